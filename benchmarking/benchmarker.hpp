@@ -9,13 +9,118 @@
 #ifndef BENCHMARKER
 #define BENCHMARKER
 
+#include <algorithm> //To sort the samples to find percentiles.
 #include <chrono> //To measure execution time.
+#include <cmath> //To compute standard deviations.
 #include <functional> //To accept functions to benchmark with.
 #include <iomanip> //For std::setw.
 #include <iostream> //To output progress during benchmarking.
+#include <string> //To name the benchmarks and their versions.
+#include <vector> //To store measurements.
 
 namespace benchmarker {
 
+/*!
+ * The statistics of the execution time of a benchmark with one input size.
+ *
+ * All durations are in nanoseconds, for one execution of the benchmarked
+ * function.
+ */
+struct Measurement {
+	/*!
+	 * The size of the input that the benchmarked function was given.
+	 */
+	size_t size;
+
+	/*!
+	 * How many samples were taken of the execution time.
+	 */
+	size_t samples;
+
+	/*!
+	 * How often the benchmarked function was executed in each sample.
+	 *
+	 * Very short functions are executed multiple times per sample, so that the
+	 * overhead of the clock doesn't dominate the measurement.
+	 */
+	size_t runs_per_sample;
+
+	/*!
+	 * The average execution time.
+	 */
+	double mean;
+
+	/*!
+	 * The variance of the execution time between samples.
+	 */
+	double variance;
+
+	/*!
+	 * The fastest sample.
+	 */
+	double minimum;
+
+	/*!
+	 * The median execution time.
+	 */
+	double median;
+
+	/*!
+	 * The execution time that 90% of the samples were faster than.
+	 */
+	double percentile_90;
+
+	/*!
+	 * The execution time that 99% of the samples were faster than.
+	 */
+	double percentile_99;
+
+	/*!
+	 * The slowest sample.
+	 */
+	double maximum;
+
+	/*!
+	 * Get the standard deviation of the execution time between samples.
+	 * \return The standard deviation, in nanoseconds.
+	 */
+	double standard_deviation() const {
+		return std::sqrt(variance);
+	}
+};
+
+/*!
+ * The measurements of one version of a benchmark, with one input size.
+ *
+ * These are collected to output all results of a benchmark run together, in
+ * machine-readable formats.
+ */
+struct Record {
+	/*!
+	 * The name of the benchmark, such as the operation that was measured.
+	 *
+	 * For benchmarks of operations, this is the name of the operation as used
+	 * by the strategies, such that the results can be related to the
+	 * calibration of that operation.
+	 */
+	std::string benchmark;
+
+	/*!
+	 * The input data that was used, such as the generator of the test data.
+	 */
+	std::string input;
+
+	/*!
+	 * The version of the benchmark, such as "ST", "MT" or "GPU".
+	 */
+	std::string version;
+
+	/*!
+	 * The statistics that were measured.
+	 */
+	Measurement measurement;
+};
+
 /*!
  * Helper class to run benchmarks.
  *
@@ -37,7 +142,7 @@ public:
 	 * the performance of the operating system memory allocation influences the
 	 * measurements less. After that, they will be executed for real and the
 	 * duration will be measured. The real test is repeated a number of times,
-	 * defined by \ref repeats.
+	 * defined by \ref repeats unless specified otherwise.
 	 *
 	 * The benchmarked function may not alter the input data in this version.
 	 * To benchmark functions that do alter the input data, the data would have
@@ -59,13 +164,14 @@ public:
 	 * \emph only that task. Do not include any set-up or tear-down into this
 	 * function. The benchmarked function will be measured as a whole for its
 	 * performance.
+	 * \param num_repeats How often to repeat each test.
 	 * \return A vector of average execution times, equal to the length of the
 	 * sizes given. This vector contains the average execution time of the
 	 * benchmarked function given each size input. Execution times is in
 	 * nanoseconds.
 	 */
 	template<typename TestData>
-	static std::vector<double> run_const(const std::string name, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, std::function<void(const TestData&)> benchmark) {
+	static std::vector<double> run_const(const std::string name, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, std::function<void(const TestData&)> benchmark, const size_t num_repeats = repeats) {
 		std::cout << name << " | Preparing..." << std::flush;
 		//First pre-generate the test data for each size.
 		std::vector<TestData> test_datas;
@@ -78,41 +184,144 @@ public:
 		for(const TestData& test_data : test_datas) {
 			benchmark(test_data);
 		}
-		std::cout << "\b\b\b\b\b\b\b\b\b\b\b\b"; //Erase 'Preparing...'
-		std::cout << "[          ]";
-		std::cout << "\b\b\b\b\b\b\b\b\b\b\b"; //Return cursor to the start of the progress bar.
-		std::cout << std::flush;
+		start_progress();
 
 		//Now for real. And measure the time it takes.
 		std::vector<double> result_times;
-		size_t progress_printed = 0;
 		for(size_t test_case = 0; test_case < test_datas.size(); ++test_case) {
 			const TestData& test_data = test_datas[test_case];
 			//The counting of the for loop is some overhead within the measured period.
 			//However stopping and re-starting the time measurement has bigger overhead, so we'll have to do the loop within the measured period.
 			std::chrono::time_point start = std::chrono::steady_clock::now();
-			for(size_t repeat = 0; repeat < repeats; ++repeat) {
+			for(size_t repeat = 0; repeat < num_repeats; ++repeat) {
 				benchmark(test_data);
 			}
 			std::chrono::time_point end = std::chrono::steady_clock::now();
-			std::chrono::duration nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>((end - start) / repeats);
+			std::chrono::duration nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>((end - start) / num_repeats);
 			result_times.push_back(nanoseconds.count());
 
-			//Update progress bar.
-			const float progress = static_cast<float>(test_case) / test_datas.size();
-			while(progress * 10 > progress_printed) {
-				std::cout << "▓" << std::flush;
-				progress_printed += 1;
-			}
-		}
-		//Erase progress bar.
-		for(size_t i = 0; i < 14 + name.length(); ++i) {
-			std::cout << "\b \b" << std::flush;
+			update_progress(test_case + 1, test_datas.size());
 		}
+		end_progress(name);
 
 		return result_times;
 	}
 
+	/*!
+	 * Measure the execution time of a benchmark with various size inputs,
+	 * adapting the number of repeats to the duration of the benchmark.
+	 *
+	 * Like with \ref run_const, the test data is generated up front for each
+	 * size and the benchmark is run once as a warm-up round. This first round
+	 * estimates how long the benchmark takes. The benchmark is then sampled
+	 * often enough to fill the time budget, but at least \ref min_samples and
+	 * at most \ref max_samples times. Benchmarks that are too fast to measure
+	 * accurately with the clock are executed multiple times per sample.
+	 *
+	 * Rather than only the average, the distribution of the samples is
+	 * reported. This shows how noisy the measurement is, and whether the
+	 * benchmark sometimes takes much longer than usual.
+	 *
+	 * The benchmarked function may not alter the input data in this version.
+	 * Use \ref measure_mutating for that.
+	 * \tparam TestData A testing object provided for the benchmarked function,
+	 * which is also the output of the generator.
+	 * \param name A name to display in the terminal while this benchmark is
+	 * running.
+	 * \param generator A generator that generates test data objects with a
+	 * certain size.
+	 * \param sizes A list of sizes to test with.
+	 * \param benchmark A function to test the performance of. It must perform
+	 * only the measured task on the test object, without set-up or tear-down.
+	 * \param budget How much time to spend measuring each size, approximately.
+	 * \return For each size, the statistics of the execution time.
+	 */
+	template<typename TestData>
+	static std::vector<Measurement> measure_const(const std::string name, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, std::function<void(const TestData&)> benchmark, const std::chrono::nanoseconds budget = default_budget) {
+		std::cout << name << " | Preparing..." << std::flush;
+		std::vector<TestData> test_datas;
+		test_datas.reserve(sizes.size());
+		for(const size_t size : sizes) {
+			test_datas.push_back(generator(size));
+		}
+		start_progress();
+
+		std::vector<Measurement> result;
+		for(size_t test_case = 0; test_case < test_datas.size(); ++test_case) {
+			const TestData& test_data = test_datas[test_case];
+			const double estimate = std::max(duration_of([&]() { benchmark(test_data); }), 1.0); //Also serves as warm-up round.
+			const size_t runs_per_sample = std::max(size_t(min_sample_duration.count() / estimate), size_t(1));
+			const size_t num_samples = std::clamp(size_t(budget.count() / (estimate * runs_per_sample)), min_samples, max_samples);
+
+			std::vector<double> samples;
+			samples.reserve(num_samples);
+			for(size_t sample = 0; sample < num_samples; ++sample) {
+				samples.push_back(duration_of([&]() {
+					for(size_t run = 0; run < runs_per_sample; ++run) {
+						benchmark(test_data);
+					}
+				}) / runs_per_sample);
+			}
+			result.push_back(summarise(sizes[test_case], samples, runs_per_sample));
+			update_progress(test_case + 1, test_datas.size());
+		}
+		end_progress(name);
+		return result;
+	}
+
+	/*!
+	 * Measure the execution time of a benchmark that modifies its input, with
+	 * various size inputs.
+	 *
+	 * Before each sample, the test data is generated anew, outside of the
+	 * measured time. That way each sample operates on the same input, even if
+	 * the benchmarked function modified it in the previous sample. Copying the
+	 * input wouldn't do, since some containers optimise their memory layout
+	 * when they are copied, which is exactly what some benchmarks measure.
+	 *
+	 * The number of samples adapts to the duration of the benchmark, including
+	 * the generation of the input, to stay within the time budget. Each sample
+	 * executes the benchmark only once, since the input needs to be generated
+	 * again after every execution. This makes the measurements of very fast
+	 * functions less accurate than with \ref measure_const.
+	 * \tparam TestData A testing object provided for the benchmarked function,
+	 * which is also the output of the generator.
+	 * \param name A name to display in the terminal while this benchmark is
+	 * running.
+	 * \param generator A generator that generates test data objects with a
+	 * certain size.
+	 * \param sizes A list of sizes to test with.
+	 * \param benchmark A function to test the performance of. It may modify
+	 * the test object it gets.
+	 * \param budget How much time to spend measuring each size, approximately.
+	 * \return For each size, the statistics of the execution time.
+	 */
+	template<typename TestData>
+	static std::vector<Measurement> measure_mutating(const std::string name, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, std::function<void(TestData&)> benchmark, const std::chrono::nanoseconds budget = default_budget) {
+		std::cout << name << " | Preparing..." << std::flush;
+		start_progress();
+
+		std::vector<Measurement> result;
+		for(size_t test_case = 0; test_case < sizes.size(); ++test_case) {
+			const size_t size = sizes[test_case];
+			TestData test_data = generator(size);
+			const double generation_estimate = duration_of([&]() { test_data = generator(size); });
+			const double estimate = std::max(duration_of([&]() { benchmark(test_data); }), 1.0); //Also serves as warm-up round.
+			const size_t num_samples = std::clamp(size_t(budget.count() / (estimate + generation_estimate)), min_samples, max_samples);
+
+			std::vector<double> samples;
+			samples.reserve(num_samples);
+			for(size_t sample = 0; sample < num_samples; ++sample) {
+				test_data = generator(size); //Regenerate the input, since the previous sample modified it.
+				samples.push_back(duration_of([&]() { benchmark(test_data); }));
+			}
+			result.push_back(summarise(size, samples, 1));
+			update_progress(test_case + 1, sizes.size());
+		}
+		end_progress(name);
+		return result;
+	}
+
 	/*!
 	 * Print the benchmark results in COUT, to read them in the terminal.
 	 * \tparam The number of different benchmarks to compare in the output. For
@@ -143,13 +352,191 @@ public:
 		}
 	}
 
+	/*!
+	 * Print the statistics of measurements in COUT, to read them in the
+	 * terminal.
+	 *
+	 * Each measurement is printed on its own row. Names of versions must be 13
+	 * or fewer characters long, or it will not align well in the output.
+	 * \param records The measurements to print.
+	 */
+	static void output_cout(const std::vector<Record>& records) {
+		std::cout << std::setw(14) << "VERSION" << std::setw(14) << "SIZE" << std::setw(14) << "MEAN" << std::setw(14) << "STDDEV" << std::setw(14) << "MEDIAN" << std::setw(14) << "P90" << std::setw(14) << "P99" << std::endl;
+		for(const Record& record : records) {
+			const Measurement& measurement = record.measurement;
+			std::cout << std::setw(14) << record.version << std::setw(14) << measurement.size << std::setw(14) << std::lround(measurement.mean) << std::setw(14) << std::lround(measurement.standard_deviation()) << std::setw(14) << std::lround(measurement.median) << std::setw(14) << std::lround(measurement.percentile_90) << std::setw(14) << std::lround(measurement.percentile_99) << std::endl;
+		}
+	}
+
+	/*!
+	 * Write the statistics of measurements as comma-separated values.
+	 *
+	 * The first row is a header with the names of the columns. After that,
+	 * every measurement gets one row. Durations are in nanoseconds. This makes
+	 * it easy to load the results in a spreadsheet, or to compare them with
+	 * the results of earlier runs to find regressions.
+	 * \param output The stream to write the values to.
+	 * \param records The measurements to write.
+	 */
+	static void output_csv(std::ostream& output, const std::vector<Record>& records) {
+		output << "benchmark,input,version,size,samples,runs_per_sample,mean,standard_deviation,minimum,median,percentile_90,percentile_99,maximum\n";
+		for(const Record& record : records) {
+			const Measurement& measurement = record.measurement;
+			output << record.benchmark << "," << record.input << "," << record.version << "," << measurement.size << "," << measurement.samples << "," << measurement.runs_per_sample << ","
+				<< measurement.mean << "," << measurement.standard_deviation() << "," << measurement.minimum << "," << measurement.median << "," << measurement.percentile_90 << "," << measurement.percentile_99 << "," << measurement.maximum << "\n";
+		}
+		output << std::flush;
+	}
+
+	/*!
+	 * Write the statistics of measurements as a JSON array.
+	 *
+	 * Each measurement becomes an object in the array, with the same fields as
+	 * the columns in \ref output_csv.
+	 * \param output The stream to write the JSON document to.
+	 * \param records The measurements to write.
+	 */
+	static void output_json(std::ostream& output, const std::vector<Record>& records) {
+		output << "[";
+		for(size_t i = 0; i < records.size(); ++i) {
+			const Record& record = records[i];
+			const Measurement& measurement = record.measurement;
+			output << (i > 0 ? ",\n\t{" : "\n\t{");
+			output << "\"benchmark\": \"" << escape_json(record.benchmark) << "\", \"input\": \"" << escape_json(record.input) << "\", \"version\": \"" << escape_json(record.version) << "\", ";
+			output << "\"size\": " << measurement.size << ", \"samples\": " << measurement.samples << ", \"runs_per_sample\": " << measurement.runs_per_sample << ", ";
+			output << "\"mean\": " << measurement.mean << ", \"standard_deviation\": " << measurement.standard_deviation() << ", \"minimum\": " << measurement.minimum << ", \"median\": " << measurement.median << ", ";
+			output << "\"percentile_90\": " << measurement.percentile_90 << ", \"percentile_99\": " << measurement.percentile_99 << ", \"maximum\": " << measurement.maximum << "}";
+		}
+		output << "\n]\n" << std::flush;
+	}
+
 	/*!
 	 * Benchmark functions that calculate the area of a shape.
 	 */
 	static void bench_area();
 
+	/*!
+	 * How much time to spend measuring each size of a benchmark by default.
+	 */
+	constexpr static std::chrono::nanoseconds default_budget = std::chrono::milliseconds(100);
+
 protected:
 	constexpr static size_t repeats = 10000; //How often to repeat each test. Increase for more accurate results.
+	constexpr static size_t min_samples = 10; //Sample at least this often, even for slow benchmarks, to be able to report the variance.
+	constexpr static size_t max_samples = 1000; //Sample at most this often, to limit the time spent on fast benchmarks.
+	constexpr static std::chrono::nanoseconds min_sample_duration = std::chrono::microseconds(10); //Samples take at least this long, to make the overhead of the clock negligible.
+
+	/*!
+	 * How many blocks of the progress bar have been printed so far.
+	 */
+	inline static size_t progress_printed = 0;
+
+	/*!
+	 * Measure how long it takes to execute a function.
+	 * \param function The function to execute.
+	 * \return The execution time, in nanoseconds.
+	 */
+	template<typename Function>
+	static double duration_of(const Function& function) {
+		const std::chrono::time_point start = std::chrono::steady_clock::now();
+		function();
+		const std::chrono::time_point end = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	}
+
+	/*!
+	 * Compute the statistics of a list of samples.
+	 * \param size The input size that was measured.
+	 * \param samples The execution time of each sample, for a single run.
+	 * \param runs_per_sample How often the function was executed per sample.
+	 * \return The statistics of those samples.
+	 */
+	static Measurement summarise(const size_t size, std::vector<double> samples, const size_t runs_per_sample) {
+		std::sort(samples.begin(), samples.end());
+		Measurement result;
+		result.size = size;
+		result.samples = samples.size();
+		result.runs_per_sample = runs_per_sample;
+		double sum = 0;
+		for(const double sample : samples) {
+			sum += sample;
+		}
+		result.mean = sum / samples.size();
+		double squared_deviations = 0;
+		for(const double sample : samples) {
+			squared_deviations += (sample - result.mean) * (sample - result.mean);
+		}
+		result.variance = samples.size() > 1 ? squared_deviations / (samples.size() - 1) : 0;
+		result.minimum = samples.front();
+		result.median = percentile(samples, 0.5);
+		result.percentile_90 = percentile(samples, 0.9);
+		result.percentile_99 = percentile(samples, 0.99);
+		result.maximum = samples.back();
+		return result;
+	}
+
+	/*!
+	 * Find a percentile in a sorted list of samples, by the nearest rank.
+	 * \param sorted_samples The samples, sorted from fastest to slowest. There
+	 * must be at least one sample.
+	 * \param fraction Which percentile to find, as a fraction between 0 and 1.
+	 * \return The smallest sample that at least that fraction of the samples
+	 * is smaller than or equal to.
+	 */
+	static double percentile(const std::vector<double>& sorted_samples, const double fraction) {
+		const size_t rank = std::ceil(fraction * sorted_samples.size());
+		return sorted_samples[std::max(rank, size_t(1)) - 1];
+	}
+
+	/*!
+	 * Replace the 'Preparing...' message with an empty progress bar.
+	 */
+	static void start_progress() {
+		std::cout << "\b\b\b\b\b\b\b\b\b\b\b\b"; //Erase 'Preparing...'
+		std::cout << "[          ]";
+		std::cout << "\b\b\b\b\b\b\b\b\b\b\b"; //Return cursor to the start of the progress bar.
+		std::cout << std::flush;
+		progress_printed = 0;
+	}
+
+	/*!
+	 * Fill the progress bar up to the current progress.
+	 * \param done How many test cases are done.
+	 * \param total How many test cases there are in total.
+	 */
+	static void update_progress(const size_t done, const size_t total) {
+		const float progress = static_cast<float>(done) / total;
+		while(progress * 10 > progress_printed && progress_printed < 10) {
+			std::cout << "▓" << std::flush;
+			progress_printed += 1;
+		}
+	}
+
+	/*!
+	 * Erase the progress bar and the name of the benchmark.
+	 * \param name The name of the benchmark that was displayed.
+	 */
+	static void end_progress(const std::string& name) {
+		for(size_t i = 0; i < 14 + name.length(); ++i) {
+			std::cout << "\b \b" << std::flush;
+		}
+	}
+
+	/*!
+	 * Escape a string to be written as a string in a JSON document.
+	 * \param text The text to escape.
+	 * \return The same text, with quotes and backslashes escaped.
+	 */
+	static std::string escape_json(const std::string& text) {
+		std::string result;
+		for(const char character : text) {
+			if(character == '"' || character == '\\') {
+				result += '\\';
+			}
+			result += character;
+		}
+		return result;
+	}
 };
 
 }
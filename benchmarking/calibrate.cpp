@@ -0,0 +1,437 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <apex/detail/strategies.hpp> //To store the measured crossovers.
+#include <apex/fixed_polygon.hpp> //To calibrate operations on polygons with a fixed number of vertices.
+#include <apex/operations/bounding_box.hpp> //To calibrate computing bounding boxes.
+#include <apex/operations/clip.hpp> //To calibrate boolean operations.
+#include <apex/operations/contains.hpp> //To calibrate point-in-polygon tests.
+#include <apex/operations/convexity.hpp> //To calibrate classifying the turns of polygons.
+#include <apex/operations/intersects.hpp> //To calibrate intersecting batches of line segments and polygons.
+#include <apex/operations/offset.hpp> //To calibrate offsetting polygons.
+#include <apex/operations/self_intersections.hpp> //To calibrate finding self-intersections.
+#include <apex/polygon.hpp> //To calibrate operations on polygons.
+#include <apex/r_tree.hpp> //To calibrate batched queries on spatial indices.
+#include <apex/soa_polygon.hpp> //To calibrate operations on polygons stored as structures of arrays.
+#include <fstream> //To write the crossovers to a header file.
+#include <iostream> //To print out some progress/metadata information.
+#include <tuple> //To store the candidate pairs of polygons with the polygons.
+
+#include "benchmarker.hpp" //To measure the versions of each operation.
+#include "generators.hpp" //To generate test objects.
+#include "sizes.hpp" //To determine how big the test objects are.
+
+/*!
+ * How often to repeat each measurement during calibration.
+ *
+ * This is fewer than for the benchmarks, since the calibration measures much
+ * bigger inputs.
+ */
+constexpr size_t calibration_repeats = 20;
+
+/*!
+ * Versions that scale quadratically are only measured up to this size, since
+ * they would take too long for the bigger sizes. They are then never chosen for
+ * bigger sizes.
+ */
+constexpr size_t quadratic_limit = 4096;
+
+/*!
+ * Measure all versions of an operation and store the crossovers between them.
+ * \tparam TestData The type of input of the operation.
+ * \param operation The operation to calibrate.
+ * \param generator A function that generates an input of a certain size. The
+ * size must be measured in the same way as the operation chooses its version.
+ * \param versions For each version of the operation, in the order they are
+ * numbered by the operation, a name and a function that executes that version.
+ * \param limits For each version, the biggest size to measure it for.
+ */
+template<typename TestData>
+void calibrate(const apex::detail::Operation operation, const std::function<TestData(const size_t)> generator, const std::vector<std::pair<std::string, std::function<void(const TestData&)>>>& versions, const std::vector<size_t>& limits) {
+	const std::string operation_name = apex::detail::operation_names[static_cast<size_t>(operation)];
+	std::vector<std::vector<double>> durations;
+	for(size_t version = 0; version < versions.size(); ++version) {
+		std::vector<size_t> sizes;
+		for(const size_t size : benchmarker::sizes_calibration) {
+			if(size <= limits[version]) {
+				sizes.push_back(size);
+			}
+		}
+		durations.push_back(benchmarker::Benchmarker::run_const<TestData>(operation_name + " " + versions[version].first, generator, sizes, versions[version].second, calibration_repeats));
+	}
+	const apex::detail::Crossovers crossovers = apex::detail::Strategies::fit_crossovers(benchmarker::sizes_calibration, durations);
+	apex::detail::Strategies::set_crossovers(operation, crossovers);
+
+	std::cout << operation_name << ":";
+	for(const size_t crossover : crossovers) {
+		if(crossover == apex::detail::no_crossover) {
+			std::cout << " none";
+		} else {
+			std::cout << " " << crossover;
+		}
+	}
+	std::cout << std::endl;
+}
+
+/*!
+ * Write the current crossovers to a header file, in the same format as the
+ * default calibration of the library.
+ *
+ * Define APEX_CALIBRATION_FILE as the path to this header to compile the
+ * crossovers into the library.
+ * \param filename The path to write the header to.
+ * \return ``true`` if the header was written, or ``false`` if it couldn't be.
+ */
+bool write_header(const std::string& filename) {
+	std::ofstream file(filename);
+	if(!file.is_open()) {
+		return false;
+	}
+	file << "//Generated by apex_calibrate. For each operation, the sizes from which each version is faster than the previous one.\n";
+	file << "#ifndef APEX_CALIBRATION\n#define APEX_CALIBRATION\n\nnamespace apex {\n\nnamespace detail {\n\n";
+	file << "constexpr std::array<Crossovers, num_operations> calibrated_crossovers = index_crossovers(std::to_array<CalibratedOperation>({\n";
+	for(size_t operation = 0; operation < apex::detail::num_operations; ++operation) {
+		file << "\t{Operation::" << apex::detail::operation_names[operation] << ", {";
+		const apex::detail::Crossovers crossovers = apex::detail::Strategies::get_crossovers(static_cast<apex::detail::Operation>(operation));
+		for(size_t crossover = 0; crossover < crossovers.size(); ++crossover) {
+			file << (crossover > 0 ? ", " : "");
+			if(crossovers[crossover] == apex::detail::no_crossover) {
+				file << "no_crossover";
+			} else {
+				file << crossovers[crossover];
+			}
+		}
+		file << "}}" << (operation + 1 < apex::detail::num_operations ? "," : "") << "\n";
+	}
+	file << "}));\n\n}\n\n}\n\n#endif //APEX_CALIBRATION\n";
+	return file.good();
+}
+
+int main(int argc, char** argv) {
+	std::cout << "Apex calibration application.\n" << std::endl;
+	const std::string profile_filename = argc > 1 ? argv[1] : "apex_profile.txt";
+	const std::string header_filename = argc > 2 ? argv[2] : "";
+	using apex::Batch;
+	using apex::FixedPolygon;
+	using apex::Polygon;
+	using apex::SoAPolygon;
+	using apex::detail::Operation;
+	constexpr size_t unlimited = apex::detail::no_crossover;
+
+	//The batches consist of 10-gons. Their size is the number of polygons plus vertices, or only the vertices, depending on the operation.
+	const std::function<Polygon(const size_t)> polygon = benchmarker::generate_polygon_circle;
+	const std::function<Batch<Polygon>(const size_t)> batch_with_polygons = [](const size_t size) {
+		return benchmarker::generate_polygon_batch_10gon(size / 11);
+	};
+	const std::function<Batch<Polygon>(const size_t)> batch_of_vertices = [](const size_t size) {
+		return benchmarker::generate_polygon_batch_10gon(size / 10);
+	};
+	const std::function<SoAPolygon(const size_t)> soa_polygon = [](const size_t size) {
+		return SoAPolygon(benchmarker::generate_polygon_circle(size));
+	};
+	const std::function<Batch<SoAPolygon>(const size_t)> soa_batch_with_polygons = [](const size_t size) {
+		return Batch<SoAPolygon>(benchmarker::generate_polygon_batch_10gon(size / 11));
+	};
+	const std::function<Batch<SoAPolygon>(const size_t)> soa_batch_of_vertices = [](const size_t size) {
+		return Batch<SoAPolygon>(benchmarker::generate_polygon_batch_10gon(size / 10));
+	};
+	const std::function<Batch<FixedPolygon<10>>(const size_t)> fixed_batch = [](const size_t size) {
+		return Batch<FixedPolygon<10>>(benchmarker::generate_polygon_batch_10gon(size / 10));
+	};
+
+	calibrate<Polygon>(Operation::area, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::area_st(polygon); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::area_mt(polygon); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::area_gpu(polygon); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::area_batch, batch_with_polygons, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::area_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::area_mt(batch); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::area_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<FixedPolygon<10>>>(Operation::area_fixed_batch, fixed_batch, {
+		{"ST", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::area_st(batch); }},
+		{"MT", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::area_mt(batch); }},
+		{"GPU", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::area_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<SoAPolygon>(Operation::area_soa, soa_polygon, {
+		{"ST", [](const SoAPolygon& polygon) { apex::detail::area_st(polygon); }},
+		{"MT", [](const SoAPolygon& polygon) { apex::detail::area_mt(polygon); }},
+		{"GPU", [](const SoAPolygon& polygon) { apex::detail::area_gpu(polygon); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<SoAPolygon>>(Operation::area_soa_batch, soa_batch_with_polygons, {
+		{"ST", [](const Batch<SoAPolygon>& batch) { apex::detail::area_st(batch); }},
+		{"MT", [](const Batch<SoAPolygon>& batch) { apex::detail::area_mt(batch); }},
+		{"GPU", [](const Batch<SoAPolygon>& batch) { apex::detail::area_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Polygon>(Operation::bounding_box, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::bounding_box_st(polygon); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::bounding_box_mt(polygon); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::bounding_box_gpu(polygon); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::bounding_box_batch, batch_with_polygons, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_mt(batch); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<FixedPolygon<10>>>(Operation::bounding_box_fixed_batch, fixed_batch, {
+		{"ST", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::bounding_box_st(batch); }},
+		{"MT", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::bounding_box_mt(batch); }},
+		{"GPU", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::bounding_box_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<SoAPolygon>(Operation::bounding_box_soa, soa_polygon, {
+		{"ST", [](const SoAPolygon& polygon) { apex::detail::bounding_box_st(polygon); }},
+		{"MT", [](const SoAPolygon& polygon) { apex::detail::bounding_box_mt(polygon); }},
+		{"GPU", [](const SoAPolygon& polygon) { apex::detail::bounding_box_gpu(polygon); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<SoAPolygon>>(Operation::bounding_box_soa_batch, soa_batch_with_polygons, {
+		{"ST", [](const Batch<SoAPolygon>& batch) { apex::detail::bounding_box_st(batch); }},
+		{"MT", [](const Batch<SoAPolygon>& batch) { apex::detail::bounding_box_mt(batch); }},
+		{"GPU", [](const Batch<SoAPolygon>& batch) { apex::detail::bounding_box_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+	//Two rows of 10-gons, shifted by half of the spacing such that each polygon overlaps with two polygons of the other row. The size is the number of edges.
+	typedef std::pair<Batch<Polygon>, Batch<Polygon>> Shapes;
+	const std::function<Shapes(const size_t)> overlapping_shapes = [](const size_t size) {
+		Batch<Polygon> a = benchmarker::generate_polygon_batch_10gon(size / 20);
+		Batch<Polygon> b = a;
+		for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+			apex::translate(a[polygon], apex::Point2(apex::coord_t(polygon) * 60, 0));
+			apex::translate(b[polygon], apex::Point2(apex::coord_t(polygon) * 60 + 30, 20));
+		}
+		return Shapes(std::move(a), std::move(b));
+	};
+	const auto clip_edges = [](const Shapes& test_data) {
+		std::vector<apex::detail::ClipEdge> edges;
+		apex::detail::clip_add_edges(test_data.first, 0, edges);
+		apex::detail::clip_add_edges(test_data.second, 1, edges);
+		return edges;
+	};
+	calibrate<Shapes>(Operation::clip, overlapping_shapes, {
+		{"ST", [&clip_edges](const Shapes& test_data) { apex::detail::clip_st(clip_edges(test_data), apex::BooleanOperation::UNION, apex::FillRule::NONZERO); }},
+		{"MT", [&clip_edges](const Shapes& test_data) { apex::detail::clip_mt(clip_edges(test_data), apex::BooleanOperation::UNION, apex::FillRule::NONZERO); }}
+	}, {unlimited, unlimited});
+	calibrate<Polygon>(Operation::contains, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::contains_st(polygon, apex::Point2(0, 0)); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::contains_mt(polygon, apex::Point2(0, 0)); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::contains_gpu(polygon, apex::Point2(0, 0)); }}
+	}, {unlimited, unlimited, unlimited});
+	typedef std::pair<Batch<Polygon>, Batch<apex::Point2>> BatchPoints;
+	const std::function<BatchPoints(const size_t)> batch_with_points = [&batch_with_polygons](const size_t size) {
+		const Batch<Polygon> batch = batch_with_polygons(size);
+		return BatchPoints(batch, Batch<apex::Point2>(batch.size(), apex::Point2(0, 0)));
+	};
+	calibrate<BatchPoints>(Operation::contains_batch, batch_with_points, {
+		{"ST", [](const BatchPoints& test_data) { apex::detail::contains_st(test_data.first, test_data.second); }},
+		{"MT", [](const BatchPoints& test_data) { apex::detail::contains_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const BatchPoints& test_data) { apex::detail::contains_gpu(test_data.first, test_data.second); }}
+	}, {unlimited, unlimited, unlimited});
+	typedef std::pair<Batch<FixedPolygon<10>>, Batch<apex::Point2>> FixedBatchPoints;
+	const std::function<FixedBatchPoints(const size_t)> fixed_batch_with_points = [&fixed_batch](const size_t size) {
+		const Batch<FixedPolygon<10>> batch = fixed_batch(size);
+		return FixedBatchPoints(batch, Batch<apex::Point2>(batch.size(), apex::Point2(0, 0)));
+	};
+	calibrate<FixedBatchPoints>(Operation::contains_fixed_batch, fixed_batch_with_points, {
+		{"ST", [](const FixedBatchPoints& test_data) { apex::detail::contains_st(test_data.first, test_data.second); }},
+		{"MT", [](const FixedBatchPoints& test_data) { apex::detail::contains_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const FixedBatchPoints& test_data) { apex::detail::contains_gpu(test_data.first, test_data.second); }}
+	}, {unlimited, unlimited, unlimited});
+	//The points are tested against a 100-gon. The size is the number of points times the number of vertices.
+	typedef std::pair<Polygon, Batch<apex::Point2>> PolygonPoints;
+	const std::function<PolygonPoints(const size_t)> polygon_with_points = [](const size_t size) {
+		Batch<apex::Point2> points;
+		for(size_t point = 0; point < size / 100; ++point) {
+			points.emplace_back(apex::coord_t(point % 200) * 4 - 400, apex::coord_t(point % 193) * 4 - 400); //Spread around the 100-gon, which has a radius of 400.
+		}
+		return PolygonPoints(benchmarker::generate_polygon_circle(100), points);
+	};
+	calibrate<PolygonPoints>(Operation::contains_points, polygon_with_points, {
+		{"ST", [](const PolygonPoints& test_data) { apex::detail::contains_st(test_data.first, test_data.second); }},
+		{"MT", [](const PolygonPoints& test_data) { apex::detail::contains_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const PolygonPoints& test_data) { apex::detail::contains_gpu(test_data.first, test_data.second); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Polygon>(Operation::convexity, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::turns_st(polygon); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::turns_mt(polygon); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::turns_gpu(polygon); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::convexity_batch, batch_with_polygons, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::turns_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::turns_mt(batch); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::turns_gpu(batch); }}
+	}, {unlimited, unlimited, unlimited});
+
+	//The line segments are spread over a square of 1000 by 1000 units, such that some of them intersect.
+	const std::function<Batch<apex::LineSegment>(const size_t)> segments = [](const size_t size) {
+		Batch<apex::LineSegment> result;
+		for(size_t segment = 0; segment < size; ++segment) {
+			const apex::Point2 start((segment * 37) % 1000, (segment * 91) % 1000);
+			result.emplace_back(start, start + apex::Point2(apex::coord_t(segment % 13) * 10 - 60, apex::coord_t(segment % 7) * 10 - 30));
+		}
+		return result;
+	};
+	typedef std::pair<Batch<apex::LineSegment>, Batch<apex::LineSegment>> SegmentPairs;
+	const std::function<SegmentPairs(const size_t)> segment_pairs = [&segments](const size_t size) {
+		const Batch<apex::LineSegment> batch = segments(size * 2);
+		return SegmentPairs(Batch<apex::LineSegment>(batch.begin(), batch.begin() + size), Batch<apex::LineSegment>(batch.begin() + size, batch.end()));
+	};
+	//For all pairs, 100 segments are tested against the rest. The size is the number of pairs.
+	const std::function<SegmentPairs(const size_t)> segment_sets = [&segments](const size_t size) {
+		return SegmentPairs(segments(100), segments(size / 100));
+	};
+	calibrate<SegmentPairs>(Operation::intersecting_pairs, segment_sets, {
+		{"ST", [](const SegmentPairs& test_data) { apex::detail::intersecting_pairs_st(test_data.first, test_data.second); }},
+		{"MT", [](const SegmentPairs& test_data) { apex::detail::intersecting_pairs_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const SegmentPairs& test_data) { apex::detail::intersecting_pairs_gpu(test_data.first, test_data.second); }}
+	}, {unlimited, unlimited, unlimited});
+	//Rows of 10-gons, with a second row shifted by half of the spacing, such that each polygon intersects two polygons of the other row. The size is the number of vertices in each candidate pair multiplied.
+	typedef std::tuple<Batch<Polygon>, Batch<Polygon>, Batch<Batch<size_t>>> PolygonPairs;
+	const std::function<PolygonPairs(const size_t)> polygon_pairs = [](const size_t size) {
+		Batch<Polygon> a = benchmarker::generate_polygon_batch_10gon(size / 200);
+		Batch<Polygon> b = a;
+		for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+			apex::translate(a[polygon], apex::Point2(apex::coord_t(polygon) * 100, 0));
+			apex::translate(b[polygon], apex::Point2(apex::coord_t(polygon) * 100 + 50, 0));
+		}
+		Batch<Batch<size_t>> candidates = apex::detail::intersecting_candidates(a, apex::RTree(b));
+		return PolygonPairs(std::move(a), std::move(b), std::move(candidates));
+	};
+	calibrate<PolygonPairs>(Operation::intersecting_pairs_batch, polygon_pairs, {
+		{"ST", [](const PolygonPairs& test_data) { apex::detail::intersecting_pairs_st(std::get<0>(test_data), std::get<1>(test_data), std::get<2>(test_data)); }},
+		{"MT", [](const PolygonPairs& test_data) { apex::detail::intersecting_pairs_mt(std::get<0>(test_data), std::get<1>(test_data), std::get<2>(test_data)); }},
+		{"GPU", [](const PolygonPairs& test_data) { apex::detail::intersecting_pairs_gpu(std::get<0>(test_data), std::get<1>(test_data), std::get<2>(test_data)); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<SegmentPairs>(Operation::intersects_segments, segment_pairs, {
+		{"ST", [](const SegmentPairs& test_data) { apex::detail::intersects_st(test_data.first, test_data.second); }},
+		{"MT", [](const SegmentPairs& test_data) { apex::detail::intersects_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const SegmentPairs& test_data) { apex::detail::intersects_gpu(test_data.first, test_data.second); }}
+	}, {unlimited, unlimited, unlimited});
+
+	//Offsetting outwards, so that the corners need joins and the circle and 10-gons don't vanish. The 10-gons are spread out such that they merge with their neighbours.
+	const std::function<Batch<Polygon>(const size_t)> spread_batch = [](const size_t size) {
+		Batch<Polygon> batch = benchmarker::generate_polygon_batch_10gon(size / 11);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			apex::translate(batch[polygon], apex::Point2(apex::coord_t(polygon) * 60, 0));
+		}
+		return batch;
+	};
+	calibrate<Polygon>(Operation::offset, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::offset_st(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::offset_mt(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::offset_gpu(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::offset_batch, spread_batch, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::offset_st(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::offset_mt(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::offset_gpu(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }}
+	}, {unlimited, unlimited, unlimited});
+
+	//The tree indexes a grid of 100 by 100 squares. The size is the number of windows, spread over the grid.
+	typedef std::pair<apex::RTree, Batch<std::pair<apex::Point2, apex::Point2>>> TreeQueries;
+	const std::function<TreeQueries(const size_t)> tree_queries = [](const size_t size) {
+		Batch<std::pair<apex::Point2, apex::Point2>> boxes;
+		for(apex::coord_t x = 0; x < 100; ++x) {
+			for(apex::coord_t y = 0; y < 100; ++y) {
+				boxes.emplace_back(apex::Point2(x * 100, y * 100), apex::Point2(x * 100 + 80, y * 100 + 80));
+			}
+		}
+		Batch<std::pair<apex::Point2, apex::Point2>> windows;
+		for(size_t window = 0; window < size; ++window) {
+			const apex::Point2 minimum((window * 37) % 10000, (window * 91) % 10000);
+			windows.emplace_back(minimum, minimum + apex::Point2(250, 250));
+		}
+		return TreeQueries(apex::RTree(boxes), windows);
+	};
+	const auto split_windows = [](const TreeQueries& test_data) {
+		std::vector<apex::Point2> minima;
+		std::vector<apex::Point2> maxima;
+		for(const std::pair<apex::Point2, apex::Point2>& window : test_data.second) {
+			minima.push_back(window.first);
+			maxima.push_back(window.second);
+		}
+		return std::make_pair(minima, maxima);
+	};
+	calibrate<TreeQueries>(Operation::r_tree_query_batch, tree_queries, {
+		{"ST", [&split_windows](const TreeQueries& test_data) { const auto windows = split_windows(test_data); apex::detail::r_tree_query_st(test_data.first, windows.first.data(), windows.second.data(), windows.first.size()); }},
+		{"MT", [&split_windows](const TreeQueries& test_data) { const auto windows = split_windows(test_data); apex::detail::r_tree_query_mt(test_data.first, windows.first.data(), windows.second.data(), windows.first.size()); }},
+		{"GPU", [&split_windows](const TreeQueries& test_data) { const auto windows = split_windows(test_data); apex::detail::r_tree_query_gpu(test_data.first, windows.first.data(), windows.second.data(), windows.first.size()); }}
+	}, {unlimited, unlimited, unlimited});
+
+	calibrate<Polygon>(Operation::self_intersections, polygon, {
+		{"naive", [](const Polygon& polygon) { apex::detail::self_intersections_st_naive(polygon); }},
+		{"sweep", [](const Polygon& polygon) { apex::detail::self_intersections_st_sweep(polygon); }},
+		{"grid", [](const Polygon& polygon) { apex::detail::self_intersections_mt_grid(polygon); }}
+	}, {quadratic_limit, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::self_intersections_batch, batch_with_polygons, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::self_intersections_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::self_intersections_mt(batch); }}
+	}, {unlimited, unlimited});
+
+	//Transforming modifies the input too. The polygons rotate a bit while measuring, but that doesn't influence the duration.
+	const apex::AffineTransform rotation = apex::AffineTransform::rotation(0.1);
+	calibrate<Polygon>(Operation::transform, polygon, {
+		{"ST", [&rotation](const Polygon& polygon) { apex::detail::transform_st(const_cast<Polygon&>(polygon), rotation); }},
+		{"MT", [&rotation](const Polygon& polygon) { apex::detail::transform_mt(const_cast<Polygon&>(polygon), rotation); }},
+		{"GPU", [&rotation](const Polygon& polygon) { apex::detail::transform_gpu(const_cast<Polygon&>(polygon), rotation); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::transform_batch, batch_of_vertices, {
+		{"ST", [&rotation](const Batch<Polygon>& batch) { apex::detail::transform_st(const_cast<Batch<Polygon>&>(batch), rotation); }},
+		{"MT", [&rotation](const Batch<Polygon>& batch) { apex::detail::transform_mt(const_cast<Batch<Polygon>&>(batch), rotation); }},
+		{"GPU", [&rotation](const Batch<Polygon>& batch) { apex::detail::transform_gpu(const_cast<Batch<Polygon>&>(batch), rotation); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<SoAPolygon>(Operation::transform_soa, soa_polygon, {
+		{"ST", [&rotation](const SoAPolygon& polygon) { apex::detail::transform_st(const_cast<SoAPolygon&>(polygon), rotation); }},
+		{"MT", [&rotation](const SoAPolygon& polygon) { apex::detail::transform_mt(const_cast<SoAPolygon&>(polygon), rotation); }},
+		{"GPU", [&rotation](const SoAPolygon& polygon) { apex::detail::transform_gpu(const_cast<SoAPolygon&>(polygon), rotation); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<SoAPolygon>>(Operation::transform_soa_batch, soa_batch_of_vertices, {
+		{"ST", [&rotation](const Batch<SoAPolygon>& batch) { apex::detail::transform_st(const_cast<Batch<SoAPolygon>&>(batch), rotation); }},
+		{"MT", [&rotation](const Batch<SoAPolygon>& batch) { apex::detail::transform_mt(const_cast<Batch<SoAPolygon>&>(batch), rotation); }},
+		{"GPU", [&rotation](const Batch<SoAPolygon>& batch) { apex::detail::transform_gpu(const_cast<Batch<SoAPolygon>&>(batch), rotation); }}
+	}, {unlimited, unlimited, unlimited});
+
+	//Translating modifies the input. The polygons drift away a bit while measuring, but that doesn't influence the duration.
+	calibrate<Polygon>(Operation::translate, polygon, {
+		{"ST", [](const Polygon& polygon) { apex::detail::translate_st(const_cast<Polygon&>(polygon), apex::Point2(1, 1)); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::translate_mt(const_cast<Polygon&>(polygon), apex::Point2(1, 1)); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::translate_gpu(const_cast<Polygon&>(polygon), apex::Point2(1, 1)); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<Polygon>>(Operation::translate_batch, batch_of_vertices, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::translate_st(const_cast<Batch<Polygon>&>(batch), apex::Point2(1, 1)); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::translate_mt(const_cast<Batch<Polygon>&>(batch), apex::Point2(1, 1)); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::translate_gpu(const_cast<Batch<Polygon>&>(batch), apex::Point2(1, 1)); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<FixedPolygon<10>>>(Operation::translate_fixed_batch, fixed_batch, {
+		{"ST", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::translate_st(const_cast<Batch<FixedPolygon<10>>&>(batch), apex::Point2(1, 1)); }},
+		{"MT", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::translate_mt(const_cast<Batch<FixedPolygon<10>>&>(batch), apex::Point2(1, 1)); }},
+		{"GPU", [](const Batch<FixedPolygon<10>>& batch) { apex::detail::translate_gpu(const_cast<Batch<FixedPolygon<10>>&>(batch), apex::Point2(1, 1)); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<SoAPolygon>(Operation::translate_soa, soa_polygon, {
+		{"ST", [](const SoAPolygon& polygon) { apex::detail::translate_st(const_cast<SoAPolygon&>(polygon), apex::Point2(1, 1)); }},
+		{"MT", [](const SoAPolygon& polygon) { apex::detail::translate_mt(const_cast<SoAPolygon&>(polygon), apex::Point2(1, 1)); }},
+		{"GPU", [](const SoAPolygon& polygon) { apex::detail::translate_gpu(const_cast<SoAPolygon&>(polygon), apex::Point2(1, 1)); }}
+	}, {unlimited, unlimited, unlimited});
+	calibrate<Batch<SoAPolygon>>(Operation::translate_soa_batch, soa_batch_of_vertices, {
+		{"ST", [](const Batch<SoAPolygon>& batch) { apex::detail::translate_st(const_cast<Batch<SoAPolygon>&>(batch), apex::Point2(1, 1)); }},
+		{"MT", [](const Batch<SoAPolygon>& batch) { apex::detail::translate_mt(const_cast<Batch<SoAPolygon>&>(batch), apex::Point2(1, 1)); }},
+		{"GPU", [](const Batch<SoAPolygon>& batch) { apex::detail::translate_gpu(const_cast<Batch<SoAPolygon>&>(batch), apex::Point2(1, 1)); }}
+	}, {unlimited, unlimited, unlimited});
+
+	if(!apex::detail::Strategies::save_profile(profile_filename)) {
+		std::cerr << "Could not write the profile to " << profile_filename << std::endl;
+		return 1;
+	}
+	std::cout << "Profile written to " << profile_filename << ". Load it with apex::detail::Strategies::load_profile." << std::endl;
+	if(!header_filename.empty()) {
+		if(!write_header(header_filename)) {
+			std::cerr << "Could not write the header to " << header_filename << std::endl;
+			return 1;
+		}
+		std::cout << "Header written to " << header_filename << ". Define APEX_CALIBRATION_FILE as its path to compile it into the library." << std::endl;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -8,8 +8,11 @@
 
 #include "generators.hpp" //The definitions that this is implementing.
 
+#include <algorithm> //To copy the vertices of the 10-gon into the batch.
 #include <cmath> //For trigonometry functions to construct an approximation of a circle.
 #include <numbers> //For use of pi to construct an approximation of a circle by radians.
+#include <random> //To generate random star-shaped polygons.
+#include <vector> //To list the sizes of the polygons in a batch.
 
 namespace benchmarker {
 
@@ -26,10 +29,6 @@ apex::Polygon generate_polygon_circle(const size_t num_vertices) {
 }
 
 apex::Batch<apex::Polygon> generate_polygon_batch_10gon(const size_t num_polygons) {
-	apex::Batch<apex::Polygon> result;
-	result.reserve(num_polygons);
-	result.reserve_subelements(10 * num_polygons); //10 vertices for each polygon.
-
 	apex::Polygon polygon; //A polygon to add to the batch repeatedly.
 	for(size_t vertex = 0; vertex < 10; ++vertex) { //Construct a regular n-gon with 10 vertices.
 		const apex::coord_t x = std::lround(std::cos(std::numbers::pi * 2 / 10 * vertex) * 40);
@@ -37,8 +36,89 @@ apex::Batch<apex::Polygon> generate_polygon_batch_10gon(const size_t num_polygon
 		polygon.emplace_back(x, y);
 	}
 
+	apex::Batch<apex::Polygon> result;
+	const std::vector<size_t> sizes(num_polygons, 10); //10 vertices for each polygon.
+	result.assign_sizes(sizes);
+	const apex::Batch<apex::Polygon>::iterator polygons = result.begin();
+	#pragma omp parallel for
 	for(size_t repeat = 0; repeat < num_polygons; ++repeat) {
-		result.push_back(polygon); //Makes a copy.
+		std::copy(polygon.begin(), polygon.end(), polygons[repeat].begin()); //Makes a copy.
+	}
+	return result;
+}
+
+apex::Polygon generate_polygon_star(const size_t num_vertices) {
+	std::mt19937 random(num_vertices); //Seeded with the size, so that measurements are reproducible.
+	const apex::coord_t radius = num_vertices * 4 + 100; //Leave enough room between the vertices to avoid equal vertices, also near the centre.
+	std::uniform_int_distribution<apex::coord_t> distance(radius / 4, radius);
+	apex::Polygon result;
+	result.reserve(num_vertices);
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const apex::coord_t vertex_radius = distance(random);
+		const apex::coord_t x = std::lround(std::cos(std::numbers::pi * 2 / num_vertices * vertex) * vertex_radius);
+		const apex::coord_t y = std::lround(std::sin(std::numbers::pi * 2 / num_vertices * vertex) * vertex_radius);
+		result.emplace_back(x, y);
+	}
+	return result;
+}
+
+apex::Polygon generate_polygon_degenerate(const size_t num_vertices) {
+	const apex::coord_t side = num_vertices + 1; //The length of the sides, leaving room for a vertex on each unit of length.
+	apex::Polygon result;
+	result.reserve(num_vertices);
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		//Walk around the square counter-clockwise, placing vertices at intervals of 4 units.
+		const apex::coord_t position = (vertex * 4) % (side * 4);
+		const apex::coord_t along = position % side;
+		apex::Point2 point;
+		switch(position / side) {
+			case 0: point = apex::Point2(along, 0); break;
+			case 1: point = apex::Point2(side, along); break;
+			case 2: point = apex::Point2(side - along, side); break;
+			default: point = apex::Point2(0, side - along); break;
+		}
+		if(vertex % 7 == 3 && !result.empty()) {
+			point = result.back(); //A duplicate vertex, making an edge of zero length.
+		} else if(vertex % 11 == 5 && result.size() >= 2) {
+			const apex::Point2& before = result[result.size() - 2];
+			point = apex::Point2((before.x + result.back().x) / 2, (before.y + result.back().y) / 2); //Go back halfway along the previous edge, making a spike of zero width.
+		}
+		result.push_back(point);
+	}
+	return result;
+}
+
+apex::Batch<apex::Polygon> generate_polygon_batch_mixed(const size_t num_polygons) {
+	std::mt19937 random(num_polygons); //Seeded with the size, so that measurements are reproducible.
+	std::uniform_int_distribution<size_t> kind(0, 99);
+	std::vector<size_t> sizes;
+	sizes.reserve(num_polygons);
+	for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+		const size_t roll = kind(random);
+		sizes.push_back(roll < 80 ? 3 + roll % 10 : (roll < 98 ? 20 + roll * 2 : 1000)); //80% small polygons, 18% medium polygons, and a few big ones.
+	}
+
+	apex::Batch<apex::Polygon> result;
+	result.assign_sizes(sizes);
+	const apex::Batch<apex::Polygon>::iterator polygons = result.begin();
+	constexpr apex::coord_t spacing = 4000; //A bit less than the diameter of the biggest stars, so that some of them overlap.
+	constexpr size_t row_length = 100;
+	#pragma omp parallel for
+	for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+		const apex::Polygon star = generate_polygon_star(sizes[polygon]);
+		const apex::Point2 offset(apex::coord_t(polygon % row_length) * spacing, apex::coord_t(polygon / row_length) * spacing);
+		std::transform(star.begin(), star.end(), polygons[polygon].begin(), [&offset](const apex::Point2& vertex) {
+			return vertex + offset;
+		});
+	}
+	return result;
+}
+
+apex::Batch<apex::Polygon> generate_polygon_batch_fragmented(const size_t num_polygons) {
+	apex::Batch<apex::Polygon> result = generate_polygon_batch_mixed(num_polygons);
+	for(size_t polygon = 0; polygon < result.size(); polygon += 2) {
+		const apex::Point2 first = result[polygon][0]; //Copy it, since the reference would be invalidated when the polygon moves.
+		result[polygon].push_back(first); //Exceeds the capacity of the polygon, so it gets moved to the end of the buffer.
 	}
 	return result;
 }
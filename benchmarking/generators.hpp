@@ -28,6 +28,55 @@ apex::Polygon generate_polygon_circle(const size_t num_vertices);
  */
 apex::Batch<apex::Polygon> generate_polygon_batch_10gon(const size_t num_polygons);
 
+/*!
+ * Generate a random star-shaped polygon with a certain number of vertices.
+ *
+ * The vertices are spread evenly around a centre, like with a circle, but at a
+ * random distance from the centre. This makes the polygon concave, while it is
+ * still guaranteed not to intersect itself. The random generator is seeded
+ * with the number of vertices, so the same size always gives the same polygon.
+ * \param num_vertices The number of vertices to use for the star.
+ * \return A star-shaped polygon with the given number of vertices.
+ */
+apex::Polygon generate_polygon_star(const size_t num_vertices);
+
+/*!
+ * Generate a polygon consisting mostly of degenerate parts.
+ *
+ * The polygon is a square, with most of its vertices on the edges of the
+ * square, causing lots of collinear edges. Every few vertices are duplicated,
+ * causing edges of zero length. Some vertices form spikes of zero width,
+ * where the contour goes back on itself. This tests the robustness and
+ * performance of algorithms with input that is not in general position.
+ * \param num_vertices The number of vertices to use for the polygon.
+ * \return A mostly degenerate polygon with the given number of vertices.
+ */
+apex::Polygon generate_polygon_degenerate(const size_t num_vertices);
+
+/*!
+ * Generate a batch of star-shaped polygons of varying sizes.
+ *
+ * Most polygons are small, but some of them have up to 1000 vertices, like
+ * they would in practice. This puts algorithms to the test that distribute
+ * work evenly over the polygons. The polygons are placed next to each other in
+ * rows, but may overlap with their neighbours.
+ * \param num_polygons The number of polygons to add to the batch.
+ * \return A batch with the given number of polygons.
+ */
+apex::Batch<apex::Polygon> generate_polygon_batch_mixed(const size_t num_polygons);
+
+/*!
+ * Generate a batch of polygons whose vertices are scattered through memory.
+ *
+ * The batch is the same as \ref generate_polygon_batch_mixed, but half of the
+ * polygons grew after they were added, leaving gaps in the buffer of vertices
+ * and breaking the order of the polygons in memory. Copying the batch would
+ * optimise this away, so such a batch has to be generated anew.
+ * \param num_polygons The number of polygons to add to the batch.
+ * \return A fragmented batch with the given number of polygons.
+ */
+apex::Batch<apex::Polygon> generate_polygon_batch_fragmented(const size_t num_polygons);
+
 }
 
 #endif //BENCHMARKER_GENERATORS
\ No newline at end of file
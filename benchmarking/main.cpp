@@ -6,44 +6,365 @@
  * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
  */
 
+#include <apex/operations/bounding_box.hpp> //To benchmark computing bounding boxes.
+#include <apex/operations/clip.hpp> //To benchmark boolean operations.
+#include <apex/operations/contains.hpp> //To benchmark point-in-polygon tests.
+#include <apex/operations/convexity.hpp> //To benchmark classifying the turns of polygons.
+#include <apex/operations/intersects.hpp> //To benchmark intersecting batches of line segments.
+#include <apex/operations/offset.hpp> //To benchmark offsetting polygons.
+#include <apex/operations/self_intersections.hpp> //To benchmark finding self-intersections.
 #include <apex/polygon.hpp> //To test performance of using polygons.
+#include <fstream> //To write the results to CSV and JSON files.
 #include <iostream> //To print out some progress/metadata information.
 
 #include "benchmarker.hpp" //To execute tests.
 #include "generators.hpp" //To generate test objects.
 #include "sizes.hpp" //To determine how big the test objects are.
 
+/*!
+ * The measurements of all benchmarks that were run so far.
+ */
+std::vector<benchmarker::Record> records;
+
+/*!
+ * Only the benchmarks whose name contains one of these filters are run. If
+ * there are no filters, all benchmarks are run.
+ */
+std::vector<std::string> filters;
+
+/*!
+ * How much time to spend measuring each size of each version of a benchmark.
+ */
+std::chrono::nanoseconds budget = benchmarker::Benchmarker::default_budget;
+
+/*!
+ * Whether a benchmark is selected to run by the filters on the command line.
+ * \param benchmark The name of the benchmark.
+ * \return ``true`` if the benchmark needs to run, or ``false`` if it must be
+ * skipped.
+ */
+bool selected(const std::string& benchmark) {
+	if(filters.empty()) {
+		return true;
+	}
+	for(const std::string& filter : filters) {
+		if(benchmark.find(filter) != std::string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * Measure all versions of a benchmark that doesn't modify its input, and print
+ * the results.
+ * \tparam TestData The type of input of the benchmark.
+ * \param benchmark The name of the benchmark. For operations, this is the name
+ * of the operation as used by the strategies.
+ * \param input A name for the type of input that is generated.
+ * \param generator A function that generates an input of a certain size.
+ * \param sizes The sizes to measure.
+ * \param versions For each version of the benchmark, a name and a function
+ * that executes that version.
+ * \param limits For each version, the biggest size to measure it for. If
+ * empty, all versions are measured with all sizes.
+ */
+template<typename TestData>
+void bench(const std::string& benchmark, const std::string& input, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, const std::vector<std::pair<std::string, std::function<void(const TestData&)>>>& versions, const std::vector<size_t>& limits = {}) {
+	if(!selected(benchmark)) {
+		return;
+	}
+	std::cout << "________ " << benchmark << " (" << input << ") ________" << std::endl;
+	const size_t first_record = records.size();
+	for(size_t version = 0; version < versions.size(); ++version) {
+		std::vector<size_t> version_sizes;
+		for(const size_t size : sizes) {
+			if(limits.empty() || size <= limits[version]) {
+				version_sizes.push_back(size);
+			}
+		}
+		for(const benchmarker::Measurement& measurement : benchmarker::Benchmarker::measure_const<TestData>(benchmark + " " + versions[version].first, generator, version_sizes, versions[version].second, budget)) {
+			records.push_back({benchmark, input, versions[version].first, measurement});
+		}
+	}
+	benchmarker::Benchmarker::output_cout(std::vector<benchmarker::Record>(records.begin() + first_record, records.end()));
+}
+
+/*!
+ * Measure all versions of a benchmark that modifies its input, and print the
+ * results.
+ *
+ * The input is generated anew before each measurement.
+ * \tparam TestData The type of input of the benchmark.
+ * \param benchmark The name of the benchmark. For operations, this is the name
+ * of the operation as used by the strategies.
+ * \param input A name for the type of input that is generated.
+ * \param generator A function that generates an input of a certain size.
+ * \param sizes The sizes to measure.
+ * \param versions For each version of the benchmark, a name and a function
+ * that executes that version.
+ */
+template<typename TestData>
+void bench_mutating(const std::string& benchmark, const std::string& input, const std::function<TestData(const size_t)> generator, const std::vector<size_t>& sizes, const std::vector<std::pair<std::string, std::function<void(TestData&)>>>& versions) {
+	if(!selected(benchmark)) {
+		return;
+	}
+	std::cout << "________ " << benchmark << " (" << input << ") ________" << std::endl;
+	const size_t first_record = records.size();
+	for(const std::pair<std::string, std::function<void(TestData&)>>& version : versions) {
+		for(const benchmarker::Measurement& measurement : benchmarker::Benchmarker::measure_mutating<TestData>(benchmark + " " + version.first, generator, sizes, version.second, budget)) {
+			records.push_back({benchmark, input, version.first, measurement});
+		}
+	}
+	benchmarker::Benchmarker::output_cout(std::vector<benchmarker::Record>(records.begin() + first_record, records.end()));
+}
+
+/*!
+ * Run the benchmarks.
+ *
+ * The command line accepts the following arguments:
+ * - ``--csv <file>`` to write all measurements to a CSV file.
+ * - ``--json <file>`` to write all measurements to a JSON file.
+ * - ``--budget <milliseconds>`` to change how long each size of each version
+ *   is measured.
+ * - Any other argument is a filter. Only the benchmarks whose name contains
+ *   one of the filters are run, e.g. ``area`` or ``translate_batch``.
+ */
 int main(int argc, char** argv) {
 	std::cout << "Apex benchmarking application.\n" << std::endl;
+	std::string csv_filename;
+	std::string json_filename;
+	for(int argument = 1; argument < argc; ++argument) {
+		const std::string flag = argv[argument];
+		if(flag == "--csv" && argument + 1 < argc) {
+			csv_filename = argv[++argument];
+		} else if(flag == "--json" && argument + 1 < argc) {
+			json_filename = argv[++argument];
+		} else if(flag == "--budget" && argument + 1 < argc) {
+			budget = std::chrono::milliseconds(std::stoul(argv[++argument]));
+		} else {
+			filters.push_back(flag);
+		}
+	}
+
+	using apex::Batch;
+	using apex::Polygon;
+	using benchmarker::sizes_polygon_batch_exponential;
+	using benchmarker::sizes_polygon_exponential;
+	constexpr size_t quadratic_limit = 3000; //Versions that scale quadratically are only measured up to this size, since they would take too long for the bigger sizes.
+	constexpr size_t offset_batch_limit = 100; //Offsetting a batch involves a boolean operation on all of its polygons at once, so it's only measured up to this many polygons.
+
+	const std::function<Polygon(const size_t)> circle = benchmarker::generate_polygon_circle;
+	const std::function<Polygon(const size_t)> star = benchmarker::generate_polygon_star;
+	const std::function<Polygon(const size_t)> degenerate = benchmarker::generate_polygon_degenerate;
+	const std::function<Batch<Polygon>(const size_t)> batch_10gon = benchmarker::generate_polygon_batch_10gon;
+	const std::function<Batch<Polygon>(const size_t)> batch_mixed = benchmarker::generate_polygon_batch_mixed;
+	const std::function<Batch<Polygon>(const size_t)> batch_fragmented = benchmarker::generate_polygon_batch_fragmented;
+
+	//Area, with all polygon shapes, since the SIMD versions may depend on the alignment of the vertices.
+	for(const std::pair<std::string, std::function<Polygon(const size_t)>>& input : std::vector<std::pair<std::string, std::function<Polygon(const size_t)>>>{{"circle", circle}, {"star", star}, {"degenerate", degenerate}}) {
+		bench<Polygon>("area", input.first, input.second, benchmarker::sizes_polygon_big, {
+			{"ST", [](const Polygon& polygon) { apex::detail::area_st(polygon); }},
+			{"MT", [](const Polygon& polygon) { apex::detail::area_mt(polygon); }},
+			{"GPU", [](const Polygon& polygon) { apex::detail::area_gpu(polygon); }},
+			{"SIMD", [](const Polygon& polygon) { apex::detail::area_simd(polygon); }}
+		});
+	}
+	for(const std::pair<std::string, std::function<Batch<Polygon>(const size_t)>>& input : std::vector<std::pair<std::string, std::function<Batch<Polygon>(const size_t)>>>{{"10-gons", batch_10gon}, {"mixed", batch_mixed}}) {
+		bench<Batch<Polygon>>("area_batch", input.first, input.second, benchmarker::sizes_polygon_batch_big, {
+			{"ST", [](const Batch<Polygon>& batch) { apex::detail::area_st(batch); }},
+			{"MT", [](const Batch<Polygon>& batch) { apex::detail::area_mt(batch); }},
+			{"GPU", [](const Batch<Polygon>& batch) { apex::detail::area_gpu(batch); }},
+			{"SIMD", [](const Batch<Polygon>& batch) { apex::detail::area_simd(batch); }}
+		});
+	}
 
-	std::cout << "________ AREA ________" << std::endl;
-	std::vector<double> durations_st = benchmarker::Benchmarker::run_const<apex::Polygon>("Area ST", benchmarker::generate_polygon_circle, benchmarker::sizes_polygon_big, [](const apex::Polygon& polygon) {
-		apex::detail::area_st(polygon);
+	//Constructing, copying and optimising batches. These are not operations, but all operations on batches depend on them.
+	bench<Batch<Polygon>>("batch_construct", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"push_back", [](const Batch<Polygon>& source) {
+			Batch<Polygon> batch;
+			for(const apex::Subbatch<apex::Point2>& polygon : source) {
+				batch.push_back(polygon);
+			}
+		}},
+		{"assign_sizes", [](const Batch<Polygon>& source) {
+			std::vector<size_t> sizes;
+			sizes.reserve(source.size());
+			for(const apex::Subbatch<apex::Point2>& polygon : source) {
+				sizes.push_back(polygon.size());
+			}
+			Batch<Polygon> batch;
+			batch.assign_sizes(sizes);
+			for(size_t polygon = 0; polygon < source.size(); ++polygon) {
+				std::copy(source[polygon].begin(), source[polygon].end(), batch[polygon].begin());
+			}
+		}},
+		{"adopt", [](const Batch<Polygon>& source) {
+			std::pmr::vector<apex::Point2> buffer;
+			buffer.reserve(source.size_subelements());
+			std::vector<size_t> offsets = {0};
+			offsets.reserve(source.size() + 1);
+			for(const apex::Subbatch<apex::Point2>& polygon : source) {
+				buffer.insert(buffer.end(), polygon.begin(), polygon.end());
+				offsets.push_back(buffer.size());
+			}
+			const Batch<Polygon> batch(std::move(buffer), offsets);
+		}}
 	});
-	std::vector<double> durations_mt = benchmarker::Benchmarker::run_const<apex::Polygon>("Area MT", benchmarker::generate_polygon_circle, benchmarker::sizes_polygon_big, [](const apex::Polygon& polygon) {
-		apex::detail::area_mt(polygon);
+	for(const std::pair<std::string, std::function<Batch<Polygon>(const size_t)>>& input : std::vector<std::pair<std::string, std::function<Batch<Polygon>(const size_t)>>>{{"mixed", batch_mixed}, {"fragmented", batch_fragmented}}) {
+		bench<Batch<Polygon>>("batch_copy", input.first, input.second, sizes_polygon_batch_exponential, {
+			{"copy", [](const Batch<Polygon>& source) { const Batch<Polygon> copy(source); }}
+		});
+	}
+	bench_mutating<Batch<Polygon>>("batch_shrink_to_fit", "fragmented", batch_fragmented, sizes_polygon_batch_exponential, {
+		{"shrink_to_fit", [](Batch<Polygon>& batch) { batch.shrink_to_fit(); }}
 	});
-	std::vector<double> durations_gpu = benchmarker::Benchmarker::run_const<apex::Polygon>("Area GPU", benchmarker::generate_polygon_circle, benchmarker::sizes_polygon_big, [](const apex::Polygon& polygon) {
-		apex::detail::area_gpu(polygon);
+
+	bench<Polygon>("bounding_box", "star", star, sizes_polygon_exponential, {
+		{"ST", [](const Polygon& polygon) { apex::detail::bounding_box_st(polygon); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::bounding_box_mt(polygon); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::bounding_box_gpu(polygon); }}
+	});
+	bench<Batch<Polygon>>("bounding_box_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_mt(batch); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::bounding_box_gpu(batch); }}
+	});
+
+	//Two rows of 10-gons, shifted by half of the spacing such that each polygon overlaps with two polygons of the other row. The size is the number of edges.
+	typedef std::pair<Batch<Polygon>, Batch<Polygon>> Shapes;
+	const std::function<Shapes(const size_t)> overlapping_shapes = [](const size_t size) {
+		Batch<Polygon> a = benchmarker::generate_polygon_batch_10gon(size / 20);
+		Batch<Polygon> b = a;
+		for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+			apex::translate(a[polygon], apex::Point2(apex::coord_t(polygon) * 60, 0));
+			apex::translate(b[polygon], apex::Point2(apex::coord_t(polygon) * 60 + 30, 20));
+		}
+		return Shapes(std::move(a), std::move(b));
+	};
+	const auto clip_edges = [](const Shapes& test_data) {
+		std::vector<apex::detail::ClipEdge> edges;
+		apex::detail::clip_add_edges(test_data.first, 0, edges);
+		apex::detail::clip_add_edges(test_data.second, 1, edges);
+		return edges;
+	};
+	bench<Shapes>("clip", "10-gon rows", overlapping_shapes, sizes_polygon_exponential, {
+		{"ST", [&clip_edges](const Shapes& test_data) { apex::detail::clip_st(clip_edges(test_data), apex::BooleanOperation::UNION, apex::FillRule::NONZERO); }},
+		{"MT", [&clip_edges](const Shapes& test_data) { apex::detail::clip_mt(clip_edges(test_data), apex::BooleanOperation::UNION, apex::FillRule::NONZERO); }}
 	});
 
-	//Output the results to terminal for now.
-	benchmarker::Benchmarker::output_cout<3>({"ST", "MT", "GPU"}, benchmarker::sizes_polygon_big, {durations_st, durations_mt, durations_gpu});
+	bench<Polygon>("contains", "star", star, sizes_polygon_exponential, {
+		{"ST", [](const Polygon& polygon) { apex::detail::contains_st(polygon, apex::Point2(0, 0)); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::contains_mt(polygon, apex::Point2(0, 0)); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::contains_gpu(polygon, apex::Point2(0, 0)); }}
+	});
+	typedef std::pair<Batch<Polygon>, Batch<apex::Point2>> BatchPoints;
+	const std::function<BatchPoints(const size_t)> mixed_with_points = [](const size_t size) {
+		Batch<Polygon> batch = benchmarker::generate_polygon_batch_mixed(size);
+		Batch<apex::Point2> points;
+		points.reserve(batch.size());
+		for(const apex::Subbatch<apex::Point2>& polygon : batch) {
+			points.push_back(polygon[0]); //Test a point on the boundary, which is the hardest case.
+		}
+		return BatchPoints(std::move(batch), std::move(points));
+	};
+	bench<BatchPoints>("contains_batch", "mixed", mixed_with_points, sizes_polygon_batch_exponential, {
+		{"ST", [](const BatchPoints& test_data) { apex::detail::contains_st(test_data.first, test_data.second); }},
+		{"MT", [](const BatchPoints& test_data) { apex::detail::contains_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const BatchPoints& test_data) { apex::detail::contains_gpu(test_data.first, test_data.second); }}
+	});
 
-	//Repeat for the area of batches of polygons.
-	std::cout << "_______ [AREA] _______" << std::endl;
-	durations_st = benchmarker::Benchmarker::run_const<apex::Batch<apex::Polygon>>("[Area] ST", benchmarker::generate_polygon_batch_10gon, benchmarker::sizes_polygon_batch_big, [](const apex::Batch<apex::Polygon>& batch) {
-		apex::detail::area_st(batch);
+	for(const std::pair<std::string, std::function<Polygon(const size_t)>>& input : std::vector<std::pair<std::string, std::function<Polygon(const size_t)>>>{{"star", star}, {"degenerate", degenerate}}) {
+		bench<Polygon>("convexity", input.first, input.second, sizes_polygon_exponential, {
+			{"ST", [](const Polygon& polygon) { apex::detail::turns_st(polygon); }},
+			{"MT", [](const Polygon& polygon) { apex::detail::turns_mt(polygon); }},
+			{"GPU", [](const Polygon& polygon) { apex::detail::turns_gpu(polygon); }}
+		});
+	}
+	bench<Batch<Polygon>>("convexity_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::turns_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::turns_mt(batch); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::turns_gpu(batch); }}
 	});
-	durations_mt = benchmarker::Benchmarker::run_const<apex::Batch<apex::Polygon>>("[Area] MT", benchmarker::generate_polygon_batch_10gon, benchmarker::sizes_polygon_batch_big, [](const apex::Batch<apex::Polygon>& batch) {
-		apex::detail::area_mt(batch);
+
+	//The line segments are spread over a square of 1000 by 1000 units, such that some of them intersect.
+	typedef std::pair<Batch<apex::LineSegment>, Batch<apex::LineSegment>> SegmentPairs;
+	const std::function<SegmentPairs(const size_t)> segment_pairs = [](const size_t size) {
+		SegmentPairs result;
+		for(size_t segment = 0; segment < size * 2; ++segment) {
+			const apex::Point2 start((segment * 37) % 1000, (segment * 91) % 1000);
+			(segment < size ? result.first : result.second).emplace_back(start, start + apex::Point2(apex::coord_t(segment % 13) * 10 - 60, apex::coord_t(segment % 7) * 10 - 30));
+		}
+		return result;
+	};
+	bench<SegmentPairs>("intersects_segments", "scattered", segment_pairs, sizes_polygon_exponential, {
+		{"ST", [](const SegmentPairs& test_data) { apex::detail::intersects_st(test_data.first, test_data.second); }},
+		{"MT", [](const SegmentPairs& test_data) { apex::detail::intersects_mt(test_data.first, test_data.second); }},
+		{"GPU", [](const SegmentPairs& test_data) { apex::detail::intersects_gpu(test_data.first, test_data.second); }}
 	});
-	durations_gpu = benchmarker::Benchmarker::run_const<apex::Batch<apex::Polygon>>("[Area] GPU", benchmarker::generate_polygon_batch_10gon, benchmarker::sizes_polygon_batch_big, [](const apex::Batch<apex::Polygon>& batch) {
-		apex::detail::area_gpu(batch);
+
+	//Offsetting outwards, so that the concave corners of the stars need to be resolved by the union.
+	bench<Polygon>("offset", "star", star, sizes_polygon_exponential, {
+		{"ST", [](const Polygon& polygon) { apex::detail::offset_st(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }},
+		{"MT", [](const Polygon& polygon) { apex::detail::offset_mt(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }},
+		{"GPU", [](const Polygon& polygon) { apex::detail::offset_gpu(apex::detail::offset_prepare(polygon), 10, apex::JoinType::ROUND); }}
 	});
+	bench<Batch<Polygon>>("offset_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::offset_st(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::offset_mt(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }},
+		{"GPU", [](const Batch<Polygon>& batch) { apex::detail::offset_gpu(apex::detail::offset_prepare(batch), 10, apex::JoinType::ROUND); }}
+	}, {offset_batch_limit, offset_batch_limit, offset_batch_limit});
 
-	//Output the results to terminal for now.
-	benchmarker::Benchmarker::output_cout<3>({"ST", "MT", "GPU"}, benchmarker::sizes_polygon_batch_big, {durations_st, durations_mt, durations_gpu});
+	for(const std::pair<std::string, std::function<Polygon(const size_t)>>& input : std::vector<std::pair<std::string, std::function<Polygon(const size_t)>>>{{"star", star}, {"degenerate", degenerate}}) {
+		bench<Polygon>("self_intersections", input.first, input.second, sizes_polygon_exponential, {
+			{"naive", [](const Polygon& polygon) { apex::detail::self_intersections_st_naive(polygon); }},
+			{"sweep", [](const Polygon& polygon) { apex::detail::self_intersections_st_sweep(polygon); }},
+			{"grid", [](const Polygon& polygon) { apex::detail::self_intersections_mt_grid(polygon); }}
+		}, {quadratic_limit, apex::detail::no_crossover, apex::detail::no_crossover});
+	}
+	bench<Batch<Polygon>>("self_intersections_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [](const Batch<Polygon>& batch) { apex::detail::self_intersections_st(batch); }},
+		{"MT", [](const Batch<Polygon>& batch) { apex::detail::self_intersections_mt(batch); }}
+	});
+
+	const apex::AffineTransform rotation = apex::AffineTransform::rotation(0.1);
+	bench_mutating<Polygon>("transform", "star", star, sizes_polygon_exponential, {
+		{"ST", [&rotation](Polygon& polygon) { apex::detail::transform_st(polygon, rotation); }},
+		{"MT", [&rotation](Polygon& polygon) { apex::detail::transform_mt(polygon, rotation); }},
+		{"GPU", [&rotation](Polygon& polygon) { apex::detail::transform_gpu(polygon, rotation); }}
+	});
+	bench_mutating<Batch<Polygon>>("transform_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [&rotation](Batch<Polygon>& batch) { apex::detail::transform_st(batch, rotation); }},
+		{"MT", [&rotation](Batch<Polygon>& batch) { apex::detail::transform_mt(batch, rotation); }},
+		{"GPU", [&rotation](Batch<Polygon>& batch) { apex::detail::transform_gpu(batch, rotation); }}
+	});
+
+	bench_mutating<Polygon>("translate", "star", star, sizes_polygon_exponential, {
+		{"ST", [](Polygon& polygon) { apex::detail::translate_st(polygon, apex::Point2(1, 1)); }},
+		{"MT", [](Polygon& polygon) { apex::detail::translate_mt(polygon, apex::Point2(1, 1)); }},
+		{"GPU", [](Polygon& polygon) { apex::detail::translate_gpu(polygon, apex::Point2(1, 1)); }}
+	});
+	bench_mutating<Batch<Polygon>>("translate_batch", "mixed", batch_mixed, sizes_polygon_batch_exponential, {
+		{"ST", [](Batch<Polygon>& batch) { apex::detail::translate_st(batch, apex::Point2(1, 1)); }},
+		{"MT", [](Batch<Polygon>& batch) { apex::detail::translate_mt(batch, apex::Point2(1, 1)); }},
+		{"GPU", [](Batch<Polygon>& batch) { apex::detail::translate_gpu(batch, apex::Point2(1, 1)); }}
+	});
 
+	if(!csv_filename.empty()) {
+		std::ofstream csv_file(csv_filename);
+		benchmarker::Benchmarker::output_csv(csv_file, records);
+		if(!csv_file.good()) {
+			std::cerr << "Could not write the results to " << csv_filename << std::endl;
+			return 1;
+		}
+	}
+	if(!json_filename.empty()) {
+		std::ofstream json_file(json_filename);
+		benchmarker::Benchmarker::output_json(json_file, records);
+		if(!json_file.good()) {
+			std::cerr << "Could not write the results to " << json_filename << std::endl;
+			return 1;
+		}
+	}
 	return 0;
 }
\ No newline at end of file
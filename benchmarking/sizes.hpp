@@ -53,6 +53,37 @@ static std::vector<size_t> sizes_polygon_batch_big = {
 	1000
 };
 
+/*!
+ * A list of sizes for benchmarking polygons over a wide range of sizes.
+ *
+ * The sizes grow exponentially, from trivial polygons to big ones. This is
+ * useful to compare many operations and versions in one benchmark run.
+ */
+static std::vector<size_t> sizes_polygon_exponential = {
+	3, 10, 30, 100, 300, 1000, 3000, 10000
+};
+
+/*!
+ * A list of sizes for benchmarking batches of polygons over a wide range of
+ * sizes.
+ *
+ * The sizes grow exponentially, from a single polygon to big amounts of data.
+ * This is useful to compare many operations and versions in one benchmark run.
+ */
+static std::vector<size_t> sizes_polygon_batch_exponential = {
+	1, 3, 10, 30, 100, 300, 1000, 3000, 10000
+};
+
+/*!
+ * A list of sizes for calibrating which version of an operation to use.
+ *
+ * The sizes grow exponentially, to find the crossovers between versions over a
+ * wide range of input sizes with few measurements.
+ */
+static std::vector<size_t> sizes_calibration = {
+	16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536, 131072
+};
+
 }
 
 #endif //BENCHMARKER_SIZES
\ No newline at end of file
@@ -0,0 +1,339 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_AFFINE_TRANSFORM
+#define APEX_AFFINE_TRANSFORM
+
+#include <algorithm> //For std::max and std::clamp.
+#include <cmath> //To quantise rotations and scales to fixed-point coefficients.
+#include <limits> //To saturate the results to the range of coordinates.
+#include <ostream> //To overload printing the transformation to a stream.
+
+#include "coordinate.hpp" //To store the coefficients with enough precision.
+#include "point2.hpp" //To transform points.
+
+namespace apex {
+
+/*!
+ * The maximum number of fraction bits of the coefficients of an
+ * \ref AffineTransform.
+ *
+ * The limits of affine transformations are defined outside of the class, so
+ * that the class can be mapped to the GPU.
+ */
+constexpr int max_transform_fraction_bits = 29;
+
+/*!
+ * The maximum magnitude of each coefficient of the linear part of an
+ * \ref AffineTransform, in units of \f$2^{-fraction\_bits}\f$.
+ *
+ * The product of a coefficient with a coordinate then takes at most 61 bits, so
+ * that the sum of two of them still fits in ``area_t``.
+ */
+constexpr area_t max_transform_coefficient = area_t(1) << 29;
+
+/*!
+ * The maximum magnitude of the translation of an \ref AffineTransform.
+ *
+ * This allows moving from one end of the coordinate space to the other, and is
+ * small enough to compose with any linear part without overflowing.
+ */
+constexpr area_t max_transform_translation = area_t(1) << 32;
+
+/*!
+ * A linear transformation followed by a translation, in 2D space.
+ *
+ * This is a 2x3 matrix. Transforming a point with it multiplies the point with
+ * the 2x2 linear part of the matrix, and then adds the translation:
+ * \f$x' = xx \cdot x + xy \cdot y + t_x \\
+ * y' = yx \cdot x + yy \cdot y + t_y\f$
+ *
+ * To stay in integer arithmetic, the coefficients of the linear part are stored
+ * as fixed-point numbers. They are integers that are implicitly divided by
+ * \f$2^{fraction\_bits}\f$. The number of fraction bits is chosen per
+ * transformation, as high as possible for the precision while still fitting
+ * the coefficients. A scale by an integer factor therefore has no fraction bits
+ * and is exact, while for a rotation the coefficients have 29 fraction bits.
+ * The translation is an integer, so it is exact too.
+ *
+ * The coefficients are limited to \ref max_transform_coefficient and the
+ * translation to \ref max_transform_translation. Together with the 32-bit
+ * coordinates, that guarantees that transforming a point can't overflow the
+ * 64-bit intermediate results. The results are rounded to the nearest
+ * coordinate and saturated to the range of ``coord_t``, so points that would
+ * end up outside of the coordinate space end up on its border instead of
+ * wrapping around.
+ *
+ * Transformations can be composed with \ref then, which gives a transformation
+ * that performs both at once. Transforming a polygon with the composition only
+ * needs to read and write each vertex once, instead of once for each step. It
+ * is also more accurate, since the result is only rounded once.
+ *
+ * The transformation is always stored in a normalised form: without redundant
+ * fraction bits. Two transformations that do the same thing therefore compare
+ * equal.
+ */
+class AffineTransform {
+public:
+	/*!
+	 * The coefficient of the X coordinate in the resulting X coordinate.
+	 */
+	area_t xx;
+
+	/*!
+	 * The coefficient of the Y coordinate in the resulting X coordinate.
+	 */
+	area_t xy;
+
+	/*!
+	 * The coefficient of the X coordinate in the resulting Y coordinate.
+	 */
+	area_t yx;
+
+	/*!
+	 * The coefficient of the Y coordinate in the resulting Y coordinate.
+	 */
+	area_t yy;
+
+	/*!
+	 * The distance to move in the X direction, after the linear part.
+	 */
+	area_t translation_x;
+
+	/*!
+	 * The distance to move in the Y direction, after the linear part.
+	 */
+	area_t translation_y;
+
+	/*!
+	 * The number of bits of the coefficients that are behind the binary point.
+	 */
+	int fraction_bits;
+
+	/*!
+	 * Creates the identity transformation, which doesn't change anything.
+	 */
+	constexpr AffineTransform() : xx(1), xy(0), yx(0), yy(1), translation_x(0), translation_y(0), fraction_bits(0) {}
+
+	/*!
+	 * Creates a transformation from its fixed-point coefficients.
+	 *
+	 * Coefficients and translations that are out of range are saturated. If
+	 * the coefficients have more fraction bits than
+	 * \ref max_transform_fraction_bits, or don't fit with this many fraction
+	 * bits, precision is reduced until they do.
+	 * \param xx The coefficient of the X coordinate in the resulting X
+	 * coordinate.
+	 * \param xy The coefficient of the Y coordinate in the resulting X
+	 * coordinate.
+	 * \param yx The coefficient of the X coordinate in the resulting Y
+	 * coordinate.
+	 * \param yy The coefficient of the Y coordinate in the resulting Y
+	 * coordinate.
+	 * \param translation_x The distance to move in the X direction.
+	 * \param translation_y The distance to move in the Y direction.
+	 * \param fraction_bits The number of bits of the coefficients that are
+	 * behind the binary point.
+	 */
+	constexpr AffineTransform(const area_t xx, const area_t xy, const area_t yx, const area_t yy, const area_t translation_x = 0, const area_t translation_y = 0, const int fraction_bits = 0) :
+		xx(xx), xy(xy), yx(yx), yy(yy), translation_x(translation_x), translation_y(translation_y), fraction_bits(std::max(fraction_bits, 0)) {
+		normalise();
+	}
+
+	/*!
+	 * Creates a transformation that moves points by a certain offset.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 * \return A transformation that moves points by the given offset.
+	 */
+	static constexpr AffineTransform translation(const Point2& delta) {
+		return AffineTransform(1, 0, 0, 1, delta.x, delta.y);
+	}
+
+	/*!
+	 * Creates a transformation that scales points away from the origin.
+	 *
+	 * Negative factors mirror the points as well.
+	 * \param factor_x The factor to multiply the X coordinates with.
+	 * \param factor_y The factor to multiply the Y coordinates with.
+	 * \return A transformation that scales points by the given factors.
+	 */
+	static AffineTransform scaling(const double factor_x, const double factor_y) {
+		return matrix(factor_x, 0, 0, factor_y);
+	}
+
+	/*!
+	 * Creates a transformation that scales points uniformly away from the
+	 * origin.
+	 * \param factor The factor to multiply the coordinates with.
+	 * \return A transformation that scales points by the given factor.
+	 */
+	static AffineTransform scaling(const double factor) {
+		return scaling(factor, factor);
+	}
+
+	/*!
+	 * Creates a transformation that rotates points around the origin.
+	 * \param angle The angle to rotate by, in radians. Positive angles rotate
+	 * counter-clockwise, from the positive X axis towards the positive Y axis.
+	 * \return A transformation that rotates points by the given angle.
+	 */
+	static AffineTransform rotation(const double angle) {
+		const double cosine = std::cos(angle);
+		const double sine = std::sin(angle);
+		return matrix(cosine, -sine, sine, cosine);
+	}
+
+	/*!
+	 * Creates a transformation from a matrix of floating point coefficients.
+	 *
+	 * The coefficients are rounded to fixed-point numbers with as many fraction
+	 * bits as they allow.
+	 * \param xx The coefficient of the X coordinate in the resulting X
+	 * coordinate.
+	 * \param xy The coefficient of the Y coordinate in the resulting X
+	 * coordinate.
+	 * \param yx The coefficient of the X coordinate in the resulting Y
+	 * coordinate.
+	 * \param yy The coefficient of the Y coordinate in the resulting Y
+	 * coordinate.
+	 * \param translation The distance to move after the linear part.
+	 * \return A transformation with the given matrix.
+	 */
+	static AffineTransform matrix(const double xx, const double xy, const double yx, const double yy, const Point2& translation = Point2(0, 0)) {
+		const double largest = std::max({std::abs(xx), std::abs(xy), std::abs(yx), std::abs(yy)});
+		int bits = max_transform_fraction_bits;
+		while(bits > 0 && std::ldexp(largest, bits) > max_transform_coefficient) {
+			--bits;
+		}
+		return AffineTransform(quantise(xx, bits), quantise(xy, bits), quantise(yx, bits), quantise(yy, bits), translation.x, translation.y, bits);
+	}
+
+	/*!
+	 * Compose this transformation with another one, performed afterwards.
+	 *
+	 * The result transforms points the same way as transforming them with this
+	 * transformation first and then with the other, but in a single step.
+	 * Since that step rounds only once, the result may differ by a unit from
+	 * performing the steps separately.
+	 * \param next The transformation to perform after this one.
+	 * \return A transformation that performs both transformations.
+	 */
+	constexpr AffineTransform then(const AffineTransform& next) const {
+		return AffineTransform( //The products of the coefficients use at most 58 bits, so these sums can't overflow.
+			next.xx * xx + next.xy * yx,
+			next.xx * xy + next.xy * yy,
+			next.yx * xx + next.yy * yx,
+			next.yx * xy + next.yy * yy,
+			round_shift(next.xx * translation_x + next.xy * translation_y, next.fraction_bits) + next.translation_x,
+			round_shift(next.yx * translation_x + next.yy * translation_y, next.fraction_bits) + next.translation_y,
+			next.fraction_bits + fraction_bits);
+	}
+
+	/*!
+	 * Transform a point.
+	 *
+	 * The result is rounded to the nearest coordinate, rounding away from zero
+	 * if it's exactly halfway. If the result doesn't fit in ``coord_t``, it is
+	 * saturated to the nearest coordinate that does.
+	 * \param point The point to transform.
+	 * \return The transformed point.
+	 */
+	constexpr Point2 apply(const Point2& point) const {
+		const area_t x = round_shift(xx * point.x + xy * point.y, fraction_bits) + translation_x;
+		const area_t y = round_shift(yx * point.x + yy * point.y, fraction_bits) + translation_y;
+		return Point2(saturate(x), saturate(y));
+	}
+
+	/*!
+	 * Compare two transformations for equality.
+	 *
+	 * Since transformations are normalised, they compare equal if they
+	 * transform all points the same way.
+	 * \param other The transformation to compare with.
+	 * \return ``true`` if the transformations are equal, or ``false`` if they
+	 * are different.
+	 */
+	constexpr bool operator ==(const AffineTransform& other) const = default;
+
+	/*!
+	 * Overloads streaming this transformation.
+	 *
+	 * This is useful for debugging, since it allows printing the transformation
+	 * to a stream directly, giving you a reasonably readable output.
+	 */
+	friend std::ostream& operator <<(std::ostream& output_stream, const AffineTransform& transformation) {
+		return output_stream << "[" << transformation.xx << "," << transformation.xy << "," << transformation.translation_x << ";" << transformation.yx << "," << transformation.yy << "," << transformation.translation_y << "]/2^" << transformation.fraction_bits;
+	}
+
+protected:
+	/*!
+	 * Shift a number to the right, rounding to the nearest integer.
+	 *
+	 * If the result ends up exactly halfway between two integers, it is rounded
+	 * away from zero, the same as \ref round_divide. Shifting is much cheaper
+	 * than dividing though.
+	 * \param value The number to shift.
+	 * \param bits The number of bits to shift by.
+	 * \return The number, divided by \f$2^{bits}\f$ and rounded.
+	 */
+	static constexpr area_t round_shift(const area_t value, const int bits) {
+		const area_t half = (area_t(1) << bits) >> 1;
+		return (value < 0) ? -((half - value) >> bits) : ((value + half) >> bits);
+	}
+
+	/*!
+	 * Limit a transformed coordinate to the range of ``coord_t``.
+	 * \param value The coordinate to limit.
+	 * \return The nearest coordinate that fits in ``coord_t``.
+	 */
+	static constexpr coord_t saturate(const area_t value) {
+		return value < std::numeric_limits<coord_t>::min() ? std::numeric_limits<coord_t>::min() : (value > std::numeric_limits<coord_t>::max() ? std::numeric_limits<coord_t>::max() : coord_t(value));
+	}
+
+	/*!
+	 * Round a floating point coefficient to a fixed-point number.
+	 * \param coefficient The coefficient to round.
+	 * \param bits The number of fraction bits of the result.
+	 * \return The fixed-point coefficient.
+	 */
+	static area_t quantise(const double coefficient, const int bits) {
+		return std::llround(std::clamp(std::ldexp(coefficient, bits), double(-max_transform_coefficient), double(max_transform_coefficient)));
+	}
+
+	/*!
+	 * Bring the coefficients in the range where they can't overflow, and remove
+	 * redundant fraction bits.
+	 */
+	constexpr void normalise() {
+		while(fraction_bits > max_transform_fraction_bits || (fraction_bits > 0 && std::max({xx, -xx, xy, -xy, yx, -yx, yy, -yy}) > max_transform_coefficient)) {
+			xx = round_shift(xx, 1); //Give up precision to fit the coefficients.
+			xy = round_shift(xy, 1);
+			yx = round_shift(yx, 1);
+			yy = round_shift(yy, 1);
+			--fraction_bits;
+		}
+		xx = std::clamp(xx, -max_transform_coefficient, max_transform_coefficient); //Without any fraction bits left, all we can do is saturate.
+		xy = std::clamp(xy, -max_transform_coefficient, max_transform_coefficient);
+		yx = std::clamp(yx, -max_transform_coefficient, max_transform_coefficient);
+		yy = std::clamp(yy, -max_transform_coefficient, max_transform_coefficient);
+		while(fraction_bits > 0 && ((xx | xy | yx | yy) & 1) == 0) { //Drop trailing zero bits, which makes integer scales exact and the representation unique.
+			xx >>= 1;
+			xy >>= 1;
+			yx >>= 1;
+			yy >>= 1;
+			--fraction_bits;
+		}
+		translation_x = std::clamp(translation_x, -max_transform_translation, max_transform_translation);
+		translation_y = std::clamp(translation_y, -max_transform_translation, max_transform_translation);
+	}
+};
+
+}
+
+#endif //APEX_AFFINE_TRANSFORM
\ No newline at end of file
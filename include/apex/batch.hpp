@@ -9,8 +9,12 @@
 #ifndef APEX_BATCH
 #define APEX_BATCH
 
+#include <limits> //To indicate that a subbatch can grow indefinitely.
+#include <memory_resource> //To allow allocating the elements from a custom memory resource.
 #include <numeric> //For std::accumulate.
+#include <span> //To take the sizes or offsets of subbatches from any contiguous container.
 #include <stdexcept> //For std::out_of_range.
+#include <utility> //For std::move.
 #include <vector> //Providing the base data structure to store elements in.
 
 namespace apex {
@@ -50,12 +54,21 @@ class Subbatch;
  * the user can't accidentally cast to vectors, but we still get to re-use its
  * implementation.
  *
- * This batch doesn't support customising the allocator. If a specific allocator
- * is necessary, it should be customised in the template specialisation.
+ * The memory of the batch is allocated through a polymorphic memory resource.
+ * By default this is the default memory resource of the program, which
+ * allocates on the heap unless changed. A different memory resource can be
+ * given upon construction, such as an arena that is released all at once after
+ * a job is completed. This avoids many separate allocations and deallocations
+ * that compete for the global heap across threads. The memory resource is not
+ * propagated when copying, moving or swapping batches, like with the
+ * containers of the standard library. Copies use the default memory resource.
+ * Moving to a batch with a different memory resource needs to move each
+ * element separately. Swapping batches with different memory resources is not
+ * allowed.
  * \tparam Element The type of elements stored in this batch.
  */
 template<typename Element>
-class Batch : protected std::vector<Element> {
+class Batch : protected std::pmr::vector<Element> {
 public:
 	/*!
 	 * Iterates in the forward direction over elements of this batch.
@@ -63,7 +76,7 @@ public:
 	 * This is a random access iterator, which allows addition and subtraction,
 	 * is bidirectional and allows iterating multiple times.
 	 */
-	using iterator = typename std::vector<Element>::iterator;
+	using iterator = typename std::pmr::vector<Element>::iterator;
 
 	/*!
 	 * Iterates in the forward direction over elements of this batch.
@@ -72,7 +85,7 @@ public:
 	 * access iterator, which allows addition and subtraction, is bidirectional
 	 * and allows iterating multiple times.
 	 */
-	using const_iterator = typename std::vector<Element>::const_iterator;
+	using const_iterator = typename std::pmr::vector<Element>::const_iterator;
 
 	/*!
 	 * Iterates in the backward direction over elements of this batch, as if the
@@ -81,7 +94,7 @@ public:
 	 * This is a random access iterator, which allows addition and subtraction,
 	 * is bidirectional and allows iterating multiple times.
 	 */
-	using reverse_iterator = typename std::vector<Element>::reverse_iterator;
+	using reverse_iterator = typename std::pmr::vector<Element>::reverse_iterator;
 
 	/*!
 	 * Iterates in the backward direction over elements of this batch, as if the
@@ -91,44 +104,53 @@ public:
 	 * access iterator, which allows addition and subtraction, is bidirectional
 	 * and allows iterating multiple times.
 	 */
-	using const_reverse_iterator = typename std::vector<Element>::const_reverse_iterator;
+	using const_reverse_iterator = typename std::pmr::vector<Element>::const_reverse_iterator;
 
 	//Inheriting all functions of vectors in this case, completely transparently.
-	using std::vector<Element>::operator =;
-	using std::vector<Element>::operator [];
-	using std::vector<Element>::assign;
-	using std::vector<Element>::at;
-	using std::vector<Element>::back;
-	using std::vector<Element>::begin;
-	using std::vector<Element>::capacity;
-	using std::vector<Element>::cbegin;
-	using std::vector<Element>::cend;
-	using std::vector<Element>::clear;
-	using std::vector<Element>::crbegin;
-	using std::vector<Element>::crend;
-	using std::vector<Element>::data;
-	using std::vector<Element>::emplace;
-	using std::vector<Element>::emplace_back;
-	using std::vector<Element>::empty;
-	using std::vector<Element>::end;
-	using std::vector<Element>::erase;
-	using std::vector<Element>::front;
-	using std::vector<Element>::insert;
-	using std::vector<Element>::max_size;
-	using std::vector<Element>::pop_back;
-	using std::vector<Element>::push_back;
-	using std::vector<Element>::rbegin;
-	using std::vector<Element>::rend;
-	using std::vector<Element>::reserve;
-	using std::vector<Element>::resize;
-	using std::vector<Element>::shrink_to_fit;
-	using std::vector<Element>::size;
-	using std::vector<Element>::swap;
+	using std::pmr::vector<Element>::operator =;
+	using std::pmr::vector<Element>::operator [];
+	using std::pmr::vector<Element>::assign;
+	using std::pmr::vector<Element>::at;
+	using std::pmr::vector<Element>::back;
+	using std::pmr::vector<Element>::begin;
+	using std::pmr::vector<Element>::capacity;
+	using std::pmr::vector<Element>::cbegin;
+	using std::pmr::vector<Element>::cend;
+	using std::pmr::vector<Element>::clear;
+	using std::pmr::vector<Element>::crbegin;
+	using std::pmr::vector<Element>::crend;
+	using std::pmr::vector<Element>::data;
+	using std::pmr::vector<Element>::emplace;
+	using std::pmr::vector<Element>::emplace_back;
+	using std::pmr::vector<Element>::empty;
+	using std::pmr::vector<Element>::end;
+	using std::pmr::vector<Element>::erase;
+	using std::pmr::vector<Element>::front;
+	using std::pmr::vector<Element>::insert;
+	using std::pmr::vector<Element>::max_size;
+	using std::pmr::vector<Element>::pop_back;
+	using std::pmr::vector<Element>::push_back;
+	using std::pmr::vector<Element>::rbegin;
+	using std::pmr::vector<Element>::rend;
+	using std::pmr::vector<Element>::reserve;
+	using std::pmr::vector<Element>::resize;
+	using std::pmr::vector<Element>::shrink_to_fit;
+	using std::pmr::vector<Element>::size;
+	using std::pmr::vector<Element>::swap;
 
 	/*!
 	 * Construct an empty batch.
 	 */
-	Batch() noexcept : std::vector<Element>() {}
+	Batch() noexcept : std::pmr::vector<Element>() {}
+
+	/*!
+	 * Construct an empty batch that allocates its memory from a specific memory
+	 * resource.
+	 *
+	 * The memory resource must outlive the batch.
+	 * \param resource The memory resource to allocate the elements from.
+	 */
+	explicit Batch(std::pmr::memory_resource* resource) noexcept : std::pmr::vector<Element>(resource) {}
 
 	/*!
 	 * Construct a batch containing the specified element repeated a number of
@@ -137,13 +159,13 @@ public:
 	 * \param value The element to fill the batch with. This element gets
 	 * repeated a number of times.
 	 */
-	Batch(const size_t count, const Element& value = Element()) : std::vector<Element>(count, value) {}
+	Batch(const size_t count, const Element& value = Element()) : std::pmr::vector<Element>(count, value) {}
 
 	/*!
 	 * Construct a batch containing default-inserted instances of the element.
 	 * \param count The amount of elements to fill the batch with.
 	 */
-	Batch(const size_t count) : std::vector<Element>(count) {}
+	Batch(const size_t count) : std::pmr::vector<Element>(count) {}
 
 	/*!
 	 * Construct a batch with the contents of the range ``[first, last)``.
@@ -154,13 +176,13 @@ public:
 	 * ended.
 	 */
 	template<class InputIterator>
-	Batch(InputIterator first, InputIterator last) : std::vector<Element>(first, last) {}
+	Batch(InputIterator first, InputIterator last) : std::pmr::vector<Element>(first, last) {}
 
 	/*!
 	 * Construct a batch from the contents of an initialiser list.
 	 * \param initialiser_list The list of elements to put in the new batch.
 	 */
-	Batch(std::initializer_list<Element> initialiser_list) : std::vector<Element>(initialiser_list) {}
+	Batch(std::initializer_list<Element> initialiser_list) : std::pmr::vector<Element>(initialiser_list) {}
 
 	/*!
 	 * Convert a subbatch into a real, normal batch.
@@ -169,7 +191,7 @@ public:
 	 * used. However, this does create a copy of the data in the subbatch.
 	 * \param subbatch The subbatch to convert to a normal batch.
 	 */
-	Batch(const Subbatch<Element>& subbatch) : std::vector<Element>(subbatch.begin(), subbatch.end()) {}
+	Batch(const Subbatch<Element>& subbatch) : std::pmr::vector<Element>(subbatch.begin(), subbatch.end()) {}
 
 	/*!
 	 * Construct a copy of the specified batch.
@@ -177,16 +199,18 @@ public:
 	 * All elements inside the batch will be copied as well.
 	 * \param other The batch to copy.
 	 */
-	Batch(const Batch& other) : std::vector<Element>(other) {}
+	Batch(const Batch& other) : std::pmr::vector<Element>(other) {}
 
 	/*!
 	 * Move constructor, moving one batch to another location using move
 	 * semantics.
 	 *
-	 * After the move, ``other`` is guaranteed to be empty.
+	 * This takes over the element buffer of the other batch, so it runs in
+	 * constant time and doesn't allocate any memory. After the move, ``other``
+	 * is guaranteed to be empty.
 	 * \param other The batch to move into the new batch.
 	 */
-	Batch(Batch&& other) noexcept : std::vector<Element>(other) {}
+	Batch(Batch&& other) noexcept : std::pmr::vector<Element>(std::move(other)) {}
 
 	//Because of the types involved here, Vector's own assignment operators are not useful when using just batches.
 	//We'll have to define these overloads ourselves.
@@ -199,19 +223,24 @@ public:
 	 * \return A reference to this batch.
 	 */
 	Batch& operator =(const Batch& other) {
-		std::vector<Element>::operator =(other);
+		std::pmr::vector<Element>::operator =(other);
 		return *this;
 	}
 
 	/*!
 	 * Moves the contents of the given batch into this batch.
 	 *
-	 * The given batch should no longer be used afterwards.
+	 * If both batches use the same memory resource, this takes over the
+	 * element buffer of the other batch, so it runs in constant time and
+	 * doesn't allocate any memory. Otherwise the elements are moved one by one
+	 * into memory from the resource of this batch, which may throw if that
+	 * resource can't allocate it. The given batch should no longer be used
+	 * afterwards.
 	 * \param other The batch to move into this batch.
 	 * \return A reference to this batch.
 	 */
-	Batch& operator =(Batch&& other) noexcept {
-		std::vector<Element>::operator =(other);
+	Batch& operator =(Batch&& other) {
+		std::pmr::vector<Element>::operator =(std::move(other));
 		return *this;
 	}
 
@@ -229,7 +258,7 @@ public:
 	 * inequal.
 	 */
 	bool operator ==(const Batch<Element>& other) const {
-		return (*this) == static_cast<const std::vector<Element>&>(other);
+		return (*this) == static_cast<const std::pmr::vector<Element>&>(other);
 	}
 
 	/*!
@@ -244,7 +273,7 @@ public:
 	 * equal.
 	 */
 	bool operator !=(const Batch<Element>& other) const {
-		return (*this) != static_cast<const std::vector<Element>&>(other);
+		return (*this) != static_cast<const std::pmr::vector<Element>&>(other);
 	}
 
 	/*!
@@ -255,7 +284,7 @@ public:
 	 * other batch.
 	 */
 	bool operator <(const Batch<Element>& other) const {
-		return (*this) < static_cast<const std::vector<Element>&>(other);
+		return (*this) < static_cast<const std::pmr::vector<Element>&>(other);
 	}
 
 	/*!
@@ -266,7 +295,7 @@ public:
 	 * batch.
 	 */
 	bool operator <=(const Batch<Element>& other) const {
-		return (*this) <= static_cast<const std::vector<Element>&>(other);
+		return (*this) <= static_cast<const std::pmr::vector<Element>&>(other);
 	}
 
 	/*!
@@ -277,7 +306,7 @@ public:
 	 * other batch.
 	 */
 	bool operator >(const Batch<Element>& other) const {
-		return (*this) > static_cast<const std::vector<Element>&>(other);
+		return (*this) > static_cast<const std::pmr::vector<Element>&>(other);
 	}
 
 	/*!
@@ -288,7 +317,15 @@ public:
 	 * batch.
 	 */
 	bool operator >=(const Batch<Element>& other) const {
-		return (*this) >= static_cast<const std::vector<Element>&>(other);
+		return (*this) >= static_cast<const std::pmr::vector<Element>&>(other);
+	}
+
+	/*!
+	 * Get the memory resource that this batch allocates its elements from.
+	 * \return The memory resource of this batch.
+	 */
+	std::pmr::memory_resource* get_memory_resource() const {
+		return std::pmr::vector<Element>::get_allocator().resource();
 	}
 
 	/*!
@@ -296,10 +333,11 @@ public:
 	 *
 	 * This swap is made by reference and can be executed in constant time,
 	 * without needing to copy or move the individual elements of the batches.
+	 * Both batches must use the same memory resource.
 	 * \param other The batch to swap contents with.
 	 */
 	void swap(Batch<Element>& other) noexcept {
-		static_cast<std::vector<Element>&>(other).swap(*this);
+		static_cast<std::pmr::vector<Element>&>(other).swap(*this);
 	}
 };
 
@@ -338,10 +376,13 @@ class Subbatch; //Forward declare this subbatch here so we can use it as templat
  *
  * There are also disadvantages to this approach. It essentially operates as a
  * monotonic allocator, so if any of the elements have to grow in size, they
- * will need to be moved in their entirety to the end of the buffer. There is
- * also no tracking of where there might be gaps halfway in the buffer to move
- * them to, so the buffer will only grow unless it is optimised with a manual
- * call. Consider frequent modifications of the batch to be inefficient, if the
+ * will need to be moved in their entirety to the end of the buffer, unless the
+ * space right after them happens to be free. There is no tracking of where
+ * there might be gaps halfway in the buffer to move them to. Instead, when the
+ * buffer needs to grow while too much of it consists of gaps, it is compacted
+ * first. How much dead space is tolerated can be configured with
+ * \ref set_compaction_threshold, and measured with \ref fragmentation.
+ * Consider frequent modifications of the batch to be inefficient, if the
  * modifications cause the subbatches to grow.
  *
  * The subbatches introduce a level of indirection when accessing individual
@@ -359,10 +400,14 @@ class Subbatch; //Forward declare this subbatch here so we can use it as templat
  * such, it is not suitable for data types that produce side effects in its
  * constructor or destructor. Only plain old data types can be used in these
  * batches.
+ *
+ * Both the subelement buffer and the table of subbatches are allocated from the
+ * same polymorphic memory resource, which can be given upon construction. The
+ * same rules apply to it as for the memory resource of normal batches.
  * \tparam Element The type of element stored in the subbatches.
  */
 template<typename Element>
-class Batch<Batch<Element>> : protected std::vector<Subbatch<Element>> { //Specialise batches of batches.
+class Batch<Batch<Element>> : protected std::pmr::vector<Subbatch<Element>> { //Specialise batches of batches.
 	friend class Subbatch<Element>; //Subbatches can access the coalesced data structure to get their own information.
 
 public:
@@ -372,7 +417,7 @@ public:
 	 * This is a random access iterator, which allows addition and subtraction,
 	 * is bidirectional and allows iterating multiple times.
 	 */
-	using iterator = typename std::vector<Subbatch<Element>>::iterator;
+	using iterator = typename std::pmr::vector<Subbatch<Element>>::iterator;
 
 	/*!
 	 * Iterates in the forward direction over elements of this batch.
@@ -381,7 +426,7 @@ public:
 	 * access iterator, which allows addition and subtraction, is bidirectional
 	 * and allows iterating multiple times.
 	 */
-	using const_iterator = typename std::vector<Subbatch<Element>>::const_iterator;
+	using const_iterator = typename std::pmr::vector<Subbatch<Element>>::const_iterator;
 
 	/*!
 	 * Iterates in the backward direction over elements of this batch, as if the
@@ -390,7 +435,7 @@ public:
 	 * This is a random access iterator, which allows addition and subtraction,
 	 * is bidirectional and allows iterating multiple times.
 	 */
-	using reverse_iterator = typename std::vector<Subbatch<Element>>::reverse_iterator;
+	using reverse_iterator = typename std::pmr::vector<Subbatch<Element>>::reverse_iterator;
 
 	/*!
 	 * Iterates in the backward direction over elements of this batch, as if the
@@ -400,29 +445,29 @@ public:
 	 * access iterator, which allows addition and subtraction, is bidirectional
 	 * and allows iterating multiple times.
 	 */
-	using const_reverse_iterator = typename std::vector<Subbatch<Element>>::const_reverse_iterator;
+	using const_reverse_iterator = typename std::pmr::vector<Subbatch<Element>>::const_reverse_iterator;
 
 	//Many functions can be taken over directly from the underlying vector class.
-	using std::vector<Subbatch<Element>>::operator[];
-	using std::vector<Subbatch<Element>>::at;
-	using std::vector<Subbatch<Element>>::back;
-	using std::vector<Subbatch<Element>>::begin;
-	using std::vector<Subbatch<Element>>::capacity;
-	using std::vector<Subbatch<Element>>::cbegin;
-	using std::vector<Subbatch<Element>>::cend;
-	using std::vector<Subbatch<Element>>::crbegin;
-	using std::vector<Subbatch<Element>>::crend;
-	using std::vector<Subbatch<Element>>::data; //Gets the data pointing to the subbatches, not the subelement data.
-	using std::vector<Subbatch<Element>>::empty;
-	using std::vector<Subbatch<Element>>::erase;
-	using std::vector<Subbatch<Element>>::end;
-	using std::vector<Subbatch<Element>>::front;
-	using std::vector<Subbatch<Element>>::max_size;
-	using std::vector<Subbatch<Element>>::pop_back;
-	using std::vector<Subbatch<Element>>::rbegin;
-	using std::vector<Subbatch<Element>>::rend;
-	using std::vector<Subbatch<Element>>::reserve;
-	using std::vector<Subbatch<Element>>::size;
+	using std::pmr::vector<Subbatch<Element>>::operator[];
+	using std::pmr::vector<Subbatch<Element>>::at;
+	using std::pmr::vector<Subbatch<Element>>::back;
+	using std::pmr::vector<Subbatch<Element>>::begin;
+	using std::pmr::vector<Subbatch<Element>>::capacity;
+	using std::pmr::vector<Subbatch<Element>>::cbegin;
+	using std::pmr::vector<Subbatch<Element>>::cend;
+	using std::pmr::vector<Subbatch<Element>>::crbegin;
+	using std::pmr::vector<Subbatch<Element>>::crend;
+	using std::pmr::vector<Subbatch<Element>>::data; //Gets the data pointing to the subbatches, not the subelement data.
+	using std::pmr::vector<Subbatch<Element>>::empty;
+	using std::pmr::vector<Subbatch<Element>>::erase;
+	using std::pmr::vector<Subbatch<Element>>::end;
+	using std::pmr::vector<Subbatch<Element>>::front;
+	using std::pmr::vector<Subbatch<Element>>::max_size;
+	using std::pmr::vector<Subbatch<Element>>::pop_back;
+	using std::pmr::vector<Subbatch<Element>>::rbegin;
+	using std::pmr::vector<Subbatch<Element>>::rend;
+	using std::pmr::vector<Subbatch<Element>>::reserve;
+	using std::pmr::vector<Subbatch<Element>>::size;
 
 	/*!
 	 * Creates an empty batch.
@@ -431,6 +476,20 @@ public:
 		subelements.resize(8);
 	}
 
+	/*!
+	 * Creates an empty batch that allocates its memory from a specific memory
+	 * resource.
+	 *
+	 * Both the subelements and the subbatches are allocated from this resource.
+	 * The memory resource must outlive the batch.
+	 * \param resource The memory resource to allocate the batch from.
+	 */
+	explicit Batch(std::pmr::memory_resource* resource) : std::pmr::vector<Subbatch<Element>>(resource),
+		subelements(resource),
+		next_position(0) {
+		subelements.resize(8);
+	}
+
 	/*!
 	 * Creates a batch with a number of copies of the same subbatch.
 	 * \param count The number of copies to store in this batch.
@@ -458,7 +517,7 @@ public:
 	 * Copy constructor, creating a copy of the specified batch.
 	 * \param other The batch to copy.
 	 */
-	Batch(const Batch<Batch<Element>>& other) : next_position(0) {
+	Batch(const Batch<Batch<Element>>& other) : next_position(0), compaction_threshold(other.compaction_threshold) {
 		subelements.resize(8);
 		//Don't simply copy the subelements buffer and subbatches.
 		//If we're copying the data anyway, we might as well shrink the subelements buffer to fit.
@@ -475,8 +534,16 @@ public:
 	 * purpose of the move constructor.
 	 * \param other The batch to move into this batch.
 	 */
-	Batch(Batch<Batch<Element>>&& other) {
-		(*this) = std::move(other); //Same as move assignment operator.
+	Batch(Batch<Batch<Element>>&& other) noexcept : std::pmr::vector<Subbatch<Element>>(std::move(other)),
+		subelements(std::move(other.subelements)),
+		next_position(other.next_position),
+		in_order(other.in_order),
+		compaction_threshold(other.compaction_threshold) {
+		//Change all back-references to the batch-of-batches in all subbatches.
+		for(Subbatch<Element>& subbatch : *this) {
+			subbatch.batch = this;
+		}
+		other.next_position = 0; //The other batch no longer has any subelements.
 	}
 
 	/*!
@@ -489,6 +556,49 @@ public:
 		assign(initialiser_list.begin(), initialiser_list.end());
 	}
 
+	/*!
+	 * Constructs a batch of batches around an existing buffer of subelements,
+	 * without copying them.
+	 *
+	 * The buffer is moved into the batch and used as its subelement buffer
+	 * directly. The offsets indicate where each subbatch starts in the buffer.
+	 * The last offset indicates where the last subbatch ends. Each subbatch
+	 * gets exactly enough capacity for its subelements. This is like the
+	 * compressed format often used to store many arrays in one flat array.
+	 *
+	 * Every subbatch needs space of its own in the buffer, even when it is
+	 * empty. The space for empty subbatches is added at the end of the buffer,
+	 * which may reallocate it if it doesn't have the capacity. Both the buffer
+	 * and the subbatches are allocated from the memory resource of the buffer.
+	 * \param buffer The subelements of all subbatches, stored subbatch after
+	 * subbatch.
+	 * \param offsets For each subbatch, the index in the buffer where its
+	 * subelements start, followed by the index where the subelements of the
+	 * last subbatch end. The offsets must be non-decreasing, and may not exceed
+	 * the size of the buffer.
+	 */
+	Batch(std::pmr::vector<Element>&& buffer, const std::span<const size_t> offsets) : std::pmr::vector<Subbatch<Element>>(buffer.get_allocator().resource()),
+		subelements(std::move(buffer)),
+		next_position(offsets.empty() ? 0 : offsets.back()) {
+		const size_t num_subbatches = offsets.empty() ? 0 : offsets.size() - 1;
+		reserve(num_subbatches);
+		bool after_empty = false; //Once an empty subbatch is placed at the end, any subsequent subbatches are no longer in order.
+		for(size_t subbatch = 0; subbatch < num_subbatches; ++subbatch) {
+			const size_t size = offsets[subbatch + 1] - offsets[subbatch];
+			if(size == 0) {
+				std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
+				next_position += 1;
+				after_empty = true;
+			} else {
+				std::pmr::vector<Subbatch<Element>>::emplace_back(*this, offsets[subbatch], size, size);
+				in_order = in_order && !after_empty;
+			}
+		}
+		if(subelements.size() < std::max(next_position, size_t(1))) { //Growing the buffer by doubling needs at least 1 element.
+			subelements.resize(std::max(next_position, size_t(1)));
+		}
+	}
+
 	/*!
 	 * Copy-assignment operator, which copies the contents of the given batch
 	 * into this batch.
@@ -508,17 +618,24 @@ public:
 	 * This will normally not make a full copy of the data. The data stored on
 	 * the heap for the given batch will remain in place, but this batch will
 	 * now refer to it instead. The other batch should no longer be used.
+	 *
+	 * If the batches use different memory resources, the data can't be taken
+	 * over. It is then moved into memory from the resource of this batch, which
+	 * may throw if that resource can't allocate it.
 	 * \param other The batch to assign to this batch.
 	 * \return A reference to this batch.
 	 */
-	Batch<Batch<Element>>& operator =(Batch<Batch<Element>>&& other) noexcept {
-		std::vector<Subbatch<Element>>::operator=(std::move(other));
+	Batch<Batch<Element>>& operator =(Batch<Batch<Element>>&& other) {
+		std::pmr::vector<Subbatch<Element>>::operator=(std::move(other));
 		//Change all back-references to the batch-of-batches in all subbatches.
 		for(Subbatch<Element>& subbatch : *this) {
 			subbatch.batch = this;
 		}
 		subelements = std::move(other.subelements);
 		next_position = other.next_position;
+		in_order = other.in_order;
+		compaction_threshold = other.compaction_threshold;
+		other.next_position = 0; //The other batch no longer has any subelements.
 		return (*this);
 	}
 
@@ -533,7 +650,7 @@ public:
 	 * otherwise.
 	 */
 	bool operator ==(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) == static_cast<const std::vector<Subbatch<Element>>&>(other); //The base vector knows its size and lets all subbatches compare too.
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) == static_cast<const std::pmr::vector<Subbatch<Element>>&>(other); //The base vector knows its size and lets all subbatches compare too.
 	}
 
 	/*!
@@ -548,7 +665,7 @@ public:
 	 * otherwise.
 	 */
 	bool operator !=(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) != static_cast<const std::vector<Subbatch<Element>>&>(other);
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) != static_cast<const std::pmr::vector<Subbatch<Element>>&>(other);
 	}
 
 	/*!
@@ -564,7 +681,7 @@ public:
 	 * the other batch, or ``false`` if it is greater.
 	 */
 	bool operator <=(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) <= static_cast<const std::vector<Subbatch<Element>>&>(other);
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) <= static_cast<const std::pmr::vector<Subbatch<Element>>&>(other);
 	}
 
 	/*!
@@ -580,7 +697,7 @@ public:
 	 * batch, or ``false`` if it is greater or equal.
 	 */
 	bool operator <(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) < static_cast<const std::vector<Subbatch<Element>>&>(other);
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) < static_cast<const std::pmr::vector<Subbatch<Element>>&>(other);
 	}
 
 	/*!
@@ -596,7 +713,7 @@ public:
 	 * to the other batch, or ``false`` if it is less.
 	 */
 	bool operator >=(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) >= static_cast<const std::vector<Subbatch<Element>>&>(other);
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) >= static_cast<const std::pmr::vector<Subbatch<Element>>&>(other);
 	}
 
 	/*!
@@ -612,7 +729,7 @@ public:
 	 * other batch, or ``false`` if it is less or equal.
 	 */
 	bool operator >(const Batch<Batch<Element>>& other) const {
-		return static_cast<const std::vector<Subbatch<Element>>&>(*this) > static_cast<const std::vector<Subbatch<Element>>&>(other);
+		return static_cast<const std::pmr::vector<Subbatch<Element>>&>(*this) > static_cast<const std::pmr::vector<Subbatch<Element>>&>(other);
 	}
 
 	/*!
@@ -660,14 +777,86 @@ public:
 		assign(initialiser_list.begin(), initialiser_list.end());
 	}
 
+	/*!
+	 * Replace the contents of the batch with subbatches of predetermined
+	 * sizes, to be filled afterwards.
+	 *
+	 * The positions of the subbatches in the subelement buffer are computed
+	 * with a prefix sum over their sizes, so that the buffer only needs to be
+	 * allocated once, and the subbatches are placed in order without any gaps.
+	 * The subbatches are filled with default-constructed elements. Since they
+	 * already have their final size, they can be filled by writing their
+	 * elements directly, without reallocating anything. That also makes it safe
+	 * to fill different subbatches from different threads at the same time.
+	 * \param sizes For each subbatch, the number of elements it must get.
+	 */
+	void assign_sizes(const std::span<const size_t> sizes) {
+		clear();
+		std::pmr::vector<Subbatch<Element>>::resize(sizes.size(), Subbatch<Element>(*this, 0, 0, 1));
+		size_t position = 0; //Exclusive prefix sum of the capacities.
+		for(size_t subbatch = 0; subbatch < sizes.size(); ++subbatch) {
+			Subbatch<Element>& current = (*this)[subbatch];
+			current.start_index = position;
+			current.num_elements = sizes[subbatch];
+			current.current_capacity = std::max(size_t(1), sizes[subbatch]); //Capacity of the subbatch needs to be at least 1.
+			position += current.current_capacity;
+		}
+		subelements.assign(std::max(position, size_t(8)), Element());
+		next_position = position;
+	}
+
 	/*!
 	 * Erase all contents from this batch of batches.
 	 *
 	 * All subbatches will be eliminated.
 	 */
 	void clear() noexcept {
-		std::vector<Subbatch<Element>>::clear();
+		std::pmr::vector<Subbatch<Element>>::clear();
 		next_position = 0;
+		in_order = true;
+	}
+
+	/*!
+	 * Closes the gaps in the subelement buffer that are not used by any
+	 * subbatch.
+	 *
+	 * Gaps are left behind when subbatches are removed, or when they grow and
+	 * have to be moved to the end of the buffer. This moves all subbatches to
+	 * the start of the buffer, in the order in which they appear in this batch,
+	 * so that streaming over the subelement buffer doesn't have to skip over
+	 * unused data.
+	 *
+	 * Unlike \ref shrink_to_fit, the subbatches keep their capacity and the
+	 * buffer keeps its size. It doesn't free any memory, but the space at the
+	 * end of the buffer can be used to grow the subbatches again without
+	 * reallocating. Pointers and iterators referring to subelements will be
+	 * invalidated, but references to the subbatches themselves stay valid.
+	 */
+	void compact() {
+		size_t compacted_position = 0; //Position in the buffer where to place the next subbatch.
+		if(in_order) { //The subbatches are already in the right order, so each of them only needs to shift towards the start.
+			for(Subbatch<Element>& subbatch : *this) {
+				if(subbatch.start_index != compacted_position) {
+					for(size_t i = 0; i < subbatch.capacity(); ++i) { //Move the whole capacity, since insertions keep data there temporarily.
+						subelements[compacted_position + i] = std::move(subelements[subbatch.start_index + i]);
+					}
+					subbatch.start_index = compacted_position;
+				}
+				compacted_position += subbatch.capacity();
+			}
+		} else { //Subbatches may overlap their new position with the data of other subbatches. Move the data to a new buffer instead.
+			std::pmr::vector<Element> compacted(subelements.size(), subelements.get_allocator());
+			for(Subbatch<Element>& subbatch : *this) {
+				for(size_t i = 0; i < subbatch.capacity(); ++i) {
+					compacted[compacted_position + i] = std::move(subelements[subbatch.start_index + i]);
+				}
+				subbatch.start_index = compacted_position;
+				compacted_position += subbatch.capacity();
+			}
+			subelements = std::move(compacted);
+		}
+		next_position = compacted_position;
+		in_order = true;
 	}
 
 	/*!
@@ -707,9 +896,11 @@ public:
 	 * \return An iterator pointing to the newly emplaced subbatch.
 	 */
 	iterator emplace(const_iterator position) {
-		reserve_subelements_doubling(next_position + 1);
-		return std::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, 1);
+		reserve_subelements_appending(1);
+		in_order = in_order && position == cend(); //Compacting puts subbatches in order, so only check this afterwards.
+		const iterator result = std::pmr::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, 1);
 		next_position += 1;
+		return result;
 	}
 
 	/*!
@@ -722,8 +913,9 @@ public:
 	 */
 	iterator emplace(const_iterator position, const size_t count, const Element& value = Element()) {
 		const size_t capacity = std::max(size_t(1), count);
-		reserve_subelements_doubling(next_position + capacity);
-		const iterator result = std::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, capacity);
+		reserve_subelements_appending(capacity);
+		in_order = in_order && position == cend();
+		const iterator result = std::pmr::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, capacity);
 		next_position += capacity;
 		result->assign(count, value);
 		return result;
@@ -741,8 +933,9 @@ public:
 	 */
 	template<class InputIterator>
 	iterator emplace(const_iterator position, InputIterator first, InputIterator last) {
-		reserve_subelements_doubling(next_position + 1);
-		const iterator result = std::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, 1);
+		reserve_subelements_appending(1);
+		in_order = in_order && position == cend();
+		const iterator result = std::pmr::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, 1);
 		next_position += 1; //Capacity is 1.
 		result->assign(first, last);
 		return result;
@@ -779,8 +972,9 @@ public:
 	 */
 	iterator emplace(const_iterator position, const std::initializer_list<Element>& initialiser_list) {
 		const size_t capacity = std::max(size_t(1), initialiser_list.size());
-		reserve_subelements_doubling(next_position + capacity);
-		const iterator result = std::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, capacity);
+		reserve_subelements_appending(capacity);
+		in_order = in_order && position == cend();
+		const iterator result = std::pmr::vector<Subbatch<Element>>::emplace(position, *this, next_position, 0, capacity);
 		next_position += capacity;
 		result->assign(initialiser_list);
 		return result;
@@ -790,8 +984,8 @@ public:
 	 * Append an empty subbatch at the end of this batch of batches.
 	 */
 	void emplace_back() {
-		reserve_subelements_doubling(next_position + 1);
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
+		reserve_subelements_appending(1);
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
 		next_position += 1;
 	}
 
@@ -803,8 +997,8 @@ public:
 	 */
 	void emplace_back(const size_t count, const Element& value = Element()) {
 		const size_t capacity = std::max(size_t(1), count);
-		reserve_subelements_doubling(next_position + capacity);
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity);
+		reserve_subelements_appending(capacity);
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity);
 		next_position += capacity;
 		back().assign(count, value);
 	}
@@ -819,8 +1013,8 @@ public:
 	 */
 	template<class InputIterator>
 	void emplace_back(InputIterator first, InputIterator last) {
-		reserve_subelements_doubling(next_position + 1);
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
+		reserve_subelements_appending(1);
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
 		next_position += 1;
 		back().assign(first, last);
 	}
@@ -850,12 +1044,50 @@ public:
 	 */
 	void emplace_back(const std::initializer_list<Element>& initialiser_list) {
 		const size_t capacity = initialiser_list.size();
-		reserve_subelements_doubling(next_position + capacity);
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity);
+		reserve_subelements_appending(capacity);
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity);
 		next_position += capacity;
 		back().assign(initialiser_list);
 	}
 
+	/*!
+	 * Get the fraction of the used part of the subelement buffer that is not
+	 * used by any subbatch.
+	 *
+	 * The used part of the buffer is the range up to \ref size_subelements.
+	 * Subbatches leave gaps in this range when they are removed, or when they
+	 * grow and have to move to the end of the buffer. Streaming over the
+	 * subelement buffer or sending it to a compute device also processes these
+	 * gaps. The unused capacity at the end of each subbatch is not counted,
+	 * since it serves to let the subbatches grow in place.
+	 *
+	 * This needs to iterate over all subbatches, so it takes linear time.
+	 * \return A ratio between 0 and 1. 0 means that the subbatches are packed
+	 * without any gaps. 1 means that none of the used part of the buffer is in
+	 * use any more.
+	 */
+	double fragmentation() const {
+		if(next_position == 0) {
+			return 0.0;
+		}
+		size_t occupied = 0;
+		for(const Subbatch<Element>& subbatch : *this) {
+			occupied += subbatch.capacity();
+		}
+		return double(next_position - std::min(occupied, next_position)) / next_position;
+	}
+
+	/*!
+	 * Get the fragmentation above which the subelement buffer is automatically
+	 * compacted.
+	 *
+	 * See \ref set_compaction_threshold for details on the compaction policy.
+	 * \return The fraction of dead space that triggers a compaction.
+	 */
+	double get_compaction_threshold() const {
+		return compaction_threshold;
+	}
+
 	/*!
 	 * Insert a new batch at the specified position in this batch of batches.
 	 *
@@ -869,11 +1101,12 @@ public:
 	 */
 	iterator insert(const_iterator position, const Batch<Element>& value) {
 		const size_t capacity = std::max(size_t(1), value.size()); //Capacity of the subbatch needs to be at least 1.
-		reserve_subelements_doubling(next_position + capacity); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(capacity);
+		in_order = in_order && position == cend();
 		Subbatch<Element> subbatch(*this, next_position, 0, capacity); //Create a subbatch pointing to the new data.
 		next_position += capacity;
 		subbatch.assign(value.begin(), value.end()); //Insert the data into that subbatch.
-		return std::vector<Subbatch<Element>>::insert(position, subbatch);
+		return std::pmr::vector<Subbatch<Element>>::insert(position, subbatch);
 	}
 
 	/*!
@@ -889,7 +1122,8 @@ public:
 	 */
 	iterator insert(const_iterator position, Batch<Element>&& value) {
 		const size_t capacity = std::max(size_t(1), value.size()); //Capacity of the subbatch needs to be at least 1.
-		reserve_subelements_doubling(next_position + capacity); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(capacity);
+		in_order = in_order && position == cend();
 		Subbatch<Element> subbatch(*this, next_position, 0, capacity); //Create a subbatch pointing to the new data.
 		next_position += capacity;
 
@@ -898,7 +1132,7 @@ public:
 			subbatch.push_back(std::move(subelement));
 		}
 
-		return std::vector<Subbatch<Element>>::insert(position, subbatch);
+		return std::pmr::vector<Subbatch<Element>>::insert(position, subbatch);
 	}
 
 	/*!
@@ -917,12 +1151,13 @@ public:
 	 * subbatches.
 	 */
 	iterator insert(const_iterator position, const size_t count, const Batch<Element>& value) {
+		in_order = in_order && position == cend();
 		const size_t capacity = std::max(size_t(1), value.size()); //Capacity per subbatch needs to be at least 1.
 		reserve_subelements(next_position + capacity * count);
 
 		//Since we can't directly adjust the size of the subbatches list, we'll have to insert repeated counts of the first subbatch and adjust its fields afterwards.
 		const size_t first_index = position - cbegin(); //Insert may invalidate the iterator we give it, so use indices afterwards.
-		iterator result = std::vector<Subbatch<Element>>::insert(position, count, Subbatch(*this, next_position, 0, capacity));
+		iterator result = std::pmr::vector<Subbatch<Element>>::insert(position, count, Subbatch(*this, next_position, 0, capacity));
 		for(size_t repeat = 0; repeat < count; ++repeat) {
 			Subbatch<Element>& new_subbatch = (*this)[first_index + repeat];
 			new_subbatch.start_index = next_position + repeat * capacity;
@@ -951,6 +1186,7 @@ public:
 	 */
 	template<class InputIterator>
 	iterator insert(const_iterator position, InputIterator first, InputIterator last) {
+		in_order = in_order && position == cend();
 		return insert_iterator_dispatch<InputIterator>(position, first, last, typename std::iterator_traits<InputIterator>::iterator_category());
 	}
 
@@ -978,7 +1214,7 @@ public:
 	 * \param value The batch to append to this batch of batches.
 	 */
 	void push_back(const Batch<Element>& value) {
-		reserve_subelements_doubling(next_position + std::max(size_t(1), value.size())); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(std::max(size_t(1), value.size()));
 		push_back_unsafe(value);
 	}
 
@@ -993,7 +1229,7 @@ public:
 	 * \param value The batch to append to this batch of batches.
 	 */
 	void push_back(Batch<Element>&& value) {
-		reserve_subelements_doubling(next_position + std::max(size_t(1), value.size())); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(std::max(size_t(1), value.size()));
 		push_back_unsafe(value);
 	}
 
@@ -1004,7 +1240,7 @@ public:
 	 * \param value The batch to append to this batch of batches.
 	 */
 	void push_back(const Subbatch<Element>& value) {
-		reserve_subelements_doubling(next_position + std::max(size_t(1), value.size())); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(std::max(size_t(1), value.size()));
 		push_back_unsafe(value);
 	}
 
@@ -1019,7 +1255,7 @@ public:
 	 * \param value The batch to append to this batch of batches.
 	 */
 	void push_back(Subbatch<Element>&& value) {
-		reserve_subelements_doubling(next_position + std::max(size_t(1), value.size())); //Grow by doubling to reduce amortised cost of repeated push_backs.
+		reserve_subelements_appending(std::max(size_t(1), value.size()));
 		push_back_unsafe(value);
 	}
 
@@ -1049,12 +1285,12 @@ public:
 	 */
 	void resize(const size_t count) {
 		if(count < size()) {
-			std::vector<Subbatch<Element>>::resize(count, Subbatch<Element>(*this, next_position, 0, 1));
+			std::pmr::vector<Subbatch<Element>>::resize(count, Subbatch<Element>(*this, next_position, 0, 1));
 		} else if(count > size()) { //If the size increases, we need to allocate memory in the subelements and assign spots for each subbatch.
 			reserve(count);
 			reserve_subelements(next_position + count - size());
 			while(size() < count) {
-				std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
+				std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, 1);
 				next_position += 1;
 			}
 		}
@@ -1072,7 +1308,7 @@ public:
 	 */
 	void resize(const size_t count, const Batch<Element>& value) {
 		if(count < size()) {
-			std::vector<Subbatch<Element>>::resize(count, Subbatch<Element>(*this, next_position, 0, 1));
+			std::pmr::vector<Subbatch<Element>>::resize(count, Subbatch<Element>(*this, next_position, 0, 1));
 		} else if(count > size()) {
 			reserve(count);
 			reserve_subelements(next_position + (count - size()) * std::max(size_t(1), value.size()));
@@ -1082,6 +1318,27 @@ public:
 		}
 	}
 
+	/*!
+	 * Change how fragmented the subelement buffer may get before it is
+	 * automatically compacted.
+	 *
+	 * When the subelement buffer is full and needs to grow, the batch first
+	 * checks its \ref fragmentation. If the fraction of dead space exceeds this
+	 * threshold, the buffer is compacted instead, closing the gaps. It only
+	 * grows if that didn't free up enough space. Growing the buffer invalidates
+	 * all pointers to subelements anyway, so compacting at that moment has no
+	 * additional effect on the validity of pointers. Compacting takes linear
+	 * time, but since it only happens when a significant part of the buffer can
+	 * be reclaimed, the amortised cost of adding elements stays constant.
+	 * Lower thresholds keep the buffer more tightly packed, but compact more
+	 * often.
+	 * \param threshold The fraction of dead space that triggers a compaction,
+	 * between 0 and 1. A threshold of 1 disables automatic compaction.
+	 */
+	void set_compaction_threshold(const double threshold) {
+		compaction_threshold = threshold;
+	}
+
 	/*!
 	 * Attempts to reduce memory usage by to the minimum possible by rearranging
 	 * the data inside of the buffers held by this batch.
@@ -1106,7 +1363,7 @@ public:
 		const size_t num_subelements = std::accumulate(cbegin(), cend(), size_t(0), [](const size_t current, const Subbatch<Element>& subbatch) {
 			return current + std::max(subbatch.size(), size_t(1));
 		});
-		std::vector<Element> optimised(std::max(num_subelements, size_t(8))); //Allocate the necessary memory. We'll move this on top of our old buffer once all data is moved.
+		std::pmr::vector<Element> optimised(std::max(num_subelements, size_t(8)), subelements.get_allocator()); //Allocate the necessary memory. We'll move this on top of our old buffer once all data is moved.
 
 		//Move the data into the optimised buffer.
 		size_t optimised_position = 0; //Position in the optimised buffer where to place next subelement.
@@ -1122,8 +1379,9 @@ public:
 		//Once optimised, swap out the new subelement buffer with the old one.
 		subelements = std::move(optimised);
 		next_position = optimised_position;
+		in_order = true;
 
-		std::vector<Subbatch<Element>>::shrink_to_fit(); //Also shrink the table of subbatches.
+		std::pmr::vector<Subbatch<Element>>::shrink_to_fit(); //Also shrink the table of subbatches.
 	}
 
 	/*!
@@ -1146,18 +1404,29 @@ public:
 		return next_position; //The next_position indicates the first open space we have, thus also the end of the occupied and formerly occupied spaces.
 	}
 
+	/*!
+	 * Get the memory resource that this batch allocates its subelements and
+	 * subbatches from.
+	 * \return The memory resource of this batch.
+	 */
+	std::pmr::memory_resource* get_memory_resource() const {
+		return subelements.get_allocator().resource();
+	}
+
 	/*!
 	 * Exchange the contents of this batch of batches with that of another.
 	 *
 	 * For this type of swap, the element data itself doesn't need to move.
 	 * Iterators and pointers to the element and subbatch data will remain
-	 * valid.
+	 * valid. Both batches must use the same memory resource.
 	 * \param other The batch of batches to swap with.
 	 */
 	void swap(Batch<Batch<Element>>& other) noexcept {
 		std::swap(subelements, other.subelements);
 		std::swap(next_position, other.next_position);
-		std::vector<Subbatch<Element>>::swap(static_cast<std::vector<Subbatch<Element>>&>(other)); //Swap all the subbatches pointing to that data too.
+		std::swap(in_order, other.in_order);
+		std::swap(compaction_threshold, other.compaction_threshold);
+		std::pmr::vector<Subbatch<Element>>::swap(static_cast<std::pmr::vector<Subbatch<Element>>&>(other)); //Swap all the subbatches pointing to that data too.
 		for(Subbatch<Element>& subbatch : *this) { //Update the pointers to the parent batch in each subbatch.
 			subbatch.batch = this;
 		}
@@ -1174,7 +1443,7 @@ public:
 	 * which is easier to transfer to other devices in one allocation, improving
 	 * performance.
 	 */
-	std::vector<Element> subelements;
+	std::pmr::vector<Element> subelements;
 
 	/*!
 	 * The starting index in the element buffer of the next subbatch, if a new
@@ -1185,6 +1454,50 @@ public:
 	 */
 	size_t next_position;
 
+	/*!
+	 * Whether the subbatches are placed in the subelement buffer in the same
+	 * order as they appear in this batch.
+	 *
+	 * If they are, the space between the end of a subbatch and the start of
+	 * the next subbatch is unused, so the subbatch can grow into it without
+	 * moving. Inserting subbatches in the middle or moving subbatches to the
+	 * end of the buffer breaks this order, until the buffer is compacted.
+	 */
+	bool in_order = true;
+
+	/*!
+	 * The fragmentation above which the subelement buffer is compacted when it
+	 * needs to grow.
+	 *
+	 * See \ref set_compaction_threshold.
+	 */
+	double compaction_threshold = 0.5;
+
+	/*!
+	 * Get the end of the free space after a subbatch in the subelement buffer,
+	 * into which the subbatch could grow without moving.
+	 *
+	 * If no other subbatch is placed after this subbatch in the buffer, the
+	 * subbatch can grow indefinitely, since the buffer can be grown too.
+	 * \param subbatch The subbatch to find the free space after.
+	 * \return The first position after the subbatch that is in use by a
+	 * different subbatch, or the maximum ``size_t`` if there is none.
+	 */
+	size_t free_space_end(const Subbatch<Element>& subbatch) const {
+		const size_t subbatch_end = subbatch.start_index + subbatch.current_capacity;
+		if(subbatch_end >= next_position) {
+			return std::numeric_limits<size_t>::max(); //This is the last subbatch in the buffer.
+		}
+		if(in_order && !empty() && &subbatch >= &front() && &subbatch <= &back()) { //In order, the next subbatch in the list is also the next one in the buffer.
+			const size_t index = &subbatch - &front();
+			if(index + 1 == size()) {
+				return std::numeric_limits<size_t>::max(); //The last subbatch in the list is then also the last one in the buffer.
+			}
+			return (*this)[index + 1].start_index;
+		}
+		return subbatch_end; //Can't find anything free without searching through all subbatches.
+	}
+
 	/*!
 	 * Specialised assign operation for when assigning a range defined by random
 	 * access iterators.
@@ -1301,7 +1614,7 @@ public:
 		reserve_subelements(next_position + subelement_count);
 
 		//Since we can't directly adjust the size of the subbatch list, we'll have to insert repeated counts of the first subbatch and adjust its fields afterwards.
-		const iterator result = std::vector<Subbatch<Element>>::insert(position, subbatch_count, Subbatch(*this, next_position, 0, std::max(size_t(1), start->size())));
+		const iterator result = std::pmr::vector<Subbatch<Element>>::insert(position, subbatch_count, Subbatch(*this, next_position, 0, std::max(size_t(1), start->size())));
 		iterator subbatch = begin() + index;
 		for(InputIterator it = start; it != end; it++) {
 			subbatch->start_index = next_position;
@@ -1346,7 +1659,7 @@ public:
 		reserve_subelements(next_position + subelement_count);
 
 		//Since we can't directly adjust the size of the subbatch list, we'll have to insert repeated counts of the first subbatch and adjust its fields afterwards.
-		iterator result = std::vector<Subbatch<Element>>::insert(position, subbatch_count, Subbatch(*this, next_position, 0, std::max(size_t(1), start->size())));
+		iterator result = std::pmr::vector<Subbatch<Element>>::insert(position, subbatch_count, Subbatch(*this, next_position, 0, std::max(size_t(1), start->size())));
 		iterator subbatch = begin() + index;
 		for(InputIterator it = start; it != end; it++) {
 			subbatch->start_index = next_position;
@@ -1384,7 +1697,7 @@ public:
 		Keep the subbatches in a separate array and then insert them all at once
 		once iteration is completed. */
 
-		std::vector<Subbatch<Element>> subbatches;
+		std::pmr::vector<Subbatch<Element>> subbatches;
 		for(; start != end; start++) {
 			const size_t capacity = std::max(size_t(1), start->size());
 			subbatches.emplace_back(*this, next_position, 0, capacity);
@@ -1393,7 +1706,7 @@ public:
 			subbatches.back().assign(start->begin(), start->end()); //Copy data from the original batch into subelement array.
 		}
 		//Now insert the new subbatches directly into the subbatch array.
-		return std::vector<Subbatch<Element>>::insert(position, subbatches.begin(), subbatches.end());
+		return std::pmr::vector<Subbatch<Element>>::insert(position, subbatches.begin(), subbatches.end());
 	}
 
 	/*!
@@ -1407,7 +1720,7 @@ public:
 	 */
 	void push_back_unsafe(const Batch<Element>& subbatch) {
 		const size_t capacity = std::max(size_t(1), subbatch.size());
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity); //Create a new subbatch with exactly enough capacity.
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity); //Create a new subbatch with exactly enough capacity.
 		next_position += capacity;
 		back().assign(subbatch.begin(), subbatch.end()); //Copy all subelements.
 	}
@@ -1423,7 +1736,7 @@ public:
 	 */
 	void push_back_unsafe(Batch<Element>&& subbatch) {
 		const size_t capacity = std::max(size_t(1), subbatch.size());
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, subbatch.size(), capacity); //Create a new subbatch with exactly enough capacity.
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, subbatch.size(), capacity); //Create a new subbatch with exactly enough capacity.
 		next_position += capacity;
 		Subbatch<Element>& new_subbatch = back();
 		for(size_t subelement = 0; subelement < subbatch.size(); ++subelement) {
@@ -1442,7 +1755,7 @@ public:
 	 */
 	void push_back_unsafe(const Subbatch<Element>& subbatch) {
 		const size_t capacity = std::max(size_t(1), subbatch.size());
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity); //Create a new subbatch with exactly enough capacity.
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, 0, capacity); //Create a new subbatch with exactly enough capacity.
 		next_position += capacity;
 		back().assign(subbatch.begin(), subbatch.end()); //Copy all subelements.
 	}
@@ -1458,7 +1771,7 @@ public:
 	 */
 	void push_back_unsafe(Subbatch<Element>&& subbatch) {
 		const size_t capacity = std::max(size_t(1), subbatch.size());
-		std::vector<Subbatch<Element>>::emplace_back(*this, next_position, subbatch.size(), capacity); //Create a new subbatch with exactly enough capacity.
+		std::pmr::vector<Subbatch<Element>>::emplace_back(*this, next_position, subbatch.size(), capacity); //Create a new subbatch with exactly enough capacity.
 		next_position += capacity;
 		Subbatch<Element>& new_subbatch = back();
 		for(size_t subelement = 0; subelement < subbatch.size(); ++subelement) {
@@ -1486,6 +1799,30 @@ public:
 		}
 		subelements.resize(buffer_size); //Resize all at once.
 	}
+
+	/*!
+	 * Make sure that a number of subelements can be added at the end of the
+	 * used part of the subelement buffer.
+	 *
+	 * If the buffer is not big enough, it is first compacted if it is more
+	 * fragmented than the \ref compaction_threshold. If it is still not big
+	 * enough, it is grown by doubling, to keep the amortised cost of adding
+	 * subbatches constant.
+	 *
+	 * This may move the subelements of all subbatches, so it may only be called
+	 * while all subbatches that refer to the buffer are part of this batch.
+	 * \param count The number of subelements that must fit after
+	 * \ref next_position.
+	 */
+	void reserve_subelements_appending(const size_t count) {
+		if(next_position + count <= subelements.size()) {
+			return; //Already fits.
+		}
+		if(fragmentation() > compaction_threshold) {
+			compact();
+		}
+		reserve_subelements_doubling(next_position + count);
+	}
 };
 
 /*!
@@ -1512,24 +1849,24 @@ class Subbatch {
 	/*!
 	 * The iterator type used to iterate over elements of the subbatch.
 	 */
-	using iterator = typename std::vector<Element>::iterator;
+	using iterator = typename std::pmr::vector<Element>::iterator;
 
 	/*!
 	 * The iterator type used to iterate over elements of a const subbatch.
 	 */
-	using const_iterator = typename std::vector<Element>::const_iterator;
+	using const_iterator = typename std::pmr::vector<Element>::const_iterator;
 
 	/*!
 	 * The iterator type used to iterate in reverse over elements of the
 	 * subbatch.
 	 */
-	using reverse_iterator = typename std::vector<Element>::reverse_iterator;
+	using reverse_iterator = typename std::pmr::vector<Element>::reverse_iterator;
 
 	/*!
 	 * The iterator type used to iterate in reverse over elements of a const
 	 * subbatch.
 	 */
-	using const_reverse_iterator = typename std::vector<Element>::const_reverse_iterator;
+	using const_reverse_iterator = typename std::pmr::vector<Element>::const_reverse_iterator;
 
 	/*!
 	 * Construct a new subbatch.
@@ -2471,6 +2808,7 @@ class Subbatch {
 	void swap(Subbatch<Element>& other) {
 		if(&batch == &other.batch) {
 			//If we just swap which part of the element buffer they point to, that already works.
+			batch->in_order = false; //But then they are no longer in order.
 			std::swap(start_index, other.start_index);
 			std::swap(num_elements, other.num_elements);
 			std::swap(current_capacity, other.current_capacity);
@@ -2491,6 +2829,7 @@ class Subbatch {
 				batch->subelements.resize(buffer_capacity, Element());
 				current_capacity = other_size;
 				batch->next_position += current_capacity;
+				batch->in_order = false;
 			}
 			size_t other_destination = other.start_index;
 			if(my_size > other.capacity()) {
@@ -2503,6 +2842,7 @@ class Subbatch {
 				other.batch->subelements.resize(buffer_capacity, Element());
 				other.current_capacity = my_size;
 				other.batch->next_position += other.current_capacity;
+				other.batch->in_order = false;
 			}
 
 			//Now swap all of the data, being careful not to overwrite important data.
@@ -2572,6 +2912,7 @@ class Subbatch {
 			batch->subelements.resize(buffer_capacity, Element());
 			current_capacity = other_size;
 			batch->next_position += current_capacity;
+			batch->in_order = false;
 		}
 		other.reserve(my_size); //For the other batch, we can't really prevent it.
 
@@ -2857,25 +3198,19 @@ class Subbatch {
 		for(; start != end; start++, ++count) {
 			if(remaining_space == 0) { //Not enough space to add the next element. Allocate more.
 				//This reallocation is "manual". Instead of moving all elements, we'll immediately move the trailing end to the end of the capacity.
-				const size_t new_place = batch->next_position;
 				const size_t new_capacity = current_capacity * 2; //Doubling the capacity ensures that repeated insertion of a new element is done in amortised constant time.
-				batch->next_position += new_capacity;
+				const size_t new_place = find_place(new_capacity);
 
-				//Make sure we have enough capacity in the element buffer itself. Grow by doubling there too.
-				size_t buffer_capacity = batch->subelements.size();
-				while(buffer_capacity < new_place + new_capacity) {
-					buffer_capacity = buffer_capacity * 2;
-				}
-				batch->subelements.resize(buffer_capacity, Element());
-
-				//Copy the leading elements to the start of the allocated space.
-				for(size_t i = 0; i < index + count; ++i) {
-					batch->subelements[new_place + i] = (*this)[i];
+				//Copy the leading elements to the start of the allocated space, unless we're growing in place.
+				if(new_place != start_index) {
+					for(size_t i = 0; i < index + count; ++i) {
+						batch->subelements[new_place + i] = (*this)[i];
+					}
 				}
-				//Copy the trailing elements to the end of the allocated space.
+				//Copy the trailing elements to the end of the allocated space. Iterate backwards, since growing in place makes the ranges overlap.
 				remaining_space = new_capacity - current_capacity;
-				for(size_t i = index + count; i < current_capacity; ++i) {
-					batch->subelements[new_place + i + remaining_space] = (*this)[i];
+				for(size_t i = current_capacity; i > index + count; --i) {
+					batch->subelements[new_place + i - 1 + remaining_space] = (*this)[i - 1];
 				}
 
 				start_index = new_place;
@@ -2897,6 +3232,39 @@ class Subbatch {
 		return begin() + index;
 	}
 
+	/*!
+	 * Find a place in the element buffer where this subbatch can be stored with
+	 * a bigger capacity, and reserve that space.
+	 *
+	 * If the space after this subbatch is not in use by any other subbatch, the
+	 * subbatch can grow in place. This is always the case for the last subbatch
+	 * in the buffer. Otherwise the subbatch needs to move to the end of the
+	 * buffer. If the buffer then needs to grow and is too fragmented, it gets
+	 * compacted first. This changes the start index of this subbatch too.
+	 *
+	 * The data of the subbatch is not moved to the new place. That is left to
+	 * the caller, who may want to arrange it differently.
+	 * \param new_capacity The capacity that the subbatch needs to get.
+	 * \return The position in the element buffer where the subbatch can be
+	 * stored. If this is the current start index, the subbatch can grow in
+	 * place.
+	 */
+	size_t find_place(const size_t new_capacity) {
+		if(start_index + new_capacity > batch->free_space_end(*this) //Would need to move to the end.
+				&& batch->next_position + new_capacity > batch->subelements.size() //And the buffer would need to grow.
+				&& batch->fragmentation() > batch->compaction_threshold) {
+			batch->compact(); //Growing the buffer invalidates references to all subelements anyway, so this is a good moment to close the gaps.
+		}
+		size_t new_place = start_index;
+		if(start_index + new_capacity > batch->free_space_end(*this)) { //Not enough free space after this subbatch, so move to the end.
+			new_place = batch->next_position;
+			batch->in_order = false;
+		}
+		batch->next_position = std::max(batch->next_position, new_place + new_capacity);
+		batch->reserve_subelements_doubling(new_place + new_capacity); //Make sure we have enough capacity in the element buffer itself. Grow by doubling there too.
+		return new_place;
+	}
+
 	/*!
 	 * Moves this subbatch to a new location inside the element buffer to make
 	 * more space for new elements.
@@ -2907,27 +3275,15 @@ class Subbatch {
 	 * subbatch grows bigger, resulting in an amortised constant time complexity
 	 * for adding elements.
 	 *
-	 * If the subbatch is currently the last subbatch in the batch, it will not
-	 * get moved unless capacity needs to be expanded. This prevents the need to
-	 * move elements often, for the common case where data is initially entered
-	 * in a linear fashion.
+	 * If the space after the subbatch is free, for instance because it is the
+	 * last subbatch in the batch, it will not get moved but grow in place. This
+	 * prevents the need to move elements often, for the common case where data
+	 * is initially entered in a linear fashion.
 	 * \param new_capacity The amount of elements that can be stored without
 	 * allocating new memory, after this operation has been completed.
 	 */
 	void reallocate(const size_t new_capacity) {
-		size_t new_place = start_index;
-		if(start_index + current_capacity != batch->next_position) { //If we're currently the last subbatch in the buffer, don't change the start index.
-			new_place = batch->next_position;
-		}
-		batch->next_position = new_place + new_capacity;
-
-		//Make sure we have enough capacity in the element buffer itself. Grow by doubling there too.
-		size_t buffer_capacity = batch->subelements.size();
-		while(buffer_capacity < new_place + new_capacity) {
-			buffer_capacity *= 2;
-		}
-		batch->subelements.resize(buffer_capacity, Element());
-
+		const size_t new_place = find_place(new_capacity);
 		if(new_place != start_index) {
 			//If we've moved, copy all of the data over.
 			for(size_t index = 0; index < size(); ++index) {
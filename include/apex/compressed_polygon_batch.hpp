@@ -0,0 +1,512 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_COMPRESSED_POLYGON_BATCH
+#define APEX_COMPRESSED_POLYGON_BATCH
+
+#include <algorithm> //For std::min and std::max.
+#include <bit> //For std::bit_width, to find how many bits each delta needs.
+#include <cstdint> //To store the compressed vertices as bytes.
+#include <memory_resource> //To allocate the compressed data from a memory resource.
+#include <utility> //For std::pair, to return bounding boxes.
+#include <vector> //To store the compressed data.
+
+#include "batch.hpp" //To return batches of results.
+#include "coordinate.hpp" //To compute areas.
+#include "detail/geometry_concepts.hpp" //To compress any batch of polygons.
+#include "detail/strategies.hpp" //To choose whether to decompress on multiple threads.
+#include "operations/bounding_box.hpp" //To compute the bounding boxes of the decompressed blocks.
+#include "point2.hpp" //The vertices of the polygons are 2D points.
+#include "polygon.hpp" //To decompress the polygons.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * The number of vertices that are bit-packed together in a compressed polygon.
+ *
+ * All deltas in a block are packed with the same number of bits. Bigger blocks
+ * have less overhead for storing that number, but smaller blocks adapt better
+ * to parts of a polygon with longer or shorter edges. The blocks are also
+ * decompressed into a buffer of this size on the stack.
+ */
+constexpr size_t compressed_block_size = 32;
+
+/*!
+ * The number of zero bytes after the compressed data.
+ *
+ * The packed deltas are read 8 bytes at a time, so that they can be extracted
+ * with a single shift, without checking whether they straddle a byte boundary.
+ * With this padding, that never reads outside of the data.
+ */
+constexpr size_t compressed_padding = 8;
+
+/*!
+ * Maps signed integers to unsigned integers such that numbers close to zero
+ * get few significant bits, whether they are positive or negative.
+ *
+ * This maps 0, -1, 1, -2, 2, etc. to 0, 1, 2, 3, 4, etc.
+ * \param value The signed integer to map.
+ * \return The unsigned integer representing that signed integer.
+ */
+inline uint32_t zigzag_encode(const int32_t value) {
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/*!
+ * Maps the unsigned integers created by \ref zigzag_encode back to the signed
+ * integers they represent.
+ * \param value The unsigned integer to map back.
+ * \return The signed integer that the unsigned integer represents.
+ */
+inline int32_t zigzag_decode(const uint32_t value) {
+	return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+}
+
+/*!
+ * Appends an unsigned integer to a byte buffer, using as many bytes as needed.
+ *
+ * Each byte stores 7 bits of the integer, least significant first. The highest
+ * bit of each byte indicates whether more bytes follow.
+ * \param buffer The buffer to append the integer to.
+ * \param value The integer to append.
+ */
+inline void write_varint(std::pmr::vector<uint8_t>& buffer, uint64_t value) {
+	while(value >= 0x80) {
+		buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<uint8_t>(value));
+}
+
+/*!
+ * Reads an unsigned integer written by \ref write_varint.
+ * \param position The position to read the integer from. This is moved to the
+ * first byte after the integer.
+ * \return The integer that was read.
+ */
+inline uint64_t read_varint(const uint8_t*& position) {
+	uint64_t value = 0;
+	unsigned shift = 0;
+	while(*position & 0x80) {
+		value |= static_cast<uint64_t>(*position & 0x7F) << shift;
+		shift += 7;
+		++position;
+	}
+	value |= static_cast<uint64_t>(*position) << shift;
+	++position;
+	return value;
+}
+
+/*!
+ * Appends integers to a byte buffer, using a fixed number of bits for each.
+ *
+ * The integers are packed least significant bit first, so that they can be
+ * read with a little-endian load and a shift.
+ * \param buffer The buffer to append the integers to.
+ * \param values The integers to append.
+ * \param count The number of integers to append.
+ * \param width The number of bits to use for each integer. The integers must
+ * fit in that number of bits.
+ */
+inline void pack_bits(std::pmr::vector<uint8_t>& buffer, const uint32_t* values, const size_t count, const unsigned width) {
+	uint64_t accumulator = 0;
+	unsigned num_bits = 0;
+	for(size_t i = 0; i < count; ++i) {
+		accumulator |= static_cast<uint64_t>(values[i]) << num_bits;
+		num_bits += width;
+		while(num_bits >= 8) {
+			buffer.push_back(static_cast<uint8_t>(accumulator));
+			accumulator >>= 8;
+			num_bits -= 8;
+		}
+	}
+	if(num_bits > 0) {
+		buffer.push_back(static_cast<uint8_t>(accumulator));
+	}
+}
+
+/*!
+ * Reads 8 bytes as a little-endian integer.
+ *
+ * On little-endian processors, the compiler turns this into a single load.
+ * \param bytes The bytes to read.
+ * \return The integer that the bytes represent.
+ */
+inline uint64_t load_little_endian(const uint8_t* bytes) {
+	uint64_t result = 0;
+	for(unsigned byte = 0; byte < 8; ++byte) {
+		result |= static_cast<uint64_t>(bytes[byte]) << (byte * 8);
+	}
+	return result;
+}
+
+/*!
+ * Reads integers written by \ref pack_bits.
+ *
+ * Each integer is extracted independently from the others, with a load and a
+ * shift, so that the loop can be vectorised. The 8 bytes after the packed
+ * integers must be readable.
+ * \param packed The packed integers.
+ * \param count The number of integers to read.
+ * \param width The number of bits used for each integer.
+ * \param values The array to store the integers in.
+ */
+APEX_SIMD_CLONES inline void unpack_bits(const uint8_t* packed, const size_t count, const unsigned width, uint32_t* values) {
+	const uint64_t mask = (uint64_t(1) << width) - 1;
+	for(size_t i = 0; i < count; ++i) {
+		const size_t bit = i * width;
+		values[i] = static_cast<uint32_t>((load_little_endian(packed + bit / 8) >> (bit % 8)) & mask);
+	}
+}
+
+}
+
+/*!
+ * A batch of polygons that stores its vertices compressed, taking much less
+ * memory than a ``Batch<Polygon>``.
+ *
+ * This is intended for large sets of polygons that are kept in memory, but
+ * rarely processed. The polygons can't be modified in this form. To modify
+ * them, decompress them into a ``Batch<Polygon>`` first. Some operations can be
+ * performed on the compressed polygons directly though, decompressing the
+ * vertices into a small buffer on the fly, without ever decompressing the
+ * whole polygons.
+ *
+ * Adjacent vertices of a polygon are usually close to each other. The vertices
+ * are therefore stored as the difference with the previous vertex. These
+ * deltas are zigzag-encoded, so that small negative deltas also become small
+ * numbers. They are then bit-packed in blocks of 32 vertices (see
+ * \ref detail::compressed_block_size), where all X deltas of a block use the
+ * same number of bits, and all Y deltas of a block as well. Unlike variable
+ * length encodings, this can be decompressed without branches for each
+ * vertex.
+ *
+ * The compressed data of each polygon consists of:
+ * - The number of vertices, as a variable length integer.
+ * - The first vertex, as two zigzag-encoded variable length integers.
+ * - For each block of up to 32 subsequent vertices, one byte indicating the
+ * number of bits of the X deltas, one byte indicating the number of bits of
+ * the Y deltas, then the packed X deltas and the packed Y deltas.
+ * A table indicates where the data of each polygon starts, so that polygons
+ * can be decompressed in parallel.
+ */
+class CompressedPolygonBatch {
+public:
+	/*!
+	 * Creates an empty batch.
+	 * \param resource The memory resource to allocate the compressed data
+	 * from.
+	 */
+	explicit CompressedPolygonBatch(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+		data(resource),
+		starts(1, 0, resource),
+		num_vertices(0) {}
+
+	/*!
+	 * Compresses a batch of polygons.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The polygons to compress.
+	 * \param resource The memory resource to allocate the compressed data
+	 * from.
+	 */
+	template<multi_polygonal PolygonBatch>
+	explicit CompressedPolygonBatch(const PolygonBatch& batch, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+		CompressedPolygonBatch(resource) {
+		starts.reserve(batch.size() + 1);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			compress(batch[polygon]);
+		}
+		data.resize(data.size() + detail::compressed_padding, 0);
+	}
+
+	/*!
+	 * Compresses a polygon and adds it to the end of this batch.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to add.
+	 */
+	template<polygonal Polygon>
+	void push_back(const Polygon& polygon) {
+		data.resize(starts.back()); //Remove the padding while appending.
+		compress(polygon);
+		data.resize(data.size() + detail::compressed_padding, 0);
+	}
+
+	/*!
+	 * Get the number of polygons in this batch.
+	 * \return The number of polygons.
+	 */
+	size_t size() const {
+		return starts.size() - 1;
+	}
+
+	/*!
+	 * Get whether this batch has any polygons.
+	 * \return ``true`` if there are no polygons in this batch, or ``false`` if
+	 * there are.
+	 */
+	bool empty() const {
+		return size() == 0;
+	}
+
+	/*!
+	 * Get the total number of vertices of all polygons in this batch.
+	 * \return The number of vertices.
+	 */
+	size_t size_subelements() const {
+		return num_vertices;
+	}
+
+	/*!
+	 * Get the amount of memory used to store the polygons.
+	 * \return The number of bytes used for the compressed data and the table
+	 * indicating where each polygon starts.
+	 */
+	size_t memory_usage() const {
+		return data.size() * sizeof(uint8_t) + starts.size() * sizeof(size_t);
+	}
+
+	/*!
+	 * Decompresses one of the polygons in this batch.
+	 * \param index The index of the polygon to decompress.
+	 * \return A copy of that polygon.
+	 */
+	Polygon decompress(const size_t index) const {
+		const uint8_t* position = &data[starts[index]];
+		Polygon result(detail::read_varint(position));
+		Polygon::iterator destination = result.begin();
+		decode(position, result.size(), [&destination](const Point2* vertices, const size_t count) {
+			destination = std::copy(vertices, vertices + count, destination);
+		});
+		return result;
+	}
+
+	/*!
+	 * Decompresses all polygons in this batch.
+	 *
+	 * The polygons are decompressed directly into the vertex buffer of the
+	 * result, in parallel.
+	 * \return A batch with copies of all polygons in this batch.
+	 */
+	Batch<Polygon> decompress() const {
+		std::vector<size_t> offsets(size() + 1, 0);
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			const uint8_t* position = &data[starts[polygon]];
+			offsets[polygon + 1] = offsets[polygon] + detail::read_varint(position);
+		}
+		std::pmr::vector<Point2> vertices(num_vertices, data.get_allocator().resource());
+		Point2* vertices_data = vertices.data();
+		#pragma omp parallel for schedule(dynamic, 16) if(parallel())
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			const uint8_t* position = &data[starts[polygon]];
+			const size_t polygon_size = detail::read_varint(position);
+			Point2* destination = vertices_data + offsets[polygon];
+			decode(position, polygon_size, [&destination](const Point2* block, const size_t count) {
+				destination = std::copy(block, block + count, destination);
+			});
+		}
+		return Batch<Polygon>(std::move(vertices), offsets);
+	}
+
+	/*!
+	 * Computes the surface area of the polygons in this batch.
+	 *
+	 * The vertices are decompressed block by block into a small buffer, and
+	 * the shoelace formula is applied to each block as it is decompressed. The
+	 * vertices are taken relative to the first vertex of the polygon, which
+	 * gives the same area, but with much smaller coordinates.
+	 *
+	 * See ``Batch<Polygon>::area`` for details on the result.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the areas of each polygon in the same order.
+	 */
+	Batch<area_t> area() const {
+		Batch<area_t> result(size(), 0);
+		area_t* result_data = result.data();
+		#pragma omp parallel for schedule(dynamic, 16) if(parallel())
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			const uint8_t* position = &data[starts[polygon]];
+			const size_t polygon_size = detail::read_varint(position);
+			bool first = true;
+			Point2 origin(0, 0);
+			area_t previous_x = 0; //The previous vertex, relative to the origin.
+			area_t previous_y = 0;
+			area_t area = 0;
+			decode(position, polygon_size, [&](const Point2* vertices, const size_t count) {
+				if(first) {
+					origin = vertices[0];
+					first = false;
+				}
+				for(size_t vertex = 0; vertex < count; ++vertex) {
+					const area_t x = static_cast<area_t>(vertices[vertex].x) - origin.x;
+					const area_t y = static_cast<area_t>(vertices[vertex].y) - origin.y;
+					area += previous_x * y - previous_y * x;
+					previous_x = x;
+					previous_y = y;
+				}
+			}); //The closing edge back to the origin doesn't add anything.
+			result_data[polygon] = area / 2; //Instead of dividing each triangle's area by 2, simply divide the total by 2 afterwards.
+		}
+		return result;
+	}
+
+	/*!
+	 * Computes the axis-aligned bounding boxes of the polygons in this batch.
+	 *
+	 * The vertices are decompressed block by block into a small buffer, and
+	 * the bounding box of each block is merged into the bounding box of the
+	 * polygon.
+	 * \return For each polygon, the minimum and maximum corner of its bounding
+	 * box, in the same order as the order of those polygons in the batch.
+	 */
+	Batch<std::pair<Point2, Point2>> bounding_box() const {
+		Batch<std::pair<Point2, Point2>> result(size(), std::make_pair(Point2(0, 0), Point2(0, 0)));
+		std::pair<Point2, Point2>* result_data = result.data();
+		#pragma omp parallel for schedule(dynamic, 16) if(parallel())
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			const uint8_t* position = &data[starts[polygon]];
+			const size_t polygon_size = detail::read_varint(position);
+			bool first = true;
+			std::pair<Point2, Point2> box = std::make_pair(Point2(0, 0), Point2(0, 0));
+			decode(position, polygon_size, [&](const Point2* vertices, const size_t count) {
+				const std::pair<Point2, Point2> block_box = detail::bounding_box_vertices(vertices, count);
+				if(first) {
+					box = block_box;
+					first = false;
+					return;
+				}
+				box.first = Point2(std::min(box.first.x, block_box.first.x), std::min(box.first.y, block_box.first.y));
+				box.second = Point2(std::max(box.second.x, block_box.second.x), std::max(box.second.y, block_box.second.y));
+			});
+			result_data[polygon] = box;
+		}
+		return result;
+	}
+
+protected:
+	/*!
+	 * The compressed polygons, one after another, followed by padding.
+	 *
+	 * See the class description for the format.
+	 */
+	std::pmr::vector<uint8_t> data;
+
+	/*!
+	 * For each polygon, the position in \ref data where it starts, followed by
+	 * the position where the last polygon ends.
+	 */
+	std::pmr::vector<size_t> starts;
+
+	/*!
+	 * The total number of vertices in all polygons.
+	 */
+	size_t num_vertices;
+
+	/*!
+	 * Get whether the polygons of this batch are large enough to decompress
+	 * them on multiple threads.
+	 *
+	 * This uses the same crossover as computing the areas of a batch of
+	 * polygons, since decompressing is similarly cheap for each vertex.
+	 * \return ``true`` to use multiple threads, or ``false`` to use only one.
+	 */
+	bool parallel() const {
+		return detail::Strategies::choose(detail::Operation::area_batch, size() + num_vertices) != 0;
+	}
+
+	/*!
+	 * Compresses a polygon and appends it to the data, without padding.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to compress.
+	 */
+	template<polygonal Polygon>
+	void compress(const Polygon& polygon) {
+		const size_t polygon_size = polygon.size();
+		detail::write_varint(data, polygon_size);
+		if(polygon_size > 0) {
+			const Point2 first = polygon[0];
+			detail::write_varint(data, detail::zigzag_encode(first.x));
+			detail::write_varint(data, detail::zigzag_encode(first.y));
+			uint32_t deltas_x[detail::compressed_block_size];
+			uint32_t deltas_y[detail::compressed_block_size];
+			for(size_t block_start = 1; block_start < polygon_size; block_start += detail::compressed_block_size) {
+				const size_t count = std::min(detail::compressed_block_size, polygon_size - block_start);
+				uint32_t all_bits_x = 0;
+				uint32_t all_bits_y = 0;
+				for(size_t vertex = 0; vertex < count; ++vertex) {
+					const Point2 current = polygon[block_start + vertex];
+					const Point2 previous = polygon[block_start + vertex - 1];
+					//Subtract as unsigned integers, so that the delta wraps around instead of overflowing. Adding it back wraps around the same way.
+					deltas_x[vertex] = detail::zigzag_encode(static_cast<int32_t>(static_cast<uint32_t>(current.x) - static_cast<uint32_t>(previous.x)));
+					deltas_y[vertex] = detail::zigzag_encode(static_cast<int32_t>(static_cast<uint32_t>(current.y) - static_cast<uint32_t>(previous.y)));
+					all_bits_x |= deltas_x[vertex];
+					all_bits_y |= deltas_y[vertex];
+				}
+				const unsigned width_x = std::bit_width(all_bits_x);
+				const unsigned width_y = std::bit_width(all_bits_y);
+				data.push_back(static_cast<uint8_t>(width_x));
+				data.push_back(static_cast<uint8_t>(width_y));
+				detail::pack_bits(data, deltas_x, count, width_x);
+				detail::pack_bits(data, deltas_y, count, width_y);
+			}
+		}
+		starts.push_back(data.size());
+		num_vertices += polygon_size;
+	}
+
+	/*!
+	 * Decompresses the vertices of a polygon, block by block.
+	 *
+	 * The first vertex is given to the visitor alone. Then each block of up to
+	 * \ref detail::compressed_block_size vertices is given to the visitor,
+	 * until all vertices of the polygon have been given.
+	 * \tparam Visitor A function to call with each block of vertices.
+	 * \param position The start of the compressed vertices, after the number
+	 * of vertices.
+	 * \param polygon_size The number of vertices in the polygon.
+	 * \param visit The function to call with a pointer to the vertices of each
+	 * block, and the number of vertices in that block.
+	 */
+	template<typename Visitor>
+	static void decode(const uint8_t* position, const size_t polygon_size, Visitor&& visit) {
+		if(polygon_size == 0) {
+			return;
+		}
+		const coord_t first_x = detail::zigzag_decode(detail::read_varint(position));
+		const coord_t first_y = detail::zigzag_decode(detail::read_varint(position));
+		Point2 vertices[detail::compressed_block_size];
+		vertices[0] = Point2(first_x, first_y);
+		visit(static_cast<const Point2*>(vertices), size_t(1));
+
+		uint32_t deltas_x[detail::compressed_block_size];
+		uint32_t deltas_y[detail::compressed_block_size];
+		uint32_t x = static_cast<uint32_t>(first_x);
+		uint32_t y = static_cast<uint32_t>(first_y);
+		for(size_t block_start = 1; block_start < polygon_size; block_start += detail::compressed_block_size) {
+			const size_t count = std::min(detail::compressed_block_size, polygon_size - block_start);
+			const unsigned width_x = position[0];
+			const unsigned width_y = position[1];
+			position += 2;
+			detail::unpack_bits(position, count, width_x, deltas_x);
+			position += (count * width_x + 7) / 8;
+			detail::unpack_bits(position, count, width_y, deltas_y);
+			position += (count * width_y + 7) / 8;
+			for(size_t vertex = 0; vertex < count; ++vertex) {
+				x += static_cast<uint32_t>(detail::zigzag_decode(deltas_x[vertex]));
+				y += static_cast<uint32_t>(detail::zigzag_decode(deltas_y[vertex]));
+				vertices[vertex] = Point2(static_cast<coord_t>(x), static_cast<coord_t>(y));
+			}
+			visit(static_cast<const Point2*>(vertices), count);
+		}
+	}
+};
+
+}
+
+#endif //APEX_COMPRESSED_POLYGON_BATCH
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_CALIBRATION
+#define APEX_CALIBRATION
+
+/*
+This file contains the input sizes from which each version of an operation is
+faster than the previous version. These are untuned defaults, not measurements.
+Many operations share a placeholder of 20000 for the first crossover, which
+keeps small inputs on a single thread. The calibration application in the
+benchmarking directory can measure the actual crossovers on a computer. It
+writes a file in the same format as this one. To build the library with those
+measurements, define APEX_CALIBRATION_FILE as the path to that file.
+*/
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * For each operation, the input sizes from which each version is faster than
+ * the previous version.
+ */
+constexpr std::array<Crossovers, num_operations> calibrated_crossovers = index_crossovers(std::to_array<CalibratedOperation>({
+	{Operation::area, {400, 3000, no_crossover}},
+	{Operation::area_batch, {200, no_crossover, no_crossover}},
+	{Operation::area_fixed_batch, {2000, no_crossover, no_crossover}},
+	{Operation::area_soa, {1000, 3000, no_crossover}},
+	{Operation::area_soa_batch, {400, no_crossover, no_crossover}},
+	{Operation::bounding_box, {20000, no_crossover, no_crossover}},
+	{Operation::bounding_box_batch, {20000, no_crossover, no_crossover}},
+	{Operation::bounding_box_fixed_batch, {20000, no_crossover, no_crossover}},
+	{Operation::bounding_box_soa, {20000, no_crossover, no_crossover}},
+	{Operation::bounding_box_soa_batch, {20000, no_crossover, no_crossover}},
+	{Operation::clip, {20000, no_crossover, no_crossover}},
+	{Operation::contains, {20000, no_crossover, no_crossover}},
+	{Operation::contains_batch, {400, no_crossover, no_crossover}},
+	{Operation::contains_fixed_batch, {4000, no_crossover, no_crossover}},
+	{Operation::contains_points, {20000, no_crossover, no_crossover}},
+	{Operation::convexity, {20000, no_crossover, no_crossover}},
+	{Operation::convexity_batch, {400, no_crossover, no_crossover}},
+	{Operation::intersecting_pairs, {20000, no_crossover, no_crossover}},
+	{Operation::intersecting_pairs_batch, {20000, no_crossover, no_crossover}},
+	{Operation::intersects_segments, {20000, no_crossover, no_crossover}},
+	{Operation::offset, {1000, no_crossover, no_crossover}},
+	{Operation::offset_batch, {1000, no_crossover, no_crossover}},
+	{Operation::r_tree_query_batch, {64, no_crossover, no_crossover}},
+	{Operation::self_intersections, {64, 20000, no_crossover}},
+	{Operation::self_intersections_batch, {200, no_crossover, no_crossover}},
+	{Operation::transform, {20000, no_crossover, no_crossover}},
+	{Operation::transform_batch, {20000, no_crossover, no_crossover}},
+	{Operation::transform_soa, {20000, no_crossover, no_crossover}},
+	{Operation::transform_soa_batch, {20000, no_crossover, no_crossover}},
+	{Operation::translate, {100000, no_crossover, no_crossover}},
+	{Operation::translate_batch, {100000, no_crossover, no_crossover}},
+	{Operation::translate_fixed_batch, {100000, no_crossover, no_crossover}},
+	{Operation::translate_soa, {100000, no_crossover, no_crossover}},
+	{Operation::translate_soa_batch, {100000, no_crossover, no_crossover}}
+}));
+
+}
+
+}
+
+#endif //APEX_CALIBRATION
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_FIXED_SIZE
+#define APEX_FIXED_SIZE
+
+#include <cstddef> //For size_t.
+#include <utility> //To generate the sequence of indices.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * The number of polygons that each thread processes at a time, when processing
+ * batches of polygons with a fixed number of vertices in parallel.
+ *
+ * All of these polygons take equally long, so the blocks don't need to be
+ * small to balance the load. They need to be big enough to fill the vector
+ * registers many times over, and to keep the threads from writing to the same
+ * cache lines of the results.
+ */
+constexpr size_t fixed_block_size = 1024;
+
+/*!
+ * Calls a function once for each index in a range that is known at compile
+ * time, without a loop.
+ *
+ * The index is given to the function as a template argument, so that the
+ * function can compute the neighbouring indices at compile time as well. For a
+ * polygon with a fixed number of vertices, this computes the index of the
+ * previous vertex without any modulo operation at run-time.
+ *
+ * The calls are generated with a fold expression, so they are always unrolled,
+ * regardless of how the compiler would otherwise decide to unroll a loop. This
+ * is only suitable for small ranges, such as the vertices of triangles or
+ * quads.
+ *
+ * Use it with a lambda with a template parameter, such as:
+ * ``unroll<4>([&]<size_t index>() { sum += values[index]; });``
+ * \tparam count The number of indices to call the function with, starting from
+ * 0.
+ * \tparam Function The type of function to call.
+ * \param function The function to call for each index.
+ */
+template<size_t count, typename Function>
+constexpr void unroll(Function&& function) {
+	[&]<size_t... index>(std::index_sequence<index...>) {
+		(function.template operator()<index>(), ...);
+	}(std::make_index_sequence<count>());
+}
+
+}
+
+}
+
+#endif //APEX_FIXED_SIZE
\ No newline at end of file
@@ -9,6 +9,9 @@
 #ifndef APEX_GEOMETRY_CONCEPTS
 #define APEX_GEOMETRY_CONCEPTS
 
+#include <type_traits> //To require the number of vertices of fixed-size polygons to be a constant.
+
+#include "../coordinate.hpp" //To require coordinate arrays.
 #include "../point2.hpp" //To require return types.
 
 namespace apex {
@@ -38,6 +41,82 @@ concept multi_polygonal = requires(T object) {
 	{ object[1] } -> polygonal;
 };
 
+/*!
+ * A concept for polygons that store their coordinates in a structure of arrays.
+ *
+ * These are still polygons, but instead of storing their vertices as one array
+ * of points, they store the X coordinates and the Y coordinates of all vertices
+ * in two separate arrays. Algorithms can then load the coordinates of multiple
+ * consecutive vertices at once, which vectorises better.
+ *
+ * Since these objects are polygonal too, this concept is more specific than
+ * \ref polygonal. Functions with an overload for this concept will prefer it.
+ */
+template<typename T>
+concept soa_polygonal = polygonal<T> && requires(T object) {
+	{ object.data_x() } -> std::convertible_to<const coord_t*>;
+	{ object.data_y() } -> std::convertible_to<const coord_t*>;
+};
+
+/*!
+ * A concept for batches of polygons that store their coordinates in a
+ * structure of arrays.
+ *
+ * The X coordinates and the Y coordinates of all vertices of all polygons are
+ * stored in two separate arrays. A third array indicates where each polygon
+ * starts in those arrays, with one extra element at the end to indicate where
+ * the last polygon ends.
+ *
+ * Since these objects are multi-polygonal too, this concept is more specific
+ * than \ref multi_polygonal. Functions with an overload for this concept will
+ * prefer it.
+ */
+template<typename T>
+concept soa_multi_polygonal = multi_polygonal<T> && requires(T object) {
+	{ object.data_x() } -> std::convertible_to<const coord_t*>;
+	{ object.data_y() } -> std::convertible_to<const coord_t*>;
+	{ object.data_starts() } -> std::convertible_to<const size_t*>;
+	{ object.size_subelements() } -> std::unsigned_integral;
+};
+
+/*!
+ * A concept for polygons that have a number of vertices that is fixed at
+ * compile time.
+ *
+ * These polygons store their vertices contiguously as an array of points. Since
+ * the number of vertices is a constant, algorithms can be unrolled completely
+ * and don't need to wrap around the end of the vertex array at run-time.
+ *
+ * Since these objects are polygonal too, this concept is more specific than
+ * \ref polygonal. Functions with an overload for this concept will prefer it.
+ */
+template<typename T>
+concept fixed_polygonal = polygonal<T> && requires(T object) {
+	typename std::integral_constant<size_t, T::fixed_size>; //The number of vertices must be a constant expression.
+	{ object.data() } -> std::convertible_to<const Point2*>;
+};
+
+/*!
+ * A concept for batches of polygons that all have the same number of vertices,
+ * fixed at compile time.
+ *
+ * The vertices of all polygons are stored contiguously as one array of points.
+ * Since every polygon has the same number of vertices, polygon ``i`` starts at
+ * index ``i * fixed_size`` in that array, so no table is needed to find the
+ * polygons. Algorithms can then process many polygons at once with SIMD
+ * instructions, each lane computing a different polygon.
+ *
+ * Since these objects are multi-polygonal too, this concept is more specific
+ * than \ref multi_polygonal. Functions with an overload for this concept will
+ * prefer it.
+ */
+template<typename T>
+concept fixed_multi_polygonal = multi_polygonal<T> && requires(T object) {
+	typename std::integral_constant<size_t, T::fixed_size>; //The number of vertices of each polygon must be a constant expression.
+	{ object.data() } -> std::convertible_to<const Point2*>;
+	{ object.size_subelements() } -> std::unsigned_integral;
+};
+
 }
 
 #endif //APEX_GEOMETRY_CONCEPTS
\ No newline at end of file
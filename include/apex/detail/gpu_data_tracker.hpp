@@ -9,11 +9,37 @@
 #ifndef APEX_GPU_DATA_TRACKER
 #define APEX_GPU_DATA_TRACKER
 
+#include <atomic> //To check quickly whether there is anything to synchronise, without locking.
+#include <limits> //To not limit the memory on the GPU by default.
+#include <list> //To track which data was used least recently.
+#include <mutex> //To allow using the tracker from multiple threads.
+#include <unordered_map> //To track the synchronisation state of each piece of data.
+
+#include "../instrumentation.hpp" //To report how much data is transferred.
+
 //All the types we need to be able to sync.
-#include "apex/point2.hpp"
+#include "../point2.hpp"
 
 namespace apex {
 
+/*!
+ * Indicates that a type registers its data with the ``GPUDataTracker``.
+ *
+ * Operations that run on the GPU leave the data of these types on the GPU
+ * afterwards, so that subsequent operations on the GPU don't need to transfer
+ * it again. The type itself is responsible for synchronising the data back to
+ * the host when it is accessed there, and for releasing the data on the GPU
+ * when its memory is freed or reallocated.
+ *
+ * Types opt in to this by defining a static constant ``gpu_tracked`` that is
+ * ``true``. For other types, the operations transfer the data to and from the
+ * GPU every time.
+ */
+template<typename T>
+concept gpu_tracked = requires {
+	requires T::gpu_tracked;
+};
+
 /*!
  * The ``GPUDataTracker`` tracks what data is currently on the GPU and what is
  * currently on the host.
@@ -31,7 +57,39 @@ namespace apex {
  * The ``GPUDataTracker`` tracks a synchronisation state for each piece of data.
  * This state tracks whether the data on the host is the most up-to-date
  * version, the data on the GPU is the most up-to-date, or whether the two are
- * in sync.
+ * in sync. Data that is not tracked at all is only present on the host.
+ *
+ * Data is identified by the address of its buffer on the host. Once data has
+ * been synchronised to the GPU, the GPU keeps a copy of it until the data is
+ * released. The owner of the data must release it before freeing or
+ * reallocating the buffer. As a safety net, the tracker also remembers which
+ * object owns each buffer. If an object synchronises a different buffer than
+ * before, its previous buffer was reallocated without being released, so the
+ * copy of that buffer is removed from the GPU. If a buffer is synchronised by a
+ * different object than before, its address was reused or the object was
+ * moved. Either way, the data on the GPU is refreshed before it is used.
+ *
+ * The GPU has limited memory. The tracker keeps the total size of the data it
+ * keeps on the GPU within a budget. If some data doesn't fit any more, the data
+ * that was used least recently is removed from the GPU. If it was changed on
+ * the GPU, it is transferred back to the host first. Data that is larger than
+ * the entire budget is not kept on the GPU at all. Operations then transfer it
+ * every time they need it.
+ *
+ * Operations can also be queued on the GPU without waiting for them to finish.
+ * These asynchronous operations transfer their data with deferred tasks too,
+ * so that the transfer of one piece of data can overlap with computations on
+ * another. The tasks that use the same data are ordered by their dependencies
+ * on the buffer of that data. Before the tracker transfers data to the host,
+ * removes it from the GPU, or lets the host modify it, it waits for the tasks
+ * that use that data. Blocking operations on the GPU wait for them too. Only
+ * tasks that were queued by the same host thread are waited for, as OpenMP
+ * only orders tasks with their siblings.
+ *
+ * Operations may be called from multiple host threads at the same time, so
+ * the tracker locks its state whenever it is accessed. Accessing data on the
+ * host while nothing was changed on the GPU doesn't need to lock, so that the
+ * host accessors stay fast.
  *
  * Being a resource management system, it is inappropriate to have multiple
  * copies tracking the synchronisation state of memory objects. For that reason,
@@ -50,9 +108,23 @@ public:
 	 *
 	 * Any data on the host will be invalidated. If data is changed on the host
 	 * and the GPU simultaneously, the latest change will be seen as leading.
+	 *
+	 * The data must have been synchronised to the GPU before. If it was removed
+	 * from the GPU in the meanwhile, the operation transferred its result back
+	 * to the host by itself, so nothing needs to happen.
+	 * \param points The data that was changed.
 	 */
 	static void changed_on_gpu(const Point2* points) {
-		sync_state[points] = GPUSyncState::DEVICE;
+		const std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(points);
+		if(tracked == sync_state.end()) { //Not on the GPU, so it can't have changed there.
+			return;
+		}
+		if(tracked->second.state != GPUSyncState::DEVICE) {
+			num_on_device++;
+		}
+		tracked->second.state = GPUSyncState::DEVICE;
+		touch(tracked->second);
 	}
 
 	/*!
@@ -60,9 +132,22 @@ public:
 	 *
 	 * Any data on the GPU will be invalidated. If data is changed on the host
 	 * and the GPU simultaneously, the latest change will be seen as leading.
+	 * \param points The data that was changed.
 	 */
 	static void changed_on_host(const Point2* points) {
-		sync_state[points] = GPUSyncState::HOST;
+		if(num_tracked == 0) { //Nothing is on the GPU, so nothing to invalidate.
+			return;
+		}
+		const std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(points);
+		if(tracked == sync_state.end()) {
+			return;
+		}
+		wait_for_tasks(points); //Don't modify the data while the GPU may still be reading it.
+		if(tracked->second.state == GPUSyncState::DEVICE) {
+			num_on_device--;
+		}
+		tracked->second.state = GPUSyncState::HOST;
 	}
 
 	/*!
@@ -71,14 +156,90 @@ public:
 	 * If the GPU data was outdated, this ensures that the data on the GPU is
 	 * up to date again. If the data on the GPU was already updated, this won't
 	 * unnecessarily transfer anything.
+	 *
+	 * After this, target regions that map this data find it already present on
+	 * the GPU, so they won't transfer it either. If the data doesn't fit in the
+	 * memory budget, it is not put on the GPU, and target regions transfer it
+	 * themselves.
+	 *
+	 * If the synchronisation is asynchronous, the transfer is only queued. Tasks
+	 * that depend on the first point of the data are executed after the
+	 * transfer completes, so the target region of an asynchronous operation
+	 * must have an ``in`` or ``inout`` dependency on it. Otherwise, this first
+	 * waits for any asynchronous operations that are still using the data, so
+	 * that blocking target regions get to see their results.
+	 * \param points The data to synchronise.
+	 * \param count The number of points in the data.
+	 * \param owner The object that owns the data, such as the polygon or batch
+	 * it belongs to.
+	 * \param asynchronous Whether to queue the transfer rather than waiting for
+	 * it to complete.
 	 */
-	static void sync_to_gpu(const Point2* points, const size_t count) {
-		std::unordered_map<const Point2*, GPUSyncState>::iterator current_sync_state = sync_state.find(points);
-		if(current_sync_state != sync_state.end() && current_sync_state->second != GPUSyncState::HOST) { //GPU already has the most recent copy.
+	static void sync_to_gpu(const Point2* points, const size_t count, const void* owner, const bool asynchronous = false) {
+		if(count == 0) {
 			return;
 		}
-		#pragma omp target enter data map(to:points[count])
-		sync_state[points] = GPUSyncState::SYNC; //The host and device are now in sync.
+		const std::lock_guard<std::mutex> lock(mutex);
+		if(!asynchronous) {
+			wait_for_tasks(points);
+		}
+
+		//If the owner had a different buffer before, that buffer was reallocated without releasing it.
+		std::unordered_map<const void*, const Point2*>::iterator previous_buffer = owners.find(owner);
+		if(previous_buffer != owners.end() && previous_buffer->second != points) {
+			std::unordered_map<const Point2*, TrackedData>::iterator stale = sync_state.find(previous_buffer->second);
+			if(stale != sync_state.end() && stale->second.owner == owner && stale->second.state != GPUSyncState::DEVICE) { //Never discard changes, in case the buffer was moved to a different owner instead.
+				remove(stale);
+			}
+		}
+		owners[owner] = points;
+
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(points);
+		if(tracked != sync_state.end() && tracked->second.owner != owner) { //The address was reused, or the owner was moved.
+			if(tracked->second.state != GPUSyncState::DEVICE) { //Changes on the GPU can only be from a moved owner, so keep those. Otherwise, refresh the data to be sure.
+				tracked->second.state = GPUSyncState::HOST;
+			}
+			tracked->second.owner = owner;
+		}
+		if(tracked != sync_state.end() && tracked->second.count != count) { //The data changed size, so it needs to be remapped.
+			if(tracked->second.state == GPUSyncState::DEVICE) { //Keep the changes of the part that was on the GPU.
+				transfer_to_host(points, tracked->second.count);
+			}
+			remove(tracked);
+			tracked = sync_state.end();
+		}
+
+		if(tracked == sync_state.end()) { //Not on the GPU yet.
+			const size_t bytes = count * sizeof(Point2);
+			if(bytes > memory_budget) { //Would never fit. Let the target regions transfer it.
+				return;
+			}
+			while(memory_used + bytes > memory_budget) {
+				evict_least_recently_used();
+			}
+			const detail::TransferTimer timer(TransferEvent::Direction::TO_DEVICE, bytes, asynchronous);
+			if(asynchronous) {
+				#pragma omp target enter data map(to:points[0:count]) nowait depend(out:points[0])
+			} else {
+				#pragma omp target enter data map(to:points[0:count])
+			}
+			recency.push_front(points);
+			sync_state[points] = {GPUSyncState::SYNC, count, owner, recency.begin()};
+			memory_used += bytes;
+			num_tracked++;
+			return;
+		}
+		if(tracked->second.state == GPUSyncState::HOST) { //GPU has an outdated copy.
+			const detail::TransferTimer timer(TransferEvent::Direction::TO_DEVICE, count * sizeof(Point2), asynchronous);
+			if(asynchronous) {
+				#pragma omp target update to(points[0:count]) nowait depend(out:points[0])
+			} else {
+				#pragma omp target update to(points[0:count])
+			}
+			tracked->second.state = GPUSyncState::SYNC;
+		}
+		//Otherwise the GPU already has the most recent copy.
+		touch(tracked->second);
 	}
 
 	/*!
@@ -87,14 +248,80 @@ public:
 	 * If the host data was outdated, this ensures that the data on the host is
 	 * up to date again. If the data on the host was already updated, this won't
 	 * unnecessarily transfer anything.
+	 *
+	 * This is called for every access to the data on the host, so it returns
+	 * quickly if no data at all has changed on the GPU.
+	 * \param points The data to synchronise.
 	 */
-	static void sync_to_host(const Point2* points, const size_t count) {
-		std::unordered_map<const Point2*, GPUSyncState>::iterator current_sync_state = sync_state.find(points);
-		if(current_sync_state == sync_state.end() || current_sync_state->second != GPUSyncState::DEVICE) { //Host already has the most recent copy.
+	static void sync_to_host(const Point2* points) {
+		if(num_on_device == 0) { //Host has the most recent copy of everything.
+			return;
+		}
+		const std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(points);
+		if(tracked == sync_state.end() || tracked->second.state != GPUSyncState::DEVICE) { //Host already has the most recent copy.
 			return;
 		}
-		#pragma omp target update from(points[count])
-		sync_state[points] = GPUSyncState::SYNC; //The host and device are now in sync.
+		transfer_to_host(points, tracked->second.count);
+		tracked->second.state = GPUSyncState::SYNC; //The host and device are now in sync.
+		num_on_device--;
+	}
+
+	/*!
+	 * Remove point data from the GPU.
+	 *
+	 * This must be called before the memory of the data is freed or
+	 * reallocated on the host. Any changes made on the GPU that were not
+	 * synchronised to the host yet are lost. If the data is not on the GPU,
+	 * nothing happens.
+	 * \param points The data to remove.
+	 */
+	static void release(const Point2* points) {
+		if(num_tracked == 0) {
+			return;
+		}
+		const std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(points);
+		if(tracked == sync_state.end()) {
+			return;
+		}
+		remove(tracked);
+	}
+
+	/*!
+	 * Set the maximum amount of memory that the tracker may keep occupied on
+	 * the GPU.
+	 *
+	 * If more memory is currently occupied, data is removed from the GPU until
+	 * it fits.
+	 * \param bytes The maximum number of bytes to keep on the GPU.
+	 */
+	static void set_memory_budget(const size_t bytes) {
+		const std::lock_guard<std::mutex> lock(mutex);
+		memory_budget = bytes;
+		while(memory_used > memory_budget) {
+			evict_least_recently_used();
+		}
+	}
+
+	/*!
+	 * Get the maximum amount of memory that the tracker may keep occupied on
+	 * the GPU.
+	 * \return The maximum number of bytes to keep on the GPU.
+	 */
+	static size_t get_memory_budget() {
+		const std::lock_guard<std::mutex> lock(mutex);
+		return memory_budget;
+	}
+
+	/*!
+	 * Get the amount of memory that the tracker currently keeps occupied on the
+	 * GPU.
+	 * \return The number of bytes of data on the GPU.
+	 */
+	static size_t get_memory_used() {
+		const std::lock_guard<std::mutex> lock(mutex);
+		return memory_used;
 	}
 
 	/*!
@@ -127,19 +354,168 @@ protected:
 	 * copy, or both have the most recent copy (they are in sync).
 	 */
 	enum GPUSyncState {
-		HOST, //The host currently has a more recent copy. The polygon may not be on the GPU at all.
+		HOST, //The host currently has a more recent copy. The GPU has an outdated copy.
 		DEVICE, //The GPU device currently has a more recent copy.
 		SYNC //The host and GPU are currently in sync. Both have a recent copy.
 	};
-	
+
 	/*!
-	 * For each memory object, tracks whether the object is currently up-to-date
-	 * in the host, in the GPU, or both.
+	 * The information tracked for each piece of data that is on the GPU.
 	 */
-	static std::unordered_map<const Point2*, GPUSyncState> sync_state;
-};
+	struct TrackedData {
+		/*!
+		 * Whether the host or the GPU has the most recent copy, or both.
+		 */
+		GPUSyncState state;
 
-std::unordered_map<const Point2*, GPUDataTracker::GPUSyncState> GPUDataTracker::sync_state;
+		/*!
+		 * The number of elements that were mapped to the GPU.
+		 */
+		size_t count;
+
+		/*!
+		 * The object that last synchronised this data to the GPU.
+		 */
+		const void* owner;
+
+		/*!
+		 * The position of this data in the \ref recency list.
+		 */
+		std::list<const Point2*>::iterator recency_position;
+	};
+
+	/*!
+	 * Protects the state of the tracker against concurrent access from
+	 * multiple host threads.
+	 */
+	inline static std::mutex mutex;
+
+	/*!
+	 * For each memory object on the GPU, tracks whether the object is currently
+	 * up-to-date in the host, in the GPU, or both.
+	 */
+	inline static std::unordered_map<const Point2*, TrackedData> sync_state;
+
+	/*!
+	 * For each object that synchronised data to the GPU, the buffer that it
+	 * synchronised last.
+	 *
+	 * This is used to detect when an object reallocated its buffer.
+	 */
+	inline static std::unordered_map<const void*, const Point2*> owners;
+
+	/*!
+	 * The data on the GPU, ordered from most recently used to least recently
+	 * used.
+	 */
+	inline static std::list<const Point2*> recency;
+
+	/*!
+	 * The maximum number of bytes to keep on the GPU.
+	 */
+	inline static size_t memory_budget = std::numeric_limits<size_t>::max();
+
+	/*!
+	 * The number of bytes of data currently on the GPU.
+	 */
+	inline static size_t memory_used = 0;
+
+	/*!
+	 * The number of memory objects on the GPU.
+	 *
+	 * This can be read without locking, to quickly find that there is nothing
+	 * to do.
+	 */
+	inline static std::atomic<size_t> num_tracked = 0;
+
+	/*!
+	 * The number of memory objects for which the GPU has a more recent copy
+	 * than the host.
+	 *
+	 * This can be read without locking, to quickly find that there is nothing
+	 * to do.
+	 */
+	inline static std::atomic<size_t> num_on_device = 0;
+
+	/*!
+	 * Mark some data as the most recently used.
+	 *
+	 * The mutex must be locked while calling this.
+	 * \param tracked The data that was used.
+	 */
+	static void touch(TrackedData& tracked) {
+		recency.splice(recency.begin(), recency, tracked.recency_position);
+	}
+
+	/*!
+	 * Wait for the asynchronous operations that use some data to complete.
+	 *
+	 * Only the tasks queued by the current thread are waited for.
+	 * \param points The data to wait for.
+	 */
+	static void wait_for_tasks([[maybe_unused]] const Point2* points) {
+		#pragma omp taskwait depend(inout:points[0])
+	}
+
+	/*!
+	 * Transfer data from the GPU to the host.
+	 *
+	 * Any asynchronous operations still using the data are completed first.
+	 * \param points The data to transfer.
+	 * \param count The number of points to transfer.
+	 */
+	static void transfer_to_host(const Point2* points, const size_t count) {
+		wait_for_tasks(points);
+		const detail::TransferTimer timer(TransferEvent::Direction::TO_HOST, count * sizeof(Point2), false);
+		#pragma omp target update from(points[0:count])
+	}
+
+	/*!
+	 * Remove some data from the GPU and stop tracking it, without transferring
+	 * it back.
+	 *
+	 * The data is released rather than deleted from the GPU. If a target region
+	 * on a different thread is still using it, it is only freed once that
+	 * region completes. Asynchronous operations queued by the current thread are
+	 * completed first.
+	 *
+	 * The mutex must be locked while calling this.
+	 * \param tracked The data to remove.
+	 */
+	static void remove(const std::unordered_map<const Point2*, TrackedData>::iterator tracked) {
+		const Point2* points = tracked->first;
+		const size_t count = tracked->second.count;
+		wait_for_tasks(points);
+		#pragma omp target exit data map(release:points[0:count])
+		if(tracked->second.state == GPUSyncState::DEVICE) {
+			num_on_device--;
+		}
+		std::unordered_map<const void*, const Point2*>::iterator owner = owners.find(tracked->second.owner);
+		if(owner != owners.end() && owner->second == points) {
+			owners.erase(owner);
+		}
+		recency.erase(tracked->second.recency_position);
+		memory_used -= count * sizeof(Point2);
+		sync_state.erase(tracked);
+		num_tracked--;
+	}
+
+	/*!
+	 * Remove the least recently used data from the GPU, to make room for other
+	 * data.
+	 *
+	 * If the data was changed on the GPU, it is transferred to the host first.
+	 *
+	 * The mutex must be locked while calling this.
+	 */
+	static void evict_least_recently_used() {
+		std::unordered_map<const Point2*, TrackedData>::iterator tracked = sync_state.find(recency.back());
+		if(tracked->second.state == GPUSyncState::DEVICE) {
+			transfer_to_host(tracked->first, tracked->second.count);
+		}
+		remove(tracked);
+	}
+};
 
 }
 
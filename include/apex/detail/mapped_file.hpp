@@ -0,0 +1,180 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_MAPPED_FILE
+#define APEX_MAPPED_FILE
+
+#include <cerrno> //To report why the file couldn't be mapped.
+#include <fcntl.h> //To open the file to map.
+#include <filesystem> //To indicate which file to map.
+#include <sys/mman.h> //To map the file into memory.
+#include <sys/stat.h> //To find the size of the file to map.
+#include <system_error> //To report failures of the operating system.
+#include <unistd.h> //To close the file after mapping it.
+#include <utility> //For std::exchange.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * A file that is mapped into memory, for as long as this object exists.
+ *
+ * Only the pages of the file that are actually accessed get read from disk.
+ * The mapping is private, so if it is writable, modifications are made to a
+ * copy of the modified pages in memory, and never end up in the file.
+ */
+class MappedFile {
+public:
+	/*!
+	 * Maps a file into memory.
+	 *
+	 * An empty file is not mapped, but gives an empty range of memory.
+	 * \param filename The file to map.
+	 * \param writable Whether the mapped memory may be modified. The file itself
+	 * is never modified.
+	 */
+	explicit MappedFile(const std::filesystem::path& filename, const bool writable = false) {
+		const int file_descriptor = open(filename.c_str(), O_RDONLY);
+		if(file_descriptor < 0) {
+			throw std::system_error(errno, std::generic_category(), "Couldn't open " + filename.string() + ".");
+		}
+		struct stat status;
+		if(fstat(file_descriptor, &status) != 0) {
+			const int error = errno;
+			close(file_descriptor);
+			throw std::system_error(error, std::generic_category(), "Couldn't find the size of " + filename.string() + ".");
+		}
+		mapping_size = status.st_size;
+		if(mapping_size == 0) { //Mapping nothing is not allowed.
+			close(file_descriptor);
+			return;
+		}
+		void* mapped = mmap(nullptr, mapping_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		const int error = errno;
+		close(file_descriptor); //The mapping stays valid after closing the file.
+		if(mapped == MAP_FAILED) {
+			mapping_size = 0;
+			throw std::system_error(error, std::generic_category(), "Couldn't map " + filename.string() + " into memory.");
+		}
+		mapping = static_cast<char*>(mapped);
+	}
+
+	/*!
+	 * The mapping can't be copied, since each mapping is unmapped when it is
+	 * destroyed.
+	 */
+	MappedFile(const MappedFile& original) = delete;
+
+	/*!
+	 * Moves the mapping to a new object.
+	 *
+	 * The mapped memory stays in the same place.
+	 * \param original The object to take the mapping from.
+	 */
+	MappedFile(MappedFile&& original) noexcept :
+		mapping(std::exchange(original.mapping, nullptr)),
+		mapping_size(std::exchange(original.mapping_size, 0)) {}
+
+	/*!
+	 * Unmaps the file from memory.
+	 */
+	~MappedFile() {
+		unmap();
+	}
+
+	/*!
+	 * The mapping can't be copied, since each mapping is unmapped when it is
+	 * destroyed.
+	 * \param other The mapping that would be copied.
+	 * \return A reference to this mapping.
+	 */
+	MappedFile& operator =(const MappedFile& other) = delete;
+
+	/*!
+	 * Moves the mapping of another object to this object.
+	 *
+	 * The file that this object mapped is unmapped first.
+	 * \param other The object to take the mapping from.
+	 * \return A reference to this mapping.
+	 */
+	MappedFile& operator =(MappedFile&& other) noexcept {
+		if(this != &other) {
+			unmap();
+			mapping = std::exchange(other.mapping, nullptr);
+			mapping_size = std::exchange(other.mapping_size, 0);
+		}
+		return *this;
+	}
+
+	/*!
+	 * Get the mapped contents of the file.
+	 * \return A pointer to the first byte of the file, or ``nullptr`` if
+	 * nothing is mapped.
+	 */
+	char* data() {
+		return mapping;
+	}
+
+	/*!
+	 * Get the mapped contents of the file.
+	 * \return A pointer to the first byte of the file, or ``nullptr`` if
+	 * nothing is mapped.
+	 */
+	const char* data() const {
+		return mapping;
+	}
+
+	/*!
+	 * Get the size of the mapped file.
+	 * \return The number of bytes that are mapped.
+	 */
+	size_t size() const {
+		return mapping_size;
+	}
+
+	/*!
+	 * Tell the operating system that the file will be read from start to end.
+	 *
+	 * This makes it read ahead further, so that reading the file doesn't need
+	 * to wait for the disk as often.
+	 */
+	void advise_sequential() const {
+		if(mapping) {
+			madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+		}
+	}
+
+protected:
+	/*!
+	 * The memory that the file is mapped to, or ``nullptr`` if nothing is
+	 * mapped.
+	 */
+	char* mapping = nullptr;
+
+	/*!
+	 * The number of bytes mapped into memory.
+	 */
+	size_t mapping_size = 0;
+
+	/*!
+	 * Unmaps the file from memory, if it is mapped.
+	 */
+	void unmap() {
+		if(mapping) {
+			munmap(mapping, mapping_size);
+			mapping = nullptr;
+		}
+	}
+};
+
+}
+
+}
+
+#endif //APEX_MAPPED_FILE
\ No newline at end of file
@@ -9,6 +9,14 @@
 #ifndef APEX_POLYGON_PROPERTIES
 #define APEX_POLYGON_PROPERTIES
 
+#include <concepts> //To define which types cache their properties.
+#include <ostream> //To print the properties to a stream.
+#include <string> //To print the properties to a stream.
+#include <utility> //To return bounding boxes as pairs of corners.
+
+#include "../coordinate.hpp" //To cache the area.
+#include "../point2.hpp" //To cache the bounding box.
+
 namespace apex {
 
 /*!
@@ -17,6 +25,10 @@ namespace apex {
  * These properties must not add any new information that cannot be derived from
  * the polygon itself. It is only used to cache information for more efficient
  * computation.
+ *
+ * Aside from the classifications in the bit field, this can also remember the
+ * area and the bounding box of the polygon, which are expensive to compute for
+ * big polygons. The bit field indicates whether those are known.
  */
 struct PolygonProperties {
 	/*!
@@ -144,18 +156,41 @@ struct PolygonProperties {
 	 * - The 2 least significant bits indicate the convexity.
 	 * - The next 2 least significant bits indicate self-intersection.
 	 * - The next 2 least significant bits indicate orientation.
+	 * - The next bit indicates whether the area is known.
+	 * - The next bit indicates whether the bounding box is known.
 	 * - The remaining bits of the int (however long that is) are unused.
 	 * This uses an integer as bits, since it is by definition the same type as
 	 * the enums that it is composed of, preventing the need for copies in order
-	 * to cast. This makes at least 16 bits available (of which currently only 6
+	 * to cast. This makes at least 16 bits available (of which currently only 8
 	 * are used).
 	 */
 	unsigned int bitfield;
 
+	/*!
+	 * The area of the polygon, if it is known.
+	 *
+	 * Only valid if \ref has_area is ``true``.
+	 */
+	area_t cached_area;
+
+	/*!
+	 * The minimum corner of the bounding box of the polygon, if it is known.
+	 *
+	 * Only valid if \ref has_bounding_box is ``true``.
+	 */
+	Point2 bounding_box_minimum;
+
+	/*!
+	 * The maximum corner of the bounding box of the polygon, if it is known.
+	 *
+	 * Only valid if \ref has_bounding_box is ``true``.
+	 */
+	Point2 bounding_box_maximum;
+
 	/*!
 	 * Initialises the bitfield with all unknown properties.
 	 */
-	PolygonProperties() : bitfield(0) {}
+	PolygonProperties() : bitfield(0), cached_area(0) {}
 
 	/*!
 	 * Initialises the bitfield with a specific set of properties.
@@ -165,7 +200,7 @@ struct PolygonProperties {
 	 * ``PolygonProperties(PolygonProperties::Convexity::CONVEX | PolygonProperties::Orientation::Positive``)
 	 * \param bitfield The bits to store in this properties object.
 	 */
-	PolygonProperties(const unsigned int bitfield) : bitfield(bitfield) {}
+	PolygonProperties(const unsigned int bitfield) : bitfield(bitfield), cached_area(0) {}
 
 	/*!
 	 * Whether this polygon is convex or concave.
@@ -217,6 +252,84 @@ struct PolygonProperties {
 		bitfield = (bitfield & (~0b110000)) + static_cast<int>(orientation); //Clear the orientation bits, then add the new orientation to them.
 	}
 
+	/*!
+	 * Whether the area of the polygon is known.
+	 * \return ``true`` if the area is known, or ``false`` if it still needs to
+	 * be computed.
+	 */
+	bool has_area() const {
+		return bitfield & area_bit;
+	}
+
+	/*!
+	 * The area of the polygon.
+	 *
+	 * This is only valid if the area is known, see \ref has_area.
+	 * \return The area of the polygon.
+	 */
+	area_t area() const {
+		return cached_area;
+	}
+
+	/*!
+	 * Store the area of the polygon.
+	 *
+	 * If the polygon is known not to intersect itself, the sign of the area
+	 * also tells its orientation, so that is stored as well.
+	 * \param area The area of the polygon.
+	 */
+	void set_area(const area_t area) {
+		cached_area = area;
+		bitfield |= area_bit;
+		if(self_intersecting() == SelfIntersecting::NO && area != 0) {
+			set_orientation(area > 0 ? Orientation::POSITIVE : Orientation::NEGATIVE);
+		}
+	}
+
+	/*!
+	 * Whether the bounding box of the polygon is known.
+	 * \return ``true`` if the bounding box is known, or ``false`` if it still
+	 * needs to be computed.
+	 */
+	bool has_bounding_box() const {
+		return bitfield & bounding_box_bit;
+	}
+
+	/*!
+	 * The axis-aligned bounding box of the polygon.
+	 *
+	 * This is only valid if the bounding box is known, see
+	 * \ref has_bounding_box.
+	 * \return The minimum and maximum corner of the bounding box, in that
+	 * order.
+	 */
+	std::pair<Point2, Point2> bounding_box() const {
+		return std::make_pair(bounding_box_minimum, bounding_box_maximum);
+	}
+
+	/*!
+	 * Store the axis-aligned bounding box of the polygon.
+	 * \param minimum The minimum corner of the bounding box.
+	 * \param maximum The maximum corner of the bounding box.
+	 */
+	void set_bounding_box(const Point2& minimum, const Point2& maximum) {
+		bounding_box_minimum = minimum;
+		bounding_box_maximum = maximum;
+		bitfield |= bounding_box_bit;
+	}
+
+	/*!
+	 * Update the properties after the polygon was moved.
+	 *
+	 * Moving a polygon doesn't change its shape, so all properties stay the
+	 * same, except the bounding box, which moves along.
+	 * \param delta The distance by which the polygon was moved.
+	 */
+	void translate(const Point2& delta) {
+		bounding_box_minimum += delta;
+		bounding_box_maximum += delta;
+	}
+
 	/*!
 	 * Makes all properties unknown again.
 	 *
@@ -227,6 +340,43 @@ struct PolygonProperties {
 	void reset() {
 		bitfield = 0;
 	}
+
+protected:
+	/*!
+	 * The bit in the bit field that indicates whether the area is known.
+	 */
+	static constexpr unsigned int area_bit = 64;
+
+	/*!
+	 * The bit in the bit field that indicates whether the bounding box is known.
+	 */
+	static constexpr unsigned int bounding_box_bit = 128;
+};
+
+/*!
+ * A concept for polygons that cache their properties.
+ *
+ * Operations look up what is already known about these polygons to skip work,
+ * and store what they found out for subsequent operations. The cache only holds
+ * information that can be derived from the vertices, so it can be updated
+ * through a constant reference too.
+ */
+template<typename T>
+concept caches_properties = requires(const T object, const PolygonProperties properties) {
+	{ object.get_properties() } -> std::convertible_to<PolygonProperties>;
+	object.set_properties(properties);
+};
+
+/*!
+ * A concept for batches of polygons that cache the properties of each polygon.
+ *
+ * This is the equivalent of \ref caches_properties for batches, where the
+ * properties of each polygon are looked up by its index in the batch.
+ */
+template<typename T>
+concept caches_batch_properties = requires(const T object, const size_t index, const PolygonProperties properties) {
+	{ object.get_properties(index) } -> std::convertible_to<PolygonProperties>;
+	object.set_properties(index, properties);
 };
 
 /*!
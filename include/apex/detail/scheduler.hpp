@@ -0,0 +1,362 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_SCHEDULER
+#define APEX_SCHEDULER
+
+#include <algorithm> //For std::upper_bound, std::min and std::max.
+#include <atomic> //To let threads take tasks from each other's queues.
+#include <omp.h> //To run the tasks on multiple threads.
+#include <vector> //To store the queues of each thread.
+
+#include "geometry_concepts.hpp" //To find the vertices of any batch of polygons.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * How the threads that process a batch are placed on the processors.
+ */
+enum class Affinity {
+	/*!
+	 * Leave the placement of the threads to the OpenMP runtime, which may be
+	 * configured with the ``OMP_PROC_BIND`` and ``OMP_PLACES`` environment
+	 * variables.
+	 */
+	unspecified,
+
+	/*!
+	 * Place the threads close together, on neighbouring cores.
+	 *
+	 * The threads then share caches, and stay on the same NUMA node if they
+	 * fit on it.
+	 */
+	close,
+
+	/*!
+	 * Spread the threads evenly over all processors.
+	 *
+	 * The threads then use the memory bandwidth and caches of all NUMA nodes.
+	 */
+	spread
+};
+
+/*!
+ * Where the polygons of a batch are in its vertex buffer, and where they would
+ * be if the vertices of all polygons were put in one list without gaps.
+ *
+ * The ``Scheduler`` divides the list without gaps into tasks. The operations
+ * then use the starts to find the vertices of each task in the buffer.
+ */
+struct VertexRanges {
+	/*!
+	 * Constructs the table for a batch of polygons.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The batch to find the polygons of.
+	 */
+	template<multi_polygonal PolygonBatch>
+	explicit VertexRanges(const PolygonBatch& batch) : starts(batch.size()), offsets(batch.size() + 1, 0) {
+		const auto* vertices = batch.data_subelements();
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			starts[polygon] = batch[polygon].empty() ? 0 : &batch[polygon][0] - vertices;
+			offsets[polygon + 1] = offsets[polygon] + batch[polygon].size();
+		}
+	}
+
+	/*!
+	 * Gets the number of vertices of a polygon.
+	 * \param polygon The index of the polygon.
+	 * \return The number of vertices of that polygon.
+	 */
+	size_t size(const size_t polygon) const {
+		return offsets[polygon + 1] - offsets[polygon];
+	}
+
+	/*!
+	 * For each polygon, the index of its first vertex in the vertex buffer of
+	 * the batch.
+	 */
+	std::vector<size_t> starts;
+
+	/*!
+	 * For each polygon, the index of its first vertex in the list without gaps,
+	 * with one extra element at the end for the total number of vertices.
+	 */
+	std::vector<size_t> offsets;
+};
+
+/*!
+ * Divides the vertices of a batch of polygons over multiple threads.
+ *
+ * Batches may mix polygons with a few vertices and polygons with hundreds of
+ * thousands of vertices. Dividing the polygons over the threads then leaves one
+ * thread to process the giant polygon while the others are idle. Instead, the
+ * scheduler treats the vertices of all polygons as one long list, and divides
+ * that list into tasks with an equal number of vertices. Small polygons are
+ * grouped together into one task, while large polygons are split over many
+ * tasks.
+ *
+ * Each thread gets a queue containing a contiguous part of the tasks, so that
+ * each thread reads its own part of the vertex buffer. When a thread finishes
+ * its own queue, it steals tasks from the queues of the other threads. That way
+ * the threads stay busy even if some tasks take longer than others.
+ *
+ * If a batch operation is performed from within a parallel region, all tasks
+ * are executed by the calling thread, to prevent nested parallel regions from
+ * starting more threads than there are cores.
+ *
+ * Like the ``Strategies``, this class is completely static. It is impossible to
+ * instantiate the class.
+ */
+class Scheduler {
+public:
+	/*!
+	 * The number of vertices in a task, unless configured otherwise.
+	 *
+	 * Enough vertices to make scheduling a task worth it, but small enough to
+	 * balance the load between threads.
+	 */
+	static constexpr size_t default_grain_size = 4096;
+
+	/*!
+	 * Visit every vertex of a batch of polygons, divided over multiple threads.
+	 *
+	 * The visitor is called with the index of a polygon and a range of its
+	 * vertices, as ``visit(polygon, begin, end)``. Together, all calls cover
+	 * every vertex of every polygon exactly once. Polygons without vertices are
+	 * never visited. If ``begin`` is 0 and ``end`` is the size of the polygon,
+	 * the call covers the whole polygon, and no other thread visits that
+	 * polygon. Otherwise, the polygon is split, and the other parts may be
+	 * visited at the same time by other threads. The visitor must then combine
+	 * its results with those of the other threads atomically.
+	 * \tparam Visitor A function to call for each range of vertices.
+	 * \param offsets Where each polygon would start if the vertices of all
+	 * polygons were put in one list without gaps, with one extra element at the
+	 * end for the total number of vertices.
+	 * \param visit The function to call for each range of vertices.
+	 */
+	template<typename Visitor>
+	static void for_each_range(const std::vector<size_t>& offsets, const Visitor& visit) {
+		const size_t total_vertices = offsets.back();
+		const size_t task_size = grain_size;
+		run_tasks((total_vertices + task_size - 1) / task_size, [&](const size_t task) {
+			run_task(offsets, task * task_size, std::min(task * task_size + task_size, total_vertices), visit);
+		});
+	}
+
+	/*!
+	 * Visit a range of indices, divided over multiple threads.
+	 *
+	 * This is for passes over the polygons of a batch that are cheap for every
+	 * polygon, such as finishing the results of the ranges visited by
+	 * \ref for_each_range. The indices are divided into blocks of the grain
+	 * size, which are executed with the same threads as the vertex ranges. The
+	 * visitor is called as ``visit(begin, end)`` for each block.
+	 * \tparam Visitor A function to call for each block of indices.
+	 * \param count The number of indices to visit.
+	 * \param visit The function to call for each block of indices.
+	 */
+	template<typename Visitor>
+	static void for_each_block(const size_t count, const Visitor& visit) {
+		const size_t task_size = grain_size;
+		run_tasks((count + task_size - 1) / task_size, [&](const size_t task) {
+			visit(task * task_size, std::min(task * task_size + task_size, count));
+		});
+	}
+
+	/*!
+	 * Get the number of threads used to process batches.
+	 * \return The number of threads, or 0 if the number of threads is chosen
+	 * by the OpenMP runtime.
+	 */
+	static size_t get_num_threads() {
+		return num_threads;
+	}
+
+	/*!
+	 * Set the number of threads used to process batches.
+	 * \param threads The number of threads to use, or 0 to let the OpenMP
+	 * runtime choose, as configured with the ``OMP_NUM_THREADS`` environment
+	 * variable.
+	 */
+	static void set_num_threads(const size_t threads) {
+		num_threads = threads;
+	}
+
+	/*!
+	 * Get how the threads that process batches are placed on the processors.
+	 * \return The affinity of the threads.
+	 */
+	static Affinity get_affinity() {
+		return affinity;
+	}
+
+	/*!
+	 * Set how the threads that process batches are placed on the processors.
+	 *
+	 * On computers with multiple NUMA nodes, spreading the threads makes use of
+	 * the memory bandwidth of all nodes, while placing them close together keeps
+	 * them near the memory they share.
+	 * \param new_affinity The affinity of the threads.
+	 */
+	static void set_affinity(const Affinity new_affinity) {
+		affinity = new_affinity;
+	}
+
+	/*!
+	 * Get the number of vertices in each task.
+	 * \return The number of vertices in each task.
+	 */
+	static size_t get_grain_size() {
+		return grain_size;
+	}
+
+	/*!
+	 * Set the number of vertices in each task.
+	 *
+	 * Smaller tasks balance the load better, but take more time to schedule.
+	 * Tasks have at least 1 vertex, so a grain size of 0 is changed to 1.
+	 * \param vertices The number of vertices in each task.
+	 */
+	static void set_grain_size(const size_t vertices) {
+		grain_size = std::max(size_t(1), vertices);
+	}
+
+	/*!
+	 * Restore the default number of threads, affinity and grain size.
+	 */
+	static void reset() {
+		num_threads = 0;
+		affinity = Affinity::unspecified;
+		grain_size = default_grain_size;
+	}
+
+	/*!
+	 * This object may not be instantiated.
+	 */
+	Scheduler() = delete;
+
+protected:
+	/*!
+	 * The tasks that a thread has yet to execute.
+	 *
+	 * Each queue is aligned to a cache line, so that threads taking tasks from
+	 * their own queue don't invalidate the cache of other threads.
+	 */
+	struct alignas(64) Queue {
+		/*!
+		 * The next task to execute. Both the owner of the queue and threads
+		 * stealing from it take tasks by incrementing this.
+		 */
+		std::atomic<size_t> next = 0;
+
+		/*!
+		 * The task past the last task in this queue.
+		 */
+		size_t end = 0;
+	};
+
+	/*!
+	 * Execute a number of tasks, divided over the configured number of
+	 * threads, with work stealing.
+	 * \tparam Task A function to call with the index of each task.
+	 * \param num_tasks The number of tasks to execute.
+	 * \param execute The function to call with the index of each task.
+	 */
+	template<typename Task>
+	static void run_tasks(const size_t num_tasks, const Task& execute) {
+		if(num_tasks == 0) {
+			return;
+		}
+		const size_t requested_threads = num_threads == 0 ? size_t(omp_get_max_threads()) : size_t(num_threads);
+		const size_t threads = omp_in_parallel() ? 1 : std::max(size_t(1), std::min(requested_threads, num_tasks)); //Don't start threads that would have no tasks of their own.
+		if(threads == 1) { //Don't start a parallel region just for the calling thread.
+			for(size_t task = 0; task < num_tasks; ++task) {
+				execute(task);
+			}
+			return;
+		}
+		std::vector<Queue> queues(threads);
+
+		const auto run = [&]() {
+			const size_t thread = omp_get_thread_num();
+			const size_t team_size = omp_get_num_threads(); //May be fewer threads than requested.
+			queues[thread].next = num_tasks * thread / team_size;
+			queues[thread].end = num_tasks * (thread + 1) / team_size;
+			#pragma omp barrier
+
+			//Start with the own queue, then steal from the queues of the next threads.
+			for(size_t victim = 0; victim < team_size; ++victim) {
+				Queue& queue = queues[(thread + victim) % team_size];
+				for(size_t task = queue.next++; task < queue.end; task = queue.next++) {
+					execute(task);
+				}
+			}
+		};
+		switch(affinity.load()) {
+			case Affinity::close: {
+				#pragma omp parallel num_threads(threads) proc_bind(close)
+				run();
+				break;
+			}
+			case Affinity::spread: {
+				#pragma omp parallel num_threads(threads) proc_bind(spread)
+				run();
+				break;
+			}
+			default: {
+				#pragma omp parallel num_threads(threads)
+				run();
+			}
+		}
+	}
+
+	/*!
+	 * Visit the ranges of the polygons overlapping with a task.
+	 * \tparam Visitor A function to call for each range of vertices.
+	 * \param offsets Where each polygon starts in the list of all vertices.
+	 * \param task_begin The first vertex of the task in the list of all
+	 * vertices.
+	 * \param task_end The vertex past the last vertex of the task.
+	 * \param visit The function to call for each range of vertices.
+	 */
+	template<typename Visitor>
+	static void run_task(const std::vector<size_t>& offsets, const size_t task_begin, const size_t task_end, const Visitor& visit) {
+		const size_t num_polygons = offsets.size() - 1;
+		size_t polygon = std::upper_bound(offsets.begin(), offsets.end(), task_begin) - offsets.begin() - 1; //The polygon containing the first vertex of this task.
+		for(; polygon < num_polygons && offsets[polygon] < task_end; ++polygon) {
+			const size_t begin = std::max(task_begin, offsets[polygon]) - offsets[polygon];
+			const size_t end = std::min(task_end, offsets[polygon + 1]) - offsets[polygon];
+			if(begin < end) { //Skip polygons without vertices.
+				visit(polygon, begin, end);
+			}
+		}
+	}
+
+	/*!
+	 * The number of threads to use, or 0 to let the OpenMP runtime choose.
+	 */
+	inline static std::atomic<size_t> num_threads = 0;
+
+	/*!
+	 * How the threads are placed on the processors.
+	 */
+	inline static std::atomic<Affinity> affinity = Affinity::unspecified;
+
+	/*!
+	 * The number of vertices in each task.
+	 */
+	inline static std::atomic<size_t> grain_size = default_grain_size;
+};
+
+}
+
+}
+
+#endif //APEX_SCHEDULER
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_SIMD_DISPATCH
+#define APEX_SIMD_DISPATCH
+
+/*
+Kernels that benefit from wide vector registers can be marked with
+APEX_SIMD_CLONES. The compiler then generates a version of the function for
+each of the listed instruction sets, and the best version that the processor
+supports is selected when the program is loaded. That way the library can use
+AVX-512 or AVX2 where available, while still running on processors that only
+support older instruction sets, without compiling the whole library for a
+specific processor.
+
+The kernels themselves are written as plain loops that the compiler can
+vectorise, with "omp simd" pragmas. This keeps them portable. On processors
+where the vector instructions are always available, such as NEON on 64-bit
+ARM, the loops are just vectorised for that instruction set directly.
+
+Define APEX_NO_SIMD_DISPATCH to disable generating multiple versions, for
+instance when compiling for a specific processor anyway.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(APEX_NO_SIMD_DISPATCH)
+	#define APEX_SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "sse4.1", "default")))
+#else
+	#define APEX_SIMD_CLONES
+#endif
+
+#endif //APEX_SIMD_DISPATCH
\ No newline at end of file
@@ -0,0 +1,567 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_STRATEGIES
+#define APEX_STRATEGIES
+
+#include <array> //To store the crossovers of all operations.
+#include <atomic> //To track how many operations are using the GPU, from multiple threads.
+#include <fstream> //To load and save calibration profiles.
+#include <limits> //To indicate that a version is never faster.
+#include <sstream> //To parse the lines of calibration profiles.
+#include <stdexcept> //To catch invalid numbers in calibration profiles, and to reject compiled profiles that list an operation twice.
+#include <string> //To identify operations in calibration profiles.
+#include <vector> //To fit crossovers to measurements.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * The operations that choose between multiple versions based on the size of
+ * their input.
+ *
+ * For each operation, the versions are numbered from the one with the lowest
+ * overhead to the one that scales best:
+ * - ``area``: ``area_st``, ``area_mt``, ``area_gpu``, by number of vertices.
+ * - ``area_batch``: ``area_st``, ``area_mt``, ``area_gpu``, by number of
+ *   polygons plus vertices.
+ * - ``area_fixed_batch``: ``area_st``, ``area_mt``, ``area_gpu``, by number of
+ *   vertices, for batches of polygons with a fixed number of vertices.
+ * - ``area_soa``, ``area_soa_batch``: As ``area`` and ``area_batch``, for
+ *   polygons that store their vertices as a structure of arrays.
+ * - ``bounding_box``: ``bounding_box_st``, ``bounding_box_mt``,
+ *   ``bounding_box_gpu``, by number of vertices.
+ * - ``bounding_box_batch``: ``bounding_box_st``, ``bounding_box_mt``,
+ *   ``bounding_box_gpu``, by number of polygons plus vertices.
+ * - ``bounding_box_fixed_batch``: ``bounding_box_st``, ``bounding_box_mt``,
+ *   ``bounding_box_gpu``, by number of vertices, for batches of polygons with a
+ *   fixed number of vertices.
+ * - ``bounding_box_soa``, ``bounding_box_soa_batch``: As ``bounding_box`` and
+ *   ``bounding_box_batch``, for polygons that store their vertices as a
+ *   structure of arrays.
+ * - ``clip``: ``clip_st``, ``clip_mt``, by number of edges of both shapes.
+ * - ``contains``: ``contains_st``, ``contains_mt``, ``contains_gpu``, by number
+ *   of vertices.
+ * - ``contains_batch``: ``contains_st``, ``contains_mt``, ``contains_gpu``, by
+ *   number of polygons plus vertices.
+ * - ``contains_fixed_batch``: ``contains_st``, ``contains_mt``,
+ *   ``contains_gpu``, by number of vertices, for batches of polygons with a
+ *   fixed number of vertices.
+ * - ``contains_points``: ``contains_st``, ``contains_mt``, ``contains_gpu``, by
+ *   number of vertices times number of points.
+ * - ``convexity``: ``turns_st``, ``turns_mt``, ``turns_gpu``, by number of
+ *   vertices. This is used by ``orientation`` as well.
+ * - ``convexity_batch``: ``turns_st``, ``turns_mt``, ``turns_gpu``, by number of
+ *   polygons plus vertices. This is used by ``orientation`` as well.
+ * - ``intersecting_pairs``: ``intersecting_pairs_st``,
+ *   ``intersecting_pairs_mt``, ``intersecting_pairs_gpu``, by number of
+ *   segments in one batch times number of segments in the other.
+ * - ``intersecting_pairs_batch``: ``intersecting_pairs_st``,
+ *   ``intersecting_pairs_mt``, ``intersecting_pairs_gpu``, by the sum of the
+ *   products of the sizes of the candidate pairs of polygons.
+ * - ``intersects_segments``: ``intersects_st``, ``intersects_mt``,
+ *   ``intersects_gpu``, by number of pairs of line segments.
+ * - ``offset``: ``offset_st``, ``offset_mt``, ``offset_gpu``, by number of
+ *   vertices.
+ * - ``offset_batch``: ``offset_st``, ``offset_mt``, ``offset_gpu``, by number
+ *   of polygons plus vertices.
+ * - ``r_tree_query_batch``: ``r_tree_query_st``, ``r_tree_query_mt``,
+ *   ``r_tree_query_gpu``, by number of windows to query.
+ * - ``self_intersections``: ``self_intersections_st_naive``,
+ *   ``self_intersections_st_sweep``, ``self_intersections_mt_grid``, by number
+ *   of vertices.
+ * - ``self_intersections_batch``: ``self_intersections_st``,
+ *   ``self_intersections_mt``, by number of polygons plus vertices.
+ * - ``transform``: ``transform_st``, ``transform_mt``, ``transform_gpu``, by
+ *   number of vertices.
+ * - ``transform_batch``: ``transform_st``, ``transform_mt``,
+ *   ``transform_gpu``, by number of vertices.
+ * - ``transform_soa``, ``transform_soa_batch``: As ``transform`` and
+ *   ``transform_batch``, for polygons that store their vertices as a structure
+ *   of arrays.
+ * - ``translate``: ``translate_st``, ``translate_mt``, ``translate_gpu``, by
+ *   number of vertices.
+ * - ``translate_batch``: ``translate_st``, ``translate_mt``,
+ *   ``translate_gpu``, by number of vertices.
+ * - ``translate_fixed_batch``: ``translate_st``, ``translate_mt``,
+ *   ``translate_gpu``, by number of vertices, for batches of polygons with a
+ *   fixed number of vertices.
+ * - ``translate_soa``, ``translate_soa_batch``: As ``translate`` and
+ *   ``translate_batch``, for polygons that store their vertices as a structure
+ *   of arrays.
+ */
+enum class Operation : size_t {
+	area,
+	area_batch,
+	area_fixed_batch,
+	area_soa,
+	area_soa_batch,
+	bounding_box,
+	bounding_box_batch,
+	bounding_box_fixed_batch,
+	bounding_box_soa,
+	bounding_box_soa_batch,
+	clip,
+	contains,
+	contains_batch,
+	contains_fixed_batch,
+	contains_points,
+	convexity,
+	convexity_batch,
+	intersecting_pairs,
+	intersecting_pairs_batch,
+	intersects_segments,
+	offset,
+	offset_batch,
+	r_tree_query_batch,
+	self_intersections,
+	self_intersections_batch,
+	transform,
+	transform_batch,
+	transform_soa,
+	transform_soa_batch,
+	translate,
+	translate_batch,
+	translate_fixed_batch,
+	translate_soa,
+	translate_soa_batch
+};
+
+/*!
+ * The number of operations in \ref Operation.
+ *
+ * This is derived from the last operation, so new operations must be added
+ * before it.
+ */
+constexpr size_t num_operations = static_cast<size_t>(Operation::translate_soa_batch) + 1;
+
+/*!
+ * The names of the operations, as used in calibration profiles.
+ */
+constexpr std::array<const char*, num_operations> operation_names = {
+	"area",
+	"area_batch",
+	"area_fixed_batch",
+	"area_soa",
+	"area_soa_batch",
+	"bounding_box",
+	"bounding_box_batch",
+	"bounding_box_fixed_batch",
+	"bounding_box_soa",
+	"bounding_box_soa_batch",
+	"clip",
+	"contains",
+	"contains_batch",
+	"contains_fixed_batch",
+	"contains_points",
+	"convexity",
+	"convexity_batch",
+	"intersecting_pairs",
+	"intersecting_pairs_batch",
+	"intersects_segments",
+	"offset",
+	"offset_batch",
+	"r_tree_query_batch",
+	"self_intersections",
+	"self_intersections_batch",
+	"transform",
+	"transform_batch",
+	"transform_soa",
+	"transform_soa_batch",
+	"translate",
+	"translate_batch",
+	"translate_fixed_batch",
+	"translate_soa",
+	"translate_soa_batch"
+};
+
+/*!
+ * The maximum number of versions that an operation may choose between.
+ */
+constexpr size_t max_versions = 4;
+
+/*!
+ * For an operation, the input sizes from which each version is faster than the
+ * previous version.
+ *
+ * The first element is the size from which version 1 is faster than version 0,
+ * and so on. The sizes must be ascending.
+ */
+typedef std::array<size_t, max_versions - 1> Crossovers;
+
+/*!
+ * Indicates that a version is never faster than the previous version.
+ */
+constexpr size_t no_crossover = std::numeric_limits<size_t>::max();
+
+/*!
+ * The crossovers of one operation, as listed in a calibration profile that is
+ * compiled into the library.
+ */
+struct CalibratedOperation {
+	/*!
+	 * The operation that these crossovers belong to.
+	 */
+	Operation operation;
+
+	/*!
+	 * The input sizes from which each version of the operation is faster than
+	 * the previous version.
+	 */
+	Crossovers crossovers;
+};
+
+/*!
+ * Arranges the crossovers of a compiled calibration profile in the order of
+ * \ref Operation.
+ *
+ * Each operation must be listed exactly once, but the order of the list doesn't
+ * matter. If an operation is listed twice, this throws, which makes the
+ * profile fail to compile since it is evaluated as a constant expression.
+ * \tparam num_entries The number of operations listed in the profile.
+ * \param entries The crossovers of each operation.
+ * \return The crossovers, indexed by the operation they belong to.
+ */
+template<size_t num_entries>
+constexpr std::array<Crossovers, num_operations> index_crossovers(const std::array<CalibratedOperation, num_entries>& entries) {
+	static_assert(num_entries == num_operations, "The calibration profile must list the crossovers of every operation.");
+	std::array<Crossovers, num_operations> result {};
+	std::array<bool, num_operations> listed {};
+	for(const CalibratedOperation& entry : entries) {
+		const size_t index = static_cast<size_t>(entry.operation);
+		if(listed[index]) {
+			throw std::invalid_argument("The calibration profile lists the crossovers of an operation twice.");
+		}
+		listed[index] = true;
+		result[index] = entry.crossovers;
+	}
+	return result;
+}
+
+}
+
+}
+
+//Load the measurements of the crossovers, either of a different computer or the default ones.
+#ifdef APEX_CALIBRATION_FILE
+#include APEX_CALIBRATION_FILE
+#else
+#include "calibration.hpp"
+#endif
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * Chooses which version of an operation is expected to be fastest.
+ *
+ * Each operation has a number of versions with different trade-offs. Versions
+ * with little overhead are faster for small inputs, while versions that scale
+ * well are faster for big inputs. Somewhere in between there is a size from
+ * which the next version is faster, the crossover. These crossovers depend on
+ * the hardware. They are measured by the calibration application in the
+ * benchmarking directory. Its measurements are compiled into the library, and
+ * can also be loaded from a profile at run-time. Choosing a version then takes
+ * only a few integer comparisons.
+ *
+ * The GPU may be busy with operations of other threads. It's then often faster
+ * to run on the CPU than to wait for the GPU, so if too many operations are
+ * already using the GPU, the best version on the CPU is chosen instead.
+ * Operations that run on the GPU must hold a \ref GPUReservation while they run,
+ * to let the other threads know. Without GPU support, the versions on the GPU
+ * are never chosen.
+ *
+ * Like the ``GPUDataTracker``, this class is completely static. It is
+ * impossible to instantiate the class.
+ */
+class Strategies {
+public:
+	/*!
+	 * Signals that an operation is running on the GPU, as long as this object
+	 * exists.
+	 */
+	class GPUReservation {
+	public:
+		/*!
+		 * Starts using the GPU.
+		 */
+		GPUReservation() {
+			gpu_users++;
+		}
+
+		/*!
+		 * Stops using the GPU.
+		 */
+		~GPUReservation() {
+			gpu_users--;
+		}
+
+		/*!
+		 * The reservation may not be copied, or the GPU would be freed twice.
+		 */
+		GPUReservation(const GPUReservation& original) = delete;
+
+		/*!
+		 * The reservation may not be assigned, or the GPU would be freed twice.
+		 */
+		GPUReservation& operator =(const GPUReservation& original) = delete;
+	};
+
+	/*!
+	 * Chooses the version of an operation that is expected to be fastest.
+	 * \param operation The operation to choose a version of.
+	 * \param size The size of the input of the operation. What this means
+	 * differs per operation. See \ref Operation.
+	 * \return The index of the version to use.
+	 */
+	static size_t choose(const Operation operation, const size_t size) {
+		const size_t index = static_cast<size_t>(operation);
+		const Crossovers& operation_crossovers = crossovers[index];
+		size_t version = (size >= operation_crossovers[0]) + (size >= operation_crossovers[1]) + (size >= operation_crossovers[2]);
+		if(version == gpu_versions[index]) {
+#ifdef GPU
+			if(gpu_users >= max_gpu_users) { //GPU is busy. Don't wait for it.
+				version = cpu_fallbacks[index];
+			}
+#else
+			version = cpu_fallbacks[index]; //Not compiled with GPU support.
+#endif //GPU
+		}
+		return version;
+	}
+
+	/*!
+	 * Get the sizes from which each version of an operation is faster than the
+	 * previous version.
+	 * \param operation The operation to get the crossovers of.
+	 * \return The crossovers of that operation.
+	 */
+	static Crossovers get_crossovers(const Operation operation) {
+		return crossovers[static_cast<size_t>(operation)];
+	}
+
+	/*!
+	 * Change the sizes from which each version of an operation is faster than
+	 * the previous version.
+	 *
+	 * This is not thread-safe. It must be called before other threads start
+	 * performing operations.
+	 * \param operation The operation to set the crossovers of.
+	 * \param new_crossovers The sizes from which each version of the operation
+	 * is faster than the previous version. They must be ascending.
+	 */
+	static void set_crossovers(const Operation operation, const Crossovers& new_crossovers) {
+		crossovers[static_cast<size_t>(operation)] = new_crossovers;
+	}
+
+	/*!
+	 * Restore the crossovers that were compiled into the library.
+	 *
+	 * This is not thread-safe. It must be called before other threads start
+	 * performing operations.
+	 */
+	static void reset() {
+		crossovers = calibrated_crossovers;
+	}
+
+	/*!
+	 * Set how many operations may use the GPU at the same time, before other
+	 * operations fall back to the CPU.
+	 * \param users The maximum number of operations to run on the GPU at the
+	 * same time.
+	 */
+	static void set_max_gpu_users(const size_t users) {
+		max_gpu_users = users;
+	}
+
+	/*!
+	 * Load the crossovers from a calibration profile.
+	 *
+	 * A calibration profile is a text file with a line for each operation. Each
+	 * line contains the name of the operation, followed by the crossovers of
+	 * that operation, separated by spaces. A crossover of ``none`` indicates
+	 * that a version is never faster than the previous one. Lines starting with
+	 * ``#`` are comments. Operations that are not in the profile keep their
+	 * current crossovers.
+	 *
+	 * If the profile can't be read or contains errors, none of the crossovers
+	 * are changed.
+	 *
+	 * This is not thread-safe. It must be called before other threads start
+	 * performing operations.
+	 * \param filename The path to the profile to load.
+	 * \return ``true`` if the profile was loaded, or ``false`` if it couldn't
+	 * be read.
+	 */
+	static bool load_profile(const std::string& filename) {
+		std::ifstream file(filename);
+		if(!file.is_open()) {
+			return false;
+		}
+		std::array<Crossovers, num_operations> loaded = crossovers;
+		std::string line;
+		while(std::getline(file, line)) {
+			if(line.empty() || line[0] == '#') {
+				continue;
+			}
+			std::istringstream fields(line);
+			std::string name;
+			fields >> name;
+			size_t operation = 0;
+			while(operation < num_operations && name != operation_names[operation]) {
+				operation++;
+			}
+			if(operation == num_operations) { //Unknown operation. Perhaps from a different version of the library.
+				continue;
+			}
+			for(size_t crossover = 0; crossover < max_versions - 1; ++crossover) {
+				std::string value;
+				if(!(fields >> value)) {
+					return false;
+				}
+				if(value == "none") {
+					loaded[operation][crossover] = no_crossover;
+					continue;
+				}
+				size_t parsed_length = 0;
+				try {
+					loaded[operation][crossover] = std::stoull(value, &parsed_length);
+				} catch(const std::logic_error&) { //Not a number, or out of range.
+					return false;
+				}
+				if(parsed_length != value.size()) {
+					return false;
+				}
+			}
+			for(size_t crossover = 1; crossover < max_versions - 1; ++crossover) {
+				if(loaded[operation][crossover] < loaded[operation][crossover - 1]) { //Must be ascending.
+					return false;
+				}
+			}
+		}
+		crossovers = loaded;
+		return true;
+	}
+
+	/*!
+	 * Save the current crossovers to a calibration profile.
+	 *
+	 * The profile can be loaded again with \ref load_profile.
+	 * \param filename The path to save the profile to.
+	 * \return ``true`` if the profile was saved, or ``false`` if it couldn't be
+	 * written.
+	 */
+	static bool save_profile(const std::string& filename) {
+		std::ofstream file(filename);
+		if(!file.is_open()) {
+			return false;
+		}
+		file << "#Apex calibration profile. For each operation, the sizes from which each version is faster than the previous one.\n";
+		for(size_t operation = 0; operation < num_operations; ++operation) {
+			file << operation_names[operation];
+			for(const size_t crossover : crossovers[operation]) {
+				file << ' ';
+				if(crossover == no_crossover) {
+					file << "none";
+				} else {
+					file << crossover;
+				}
+			}
+			file << '\n';
+		}
+		return file.good();
+	}
+
+	/*!
+	 * Find the crossovers of an operation from measurements of the duration of
+	 * each version.
+	 *
+	 * For each size, the fastest version is found. The crossover of a version is
+	 * the smallest size from which a later version is always faster. That way,
+	 * a single measurement where a version happens to be slightly faster
+	 * doesn't cause it to be chosen for all sizes between.
+	 * \param sizes The input sizes that were measured, in ascending order.
+	 * \param durations For each version, the duration of the operation for
+	 * each of the sizes. Versions that could not be measured, for instance
+	 * because there is no GPU, may be left empty. They are then never chosen.
+	 * \return The crossovers that fit the measurements.
+	 */
+	static Crossovers fit_crossovers(const std::vector<size_t>& sizes, const std::vector<std::vector<double>>& durations) {
+		std::vector<size_t> fastest(sizes.size(), 0);
+		for(size_t size = 0; size < sizes.size(); ++size) {
+			double fastest_duration = std::numeric_limits<double>::infinity();
+			for(size_t version = 0; version < durations.size() && version < max_versions; ++version) {
+				if(durations[version].size() > size && durations[version][size] < fastest_duration) {
+					fastest[size] = version;
+					fastest_duration = durations[version][size];
+				}
+			}
+		}
+
+		Crossovers result;
+		result.fill(no_crossover);
+		for(size_t crossover = 0; crossover < max_versions - 1; ++crossover) {
+			//Walk back from the biggest size, as long as the fastest version is later than this crossover.
+			size_t first = sizes.size();
+			while(first > 0 && fastest[first - 1] > crossover) {
+				first--;
+			}
+			if(first < sizes.size()) {
+				result[crossover] = sizes[first];
+			}
+		}
+		return result;
+	}
+
+	/*!
+	 * This object may not be instantiated.
+	 */
+	Strategies() = delete;
+
+protected:
+	/*!
+	 * For each operation, the sizes from which each version is faster than the
+	 * previous version.
+	 */
+	inline static std::array<Crossovers, num_operations> crossovers = calibrated_crossovers;
+
+	/*!
+	 * For each operation, the index of the version that runs on the GPU.
+	 *
+	 * The versions of ``self_intersections`` on the GPU are not chosen
+	 * automatically. They collect their results from within the target
+	 * region, which only works if the region runs on the host. ``clip`` has no
+	 * version on the GPU.
+	 */
+	static constexpr std::array<size_t, num_operations> gpu_versions = {2, 2, 2, 2, 2, 2, 2, 2, 2, 2, max_versions, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, max_versions, max_versions, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+
+	/*!
+	 * For each operation, the index of the version to use instead of the GPU
+	 * version, if the GPU is not available.
+	 */
+	static constexpr std::array<size_t, num_operations> cpu_fallbacks = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+
+	/*!
+	 * The number of operations currently running on the GPU.
+	 */
+	inline static std::atomic<size_t> gpu_users = 0;
+
+	/*!
+	 * How many operations may run on the GPU at the same time, before other
+	 * operations fall back to the CPU.
+	 */
+	inline static std::atomic<size_t> max_gpu_users = 1;
+};
+
+}
+
+}
+
+#endif //APEX_STRATEGIES
\ No newline at end of file
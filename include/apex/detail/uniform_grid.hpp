@@ -0,0 +1,240 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_UNIFORM_GRID
+#define APEX_UNIFORM_GRID
+
+#include <algorithm> //For std::min and std::max.
+#include <cmath> //To choose the resolution of the grid.
+#include <span> //To return the contents of a cell without copying.
+#include <utility> //To store bounding boxes as pairs of corners.
+#include <vector> //To store the contents of the cells.
+
+#include "../coordinate.hpp" //To compute cell coordinates without overflowing.
+#include "../point2.hpp" //To store the bounding boxes of the items.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * A broad phase to find pairs of items whose bounding boxes overlap.
+ *
+ * The space covered by the items is divided into a grid of equally-sized cells.
+ * Each item is binned into every cell that its bounding box overlaps with. Only
+ * items that share a cell can have overlapping bounding boxes. If the items are
+ * small relative to the total space and distributed somewhat evenly, every cell
+ * contains only a few items. Finding the candidate pairs then takes roughly
+ * linear time, rather than the quadratic time needed to compare every pair.
+ *
+ * The cells are stored in a compressed format, with the items of all cells in
+ * one flat array, and an array indicating where each cell starts. This way the
+ * grid only needs a few allocations. By choosing the number of cells based on
+ * the number of items, the total memory stays linear too, unless the items are
+ * much larger than the cells.
+ *
+ * The cells are independent of each other, which makes it easy to process them
+ * in parallel. Pairs of items that share multiple cells are only reported by
+ * one of those cells, so that processing all cells reports each pair once.
+ *
+ * Items are identified by their index in the list of bounding boxes that the
+ * grid was constructed with.
+ */
+class UniformGrid {
+public:
+	/*!
+	 * Constructs a grid containing items with the given bounding boxes.
+	 *
+	 * The number of cells is chosen to be approximately equal to the number of
+	 * items. The grid is stretched to fit around all items.
+	 * \param boxes For each item, the minimum and maximum corner of its bounding
+	 * box, in that order.
+	 */
+	UniformGrid(const std::vector<std::pair<Point2, Point2>>& boxes) : boxes(boxes) {
+		if(boxes.empty()) {
+			columns = 1;
+			rows = 1;
+			cell_starts.assign(2, 0);
+			return;
+		}
+		minimum = boxes[0].first;
+		Point2 maximum = boxes[0].second;
+		for(const std::pair<Point2, Point2>& box : boxes) {
+			minimum.x = std::min(minimum.x, box.first.x);
+			minimum.y = std::min(minimum.y, box.first.y);
+			maximum.x = std::max(maximum.x, box.second.x);
+			maximum.y = std::max(maximum.y, box.second.y);
+		}
+		width = area_t(maximum.x) - minimum.x + 1;
+		height = area_t(maximum.y) - minimum.y + 1;
+		const size_t resolution = std::ceil(std::sqrt(boxes.size()));
+		columns = std::max(size_t(1), std::min(resolution, size_t(width)));
+		rows = std::max(size_t(1), std::min(resolution, size_t(height)));
+
+		//First count how many items go into each cell, then store the items in a flat array with that layout.
+		cell_starts.assign(columns * rows + 1, 0);
+		for(const std::pair<Point2, Point2>& box : boxes) {
+			const size_t min_column = column(box.first.x);
+			const size_t max_column = column(box.second.x);
+			const size_t max_row = row(box.second.y);
+			for(size_t box_row = row(box.first.y); box_row <= max_row; ++box_row) {
+				for(size_t box_column = min_column; box_column <= max_column; ++box_column) {
+					cell_starts[box_row * columns + box_column + 1]++;
+				}
+			}
+		}
+		for(size_t cell = 1; cell < cell_starts.size(); ++cell) {
+			cell_starts[cell] += cell_starts[cell - 1];
+		}
+		cell_items.resize(cell_starts.back());
+		std::vector<size_t> cell_fill(cell_starts.begin(), cell_starts.end() - 1); //Where to put the next item in each cell.
+		for(size_t item = 0; item < boxes.size(); ++item) {
+			const size_t min_column = column(boxes[item].first.x);
+			const size_t max_column = column(boxes[item].second.x);
+			const size_t max_row = row(boxes[item].second.y);
+			for(size_t box_row = row(boxes[item].first.y); box_row <= max_row; ++box_row) {
+				for(size_t box_column = min_column; box_column <= max_column; ++box_column) {
+					cell_items[cell_fill[box_row * columns + box_column]++] = item;
+				}
+			}
+		}
+	}
+
+	/*!
+	 * Get the total number of cells in the grid.
+	 * \return The number of cells in the grid.
+	 */
+	size_t num_cells() const {
+		return columns * rows;
+	}
+
+	/*!
+	 * Get the items that overlap with a certain cell.
+	 *
+	 * The items in each cell are sorted by their index.
+	 * \param index The index of the cell to get the items of.
+	 * \return The indices of the items whose bounding boxes overlap with the
+	 * cell.
+	 */
+	std::span<const size_t> cell(const size_t index) const {
+		return std::span<const size_t>(cell_items.data() + cell_starts[index], cell_starts[index + 1] - cell_starts[index]);
+	}
+
+	/*!
+	 * Get the index of the cell that contains a certain position.
+	 *
+	 * Positions outside of the grid are clamped to the nearest cell.
+	 * \param position The position to find the cell of.
+	 * \return The index of the cell containing that position.
+	 */
+	size_t cell_at(const Point2& position) const {
+		return row(position.y) * columns + column(position.x);
+	}
+
+	/*!
+	 * Find the pairs of items in a cell whose bounding boxes overlap.
+	 *
+	 * If the bounding boxes of two items overlap in multiple cells, the pair is
+	 * only reported by the cell that contains the minimum corner of the
+	 * overlapping region. That way, each pair is reported exactly once when
+	 * processing all cells.
+	 * \tparam Callback A function taking two item indices.
+	 * \param index The index of the cell to find the overlapping pairs in.
+	 * \param callback The function to call for each pair of items with
+	 * overlapping bounding boxes. It is given the indices of the two items,
+	 * with the lowest index first.
+	 */
+	template<typename Callback>
+	void candidates(const size_t index, Callback callback) const {
+		const std::span<const size_t> items = cell(index);
+		for(size_t first = 0; first < items.size(); ++first) {
+			const std::pair<Point2, Point2>& box_first = boxes[items[first]];
+			for(size_t second = first + 1; second < items.size(); ++second) {
+				const std::pair<Point2, Point2>& box_second = boxes[items[second]];
+				if(box_first.first.x > box_second.second.x || box_second.first.x > box_first.second.x || box_first.first.y > box_second.second.y || box_second.first.y > box_first.second.y) {
+					continue; //Bounding boxes don't overlap.
+				}
+				const Point2 overlap_minimum(std::max(box_first.first.x, box_second.first.x), std::max(box_first.first.y, box_second.first.y));
+				if(cell_at(overlap_minimum) != index) {
+					continue; //Another cell will report this pair.
+				}
+				callback(items[first], items[second]);
+			}
+		}
+	}
+
+protected:
+	/*!
+	 * The bounding boxes of all items in the grid.
+	 */
+	std::vector<std::pair<Point2, Point2>> boxes;
+
+	/*!
+	 * The minimum corner of the space covered by the grid.
+	 */
+	Point2 minimum;
+
+	/*!
+	 * The width of the space covered by the grid.
+	 */
+	area_t width = 1;
+
+	/*!
+	 * The height of the space covered by the grid.
+	 */
+	area_t height = 1;
+
+	/*!
+	 * The number of cells in the X direction.
+	 */
+	size_t columns;
+
+	/*!
+	 * The number of cells in the Y direction.
+	 */
+	size_t rows;
+
+	/*!
+	 * For each cell, where its items start in \ref cell_items.
+	 *
+	 * This contains one extra element at the end, indicating the end of the last
+	 * cell.
+	 */
+	std::vector<size_t> cell_starts;
+
+	/*!
+	 * The items of all cells, stored cell after cell.
+	 */
+	std::vector<size_t> cell_items;
+
+	/*!
+	 * Get the column that contains a certain X coordinate.
+	 * \param x The X coordinate to find the column of.
+	 * \return The column of cells containing that X coordinate.
+	 */
+	size_t column(const coord_t x) const {
+		const area_t offset = std::clamp(area_t(x) - minimum.x, area_t(0), width - 1);
+		return offset * columns / width;
+	}
+
+	/*!
+	 * Get the row that contains a certain Y coordinate.
+	 * \param y The Y coordinate to find the row of.
+	 * \return The row of cells containing that Y coordinate.
+	 */
+	size_t row(const coord_t y) const {
+		const area_t offset = std::clamp(area_t(y) - minimum.y, area_t(0), height - 1);
+		return offset * rows / height;
+	}
+};
+
+}
+
+}
+
+#endif //APEX_UNIFORM_GRID
\ No newline at end of file
@@ -0,0 +1,548 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_FIXED_POLYGON
+#define APEX_FIXED_POLYGON
+
+#include <algorithm> //For std::min.
+#include <array> //To store the vertices.
+#include <initializer_list> //To construct polygons from a list of vertices.
+
+#include "batch.hpp" //To store the vertices of batches.
+#include "detail/geometry_concepts.hpp" //To convert from any type of polygon.
+#include "operations/area.hpp" //To allow calculating the area of this shape.
+#include "operations/bounding_box.hpp" //To allow calculating the bounding box of this shape.
+#include "operations/contains.hpp" //To allow testing whether points are inside of this shape.
+#include "operations/translate.hpp" //To allow moving this shape.
+#include "point2.hpp" //The vertices of the polygon are 2D points.
+#include "polygon.hpp" //To convert to normal polygons.
+
+namespace apex {
+
+/*!
+ * A polygon with a number of vertices that is fixed at compile time, such as a
+ * triangle or a quad.
+ *
+ * The vertices are stored in place, without allocating any memory. Since the
+ * number of vertices is known at compile time, operations on these polygons
+ * are completely unrolled. They don't need to loop over the vertices or compute
+ * the index of the previous vertex with a modulo operation at run-time. These
+ * polygons are intended for small numbers of vertices. For bigger polygons, the
+ * unrolled code becomes too big to be efficient.
+ *
+ * The number of vertices can't change. When converting from polygons with a
+ * different number of vertices, excess vertices are dropped, or the last vertex
+ * is repeated to fill up the polygon. Repeating a vertex doesn't change the
+ * shape of the polygon.
+ * \tparam N The number of vertices of the polygon.
+ */
+template<size_t N>
+class FixedPolygon {
+public:
+	/*!
+	 * The number of vertices of this type of polygon.
+	 */
+	static constexpr size_t fixed_size = N;
+
+	/*!
+	 * Constructs a polygon with all of its vertices at the origin.
+	 *
+	 * The polygon will be degenerate, until its vertices are moved.
+	 */
+	FixedPolygon() noexcept : vertices() {}
+
+	/*!
+	 * Constructs a polygon, filled with the vertices from this initialiser
+	 * list.
+	 *
+	 * If the list has a different number of vertices than the polygon, excess
+	 * vertices are dropped, or the last vertex is repeated.
+	 * \param vertices The vertices of the polygon.
+	 */
+	FixedPolygon(const std::initializer_list<Point2>& vertices) noexcept {
+		fill(vertices.begin(), vertices.size());
+	}
+
+	/*!
+	 * Converts any other type of polygon into a polygon with a fixed number of
+	 * vertices.
+	 *
+	 * If the original polygon has a different number of vertices, excess
+	 * vertices are dropped, or the last vertex is repeated.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to convert.
+	 */
+	template<polygonal Polygon>
+	explicit FixedPolygon(const Polygon& polygon) {
+		const size_t size = polygon.size();
+		for(size_t vertex = 0; vertex < N; ++vertex) {
+			vertices[vertex] = size == 0 ? Point2(0, 0) : Point2(polygon[std::min(vertex, size - 1)]);
+		}
+	}
+
+	/*!
+	 * Tests whether this polygon has the same vertices as another, in the same
+	 * order.
+	 *
+	 * Unlike normal polygons, this doesn't try to match polygons that start at
+	 * a different vertex.
+	 * \param other The polygon to compare to.
+	 * \return ``true`` if the polygons have the same vertices in the same
+	 * order, or ``false`` otherwise.
+	 */
+	bool operator ==(const FixedPolygon<N>& other) const {
+		return vertices == other.vertices;
+	}
+
+	/*!
+	 * Gives a reference to a vertex of the polygon.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at that index.
+	 */
+	const Point2& operator [](const size_t index) const {
+		return vertices[index];
+	}
+
+	/*!
+	 * Gives a reference to a vertex of the polygon.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at that index.
+	 */
+	Point2& operator [](const size_t index) {
+		return vertices[index];
+	}
+
+	/*!
+	 * Computes the surface area of the polygon.
+	 *
+	 * The sign of the area is linked to the polygon winding order. If the
+	 * polygon is positive, the area will be positive too, and vice versa. If
+	 * the polygon intersects itself, parts of the polygon will be subtracting
+	 * from the area while other parts add up to the area.
+	 * \return The surface area of the polygon.
+	 */
+	area_t area() const {
+		return apex::area(*this);
+	}
+
+	/*!
+	 * Gives an iterator to the first vertex of the polygon.
+	 * \return An iterator to the first vertex.
+	 */
+	typename std::array<Point2, N>::const_iterator begin() const {
+		return vertices.begin();
+	}
+
+	/*!
+	 * Gives an iterator to the first vertex of the polygon.
+	 * \return An iterator to the first vertex.
+	 */
+	typename std::array<Point2, N>::iterator begin() {
+		return vertices.begin();
+	}
+
+	/*!
+	 * Computes the axis-aligned bounding box of the polygon.
+	 *
+	 * For a polygon without vertices, the bounding box is empty, with both
+	 * corners at the origin.
+	 * \return The minimum and maximum corner of the bounding box, in that
+	 * order.
+	 */
+	std::pair<Point2, Point2> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Tests whether a point is inside of this polygon.
+	 *
+	 * This uses the nonzero fill rule. Points exactly on the border of the
+	 * polygon are considered to be inside.
+	 * \param point The point to test.
+	 * \return ``true`` if the point is inside of the polygon or on its border,
+	 * or ``false`` if it is outside.
+	 */
+	bool contains(const Point2& point) const {
+		return apex::contains(*this, point);
+	}
+
+	/*!
+	 * Gets a pointer to the vertices of the polygon.
+	 * \return A pointer to an array with the vertices of the polygon.
+	 */
+	Point2* data() noexcept {
+		return vertices.data();
+	}
+
+	/*!
+	 * Gets a pointer to the vertices of the polygon.
+	 * \return A pointer to an array with the vertices of the polygon.
+	 */
+	const Point2* data() const noexcept {
+		return vertices.data();
+	}
+
+	/*!
+	 * Checks whether the polygon has any vertices.
+	 *
+	 * This is only the case for polygons with 0 vertices, regardless of where
+	 * the vertices are.
+	 * \return ``true`` if the polygon has no vertices, or ``false`` if it has.
+	 */
+	static constexpr bool empty() noexcept {
+		return N == 0;
+	}
+
+	/*!
+	 * Gives an iterator past the last vertex of the polygon.
+	 * \return An iterator past the last vertex.
+	 */
+	typename std::array<Point2, N>::const_iterator end() const {
+		return vertices.end();
+	}
+
+	/*!
+	 * Gives an iterator past the last vertex of the polygon.
+	 * \return An iterator past the last vertex.
+	 */
+	typename std::array<Point2, N>::iterator end() {
+		return vertices.end();
+	}
+
+	/*!
+	 * Gets the number of vertices in the polygon.
+	 * \return The number of vertices in the polygon.
+	 */
+	static constexpr size_t size() noexcept {
+		return N;
+	}
+
+	/*!
+	 * Converts this polygon to a normal polygon, which can change its number of
+	 * vertices.
+	 * \return A polygon with the same vertices.
+	 */
+	Polygon to_polygon() const {
+		return Polygon(vertices.begin(), vertices.end());
+	}
+
+	/*!
+	 * Moves the polygon with a certain offset.
+	 *
+	 * The polygon is moved in-place.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 */
+	void translate(const Point2& delta) {
+		apex::translate(*this, delta);
+	}
+
+protected:
+	/*!
+	 * The vertices of the polygon.
+	 */
+	std::array<Point2, N> vertices;
+
+	/*!
+	 * Copies vertices into the polygon, dropping excess vertices or repeating
+	 * the last vertex if the number of vertices doesn't match.
+	 * \param source The vertices to copy.
+	 * \param size The number of vertices to copy.
+	 */
+	void fill(const Point2* source, const size_t size) noexcept {
+		for(size_t vertex = 0; vertex < N; ++vertex) {
+			vertices[vertex] = size == 0 ? Point2(0, 0) : source[std::min(vertex, size - 1)];
+		}
+	}
+};
+
+/*!
+ * A read-only view on one polygon in a batch of polygons with a fixed number of
+ * vertices.
+ *
+ * The view refers to the vertex array of the batch, so it becomes invalid when
+ * the batch is modified or destroyed.
+ * \tparam N The number of vertices of the polygon.
+ */
+template<size_t N>
+class FixedPolygonView {
+public:
+	/*!
+	 * The number of vertices of this type of polygon.
+	 */
+	static constexpr size_t fixed_size = N;
+
+	/*!
+	 * Creates a view on a range of the vertex array of a batch.
+	 * \param vertices The first vertex of the polygon. The other vertices must
+	 * follow contiguously.
+	 */
+	explicit FixedPolygonView(const Point2* vertices) noexcept : vertices(vertices) {}
+
+	/*!
+	 * Gives a reference to a vertex of the polygon.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at that index.
+	 */
+	const Point2& operator [](const size_t index) const {
+		return vertices[index];
+	}
+
+	/*!
+	 * Gives an iterator to the first vertex of the polygon.
+	 * \return An iterator to the first vertex.
+	 */
+	const Point2* begin() const noexcept {
+		return vertices;
+	}
+
+	/*!
+	 * Gets a pointer to the vertices of the polygon.
+	 * \return A pointer to an array with the vertices of the polygon.
+	 */
+	const Point2* data() const noexcept {
+		return vertices;
+	}
+
+	/*!
+	 * Checks whether the polygon has any vertices.
+	 * \return ``true`` if the polygon has no vertices, or ``false`` if it has.
+	 */
+	static constexpr bool empty() noexcept {
+		return N == 0;
+	}
+
+	/*!
+	 * Gives an iterator past the last vertex of the polygon.
+	 * \return An iterator past the last vertex.
+	 */
+	const Point2* end() const noexcept {
+		return vertices + N;
+	}
+
+	/*!
+	 * Gets the number of vertices in the polygon.
+	 * \return The number of vertices in the polygon.
+	 */
+	static constexpr size_t size() noexcept {
+		return N;
+	}
+
+protected:
+	/*!
+	 * The vertices of the polygon.
+	 */
+	const Point2* vertices;
+};
+
+/*!
+ * A batch of polygons that all have the same number of vertices, fixed at
+ * compile time.
+ *
+ * The vertices of all polygons are stored consecutively in one array, with a
+ * stride of ``N`` vertices per polygon. Polygon ``i`` starts at vertex
+ * ``i * N``, so unlike other batches of polygons there is no table to find
+ * where each polygon starts. Operations on these batches process multiple
+ * polygons at once with SIMD instructions, each lane of the vector registers
+ * computing a different polygon, while the loop over the vertices of each
+ * polygon is unrolled at compile time.
+ *
+ * Polygons can only be added at the end. The vertices of the polygons can be
+ * read through views, or modified directly through \ref data.
+ * \tparam N The number of vertices of each polygon.
+ */
+template<size_t N>
+class Batch<FixedPolygon<N>> {
+public:
+	/*!
+	 * The number of vertices of each polygon in this batch.
+	 */
+	static constexpr size_t fixed_size = N;
+
+	/*!
+	 * Creates an empty batch.
+	 */
+	Batch() {}
+
+	/*!
+	 * Converts any other batch of polygons into a batch of polygons with a fixed
+	 * number of vertices.
+	 *
+	 * Polygons with a different number of vertices get their excess vertices
+	 * dropped, or their last vertex repeated.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The batch of polygons to convert.
+	 */
+	template<multi_polygonal PolygonBatch>
+	explicit Batch(const PolygonBatch& batch) {
+		reserve(batch.size());
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			push_back(batch[polygon]);
+		}
+	}
+
+	/*!
+	 * Gets a view on one of the polygons in the batch.
+	 * \param index The index of the polygon to get.
+	 * \return A view on the polygon at that index.
+	 */
+	FixedPolygonView<N> operator [](const size_t index) const {
+		return FixedPolygonView<N>(vertices.data() + index * N);
+	}
+
+	/*!
+	 * Computes the surface area of the polygons in this batch.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the areas of each polygon in the same order.
+	 */
+	Batch<area_t> area() const {
+		return apex::area(*this);
+	}
+
+	/*!
+	 * Computes the axis-aligned bounding boxes of the polygons in this batch.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the minimum and maximum corner of the bounding box of each
+	 * polygon in the same order.
+	 */
+	Batch<std::pair<Point2, Point2>> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Removes all polygons from the batch.
+	 */
+	void clear() noexcept {
+		vertices.clear();
+	}
+
+	/*!
+	 * Tests for each polygon in this batch whether the corresponding point is
+	 * inside of it.
+	 * \param points For each polygon, a point to test. This must have the same
+	 * size as the batch.
+	 * \return For each polygon, whether the corresponding point is inside of it
+	 * or on its border.
+	 */
+	Batch<bool> contains(const Batch<Point2>& points) const {
+		return apex::contains(*this, points);
+	}
+
+	/*!
+	 * Gets a pointer to the vertices of all polygons.
+	 *
+	 * The vertices of polygon ``i`` start at index ``i * N``.
+	 * \return A pointer to an array with the vertices of all polygons.
+	 */
+	Point2* data() noexcept {
+		return vertices.data();
+	}
+
+	/*!
+	 * Gets a pointer to the vertices of all polygons.
+	 *
+	 * The vertices of polygon ``i`` start at index ``i * N``.
+	 * \return A pointer to an array with the vertices of all polygons.
+	 */
+	const Point2* data() const noexcept {
+		return vertices.data();
+	}
+
+	/*!
+	 * Checks whether the batch has any polygons.
+	 * \return ``true`` if the batch has no polygons, or ``false`` if it has.
+	 */
+	bool empty() const noexcept {
+		return size() == 0;
+	}
+
+	/*!
+	 * Adds a polygon at the end of the batch.
+	 *
+	 * If the polygon has a different number of vertices, its excess vertices
+	 * are dropped, or its last vertex is repeated.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to add.
+	 */
+	template<polygonal Polygon>
+	void push_back(const Polygon& polygon) {
+		const size_t size = polygon.size();
+		for(size_t vertex = 0; vertex < N; ++vertex) {
+			vertices.push_back(size == 0 ? Point2(0, 0) : Point2(polygon[std::min(vertex, size - 1)]));
+		}
+	}
+
+	/*!
+	 * Reserves memory for a number of polygons.
+	 * \param num_polygons The number of polygons to reserve memory for.
+	 */
+	void reserve(const size_t num_polygons) {
+		vertices.reserve(num_polygons * N);
+	}
+
+	/*!
+	 * Gets the number of polygons in the batch.
+	 * \return The number of polygons in the batch.
+	 */
+	size_t size() const noexcept {
+		if constexpr(N == 0) {
+			return 0; //Polygons without vertices take no space, so they can't be counted.
+		} else {
+			return vertices.size() / N;
+		}
+	}
+
+	/*!
+	 * Gets the total number of vertices of all polygons in the batch.
+	 *
+	 * This is the length of the vertex array.
+	 * \return The total number of vertices in the batch.
+	 */
+	size_t size_subelements() const noexcept {
+		return vertices.size();
+	}
+
+	/*!
+	 * Converts this batch to a normal batch of polygons, which can change their
+	 * number of vertices.
+	 * \return A batch of polygons with the same vertices.
+	 */
+	Batch<Polygon> to_polygons() const {
+		Batch<Polygon> result;
+		result.reserve(size());
+		result.reserve_subelements(size_subelements());
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			result.emplace_back();
+			for(size_t vertex = 0; vertex < N; ++vertex) {
+				result.back().push_back(vertices[polygon * N + vertex]);
+			}
+		}
+		return result;
+	}
+
+	/*!
+	 * Moves all polygons in this batch with the same offset.
+	 *
+	 * The polygons are moved in-place.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 */
+	void translate(const Point2& delta) {
+		apex::translate(*this, delta);
+	}
+
+protected:
+	/*!
+	 * The vertices of all polygons, with ``N`` vertices per polygon.
+	 */
+	Batch<Point2> vertices;
+};
+
+}
+
+#endif //APEX_FIXED_POLYGON
\ No newline at end of file
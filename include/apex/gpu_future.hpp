@@ -0,0 +1,258 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_GPU_FUTURE
+#define APEX_GPU_FUTURE
+
+#include <functional> //To finish the result on the host once the GPU is done.
+#include <memory> //To keep the result at a fixed address while the GPU writes to it.
+
+namespace apex {
+
+/*!
+ * A handle to the result of an operation that was queued on the GPU, but may
+ * not have completed yet.
+ *
+ * Asynchronous operations return immediately after queueing their work on the
+ * GPU, as deferred OpenMP target tasks. Meanwhile the host can continue with
+ * other work, such as preparing the next batch of data. Once the result is
+ * needed, the handle waits for the task that produces it.
+ *
+ * The task that produces the result is identified by a dependency on an
+ * address, usually the address of the result itself. Waiting for the result
+ * waits for all tasks that depend on that address. Like OpenMP, this only
+ * waits for tasks that were queued by the same host thread, so the handle must
+ * be waited on by the thread that called the operation.
+ *
+ * The result is stored on the heap, so that its address stays the same while
+ * the GPU is writing to it, even if the handle is moved. The handle waits for
+ * the result when it is destroyed, so that the GPU never writes to freed
+ * memory.
+ *
+ * Like ``std::future``, this handle can only be moved, and the result can only
+ * be retrieved once.
+ * \tparam T The type of the result of the operation.
+ */
+template<typename T>
+class GPUFuture {
+public:
+	/*!
+	 * Creates a handle for a result that is already available.
+	 *
+	 * This is used if there was no work to do on the GPU at all.
+	 * \param value The result of the operation.
+	 */
+	explicit GPUFuture(T value) : result(std::make_unique<T>(std::move(value))), dependency(nullptr) {}
+
+	/*!
+	 * Creates a handle for a result that is being computed on the GPU.
+	 * \param result The storage that the GPU writes the result to.
+	 * \param dependency The address that the task producing the result has an
+	 * ``out`` dependency on.
+	 * \param finish A function to apply to the result on the host once the GPU
+	 * is done, such as a final division that isn't worth a separate task on
+	 * the GPU.
+	 */
+	GPUFuture(std::unique_ptr<T> result, const void* dependency, std::function<void(T&)> finish = nullptr) : result(std::move(result)), dependency(static_cast<const char*>(dependency)), finish(std::move(finish)) {}
+
+	/*!
+	 * Moves the handle to a different variable.
+	 *
+	 * The original handle no longer refers to any result afterwards.
+	 * \param original The handle to move.
+	 */
+	GPUFuture(GPUFuture&& original) noexcept : result(std::move(original.result)), dependency(original.dependency), finish(std::move(original.finish)) {
+		original.dependency = nullptr;
+	}
+
+	/*!
+	 * Moves a different handle into this one.
+	 *
+	 * The result this handle referred to before is waited for first.
+	 * \param original The handle to move.
+	 * \return A reference to this handle.
+	 */
+	GPUFuture& operator =(GPUFuture&& original) noexcept {
+		wait();
+		result = std::move(original.result);
+		dependency = original.dependency;
+		finish = std::move(original.finish);
+		original.dependency = nullptr;
+		return *this;
+	}
+
+	/*!
+	 * Handles can't be copied, since only one of them can retrieve the result.
+	 */
+	GPUFuture(const GPUFuture& original) = delete;
+
+	/*!
+	 * Handles can't be copied, since only one of them can retrieve the result.
+	 */
+	GPUFuture& operator =(const GPUFuture& original) = delete;
+
+	/*!
+	 * Waits for the operation to complete before destroying the result.
+	 */
+	~GPUFuture() {
+		wait();
+	}
+
+	/*!
+	 * Whether this handle still refers to a result.
+	 *
+	 * After the result is retrieved with \ref get, or after the handle was
+	 * moved, the handle no longer refers to a result.
+	 * \return ``true`` if the result can still be retrieved, or ``false`` if it
+	 * can't.
+	 */
+	bool valid() const {
+		return result != nullptr;
+	}
+
+	/*!
+	 * Blocks until the result is available.
+	 *
+	 * If the result is already available, this returns immediately.
+	 */
+	void wait() {
+		if(dependency == nullptr) {
+			return;
+		}
+		#pragma omp taskwait depend(inout:dependency[0])
+		dependency = nullptr;
+		if(finish) {
+			finish(*result);
+		}
+	}
+
+	/*!
+	 * Retrieves the result of the operation.
+	 *
+	 * This waits for the result to become available, if necessary. Afterwards,
+	 * the handle no longer refers to the result.
+	 * \return The result of the operation.
+	 */
+	T get() {
+		wait();
+		T value = std::move(*result);
+		result.reset();
+		return value;
+	}
+
+protected:
+	/*!
+	 * The storage that the result is written to.
+	 */
+	std::unique_ptr<T> result;
+
+	/*!
+	 * The address that the task producing the result depends on, or
+	 * ``nullptr`` if the result is already available.
+	 */
+	const char* dependency;
+
+	/*!
+	 * A function to apply to the result on the host once it is available.
+	 */
+	std::function<void(T&)> finish;
+};
+
+/*!
+ * A handle to an operation that was queued on the GPU, but doesn't produce a
+ * result.
+ *
+ * This is returned by operations that modify their input, such as
+ * \ref translate_async. Other operations on the GPU using the same data are
+ * ordered after the operation automatically. The handle only needs to be waited
+ * on if the data is needed on the host and is not tracked by the
+ * ``GPUDataTracker``, which would wait for it by itself.
+ */
+template<>
+class GPUFuture<void> {
+public:
+	/*!
+	 * Creates a handle for an operation that already completed.
+	 */
+	GPUFuture() : dependency(nullptr) {}
+
+	/*!
+	 * Creates a handle for an operation that was queued on the GPU.
+	 * \param dependency The address that the task of the operation has an
+	 * ``out`` or ``inout`` dependency on.
+	 */
+	explicit GPUFuture(const void* dependency) : dependency(static_cast<const char*>(dependency)) {}
+
+	/*!
+	 * Moves the handle to a different variable.
+	 *
+	 * The original handle no longer refers to the operation afterwards.
+	 * \param original The handle to move.
+	 */
+	GPUFuture(GPUFuture&& original) noexcept : dependency(original.dependency) {
+		original.dependency = nullptr;
+	}
+
+	/*!
+	 * Moves a different handle into this one.
+	 *
+	 * The operation this handle referred to before is waited for first.
+	 * \param original The handle to move.
+	 * \return A reference to this handle.
+	 */
+	GPUFuture& operator =(GPUFuture&& original) noexcept {
+		wait();
+		dependency = original.dependency;
+		original.dependency = nullptr;
+		return *this;
+	}
+
+	/*!
+	 * Handles can't be copied, to keep them consistent with handles that
+	 * produce a result.
+	 */
+	GPUFuture(const GPUFuture& original) = delete;
+
+	/*!
+	 * Handles can't be copied, to keep them consistent with handles that
+	 * produce a result.
+	 */
+	GPUFuture& operator =(const GPUFuture& original) = delete;
+
+	/*!
+	 * Unlike handles with a result, this doesn't wait for the operation.
+	 *
+	 * The data that the operation works on is owned by the caller rather than
+	 * by this handle, so the operation may safely continue in the background.
+	 */
+	~GPUFuture() = default;
+
+	/*!
+	 * Blocks until the operation has completed.
+	 *
+	 * If the operation already completed, this returns immediately.
+	 */
+	void wait() {
+		if(dependency == nullptr) {
+			return;
+		}
+		#pragma omp taskwait depend(inout:dependency[0])
+		dependency = nullptr;
+	}
+
+protected:
+	/*!
+	 * The address that the task of the operation depends on, or ``nullptr`` if
+	 * the operation already completed.
+	 */
+	const char* dependency;
+};
+
+}
+
+#endif //APEX_GPU_FUTURE
\ No newline at end of file
@@ -0,0 +1,767 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_INSTRUMENTATION
+#define APEX_INSTRUMENTATION
+
+#include <array> //To store the totals of the counters.
+#include <atomic> //To count from multiple threads, and to check quickly whether anyone is listening.
+#include <chrono> //To time the versions of operations and the transfers to and from the GPU.
+#include <cstdint> //For the fixed-size values of hardware performance counters.
+#include <functional> //To store the callbacks.
+#include <mutex> //To register callbacks and report events from multiple threads.
+#include <utility> //To store callbacks together with their handles.
+#include <vector> //To store the callbacks.
+#if defined(INSTRUMENTATION) && defined(__linux__)
+#include <linux/perf_event.h> //To configure the hardware performance counters.
+#include <sys/syscall.h> //The C library has no wrapper for perf_event_open.
+#include <unistd.h> //To read and close the hardware performance counters.
+#endif
+
+#include "detail/strategies.hpp" //To identify operations and choose their versions.
+
+namespace apex {
+
+/*!
+ * The values of the hardware performance counters of the processor, measured
+ * over some period of time.
+ *
+ * These are only measured on Linux, if enabled with
+ * \ref Instrumentation::enable_hardware_counters. Only the thread that
+ * started the operation is measured. The other threads of multi-threaded
+ * versions are not.
+ */
+struct HardwareCounters {
+	/*!
+	 * Whether the counters could be measured. If not, all counts are 0.
+	 */
+	bool valid = false;
+
+	/*!
+	 * The number of processor cycles.
+	 */
+	uint64_t cycles = 0;
+
+	/*!
+	 * The number of instructions that were executed.
+	 */
+	uint64_t instructions = 0;
+
+	/*!
+	 * The number of accesses to the last level of cache.
+	 */
+	uint64_t cache_references = 0;
+
+	/*!
+	 * The number of accesses to the last level of cache that missed.
+	 */
+	uint64_t cache_misses = 0;
+
+	/*!
+	 * Get the average number of instructions that were executed per cycle.
+	 * \return The number of instructions per cycle, or 0 if no cycles were
+	 * counted.
+	 */
+	double instructions_per_cycle() const {
+		return cycles == 0 ? 0.0 : static_cast<double>(instructions) / cycles;
+	}
+};
+
+/*!
+ * Reported when an operation chose which version to use.
+ */
+struct StrategyEvent {
+	/*!
+	 * The operation that chose a version.
+	 */
+	detail::Operation operation;
+
+	/*!
+	 * The size of the input of the operation, as used to choose the version.
+	 * What this means differs per operation. See ``detail::Operation``.
+	 */
+	size_t size;
+
+	/*!
+	 * The index of the version that was chosen. See ``detail::Operation`` for
+	 * the versions of each operation.
+	 */
+	size_t version;
+
+	/*!
+	 * Get the name of the operation, as used in calibration profiles.
+	 * \return The name of the operation.
+	 */
+	const char* operation_name() const {
+		return detail::operation_names[static_cast<size_t>(operation)];
+	}
+};
+
+/*!
+ * Reported when the chosen version of an operation completed.
+ */
+struct KernelEvent {
+	/*!
+	 * The operation that completed.
+	 */
+	detail::Operation operation;
+
+	/*!
+	 * The size of the input of the operation, as used to choose the version.
+	 */
+	size_t size;
+
+	/*!
+	 * The index of the version that was executed.
+	 */
+	size_t version;
+
+	/*!
+	 * How long it took to execute the version, including any transfers to and
+	 * from the GPU.
+	 */
+	std::chrono::nanoseconds duration;
+
+	/*!
+	 * The hardware performance counters while executing the version, if they
+	 * are enabled.
+	 */
+	HardwareCounters hardware;
+
+	/*!
+	 * Get the name of the operation, as used in calibration profiles.
+	 * \return The name of the operation.
+	 */
+	const char* operation_name() const {
+		return detail::operation_names[static_cast<size_t>(operation)];
+	}
+};
+
+/*!
+ * Reported when the ``GPUDataTracker`` transferred data between the host and
+ * the GPU.
+ */
+struct TransferEvent {
+	/*!
+	 * In which direction data can be transferred.
+	 */
+	enum class Direction {
+		TO_DEVICE,
+		TO_HOST
+	};
+
+	/*!
+	 * In which direction the data was transferred.
+	 */
+	Direction direction;
+
+	/*!
+	 * How many bytes were transferred.
+	 */
+	size_t bytes;
+
+	/*!
+	 * Whether the transfer was queued without waiting for it. If so, the
+	 * duration only includes queueing the transfer.
+	 */
+	bool asynchronous;
+
+	/*!
+	 * How long the transfer took.
+	 */
+	std::chrono::nanoseconds duration;
+};
+
+/*!
+ * Quantities that are counted while operations run.
+ */
+enum class Counter : size_t {
+	/*!
+	 * The number of bytes that the ``GPUDataTracker`` transferred to the GPU.
+	 */
+	bytes_to_device,
+
+	/*!
+	 * The number of bytes that the ``GPUDataTracker`` transferred to the host.
+	 */
+	bytes_to_host,
+
+	/*!
+	 * The number of pairs of edges that the versions of ``self_intersections``
+	 * on the CPU tested for intersection, after the broad phase.
+	 */
+	pairs_tested
+};
+
+/*!
+ * The number of counters in \ref Counter.
+ */
+constexpr size_t num_counters = 3;
+
+#if defined(INSTRUMENTATION) && defined(__linux__)
+namespace detail {
+
+/*!
+ * The hardware performance counters that are opened for a thread.
+ *
+ * The counters are opened as one group, so that they are all read at once
+ * and count over the same period.
+ */
+struct HardwareCounterGroup {
+	/*!
+	 * Whether the counters were opened, successfully or not.
+	 */
+	bool opened = false;
+
+	/*!
+	 * The file descriptors of the counters. The first is the leader of the
+	 * group. If the counters couldn't be opened, these are all -1.
+	 */
+	std::array<int, 4> descriptors = {-1, -1, -1, -1};
+
+	/*!
+	 * Open the counters for the current thread, on any processor.
+	 */
+	void open() {
+		opened = true;
+		constexpr std::array<uint64_t, 4> events = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+		for(size_t event = 0; event < events.size(); ++event) {
+			perf_event_attr attributes = {};
+			attributes.type = PERF_TYPE_HARDWARE;
+			attributes.size = sizeof(attributes);
+			attributes.config = events[event];
+			attributes.read_format = PERF_FORMAT_GROUP;
+			attributes.exclude_kernel = 1; //Only count the library itself, which also allows unprivileged processes to read the counters.
+			attributes.exclude_hv = 1;
+			descriptors[event] = syscall(SYS_perf_event_open, &attributes, 0, -1, event == 0 ? -1 : descriptors[0], 0);
+			if(descriptors[event] < 0) { //Not supported, or not allowed. Don't count at all, rather than counting only some of them.
+				close();
+				return;
+			}
+		}
+	}
+
+	/*!
+	 * Close all counters that were opened.
+	 */
+	void close() {
+		for(int& descriptor : descriptors) {
+			if(descriptor >= 0) {
+				::close(descriptor);
+			}
+			descriptor = -1;
+		}
+	}
+
+	/*!
+	 * Closes the counters when the thread ends.
+	 */
+	~HardwareCounterGroup() {
+		close();
+	}
+};
+
+}
+#endif //INSTRUMENTATION && __linux__
+
+/*!
+ * Reports what happens inside of the operations, to find out why they are
+ * slow.
+ *
+ * The public dispatchers of the operations report which version they chose,
+ * and how long that version took to execute. Optionally, the hardware
+ * performance counters of the processor are read as well. The
+ * ``GPUDataTracker`` reports how much data it transferred to and from the GPU,
+ * and how long that took. These events are passed to the callbacks that are
+ * registered here, so that they can be exported to any telemetry system. Some
+ * quantities are also accumulated in counters, which can be read at any time.
+ *
+ * Instrumentation is only compiled in if the ``INSTRUMENTATION`` macro is
+ * defined, e.g. with the ``WITH_INSTRUMENTATION`` option of the build system.
+ * Otherwise all hooks are empty, and the compiler optimises them away
+ * completely. Callbacks can then still be registered, but they are never
+ * called. Even if instrumentation is compiled in, the operations are only
+ * timed if a callback is registered for the kernels.
+ *
+ * Callbacks are called from the thread that performed the operation, while
+ * other threads may be reporting events too. They are called one at a time.
+ * Callbacks must be quick, and may not register or remove callbacks.
+ *
+ * Like the ``Strategies``, this class is completely static. It is impossible to
+ * instantiate the class.
+ */
+class Instrumentation {
+public:
+	/*!
+	 * Whether instrumentation is compiled into the library.
+	 */
+#ifdef INSTRUMENTATION
+	static constexpr bool compiled = true;
+#else
+	static constexpr bool compiled = false;
+#endif
+
+	/*!
+	 * Register a function to call whenever an operation chose a version.
+	 * \param callback The function to call.
+	 * \return A handle to remove the callback with.
+	 */
+	static size_t add_strategy_callback(const std::function<void(const StrategyEvent&)> callback) {
+		const std::lock_guard<std::mutex> lock(mutex);
+		strategy_callbacks.emplace_back(next_handle, callback);
+		num_strategy_callbacks = strategy_callbacks.size();
+		return next_handle++;
+	}
+
+	/*!
+	 * Register a function to call whenever the chosen version of an operation
+	 * completed.
+	 * \param callback The function to call.
+	 * \return A handle to remove the callback with.
+	 */
+	static size_t add_kernel_callback(const std::function<void(const KernelEvent&)> callback) {
+		const std::lock_guard<std::mutex> lock(mutex);
+		kernel_callbacks.emplace_back(next_handle, callback);
+		num_kernel_callbacks = kernel_callbacks.size();
+		return next_handle++;
+	}
+
+	/*!
+	 * Register a function to call whenever data was transferred between the
+	 * host and the GPU.
+	 * \param callback The function to call.
+	 * \return A handle to remove the callback with.
+	 */
+	static size_t add_transfer_callback(const std::function<void(const TransferEvent&)> callback) {
+		const std::lock_guard<std::mutex> lock(mutex);
+		transfer_callbacks.emplace_back(next_handle, callback);
+		num_transfer_callbacks = transfer_callbacks.size();
+		return next_handle++;
+	}
+
+	/*!
+	 * Stop calling a callback.
+	 * \param handle The handle that was returned when the callback was added.
+	 * If no callback has this handle, nothing happens.
+	 */
+	static void remove_callback(const size_t handle) {
+		const std::lock_guard<std::mutex> lock(mutex);
+		remove_from(strategy_callbacks, handle);
+		remove_from(kernel_callbacks, handle);
+		remove_from(transfer_callbacks, handle);
+		num_strategy_callbacks = strategy_callbacks.size();
+		num_kernel_callbacks = kernel_callbacks.size();
+		num_transfer_callbacks = transfer_callbacks.size();
+	}
+
+	/*!
+	 * Stop calling all callbacks.
+	 */
+	static void clear_callbacks() {
+		const std::lock_guard<std::mutex> lock(mutex);
+		strategy_callbacks.clear();
+		kernel_callbacks.clear();
+		transfer_callbacks.clear();
+		num_strategy_callbacks = 0;
+		num_kernel_callbacks = 0;
+		num_transfer_callbacks = 0;
+	}
+
+	/*!
+	 * Get the total of a counter, since the counters were last reset.
+	 * \param counter The counter to get the total of.
+	 * \return The total of that counter.
+	 */
+	static size_t get_counter(const Counter counter) {
+		return counters[static_cast<size_t>(counter)];
+	}
+
+	/*!
+	 * Set all counters back to 0.
+	 */
+	static void reset_counters() {
+		for(std::atomic<size_t>& counter : counters) {
+			counter = 0;
+		}
+	}
+
+	/*!
+	 * Choose whether to read the hardware performance counters of the
+	 * processor while the operations execute.
+	 *
+	 * The counters are only available on Linux. The kernel may also forbid
+	 * reading them, depending on the ``perf_event_paranoid`` setting. Reading
+	 * them adds a few system calls to each operation.
+	 * \param enable Whether to read the hardware performance counters.
+	 * \return Whether the counters can be read. If not, the counters of the
+	 * kernel events are never valid.
+	 */
+	static bool enable_hardware_counters(const bool enable) {
+		hardware_counters_enabled = enable;
+		return enable && read_hardware_counters().valid;
+	}
+
+	/*!
+	 * Report that an operation chose a version.
+	 *
+	 * This is called by the dispatchers of the operations.
+	 * \param operation The operation that chose a version.
+	 * \param size The size of the input of the operation.
+	 * \param version The version that was chosen.
+	 */
+	static void strategy_chosen([[maybe_unused]] const detail::Operation operation, [[maybe_unused]] const size_t size, [[maybe_unused]] const size_t version) {
+#ifdef INSTRUMENTATION
+		if(num_strategy_callbacks == 0) {
+			return;
+		}
+		const StrategyEvent event = {operation, size, version};
+		const std::lock_guard<std::mutex> lock(mutex);
+		for(const std::pair<size_t, std::function<void(const StrategyEvent&)>>& callback : strategy_callbacks) {
+			callback.second(event);
+		}
+#endif //INSTRUMENTATION
+	}
+
+	/*!
+	 * Whether the kernels need to be timed, because someone is listening for
+	 * them.
+	 * \return ``true`` if the kernels need to be timed, or ``false`` if not.
+	 */
+	static bool timing_kernels() {
+#ifdef INSTRUMENTATION
+		return num_kernel_callbacks > 0;
+#else
+		return false;
+#endif //INSTRUMENTATION
+	}
+
+	/*!
+	 * Report that the chosen version of an operation completed.
+	 * \param event The measurements of the version.
+	 */
+	static void kernel_finished([[maybe_unused]] const KernelEvent& event) {
+#ifdef INSTRUMENTATION
+		const std::lock_guard<std::mutex> lock(mutex);
+		for(const std::pair<size_t, std::function<void(const KernelEvent&)>>& callback : kernel_callbacks) {
+			callback.second(event);
+		}
+#endif //INSTRUMENTATION
+	}
+
+	/*!
+	 * Report that data was transferred between the host and the GPU.
+	 *
+	 * This adds the transferred bytes to the counters as well.
+	 * \param event The transfer that took place.
+	 */
+	static void transferred([[maybe_unused]] const TransferEvent& event) {
+#ifdef INSTRUMENTATION
+		count(event.direction == TransferEvent::Direction::TO_DEVICE ? Counter::bytes_to_device : Counter::bytes_to_host, event.bytes);
+		if(num_transfer_callbacks == 0) {
+			return;
+		}
+		const std::lock_guard<std::mutex> lock(mutex);
+		for(const std::pair<size_t, std::function<void(const TransferEvent&)>>& callback : transfer_callbacks) {
+			callback.second(event);
+		}
+#endif //INSTRUMENTATION
+	}
+
+	/*!
+	 * Add to the total of a counter.
+	 *
+	 * This may be called from multiple threads at the same time, but it is
+	 * best to accumulate a local count first and add it once.
+	 * \param counter The counter to add to.
+	 * \param amount How much to add.
+	 */
+	static void count([[maybe_unused]] const Counter counter, [[maybe_unused]] const size_t amount) {
+#ifdef INSTRUMENTATION
+		counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+#endif //INSTRUMENTATION
+	}
+
+	/*!
+	 * Read the current values of the hardware performance counters for the
+	 * current thread.
+	 *
+	 * The counters are opened the first time they are read on each thread.
+	 * \return The current values, which are only valid if the counters are
+	 * enabled and available.
+	 */
+	static HardwareCounters read_hardware_counters() {
+		HardwareCounters result;
+#if defined(INSTRUMENTATION) && defined(__linux__)
+		if(!hardware_counters_enabled) {
+			return result;
+		}
+		detail::HardwareCounterGroup& group = hardware_counter_group;
+		if(!group.opened) {
+			group.open();
+		}
+		if(group.descriptors[0] < 0) { //Not available.
+			return result;
+		}
+		struct {
+			uint64_t count;
+			uint64_t values[4];
+		} data;
+		if(::read(group.descriptors[0], &data, sizeof(data)) != sizeof(data) || data.count != 4) {
+			return result;
+		}
+		result.valid = true;
+		result.cycles = data.values[0];
+		result.instructions = data.values[1];
+		result.cache_references = data.values[2];
+		result.cache_misses = data.values[3];
+#endif //INSTRUMENTATION && __linux__
+		return result;
+	}
+
+	/*!
+	 * This object may not be instantiated.
+	 */
+	Instrumentation() = delete;
+
+protected:
+	/*!
+	 * Locks the callbacks while they are being called or changed.
+	 */
+	inline static std::mutex mutex;
+
+	/*!
+	 * The handle to give to the next callback that is added.
+	 */
+	inline static size_t next_handle = 0;
+
+	/*!
+	 * The functions to call when an operation chose a version, with their
+	 * handles.
+	 */
+	inline static std::vector<std::pair<size_t, std::function<void(const StrategyEvent&)>>> strategy_callbacks;
+
+	/*!
+	 * The functions to call when a version of an operation completed, with
+	 * their handles.
+	 */
+	inline static std::vector<std::pair<size_t, std::function<void(const KernelEvent&)>>> kernel_callbacks;
+
+	/*!
+	 * The functions to call when data was transferred, with their handles.
+	 */
+	inline static std::vector<std::pair<size_t, std::function<void(const TransferEvent&)>>> transfer_callbacks;
+
+	/*!
+	 * The number of callbacks for strategies, to check without locking whether
+	 * these events need to be reported at all.
+	 */
+	inline static std::atomic<size_t> num_strategy_callbacks = 0;
+
+	/*!
+	 * The number of callbacks for kernels, to check without locking whether
+	 * the kernels need to be timed at all.
+	 */
+	inline static std::atomic<size_t> num_kernel_callbacks = 0;
+
+	/*!
+	 * The number of callbacks for transfers, to check without locking whether
+	 * these events need to be reported at all.
+	 */
+	inline static std::atomic<size_t> num_transfer_callbacks = 0;
+
+	/*!
+	 * The totals of the counters.
+	 */
+	inline static std::array<std::atomic<size_t>, num_counters> counters = {};
+
+	/*!
+	 * Whether to read the hardware performance counters.
+	 */
+	inline static std::atomic<bool> hardware_counters_enabled = false;
+
+#if defined(INSTRUMENTATION) && defined(__linux__)
+	/*!
+	 * The hardware performance counters of the current thread.
+	 */
+	inline static thread_local detail::HardwareCounterGroup hardware_counter_group;
+#endif //INSTRUMENTATION && __linux__
+
+	/*!
+	 * Remove the callback with a certain handle from a list of callbacks.
+	 * \tparam Callbacks The type of list of callbacks.
+	 * \param callbacks The list to remove the callback from.
+	 * \param handle The handle of the callback to remove.
+	 */
+	template<typename Callbacks>
+	static void remove_from(Callbacks& callbacks, const size_t handle) {
+		std::erase_if(callbacks, [handle](const typename Callbacks::value_type& callback) {
+			return callback.first == handle;
+		});
+	}
+};
+
+namespace detail {
+
+/*!
+ * Chooses the version of an operation to execute, and reports on it while it
+ * executes.
+ *
+ * The dispatchers of the operations construct this object before executing the
+ * version it chose. It reports the chosen version to the ``Instrumentation``.
+ * If the kernels are timed, it measures until it is destroyed, when the
+ * dispatcher returns. Without instrumentation, this is equivalent to calling
+ * ``Strategies::choose``.
+ */
+class Dispatch {
+public:
+	/*!
+	 * The version that was chosen.
+	 */
+	const size_t version;
+
+	/*!
+	 * Chooses the version of an operation that is expected to be fastest.
+	 * \param operation The operation to choose a version of.
+	 * \param size The size of the input of the operation. What this means
+	 * differs per operation. See \ref Operation.
+	 */
+	Dispatch(const Operation operation, const size_t size) : version(Strategies::choose(operation, size)) {
+#ifdef INSTRUMENTATION
+		Instrumentation::strategy_chosen(operation, size, version);
+		timed = Instrumentation::timing_kernels();
+		if(timed) {
+			this->operation = operation;
+			this->size = size;
+			hardware_start = Instrumentation::read_hardware_counters();
+			start = std::chrono::steady_clock::now();
+		}
+#endif //INSTRUMENTATION
+	}
+
+#ifdef INSTRUMENTATION
+	/*!
+	 * Reports how long the chosen version took to execute.
+	 */
+	~Dispatch() {
+		if(!timed) {
+			return;
+		}
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		const HardwareCounters hardware_end = Instrumentation::read_hardware_counters();
+		KernelEvent event = {operation, size, version, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start), HardwareCounters()};
+		if(hardware_start.valid && hardware_end.valid) {
+			event.hardware.valid = true;
+			event.hardware.cycles = hardware_end.cycles - hardware_start.cycles;
+			event.hardware.instructions = hardware_end.instructions - hardware_start.instructions;
+			event.hardware.cache_references = hardware_end.cache_references - hardware_start.cache_references;
+			event.hardware.cache_misses = hardware_end.cache_misses - hardware_start.cache_misses;
+		}
+		Instrumentation::kernel_finished(event);
+	}
+#endif //INSTRUMENTATION
+
+	/*!
+	 * The dispatch may not be copied, or the version would be reported twice.
+	 */
+	Dispatch(const Dispatch& original) = delete;
+
+	/*!
+	 * The dispatch may not be assigned, or the version would be reported twice.
+	 */
+	Dispatch& operator =(const Dispatch& original) = delete;
+
+#ifdef INSTRUMENTATION
+protected:
+	/*!
+	 * Whether the version is being timed.
+	 */
+	bool timed;
+
+	/*!
+	 * The operation that is being executed.
+	 */
+	Operation operation;
+
+	/*!
+	 * The size of the input of the operation.
+	 */
+	size_t size;
+
+	/*!
+	 * The hardware performance counters when the version started.
+	 */
+	HardwareCounters hardware_start;
+
+	/*!
+	 * When the version started.
+	 */
+	std::chrono::steady_clock::time_point start;
+#endif //INSTRUMENTATION
+};
+
+/*!
+ * Reports a transfer between the host and the GPU to the ``Instrumentation``,
+ * timing it until this object is destroyed.
+ *
+ * The ``GPUDataTracker`` constructs this object right before it transfers
+ * data. Without instrumentation, this does nothing.
+ */
+class TransferTimer {
+public:
+	/*!
+	 * Starts timing a transfer.
+	 * \param direction In which direction the data is transferred.
+	 * \param bytes How many bytes are transferred.
+	 * \param asynchronous Whether the transfer is queued without waiting for
+	 * it.
+	 */
+	TransferTimer([[maybe_unused]] const TransferEvent::Direction direction, [[maybe_unused]] const size_t bytes, [[maybe_unused]] const bool asynchronous)
+#ifdef INSTRUMENTATION
+		: event{direction, bytes, asynchronous, std::chrono::nanoseconds(0)}, start(std::chrono::steady_clock::now())
+#endif //INSTRUMENTATION
+	{}
+
+#ifdef INSTRUMENTATION
+	/*!
+	 * Reports the transfer, once it completed.
+	 */
+	~TransferTimer() {
+		event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		Instrumentation::transferred(event);
+	}
+#endif //INSTRUMENTATION
+
+	/*!
+	 * The timer may not be copied, or the transfer would be reported twice.
+	 */
+	TransferTimer(const TransferTimer& original) = delete;
+
+	/*!
+	 * The timer may not be assigned, or the transfer would be reported twice.
+	 */
+	TransferTimer& operator =(const TransferTimer& original) = delete;
+
+#ifdef INSTRUMENTATION
+protected:
+	/*!
+	 * The transfer that is being timed.
+	 */
+	TransferEvent event;
+
+	/*!
+	 * When the transfer started.
+	 */
+	std::chrono::steady_clock::time_point start;
+#endif //INSTRUMENTATION
+};
+
+}
+
+}
+
+#endif //APEX_INSTRUMENTATION
\ No newline at end of file
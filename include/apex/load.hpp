@@ -0,0 +1,643 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_LOAD
+#define APEX_LOAD
+
+#include <algorithm> //For std::copy and std::min.
+#include <bit> //To count the digits of a number with bitwise operations.
+#include <charconv> //To parse numbers with decimals.
+#include <cmath> //To round numbers with decimals to coordinates.
+#include <cstdint> //To process the characters of numbers in 64-bit blocks.
+#include <cstring> //To load the characters of numbers in 64-bit blocks.
+#include <exception> //To report errors in the input from multiple threads.
+#include <filesystem> //To load files.
+#include <limits> //To check whether numbers fit in a coordinate.
+#include <memory_resource> //To allow allocating the vertices from a custom memory resource.
+#include <omp.h> //To parse large inputs on multiple threads.
+#include <optional> //To look up attributes that may not exist.
+#include <stdexcept> //To report malformed input.
+#include <string> //To report where the input is malformed.
+#include <string_view> //To parse the input without copying it.
+#include <vector> //To store where each polygon starts in the vertex buffer.
+
+#include "coordinate.hpp" //To parse coordinates.
+#include "detail/mapped_file.hpp" //To load files through memory-mapping.
+#include "point2.hpp" //To construct the vertices.
+#include "polygon.hpp" //To return batches of polygons.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * Powers of ten, to combine blocks of digits into one number.
+ */
+constexpr uint64_t powers_of_ten[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+/*!
+ * Counts how many of the characters in a block of 8 are digits, before the
+ * first character that is not a digit.
+ *
+ * This checks all 8 characters at once with bitwise operations. A character is
+ * a digit if its upper 4 bits are 0011, and they still are after adding 6. The
+ * addition may carry into the next character, but only from characters that
+ * are not digits, after which the rest doesn't matter any more.
+ * \param block 8 characters, with the first character in the least significant
+ * byte.
+ * \return The number of leading digits.
+ */
+inline size_t count_digits(const uint64_t block) {
+	const uint64_t not_digits = ((block & 0xF0F0F0F0F0F0F0F0) ^ 0x3030303030303030) | (((block + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) ^ 0x3030303030303030);
+	return std::countr_zero(not_digits) / 8; //Each non-digit character has some bits set, so the first of them determines the number of trailing zeroes.
+}
+
+/*!
+ * Converts the leading digits of a block of 8 characters to a number.
+ *
+ * The digits are shifted to the end of the block, padding the start with
+ * zeroes. Then adjacent digits are combined pairwise with multiplications,
+ * first into 4 numbers of 2 digits, then 2 numbers of 4 digits, then the final
+ * number. That takes 3 multiplications instead of 8.
+ * \param block 8 characters, with the first character in the least significant
+ * byte.
+ * \param num_digits The number of leading digits, between 1 and 8.
+ * \return The number that those digits represent.
+ */
+inline uint32_t parse_digits(uint64_t block, const size_t num_digits) {
+	block <<= 8 * (8 - num_digits); //Zeroes in front of the number don't change its value.
+	block = ((block & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8; //Combine pairs of digits: 10 * first + second.
+	block = ((block & 0x00FF00FF00FF00FF) * 6553601) >> 16; //Combine pairs of 2-digit numbers: 100 * first + second.
+	return static_cast<uint32_t>(((block & 0x0000FFFF0000FFFF) * 42949672960001) >> 32); //Combine the two 4-digit numbers: 10000 * first + second.
+}
+
+/*!
+ * Parses a coordinate from text.
+ *
+ * Integers are parsed 8 digits at a time. Numbers with decimals or an exponent
+ * are rounded to the nearest coordinate.
+ * \param position The start of the number. This is moved to the first
+ * character after the number.
+ * \param end The end of the text.
+ * \return The parsed coordinate.
+ */
+inline coord_t parse_coordinate(const char*& position, const char* const end) {
+	const char* const start = position;
+	bool negative = false;
+	if(position < end && (*position == '-' || *position == '+')) {
+		negative = *position == '-';
+		++position;
+	}
+	const char* const digits_start = position;
+	uint64_t magnitude = 0;
+	if constexpr(std::endian::native == std::endian::little) { //The blocks of digits assume the first character is the least significant byte.
+		while(end - position >= 8 && position - digits_start <= 10) { //Beyond 10 digits it doesn't fit in a coordinate. Stop before overflowing.
+			uint64_t block;
+			std::memcpy(&block, position, 8);
+			const size_t num_digits = count_digits(block);
+			if(num_digits == 0) {
+				break;
+			}
+			magnitude = magnitude * powers_of_ten[num_digits] + parse_digits(block, num_digits);
+			position += num_digits;
+			if(num_digits < 8) { //The number ended within this block.
+				break;
+			}
+		}
+	}
+	while(position < end && *position >= '0' && *position <= '9' && position - digits_start <= 10) { //The last few characters of the text, or on big-endian processors.
+		magnitude = magnitude * 10 + (*position - '0');
+		++position;
+	}
+	if(position < end && *position >= '0' && *position <= '9') {
+		throw std::out_of_range("The number at \"" + std::string(start, std::min(position, start + 20)) + "\" is too big for a coordinate.");
+	}
+
+	if(position < end && (*position == '.' || *position == 'e' || *position == 'E')) { //Not an integer. Parse it completely and round it.
+		double value;
+		const std::from_chars_result result = std::from_chars(digits_start, end, value);
+		if(result.ec != std::errc() || result.ptr == digits_start) {
+			throw std::invalid_argument("Expected a number at \"" + std::string(start, std::min(end, start + 20)) + "\".");
+		}
+		position = result.ptr;
+		value = std::round(negative ? -value : value);
+		if(!(value >= std::numeric_limits<coord_t>::min() && value <= std::numeric_limits<coord_t>::max())) {
+			throw std::out_of_range("The number at \"" + std::string(start, position) + "\" is too big for a coordinate.");
+		}
+		return static_cast<coord_t>(value);
+	}
+	if(position == digits_start) {
+		throw std::invalid_argument("Expected a number at \"" + std::string(start, std::min(end, start + 20)) + "\".");
+	}
+	if(magnitude > static_cast<uint64_t>(std::numeric_limits<coord_t>::max()) + (negative ? 1 : 0)) {
+		throw std::out_of_range("The number at \"" + std::string(start, position) + "\" is too big for a coordinate.");
+	}
+	return static_cast<coord_t>(negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude));
+}
+
+/*!
+ * Whether a character separates numbers in SVG attributes, which is whitespace
+ * or a comma.
+ * \param character The character to check.
+ * \return ``true`` if the character is a separator, or ``false`` if it isn't.
+ */
+inline bool is_separator(const char character) {
+	return character == ' ' || character == ',' || character == '\n' || character == '\r' || character == '\t';
+}
+
+/*!
+ * Skips over separators between numbers.
+ * \param position The position to start skipping from. This is moved to the
+ * first character that is not a separator.
+ * \param end The end of the text.
+ */
+inline void skip_separators(const char*& position, const char* const end) {
+	while(position < end && is_separator(*position)) {
+		++position;
+	}
+}
+
+/*!
+ * The polygons parsed from part of the input.
+ *
+ * The vertices of all polygons are stored in one buffer, with where each
+ * polygon starts, so that they can be adopted by a ``Batch<Polygon>`` without
+ * copying them.
+ */
+struct ParsedPolygons {
+	/*!
+	 * The vertices of all polygons, one polygon after another.
+	 */
+	std::pmr::vector<Point2> vertices;
+
+	/*!
+	 * For each polygon, where its vertices start, followed by where the last
+	 * polygon ends.
+	 */
+	std::vector<size_t> offsets;
+
+	/*!
+	 * Prepares to parse polygons.
+	 * \param resource The memory resource to allocate the vertices from.
+	 */
+	explicit ParsedPolygons(std::pmr::memory_resource* resource) : vertices(resource), offsets(1, 0) {}
+
+	/*!
+	 * Ends the current polygon, starting the next polygon.
+	 */
+	void end_polygon() {
+		offsets.push_back(vertices.size());
+	}
+
+	/*!
+	 * Whether any vertices were added since the last polygon ended.
+	 * \return ``true`` if the current polygon has vertices, or ``false`` if it
+	 * doesn't.
+	 */
+	bool polygon_started() const {
+		return vertices.size() > offsets.back();
+	}
+};
+
+/*!
+ * Parses the ``points`` attribute of an SVG polygon.
+ * \param points The value of the attribute.
+ * \param output The polygons parsed so far, to add the polygon to.
+ */
+inline void parse_svg_points(const std::string_view points, ParsedPolygons& output) {
+	const char* position = points.data();
+	const char* const end = points.data() + points.size();
+	while(true) {
+		skip_separators(position, end);
+		if(position >= end) {
+			break;
+		}
+		const coord_t x = parse_coordinate(position, end);
+		skip_separators(position, end);
+		if(position >= end) {
+			throw std::invalid_argument("The points of the polygon have an odd number of coordinates.");
+		}
+		const coord_t y = parse_coordinate(position, end);
+		output.vertices.emplace_back(x, y);
+	}
+	output.end_polygon();
+}
+
+/*!
+ * Parses the ``d`` attribute of an SVG path.
+ *
+ * Each subpath becomes a polygon, whether it is closed explicitly or not,
+ * since it is closed implicitly when filling it. Curves and arcs are replaced
+ * by a straight line to their end point.
+ * \param path The value of the attribute.
+ * \param output The polygons parsed so far, to add the polygons to.
+ */
+inline void parse_svg_path(const std::string_view path, ParsedPolygons& output) {
+	const char* position = path.data();
+	const char* const end = path.data() + path.size();
+	char command = 0; //No command yet, so numbers are not allowed.
+	Point2 current(0, 0);
+	Point2 subpath_start(0, 0);
+	bool closed = false; //After closing a subpath, drawing continues with a new subpath from its start.
+	const auto parse_number = [&position, end]() {
+		skip_separators(position, end);
+		return parse_coordinate(position, end);
+	};
+	const auto add_vertex = [&output, &current, &subpath_start, &closed](const Point2& vertex) {
+		if(closed) {
+			output.vertices.push_back(subpath_start);
+			closed = false;
+		}
+		current = vertex;
+		output.vertices.push_back(vertex);
+	};
+	while(true) {
+		skip_separators(position, end);
+		if(position >= end) {
+			break;
+		}
+		if((*position >= 'a' && *position <= 'z') || (*position >= 'A' && *position <= 'Z')) {
+			command = *position;
+			++position;
+			if(command == 'Z' || command == 'z') { //Closing the subpath needs no numbers.
+				if(output.polygon_started()) {
+					output.end_polygon();
+				}
+				current = subpath_start;
+				closed = true;
+				continue;
+			}
+		} else if(command == 0 || command == 'Z' || command == 'z') {
+			throw std::invalid_argument("Expected a command in the path at \"" + std::string(position, std::min(end, position + 20)) + "\".");
+		}
+
+		const bool relative = command >= 'a';
+		const Point2 origin = relative ? current : Point2(0, 0);
+		switch(command) {
+			case 'M': case 'm': {
+				if(output.polygon_started()) {
+					output.end_polygon();
+				}
+				const coord_t x = parse_number();
+				const coord_t y = parse_number();
+				subpath_start = origin + Point2(x, y);
+				closed = false;
+				add_vertex(subpath_start);
+				command = relative ? 'l' : 'L'; //Further coordinate pairs are lines.
+				break;
+			}
+			case 'L': case 'l': case 'T': case 't': {
+				const coord_t x = parse_number();
+				const coord_t y = parse_number();
+				add_vertex(origin + Point2(x, y));
+				break;
+			}
+			case 'H': case 'h':
+				add_vertex(Point2(origin.x + parse_number(), current.y));
+				break;
+			case 'V': case 'v':
+				add_vertex(Point2(current.x, origin.y + parse_number()));
+				break;
+			case 'C': case 'c': case 'S': case 's': case 'Q': case 'q': { //Skip the control points, and only take the end point.
+				const size_t num_control_coordinates = (command == 'C' || command == 'c') ? 4 : 2;
+				for(size_t control = 0; control < num_control_coordinates; ++control) {
+					parse_number();
+				}
+				const coord_t x = parse_number();
+				const coord_t y = parse_number();
+				add_vertex(origin + Point2(x, y));
+				break;
+			}
+			case 'A': case 'a': { //Skip the radii, rotation and flags, and only take the end point.
+				for(size_t parameter = 0; parameter < 5; ++parameter) {
+					skip_separators(position, end);
+					if(parameter >= 3 && position < end && (*position == '0' || *position == '1')) { //Flags may be written without separators.
+						++position;
+					} else {
+						parse_coordinate(position, end);
+					}
+				}
+				const coord_t x = parse_number();
+				const coord_t y = parse_number();
+				add_vertex(origin + Point2(x, y));
+				break;
+			}
+			default:
+				throw std::invalid_argument(std::string("Unknown command in the path: ") + command + ".");
+		}
+	}
+	if(output.polygon_started()) {
+		output.end_polygon();
+	}
+}
+
+/*!
+ * Finds the value of an attribute in an SVG tag.
+ * \param tag The tag to search in, from the ``<`` up to the ``>``.
+ * \param name The name of the attribute.
+ * \return The value of the attribute, without quotes, or nothing if the tag
+ * doesn't have the attribute.
+ */
+inline std::optional<std::string_view> find_attribute(const std::string_view tag, const std::string_view name) {
+	size_t position = 0;
+	while((position = tag.find(name, position)) != std::string_view::npos) {
+		const bool starts_attribute = position > 0 && is_separator(tag[position - 1]);
+		position += name.size();
+		if(!starts_attribute) { //Part of a different name or value.
+			continue;
+		}
+		while(position < tag.size() && is_separator(tag[position])) {
+			++position;
+		}
+		if(position >= tag.size() || tag[position] != '=') {
+			continue;
+		}
+		++position;
+		while(position < tag.size() && is_separator(tag[position])) {
+			++position;
+		}
+		if(position >= tag.size() || (tag[position] != '"' && tag[position] != '\'')) {
+			continue;
+		}
+		const size_t value_end = tag.find(tag[position], position + 1);
+		if(value_end == std::string_view::npos) {
+			throw std::invalid_argument("The value of the " + std::string(name) + " attribute never ends.");
+		}
+		return tag.substr(position + 1, value_end - position - 1);
+	}
+	return std::nullopt;
+}
+
+/*!
+ * Whether an SVG tag has a certain name.
+ * \param svg The SVG document.
+ * \param position The position of the ``<`` that starts the tag.
+ * \param name The name of the tag to check for.
+ * \return ``true`` if the tag has that name, or ``false`` if it doesn't.
+ */
+inline bool is_tag(const std::string_view svg, const size_t position, const std::string_view name) {
+	const size_t name_end = position + 1 + name.size();
+	return svg.compare(position + 1, name.size(), name) == 0 && name_end < svg.size() && (is_separator(svg[name_end]) || svg[name_end] == '/' || svg[name_end] == '>');
+}
+
+/*!
+ * Parses the polygons and paths in part of an SVG document.
+ *
+ * The part must start and end at the start of a tag, or at the start or end of
+ * the document. Since tags can't contain a ``<``, each tag is then completely
+ * inside of one part.
+ * \param svg The part of the SVG document to parse.
+ * \param output The polygons parsed so far, to add the polygons to.
+ */
+inline void parse_svg(const std::string_view svg, ParsedPolygons& output) {
+	size_t position = 0;
+	while((position = svg.find('<', position)) != std::string_view::npos) {
+		const bool polygon = is_tag(svg, position, "polygon");
+		const bool path = !polygon && is_tag(svg, position, "path");
+		if(!polygon && !path) {
+			++position;
+			continue;
+		}
+		const size_t tag_end = std::min(svg.find('>', position), svg.size());
+		const std::string_view tag = svg.substr(position, tag_end - position);
+		if(polygon) {
+			parse_svg_points(find_attribute(tag, "points").value_or(std::string_view()), output);
+		} else {
+			const std::optional<std::string_view> data = find_attribute(tag, "d");
+			if(data) {
+				parse_svg_path(*data, output);
+			}
+		}
+		position = tag_end;
+	}
+}
+
+/*!
+ * Parses part of a list of vertices, one vertex per line, with blank lines
+ * between polygons.
+ * \param text The part of the text to parse. It must start at the start of a
+ * line.
+ * \param output The polygons parsed so far, to add the polygons to.
+ */
+inline void parse_vertices(const std::string_view text, ParsedPolygons& output) {
+	const char* position = text.data();
+	const char* const end = text.data() + text.size();
+	const auto skip_blanks = [&position, end]() {
+		while(position < end && (*position == ' ' || *position == '\t' || *position == '\r')) {
+			++position;
+		}
+	};
+	while(position < end) {
+		skip_blanks();
+		if(position < end && *position == '#') { //Comment. Skip the line.
+			while(position < end && *position != '\n') {
+				++position;
+			}
+		} else if(position >= end || *position == '\n') { //Blank line ends the polygon.
+			if(output.polygon_started()) {
+				output.end_polygon();
+			}
+		} else {
+			const coord_t x = parse_coordinate(position, end);
+			while(position < end && (*position == ' ' || *position == '\t' || *position == ',')) {
+				++position;
+			}
+			const coord_t y = parse_coordinate(position, end);
+			output.vertices.emplace_back(x, y);
+			while(position < end && *position != '\n') { //Ignore any further columns.
+				++position;
+			}
+		}
+		++position; //Skip the newline.
+	}
+	if(output.polygon_started()) {
+		output.end_polygon();
+	}
+}
+
+/*!
+ * The minimum amount of text to give to each thread when parsing in parallel.
+ */
+constexpr size_t parse_chunk_size = 1 << 20;
+
+/*!
+ * Parses text into polygons, in parallel for large texts.
+ *
+ * The text is split into parts, one for each thread. Each part starts at a
+ * boundary that the format allows to parse from. The vertices of each part are
+ * then concatenated into one buffer, which the resulting batch adopts.
+ * \tparam FindBoundary A function that finds the first position at or after a
+ * given position where parsing can start.
+ * \tparam Parse A function that parses a part of the text.
+ * \param text The text to parse.
+ * \param find_boundary The function to find where parsing can start.
+ * \param parse The function to parse a part of the text.
+ * \param resource The memory resource to allocate the vertices from.
+ * \return The parsed polygons.
+ */
+template<typename FindBoundary, typename Parse>
+Batch<Polygon> parse_parallel(const std::string_view text, FindBoundary find_boundary, Parse parse, std::pmr::memory_resource* resource) {
+	const size_t num_parts = std::max(size_t(1), std::min(static_cast<size_t>(omp_get_max_threads()), text.size() / parse_chunk_size));
+	std::vector<size_t> boundaries(num_parts + 1, text.size());
+	boundaries[0] = 0;
+	for(size_t part = 1; part < num_parts; ++part) {
+		boundaries[part] = std::max(boundaries[part - 1], find_boundary(text, text.size() / num_parts * part));
+	}
+
+	std::vector<ParsedPolygons> parts;
+	parts.reserve(num_parts);
+	for(size_t part = 0; part < num_parts; ++part) {
+		parts.emplace_back(resource); //Not copied from one instance, since copies would use the default memory resource.
+	}
+	std::vector<std::exception_ptr> errors(num_parts); //Exceptions can't leave a parallel region, so rethrow them afterwards.
+	#pragma omp parallel for schedule(static, 1)
+	for(size_t part = 0; part < num_parts; ++part) {
+		try {
+			const std::string_view part_text = text.substr(boundaries[part], boundaries[part + 1] - boundaries[part]);
+			parts[part].vertices.reserve(part_text.size() / 16); //A rough estimate of the space for each vertex, to reallocate less often.
+			parse(part_text, parts[part]);
+		} catch(...) {
+			errors[part] = std::current_exception();
+		}
+	}
+	for(const std::exception_ptr& error : errors) {
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+	if(num_parts == 1) {
+		return Batch<Polygon>(std::move(parts[0].vertices), parts[0].offsets);
+	}
+
+	//Concatenate all parts.
+	std::vector<size_t> vertex_starts(num_parts + 1, 0);
+	std::vector<size_t> offsets(1, 0);
+	for(size_t part = 0; part < num_parts; ++part) {
+		vertex_starts[part + 1] = vertex_starts[part] + parts[part].vertices.size();
+		for(size_t polygon = 1; polygon < parts[part].offsets.size(); ++polygon) {
+			offsets.push_back(vertex_starts[part] + parts[part].offsets[polygon]);
+		}
+	}
+	std::pmr::vector<Point2> vertices(vertex_starts[num_parts], resource);
+	#pragma omp parallel for schedule(static, 1)
+	for(size_t part = 0; part < num_parts; ++part) {
+		std::copy(parts[part].vertices.begin(), parts[part].vertices.end(), vertices.begin() + vertex_starts[part]);
+	}
+	return Batch<Polygon>(std::move(vertices), offsets);
+}
+
+/*!
+ * Finds the first tag at or after a position in an SVG document, to start
+ * parsing from there.
+ * \param svg The SVG document.
+ * \param position The position to start searching from.
+ * \return The position of the start of the tag, or the end of the document if
+ * there are no more tags.
+ */
+inline size_t find_svg_boundary(const std::string_view svg, const size_t position) {
+	return std::min(svg.find('<', position), svg.size());
+}
+
+/*!
+ * Finds the first blank line at or after a position in a list of vertices, to
+ * start parsing from there.
+ * \param text The list of vertices.
+ * \param position The position to start searching from.
+ * \return The position of the start of the blank line, or the end of the text
+ * if there are no more blank lines.
+ */
+inline size_t find_vertices_boundary(const std::string_view text, size_t position) {
+	while((position = text.find('\n', position)) != std::string_view::npos) {
+		++position;
+		size_t line_end = position;
+		while(line_end < text.size() && (text[line_end] == ' ' || text[line_end] == '\t' || text[line_end] == '\r')) {
+			++line_end;
+		}
+		if(line_end >= text.size() || text[line_end] == '\n') {
+			return position;
+		}
+	}
+	return text.size();
+}
+
+}
+
+/*!
+ * Loads the polygons in an SVG document.
+ *
+ * Each ``<polygon>`` element becomes one polygon, with the coordinates of its
+ * ``points`` attribute, even if it has no points. Each subpath of each ``<path>``
+ * element becomes one polygon too. Curves and arcs in paths are replaced by a
+ * straight line to their end point. Coordinates with decimals are rounded.
+ * Other elements are ignored, and no transformations or styles are applied.
+ *
+ * The vertices are parsed directly into the buffer of the resulting batch. The
+ * characters of the coordinates are processed 8 at a time with bitwise
+ * operations. Large documents are split into parts at the start of a tag,
+ * which are parsed in parallel.
+ * \param svg The contents of the SVG document.
+ * \param resource The memory resource to allocate the vertices from.
+ * \return The polygons in the document, in the order in which they appear.
+ */
+inline Batch<Polygon> load_svg(const std::string_view svg, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+	return detail::parse_parallel(svg, detail::find_svg_boundary, detail::parse_svg, resource);
+}
+
+/*!
+ * Loads the polygons in an SVG file.
+ *
+ * The file is mapped into memory and parsed from there, without reading it
+ * into a buffer first. See \ref load_svg for which elements are loaded.
+ * \param filename The SVG file to load.
+ * \param resource The memory resource to allocate the vertices from.
+ * \return The polygons in the file, in the order in which they appear.
+ */
+inline Batch<Polygon> load_svg_file(const std::filesystem::path& filename, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+	const detail::MappedFile file(filename);
+	file.advise_sequential();
+	return load_svg(std::string_view(file.data(), file.size()), resource);
+}
+
+/*!
+ * Loads polygons from a list of vertices.
+ *
+ * The list has one vertex on each line, with the X and Y coordinate separated
+ * by whitespace or a comma. Any further columns are ignored. Polygons are
+ * separated by one or more blank lines. Lines starting with ``#`` are comments.
+ * Coordinates with decimals are rounded.
+ *
+ * The vertices are parsed directly into the buffer of the resulting batch. The
+ * characters of the coordinates are processed 8 at a time with bitwise
+ * operations. Large lists are split into parts at a blank line, which are
+ * parsed in parallel.
+ * \param text The list of vertices.
+ * \param resource The memory resource to allocate the vertices from.
+ * \return The polygons in the list, in order.
+ */
+inline Batch<Polygon> load_vertices(const std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+	return detail::parse_parallel(text, detail::find_vertices_boundary, detail::parse_vertices, resource);
+}
+
+/*!
+ * Loads polygons from a file with a list of vertices.
+ *
+ * The file is mapped into memory and parsed from there, without reading it
+ * into a buffer first. See \ref load_vertices for the format of the file.
+ * \param filename The file to load.
+ * \param resource The memory resource to allocate the vertices from.
+ * \return The polygons in the file, in order.
+ */
+inline Batch<Polygon> load_vertices_file(const std::filesystem::path& filename, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+	const detail::MappedFile file(filename);
+	file.advise_sequential();
+	return load_vertices(std::string_view(file.data(), file.size()), resource);
+}
+
+}
+
+#endif //APEX_LOAD
\ No newline at end of file
@@ -0,0 +1,678 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_MAPPED_POLYGON_BATCH
+#define APEX_MAPPED_POLYGON_BATCH
+
+#include <cerrno> //To report why the file couldn't be written.
+#include <cstdint> //To give the fields of the file format a fixed size.
+#include <cstring> //For std::memcmp and std::memset.
+#include <filesystem> //To indicate which file to read or write.
+#include <fstream> //To write the file.
+#include <mutex> //To allow caching properties from multiple threads.
+#include <span> //To represent the polygons in the mapped memory.
+#include <stdexcept> //To report malformed files.
+#include <string> //To report which version of the file format is unsupported.
+#include <system_error> //To report failures to write the file.
+#include <type_traits> //To check that the records of the file can be used in-place.
+#include <utility> //For std::exchange.
+#include <vector> //To cache properties if the file doesn't store them.
+
+#include "detail/geometry_concepts.hpp" //To write any batch of polygons.
+#include "detail/mapped_file.hpp" //To map the file into memory.
+#include "detail/polygon_properties.hpp" //To store the cached properties in the file.
+#include "operations/area.hpp" //To allow calculating the area of the mapped polygons.
+#include "operations/self_intersections.hpp" //To allow finding self-intersections in the mapped polygons.
+#include "operations/translate.hpp" //To allow moving the mapped polygons.
+#include "point2.hpp" //The vertices of the polygons are 2D points.
+#include "polygon.hpp" //To write batches of polygons.
+
+namespace apex {
+
+/*!
+ * A batch of polygons that is read directly from a file, without copying.
+ *
+ * A ``Batch<Polygon>`` already stores all of its vertices in one buffer, with a
+ * table indicating where each polygon starts. The binary format of these files
+ * is a compacted version of that layout, so that the file can be mapped into
+ * memory and used as it is, without parsing or copying anything. Only the
+ * pages of the file that are actually accessed get read from disk.
+ *
+ * The format consists of the following sections, each starting at a multiple
+ * of 64 bytes so that the vertices are aligned for SIMD instructions:
+ * - A header, indicating the version of the format and where the other
+ * sections are, see \ref Header.
+ * - A table of offsets, with one 64-bit integer for each polygon indicating
+ * the index of its first vertex in the vertex section. The table ends with
+ * the total number of vertices, so that the size of each polygon is the
+ * difference with the next offset.
+ * - All vertices of all polygons, each as two 32-bit coordinates.
+ * - Optionally, the cached properties of each polygon, in the layout of
+ * ``PolygonProperties``. This way, what was computed about the polygons
+ * before writing them doesn't need to be computed again.
+ * All numbers are stored in the byte order of the processor that wrote them.
+ * Reading a file with a different byte order is refused.
+ *
+ * The mapping is private. Operations that modify the polygons, such as
+ * ``translate``, can be performed in-place. The modified pages are then copied
+ * into memory by the operating system, but the file itself is never changed.
+ * To store the modifications, write this batch to a new file.
+ *
+ * Like ``Batch<Polygon>``, this can be used with any of the operations on
+ * batches of polygons. The polygons in this batch are spans over the mapped
+ * vertices. The number of polygons and their sizes can't be changed. This batch
+ * is not tracked on the GPU, so operations on the GPU copy the vertices every
+ * time.
+ */
+class MappedPolygonBatch {
+public:
+	/*!
+	 * The version of the file format written by \ref write.
+	 *
+	 * Files with a different version are refused when mapping them, since
+	 * their layout may be different.
+	 */
+	static constexpr uint32_t version = 1;
+
+	/*!
+	 * Iterates over the polygons in the mapped batch.
+	 */
+	class const_iterator {
+	public:
+		/*!
+		 * Creates an iterator pointing to a polygon in a batch.
+		 * \param batch The batch to iterate over.
+		 * \param index The index of the polygon to point to.
+		 */
+		const_iterator(const MappedPolygonBatch& batch, const size_t index) : batch(&batch), index(index) {}
+
+		/*!
+		 * Gets the polygon that this iterator points to.
+		 * \return The vertices of the polygon.
+		 */
+		std::span<const Point2> operator *() const {
+			return (*batch)[index];
+		}
+
+		/*!
+		 * Moves the iterator to the next polygon.
+		 * \return This iterator, for chaining.
+		 */
+		const_iterator& operator ++() {
+			++index;
+			return *this;
+		}
+
+		/*!
+		 * Compares two iterators for equality.
+		 * \param other The iterator to compare with.
+		 * \return ``true`` if both iterators point to the same polygon of the
+		 * same batch, or ``false`` if they don't.
+		 */
+		bool operator ==(const const_iterator& other) const = default;
+
+	protected:
+		/*!
+		 * The batch that this iterator iterates over.
+		 */
+		const MappedPolygonBatch* batch;
+
+		/*!
+		 * The index of the polygon in the batch that this iterator points to.
+		 */
+		size_t index;
+	};
+
+	/*!
+	 * Writes a batch of polygons to a file in the binary format that can be
+	 * mapped into memory.
+	 *
+	 * The polygons are compacted while writing them, so any free space between
+	 * the polygons in the batch doesn't end up in the file.
+	 *
+	 * If the batch caches properties of its polygons, those are stored in the
+	 * file too, unless requested otherwise.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The batch of polygons to write.
+	 * \param filename The file to write the polygons to. If this file already
+	 * exists, it is overwritten.
+	 * \param with_properties Whether to store the cached properties of the
+	 * polygons in the file, if the batch caches them.
+	 */
+	template<multi_polygonal PolygonBatch>
+	static void write(const PolygonBatch& batch, const std::filesystem::path& filename, const bool with_properties = true) {
+		const size_t num_polygons = batch.size();
+		Header header;
+		std::memcpy(header.magic, magic, sizeof(magic));
+		header.version = version;
+		header.byte_order = byte_order;
+		header.flags = (with_properties && caches_batch_properties<PolygonBatch>) ? has_properties : 0;
+		header.num_polygons = num_polygons;
+		header.num_vertices = 0;
+		for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+			header.num_vertices += batch[polygon].size();
+		}
+		header.offsets_position = align(sizeof(Header));
+		header.vertices_position = align(header.offsets_position + (num_polygons + 1) * sizeof(uint64_t));
+		header.properties_position = (header.flags & has_properties) ? align(header.vertices_position + header.num_vertices * sizeof(Point2)) : 0;
+
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		if(!file) {
+			throw std::system_error(errno, std::generic_category(), "Couldn't open " + filename.string() + " for writing.");
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		pad(file, header.offsets_position);
+
+		uint64_t offset = 0;
+		for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+			file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+			offset += batch[polygon].size();
+		}
+		file.write(reinterpret_cast<const char*>(&offset), sizeof(offset)); //The table ends with the total number of vertices.
+		pad(file, header.vertices_position);
+
+		for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+			if(!batch[polygon].empty()) {
+				file.write(reinterpret_cast<const char*>(&batch[polygon][0]), batch[polygon].size() * sizeof(Point2));
+			}
+		}
+
+		if constexpr(caches_batch_properties<PolygonBatch>) {
+			if(header.flags & has_properties) {
+				pad(file, header.properties_position);
+				for(size_t polygon = 0; polygon < num_polygons; ++polygon) {
+					const PolygonProperties properties = batch.get_properties(polygon);
+					PolygonProperties record;
+					std::memset(static_cast<void*>(&record), 0, sizeof(record)); //Clear the padding, so that the same polygons always give the same file.
+					record.bitfield = properties.bitfield;
+					record.cached_area = properties.cached_area;
+					record.bounding_box_minimum = properties.bounding_box_minimum;
+					record.bounding_box_maximum = properties.bounding_box_maximum;
+					file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+				}
+			}
+		}
+
+		if(!file) {
+			throw std::system_error(errno, std::generic_category(), "Couldn't write to " + filename.string() + ".");
+		}
+	}
+
+	/*!
+	 * Maps a file written by \ref write into memory.
+	 *
+	 * The header and the offset table are validated, so that the polygons can't
+	 * point outside of the file. The vertices themselves are not read until
+	 * they are used.
+	 * \param filename The file to map.
+	 */
+	explicit MappedPolygonBatch(const std::filesystem::path& filename) : file(filename, true) { //Writable, so that the polygons can be modified in the private copy.
+		if(file.size() < sizeof(Header)) {
+			throw std::runtime_error(filename.string() + " is too small to be a batch of polygons.");
+		}
+		validate();
+		const Header& header = *reinterpret_cast<const Header*>(file.data());
+		num_polygons = header.num_polygons;
+		num_vertices = header.num_vertices;
+		offsets = reinterpret_cast<const uint64_t*>(file.data() + header.offsets_position);
+		vertices = reinterpret_cast<Point2*>(file.data() + header.vertices_position);
+		if(header.flags & has_properties) {
+			mapped_properties = reinterpret_cast<PolygonProperties*>(file.data() + header.properties_position);
+		}
+	}
+
+	/*!
+	 * The mapping can't be copied, since each mapping is unmapped when it is
+	 * destroyed.
+	 */
+	MappedPolygonBatch(const MappedPolygonBatch& original) = delete;
+
+	/*!
+	 * Moves the mapping to a new batch.
+	 *
+	 * The vertices stay in the same place in memory.
+	 * \param original The batch to take the mapping from.
+	 */
+	MappedPolygonBatch(MappedPolygonBatch&& original) noexcept :
+		file(std::move(original.file)),
+		num_polygons(std::exchange(original.num_polygons, 0)),
+		num_vertices(std::exchange(original.num_vertices, 0)),
+		offsets(std::exchange(original.offsets, &empty_offset)),
+		vertices(std::exchange(original.vertices, nullptr)),
+		mapped_properties(std::exchange(original.mapped_properties, nullptr)),
+		properties(std::move(original.properties)) {}
+
+	/*!
+	 * The mapping can't be copied, since each mapping is unmapped when it is
+	 * destroyed.
+	 * \param other The batch that would be copied.
+	 * \return A reference to this batch.
+	 */
+	MappedPolygonBatch& operator =(const MappedPolygonBatch& other) = delete;
+
+	/*!
+	 * Moves the mapping of another batch to this batch.
+	 *
+	 * The file that this batch mapped is unmapped first.
+	 * \param other The batch to take the mapping from.
+	 * \return A reference to this batch.
+	 */
+	MappedPolygonBatch& operator =(MappedPolygonBatch&& other) noexcept {
+		if(this != &other) {
+			file = std::move(other.file);
+			num_polygons = std::exchange(other.num_polygons, 0);
+			num_vertices = std::exchange(other.num_vertices, 0);
+			offsets = std::exchange(other.offsets, &empty_offset);
+			vertices = std::exchange(other.vertices, nullptr);
+			mapped_properties = std::exchange(other.mapped_properties, nullptr);
+			properties = std::move(other.properties);
+		}
+		return *this;
+	}
+
+	/*!
+	 * Gets one of the polygons in this batch.
+	 * \param index The index of the polygon to get.
+	 * \return The vertices of that polygon.
+	 */
+	std::span<const Point2> operator [](const size_t index) const {
+		return std::span<const Point2>(vertices + offsets[index], offsets[index + 1] - offsets[index]);
+	}
+
+	/*!
+	 * Gets one of the polygons in this batch, to modify its vertices.
+	 *
+	 * Since the vertices may be changed arbitrarily through the result, the
+	 * cached properties of this polygon are forgotten.
+	 * \param index The index of the polygon to get.
+	 * \return The vertices of that polygon.
+	 */
+	std::span<Point2> operator [](const size_t index) {
+		{
+			const std::lock_guard<std::mutex> lock(properties_mutex);
+			if(mapped_properties) {
+				mapped_properties[index].reset();
+			} else if(index < properties.size()) {
+				properties[index].reset();
+			}
+		}
+		return std::span<Point2>(vertices + offsets[index], offsets[index + 1] - offsets[index]);
+	}
+
+	/*!
+	 * Get an iterator to the first polygon in this batch.
+	 * \return An iterator to the first polygon.
+	 */
+	const_iterator begin() const {
+		return const_iterator(*this, 0);
+	}
+
+	/*!
+	 * Get an iterator past the last polygon in this batch.
+	 * \return An iterator past the last polygon.
+	 */
+	const_iterator end() const {
+		return const_iterator(*this, num_polygons);
+	}
+
+	/*!
+	 * Whether there are any polygons in this batch.
+	 * \return ``true`` if there are no polygons in this batch, or ``false`` if
+	 * there are.
+	 */
+	bool empty() const {
+		return num_polygons == 0;
+	}
+
+	/*!
+	 * Get the number of polygons in this batch.
+	 * \return The number of polygons.
+	 */
+	size_t size() const {
+		return num_polygons;
+	}
+
+	/*!
+	 * Get the vertices of all polygons in this batch, in the mapped memory.
+	 *
+	 * The vertices of the polygons are stored consecutively, without any
+	 * space in between.
+	 * \return A pointer to the first vertex of the first polygon.
+	 */
+	Point2* data_subelements() {
+		return vertices;
+	}
+
+	/*!
+	 * Get the vertices of all polygons in this batch, in the mapped memory.
+	 *
+	 * The vertices of the polygons are stored consecutively, without any
+	 * space in between.
+	 * \return A pointer to the first vertex of the first polygon.
+	 */
+	const Point2* data_subelements() const {
+		return vertices;
+	}
+
+	/*!
+	 * Get the total number of vertices in all polygons of this batch.
+	 * \return The total number of vertices.
+	 */
+	size_t size_subelements() const {
+		return num_vertices;
+	}
+
+	/*!
+	 * Whether the file stores the cached properties of the polygons.
+	 *
+	 * If it does, properties computed for the polygons are cached in the mapped
+	 * memory. Otherwise they are cached separately, in the same way as for
+	 * ``Batch<Polygon>``.
+	 * \return ``true`` if the properties are mapped from the file, or ``false``
+	 * if they aren't.
+	 */
+	bool has_mapped_properties() const {
+		return mapped_properties != nullptr;
+	}
+
+	/*!
+	 * Get the properties that are currently known about one of the polygons in
+	 * this batch.
+	 *
+	 * Operations use this to skip computations of which the result is already
+	 * known.
+	 * \param index The index of the polygon to get the properties of.
+	 * \return The cached properties of that polygon.
+	 */
+	PolygonProperties get_properties(const size_t index) const {
+		const std::lock_guard<std::mutex> lock(properties_mutex);
+		if(mapped_properties) {
+			return mapped_properties[index];
+		}
+		if(index >= properties.size()) { //Nothing is known about the polygons yet.
+			return PolygonProperties();
+		}
+		return properties[index];
+	}
+
+	/*!
+	 * Store properties that were computed about one of the polygons in this
+	 * batch.
+	 *
+	 * Since the properties are only a cache, this may also be called on a
+	 * constant batch, also by multiple threads at the same time. If the
+	 * properties are mapped from the file, this only changes the private copy
+	 * in memory, not the file.
+	 * \param index The index of the polygon to store the properties of.
+	 * \param new_properties The properties that are now known about that
+	 * polygon.
+	 */
+	void set_properties(const size_t index, const PolygonProperties& new_properties) const {
+		const std::lock_guard<std::mutex> lock(properties_mutex); //Filling in the cache reallocates it, which must not happen while other threads read it.
+		if(mapped_properties) {
+			mapped_properties[index] = new_properties;
+			return;
+		}
+		if(properties.size() != size()) { //Nothing is known about the polygons yet.
+			properties.assign(size(), PolygonProperties());
+		}
+		properties[index] = new_properties;
+	}
+
+	/*!
+	 * Update the cached properties of all polygons in this batch after they
+	 * were all moved by the same distance.
+	 *
+	 * This updates all of them at once, rather than getting and setting the
+	 * properties of each polygon in turn. If nothing is cached about the
+	 * polygons, nothing needs to be updated.
+	 * \param delta The distance by which the polygons were moved.
+	 */
+	void translate_properties(const Point2& delta) {
+		const std::lock_guard<std::mutex> lock(properties_mutex);
+		if(mapped_properties) {
+			for(size_t polygon = 0; polygon < size(); ++polygon) {
+				if(mapped_properties[polygon].has_bounding_box()) {
+					mapped_properties[polygon].translate(delta);
+				}
+			}
+			return;
+		}
+		for(PolygonProperties& polygon_properties : properties) {
+			if(polygon_properties.has_bounding_box()) {
+				polygon_properties.translate(delta);
+			}
+		}
+	}
+
+	/*!
+	 * Computes the surface area of the polygons in this batch.
+	 *
+	 * See ``Batch<Polygon>::area`` for details.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the areas of each polygon in the same order.
+	 */
+	Batch<area_t> area() const {
+		return apex::area(*this);
+	}
+
+	/*!
+	 * Finds all self-intersections in each polygon of this batch.
+	 * \return For each polygon, a batch of the self-intersections in that
+	 * polygon, in the same order as the polygons in this batch.
+	 */
+	Batch<Batch<PolygonSelfIntersection>> self_intersections() const {
+		return apex::self_intersections(*this);
+	}
+
+	/*!
+	 * Moves all polygons in this batch with the same offset.
+	 *
+	 * The polygons are moved in-place, in the private copy of the mapped
+	 * memory.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 */
+	void translate(const Point2& delta) {
+		apex::translate(*this, delta);
+	}
+
+protected:
+	/*!
+	 * The header at the start of each file, describing the rest of the file.
+	 */
+	struct Header {
+		/*!
+		 * Identifies the file as a batch of polygons.
+		 */
+		char magic[8];
+
+		/*!
+		 * The version of the format of the file.
+		 */
+		uint32_t version;
+
+		/*!
+		 * A known constant, to detect whether the file was written with a
+		 * different byte order.
+		 */
+		uint32_t byte_order;
+
+		/*!
+		 * Which optional sections are in the file.
+		 */
+		uint64_t flags;
+
+		/*!
+		 * The number of polygons in the file.
+		 */
+		uint64_t num_polygons;
+
+		/*!
+		 * The total number of vertices of all polygons in the file.
+		 */
+		uint64_t num_vertices;
+
+		/*!
+		 * Where the offset table starts, in bytes from the start of the file.
+		 */
+		uint64_t offsets_position;
+
+		/*!
+		 * Where the vertices start, in bytes from the start of the file.
+		 */
+		uint64_t vertices_position;
+
+		/*!
+		 * Where the properties start, in bytes from the start of the file.
+		 *
+		 * Only valid if the file has properties.
+		 */
+		uint64_t properties_position;
+	};
+
+	//The file is used as it is in memory, so the types in it must have a fixed layout.
+	static_assert(sizeof(Header) == 64, "The header must fill exactly one aligned block.");
+	static_assert(sizeof(Point2) == 2 * sizeof(int32_t) && std::is_trivially_copyable_v<Point2>, "Vertices are stored as two 32-bit coordinates.");
+	static_assert(sizeof(PolygonProperties) == 32 && std::is_trivially_copyable_v<PolygonProperties>, "The properties are stored in their layout in memory.");
+
+	/*!
+	 * The first bytes of each file, to identify it as a batch of polygons.
+	 */
+	static constexpr char magic[8] = {'A', 'P', 'E', 'X', 'P', 'O', 'L', 'Y'};
+
+	/*!
+	 * The constant stored in the header to detect the byte order.
+	 */
+	static constexpr uint32_t byte_order = 0x01020304;
+
+	/*!
+	 * The flag indicating that the file stores the properties of the polygons.
+	 */
+	static constexpr uint64_t has_properties = 1;
+
+	/*!
+	 * Each section of the file starts at a multiple of this many bytes.
+	 */
+	static constexpr uint64_t alignment = 64;
+
+	/*!
+	 * The offset table of a batch without any mapped file, so that its size
+	 * can still be computed.
+	 */
+	static constexpr uint64_t empty_offset = 0;
+
+	/*!
+	 * The mapped file.
+	 */
+	detail::MappedFile file;
+
+	/*!
+	 * The number of polygons in the batch.
+	 */
+	size_t num_polygons = 0;
+
+	/*!
+	 * The total number of vertices in the batch.
+	 */
+	size_t num_vertices = 0;
+
+	/*!
+	 * The offset table in the mapped memory.
+	 */
+	const uint64_t* offsets = &empty_offset;
+
+	/*!
+	 * The vertices in the mapped memory.
+	 */
+	Point2* vertices = nullptr;
+
+	/*!
+	 * The properties of the polygons in the mapped memory, or ``nullptr`` if
+	 * the file doesn't store them.
+	 */
+	PolygonProperties* mapped_properties = nullptr;
+
+	/*!
+	 * The cached properties of the polygons, if the file doesn't store them.
+	 *
+	 * This is empty until they are computed.
+	 */
+	mutable std::vector<PolygonProperties> properties;
+
+	/*!
+	 * Guards the cached properties while they are read or filled in through a
+	 * constant batch.
+	 */
+	mutable std::mutex properties_mutex;
+
+	/*!
+	 * Rounds a position in the file up to the start of the next section.
+	 * \param position The position to round up.
+	 * \return The first position at or after the given position where a
+	 * section may start.
+	 */
+	static constexpr uint64_t align(const uint64_t position) {
+		return (position + alignment - 1) / alignment * alignment;
+	}
+
+	/*!
+	 * Writes zeroes to a file until a certain position is reached.
+	 * \param file The file to write to.
+	 * \param position The position in the file to pad up to.
+	 */
+	static void pad(std::ofstream& file, const uint64_t position) {
+		const char zeroes[alignment] = {};
+		file.write(zeroes, position - static_cast<uint64_t>(file.tellp()));
+	}
+
+	/*!
+	 * Checks that the mapped memory contains a batch of polygons that this
+	 * version can read, and that none of its sections point outside of the
+	 * file.
+	 */
+	void validate() const {
+		const Header& header = *reinterpret_cast<const Header*>(file.data());
+		const size_t mapping_size = file.size();
+		if(std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+			throw std::runtime_error("The file is not a batch of polygons.");
+		}
+		if(header.byte_order != byte_order) {
+			throw std::runtime_error("The file was written with a different byte order.");
+		}
+		if(header.version != version) {
+			throw std::runtime_error("Unsupported version of the file format: " + std::to_string(header.version) + ".");
+		}
+		//Check the sizes of the sections in a way that can't overflow.
+		const uint64_t max_elements = mapping_size / sizeof(uint64_t);
+		if(header.num_polygons >= max_elements || header.num_vertices >= max_elements
+				|| header.offsets_position % alignment != 0 || header.vertices_position % alignment != 0
+				|| header.offsets_position > mapping_size || (header.num_polygons + 1) * sizeof(uint64_t) > mapping_size - header.offsets_position
+				|| header.vertices_position > mapping_size || header.num_vertices * sizeof(Point2) > mapping_size - header.vertices_position) {
+			throw std::runtime_error("The sections of the file don't fit in the file.");
+		}
+		if(header.flags & has_properties) {
+			if(header.properties_position % alignment != 0 || header.properties_position > mapping_size || header.num_polygons * sizeof(PolygonProperties) > mapping_size - header.properties_position) {
+				throw std::runtime_error("The properties don't fit in the file.");
+			}
+		}
+		const uint64_t* table = reinterpret_cast<const uint64_t*>(file.data() + header.offsets_position);
+		if(table[0] != 0 || table[header.num_polygons] != header.num_vertices) {
+			throw std::runtime_error("The offset table doesn't cover all vertices.");
+		}
+		for(size_t polygon = 0; polygon < header.num_polygons; ++polygon) {
+			if(table[polygon] > table[polygon + 1]) {
+				throw std::runtime_error("The offset table is not in order.");
+			}
+		}
+	}
+};
+
+}
+
+#endif //APEX_MAPPED_POLYGON_BATCH
\ No newline at end of file
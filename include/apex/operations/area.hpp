@@ -9,12 +9,22 @@
 #ifndef APEX_AREA
 #define APEX_AREA
 
+#include <algorithm> //For std::min.
+#include <memory> //To keep the results of asynchronous operations at a fixed address.
 #include <omp.h> //To do parallel processing.
 #include <vector> //Returning the results of batch operations.
 
 #include "../batch.hpp" //To return batches of areas.
 #include "../coordinate.hpp" //To return area_t.
+#include "../detail/fixed_size.hpp" //To unroll the loops over the vertices of fixed-size polygons.
 #include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
+#include "../detail/polygon_properties.hpp" //To cache the area of polygons.
+#include "../detail/scheduler.hpp" //To divide the vertices of batches over the threads.
+#include "../detail/simd_dispatch.hpp" //To compile the SIMD kernels for multiple instruction sets.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../gpu_future.hpp" //To return the results of asynchronous operations.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
 #include "../point2.hpp" //To access coordinates of vertices.
 
 namespace apex {
@@ -22,6 +32,12 @@ namespace apex {
 namespace detail {
 
 //Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+area_t area_uncached(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<area_t> area_uncached(const PolygonBatch& batch);
+
 template<polygonal Polygon>
 area_t area_st(const Polygon& polygon);
 
@@ -34,12 +50,64 @@ area_t area_mt(const Polygon& polygon);
 template<multi_polygonal PolygonBatch>
 Batch<area_t> area_mt(const PolygonBatch&);
 
+template<polygonal Polygon>
+area_t area_simd(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<area_t> area_simd(const PolygonBatch&);
+
 #ifdef GPU
 template<polygonal Polygon>
 area_t area_gpu(const Polygon& polygon);
 
 template<multi_polygonal PolygonBatch>
 Batch<area_t> area_gpu(const PolygonBatch&);
+
+template<polygonal Polygon>
+GPUFuture<area_t> area_gpu_async(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+GPUFuture<Batch<area_t>> area_gpu_async(const PolygonBatch&);
+#endif //GPU
+
+template<soa_polygonal Polygon>
+area_t area_st(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_st(const PolygonBatch&);
+
+template<soa_polygonal Polygon>
+area_t area_mt(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_mt(const PolygonBatch&);
+
+template<soa_polygonal Polygon>
+area_t area_simd(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_simd(const PolygonBatch&);
+
+#ifdef GPU
+template<soa_polygonal Polygon>
+area_t area_gpu(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_gpu(const PolygonBatch&);
+#endif //GPU
+
+template<fixed_polygonal Polygon>
+area_t area_st(const Polygon& polygon);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_st(const PolygonBatch&);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_mt(const PolygonBatch&);
+
+#ifdef GPU
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_gpu(const PolygonBatch&);
 #endif //GPU
 
 };
@@ -61,15 +129,15 @@ Batch<area_t> area_gpu(const PolygonBatch&);
  */
 template<polygonal Polygon>
 area_t area(const Polygon& polygon) {
-	if(polygon.size() < 400) {
-		return detail::area_st(polygon);
-	}
-#ifdef GPU
-	if(polygon.size() >= 3000) {
-		return detail::area_gpu(polygon);
+	if constexpr(caches_properties<Polygon>) {
+		PolygonProperties properties = polygon.get_properties();
+		if(!properties.has_area()) {
+			properties.set_area(detail::area_uncached(polygon));
+			polygon.set_properties(properties);
+		}
+		return properties.area();
 	}
-#endif //GPU
-	return detail::area_mt(polygon);
+	return detail::area_uncached(polygon);
 }
 
 /*!
@@ -90,15 +158,230 @@ area_t area(const Polygon& polygon) {
  */
 template<multi_polygonal PolygonBatch>
 Batch<area_t> area(const PolygonBatch& batch) {
-	if(batch.size() + batch.size_subelements() < 200) {
-		return detail::area_st(batch);
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		Batch<area_t> result;
+		result.reserve(batch.size());
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const PolygonProperties properties = batch.get_properties(polygon);
+			if(!properties.has_area()) {
+				break; //Computing the areas of the whole batch at once is more efficient than computing the missing ones separately.
+			}
+			result.push_back(properties.area());
+		}
+		if(result.size() == batch.size()) {
+			return result;
+		}
+		result = detail::area_uncached(batch);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			PolygonProperties properties = batch.get_properties(polygon);
+			properties.set_area(result[polygon]);
+			batch.set_properties(polygon, properties);
+		}
+		return result;
+	}
+	return detail::area_uncached(batch);
+}
+
+/*!
+ * Computes the surface area of a polygon that stores its vertices as a
+ * structure of arrays.
+ *
+ * The result is the same as for polygons that store their vertices as arrays
+ * of points. However the coordinates can be loaded contiguously, which allows
+ * the computation to be fully vectorised.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<soa_polygonal Polygon>
+area_t area(const Polygon& polygon) {
+	const detail::Dispatch dispatch(detail::Operation::area_soa, polygon.size());
+	switch(dispatch.version) {
+		case 0: return detail::area_st(polygon);
+		case 1: return detail::area_mt(polygon);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::area_gpu(polygon);
+		}
+#endif //GPU
+	}
+	return detail::area_mt(polygon);
+}
+
+/*!
+ * Computes the surface areas of each polygon in a batch that stores its
+ * vertices as a structure of arrays.
+ *
+ * The result is the same as for batches that store their vertices as arrays of
+ * points. However the coordinates can be loaded contiguously, which allows the
+ * computation to be fully vectorised.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch A batch of polygons to calculate the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area(const PolygonBatch& batch) {
+	const detail::Dispatch dispatch(detail::Operation::area_soa_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::area_st(batch);
+		case 1: return detail::area_mt(batch);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::area_gpu(batch);
+		}
+#endif //GPU
 	}
 	return detail::area_mt(batch);
-	//Currently, there doesn't seem to be a case where the GPU is faster in this algorithm.
 }
 
+/*!
+ * Computes the surface area of a polygon with a fixed number of vertices.
+ *
+ * The result is the same as for other polygons. However the number of vertices
+ * is known at compile time, so the computation is completely unrolled, without
+ * a loop or a modulo operation to find the previous vertex. Since the number of
+ * vertices is small, this always uses the single-threaded implementation.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<fixed_polygonal Polygon>
+area_t area(const Polygon& polygon) {
+	return detail::area_st(polygon);
+}
+
+/*!
+ * Computes the surface areas of each polygon in a batch of polygons with a
+ * fixed number of vertices.
+ *
+ * The result is the same as for other batches. However each polygon starts at
+ * a fixed stride in the vertex array, so each lane of the vector registers can
+ * compute the area of a different polygon, with the loop over the vertices
+ * unrolled at compile time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch A batch of polygons to calculate the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area(const PolygonBatch& batch) {
+	const detail::Dispatch dispatch(detail::Operation::area_fixed_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::area_st(batch);
+		case 1: return detail::area_mt(batch);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::area_gpu(batch);
+		}
+#endif //GPU
+	}
+	return detail::area_mt(batch);
+}
+
+#ifdef GPU
+/*!
+ * Computes the surface area of a polygon on the GPU, without waiting for the
+ * result.
+ *
+ * The computation is queued on the GPU, and this returns immediately. The host
+ * can do other work in the meanwhile, and retrieve the area from the returned
+ * handle once it is needed. Operations on the GPU that are queued later on the
+ * same polygon are executed after this one.
+ *
+ * The polygon must not be destroyed until the result is available. Modifying
+ * it on the host is only safe if it is tracked by the ``GPUDataTracker``, which
+ * waits for the computation to complete before the vertices can be modified.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to calculate the area of.
+ * \return A handle to the surface area of the polygon.
+ */
+template<polygonal Polygon>
+GPUFuture<area_t> area_async(const Polygon& polygon) {
+	return detail::area_gpu_async(polygon);
+}
+
+/*!
+ * Computes the surface areas of each polygon in a batch on the GPU, without
+ * waiting for the results.
+ *
+ * The computation is queued on the GPU, and this returns immediately. The host
+ * can do other work in the meanwhile, such as preparing the next batch. If an
+ * operation is queued on the next batch before the result of this one is
+ * retrieved, its vertices are transferred to the GPU while this batch is still
+ * being processed. Operations on the GPU that are queued later on the same
+ * batch are executed after this one.
+ *
+ * The batch must not be destroyed until the result is available. Modifying it
+ * on the host is only safe if it is tracked by the ``GPUDataTracker``, which
+ * waits for the computation to complete before the vertices can be modified.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to calculate the areas of.
+ * \return A handle to a list of areas, one for each polygon, in the same order
+ * as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+GPUFuture<Batch<area_t>> area_async(const PolygonBatch& batch) {
+	return detail::area_gpu_async(batch);
+}
+#endif //GPU
+
 namespace detail {
 
+/*!
+ * Computes the surface area of a polygon with the fastest version of ``area``,
+ * regardless of what is cached about the polygon.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<polygonal Polygon>
+area_t area_uncached(const Polygon& polygon) {
+	const Dispatch dispatch(Operation::area, polygon.size());
+	switch(dispatch.version) {
+		case 0: return area_st(polygon);
+		case 1: return area_mt(polygon);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return area_gpu(polygon);
+		}
+#endif //GPU
+	}
+	return area_mt(polygon);
+}
+
+/*!
+ * Computes the surface areas of each polygon in a batch with the fastest
+ * version of ``area``, regardless of what is cached about the polygons.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to calculate the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<area_t> area_uncached(const PolygonBatch& batch) {
+	const Dispatch dispatch(Operation::area_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return area_st(batch);
+		case 1: return area_mt(batch);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return area_gpu(batch);
+		}
+#endif //GPU
+	}
+	return area_mt(batch);
+}
+
 /*!
  * Single-threaded implementation of ``area``.
  *
@@ -232,6 +515,42 @@ area_t area_mt(const Polygon& polygon) {
 	return area / 2;
 }
 
+/*!
+ * Computes part of the shoelace sum of a polygon with SIMD instructions.
+ *
+ * Only the edges ending in the vertices from ``begin`` up to ``end`` are
+ * summed. Each edge runs from the previous vertex to that vertex, so the edge
+ * ending in vertex 0 is the closing edge from the last vertex. This closing
+ * edge is handled separately. That way the rest of the loop only accesses
+ * consecutive vertices, without the modulo operation that prevents vectorising.
+ * The coordinates are widened to ``area_t`` before multiplying, so the products
+ * can't overflow.
+ *
+ * Summing the ranges of any partition of the vertices gives the shoelace sum of
+ * the entire polygon.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \param size The number of vertices in the polygon.
+ * \param begin The first vertex of the range to sum.
+ * \param end The vertex past the last vertex of the range to sum.
+ * \return Twice the surface area contributed by the edges in the range.
+ */
+APEX_SIMD_CLONES inline area_t area_simd_shoelace(const Point2* vertices, const size_t size, size_t begin, const size_t end) {
+	area_t area = 0;
+	if(begin == 0 && end > 0) {
+		area = static_cast<area_t>(vertices[size - 1].x) * vertices[0].y - static_cast<area_t>(vertices[size - 1].y) * vertices[0].x; //The closing edge.
+		begin = 1;
+	}
+	#pragma omp simd reduction(+:area)
+	for(size_t vertex = begin; vertex < end; ++vertex) {
+		area += static_cast<area_t>(vertices[vertex - 1].x) * vertices[vertex].y - static_cast<area_t>(vertices[vertex - 1].y) * vertices[vertex].x;
+	}
+	return area;
+}
+
 /*!
  * Multi-threaded implementation of ``area``.
  *
@@ -271,10 +590,17 @@ area_t area_mt(const Polygon& polygon) {
  * arrive at the area of the triangle. The surface area of a polygon is the sum
  * of all of these triangles. This is the shoelace formula.
  *
- * In this implementation, the areas of these parallelograms are calculated in
- * parallel. This is summed with a parallel reduction, to produce the area of
- * the complete polygon. This is repeated in parallel for each polygon in the
- * batch.
+ * In this implementation, the vertices of all polygons are processed in one
+ * flat pass, as if they were one long list, rather than processing the
+ * polygons one by one. The ``Scheduler`` divides this list into tasks of equal
+ * size, which are processed in parallel. Each task sums the parallelograms in
+ * the parts of the polygons that overlap with it. This is a segmented
+ * reduction. Polygons that are split over multiple tasks get the partial sums
+ * of each task added together. This way the work is
+ * balanced evenly between the threads, even if the polygons differ a lot in
+ * size. Small polygons don't each need their own parallel loop, and each
+ * thread reads a contiguous part of the vertex buffer, which works well with
+ * the caches.
  * \tparam PolygonBatch A class that behaves like a batch of polygons.
  * \param batch The batch of polygons to calculate the areas of.
  * \return A list of areas, one for each polygon, in the same order as the order
@@ -282,22 +608,72 @@ area_t area_mt(const Polygon& polygon) {
  */
 template<multi_polygonal PolygonBatch>
 Batch<area_t> area_mt(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
 	Batch<area_t> result;
-	result.resize(batch.size()); //Resize, so that all threads can enter their data in parallel.
+	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
+	area_t* result_data = result.data();
 
-	#pragma omp parallel for
-	for(size_t polygon_index = 0; polygon_index < batch.size(); ++polygon_index) {
-		area_t area = 0;
-		const auto& polygon = batch[polygon_index]; //Instantiates auto with whatever type the batch indexes.
-		const size_t size = polygon.size();
+	const Point2* vertices = batch.data_subelements();
+	const VertexRanges ranges(batch);
 
-		//While task loops may be more efficient in this case, they cause segfaults with GCC when the loop is empty.
-		#pragma omp parallel for simd reduction(+:area)
-		for(size_t vertex = 0; vertex < size; ++vertex) {
-			size_t previous = (vertex - 1 + size) % size;
-			area += static_cast<area_t>(polygon[previous].x) * polygon[vertex].y - static_cast<area_t>(polygon[previous].y) * polygon[vertex].x;
+	Scheduler::for_each_range(ranges.offsets, [&](const size_t polygon, const size_t begin, const size_t end) {
+		const size_t size = ranges.size(polygon);
+		const area_t partial_area = area_simd_shoelace(vertices + ranges.starts[polygon], size, begin, end);
+		if(begin == 0 && end == size) { //Polygon lies completely within this task, so no other thread writes to it.
+			result_data[polygon] = partial_area;
+		} else {
+			#pragma omp atomic
+			result_data[polygon] += partial_area;
+		}
+	});
+
+	Scheduler::for_each_block(batch_size, [&](const size_t begin, const size_t end) {
+		#pragma omp simd
+		for(size_t polygon = begin; polygon < end; ++polygon) {
+			result_data[polygon] /= 2; //Instead of dividing each triangle's area by 2, divide the totals by 2 afterwards.
 		}
-		result[polygon_index] = area / 2;
+	});
+	return result;
+}
+
+/*!
+ * Single-threaded implementation of ``area`` that uses SIMD instructions.
+ *
+ * This uses the shoelace formula like the other implementations. The loop over
+ * the vertices is written such that the compiler can vectorise it, and compiled
+ * for multiple instruction sets so that the widest vector registers of the
+ * processor get used.
+ *
+ * The vertices of the polygon must be stored contiguously in memory, like they
+ * are in a ``Polygon`` and in the polygons of a ``Batch<Polygon>``.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<polygonal Polygon>
+area_t area_simd(const Polygon& polygon) {
+	if(polygon.size() == 0) {
+		return 0;
+	}
+	return area_simd_shoelace(&polygon[0], polygon.size(), 0, polygon.size()) / 2;
+}
+
+/*!
+ * Single-threaded implementation of ``area`` that uses SIMD instructions.
+ *
+ * This computes the area of each polygon in the batch in sequence, but
+ * vectorises the computation within each polygon.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<area_t> area_simd(const PolygonBatch& batch) {
+	Batch<area_t> result;
+	result.reserve(batch.size());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result.push_back(detail::area_simd(batch[polygon]));
 	}
 	return result;
 }
@@ -354,6 +730,9 @@ area_t area_gpu(const Polygon& polygon) {
 	area_t area = 0;
 	const size_t size = polygon.size();
 	const Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Leave the vertices on the GPU for subsequent operations.
+	}
 	#pragma omp target teams distribute parallel for map(to:vertices[0:size]) map(tofrom:area) reduction(+:area)
 	for(size_t vertex = 0; vertex < size; ++vertex) {
 		size_t previous = (vertex - 1 + size) % size;
@@ -417,10 +796,106 @@ Batch<area_t> area_gpu(const PolygonBatch& batch) {
 	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
 	area_t* result_data = result.data();
 
-	const Subbatch<Point2>* polygons = batch.data();
+	//Find where each polygon is in the vertex buffer on the host, so that the GPU only needs plain arrays.
 	const Point2* vertices = batch.data_subelements();
 	const size_t vertices_size = batch.size_subelements();
-	#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size]) map(to:polygons[0:batch_size]) map(from:result_data[0:batch_size])
+	std::vector<size_t> starts_vector(batch_size);
+	std::vector<size_t> sizes_vector(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		starts_vector[polygon] = batch[polygon].empty() ? 0 : &batch[polygon][0] - vertices;
+		sizes_vector[polygon] = batch[polygon].size();
+	}
+	const size_t* starts = starts_vector.data();
+	const size_t* sizes = sizes_vector.data();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Leave the vertices on the GPU for subsequent operations.
+	}
+	#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size]) map(to:starts[0:batch_size]) map(to:sizes[0:batch_size]) map(from:result_data[0:batch_size])
+	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
+		area_t area = 0;
+		const Point2* polygon = vertices + starts[polygon_index];
+		const size_t size = sizes[polygon_index];
+
+		//On the GPU we'll spawn new threads for each sub-loop too.
+		#pragma omp parallel for reduction(+:area)
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			size_t previous = (vertex - 1 + size) % size;
+			area += static_cast<area_t>(polygon[previous].x) * polygon[vertex].y - static_cast<area_t>(polygon[previous].y) * polygon[vertex].x;
+		}
+		result_data[polygon_index] = area / 2;
+	}
+	return result;
+}
+
+/*!
+ * Asynchronous implementation of ``area`` that runs on the graphics card, if
+ * available.
+ *
+ * This computes the same sum as ``area_gpu``, but the target region is queued
+ * as a deferred task instead of waiting for it to complete. The task depends on
+ * the vertices, so that it runs after any transfers and after any operations
+ * on the GPU that were queued on the same polygon earlier. The result is
+ * reduced into storage owned by the returned handle, and only divided by two
+ * once it is retrieved.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to calculate the area of.
+ * \return A handle to the surface area of the polygon.
+ */
+template<polygonal Polygon>
+GPUFuture<area_t> area_gpu_async(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return GPUFuture<area_t>(0);
+	}
+	std::unique_ptr<area_t> result = std::make_unique<area_t>(0);
+	area_t* area = result.get();
+	const Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon, true); //Queue the transfer, so that it happens in the background as well.
+	}
+	#pragma omp target teams distribute parallel for map(to:vertices[0:size]) map(tofrom:area[0:1]) reduction(+:area[0:1]) nowait depend(in:vertices[0]) depend(out:area[0])
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		size_t previous = (vertex - 1 + size) % size;
+		area[0] += static_cast<area_t>(vertices[previous].x) * vertices[vertex].y - static_cast<area_t>(vertices[previous].y) * vertices[vertex].x;
+	}
+	return GPUFuture<area_t>(std::move(result), area, [](area_t& area) {
+		area /= 2;
+	});
+}
+
+/*!
+ * Asynchronous implementation of ``area`` that runs on the graphics card, if
+ * available, for batches of polygons.
+ *
+ * This computes the same areas as ``area_gpu``, but the target region is queued
+ * as a deferred task instead of waiting for it to complete. The task depends on
+ * the vertices, so that it runs after any transfers and after any operations
+ * on the GPU that were queued on the same batch earlier. The results are
+ * written to storage owned by the returned handle.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to calculate the areas of.
+ * \return A handle to a list of areas, one for each polygon, in the same order
+ * as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+GPUFuture<Batch<area_t>> area_gpu_async(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	const size_t vertices_size = batch.size_subelements();
+	if(batch_size == 0 || vertices_size == 0) { //Nothing to compute, so all areas are 0.
+		Batch<area_t> result;
+		result.resize(batch_size);
+		return GPUFuture<Batch<area_t>>(std::move(result));
+	}
+	std::unique_ptr<Batch<area_t>> result = std::make_unique<Batch<area_t>>();
+	result->resize(batch_size);
+	area_t* result_data = result->data();
+
+	const Subbatch<Point2>* polygons = batch.data();
+	const Point2* vertices = batch.data_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch, true); //Queue the transfer, so that it overlaps with other work on the GPU.
+	}
+	#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size]) map(to:polygons[0:batch_size]) map(from:result_data[0:batch_size]) nowait depend(in:vertices[0]) depend(out:result_data[0])
 	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
 		area_t area = 0;
 		const auto& polygon = polygons[polygon_index];
@@ -434,6 +909,374 @@ Batch<area_t> area_gpu(const PolygonBatch& batch) {
 		}
 		result_data[polygon_index] = area / 2;
 	}
+	return GPUFuture<Batch<area_t>>(std::move(result), result_data);
+}
+#endif //GPU
+
+/*!
+ * Computes the shoelace sum of a range of vertices stored as a structure of
+ * arrays, with SIMD instructions.
+ *
+ * This computes the same sum as the other implementations of ``area``, but the
+ * closing edge from the last vertex to the first is handled separately. That
+ * way the rest of the loop only accesses consecutive coordinates, without the
+ * modulo operation that prevents vectorising, so that the coordinates can be
+ * loaded into vector registers directly.
+ * \param x The X coordinates of the vertices.
+ * \param y The Y coordinates of the vertices.
+ * \param size The number of vertices.
+ * \return Twice the surface area of the polygon formed by the vertices.
+ */
+APEX_SIMD_CLONES inline area_t area_soa_shoelace(const coord_t* x, const coord_t* y, const size_t size) {
+	if(size == 0) {
+		return 0;
+	}
+	area_t area = static_cast<area_t>(x[size - 1]) * y[0] - static_cast<area_t>(y[size - 1]) * x[0]; //The closing edge.
+	#pragma omp simd reduction(+:area)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		area += static_cast<area_t>(x[vertex - 1]) * y[vertex] - static_cast<area_t>(y[vertex - 1]) * x[vertex];
+	}
+	return area;
+}
+
+/*!
+ * Single-threaded implementation of ``area`` for polygons that store their
+ * vertices as a structure of arrays.
+ *
+ * This uses the shoelace formula like the other implementations, but loads the
+ * coordinates contiguously so that the sum is computed with SIMD instructions.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<soa_polygonal Polygon>
+area_t area_st(const Polygon& polygon) {
+	return area_soa_shoelace(polygon.data_x(), polygon.data_y(), polygon.size()) / 2;
+}
+
+/*!
+ * Single-threaded implementation of ``area`` for batches of polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This computes the area of each polygon in turn, with SIMD instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_st(const PolygonBatch& batch) {
+	Batch<area_t> result;
+	result.resize(batch.size());
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result[polygon] = area_soa_shoelace(x + starts[polygon], y + starts[polygon], starts[polygon + 1] - starts[polygon]) / 2;
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``area`` for polygons that store their
+ * vertices as a structure of arrays.
+ *
+ * This uses the shoelace formula like the other implementations. The vertices
+ * are divided over the threads, and each thread sums its part with SIMD
+ * instructions.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<soa_polygonal Polygon>
+area_t area_mt(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return 0;
+	}
+	const coord_t* x = polygon.data_x();
+	const coord_t* y = polygon.data_y();
+	area_t area = static_cast<area_t>(x[size - 1]) * y[0] - static_cast<area_t>(y[size - 1]) * x[0]; //The closing edge.
+	#pragma omp parallel for simd reduction(+:area)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		area += static_cast<area_t>(x[vertex - 1]) * y[vertex] - static_cast<area_t>(y[vertex - 1]) * x[vertex];
+	}
+	return area / 2;
+}
+
+/*!
+ * Multi-threaded implementation of ``area`` for batches of polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * The polygons are divided over the threads. Each thread computes the areas of
+ * its polygons with SIMD instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_mt(const PolygonBatch& batch) {
+	Batch<area_t> result;
+	result.resize(batch.size()); //Resize, so that all threads can enter their data in parallel.
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	#pragma omp parallel for schedule(dynamic, 16)
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result[polygon] = area_soa_shoelace(x + starts[polygon], y + starts[polygon], starts[polygon + 1] - starts[polygon]) / 2;
+	}
+	return result;
+}
+
+/*!
+ * Implementation of ``area`` that uses SIMD instructions, for polygons that
+ * store their vertices as a structure of arrays.
+ *
+ * The single-threaded implementation for these polygons is already vectorised,
+ * so this is the same as ``area_st``. It is provided so that the SIMD
+ * implementation can be selected for any type of polygon.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<soa_polygonal Polygon>
+area_t area_simd(const Polygon& polygon) {
+	return detail::area_st(polygon);
+}
+
+/*!
+ * Implementation of ``area`` that uses SIMD instructions, for batches of
+ * polygons that store their vertices as a structure of arrays.
+ *
+ * The single-threaded implementation for these batches is already vectorised,
+ * so this is the same as ``area_st``.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_simd(const PolygonBatch& batch) {
+	return detail::area_st(batch);
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``area`` that runs on the graphics card, if available, for
+ * polygons that store their vertices as a structure of arrays.
+ *
+ * This uses the shoelace formula like the other implementations. The separate
+ * coordinate arrays allow coalesced reads on the GPU.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<soa_polygonal Polygon>
+area_t area_gpu(const Polygon& polygon) {
+	area_t area = 0;
+	const size_t size = polygon.size();
+	const coord_t* x = polygon.data_x();
+	const coord_t* y = polygon.data_y();
+	#pragma omp target teams distribute parallel for map(to:x[0:size], y[0:size]) map(tofrom:area) reduction(+:area)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const size_t previous = (vertex - 1 + size) % size;
+		area += static_cast<area_t>(x[previous]) * y[vertex] - static_cast<area_t>(y[previous]) * x[vertex];
+	}
+	return area / 2;
+}
+
+/*!
+ * Implementation of ``area`` that runs on the graphics card, if available, for
+ * batches of polygons that store their vertices as a structure of arrays.
+ *
+ * Each polygon is processed by a team on the GPU, and the vertices of each
+ * polygon are summed in parallel within the team.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<area_t> area_gpu(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	Batch<area_t> result;
+	result.resize(batch_size);
+	area_t* result_data = result.data();
+
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	const size_t vertices_size = batch.size_subelements();
+	#pragma omp target teams distribute map(to:x[0:vertices_size], y[0:vertices_size], starts[0:batch_size + 1]) map(from:result_data[0:batch_size])
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		area_t area = 0;
+		const size_t start = starts[polygon];
+		const size_t size = starts[polygon + 1] - start;
+		#pragma omp parallel for reduction(+:area)
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const size_t previous = (vertex - 1 + size) % size;
+			area += static_cast<area_t>(x[start + previous]) * y[start + vertex] - static_cast<area_t>(y[start + previous]) * x[start + vertex];
+		}
+		result_data[polygon] = area / 2;
+	}
+	return result;
+}
+#endif //GPU
+
+/*!
+ * Computes the shoelace sum of a polygon with a number of vertices that is
+ * known at compile time.
+ *
+ * The loop over the vertices is unrolled completely. The index of the previous
+ * vertex of each vertex is then a constant, so it doesn't need to be computed
+ * with a modulo operation at run-time.
+ * \tparam size The number of vertices of the polygon.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \return Twice the surface area of the polygon.
+ */
+template<size_t size>
+constexpr area_t area_fixed_shoelace(const Point2* vertices) {
+	area_t area = 0;
+	unroll<size>([&]<size_t vertex>() {
+		constexpr size_t previous = (vertex + size - 1) % size;
+		area += static_cast<area_t>(vertices[previous].x) * vertices[vertex].y - static_cast<area_t>(vertices[previous].y) * vertices[vertex].x;
+	});
+	return area;
+}
+
+/*!
+ * Computes the areas of a range of polygons in a batch of polygons with a fixed
+ * number of vertices, with SIMD instructions.
+ *
+ * The loop over the polygons is vectorised, so that each lane of the vector
+ * registers computes the area of a different polygon. The loop over the
+ * vertices of each polygon is unrolled at compile time.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \tparam size The number of vertices of each polygon.
+ * \param vertices The vertices of all polygons in the batch, stored
+ * contiguously.
+ * \param begin The first polygon of the range to compute.
+ * \param end The polygon past the last polygon of the range to compute.
+ * \param result An array to store the area of each polygon in, at the same
+ * index as the polygon.
+ */
+template<size_t size>
+APEX_SIMD_CLONES inline void area_fixed_range(const Point2* vertices, const size_t begin, const size_t end, area_t* result) {
+	#pragma omp simd
+	for(size_t polygon = begin; polygon < end; ++polygon) {
+		result[polygon] = area_fixed_shoelace<size>(vertices + polygon * size) / 2;
+	}
+}
+
+/*!
+ * Single-threaded implementation of ``area`` for polygons with a fixed number
+ * of vertices.
+ *
+ * This uses the shoelace formula like the other implementations, unrolled at
+ * compile time.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to calculate the area of.
+ * \return The surface area of the polygon.
+ */
+template<fixed_polygonal Polygon>
+area_t area_st(const Polygon& polygon) {
+	return area_fixed_shoelace<Polygon::fixed_size>(polygon.data()) / 2;
+}
+
+/*!
+ * Single-threaded implementation of ``area`` for batches of polygons with a
+ * fixed number of vertices.
+ *
+ * All polygons are computed with SIMD instructions, several polygons at a time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_st(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	Batch<area_t> result;
+	result.resize(batch_size);
+	area_fixed_range<size>(batch.data(), 0, batch_size, result.data());
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``area`` for batches of polygons with a
+ * fixed number of vertices.
+ *
+ * The polygons are divided over the threads in blocks. Since all polygons have
+ * the same size, each block takes equally long. Each thread computes its
+ * blocks with SIMD instructions, like ``area_st``.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_mt(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	Batch<area_t> result;
+	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
+	area_t* result_data = result.data();
+	const Point2* vertices = batch.data();
+	#pragma omp parallel for
+	for(size_t begin = 0; begin < batch_size; begin += fixed_block_size) {
+		area_fixed_range<size>(vertices, begin, std::min(begin + fixed_block_size, batch_size), result_data);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``area`` that runs on the graphics card, if available, for
+ * batches of polygons with a fixed number of vertices.
+ *
+ * Each thread on the GPU computes the area of one polygon. The loop over the
+ * vertices has a constant number of iterations, so the compiler can unroll it.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the areas of.
+ * \return A list of areas, one for each polygon, in the same order as the order
+ * of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<area_t> area_gpu(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	Batch<area_t> result;
+	result.resize(batch_size);
+	area_t* result_data = result.data();
+	const Point2* vertices = batch.data();
+	const size_t vertices_size = batch.size_subelements();
+	#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size]) map(from:result_data[0:batch_size])
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		const Point2* polygon_vertices = vertices + polygon * size;
+		area_t area = 0;
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const size_t previous = vertex == 0 ? size - 1 : vertex - 1;
+			area += static_cast<area_t>(polygon_vertices[previous].x) * polygon_vertices[vertex].y - static_cast<area_t>(polygon_vertices[previous].y) * polygon_vertices[vertex].x;
+		}
+		result_data[polygon] = area / 2;
+	}
 	return result;
 }
 #endif //GPU
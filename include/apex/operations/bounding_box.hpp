@@ -0,0 +1,958 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_BOUNDING_BOX
+#define APEX_BOUNDING_BOX
+
+#include <algorithm> //For std::min and std::max.
+#include <limits> //To start the reductions on the GPU from the extremes.
+#include <utility> //To return bounding boxes as pairs of corners.
+#include <vector> //To find the polygons in the vertex buffer.
+
+#include "../batch.hpp" //To return batches of bounding boxes.
+#include "../coordinate.hpp" //To compute bounding boxes of coordinate arrays.
+#include "../detail/fixed_size.hpp" //To unroll the loops over the vertices of fixed-size polygons.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
+#include "../detail/polygon_properties.hpp" //To cache the bounding boxes of polygons.
+#include "../detail/scheduler.hpp" //To divide the vertices of batches over the threads.
+#include "../detail/simd_dispatch.hpp" //To compile the SIMD kernels for multiple instruction sets.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../point2.hpp" //To return the corners of the bounding boxes.
+
+namespace apex {
+
+namespace detail {
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_uncached(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_uncached(const PolygonBatch& batch);
+
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch);
+
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_mt(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch);
+
+#ifdef GPU
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_gpu(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch);
+#endif //GPU
+
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch);
+
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_mt(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch);
+
+#ifdef GPU
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_gpu(const Polygon& polygon);
+
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch);
+#endif //GPU
+
+template<fixed_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch);
+
+#ifdef GPU
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch);
+#endif //GPU
+
+}
+
+/*!
+ * Computes the axis-aligned bounding box of a polygon.
+ *
+ * The bounding box is the smallest rectangle, aligned with the coordinate axes,
+ * that contains all vertices of the polygon. Since the edges of the polygon
+ * are straight, it then contains the whole polygon. The bounding box of an
+ * empty polygon is empty, with both corners at the origin.
+ *
+ * If the polygon caches its properties, the bounding box is only computed if
+ * it is not known yet.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box(const Polygon& polygon) {
+	if constexpr(caches_properties<Polygon>) {
+		PolygonProperties properties = polygon.get_properties();
+		if(!properties.has_bounding_box()) {
+			const std::pair<Point2, Point2> result = detail::bounding_box_uncached(polygon);
+			properties.set_bounding_box(result.first, result.second);
+			polygon.set_properties(properties);
+		}
+		return properties.bounding_box();
+	}
+	return detail::bounding_box_uncached(polygon);
+}
+
+/*!
+ * Computes the axis-aligned bounding boxes of each polygon in a batch.
+ *
+ * The bounding boxes are the same as those computed for each polygon
+ * separately. If the batch caches the properties of its polygons, the bounding
+ * boxes are only computed if they are not all known yet.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box(const PolygonBatch& batch) {
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		Batch<std::pair<Point2, Point2>> result;
+		result.reserve(batch.size());
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const PolygonProperties properties = batch.get_properties(polygon);
+			if(!properties.has_bounding_box()) {
+				break; //Computing the bounding boxes of the whole batch at once is more efficient than computing the missing ones separately.
+			}
+			result.push_back(properties.bounding_box());
+		}
+		if(result.size() == batch.size()) {
+			return result;
+		}
+		result = detail::bounding_box_uncached(batch);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			PolygonProperties properties = batch.get_properties(polygon);
+			properties.set_bounding_box(result[polygon].first, result[polygon].second);
+			batch.set_properties(polygon, properties);
+		}
+		return result;
+	}
+	return detail::bounding_box_uncached(batch);
+}
+
+/*!
+ * Computes the axis-aligned bounding box of a polygon that stores its vertices
+ * as a structure of arrays.
+ *
+ * The result is the same as for polygons that store their vertices as arrays
+ * of points. However the coordinates can be loaded contiguously, which allows
+ * the computation to be fully vectorised.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box(const Polygon& polygon) {
+	const detail::Dispatch dispatch(detail::Operation::bounding_box_soa, polygon.size());
+	switch(dispatch.version) {
+		case 0: return detail::bounding_box_st(polygon);
+		case 1: return detail::bounding_box_mt(polygon);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::bounding_box_gpu(polygon);
+		}
+#endif //GPU
+	}
+	return detail::bounding_box_mt(polygon);
+}
+
+/*!
+ * Computes the axis-aligned bounding boxes of each polygon in a batch that
+ * stores its vertices as a structure of arrays.
+ *
+ * The result is the same as for batches that store their vertices as arrays of
+ * points. However the coordinates can be loaded contiguously, which allows the
+ * computation to be fully vectorised.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch A batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box(const PolygonBatch& batch) {
+	const detail::Dispatch dispatch(detail::Operation::bounding_box_soa_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::bounding_box_st(batch);
+		case 1: return detail::bounding_box_mt(batch);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::bounding_box_gpu(batch);
+		}
+#endif //GPU
+	}
+	return detail::bounding_box_mt(batch);
+}
+
+/*!
+ * Computes the axis-aligned bounding box of a polygon with a fixed number of
+ * vertices.
+ *
+ * The result is the same as for other polygons. However the number of vertices
+ * is known at compile time, so the computation is completely unrolled. Since
+ * the number of vertices is small, this always uses the single-threaded
+ * implementation.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<fixed_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box(const Polygon& polygon) {
+	return detail::bounding_box_st(polygon);
+}
+
+/*!
+ * Computes the axis-aligned bounding boxes of each polygon in a batch of
+ * polygons with a fixed number of vertices.
+ *
+ * The result is the same as for other batches. However each polygon starts at
+ * a fixed stride in the vertex array, so each lane of the vector registers can
+ * compute the bounding box of a different polygon, with the loop over the
+ * vertices unrolled at compile time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch A batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box(const PolygonBatch& batch) {
+	const detail::Dispatch dispatch(detail::Operation::bounding_box_fixed_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::bounding_box_st(batch);
+		case 1: return detail::bounding_box_mt(batch);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::bounding_box_gpu(batch);
+		}
+#endif //GPU
+	}
+	return detail::bounding_box_mt(batch);
+}
+
+namespace detail {
+
+/*!
+ * Computes the bounding box of a polygon with the fastest version of
+ * ``bounding_box``, regardless of what is cached about the polygon.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_uncached(const Polygon& polygon) {
+	const Dispatch dispatch(Operation::bounding_box, polygon.size());
+	switch(dispatch.version) {
+		case 0: return bounding_box_st(polygon);
+		case 1: return bounding_box_mt(polygon);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return bounding_box_gpu(polygon);
+		}
+#endif //GPU
+	}
+	return bounding_box_mt(polygon);
+}
+
+/*!
+ * Computes the bounding boxes of each polygon in a batch with the fastest
+ * version of ``bounding_box``, regardless of what is cached about the polygons.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_uncached(const PolygonBatch& batch) {
+	const Dispatch dispatch(Operation::bounding_box_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return bounding_box_st(batch);
+		case 1: return bounding_box_mt(batch);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return bounding_box_gpu(batch);
+		}
+#endif //GPU
+	}
+	return bounding_box_mt(batch);
+}
+
+/*!
+ * Computes the bounding box of a range of vertices with SIMD instructions.
+ *
+ * The minimum and maximum of each coordinate are found with a reduction. The
+ * first vertex initialises the reduction, so that no special values are needed
+ * to start from.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param vertices The vertices to compute the bounding box of, stored
+ * contiguously.
+ * \param size The number of vertices.
+ * \return The minimum and maximum corner of the bounding box, in that order. If
+ * there are no vertices, both corners are at the origin.
+ */
+APEX_SIMD_CLONES inline std::pair<Point2, Point2> bounding_box_vertices(const Point2* vertices, const size_t size) {
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	coord_t min_x = vertices[0].x;
+	coord_t min_y = vertices[0].y;
+	coord_t max_x = vertices[0].x;
+	coord_t max_y = vertices[0].y;
+	#pragma omp simd reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		min_x = std::min(min_x, vertices[vertex].x);
+		min_y = std::min(min_y, vertices[vertex].y);
+		max_x = std::max(max_x, vertices[vertex].x);
+		max_y = std::max(max_y, vertices[vertex].y);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box``.
+ *
+ * This finds the minimum and maximum coordinates of the vertices in one pass,
+ * with SIMD instructions. The vertices of the polygon must be stored
+ * contiguously in memory, like they are in a ``Polygon`` and in the polygons of
+ * a ``Batch<Polygon>``.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon) {
+	if(polygon.size() == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	return bounding_box_vertices(&polygon[0], polygon.size());
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box`` for batches of polygons.
+ *
+ * This computes the bounding box of each polygon in turn, with SIMD
+ * instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch) {
+	Batch<std::pair<Point2, Point2>> result;
+	result.reserve(batch.size());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result.push_back(detail::bounding_box_st(batch[polygon]));
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``bounding_box``.
+ *
+ * The vertices are divided over the threads. Each thread finds the minimum and
+ * maximum coordinates of its part of the vertices, and these are combined with
+ * a parallel reduction.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_mt(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	const Point2* vertices = &polygon[0]; //Synchronises the vertices with the GPU once, rather than for each vertex accessed.
+	coord_t min_x = vertices[0].x;
+	coord_t min_y = vertices[0].y;
+	coord_t max_x = vertices[0].x;
+	coord_t max_y = vertices[0].y;
+	#pragma omp parallel for simd reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		min_x = std::min(min_x, vertices[vertex].x);
+		min_y = std::min(min_y, vertices[vertex].y);
+		max_x = std::max(max_x, vertices[vertex].x);
+		max_y = std::max(max_y, vertices[vertex].y);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Multi-threaded implementation of ``bounding_box`` for batches of polygons.
+ *
+ * The ``Scheduler`` divides the vertices of all polygons over the threads, so
+ * that big polygons are split over multiple threads and small polygons are
+ * grouped together. Each thread computes the bounding boxes of its parts of the
+ * polygons with SIMD instructions. The bounding boxes of the parts of a split
+ * polygon are merged afterwards.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	Batch<std::pair<Point2, Point2>> result;
+	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
+
+	const Point2* vertices = batch.data_subelements();
+	const VertexRanges ranges(batch);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		if(!batch[polygon].empty()) { //Start from the first vertex, so that the parts of split polygons can be merged into it. Empty polygons keep an empty bounding box at the origin.
+			result[polygon] = std::make_pair(vertices[ranges.starts[polygon]], vertices[ranges.starts[polygon]]);
+		}
+	}
+
+	Scheduler::for_each_range(ranges.offsets, [&](const size_t polygon, const size_t begin, const size_t end) {
+		const std::pair<Point2, Point2> part = bounding_box_vertices(vertices + ranges.starts[polygon] + begin, end - begin);
+		if(begin == 0 && end == ranges.size(polygon)) { //Polygon lies completely within this task, so no other thread writes to it.
+			result[polygon] = part;
+		} else {
+			#pragma omp critical(apex_bounding_box_merge)
+			{
+				std::pair<Point2, Point2>& box = result[polygon];
+				box.first = Point2(std::min(box.first.x, part.first.x), std::min(box.first.y, part.first.y));
+				box.second = Point2(std::max(box.second.x, part.second.x), std::max(box.second.y, part.second.y));
+			}
+		}
+	});
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``bounding_box`` that runs on the graphics card, if
+ * available.
+ *
+ * The minimum and maximum coordinates are found with a parallel reduction on
+ * the GPU. If the polygon is tracked by the ``GPUDataTracker``, the vertices
+ * are left on the GPU for subsequent operations.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_gpu(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	const Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Leave the vertices on the GPU for subsequent operations.
+	}
+	coord_t min_x = std::numeric_limits<coord_t>::max(); //Start from the extremes, since the first vertex may only be on the GPU.
+	coord_t min_y = std::numeric_limits<coord_t>::max();
+	coord_t max_x = std::numeric_limits<coord_t>::lowest();
+	coord_t max_y = std::numeric_limits<coord_t>::lowest();
+	#pragma omp target teams distribute parallel for map(to:vertices[0:size]) map(tofrom:min_x, min_y, max_x, max_y) reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		min_x = std::min(min_x, vertices[vertex].x);
+		min_y = std::min(min_y, vertices[vertex].y);
+		max_x = std::max(max_x, vertices[vertex].x);
+		max_y = std::max(max_y, vertices[vertex].y);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Implementation of ``bounding_box`` for batches of polygons that runs on the
+ * graphics card, if available.
+ *
+ * Each polygon is processed by a team on the GPU, and the vertices of each
+ * polygon are reduced in parallel within the team.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	std::vector<Point2> minima(batch_size);
+	std::vector<Point2> maxima(batch_size);
+	Point2* minima_data = minima.data();
+	Point2* maxima_data = maxima.data();
+
+	const Subbatch<Point2>* polygons = batch.data();
+	const Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Leave the vertices on the GPU for subsequent operations.
+	}
+	#pragma omp target teams distribute map(to:vertices[0:vertices_size]) map(to:polygons[0:batch_size]) map(from:minima_data[0:batch_size], maxima_data[0:batch_size])
+	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
+		const auto& polygon = polygons[polygon_index];
+		const size_t size = polygon.size();
+		coord_t min_x = 0; //Empty polygons get an empty bounding box at the origin.
+		coord_t min_y = 0;
+		coord_t max_x = 0;
+		coord_t max_y = 0;
+		if(size > 0) {
+			min_x = polygon[0].x;
+			min_y = polygon[0].y;
+			max_x = polygon[0].x;
+			max_y = polygon[0].y;
+		}
+		#pragma omp parallel for reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+		for(size_t vertex = 1; vertex < size; ++vertex) {
+			min_x = std::min(min_x, polygon[vertex].x);
+			min_y = std::min(min_y, polygon[vertex].y);
+			max_x = std::max(max_x, polygon[vertex].x);
+			max_y = std::max(max_y, polygon[vertex].y);
+		}
+		minima_data[polygon_index] = Point2(min_x, min_y);
+		maxima_data[polygon_index] = Point2(max_x, max_y);
+	}
+
+	Batch<std::pair<Point2, Point2>> result;
+	result.reserve(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		result.emplace_back(minima[polygon], maxima[polygon]);
+	}
+	return result;
+}
+#endif //GPU
+
+/*!
+ * Computes the bounding box of a range of vertices stored as a structure of
+ * arrays, with SIMD instructions.
+ *
+ * Since the coordinates of each dimension are stored contiguously, they can be
+ * loaded into vector registers directly.
+ * \param x The X coordinates of the vertices.
+ * \param y The Y coordinates of the vertices.
+ * \param size The number of vertices.
+ * \return The minimum and maximum corner of the bounding box, in that order. If
+ * there are no vertices, both corners are at the origin.
+ */
+APEX_SIMD_CLONES inline std::pair<Point2, Point2> bounding_box_soa_coordinates(const coord_t* x, const coord_t* y, const size_t size) {
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	coord_t min_x = x[0];
+	coord_t min_y = y[0];
+	coord_t max_x = x[0];
+	coord_t max_y = y[0];
+	#pragma omp simd reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		min_x = std::min(min_x, x[vertex]);
+		min_y = std::min(min_y, y[vertex]);
+		max_x = std::max(max_x, x[vertex]);
+		max_y = std::max(max_y, y[vertex]);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box`` for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This finds the minimum and maximum coordinates in one pass, with SIMD
+ * instructions.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon) {
+	return bounding_box_soa_coordinates(polygon.data_x(), polygon.data_y(), polygon.size());
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box`` for batches of polygons
+ * that store their vertices as a structure of arrays.
+ *
+ * This computes the bounding box of each polygon in turn, with SIMD
+ * instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch) {
+	Batch<std::pair<Point2, Point2>> result;
+	result.resize(batch.size());
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result[polygon] = bounding_box_soa_coordinates(x + starts[polygon], y + starts[polygon], starts[polygon + 1] - starts[polygon]);
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``bounding_box`` for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * The vertices are divided over the threads. Each thread finds the minimum and
+ * maximum coordinates of its part with SIMD instructions, and these are
+ * combined with a parallel reduction.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_mt(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	const coord_t* x = polygon.data_x();
+	const coord_t* y = polygon.data_y();
+	coord_t min_x = x[0];
+	coord_t min_y = y[0];
+	coord_t max_x = x[0];
+	coord_t max_y = y[0];
+	#pragma omp parallel for simd reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		min_x = std::min(min_x, x[vertex]);
+		min_y = std::min(min_y, y[vertex]);
+		max_x = std::max(max_x, x[vertex]);
+		max_y = std::max(max_y, y[vertex]);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Multi-threaded implementation of ``bounding_box`` for batches of polygons
+ * that store their vertices as a structure of arrays.
+ *
+ * The polygons are divided over the threads. Each thread computes the bounding
+ * boxes of its polygons with SIMD instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch) {
+	Batch<std::pair<Point2, Point2>> result;
+	result.resize(batch.size()); //Resize, so that all threads can enter their data in parallel.
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	#pragma omp parallel for schedule(dynamic, 16)
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result[polygon] = bounding_box_soa_coordinates(x + starts[polygon], y + starts[polygon], starts[polygon + 1] - starts[polygon]);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``bounding_box`` that runs on the graphics card, if
+ * available, for polygons that store their vertices as a structure of arrays.
+ *
+ * The minimum and maximum coordinates are found with a parallel reduction on
+ * the GPU. The separate coordinate arrays allow coalesced reads.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<soa_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_gpu(const Polygon& polygon) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	}
+	const coord_t* x = polygon.data_x();
+	const coord_t* y = polygon.data_y();
+	coord_t min_x = x[0];
+	coord_t min_y = y[0];
+	coord_t max_x = x[0];
+	coord_t max_y = y[0];
+	#pragma omp target teams distribute parallel for map(to:x[0:size], y[0:size]) map(tofrom:min_x, min_y, max_x, max_y) reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		min_x = std::min(min_x, x[vertex]);
+		min_y = std::min(min_y, y[vertex]);
+		max_x = std::max(max_x, x[vertex]);
+		max_y = std::max(max_y, y[vertex]);
+	}
+	return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+}
+
+/*!
+ * Implementation of ``bounding_box`` that runs on the graphics card, if
+ * available, for batches of polygons that store their vertices as a structure
+ * of arrays.
+ *
+ * Each polygon is processed by a team on the GPU, and the vertices of each
+ * polygon are reduced in parallel within the team.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<soa_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	std::vector<Point2> minima(batch_size);
+	std::vector<Point2> maxima(batch_size);
+	Point2* minima_data = minima.data();
+	Point2* maxima_data = maxima.data();
+
+	const coord_t* x = batch.data_x();
+	const coord_t* y = batch.data_y();
+	const size_t* starts = batch.data_starts();
+	const size_t vertices_size = batch.size_subelements();
+	#pragma omp target teams distribute map(to:x[0:vertices_size], y[0:vertices_size], starts[0:batch_size + 1]) map(from:minima_data[0:batch_size], maxima_data[0:batch_size])
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		const size_t start = starts[polygon];
+		const size_t size = starts[polygon + 1] - start;
+		coord_t min_x = 0; //Empty polygons get an empty bounding box at the origin.
+		coord_t min_y = 0;
+		coord_t max_x = 0;
+		coord_t max_y = 0;
+		if(size > 0) {
+			min_x = x[start];
+			min_y = y[start];
+			max_x = x[start];
+			max_y = y[start];
+		}
+		#pragma omp parallel for reduction(min:min_x, min_y) reduction(max:max_x, max_y)
+		for(size_t vertex = 1; vertex < size; ++vertex) {
+			min_x = std::min(min_x, x[start + vertex]);
+			min_y = std::min(min_y, y[start + vertex]);
+			max_x = std::max(max_x, x[start + vertex]);
+			max_y = std::max(max_y, y[start + vertex]);
+		}
+		minima_data[polygon] = Point2(min_x, min_y);
+		maxima_data[polygon] = Point2(max_x, max_y);
+	}
+
+	Batch<std::pair<Point2, Point2>> result;
+	result.reserve(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		result.emplace_back(minima[polygon], maxima[polygon]);
+	}
+	return result;
+}
+#endif //GPU
+
+/*!
+ * Computes the bounding box of a polygon with a number of vertices that is
+ * known at compile time.
+ *
+ * The loop over the vertices is unrolled completely.
+ * \tparam size The number of vertices of the polygon.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ * For polygons without vertices, both corners are at the origin.
+ */
+template<size_t size>
+constexpr std::pair<Point2, Point2> bounding_box_fixed_vertices(const Point2* vertices) {
+	if constexpr(size == 0) {
+		return std::make_pair(Point2(0, 0), Point2(0, 0));
+	} else {
+		coord_t min_x = vertices[0].x;
+		coord_t min_y = vertices[0].y;
+		coord_t max_x = vertices[0].x;
+		coord_t max_y = vertices[0].y;
+		unroll<size - 1>([&]<size_t index>() {
+			constexpr size_t vertex = index + 1; //The first vertex is already included.
+			min_x = std::min(min_x, vertices[vertex].x);
+			min_y = std::min(min_y, vertices[vertex].y);
+			max_x = std::max(max_x, vertices[vertex].x);
+			max_y = std::max(max_y, vertices[vertex].y);
+		});
+		return std::make_pair(Point2(min_x, min_y), Point2(max_x, max_y));
+	}
+}
+
+/*!
+ * Computes the bounding boxes of a range of polygons in a batch of polygons
+ * with a fixed number of vertices, with SIMD instructions.
+ *
+ * The loop over the polygons is vectorised, so that each lane of the vector
+ * registers computes the bounding box of a different polygon. The loop over
+ * the vertices of each polygon is unrolled at compile time.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \tparam size The number of vertices of each polygon.
+ * \param vertices The vertices of all polygons in the batch, stored
+ * contiguously.
+ * \param begin The first polygon of the range to compute.
+ * \param end The polygon past the last polygon of the range to compute.
+ * \param result An array to store the bounding box of each polygon in, at the
+ * same index as the polygon.
+ */
+template<size_t size>
+APEX_SIMD_CLONES inline void bounding_box_fixed_range(const Point2* vertices, const size_t begin, const size_t end, std::pair<Point2, Point2>* result) {
+	#pragma omp simd
+	for(size_t polygon = begin; polygon < end; ++polygon) {
+		result[polygon] = bounding_box_fixed_vertices<size>(vertices + polygon * size);
+	}
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box`` for polygons with a fixed
+ * number of vertices.
+ *
+ * The loop over the vertices is unrolled at compile time.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to compute the bounding box of.
+ * \return The minimum and maximum corner of the bounding box, in that order.
+ */
+template<fixed_polygonal Polygon>
+std::pair<Point2, Point2> bounding_box_st(const Polygon& polygon) {
+	return bounding_box_fixed_vertices<Polygon::fixed_size>(polygon.data());
+}
+
+/*!
+ * Single-threaded implementation of ``bounding_box`` for batches of polygons
+ * with a fixed number of vertices.
+ *
+ * All polygons are computed with SIMD instructions, several polygons at a time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_st(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	Batch<std::pair<Point2, Point2>> result;
+	result.resize(batch_size);
+	bounding_box_fixed_range<size>(batch.data(), 0, batch_size, result.data());
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``bounding_box`` for batches of polygons
+ * with a fixed number of vertices.
+ *
+ * The polygons are divided over the threads in blocks. Since all polygons have
+ * the same size, each block takes equally long. Each thread computes its
+ * blocks with SIMD instructions, like ``bounding_box_st``.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_mt(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	Batch<std::pair<Point2, Point2>> result;
+	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
+	std::pair<Point2, Point2>* result_data = result.data();
+	const Point2* vertices = batch.data();
+	#pragma omp parallel for
+	for(size_t begin = 0; begin < batch_size; begin += fixed_block_size) {
+		bounding_box_fixed_range<size>(vertices, begin, std::min(begin + fixed_block_size, batch_size), result_data);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``bounding_box`` that runs on the graphics card, if
+ * available, for batches of polygons with a fixed number of vertices.
+ *
+ * Each thread on the GPU computes the bounding box of one polygon. The loop
+ * over the vertices has a constant number of iterations, so the compiler can
+ * unroll it.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to compute the bounding boxes of.
+ * \return For each polygon, the minimum and maximum corner of its bounding box,
+ * in the same order as the order of those polygons in the batch.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<std::pair<Point2, Point2>> bounding_box_gpu(const PolygonBatch& batch) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	std::vector<Point2> minima(batch_size);
+	std::vector<Point2> maxima(batch_size);
+	Point2* minima_data = minima.data();
+	Point2* maxima_data = maxima.data();
+	const Point2* vertices = batch.data();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(size > 0) {
+		#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size]) map(from:minima_data[0:batch_size], maxima_data[0:batch_size])
+		for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+			const Point2* polygon_vertices = vertices + polygon * size;
+			coord_t min_x = polygon_vertices[0].x;
+			coord_t min_y = polygon_vertices[0].y;
+			coord_t max_x = polygon_vertices[0].x;
+			coord_t max_y = polygon_vertices[0].y;
+			for(size_t vertex = 1; vertex < size; ++vertex) {
+				min_x = std::min(min_x, polygon_vertices[vertex].x);
+				min_y = std::min(min_y, polygon_vertices[vertex].y);
+				max_x = std::max(max_x, polygon_vertices[vertex].x);
+				max_y = std::max(max_y, polygon_vertices[vertex].y);
+			}
+			minima_data[polygon] = Point2(min_x, min_y);
+			maxima_data[polygon] = Point2(max_x, max_y);
+		}
+	}
+
+	Batch<std::pair<Point2, Point2>> result;
+	result.reserve(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		result.emplace_back(minima[polygon], maxima[polygon]);
+	}
+	return result;
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_BOUNDING_BOX
\ No newline at end of file
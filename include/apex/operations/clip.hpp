@@ -0,0 +1,811 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_CLIP
+#define APEX_CLIP
+
+#include <algorithm> //To sort edges, split points and fragments.
+#include <cmath> //For std::llround, to round intersections to the nearest coordinate.
+#include <memory_resource> //To construct the resulting polygons around their vertex buffer.
+#include <omp.h> //To divide the sweep line over multiple threads.
+#include <utility> //For std::pair, to store split points and directed edges.
+#include <vector> //To store intermediary data while clipping.
+
+#include "../batch.hpp" //To return batches of polygons.
+#include "../coordinate.hpp" //To compute orientations and windings exactly.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../point2.hpp" //The vertices of the edges.
+#include "../polygon.hpp" //The result type of this operation.
+
+namespace apex {
+
+/*!
+ * The operations that can be performed on the areas of two shapes.
+ */
+enum class BooleanOperation {
+	/*!
+	 * The area that is inside of either of the shapes, or both.
+	 */
+	UNION,
+
+	/*!
+	 * The area that is inside of both of the shapes.
+	 */
+	INTERSECTION,
+
+	/*!
+	 * The area that is inside of the first shape, but not inside of the second
+	 * shape.
+	 */
+	DIFFERENCE
+};
+
+/*!
+ * The rules that determine which parts of a shape are inside of it.
+ *
+ * Which parts are inside is determined by the winding number: How many times
+ * the contours of the shape go around a point counter-clockwise, minus how
+ * many times they go around it clockwise.
+ */
+enum class FillRule {
+	/*!
+	 * Points are inside if the contours wind around them at all, in any
+	 * direction.
+	 *
+	 * This is the rule used by ``contains``. Overlapping contours with the same
+	 * orientation merge, while contours with opposite orientation cancel out.
+	 */
+	NONZERO,
+
+	/*!
+	 * Points are inside if the contours wind around them an odd number of
+	 * times.
+	 *
+	 * With this rule, the orientation of the contours doesn't matter. Every
+	 * contour toggles whether its inside is filled.
+	 */
+	EVEN_ODD,
+
+	/*!
+	 * Points are inside if the contours wind around them counter-clockwise
+	 * more often than clockwise.
+	 *
+	 * Contours that wind clockwise cut holes into the shape, but are not filled
+	 * by themselves. This is useful to discard the parts of a shape that turned
+	 * inside out, such as the corners of an offset contour.
+	 */
+	POSITIVE
+};
+
+namespace detail {
+
+/*!
+ * An edge of one of the shapes that are being clipped.
+ */
+struct ClipEdge {
+	/*!
+	 * The vertex where the edge starts.
+	 */
+	Point2 start;
+
+	/*!
+	 * The vertex where the edge ends.
+	 */
+	Point2 end;
+
+	/*!
+	 * Which shape the edge belongs to: 0 for the first shape, or 1 for the
+	 * second shape.
+	 */
+	unsigned char operand;
+};
+
+/*!
+ * A piece of the contours of the shapes that are being clipped, between two
+ * points where it is split by other edges.
+ *
+ * Pieces that lie on top of each other are merged into one fragment. Instead of
+ * a direction, a fragment keeps track of how many times the contours of each
+ * shape pass along it, from the lower endpoint to the upper endpoint. Passing
+ * in the opposite direction counts negatively.
+ */
+struct ClipFragment {
+	/*!
+	 * The endpoint with the lowest Y coordinate. If both endpoints are at the
+	 * same height, this is the endpoint with the lowest X coordinate.
+	 */
+	Point2 lower;
+
+	/*!
+	 * The other endpoint.
+	 */
+	Point2 upper;
+
+	/*!
+	 * How many times the contours of the first shape pass along this fragment,
+	 * from the lower to the upper endpoint.
+	 */
+	int winding_a;
+
+	/*!
+	 * How many times the contours of the second shape pass along this fragment,
+	 * from the lower to the upper endpoint.
+	 */
+	int winding_b;
+};
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+void clip_add_edges(const Polygon& polygon, const unsigned char operand, std::vector<ClipEdge>& edges);
+
+template<multi_polygonal PolygonBatch>
+void clip_add_edges(const PolygonBatch& batch, const unsigned char operand, std::vector<ClipEdge>& edges);
+
+inline Batch<Polygon> clip_st(std::vector<ClipEdge> edges, const BooleanOperation operation, const FillRule fill_rule);
+inline Batch<Polygon> clip_mt(std::vector<ClipEdge> edges, const BooleanOperation operation, const FillRule fill_rule);
+
+}
+
+/*!
+ * Performs a boolean operation on the areas of two polygons.
+ *
+ * The result consists of the contours of the area that is inside of the first
+ * polygon and/or the second polygon, depending on the operation. Outer contours
+ * wind counter-clockwise, and holes wind clockwise. The resulting contours
+ * don't intersect each other or themselves, so the result is the same with
+ * either fill rule. Shapes that only touch in a vertex become separate
+ * contours. Vertices in the middle of a straight line are removed.
+ *
+ * Where edges cross, a vertex is inserted at the crossing, rounded to the
+ * nearest coordinate. Because of this rounding, the edges near a crossing may
+ * move by up to half a unit.
+ *
+ * To prevent overflows, the coordinates must stay within a quarter of the
+ * range of ``coord_t`` from the origin.
+ *
+ * Clipping a polygon with an empty polygon, using ``BooleanOperation::UNION``,
+ * removes its self-intersections.
+ * \tparam PolygonA A class that behaves like a polygon.
+ * \tparam PolygonB A class that behaves like a polygon.
+ * \param a The first polygon.
+ * \param b The second polygon.
+ * \param operation Which boolean operation to perform.
+ * \param fill_rule The rule that determines which parts of the polygons are
+ * inside of them. The same rule is used for both polygons.
+ * \return The contours of the result of the operation.
+ */
+template<polygonal PolygonA, polygonal PolygonB>
+Batch<Polygon> clip(const PolygonA& a, const PolygonB& b, const BooleanOperation operation, const FillRule fill_rule = FillRule::NONZERO) {
+	std::vector<detail::ClipEdge> edges;
+	edges.reserve(a.size() + b.size());
+	detail::clip_add_edges(a, 0, edges);
+	detail::clip_add_edges(b, 1, edges);
+	const detail::Dispatch dispatch(detail::Operation::clip, edges.size());
+	switch(dispatch.version) {
+		case 0: return detail::clip_st(std::move(edges), operation, fill_rule);
+		case 1: return detail::clip_mt(std::move(edges), operation, fill_rule);
+	}
+	return detail::clip_mt(std::move(edges), operation, fill_rule);
+}
+
+/*!
+ * Performs a boolean operation on the areas of two shapes, each consisting of a
+ * batch of polygons.
+ *
+ * All contours in a batch together define the area of a shape, for instance an
+ * outer contour with holes, or a set of contours that overlap. Which parts of
+ * the shapes are inside is determined by their winding numbers, using the fill
+ * rule. The shapes are clipped in the same way as single polygons are.
+ *
+ * The engine first splits the edges of both shapes where they intersect, with
+ * a sweep line. The sweep is divided over multiple threads for big shapes.
+ * Then it determines for each piece of edge whether the result is inside on one
+ * side and outside on the other. Those pieces are connected into the contours
+ * of the result, which are written directly into the vertex buffer of the
+ * resulting batch.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a The first shape.
+ * \param b The second shape.
+ * \param operation Which boolean operation to perform.
+ * \param fill_rule The rule that determines which parts of the shapes are
+ * inside of them. The same rule is used for both shapes.
+ * \return The contours of the result of the operation.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<Polygon> clip(const PolygonBatchA& a, const PolygonBatchB& b, const BooleanOperation operation, const FillRule fill_rule = FillRule::NONZERO) {
+	std::vector<detail::ClipEdge> edges;
+	detail::clip_add_edges(a, 0, edges);
+	detail::clip_add_edges(b, 1, edges);
+	const detail::Dispatch dispatch(detail::Operation::clip, edges.size());
+	switch(dispatch.version) {
+		case 0: return detail::clip_st(std::move(edges), operation, fill_rule);
+		case 1: return detail::clip_mt(std::move(edges), operation, fill_rule);
+	}
+	return detail::clip_mt(std::move(edges), operation, fill_rule);
+}
+
+namespace detail {
+
+/*!
+ * The maximum number of times that the edges are split at their intersections.
+ *
+ * Rounding the intersections to the nearest coordinate moves the edges a bit.
+ * In rare cases, this makes them cross other edges that they didn't cross
+ * before, so the splitting is repeated until no more intersections are found.
+ */
+constexpr size_t max_clip_iterations = 8;
+
+/*!
+ * Adds the edges of a polygon to the edges to clip.
+ *
+ * Edges of zero length are left out.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to add the edges of.
+ * \param operand Which shape the polygon is part of.
+ * \param edges The edges to add the edges of the polygon to.
+ */
+template<polygonal Polygon>
+void clip_add_edges(const Polygon& polygon, const unsigned char operand, std::vector<ClipEdge>& edges) {
+	const size_t size = polygon.size();
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 start = polygon[vertex];
+		const Point2 end = polygon[(vertex + 1) % size];
+		if(start != end) {
+			edges.push_back({start, end, operand});
+		}
+	}
+}
+
+/*!
+ * Adds the edges of all polygons in a batch to the edges to clip.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to add the edges of.
+ * \param operand Which shape the polygons are part of.
+ * \param edges The edges to add the edges of the polygons to.
+ */
+template<multi_polygonal PolygonBatch>
+void clip_add_edges(const PolygonBatch& batch, const unsigned char operand, std::vector<ClipEdge>& edges) {
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		clip_add_edges(batch[polygon], operand, edges);
+	}
+}
+
+/*!
+ * Computes the cross product of two vectors, without overflowing for big
+ * coordinates.
+ * \param a The first vector.
+ * \param b The second vector.
+ * \return The cross product of the vectors.
+ */
+constexpr area_t clip_cross(const Point2& a, const Point2& b) {
+	return area_t(a.x) * b.y - area_t(a.y) * b.x;
+}
+
+/*!
+ * Computes the dot product of two vectors, without overflowing for big
+ * coordinates.
+ * \param a The first vector.
+ * \param b The second vector.
+ * \return The dot product of the vectors.
+ */
+constexpr area_t clip_dot(const Point2& a, const Point2& b) {
+	return area_t(a.x) * b.x + area_t(a.y) * b.y;
+}
+
+/*!
+ * Splits an edge at a point of another, collinear edge, if that point lies
+ * strictly between the endpoints of the edge.
+ * \param edge The edge to split.
+ * \param index The index of the edge to split.
+ * \param point The point to split it at.
+ * \param splits The split points to add the split to, if any.
+ */
+inline void clip_split_collinear(const ClipEdge& edge, const size_t index, const Point2& point, std::vector<std::pair<size_t, Point2>>& splits) {
+	const Point2 delta = edge.end - edge.start;
+	if(clip_dot(point - edge.start, delta) > 0 && clip_dot(point - edge.end, delta) < 0) {
+		splits.emplace_back(index, point);
+	}
+}
+
+/*!
+ * Tests two edges for intersection, and adds the points where they need to be
+ * split to the split points.
+ *
+ * If the edges cross, or one edge ends on the other, both edges get split at
+ * that point, unless it is one of their own endpoints. If the edges overlap
+ * lengthwise, each edge gets split at the endpoints of the other edge that are
+ * on it. After splitting, the pieces of overlapping edges then coincide
+ * exactly.
+ * \param edges All edges that are being clipped.
+ * \param edge_a The index of one of the edges to test.
+ * \param edge_b The index of the other edge to test.
+ * \param splits The split points to add the found splits to.
+ */
+inline void clip_test_pair(const std::vector<ClipEdge>& edges, const size_t edge_a, const size_t edge_b, std::vector<std::pair<size_t, Point2>>& splits) {
+	const ClipEdge& a = edges[edge_a];
+	const ClipEdge& b = edges[edge_b];
+	const Point2 a_delta = a.end - a.start;
+	const Point2 b_delta = b.end - b.start;
+	const Point2 starts_delta = a.start - b.start;
+	const area_t divisor = clip_cross(a_delta, b_delta);
+	if(divisor == 0) [[unlikely]] { //The edges are parallel.
+		if(clip_cross(a_delta, starts_delta) != 0) { //Not collinear, so they can't intersect.
+			return;
+		}
+		clip_split_collinear(a, edge_a, b.start, splits);
+		clip_split_collinear(a, edge_a, b.end, splits);
+		clip_split_collinear(b, edge_b, a.start, splits);
+		clip_split_collinear(b, edge_b, a.end, splits);
+		return;
+	}
+
+	//Find the parametric coordinates where the lines intersect, in the same way as LineSegment::intersect.
+	const area_t a_parametric = clip_cross(b_delta, starts_delta);
+	const area_t b_parametric = clip_cross(a_delta, starts_delta);
+	const area_t lower_range = std::min(area_t(0), divisor);
+	const area_t upper_range = std::max(area_t(0), divisor);
+	if(a_parametric < lower_range || a_parametric > upper_range || b_parametric < lower_range || b_parametric > upper_range) {
+		return; //The intersection is not within the ranges of both edges.
+	}
+	Point2 intersection;
+	if(a_parametric == 0) { //Exactly on the endpoints, so there is no need to round.
+		intersection = a.start;
+	} else if(a_parametric == divisor) {
+		intersection = a.end;
+	} else if(b_parametric == 0) {
+		intersection = b.start;
+	} else if(b_parametric == divisor) {
+		intersection = b.end;
+	} else { //The products may not fit in an area_t, so use extended precision for the rounding.
+		const long double fraction = static_cast<long double>(a_parametric) / divisor;
+		intersection = a.start + Point2(coord_t(std::llround(fraction * a_delta.x)), coord_t(std::llround(fraction * a_delta.y)));
+	}
+	if(intersection != a.start && intersection != a.end) {
+		splits.emplace_back(edge_a, intersection);
+	}
+	if(intersection != b.start && intersection != b.end) {
+		splits.emplace_back(edge_b, intersection);
+	}
+}
+
+/*!
+ * Sweeps a line along the X direction to find the split points of the edges
+ * that the line crosses at the same time.
+ *
+ * This works the same way as the sweep that finds self-intersections. The
+ * sweep can start and end anywhere along the sweep order, including the edges
+ * encountered before the start that are still crossed by the sweep line at the
+ * start. Every pair of edges is tested exactly once over all slabs.
+ * \param edges All edges that are being clipped.
+ * \param order The indices of the edges, sorted by their lowest X coordinate.
+ * \param start The position in the sweep order to start sweeping.
+ * \param end The position in the sweep order to stop sweeping (exclusive).
+ * \param splits The split points to add the found splits to.
+ */
+inline void clip_sweep(const std::vector<ClipEdge>& edges, const std::vector<size_t>& order, const size_t start, const size_t end, std::vector<std::pair<size_t, Point2>>& splits) {
+	if(start >= end) {
+		return;
+	}
+	std::vector<size_t> active; //The edges that the sweep line is currently crossing.
+	const coord_t start_x = std::min(edges[order[start]].start.x, edges[order[start]].end.x);
+	for(size_t sweep_index = 0; sweep_index < start; ++sweep_index) { //Find the edges from previous slabs that reach into this slab.
+		const size_t edge = order[sweep_index];
+		if(std::max(edges[edge].start.x, edges[edge].end.x) >= start_x) {
+			active.push_back(edge);
+		}
+	}
+
+	for(size_t sweep_index = start; sweep_index < end; ++sweep_index) {
+		const size_t edge = order[sweep_index];
+		const coord_t sweep_x = std::min(edges[edge].start.x, edges[edge].end.x);
+		const coord_t min_y = std::min(edges[edge].start.y, edges[edge].end.y);
+		const coord_t max_y = std::max(edges[edge].start.y, edges[edge].end.y);
+		for(size_t active_index = 0; active_index < active.size();) {
+			const size_t other = active[active_index];
+			if(std::max(edges[other].start.x, edges[other].end.x) < sweep_x) { //The sweep line has passed this edge. Remove it by replacing it with the last one.
+				active[active_index] = active.back();
+				active.pop_back();
+				continue;
+			}
+			if(std::max(edges[other].start.y, edges[other].end.y) >= min_y && std::min(edges[other].start.y, edges[other].end.y) <= max_y) { //Bounding boxes overlap, so they may intersect.
+				clip_test_pair(edges, edge, other, splits);
+			}
+			active_index++;
+		}
+		active.push_back(edge);
+	}
+}
+
+/*!
+ * Splits the edges at all points where they intersect other edges.
+ *
+ * The pieces of each edge replace the edge, in the same order, so the edges of
+ * each contour still form a closed loop afterwards.
+ * \param edges The edges to split. The pieces are stored in here.
+ * \param parallel Whether to divide the sweep over multiple threads.
+ * \return Whether any edge was split.
+ */
+inline bool clip_split(std::vector<ClipEdge>& edges, const bool parallel) {
+	std::vector<size_t> order(edges.size());
+	for(size_t edge = 0; edge < edges.size(); ++edge) {
+		order[edge] = edge;
+	}
+	std::sort(order.begin(), order.end(), [&edges](const size_t edge_a, const size_t edge_b) {
+		const coord_t min_a = std::min(edges[edge_a].start.x, edges[edge_a].end.x);
+		const coord_t min_b = std::min(edges[edge_b].start.x, edges[edge_b].end.x);
+		return min_a < min_b || (min_a == min_b && edge_a < edge_b);
+	});
+
+	const size_t num_slabs = parallel ? std::max(size_t(1), std::min(order.size(), size_t(omp_get_max_threads()) * 4)) : 1;
+	std::vector<std::vector<std::pair<size_t, Point2>>> slab_splits(num_slabs);
+	#pragma omp parallel for schedule(dynamic) if(parallel)
+	for(size_t slab = 0; slab < num_slabs; ++slab) {
+		const size_t start = order.size() * slab / num_slabs;
+		const size_t end = order.size() * (slab + 1) / num_slabs;
+		clip_sweep(edges, order, start, end, slab_splits[slab]);
+	}
+	std::vector<std::pair<size_t, Point2>> splits;
+	for(const std::vector<std::pair<size_t, Point2>>& slab_split : slab_splits) {
+		splits.insert(splits.end(), slab_split.begin(), slab_split.end());
+	}
+	if(splits.empty()) {
+		return false;
+	}
+
+	//Order the split points along their edges, so that the pieces can be made in order.
+	std::sort(splits.begin(), splits.end(), [&edges](const std::pair<size_t, Point2>& a, const std::pair<size_t, Point2>& b) {
+		if(a.first != b.first) {
+			return a.first < b.first;
+		}
+		const Point2 delta = edges[a.first].end - edges[a.first].start;
+		return clip_dot(a.second - edges[a.first].start, delta) < clip_dot(b.second - edges[a.first].start, delta);
+	});
+	std::vector<ClipEdge> pieces;
+	pieces.reserve(edges.size() + splits.size());
+	size_t split = 0;
+	for(size_t edge = 0; edge < edges.size(); ++edge) {
+		Point2 piece_start = edges[edge].start;
+		for(; split < splits.size() && splits[split].first == edge; ++split) {
+			if(splits[split].second != piece_start) { //Skip duplicate split points.
+				pieces.push_back({piece_start, splits[split].second, edges[edge].operand});
+				piece_start = splits[split].second;
+			}
+		}
+		if(piece_start != edges[edge].end) {
+			pieces.push_back({piece_start, edges[edge].end, edges[edge].operand});
+		}
+	}
+	edges = std::move(pieces);
+	return true;
+}
+
+/*!
+ * Merges the pieces of the edges that lie on top of each other into fragments.
+ *
+ * Fragments along which the contours pass equally often in both directions,
+ * for both shapes, are left out. They don't influence which parts of the
+ * shapes are inside.
+ * \param edges The edges to merge, split such that they only meet at their
+ * endpoints.
+ * \return The fragments, sorted by their endpoints.
+ */
+inline std::vector<ClipFragment> clip_fragments(const std::vector<ClipEdge>& edges) {
+	std::vector<ClipFragment> pieces;
+	pieces.reserve(edges.size());
+	for(const ClipEdge& edge : edges) {
+		const bool upwards = edge.start.y < edge.end.y || (edge.start.y == edge.end.y && edge.start.x < edge.end.x);
+		const int direction = upwards ? 1 : -1;
+		pieces.push_back({upwards ? edge.start : edge.end, upwards ? edge.end : edge.start, edge.operand == 0 ? direction : 0, edge.operand == 0 ? 0 : direction});
+	}
+	std::sort(pieces.begin(), pieces.end(), [](const ClipFragment& a, const ClipFragment& b) {
+		return a.lower < b.lower || (a.lower == b.lower && a.upper < b.upper);
+	});
+	std::vector<ClipFragment> fragments;
+	for(size_t piece = 0; piece < pieces.size();) {
+		ClipFragment fragment = pieces[piece];
+		for(piece++; piece < pieces.size() && pieces[piece].lower == fragment.lower && pieces[piece].upper == fragment.upper; ++piece) {
+			fragment.winding_a += pieces[piece].winding_a;
+			fragment.winding_b += pieces[piece].winding_b;
+		}
+		if(fragment.winding_a != 0 || fragment.winding_b != 0) {
+			fragments.push_back(fragment);
+		}
+	}
+	return fragments;
+}
+
+/*!
+ * Computes the winding numbers of both shapes on the left side of each
+ * fragment, when looking from the lower endpoint to the upper endpoint.
+ *
+ * For a fragment that isn't horizontal, this casts a ray from the middle of
+ * the fragment in the -X direction, and counts the fragments that it crosses.
+ * Downward crossings count positively, upward crossings negatively. Fragments
+ * are crossed if they span the height of the ray, including their lower
+ * endpoint but excluding their upper endpoint. For a horizontal fragment, the
+ * same rule gives the winding number just above the fragment, which is also
+ * its left side.
+ *
+ * Only the fragments that span the height of the ray need to be tested. To
+ * find those quickly, the fragments are divided into horizontal slabs, in the
+ * same way as ``SlabDecomposition`` does.
+ * \param fragments The fragments to compute the winding numbers of.
+ * \param windings_a The winding numbers of the first shape are stored here.
+ * \param windings_b The winding numbers of the second shape are stored here.
+ * \param parallel Whether to divide the fragments over multiple threads.
+ */
+inline void clip_windings(const std::vector<ClipFragment>& fragments, std::vector<int>& windings_a, std::vector<int>& windings_b, const bool parallel) {
+	windings_a.assign(fragments.size(), 0);
+	windings_b.assign(fragments.size(), 0);
+	std::vector<size_t> crossable; //Horizontal fragments are never crossed by the rays.
+	coord_t min_y = 0;
+	coord_t max_y = 0;
+	for(size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		if(fragments[fragment].lower.y < fragments[fragment].upper.y) {
+			min_y = crossable.empty() ? fragments[fragment].lower.y : std::min(min_y, fragments[fragment].lower.y);
+			max_y = crossable.empty() ? fragments[fragment].upper.y : std::max(max_y, fragments[fragment].upper.y);
+			crossable.push_back(fragment);
+		}
+	}
+	if(crossable.empty()) {
+		return; //Without any crossable fragments, everything is outside.
+	}
+
+	//Choose the number of slabs such that fragments don't get copied too often.
+	constexpr size_t max_copies = 8;
+	const area_t height = area_t(max_y) - min_y + 1;
+	size_t slabs = std::max(size_t(1), std::min(crossable.size() / 2, size_t(height)));
+	const auto slab = [min_y, height, &slabs](const area_t y) {
+		return size_t(std::clamp(y - min_y, area_t(0), height - 1) * slabs / height);
+	};
+	while(slabs > 1) {
+		size_t total = 0;
+		for(const size_t fragment : crossable) {
+			total += slab(fragments[fragment].upper.y) - slab(fragments[fragment].lower.y) + 1;
+		}
+		if(total <= max_copies * crossable.size()) {
+			break;
+		}
+		slabs /= 2;
+	}
+	std::vector<size_t> slab_starts(slabs + 1, 0);
+	for(const size_t fragment : crossable) {
+		for(size_t fragment_slab = slab(fragments[fragment].lower.y); fragment_slab <= slab(fragments[fragment].upper.y); ++fragment_slab) {
+			slab_starts[fragment_slab + 1]++;
+		}
+	}
+	for(size_t slab_index = 1; slab_index < slab_starts.size(); ++slab_index) {
+		slab_starts[slab_index] += slab_starts[slab_index - 1];
+	}
+	std::vector<size_t> slab_fragments(slab_starts.back());
+	std::vector<size_t> slab_fill(slab_starts.begin(), slab_starts.end() - 1); //Where to put the next fragment in each slab.
+	for(const size_t fragment : crossable) {
+		for(size_t fragment_slab = slab(fragments[fragment].lower.y); fragment_slab <= slab(fragments[fragment].upper.y); ++fragment_slab) {
+			slab_fragments[slab_fill[fragment_slab]++] = fragment;
+		}
+	}
+
+	#pragma omp parallel for schedule(dynamic, 64) if(parallel)
+	for(size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		//Work with coordinates doubled, so that the middle of the fragment is on whole coordinates.
+		const area_t middle_x = area_t(fragments[fragment].lower.x) + fragments[fragment].upper.x;
+		const area_t middle_y = area_t(fragments[fragment].lower.y) + fragments[fragment].upper.y;
+		const size_t ray_slab = slab(middle_y >> 1); //Rounding down, also for negative coordinates.
+		int winding_a = 0;
+		int winding_b = 0;
+		for(size_t index = slab_starts[ray_slab]; index < slab_starts[ray_slab + 1]; ++index) {
+			const ClipFragment& other = fragments[slab_fragments[index]];
+			if(middle_y < area_t(other.lower.y) * 2 || middle_y >= area_t(other.upper.y) * 2) {
+				continue; //Doesn't span the height of the ray.
+			}
+			const area_t delta_x = area_t(other.upper.x) - other.lower.x;
+			const area_t delta_y = area_t(other.upper.y) - other.lower.y;
+			const area_t side = delta_x * (middle_y - area_t(other.lower.y) * 2) - delta_y * (middle_x - area_t(other.lower.x) * 2);
+			if(side < 0) { //The middle is to the right of the other fragment, so the ray crosses it.
+				winding_a -= other.winding_a;
+				winding_b -= other.winding_b;
+			}
+		}
+		windings_a[fragment] = winding_a;
+		windings_b[fragment] = winding_b;
+	}
+}
+
+/*!
+ * Determines whether a point with a certain winding number is inside of a
+ * shape.
+ * \param winding The winding number of the point.
+ * \param fill_rule The rule that determines which parts are inside.
+ * \return Whether the point is inside.
+ */
+constexpr bool clip_filled(const int winding, const FillRule fill_rule) {
+	switch(fill_rule) {
+		case FillRule::NONZERO: return winding != 0;
+		case FillRule::EVEN_ODD: return (winding & 1) != 0;
+		case FillRule::POSITIVE: return winding > 0;
+	}
+	return false;
+}
+
+/*!
+ * Determines whether a point is inside of the result of a boolean operation.
+ * \param inside_a Whether the point is inside of the first shape.
+ * \param inside_b Whether the point is inside of the second shape.
+ * \param operation The boolean operation to perform.
+ * \return Whether the point is inside of the result.
+ */
+constexpr bool clip_combine(const bool inside_a, const bool inside_b, const BooleanOperation operation) {
+	switch(operation) {
+		case BooleanOperation::UNION: return inside_a || inside_b;
+		case BooleanOperation::INTERSECTION: return inside_a && inside_b;
+		case BooleanOperation::DIFFERENCE: return inside_a && !inside_b;
+	}
+	return false;
+}
+
+/*!
+ * Finds the fragments that separate the inside of the result from the
+ * outside, and directs them such that the inside is on their left side.
+ * \param fragments The fragments of the contours of both shapes.
+ * \param operation The boolean operation to perform.
+ * \param fill_rule The rule that determines which parts of the shapes are
+ * inside.
+ * \param parallel Whether to divide the fragments over multiple threads.
+ * \return The edges of the contours of the result, sorted by their start point.
+ */
+inline std::vector<std::pair<Point2, Point2>> clip_boundary(const std::vector<ClipFragment>& fragments, const BooleanOperation operation, const FillRule fill_rule, const bool parallel) {
+	std::vector<int> windings_a;
+	std::vector<int> windings_b;
+	clip_windings(fragments, windings_a, windings_b, parallel);
+	std::vector<char> boundary(fragments.size()); //0 if not part of the boundary, 1 if directed upwards, 2 if directed downwards. Not booleans, since those can't be written in parallel.
+	#pragma omp parallel for if(parallel)
+	for(size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		const bool inside_left = clip_combine(clip_filled(windings_a[fragment], fill_rule), clip_filled(windings_b[fragment], fill_rule), operation);
+		//Crossing the fragment from left to right passes each contour along it once, reducing the winding number.
+		const bool inside_right = clip_combine(clip_filled(windings_a[fragment] - fragments[fragment].winding_a, fill_rule), clip_filled(windings_b[fragment] - fragments[fragment].winding_b, fill_rule), operation);
+		boundary[fragment] = (inside_left != inside_right) ? (inside_left ? 1 : 2) : 0;
+	}
+	std::vector<std::pair<Point2, Point2>> result;
+	for(size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		if(boundary[fragment] == 1) {
+			result.emplace_back(fragments[fragment].lower, fragments[fragment].upper);
+		} else if(boundary[fragment] == 2) {
+			result.emplace_back(fragments[fragment].upper, fragments[fragment].lower);
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+/*!
+ * Tests whether a direction comes before another direction, when turning
+ * clockwise from a reference direction.
+ *
+ * The reference direction itself comes last, as if it is a full turn.
+ * \param reference The direction to start turning from.
+ * \param a The first direction to compare.
+ * \param b The second direction to compare.
+ * \return ``true`` if direction ``a`` is reached before direction ``b``.
+ */
+inline bool clip_turns_before(const Point2& reference, const Point2& a, const Point2& b) {
+	const auto quadrant = [&reference](const Point2& direction) {
+		const area_t cross = clip_cross(reference, direction);
+		if(cross < 0) {
+			return 0; //Less than half a turn.
+		}
+		if(cross == 0) {
+			return clip_dot(reference, direction) < 0 ? 1 : 3; //Exactly half a turn, or a full turn.
+		}
+		return 2; //More than half a turn.
+	};
+	const int quadrant_a = quadrant(a);
+	const int quadrant_b = quadrant(b);
+	if(quadrant_a != quadrant_b) {
+		return quadrant_a < quadrant_b;
+	}
+	return clip_cross(a, b) < 0;
+}
+
+/*!
+ * Connects the edges of the result into contours.
+ *
+ * At vertices where multiple contours meet, each incoming edge continues with
+ * the first outgoing edge clockwise from where it came from. That traces the
+ * border of the area on the left side of the edge, so contours that only touch
+ * in a vertex become separate contours. Vertices in the middle of a straight
+ * line are left out.
+ * \param boundary The edges of the result, sorted by their start point.
+ * \return The contours of the result.
+ */
+inline Batch<Polygon> clip_stitch(const std::vector<std::pair<Point2, Point2>>& boundary) {
+	std::pmr::vector<Point2> vertices;
+	vertices.reserve(boundary.size());
+	std::vector<size_t> offsets = {0};
+	std::vector<char> used(boundary.size(), false);
+	for(size_t first = 0; first < boundary.size(); ++first) {
+		if(used[first]) {
+			continue;
+		}
+		const size_t contour_start = vertices.size();
+		size_t edge = first;
+		while(!used[edge]) {
+			used[edge] = true;
+			vertices.push_back(boundary[edge].first);
+			const Point2 vertex = boundary[edge].second;
+			const Point2 back = boundary[edge].first - vertex;
+			size_t next = edge;
+			for(size_t candidate = std::lower_bound(boundary.begin(), boundary.end(), std::make_pair(vertex, vertex), [](const std::pair<Point2, Point2>& a, const std::pair<Point2, Point2>& b) {
+				return a.first < b.first;
+			}) - boundary.begin(); candidate < boundary.size() && boundary[candidate].first == vertex; ++candidate) {
+				if(next == edge || clip_turns_before(back, boundary[candidate].second - vertex, boundary[next].second - vertex)) {
+					next = candidate;
+				}
+			}
+			edge = next; //If there is no outgoing edge, this edge is used already, ending the contour.
+		}
+
+		//Remove the vertices in the middle of straight lines.
+		const size_t contour_size = vertices.size() - contour_start;
+		std::vector<Point2> contour;
+		for(size_t vertex = 0; vertex < contour_size; ++vertex) {
+			const Point2 previous = vertices[contour_start + (vertex + contour_size - 1) % contour_size];
+			const Point2 current = vertices[contour_start + vertex];
+			const Point2 following = vertices[contour_start + (vertex + 1) % contour_size];
+			if(clip_cross(current - previous, following - current) != 0 || clip_dot(current - previous, following - current) < 0) {
+				contour.push_back(current);
+			}
+		}
+		vertices.resize(contour_start);
+		if(contour.size() >= 3) {
+			vertices.insert(vertices.end(), contour.begin(), contour.end());
+			offsets.push_back(vertices.size());
+		}
+	}
+	return Batch<Polygon>(std::move(vertices), offsets);
+}
+
+/*!
+ * Single-threaded implementation of the boolean operation engine.
+ * \param edges The edges of both shapes.
+ * \param operation The boolean operation to perform.
+ * \param fill_rule The rule that determines which parts of the shapes are
+ * inside.
+ * \return The contours of the result of the operation.
+ */
+inline Batch<Polygon> clip_st(std::vector<ClipEdge> edges, const BooleanOperation operation, const FillRule fill_rule) {
+	for(size_t iteration = 0; iteration < max_clip_iterations && clip_split(edges, false); ++iteration) {}
+	return clip_stitch(clip_boundary(clip_fragments(edges), operation, fill_rule, false));
+}
+
+/*!
+ * Multi-threaded implementation of the boolean operation engine.
+ *
+ * The sweep line that finds where edges intersect is divided into slabs that
+ * are processed in parallel, in the same way as for finding self-
+ * intersections. The winding numbers of the fragments are computed in
+ * parallel too. Connecting the fragments into contours is done on a single
+ * thread.
+ * \param edges The edges of both shapes.
+ * \param operation The boolean operation to perform.
+ * \param fill_rule The rule that determines which parts of the shapes are
+ * inside.
+ * \return The contours of the result of the operation.
+ */
+inline Batch<Polygon> clip_mt(std::vector<ClipEdge> edges, const BooleanOperation operation, const FillRule fill_rule) {
+	for(size_t iteration = 0; iteration < max_clip_iterations && clip_split(edges, true); ++iteration) {}
+	return clip_stitch(clip_boundary(clip_fragments(edges), operation, fill_rule, true));
+}
+
+}
+
+}
+
+#endif //APEX_CLIP
\ No newline at end of file
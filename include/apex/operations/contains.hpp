@@ -0,0 +1,809 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_CONTAINS
+#define APEX_CONTAINS
+
+#include <algorithm> //For std::min and std::max.
+#include <utility> //To read cached bounding boxes.
+#include <vector> //To find the polygons in the vertex buffer, and to collect results from multiple threads.
+
+#include "../batch.hpp" //To query batches of points.
+#include "../coordinate.hpp" //To compute the orientation of points exactly.
+#include "../detail/fixed_size.hpp" //To unroll the loops over the vertices of fixed-size polygons.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
+#include "../detail/polygon_properties.hpp" //To skip points outside of cached bounding boxes.
+#include "../detail/scheduler.hpp" //To divide the vertices of batches over the threads.
+#include "../detail/simd_dispatch.hpp" //To compile the SIMD kernels for multiple instruction sets.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../point2.hpp" //The points to test.
+
+namespace apex {
+
+namespace detail {
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+bool contains_st(const Polygon& polygon, const Point2& point);
+
+template<polygonal Polygon>
+Batch<bool> contains_st(const Polygon& polygon, const Batch<Point2>& points);
+
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_st(const PolygonBatch& batch, const Batch<Point2>& points);
+
+template<polygonal Polygon>
+bool contains_mt(const Polygon& polygon, const Point2& point);
+
+template<polygonal Polygon>
+Batch<bool> contains_mt(const Polygon& polygon, const Batch<Point2>& points);
+
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_mt(const PolygonBatch& batch, const Batch<Point2>& points);
+
+#ifdef GPU
+template<polygonal Polygon>
+bool contains_gpu(const Polygon& polygon, const Point2& point);
+
+template<polygonal Polygon>
+Batch<bool> contains_gpu(const Polygon& polygon, const Batch<Point2>& points);
+
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_gpu(const PolygonBatch& batch, const Batch<Point2>& points);
+#endif //GPU
+
+template<fixed_polygonal Polygon>
+bool contains_st(const Polygon& polygon, const Point2& point);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_st(const PolygonBatch& batch, const Batch<Point2>& points);
+
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_mt(const PolygonBatch& batch, const Batch<Point2>& points);
+
+#ifdef GPU
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_gpu(const PolygonBatch& batch, const Batch<Point2>& points);
+#endif //GPU
+
+}
+
+/*!
+ * Tests whether a point is inside of a polygon.
+ *
+ * This uses the nonzero fill rule. The polygon winds around the point a number
+ * of times, counting counter-clockwise loops as positive and clockwise loops
+ * as negative. If the winding number is not zero, the point is inside. Holes
+ * made by looping around a region in the opposite direction are then outside,
+ * but regions that the polygon loops around twice in the same direction are
+ * inside.
+ *
+ * Points exactly on the border of the polygon are considered to be inside, so
+ * that the result doesn't depend on the winding direction of the polygon. The
+ * computation is exact, without any rounding. Like with the area, this holds
+ * for polygons that span up to half of the coordinate space in each dimension.
+ *
+ * If the polygon caches its bounding box, points outside of the bounding box
+ * are rejected without looking at the vertices.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<polygonal Polygon>
+bool contains(const Polygon& polygon, const Point2& point) {
+	if constexpr(caches_properties<Polygon>) {
+		const PolygonProperties properties = polygon.get_properties();
+		if(properties.has_bounding_box()) {
+			const std::pair<Point2, Point2> box = properties.bounding_box();
+			if(point.x < box.first.x || point.x > box.second.x || point.y < box.first.y || point.y > box.second.y) {
+				return false;
+			}
+		}
+	}
+	const detail::Dispatch dispatch(detail::Operation::contains, polygon.size());
+	switch(dispatch.version) {
+		case 0: return detail::contains_st(polygon, point);
+		case 1: return detail::contains_mt(polygon, point);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::contains_gpu(polygon, point);
+		}
+#endif //GPU
+	}
+	return detail::contains_mt(polygon, point);
+}
+
+/*!
+ * Tests for each of a batch of points whether it is inside of a polygon.
+ *
+ * The results are the same as testing each point separately. For polygons that
+ * are tested very often, a ``SlabDecomposition`` can be faster.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the points are inside.
+ * \param points The points to test.
+ * \return For each point, in the same order, whether it is inside of the
+ * polygon or on its border.
+ */
+template<polygonal Polygon>
+Batch<bool> contains(const Polygon& polygon, const Batch<Point2>& points) {
+	const detail::Dispatch dispatch(detail::Operation::contains_points, polygon.size() * points.size());
+	switch(dispatch.version) {
+		case 0: return detail::contains_st(polygon, points);
+		case 1: return detail::contains_mt(polygon, points);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::contains_gpu(polygon, points);
+		}
+#endif //GPU
+	}
+	return detail::contains_mt(polygon, points);
+}
+
+/*!
+ * Tests for each polygon in a batch whether the corresponding point is inside
+ * of it.
+ *
+ * The polygons and points are paired up by their index. The first point is
+ * tested against the first polygon, the second point against the second
+ * polygon, and so on.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test. This must have the same
+ * size as the batch of polygons.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains(const PolygonBatch& batch, const Batch<Point2>& points) {
+	const detail::Dispatch dispatch(detail::Operation::contains_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::contains_st(batch, points);
+		case 1: return detail::contains_mt(batch, points);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::contains_gpu(batch, points);
+		}
+#endif //GPU
+	}
+	return detail::contains_mt(batch, points);
+}
+
+/*!
+ * Tests whether a point is inside of a polygon with a fixed number of vertices.
+ *
+ * The result is the same as for other polygons. However the number of vertices
+ * is known at compile time, so the computation is completely unrolled. Since
+ * the number of vertices is small, this always uses the single-threaded
+ * implementation.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<fixed_polygonal Polygon>
+bool contains(const Polygon& polygon, const Point2& point) {
+	return detail::contains_st(polygon, point);
+}
+
+/*!
+ * Tests for each polygon in a batch of polygons with a fixed number of
+ * vertices whether the corresponding point is inside of it.
+ *
+ * The result is the same as for other batches. However each polygon starts at
+ * a fixed stride in the vertex array, so each lane of the vector registers can
+ * test a different polygon, with the loop over the vertices unrolled at compile
+ * time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test. This must have the same
+ * size as the batch of polygons.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains(const PolygonBatch& batch, const Batch<Point2>& points) {
+	const detail::Dispatch dispatch(detail::Operation::contains_fixed_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::contains_st(batch, points);
+		case 1: return detail::contains_mt(batch, points);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::contains_gpu(batch, points);
+		}
+#endif //GPU
+	}
+	return detail::contains_mt(batch, points);
+}
+
+namespace detail {
+
+/*!
+ * Computes how an edge of a polygon contributes to its winding number around
+ * a point.
+ *
+ * A ray is cast from the point towards positive X. If the edge crosses the ray
+ * going upwards, it winds counter-clockwise around the point. If it crosses
+ * going downwards, it winds clockwise. The start of the edge is included in
+ * the edge, and the end is not, so that a ray through a vertex counts the
+ * crossing only once. Which side of the edge the point is on is computed
+ * exactly with the cross product.
+ *
+ * This doesn't branch, so that it can be vectorised.
+ * \param start The start of the edge.
+ * \param end The end of the edge.
+ * \param point The point to compute the winding number around.
+ * \return 1 if the edge crosses the ray counter-clockwise, -1 if it crosses
+ * clockwise, or 0 if it doesn't cross the ray.
+ */
+constexpr int winding_crossing(const Point2& start, const Point2& end, const Point2& point) {
+	const area_t side = (area_t(end.x) - start.x) * (area_t(point.y) - start.y) - (area_t(point.x) - start.x) * (area_t(end.y) - start.y); //Positive if the point is left of the edge.
+	const int upwards = (start.y <= point.y) & (end.y > point.y) & (side > 0);
+	const int downwards = (start.y > point.y) & (end.y <= point.y) & (side < 0);
+	return upwards - downwards;
+}
+
+/*!
+ * Tests whether a point lies exactly on an edge of a polygon.
+ *
+ * This doesn't branch, so that it can be vectorised.
+ * \param start The start of the edge.
+ * \param end The end of the edge.
+ * \param point The point to test.
+ * \return 1 if the point is on the edge, including its endpoints, or 0 if it
+ * isn't.
+ */
+constexpr int on_edge(const Point2& start, const Point2& end, const Point2& point) {
+	const area_t side = (area_t(end.x) - start.x) * (area_t(point.y) - start.y) - (area_t(point.x) - start.x) * (area_t(end.y) - start.y);
+	return (side == 0) & (std::min(start.x, end.x) <= point.x) & (point.x <= std::max(start.x, end.x)) & (std::min(start.y, end.y) <= point.y) & (point.y <= std::max(start.y, end.y));
+}
+
+/*!
+ * Tests whether a point is inside of a polygon with SIMD instructions.
+ *
+ * The winding numbers of all edges are summed with a reduction. Whether the
+ * point is on any of the edges is reduced in the same pass.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \param size The number of vertices.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+APEX_SIMD_CLONES inline bool contains_vertices(const Point2* vertices, const size_t size, const Point2 point) {
+	if(size == 0) {
+		return false;
+	}
+	int winding = winding_crossing(vertices[size - 1], vertices[0], point); //The closing edge.
+	int border = on_edge(vertices[size - 1], vertices[0], point);
+	#pragma omp simd reduction(+:winding) reduction(|:border)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		winding += winding_crossing(vertices[vertex - 1], vertices[vertex], point);
+		border |= on_edge(vertices[vertex - 1], vertices[vertex], point);
+	}
+	return border || winding != 0;
+}
+
+/*!
+ * Tests whether a point is inside of a polygon, given the edges of the polygon
+ * as separate arrays of start and end points, with SIMD instructions.
+ *
+ * This gives the same result as ``contains_vertices`` if all edges of the
+ * polygon are given, but also allows testing a subset of the edges, if the
+ * other edges are known not to cross the ray from the point.
+ * \param starts The start of each edge.
+ * \param ends The end of each edge.
+ * \param size The number of edges.
+ * \param point The point to test.
+ * \return ``true`` if the edges wind around the point or the point is on one
+ * of the edges, or ``false`` otherwise.
+ */
+APEX_SIMD_CLONES inline bool contains_edges(const Point2* starts, const Point2* ends, const size_t size, const Point2 point) {
+	int winding = 0;
+	int border = 0;
+	#pragma omp simd reduction(+:winding) reduction(|:border)
+	for(size_t edge = 0; edge < size; ++edge) {
+		winding += winding_crossing(starts[edge], ends[edge], point);
+		border |= on_edge(starts[edge], ends[edge], point);
+	}
+	return border || winding != 0;
+}
+
+/*!
+ * Sums the winding numbers of some of the edges of a polygon around a point,
+ * with SIMD instructions.
+ *
+ * Only the edges ending in the vertices from ``begin`` up to ``end`` are
+ * summed. Each edge runs from the previous vertex to that vertex, so the edge
+ * ending in vertex 0 is the closing edge from the last vertex. Summing the
+ * winding numbers of the ranges of any partition of the vertices gives the
+ * winding number of the entire polygon.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \param size The number of vertices in the polygon.
+ * \param begin The first vertex of the range to sum.
+ * \param end The vertex past the last vertex of the range to sum.
+ * \param point The point to compute the winding number around.
+ * \return The winding number of the edges in the range, and whether the point
+ * is on any of those edges.
+ */
+APEX_SIMD_CLONES inline std::pair<int, int> contains_range(const Point2* vertices, const size_t size, size_t begin, const size_t end, const Point2 point) {
+	int winding = 0;
+	int border = 0;
+	if(begin == 0 && end > 0) {
+		winding = winding_crossing(vertices[size - 1], vertices[0], point); //The closing edge.
+		border = on_edge(vertices[size - 1], vertices[0], point);
+		begin = 1;
+	}
+	#pragma omp simd reduction(+:winding) reduction(|:border)
+	for(size_t vertex = begin; vertex < end; ++vertex) {
+		winding += winding_crossing(vertices[vertex - 1], vertices[vertex], point);
+		border |= on_edge(vertices[vertex - 1], vertices[vertex], point);
+	}
+	return std::make_pair(winding, border);
+}
+
+/*!
+ * Single-threaded implementation of ``contains``.
+ *
+ * This sums the winding numbers of all edges with SIMD instructions. The
+ * vertices of the polygon must be stored contiguously in memory, like they are
+ * in a ``Polygon`` and in the polygons of a ``Batch<Polygon>``.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<polygonal Polygon>
+bool contains_st(const Polygon& polygon, const Point2& point) {
+	if(polygon.size() == 0) {
+		return false;
+	}
+	return contains_vertices(&polygon[0], polygon.size(), point);
+}
+
+/*!
+ * Single-threaded implementation of ``contains`` for a batch of points.
+ *
+ * Each point is tested in turn, summing the winding numbers of the edges with
+ * SIMD instructions.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the points are inside.
+ * \param points The points to test.
+ * \return For each point, whether it is inside of the polygon or on its
+ * border.
+ */
+template<polygonal Polygon>
+Batch<bool> contains_st(const Polygon& polygon, const Batch<Point2>& points) {
+	Batch<bool> result;
+	result.reserve(points.size());
+	const size_t size = polygon.size();
+	const Point2* vertices = size == 0 ? nullptr : &polygon[0];
+	for(const Point2& point : points) {
+		result.push_back(contains_vertices(vertices, size, point));
+	}
+	return result;
+}
+
+/*!
+ * Single-threaded implementation of ``contains`` for a batch of polygons.
+ *
+ * Each polygon is tested against its point in turn, summing the winding
+ * numbers of the edges with SIMD instructions.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_st(const PolygonBatch& batch, const Batch<Point2>& points) {
+	Batch<bool> result;
+	result.reserve(batch.size());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result.push_back(contains_st(batch[polygon], points[polygon]));
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``contains``.
+ *
+ * The edges are divided over the threads. Each thread sums the winding numbers
+ * of its edges, and these are combined with a parallel reduction.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<polygonal Polygon>
+bool contains_mt(const Polygon& polygon, const Point2& point) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return false;
+	}
+	const Point2* vertices = &polygon[0]; //Synchronises the vertices with the GPU once, rather than for each vertex accessed.
+	int winding = winding_crossing(vertices[size - 1], vertices[0], point); //The closing edge.
+	int border = on_edge(vertices[size - 1], vertices[0], point);
+	#pragma omp parallel for simd reduction(+:winding) reduction(|:border)
+	for(size_t vertex = 1; vertex < size; ++vertex) {
+		winding += winding_crossing(vertices[vertex - 1], vertices[vertex], point);
+		border |= on_edge(vertices[vertex - 1], vertices[vertex], point);
+	}
+	return border || winding != 0;
+}
+
+/*!
+ * Multi-threaded implementation of ``contains`` for a batch of points.
+ *
+ * The points are divided over the threads. Each thread tests its points with
+ * SIMD instructions.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the points are inside.
+ * \param points The points to test.
+ * \return For each point, whether it is inside of the polygon or on its
+ * border.
+ */
+template<polygonal Polygon>
+Batch<bool> contains_mt(const Polygon& polygon, const Batch<Point2>& points) {
+	const size_t size = polygon.size();
+	const Point2* vertices = size == 0 ? nullptr : &polygon[0];
+	std::vector<char> inside(points.size()); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	#pragma omp parallel for
+	for(size_t point = 0; point < points.size(); ++point) {
+		inside[point] = contains_vertices(vertices, size, points[point]);
+	}
+	return Batch<bool>(inside.begin(), inside.end());
+}
+
+/*!
+ * Multi-threaded implementation of ``contains`` for a batch of polygons.
+ *
+ * The ``Scheduler`` divides the vertices of all polygons over the threads, so
+ * that big polygons are split over multiple threads and small polygons are
+ * grouped together. The winding numbers of the parts of a split polygon are
+ * added together.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_mt(const PolygonBatch& batch, const Batch<Point2>& points) {
+	const size_t batch_size = batch.size();
+
+	const Point2* vertices = batch.data_subelements();
+	const VertexRanges ranges(batch);
+
+	std::vector<int> windings(batch_size, 0);
+	std::vector<int> borders(batch_size, 0);
+	Scheduler::for_each_range(ranges.offsets, [&](const size_t polygon, const size_t begin, const size_t end) {
+		const size_t size = ranges.size(polygon);
+		const std::pair<int, int> part = contains_range(vertices + ranges.starts[polygon], size, begin, end, points[polygon]);
+		if(begin == 0 && end == size) { //Polygon lies completely within this task, so no other thread writes to it.
+			windings[polygon] = part.first;
+			borders[polygon] = part.second;
+		} else {
+			#pragma omp atomic
+			windings[polygon] += part.first;
+			#pragma omp atomic
+			borders[polygon] |= part.second;
+		}
+	});
+
+	Batch<bool> result;
+	result.reserve(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		result.push_back(borders[polygon] || windings[polygon] != 0);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``contains`` that runs on the graphics card, if available.
+ *
+ * The winding numbers of the edges are summed with a parallel reduction on the
+ * GPU. If the polygon is tracked by the ``GPUDataTracker``, the vertices are
+ * left on the GPU for subsequent operations.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<polygonal Polygon>
+bool contains_gpu(const Polygon& polygon, const Point2& point) {
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return false;
+	}
+	const Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Leave the vertices on the GPU for subsequent operations.
+	}
+	int winding = 0;
+	int border = 0;
+	#pragma omp target teams distribute parallel for map(to:vertices[0:size]) map(tofrom:winding, border) reduction(+:winding) reduction(|:border)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const size_t previous = (vertex + size - 1) % size;
+		winding += winding_crossing(vertices[previous], vertices[vertex], point);
+		border |= on_edge(vertices[previous], vertices[vertex], point);
+	}
+	return border || winding != 0;
+}
+
+/*!
+ * Implementation of ``contains`` for a batch of points that runs on the
+ * graphics card, if available.
+ *
+ * Each point is tested by a separate thread on the GPU, which loops over all
+ * edges of the polygon.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to test whether the points are inside.
+ * \param points The points to test.
+ * \return For each point, whether it is inside of the polygon or on its
+ * border.
+ */
+template<polygonal Polygon>
+Batch<bool> contains_gpu(const Polygon& polygon, const Batch<Point2>& points) {
+	const size_t size = polygon.size();
+	const size_t num_points = points.size();
+	if(size == 0) {
+		return Batch<bool>(num_points, false);
+	}
+	const Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Leave the vertices on the GPU for subsequent operations.
+	}
+	const Point2* points_data = points.data();
+	std::vector<char> inside(num_points); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* inside_data = inside.data();
+	#pragma omp target teams distribute parallel for map(to:vertices[0:size], points_data[0:num_points]) map(from:inside_data[0:num_points])
+	for(size_t point = 0; point < num_points; ++point) {
+		int winding = 0;
+		int border = 0;
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const size_t previous = vertex == 0 ? size - 1 : vertex - 1;
+			winding += winding_crossing(vertices[previous], vertices[vertex], points_data[point]);
+			border |= on_edge(vertices[previous], vertices[vertex], points_data[point]);
+		}
+		inside_data[point] = border || winding != 0;
+	}
+	return Batch<bool>(inside.begin(), inside.end());
+}
+
+/*!
+ * Implementation of ``contains`` for a batch of polygons that runs on the
+ * graphics card, if available.
+ *
+ * Each polygon is processed by a team on the GPU, and the winding numbers of
+ * its edges are reduced in parallel within the team.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<bool> contains_gpu(const PolygonBatch& batch, const Batch<Point2>& points) {
+	const size_t batch_size = batch.size();
+	std::vector<char> inside(batch_size); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* inside_data = inside.data();
+
+	const Subbatch<Point2>* polygons = batch.data();
+	const Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	const Point2* points_data = points.data();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Leave the vertices on the GPU for subsequent operations.
+	}
+	#pragma omp target teams distribute map(to:vertices[0:vertices_size], polygons[0:batch_size], points_data[0:batch_size]) map(from:inside_data[0:batch_size])
+	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
+		const auto& polygon = polygons[polygon_index];
+		const size_t size = polygon.size();
+		const Point2 point = points_data[polygon_index];
+		int winding = 0;
+		int border = 0;
+		#pragma omp parallel for reduction(+:winding) reduction(|:border)
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const size_t previous = (vertex + size - 1) % size;
+			winding += winding_crossing(polygon[previous], polygon[vertex], point);
+			border |= on_edge(polygon[previous], polygon[vertex], point);
+		}
+		inside_data[polygon_index] = border || winding != 0;
+	}
+	return Batch<bool>(inside.begin(), inside.end());
+}
+#endif //GPU
+
+/*!
+ * Tests whether a point is inside of a polygon with a number of vertices that
+ * is known at compile time.
+ *
+ * The winding numbers of all edges are summed like in ``contains_vertices``,
+ * but the loop over the edges is unrolled completely. The index of the start
+ * of each edge is then a constant.
+ * \tparam size The number of vertices of the polygon.
+ * \param vertices The vertices of the polygon, stored contiguously.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<size_t size>
+constexpr bool contains_fixed_vertices(const Point2* vertices, const Point2& point) {
+	int winding = 0;
+	int border = 0;
+	unroll<size>([&]<size_t vertex>() {
+		constexpr size_t previous = (vertex + size - 1) % size;
+		winding += winding_crossing(vertices[previous], vertices[vertex], point);
+		border |= on_edge(vertices[previous], vertices[vertex], point);
+	});
+	return border || winding != 0;
+}
+
+/*!
+ * Tests a range of polygons in a batch of polygons with a fixed number of
+ * vertices against their points, with SIMD instructions.
+ *
+ * The loop over the polygons is vectorised, so that each lane of the vector
+ * registers tests a different polygon against its point. The loop over the
+ * edges of each polygon is unrolled at compile time.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \tparam size The number of vertices of each polygon.
+ * \param vertices The vertices of all polygons in the batch, stored
+ * contiguously.
+ * \param points For each polygon, the point to test.
+ * \param begin The first polygon of the range to test.
+ * \param end The polygon past the last polygon of the range to test.
+ * \param inside An array to store for each polygon whether its point is inside,
+ * at the same index as the polygon.
+ */
+template<size_t size>
+APEX_SIMD_CLONES inline void contains_fixed_range(const Point2* vertices, const Point2* points, const size_t begin, const size_t end, char* inside) {
+	#pragma omp simd
+	for(size_t polygon = begin; polygon < end; ++polygon) {
+		inside[polygon] = contains_fixed_vertices<size>(vertices + polygon * size, points[polygon]);
+	}
+}
+
+/*!
+ * Single-threaded implementation of ``contains`` for polygons with a fixed
+ * number of vertices.
+ *
+ * The loop over the edges is unrolled at compile time.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to test whether the point is inside.
+ * \param point The point to test.
+ * \return ``true`` if the point is inside of the polygon or on its border, or
+ * ``false`` if it is outside.
+ */
+template<fixed_polygonal Polygon>
+bool contains_st(const Polygon& polygon, const Point2& point) {
+	return contains_fixed_vertices<Polygon::fixed_size>(polygon.data(), point);
+}
+
+/*!
+ * Single-threaded implementation of ``contains`` for batches of polygons with a
+ * fixed number of vertices.
+ *
+ * All polygons are tested with SIMD instructions, several polygons at a time.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_st(const PolygonBatch& batch, const Batch<Point2>& points) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	std::vector<char> inside(batch_size); //Not booleans, since those are packed into bits that can't be written in vector lanes.
+	contains_fixed_range<size>(batch.data(), points.data(), 0, batch_size, inside.data());
+	return Batch<bool>(inside.begin(), inside.end());
+}
+
+/*!
+ * Multi-threaded implementation of ``contains`` for batches of polygons with a
+ * fixed number of vertices.
+ *
+ * The polygons are divided over the threads in blocks. Since all polygons have
+ * the same size, each block takes equally long. Each thread tests its blocks
+ * with SIMD instructions, like ``contains_st``.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_mt(const PolygonBatch& batch, const Batch<Point2>& points) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	std::vector<char> inside(batch_size); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* inside_data = inside.data();
+	const Point2* vertices = batch.data();
+	const Point2* points_data = points.data();
+	#pragma omp parallel for
+	for(size_t begin = 0; begin < batch_size; begin += fixed_block_size) {
+		contains_fixed_range<size>(vertices, points_data, begin, std::min(begin + fixed_block_size, batch_size), inside_data);
+	}
+	return Batch<bool>(inside.begin(), inside.end());
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``contains`` that runs on the graphics card, if available,
+ * for batches of polygons with a fixed number of vertices.
+ *
+ * Each thread on the GPU tests one polygon against its point. The loop over
+ * the edges has a constant number of iterations, so the compiler can unroll
+ * it.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The polygons to test whether the points are inside.
+ * \param points For each polygon, a point to test.
+ * \return For each polygon, whether the corresponding point is inside of it or
+ * on its border.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+Batch<bool> contains_gpu(const PolygonBatch& batch, const Batch<Point2>& points) {
+	constexpr size_t size = PolygonBatch::fixed_size;
+	const size_t batch_size = batch.size();
+	std::vector<char> inside(batch_size); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* inside_data = inside.data();
+	const Point2* vertices = batch.data();
+	const size_t vertices_size = batch.size_subelements();
+	const Point2* points_data = points.data();
+	#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size], points_data[0:batch_size]) map(from:inside_data[0:batch_size])
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		const Point2* polygon_vertices = vertices + polygon * size;
+		const Point2 point = points_data[polygon];
+		int winding = 0;
+		int border = 0;
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const size_t previous = vertex == 0 ? size - 1 : vertex - 1;
+			winding += winding_crossing(polygon_vertices[previous], polygon_vertices[vertex], point);
+			border |= on_edge(polygon_vertices[previous], polygon_vertices[vertex], point);
+		}
+		inside_data[polygon] = border || winding != 0;
+	}
+	return Batch<bool>(inside.begin(), inside.end());
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_CONTAINS
\ No newline at end of file
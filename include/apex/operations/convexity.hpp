@@ -0,0 +1,536 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_CONVEXITY
+#define APEX_CONVEXITY
+
+#include <omp.h> //To classify the vertices on multiple threads.
+#include <vector> //To find where the polygons of a batch are in the vertex buffer.
+
+#include "../batch.hpp" //To return the convexity of each polygon in a batch.
+#include "../coordinate.hpp" //To compute the turns at the vertices exactly.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/polygon_properties.hpp" //To cache the convexity, orientation and area of polygons.
+#include "../detail/scheduler.hpp" //To divide the vertices of batches over the threads.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../point2.hpp" //To access coordinates of vertices.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * What was found out about the turns that a polygon makes at its vertices.
+ *
+ * This is collected in a single pass over the vertices, together with the area
+ * of the polygon, since both are computed from the same vertices. From this,
+ * both the convexity and the orientation of the polygon can be derived.
+ */
+struct TurnSummary {
+	/*!
+	 * Twice the surface area of the polygon, computed with the shoelace formula.
+	 */
+	area_t double_area = 0;
+
+	/*!
+	 * The number of vertices where the contour turns left.
+	 */
+	size_t left_turns = 0;
+
+	/*!
+	 * The number of vertices where the contour turns right.
+	 */
+	size_t right_turns = 0;
+
+	/*!
+	 * The number of vertices where the contour reverses direction, going back
+	 * along the edge it came from.
+	 */
+	size_t reversals = 0;
+
+	/*!
+	 * How many times the direction of the contour turns around completely.
+	 *
+	 * This is counted by how many times the direction of the contour passes the
+	 * positive X direction, counting positively when turning counter-clockwise
+	 * and negatively when turning clockwise. Simple polygons have a turning
+	 * number of 1 or -1.
+	 */
+	coord_t turning_number = 0;
+};
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+TurnSummary turns_uncached(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_uncached(const PolygonBatch& batch);
+
+template<polygonal Polygon>
+TurnSummary turns_st(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_st(const PolygonBatch& batch);
+
+template<polygonal Polygon>
+TurnSummary turns_mt(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_mt(const PolygonBatch& batch);
+
+#ifdef GPU
+template<polygonal Polygon>
+TurnSummary turns_gpu(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_gpu(const PolygonBatch& batch);
+#endif //GPU
+
+inline PolygonProperties::Convexity classify_convexity(const TurnSummary& turns, const PolygonProperties::SelfIntersecting self_intersecting);
+inline PolygonProperties::Orientation classify_orientation(const TurnSummary& turns, const PolygonProperties::SelfIntersecting self_intersecting);
+inline void store_turns(const TurnSummary& turns, PolygonProperties& properties);
+
+}
+
+/*!
+ * Finds whether a polygon is convex or concave.
+ *
+ * A polygon is convex if it turns the same way at every vertex, and goes around
+ * exactly once. Vertices that coincide with their neighbours and vertices in
+ * the middle of a straight line are not counted as turns. Polygons without area
+ * are degenerate, as are polygons that are found to intersect themselves, such
+ * as polygons that go around more than once, or turn back on themselves. A
+ * polygon that turns both ways is concave, unless it is already known to
+ * intersect itself.
+ *
+ * The convexity is computed in the same pass over the vertices as the area and
+ * the orientation. If the polygon caches its properties, all of these are
+ * stored in the cache, so that they don't need to be computed again.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find the convexity of.
+ * \return Whether the polygon is convex, concave or degenerate.
+ */
+template<polygonal Polygon>
+PolygonProperties::Convexity convexity(const Polygon& polygon) {
+	if constexpr(caches_properties<Polygon>) {
+		PolygonProperties properties = polygon.get_properties();
+		if(properties.convexity() == PolygonProperties::Convexity::UNKNOWN) {
+			detail::store_turns(detail::turns_uncached(polygon), properties);
+			polygon.set_properties(properties);
+		}
+		return properties.convexity();
+	}
+	return detail::classify_convexity(detail::turns_uncached(polygon), PolygonProperties::SelfIntersecting::UNKNOWN);
+}
+
+/*!
+ * Finds whether each polygon in a batch is convex or concave.
+ *
+ * See the ``convexity`` of a single polygon for how the polygons are
+ * classified. If the batch caches the properties of its polygons, the
+ * convexity, orientation and area of all polygons are stored in the cache.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to find the convexity of.
+ * \return For each polygon, whether it is convex, concave or degenerate, in the
+ * same order as the order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<PolygonProperties::Convexity> convexity(const PolygonBatch& batch) {
+	Batch<PolygonProperties::Convexity> result;
+	result.reserve(batch.size());
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const PolygonProperties::Convexity cached = batch.get_properties(polygon).convexity();
+			if(cached == PolygonProperties::Convexity::UNKNOWN) {
+				break; //Classifying the whole batch at once is more efficient than classifying the missing ones separately.
+			}
+			result.push_back(cached);
+		}
+		if(result.size() == batch.size()) {
+			return result;
+		}
+		result.clear();
+		const Batch<detail::TurnSummary> turns = detail::turns_uncached(batch);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			PolygonProperties properties = batch.get_properties(polygon);
+			detail::store_turns(turns[polygon], properties);
+			batch.set_properties(polygon, properties);
+			result.push_back(properties.convexity());
+		}
+		return result;
+	}
+	for(const detail::TurnSummary& turns : detail::turns_uncached(batch)) {
+		result.push_back(detail::classify_convexity(turns, PolygonProperties::SelfIntersecting::UNKNOWN));
+	}
+	return result;
+}
+
+namespace detail {
+
+/*!
+ * Classifies the turns of a polygon with the fastest version of the
+ * operation.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to classify the turns of.
+ * \return A summary of the turns of the polygon.
+ */
+template<polygonal Polygon>
+TurnSummary turns_uncached(const Polygon& polygon) {
+	const Dispatch dispatch(Operation::convexity, polygon.size());
+	switch(dispatch.version) {
+		case 0: return turns_st(polygon);
+		case 1: return turns_mt(polygon);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return turns_gpu(polygon);
+		}
+#endif //GPU
+	}
+	return turns_mt(polygon);
+}
+
+/*!
+ * Classifies the turns of each polygon in a batch with the fastest version of
+ * the operation.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to classify the turns of.
+ * \return For each polygon, a summary of its turns.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_uncached(const PolygonBatch& batch) {
+	const Dispatch dispatch(Operation::convexity_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return turns_st(batch);
+		case 1: return turns_mt(batch);
+#ifdef GPU
+		default: {
+			const Strategies::GPUReservation reservation;
+			return turns_gpu(batch);
+		}
+#endif //GPU
+	}
+	return turns_mt(batch);
+}
+
+/*!
+ * Derives the convexity of a polygon from the turns it makes.
+ * \param turns A summary of the turns of the polygon.
+ * \param self_intersecting What is already known about whether the polygon
+ * intersects itself.
+ * \return Whether the polygon is convex, concave or degenerate.
+ */
+inline PolygonProperties::Convexity classify_convexity(const TurnSummary& turns, const PolygonProperties::SelfIntersecting self_intersecting) {
+	if(turns.double_area == 0 || turns.reversals > 0 || (turns.turning_number != 1 && turns.turning_number != -1)) {
+		return PolygonProperties::Convexity::DEGENERATE;
+	}
+	if(turns.left_turns == 0 || turns.right_turns == 0) {
+		return PolygonProperties::Convexity::CONVEX; //Turning the same way everywhere, going around only once. That can't intersect itself.
+	}
+	return self_intersecting == PolygonProperties::SelfIntersecting::YES ? PolygonProperties::Convexity::DEGENERATE : PolygonProperties::Convexity::CONCAVE;
+}
+
+/*!
+ * Derives the orientation of a polygon from the turns it makes.
+ *
+ * If the polygon is known not to intersect itself, or if it is convex, the sign
+ * of the area gives the orientation. Otherwise, polygons whose turning number
+ * disagrees with the sign of their area, such as figure eights, are mixed.
+ * \param turns A summary of the turns of the polygon.
+ * \param self_intersecting What is already known about whether the polygon
+ * intersects itself.
+ * \return The orientation of the polygon.
+ */
+inline PolygonProperties::Orientation classify_orientation(const TurnSummary& turns, const PolygonProperties::SelfIntersecting self_intersecting) {
+	if(turns.left_turns == 0 && turns.right_turns == 0) {
+		return PolygonProperties::Orientation::UNKNOWN; //All vertices are on a line. There is nothing to go around.
+	}
+	const bool simple = self_intersecting == PolygonProperties::SelfIntersecting::NO || classify_convexity(turns, self_intersecting) == PolygonProperties::Convexity::CONVEX;
+	if(turns.double_area > 0 && (simple || turns.turning_number > 0)) {
+		return PolygonProperties::Orientation::POSITIVE;
+	}
+	if(turns.double_area < 0 && (simple || turns.turning_number < 0)) {
+		return PolygonProperties::Orientation::NEGATIVE;
+	}
+	return PolygonProperties::Orientation::MIXED;
+}
+
+/*!
+ * Stores everything that was derived from the turns of a polygon in its
+ * properties.
+ * \param turns A summary of the turns of the polygon.
+ * \param properties The properties of the polygon to update.
+ */
+inline void store_turns(const TurnSummary& turns, PolygonProperties& properties) {
+	const PolygonProperties::Convexity convexity = classify_convexity(turns, properties.self_intersecting());
+	const PolygonProperties::Orientation orientation = classify_orientation(turns, properties.self_intersecting());
+	if(convexity == PolygonProperties::Convexity::CONVEX) {
+		properties.set_self_intersecting(PolygonProperties::SelfIntersecting::NO);
+	}
+	properties.set_convexity(convexity);
+	properties.set_area(turns.double_area / 2);
+	if(orientation != PolygonProperties::Orientation::UNKNOWN) {
+		properties.set_orientation(orientation);
+	}
+}
+
+/*!
+ * Classifies the turn that a contour makes at one of its vertices.
+ *
+ * Vertices that coincide with the vertex before them don't make a turn of their
+ * own. For the other vertices, the nearest distinct vertices before and after
+ * the vertex determine the turn. That way, zero-length edges don't hide the
+ * turns that are made around them.
+ *
+ * The turn is added to the summary as a left turn, right turn or reversal, and
+ * the edge ending in this vertex is added to the area. If the direction of the
+ * contour passes the positive X direction during the turn, the turning number
+ * is updated as well. Summing the results of all vertices, in any order, gives
+ * the summary of the entire polygon.
+ * \tparam Vertices A type that can be indexed to get the vertices, such as a
+ * polygon or a pointer.
+ * \param vertices The vertices of the polygon.
+ * \param size The number of vertices of the polygon.
+ * \param vertex The vertex to classify.
+ * \param turns The summary to add the turn to.
+ */
+template<typename Vertices>
+inline void classify_turn(const Vertices& vertices, const size_t size, const size_t vertex, TurnSummary& turns) {
+	const Point2 current = vertices[vertex];
+	size_t previous = (vertex + size - 1) % size;
+	const Point2 before = vertices[previous];
+	turns.double_area += static_cast<area_t>(before.x) * current.y - static_cast<area_t>(before.y) * current.x;
+	if(before.x == current.x && before.y == current.y) {
+		return; //Not a turn of its own. Any turn here is made at the first vertex of the run of coinciding vertices.
+	}
+	size_t next = (vertex + 1) % size;
+	while(next != vertex && vertices[next].x == current.x && vertices[next].y == current.y) {
+		next = (next + 1) % size;
+	}
+	while(previous != vertex && vertices[previous].x == current.x && vertices[previous].y == current.y) {
+		previous = (previous + size - 1) % size;
+	}
+	const Point2 from = vertices[previous];
+	const Point2 to = vertices[next];
+	const area_t incoming_x = area_t(current.x) - from.x;
+	const area_t incoming_y = area_t(current.y) - from.y;
+	const area_t outgoing_x = area_t(to.x) - current.x;
+	const area_t outgoing_y = area_t(to.y) - current.y;
+	const area_t cross = incoming_x * outgoing_y - incoming_y * outgoing_x;
+	const area_t dot = incoming_x * outgoing_x + incoming_y * outgoing_y;
+	//Directions pointing up, or exactly to the negative X direction, are in the upper half. The positive X direction separates it from the lower half.
+	const bool incoming_upper = incoming_y > 0 || (incoming_y == 0 && incoming_x < 0);
+	const bool outgoing_upper = outgoing_y > 0 || (outgoing_y == 0 && outgoing_x < 0);
+	if(cross > 0) {
+		++turns.left_turns;
+		turns.turning_number += !incoming_upper && outgoing_upper;
+	} else if(cross < 0) {
+		++turns.right_turns;
+		turns.turning_number -= incoming_upper && !outgoing_upper;
+	} else if(dot < 0) {
+		++turns.reversals;
+	}
+}
+
+/*!
+ * Single-threaded implementation of classifying the turns of a polygon.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to classify the turns of.
+ * \return A summary of the turns of the polygon.
+ */
+template<polygonal Polygon>
+TurnSummary turns_st(const Polygon& polygon) {
+	TurnSummary turns;
+	const size_t size = polygon.size();
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		classify_turn(polygon, size, vertex, turns);
+	}
+	return turns;
+}
+
+/*!
+ * Single-threaded implementation of classifying the turns of each polygon in a
+ * batch.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to classify the turns of.
+ * \return For each polygon, a summary of its turns.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_st(const PolygonBatch& batch) {
+	Batch<TurnSummary> result;
+	result.reserve(batch.size());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		result.push_back(turns_st(batch[polygon]));
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of classifying the turns of a polygon.
+ *
+ * The vertices are classified in parallel. Each thread sums the turns it
+ * found, which are then combined with a reduction.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to classify the turns of.
+ * \return A summary of the turns of the polygon.
+ */
+template<polygonal Polygon>
+TurnSummary turns_mt(const Polygon& polygon) {
+	area_t double_area = 0;
+	size_t left_turns = 0;
+	size_t right_turns = 0;
+	size_t reversals = 0;
+	coord_t turning_number = 0;
+	const size_t size = polygon.size();
+	#pragma omp parallel for reduction(+:double_area, left_turns, right_turns, reversals, turning_number)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		TurnSummary turns;
+		classify_turn(polygon, size, vertex, turns);
+		double_area += turns.double_area;
+		left_turns += turns.left_turns;
+		right_turns += turns.right_turns;
+		reversals += turns.reversals;
+		turning_number += turns.turning_number;
+	}
+	return TurnSummary{double_area, left_turns, right_turns, reversals, turning_number};
+}
+
+/*!
+ * Multi-threaded implementation of classifying the turns of each polygon in a
+ * batch.
+ *
+ * The ``Scheduler`` divides the vertices of all polygons over the threads, so
+ * that big polygons are split over multiple threads and small polygons are
+ * grouped together. The summaries of the parts of a split polygon are added
+ * together.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to classify the turns of.
+ * \return For each polygon, a summary of its turns.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_mt(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	Batch<TurnSummary> result;
+	result.resize(batch_size); //Resize, so that all threads can enter their data in parallel.
+
+	const Point2* vertices = batch.data_subelements();
+	const VertexRanges ranges(batch);
+
+	Scheduler::for_each_range(ranges.offsets, [&](const size_t polygon, const size_t begin, const size_t end) {
+		const size_t size = ranges.size(polygon);
+		const Point2* polygon_vertices = vertices + ranges.starts[polygon];
+		TurnSummary part;
+		for(size_t vertex = begin; vertex < end; ++vertex) {
+			classify_turn(polygon_vertices, size, vertex, part);
+		}
+		if(begin == 0 && end == size) { //Polygon lies completely within this task, so no other thread writes to it.
+			result[polygon] = part;
+		} else {
+			TurnSummary& total = result[polygon];
+			#pragma omp atomic
+			total.double_area += part.double_area;
+			#pragma omp atomic
+			total.left_turns += part.left_turns;
+			#pragma omp atomic
+			total.right_turns += part.right_turns;
+			#pragma omp atomic
+			total.reversals += part.reversals;
+			#pragma omp atomic
+			total.turning_number += part.turning_number;
+		}
+	});
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of classifying the turns of a polygon that runs on the
+ * graphics card, if available.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to classify the turns of.
+ * \return A summary of the turns of the polygon.
+ */
+template<polygonal Polygon>
+TurnSummary turns_gpu(const Polygon& polygon) {
+	area_t double_area = 0;
+	size_t left_turns = 0;
+	size_t right_turns = 0;
+	size_t reversals = 0;
+	coord_t turning_number = 0;
+	const size_t size = polygon.size();
+	const Point2* vertices = polygon.data();
+	#pragma omp target teams distribute parallel for map(to:vertices[0:size]) map(tofrom:double_area, left_turns, right_turns, reversals, turning_number) reduction(+:double_area, left_turns, right_turns, reversals, turning_number)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		TurnSummary turns;
+		classify_turn(vertices, size, vertex, turns);
+		double_area += turns.double_area;
+		left_turns += turns.left_turns;
+		right_turns += turns.right_turns;
+		reversals += turns.reversals;
+		turning_number += turns.turning_number;
+	}
+	return TurnSummary{double_area, left_turns, right_turns, reversals, turning_number};
+}
+
+/*!
+ * Implementation of classifying the turns of each polygon in a batch that runs
+ * on the graphics card, if available.
+ *
+ * Each polygon is processed by a team on the GPU, which classifies the
+ * vertices of that polygon in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to classify the turns of.
+ * \return For each polygon, a summary of its turns.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<TurnSummary> turns_gpu(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	const Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	std::vector<size_t> starts(batch_size);
+	std::vector<size_t> sizes(batch_size);
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		starts[polygon] = batch[polygon].empty() ? 0 : &batch[polygon][0] - vertices;
+		sizes[polygon] = batch[polygon].size();
+	}
+	Batch<TurnSummary> result;
+	result.resize(batch_size);
+	TurnSummary* result_data = result.data();
+	const size_t* starts_data = starts.data();
+	const size_t* sizes_data = sizes.data();
+	#pragma omp target teams distribute map(to:vertices[0:vertices_size], starts_data[0:batch_size], sizes_data[0:batch_size]) map(from:result_data[0:batch_size])
+	for(size_t polygon = 0; polygon < batch_size; ++polygon) {
+		const Point2* polygon_vertices = vertices + starts_data[polygon];
+		const size_t size = sizes_data[polygon];
+		area_t double_area = 0;
+		size_t left_turns = 0;
+		size_t right_turns = 0;
+		size_t reversals = 0;
+		coord_t turning_number = 0;
+		#pragma omp parallel for reduction(+:double_area, left_turns, right_turns, reversals, turning_number)
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			TurnSummary turns;
+			classify_turn(polygon_vertices, size, vertex, turns);
+			double_area += turns.double_area;
+			left_turns += turns.left_turns;
+			right_turns += turns.right_turns;
+			reversals += turns.reversals;
+			turning_number += turns.turning_number;
+		}
+		result_data[polygon] = TurnSummary{double_area, left_turns, right_turns, reversals, turning_number};
+	}
+	return result;
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_CONVEXITY
\ No newline at end of file
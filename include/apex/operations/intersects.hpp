@@ -0,0 +1,895 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_INTERSECTS
+#define APEX_INTERSECTS
+
+#include <algorithm> //For std::min, std::max and std::sort.
+#include <omp.h> //To collect the intersecting pairs of each thread.
+#include <utility> //For std::pair, to return pairs of indices.
+#include <vector> //To store intermediary results.
+
+#include "../batch.hpp" //To test batches of line segments.
+#include "../coordinate.hpp" //To compute the orientations of the line segments exactly.
+#include "../detail/geometry_concepts.hpp" //To test any type of polygon.
+#include "../detail/polygon_properties.hpp" //To use cached convexity for quicker tests.
+#include "../detail/simd_dispatch.hpp" //To compile the SIMD kernels for multiple instruction sets.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../line_segment.hpp" //The line segments to test.
+#include "../point2.hpp" //The endpoints of the line segments.
+#include "../r_tree.hpp" //To find which pairs of polygons may intersect.
+#include "bounding_box.hpp" //To quickly reject polygons that are far apart.
+#include "contains.hpp" //To detect polygons that are completely inside of other polygons.
+
+namespace apex {
+
+namespace detail {
+
+//Declare the detail functions so that we can reference them from the public ones.
+inline Batch<bool> intersects_st(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+inline Batch<bool> intersects_mt(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_st(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_mt(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+
+inline bool polygons_intersect(const Point2* a, const size_t a_size, const Point2* b, const size_t b_size, const bool both_convex);
+
+template<multi_polygonal PolygonBatch>
+Batch<Batch<size_t>> intersecting_candidates(const PolygonBatch& batch, const RTree& index);
+
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_st(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates);
+
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_mt(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates);
+
+#ifdef GPU
+inline Batch<bool> intersects_gpu(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_gpu(const Batch<LineSegment>& a, const Batch<LineSegment>& b);
+
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_gpu(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates);
+#endif //GPU
+
+}
+
+/*!
+ * Tests for each line segment in a batch whether it intersects with the
+ * corresponding line segment in another batch.
+ *
+ * The line segments are paired up by their index. The first segment of one
+ * batch is tested against the first segment of the other batch, and so on. The
+ * results are the same as those of ``LineSegment::intersects``, so endpoints
+ * count as part of the segments, and overlapping parallel segments intersect.
+ * \param a The first segment of each pair.
+ * \param b The second segment of each pair. This must have the same size as
+ * the first batch.
+ * \return For each pair, whether the two line segments intersect.
+ */
+inline Batch<bool> intersects(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	const detail::Dispatch dispatch(detail::Operation::intersects_segments, a.size());
+	switch(dispatch.version) {
+		case 0: return detail::intersects_st(a, b);
+		case 1: return detail::intersects_mt(a, b);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::intersects_gpu(a, b);
+		}
+#endif //GPU
+	}
+	return detail::intersects_mt(a, b);
+}
+
+/*!
+ * Finds all pairs of line segments from two batches that intersect.
+ *
+ * Each segment of one batch is tested against all segments of the other batch.
+ * Whether two segments intersect is determined in the same way as
+ * ``LineSegment::intersects``.
+ * \param a One batch of line segments.
+ * \param b The other batch of line segments.
+ * \return For each pair of intersecting segments, the index of the segment in
+ * the first batch and the index of the segment in the second batch. The pairs
+ * are sorted by those indices.
+ */
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	const detail::Dispatch dispatch(detail::Operation::intersecting_pairs, a.size() * b.size());
+	switch(dispatch.version) {
+		case 0: return detail::intersecting_pairs_st(a, b);
+		case 1: return detail::intersecting_pairs_mt(a, b);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::intersecting_pairs_gpu(a, b);
+		}
+#endif //GPU
+	}
+	return detail::intersecting_pairs_mt(a, b);
+}
+
+/*!
+ * Tests whether two polygons intersect.
+ *
+ * The polygons intersect if they have any point in common. This includes
+ * polygons whose borders touch, and polygons that are completely inside of
+ * the other polygon. The inside of the polygons is determined with the
+ * nonzero fill rule, like ``contains`` does.
+ *
+ * Polygons whose bounding boxes don't overlap are rejected without testing
+ * their edges. If both polygons are known to be convex, a separating axis test
+ * is used. Otherwise each edge of one polygon is tested against all edges of
+ * the other polygon with SIMD instructions, and if none intersect, one vertex
+ * of each polygon is tested for being inside of the other polygon.
+ * \tparam PolygonA A class that behaves like a polygon.
+ * \tparam PolygonB A class that behaves like a polygon.
+ * \param a One of the polygons to test.
+ * \param b The other polygon to test.
+ * \return ``true`` if the polygons intersect, or ``false`` if they don't.
+ */
+template<polygonal PolygonA, polygonal PolygonB>
+bool intersects(const PolygonA& a, const PolygonB& b) {
+	if(a.size() == 0 || b.size() == 0) {
+		return false;
+	}
+	const std::pair<Point2, Point2> a_box = bounding_box(a);
+	const std::pair<Point2, Point2> b_box = bounding_box(b);
+	if(a_box.first.x > b_box.second.x || a_box.second.x < b_box.first.x || a_box.first.y > b_box.second.y || a_box.second.y < b_box.first.y) {
+		return false;
+	}
+	bool both_convex = false;
+	if constexpr(caches_properties<PolygonA> && caches_properties<PolygonB>) {
+		both_convex = a.get_properties().convexity() == PolygonProperties::Convexity::CONVEX && b.get_properties().convexity() == PolygonProperties::Convexity::CONVEX;
+	}
+	return detail::polygons_intersect(&a[0], a.size(), &b[0], b.size(), both_convex);
+}
+
+/*!
+ * Finds all pairs of polygons from two batches that intersect, using an
+ * existing spatial index of the second batch.
+ *
+ * Whether two polygons intersect is determined in the same way as
+ * ``intersects`` does for two polygons. The spatial index is queried with the
+ * bounding box of each polygon of the first batch, so that only the pairs of
+ * which the bounding boxes overlap need to be tested. If the bounding boxes of
+ * the first batch are cached, they are taken from the cache.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a One batch of polygons.
+ * \param b The other batch of polygons.
+ * \param index A spatial index of the second batch of polygons, such as
+ * constructed by ``RTree(b)``. It must be up to date with the polygons.
+ * \return For each pair of intersecting polygons, the index of the polygon in
+ * the first batch and the index of the polygon in the second batch. The pairs
+ * are sorted by those indices.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs(const PolygonBatchA& a, const PolygonBatchB& b, const RTree& index) {
+	const Batch<Batch<size_t>> candidates = detail::intersecting_candidates(a, index);
+	size_t work = 0; //Testing the edges of two polygons takes time proportional to the product of their sizes.
+	for(size_t polygon = 0; polygon < candidates.size(); ++polygon) {
+		for(const size_t other : candidates[polygon]) {
+			work += a[polygon].size() * b[other].size();
+		}
+	}
+	const detail::Dispatch dispatch(detail::Operation::intersecting_pairs_batch, work);
+	switch(dispatch.version) {
+		case 0: return detail::intersecting_pairs_st(a, b, candidates);
+		case 1: return detail::intersecting_pairs_mt(a, b, candidates);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::intersecting_pairs_gpu(a, b, candidates);
+		}
+#endif //GPU
+	}
+	return detail::intersecting_pairs_mt(a, b, candidates);
+}
+
+/*!
+ * Finds all pairs of polygons from two batches that intersect.
+ *
+ * This builds a spatial index of the second batch first. If such an index is
+ * already available, pass it along to save constructing it again.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a One batch of polygons.
+ * \param b The other batch of polygons.
+ * \return For each pair of intersecting polygons, the index of the polygon in
+ * the first batch and the index of the polygon in the second batch. The pairs
+ * are sorted by those indices.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs(const PolygonBatchA& a, const PolygonBatchB& b) {
+	return intersecting_pairs(a, b, RTree(b));
+}
+
+namespace detail {
+
+/*!
+ * The result of \ref intersects_branchless if the two line segments are
+ * parallel. Whether they intersect then needs to be tested separately.
+ */
+constexpr char intersects_parallel = 2;
+
+/*!
+ * Tests whether two line segments intersect, without branching, unless they
+ * are parallel.
+ *
+ * This computes the same parametric coordinates as ``LineSegment::intersects``,
+ * but with only arithmetic and comparisons, so that many pairs of segments can
+ * be tested at once with SIMD instructions. Parallel segments are rare, but
+ * testing whether they overlap needs branches. Those are reported separately,
+ * so that they can be tested with ``LineSegment::intersects`` afterwards.
+ * \param a_start One of the vertices of the first line segment.
+ * \param a_end The other vertex of the first line segment.
+ * \param b_start One of the vertices of the second line segment.
+ * \param b_end The other vertex of the second line segment.
+ * \return 1 if the line segments intersect, 0 if they don't, or
+ * \ref intersects_parallel if they are parallel.
+ */
+constexpr char intersects_branchless(const Point2& a_start, const Point2& a_end, const Point2& b_start, const Point2& b_end) {
+	const area_t a_delta_x = area_t(a_end.x) - a_start.x;
+	const area_t a_delta_y = area_t(a_end.y) - a_start.y;
+	const area_t b_delta_x = area_t(b_end.x) - b_start.x;
+	const area_t b_delta_y = area_t(b_end.y) - b_start.y;
+	const area_t starts_delta_x = area_t(a_start.x) - b_start.x;
+	const area_t starts_delta_y = area_t(a_start.y) - b_start.y;
+	const area_t divisor = a_delta_x * b_delta_y - a_delta_y * b_delta_x;
+	const area_t a_parametric = b_delta_x * starts_delta_y - b_delta_y * starts_delta_x;
+	const area_t b_parametric = a_delta_x * starts_delta_y - a_delta_y * starts_delta_x;
+
+	//If both parameters are between 0 and the divisor, they intersect.
+	const area_t lower_range = std::min(area_t(0), divisor);
+	const area_t upper_range = std::max(area_t(0), divisor);
+	const bool in_range = (a_parametric >= lower_range) & (a_parametric <= upper_range) & (b_parametric >= lower_range) & (b_parametric <= upper_range);
+	return (divisor == 0) * intersects_parallel | ((divisor != 0) & in_range);
+}
+
+/*!
+ * Tests pairs of line segments for intersection with SIMD instructions.
+ *
+ * The pairs that are parallel are tested with the scalar implementation
+ * afterwards.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param a The first segment of each pair.
+ * \param b The second segment of each pair.
+ * \param count The number of pairs to test.
+ * \param result For each pair, whether the segments intersect.
+ */
+APEX_SIMD_CLONES inline void intersects_pairwise(const LineSegment* a, const LineSegment* b, const size_t count, char* result) {
+	#pragma omp simd
+	for(size_t pair = 0; pair < count; ++pair) {
+		result[pair] = intersects_branchless(a[pair].start, a[pair].end, b[pair].start, b[pair].end);
+	}
+	for(size_t pair = 0; pair < count; ++pair) {
+		if(result[pair] == intersects_parallel) [[unlikely]] {
+			result[pair] = LineSegment::intersects(a[pair].start, a[pair].end, b[pair].start, b[pair].end);
+		}
+	}
+}
+
+/*!
+ * Tests one line segment against many line segments for intersection with SIMD
+ * instructions.
+ *
+ * The segments that are parallel to it are tested with the scalar
+ * implementation afterwards.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param segment The line segment to test against all others.
+ * \param others The line segments to test against.
+ * \param count The number of line segments to test against.
+ * \param result For each of the other line segments, whether it intersects
+ * with the line segment.
+ */
+APEX_SIMD_CLONES inline void intersects_one_many(const LineSegment segment, const LineSegment* others, const size_t count, char* result) {
+	#pragma omp simd
+	for(size_t other = 0; other < count; ++other) {
+		result[other] = intersects_branchless(segment.start, segment.end, others[other].start, others[other].end);
+	}
+	for(size_t other = 0; other < count; ++other) {
+		if(result[other] == intersects_parallel) [[unlikely]] {
+			result[other] = LineSegment::intersects(segment.start, segment.end, others[other].start, others[other].end);
+		}
+	}
+}
+
+/*!
+ * Tests one line segment against a chain of edges for intersection with SIMD
+ * instructions, without testing the parallel edges.
+ *
+ * The edges connect subsequent vertices, as in a polygon. This is used to
+ * quickly find which edges of a polygon may intersect with a line segment.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param start One of the vertices of the line segment.
+ * \param end The other vertex of the line segment.
+ * \param vertices The vertices of the chain. There must be one more vertex
+ * than the number of edges.
+ * \param count The number of edges to test.
+ * \param result For each edge, 1 if it intersects, 0 if it doesn't, or
+ * \ref intersects_parallel if it is parallel to the line segment.
+ */
+APEX_SIMD_CLONES inline void intersects_edges(const Point2 start, const Point2 end, const Point2* vertices, const size_t count, char* result) {
+	#pragma omp simd
+	for(size_t edge = 0; edge < count; ++edge) {
+		result[edge] = intersects_branchless(start, end, vertices[edge], vertices[edge + 1]);
+	}
+}
+
+/*!
+ * Single-threaded implementation of ``intersects`` for batches of line
+ * segments.
+ *
+ * This tests all pairs with SIMD instructions.
+ * \param a The first segment of each pair.
+ * \param b The second segment of each pair.
+ * \return For each pair, whether the two line segments intersect.
+ */
+inline Batch<bool> intersects_st(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	std::vector<char> result(a.size());
+	intersects_pairwise(a.data(), b.data(), a.size(), result.data());
+	return Batch<bool>(result.begin(), result.end());
+}
+
+/*!
+ * Multi-threaded implementation of ``intersects`` for batches of line
+ * segments.
+ *
+ * The pairs are divided over the threads in chunks. Each thread tests its
+ * chunks with SIMD instructions.
+ * \param a The first segment of each pair.
+ * \param b The second segment of each pair.
+ * \return For each pair, whether the two line segments intersect.
+ */
+inline Batch<bool> intersects_mt(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	const size_t size = a.size();
+	std::vector<char> result(size); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* result_data = result.data();
+	const LineSegment* a_data = a.data();
+	const LineSegment* b_data = b.data();
+	constexpr size_t chunk_size = 4096; //Enough pairs to make scheduling a chunk worth it, but small enough to balance the load between threads.
+	const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+	#pragma omp parallel for
+	for(size_t chunk = 0; chunk < num_chunks; ++chunk) {
+		const size_t chunk_start = chunk * chunk_size;
+		const size_t chunk_end = std::min(chunk_start + chunk_size, size);
+		intersects_pairwise(a_data + chunk_start, b_data + chunk_start, chunk_end - chunk_start, result_data + chunk_start);
+	}
+	return Batch<bool>(result.begin(), result.end());
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``intersects`` for batches of line segments that runs on
+ * the graphics card, if available.
+ *
+ * Each pair is tested by a separate thread on the GPU, without branches. The
+ * pairs that are parallel are tested on the CPU afterwards.
+ * \param a The first segment of each pair.
+ * \param b The second segment of each pair.
+ * \return For each pair, whether the two line segments intersect.
+ */
+inline Batch<bool> intersects_gpu(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	const size_t size = a.size();
+	std::vector<char> result(size); //Not booleans, since those are packed into bits that can't be written to in parallel.
+	char* result_data = result.data();
+	const LineSegment* a_data = a.data();
+	const LineSegment* b_data = b.data();
+	#pragma omp target teams distribute parallel for map(to:a_data[0:size], b_data[0:size]) map(from:result_data[0:size])
+	for(size_t pair = 0; pair < size; ++pair) {
+		result_data[pair] = intersects_branchless(a_data[pair].start, a_data[pair].end, b_data[pair].start, b_data[pair].end);
+	}
+	for(size_t pair = 0; pair < size; ++pair) {
+		if(result_data[pair] == intersects_parallel) [[unlikely]] {
+			result_data[pair] = LineSegment::intersects(a_data[pair].start, a_data[pair].end, b_data[pair].start, b_data[pair].end);
+		}
+	}
+	return Batch<bool>(result.begin(), result.end());
+}
+#endif //GPU
+
+/*!
+ * Single-threaded implementation of ``intersecting_pairs``.
+ *
+ * Each segment of one batch is tested against all segments of the other batch
+ * with SIMD instructions.
+ * \param a One batch of line segments.
+ * \param b The other batch of line segments.
+ * \return For each pair of intersecting segments, the index of the segment in
+ * the first batch and the index of the segment in the second batch.
+ */
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_st(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	Batch<std::pair<size_t, size_t>> result;
+	std::vector<char> row(b.size());
+	for(size_t segment = 0; segment < a.size(); ++segment) {
+		intersects_one_many(a[segment], b.data(), b.size(), row.data());
+		for(size_t other = 0; other < b.size(); ++other) {
+			if(row[other]) {
+				result.emplace_back(segment, other);
+			}
+		}
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``intersecting_pairs``.
+ *
+ * The segments of the first batch are divided over the threads. Each thread
+ * tests its segments against all segments of the other batch with SIMD
+ * instructions. Each thread gets a contiguous range of segments, so that
+ * concatenating the pairs found by the threads keeps them sorted.
+ * \param a One batch of line segments.
+ * \param b The other batch of line segments.
+ * \return For each pair of intersecting segments, the index of the segment in
+ * the first batch and the index of the segment in the second batch.
+ */
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_mt(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	std::vector<Batch<std::pair<size_t, size_t>>> thread_results(omp_get_max_threads());
+	#pragma omp parallel
+	{
+		Batch<std::pair<size_t, size_t>>& thread_result = thread_results[omp_get_thread_num()];
+		std::vector<char> row(b.size());
+		#pragma omp for schedule(static)
+		for(size_t segment = 0; segment < a.size(); ++segment) {
+			intersects_one_many(a[segment], b.data(), b.size(), row.data());
+			for(size_t other = 0; other < b.size(); ++other) {
+				if(row[other]) {
+					thread_result.emplace_back(segment, other);
+				}
+			}
+		}
+	}
+	Batch<std::pair<size_t, size_t>> result;
+	for(const Batch<std::pair<size_t, size_t>>& thread_result : thread_results) {
+		result.insert(result.end(), thread_result.begin(), thread_result.end());
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``intersecting_pairs`` that runs on the graphics card, if
+ * available.
+ *
+ * Each pair of segments is tested by a separate thread on the GPU, without
+ * branches. To limit the memory needed for the results, the segments of the
+ * first batch are processed in chunks. The pairs that are parallel are tested
+ * on the CPU while collecting the results.
+ * \param a One batch of line segments.
+ * \param b The other batch of line segments.
+ * \return For each pair of intersecting segments, the index of the segment in
+ * the first batch and the index of the segment in the second batch.
+ */
+inline Batch<std::pair<size_t, size_t>> intersecting_pairs_gpu(const Batch<LineSegment>& a, const Batch<LineSegment>& b) {
+	Batch<std::pair<size_t, size_t>> result;
+	const size_t a_size = a.size();
+	const size_t b_size = b.size();
+	if(a_size == 0 || b_size == 0) {
+		return result;
+	}
+	const LineSegment* a_data = a.data();
+	const LineSegment* b_data = b.data();
+	const size_t chunk_rows = std::max(size_t(1), (size_t(1) << 24) / b_size); //At most 16MB of results at a time.
+	std::vector<char> results(std::min(chunk_rows, a_size) * b_size);
+	char* results_data = results.data();
+	#pragma omp target data map(to:a_data[0:a_size], b_data[0:b_size])
+	for(size_t chunk_start = 0; chunk_start < a_size; chunk_start += chunk_rows) {
+		const size_t rows = std::min(chunk_rows, a_size - chunk_start);
+		const size_t num_results = rows * b_size;
+		#pragma omp target teams distribute parallel for map(from:results_data[0:num_results])
+		for(size_t pair = 0; pair < num_results; ++pair) {
+			const LineSegment& segment = a_data[chunk_start + pair / b_size];
+			const LineSegment& other = b_data[pair % b_size];
+			results_data[pair] = intersects_branchless(segment.start, segment.end, other.start, other.end);
+		}
+		for(size_t pair = 0; pair < num_results; ++pair) {
+			const size_t segment = chunk_start + pair / b_size;
+			const size_t other = pair % b_size;
+			if(results_data[pair] == intersects_parallel) [[unlikely]] {
+				results_data[pair] = LineSegment::intersects(a_data[segment].start, a_data[segment].end, b_data[other].start, b_data[other].end);
+			}
+			if(results_data[pair]) {
+				result.emplace_back(segment, other);
+			}
+		}
+	}
+	return result;
+}
+#endif //GPU
+
+/*!
+ * Tests whether two collinear line segments overlap, without branching.
+ *
+ * This is the test for line segments that \ref intersects_branchless reports
+ * as parallel. Unlike ``LineSegment::intersects``, this doesn't need to order
+ * the endpoints, so it can be used in SIMD loops and on the GPU. Segments of
+ * zero length are only considered to intersect with the segments that they
+ * lie on.
+ * \param a_start One of the vertices of the first line segment.
+ * \param a_end The other vertex of the first line segment.
+ * \param b_start One of the vertices of the second line segment.
+ * \param b_end The other vertex of the second line segment.
+ * \return Whether the line segments are collinear and overlap.
+ */
+constexpr bool intersects_collinear(const Point2& a_start, const Point2& a_end, const Point2& b_start, const Point2& b_end) {
+	//All endpoints must be on the line through the other segment. For segments of zero length, that is always the case.
+	const area_t b_start_side = (area_t(a_end.x) - a_start.x) * (area_t(b_start.y) - a_start.y) - (area_t(b_start.x) - a_start.x) * (area_t(a_end.y) - a_start.y);
+	const area_t b_end_side = (area_t(a_end.x) - a_start.x) * (area_t(b_end.y) - a_start.y) - (area_t(b_end.x) - a_start.x) * (area_t(a_end.y) - a_start.y);
+	const area_t a_start_side = (area_t(b_end.x) - b_start.x) * (area_t(a_start.y) - b_start.y) - (area_t(a_start.x) - b_start.x) * (area_t(b_end.y) - b_start.y);
+	const area_t a_end_side = (area_t(b_end.x) - b_start.x) * (area_t(a_end.y) - b_start.y) - (area_t(a_end.x) - b_start.x) * (area_t(b_end.y) - b_start.y);
+	const bool collinear = (b_start_side == 0) & (b_end_side == 0) & (a_start_side == 0) & (a_end_side == 0);
+	//Collinear segments overlap if their ranges overlap in both dimensions.
+	const bool overlap_x = (std::max(a_start.x, a_end.x) >= std::min(b_start.x, b_end.x)) & (std::max(b_start.x, b_end.x) >= std::min(a_start.x, a_end.x));
+	const bool overlap_y = (std::max(a_start.y, a_end.y) >= std::min(b_start.y, b_end.y)) & (std::max(b_start.y, b_end.y) >= std::min(a_start.y, a_end.y));
+	return collinear & overlap_x & overlap_y;
+}
+
+/*!
+ * Tests whether two line segments intersect, without branching at all.
+ *
+ * This combines \ref intersects_branchless with \ref intersects_collinear for
+ * the parallel segments.
+ * \param a_start One of the vertices of the first line segment.
+ * \param a_end The other vertex of the first line segment.
+ * \param b_start One of the vertices of the second line segment.
+ * \param b_end The other vertex of the second line segment.
+ * \return Whether the line segments intersect.
+ */
+constexpr bool segments_intersect(const Point2& a_start, const Point2& a_end, const Point2& b_start, const Point2& b_end) {
+	const char result = intersects_branchless(a_start, a_end, b_start, b_end);
+	return (result == 1) | ((result == intersects_parallel) & intersects_collinear(a_start, a_end, b_start, b_end));
+}
+
+/*!
+ * Tests whether any edge of one polygon intersects with any edge of another
+ * polygon, with SIMD instructions.
+ *
+ * Each edge of the first polygon is tested against all edges of the second
+ * polygon at once.
+ *
+ * This function is compiled for several instruction sets, such as AVX-512,
+ * AVX2 and SSE4.1. The best version that the processor supports is chosen at
+ * run-time.
+ * \param a The vertices of the first polygon.
+ * \param a_size The number of vertices of the first polygon. This must not be
+ * 0.
+ * \param b The vertices of the second polygon.
+ * \param b_size The number of vertices of the second polygon. This must not be
+ * 0.
+ * \return Whether any of the edges intersect.
+ */
+APEX_SIMD_CLONES inline bool polygon_edges_intersect(const Point2* a, const size_t a_size, const Point2* b, const size_t b_size) {
+	for(size_t edge = 0; edge < a_size; ++edge) {
+		const Point2 start = a[edge];
+		const Point2 end = a[edge + 1 == a_size ? 0 : edge + 1];
+		int hit = segments_intersect(start, end, b[b_size - 1], b[0]); //The closing edge.
+		#pragma omp simd reduction(|:hit)
+		for(size_t other = 0; other < b_size - 1; ++other) {
+			hit |= segments_intersect(start, end, b[other], b[other + 1]);
+		}
+		if(hit) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * Computes twice the signed area of a polygon, to find its orientation.
+ * \param vertices The vertices of the polygon.
+ * \param size The number of vertices of the polygon.
+ * \return Twice the area of the polygon. This is positive if the polygon winds
+ * counter-clockwise, and negative if it winds clockwise.
+ */
+inline area_t polygon_double_area(const Point2* vertices, const size_t size) {
+	area_t area = 0;
+	for(size_t vertex = 0, previous = size - 1; vertex < size; previous = vertex++) {
+		area += area_t(vertices[previous].x) * vertices[vertex].y - area_t(vertices[previous].y) * vertices[vertex].x;
+	}
+	return area;
+}
+
+/*!
+ * Tests whether any edge of a convex polygon separates it from another convex
+ * polygon.
+ *
+ * An edge separates the polygons if all vertices of the other polygon are
+ * strictly on the outside of the line through that edge. For two convex
+ * polygons that don't intersect, such an edge always exists in one of them.
+ * \param a The vertices of the polygon of which to test the edges.
+ * \param a_size The number of vertices of that polygon.
+ * \param a_double_area Twice the signed area of that polygon, to know which side
+ * of its edges is the outside. This must not be 0.
+ * \param b The vertices of the other polygon.
+ * \param b_size The number of vertices of the other polygon.
+ * \return Whether any edge of the first polygon separates the polygons.
+ */
+inline bool separating_edge(const Point2* a, const size_t a_size, const area_t a_double_area, const Point2* b, const size_t b_size) {
+	const area_t outside = a_double_area > 0 ? -1 : 1; //The sign of the cross product for points outside of the polygon.
+	for(size_t edge = 0; edge < a_size; ++edge) {
+		const Point2 start = a[edge];
+		const Point2 end = a[edge + 1 == a_size ? 0 : edge + 1];
+		const area_t delta_x = area_t(end.x) - start.x;
+		const area_t delta_y = area_t(end.y) - start.y;
+		int all_outside = 1;
+		#pragma omp simd reduction(&:all_outside)
+		for(size_t vertex = 0; vertex < b_size; ++vertex) {
+			const area_t side = delta_x * (area_t(b[vertex].y) - start.y) - delta_y * (area_t(b[vertex].x) - start.x);
+			all_outside &= (side * outside > 0);
+		}
+		if(all_outside) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * Tests whether two polygons intersect.
+ *
+ * If both polygons are convex, this searches for a separating edge. Otherwise,
+ * this tests the edges of the polygons for intersections, and if there are
+ * none, tests whether either polygon is inside of the other.
+ * \param a The vertices of the first polygon.
+ * \param a_size The number of vertices of the first polygon.
+ * \param b The vertices of the second polygon.
+ * \param b_size The number of vertices of the second polygon.
+ * \param both_convex Whether both polygons are known to be convex.
+ * \return Whether the polygons intersect.
+ */
+inline bool polygons_intersect(const Point2* a, const size_t a_size, const Point2* b, const size_t b_size, const bool both_convex) {
+	if(a_size == 0 || b_size == 0) {
+		return false;
+	}
+	if(both_convex) {
+		const area_t a_double_area = polygon_double_area(a, a_size);
+		const area_t b_double_area = polygon_double_area(b, b_size);
+		if(a_double_area != 0 && b_double_area != 0) { //Without area, the outside of the edges is not defined.
+			return !separating_edge(a, a_size, a_double_area, b, b_size) && !separating_edge(b, b_size, b_double_area, a, a_size);
+		}
+	}
+	if(polygon_edges_intersect(a, a_size, b, b_size)) {
+		return true;
+	}
+	//If the borders don't intersect, the polygons only intersect if one is completely inside of the other.
+	return contains_vertices(b, b_size, a[0]) || contains_vertices(a, a_size, b[0]);
+}
+
+/*!
+ * Finds which polygons of a spatial index may intersect with each polygon of a
+ * batch, because their bounding boxes overlap.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The polygons to find candidates for.
+ * \param index The spatial index to query.
+ * \return For each polygon in the batch, the sorted indices of the items in
+ * the index of which the bounding boxes overlap with that polygon.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<size_t>> intersecting_candidates(const PolygonBatch& batch, const RTree& index) {
+	Batch<Batch<size_t>> candidates = index.query(bounding_box(batch));
+	for(size_t polygon = 0; polygon < candidates.size(); ++polygon) {
+		if(batch[polygon].size() == 0) { //Empty polygons have a bounding box at the origin, but don't intersect anything.
+			candidates[polygon].clear();
+			continue;
+		}
+		std::sort(candidates[polygon].begin(), candidates[polygon].end()); //The R-tree gives the results in the order of its nodes.
+	}
+	return candidates;
+}
+
+/*!
+ * Finds for each polygon in a batch whether it is known to be convex.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to look up the convexity of.
+ * \return For each polygon, whether its cached properties indicate that it is
+ * convex.
+ */
+template<multi_polygonal PolygonBatch>
+std::vector<char> known_convex(const PolygonBatch& batch) {
+	std::vector<char> result(batch.size(), false);
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			result[polygon] = batch.get_properties(polygon).convexity() == PolygonProperties::Convexity::CONVEX;
+		}
+	}
+	return result;
+}
+
+/*!
+ * Finds where each polygon of a batch starts in its vertex buffer, so that the
+ * polygons can be accessed without going through the batch.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch to find the polygons of.
+ * \param starts For each polygon, the index of its first vertex in the vertex
+ * buffer.
+ * \param sizes For each polygon, the number of vertices.
+ */
+template<multi_polygonal PolygonBatch>
+void polygon_positions(const PolygonBatch& batch, std::vector<size_t>& starts, std::vector<size_t>& sizes) {
+	const Point2* vertices = batch.data_subelements();
+	starts.resize(batch.size());
+	sizes.resize(batch.size());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		starts[polygon] = batch[polygon].empty() ? 0 : &batch[polygon][0] - vertices;
+		sizes[polygon] = batch[polygon].size();
+	}
+}
+
+/*!
+ * Single-threaded implementation of ``intersecting_pairs`` for batches of
+ * polygons.
+ *
+ * The candidate pairs are tested one by one, each with SIMD instructions.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a One batch of polygons.
+ * \param b The other batch of polygons.
+ * \param candidates For each polygon of the first batch, the sorted indices of
+ * the polygons of the second batch that it may intersect with.
+ * \return For each pair of intersecting polygons, the index of the polygon in
+ * the first batch and the index of the polygon in the second batch.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_st(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates) {
+	const std::vector<char> a_convex = known_convex(a);
+	const std::vector<char> b_convex = known_convex(b);
+	Batch<std::pair<size_t, size_t>> result;
+	for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+		for(const size_t other : candidates[polygon]) {
+			if(b[other].empty()) {
+				continue;
+			}
+			if(polygons_intersect(&a[polygon][0], a[polygon].size(), &b[other][0], b[other].size(), a_convex[polygon] && b_convex[other])) {
+				result.emplace_back(polygon, other);
+			}
+		}
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of ``intersecting_pairs`` for batches of
+ * polygons.
+ *
+ * The polygons of the first batch are divided over the threads. Since the
+ * number of candidates differs per polygon, they are scheduled dynamically.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a One batch of polygons.
+ * \param b The other batch of polygons.
+ * \param candidates For each polygon of the first batch, the sorted indices of
+ * the polygons of the second batch that it may intersect with.
+ * \return For each pair of intersecting polygons, the index of the polygon in
+ * the first batch and the index of the polygon in the second batch.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_mt(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates) {
+	const std::vector<char> a_convex = known_convex(a);
+	const std::vector<char> b_convex = known_convex(b);
+
+	//Find where each polygon is in the vertex buffers first, so that the threads don't need to synchronise the vertices for each polygon.
+	std::vector<size_t> a_starts, a_sizes, b_starts, b_sizes;
+	polygon_positions(a, a_starts, a_sizes);
+	polygon_positions(b, b_starts, b_sizes);
+	const Point2* a_vertices = a.data_subelements();
+	const Point2* b_vertices = b.data_subelements();
+
+	std::vector<std::vector<size_t>> intersecting(a.size());
+	#pragma omp parallel for schedule(dynamic, 16)
+	for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+		for(const size_t other : candidates[polygon]) {
+			if(polygons_intersect(a_vertices + a_starts[polygon], a_sizes[polygon], b_vertices + b_starts[other], b_sizes[other], a_convex[polygon] && b_convex[other])) {
+				intersecting[polygon].push_back(other);
+			}
+		}
+	}
+	Batch<std::pair<size_t, size_t>> result;
+	for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+		for(const size_t other : intersecting[polygon]) {
+			result.emplace_back(polygon, other);
+		}
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation of ``intersecting_pairs`` for batches of polygons that runs on
+ * the graphics card, if available.
+ *
+ * Each candidate pair is processed by a team on the GPU, which tests the edges
+ * of the polygons in parallel. The pairs of which the edges don't intersect are
+ * then tested on the CPU for being inside of each other, which only needs to
+ * go over the edges once.
+ * \tparam PolygonBatchA A class that behaves like a batch of polygons.
+ * \tparam PolygonBatchB A class that behaves like a batch of polygons.
+ * \param a One batch of polygons.
+ * \param b The other batch of polygons.
+ * \param candidates For each polygon of the first batch, the sorted indices of
+ * the polygons of the second batch that it may intersect with.
+ * \return For each pair of intersecting polygons, the index of the polygon in
+ * the first batch and the index of the polygon in the second batch.
+ */
+template<multi_polygonal PolygonBatchA, multi_polygonal PolygonBatchB>
+Batch<std::pair<size_t, size_t>> intersecting_pairs_gpu(const PolygonBatchA& a, const PolygonBatchB& b, const Batch<Batch<size_t>>& candidates) {
+	std::vector<size_t> a_starts, a_sizes, b_starts, b_sizes;
+	polygon_positions(a, a_starts, a_sizes);
+	polygon_positions(b, b_starts, b_sizes);
+	std::vector<size_t> pair_a;
+	std::vector<size_t> pair_b;
+	for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+		for(const size_t other : candidates[polygon]) {
+			if(b_sizes[other] > 0) {
+				pair_a.push_back(polygon);
+				pair_b.push_back(other);
+			}
+		}
+	}
+	const size_t num_pairs = pair_a.size();
+	std::vector<char> edges_hit(num_pairs);
+
+	const Point2* a_vertices = a.data_subelements();
+	const size_t a_vertices_size = a.size_subelements();
+	const Point2* b_vertices = b.data_subelements();
+	const size_t b_vertices_size = b.size_subelements();
+	const size_t* a_starts_data = a_starts.data();
+	const size_t* a_sizes_data = a_sizes.data();
+	const size_t* b_starts_data = b_starts.data();
+	const size_t* b_sizes_data = b_sizes.data();
+	const size_t a_size = a.size();
+	const size_t b_size = b.size();
+	const size_t* pair_a_data = pair_a.data();
+	const size_t* pair_b_data = pair_b.data();
+	char* edges_hit_data = edges_hit.data();
+	#pragma omp target teams distribute map(to:a_vertices[0:a_vertices_size], b_vertices[0:b_vertices_size], a_starts_data[0:a_size], a_sizes_data[0:a_size], b_starts_data[0:b_size], b_sizes_data[0:b_size], pair_a_data[0:num_pairs], pair_b_data[0:num_pairs]) map(from:edges_hit_data[0:num_pairs])
+	for(size_t pair = 0; pair < num_pairs; ++pair) {
+		const Point2* polygon = a_vertices + a_starts_data[pair_a_data[pair]];
+		const size_t polygon_size = a_sizes_data[pair_a_data[pair]];
+		const Point2* other = b_vertices + b_starts_data[pair_b_data[pair]];
+		const size_t other_size = b_sizes_data[pair_b_data[pair]];
+		int hit = 0;
+		#pragma omp parallel for reduction(|:hit)
+		for(size_t edge = 0; edge < polygon_size; ++edge) {
+			const Point2 start = polygon[edge];
+			const Point2 end = polygon[edge + 1 == polygon_size ? 0 : edge + 1];
+			for(size_t other_edge = 0; other_edge < other_size; ++other_edge) {
+				hit |= segments_intersect(start, end, other[other_edge], other[other_edge + 1 == other_size ? 0 : other_edge + 1]);
+			}
+		}
+		edges_hit_data[pair] = hit;
+	}
+
+	Batch<std::pair<size_t, size_t>> result;
+	for(size_t pair = 0; pair < num_pairs; ++pair) {
+		const Point2* polygon = a_vertices + a_starts[pair_a[pair]];
+		const size_t polygon_size = a_sizes[pair_a[pair]];
+		const Point2* other = b_vertices + b_starts[pair_b[pair]];
+		const size_t other_size = b_sizes[pair_b[pair]];
+		if(edges_hit[pair] || contains_vertices(other, other_size, polygon[0]) || contains_vertices(polygon, polygon_size, other[0])) {
+			result.emplace_back(pair_a[pair], pair_b[pair]);
+		}
+	}
+	return result;
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_INTERSECTS
\ No newline at end of file
@@ -0,0 +1,560 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_OFFSET
+#define APEX_OFFSET
+
+#include <algorithm> //For std::min and std::max, to clamp the angles of joins.
+#include <cmath> //To compute the normals of edges and the vertices of round joins.
+#include <memory_resource> //To construct the offset contours around their vertex buffer.
+#include <omp.h> //To offset vertices on multiple threads.
+#include <vector> //To store the contours in between steps, and to return the repeated insets.
+
+#include "../batch.hpp" //To return batches of polygons.
+#include "../coordinate.hpp" //To compute the orientation of polygons exactly.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+#include "../point2.hpp" //The vertices of the contours.
+#include "../polygon.hpp" //The result type of this operation.
+#include "clip.hpp" //To remove the self-intersections of the offset contours.
+#include "self_intersections.hpp" //To normalise polygons that intersect themselves before offsetting them.
+
+namespace apex {
+
+/*!
+ * The shapes that can be used to fill the gaps at the corners of an offset
+ * shape, where the offset edges move away from each other.
+ */
+enum class JoinType {
+	/*!
+	 * Extend the offset edges until they meet in a sharp corner.
+	 *
+	 * Very sharp corners would extend far away from the original vertex. If the
+	 * corner would be more than twice the offset distance away from the
+	 * original vertex, it is cut off with a straight line between the ends of
+	 * the offset edges instead.
+	 */
+	MITER,
+
+	/*!
+	 * Connect the offset edges with an arc around the original vertex.
+	 *
+	 * The arc is approximated with straight line segments that deviate at most
+	 * a quarter of a unit from the true arc.
+	 */
+	ROUND
+};
+
+namespace detail {
+
+/*!
+ * The contours of a shape that is about to be offset, prepared so that the
+ * vertices can be offset independently from each other.
+ *
+ * Each contour is stored with its last vertex repeated in front of it, and its
+ * first vertex repeated after it. That way the neighbours of each vertex can be
+ * found right next to it, without needing to know where the contour starts and
+ * ends. Vertices that coincide with the vertex before them are left out, since
+ * they have no edge to offset.
+ */
+struct OffsetContours {
+	/*!
+	 * The vertices of all contours, including the repeated vertices around
+	 * each contour.
+	 */
+	std::vector<Point2> vertices;
+
+	/*!
+	 * For each vertex that needs to be offset, its index in the vertex buffer.
+	 */
+	std::vector<size_t> centres;
+
+	/*!
+	 * For each contour, the index in ``centres`` of its first vertex, followed
+	 * by the number of vertices in all contours.
+	 */
+	std::vector<size_t> starts = {0};
+};
+
+/*!
+ * How far a miter may extend from the original vertex, as a multiple of the
+ * offset distance, before it is cut off.
+ */
+constexpr double miter_limit = 2.0;
+
+/*!
+ * How far the line segments of a round join may deviate from the true arc.
+ */
+constexpr double arc_tolerance = 0.25;
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+void offset_add_contour(const Polygon& polygon, const bool reverse, OffsetContours& contours);
+
+template<polygonal Polygon>
+OffsetContours offset_prepare(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+OffsetContours offset_prepare(const PolygonBatch& batch);
+
+inline Batch<Polygon> offset_st(const OffsetContours& contours, const coord_t distance, const JoinType join);
+inline Batch<Polygon> offset_mt(const OffsetContours& contours, const coord_t distance, const JoinType join);
+#ifdef GPU
+inline Batch<Polygon> offset_gpu(const OffsetContours& contours, const coord_t distance, const JoinType join);
+#endif
+
+}
+
+/*!
+ * Grows or shrinks a polygon by a certain distance.
+ *
+ * Every edge of the polygon is moved outwards by the given distance, or
+ * inwards if the distance is negative. Where the moved edges no longer meet,
+ * the gap is filled with the given type of join. The parts of the offset
+ * contour that turn inside out, such as at concave corners or where a thin part
+ * of the polygon shrinks away entirely, are removed. This can split the polygon
+ * into multiple parts, or remove it completely.
+ *
+ * The polygon is filled according to the nonzero rule, so it may wind in either
+ * direction. If the polygon intersects itself, it is first normalised with a
+ * union with an empty shape, so that lobes that wind the other way grow
+ * outwards too. The resulting contours follow the same conventions as the result
+ * of ``clip``: Outer contours wind counter-clockwise, and holes wind clockwise.
+ * The offset vertices are rounded to the nearest coordinate.
+ *
+ * A polygon with only two vertices is treated as a line segment, which gets
+ * offset on both sides.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to offset.
+ * \param distance How far to move the edges outwards. If negative, the edges
+ * are moved inwards.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of the offset polygon.
+ */
+template<polygonal Polygon>
+Batch<apex::Polygon> offset(const Polygon& polygon, const coord_t distance, const JoinType join = JoinType::MITER) {
+	if(polygon.size() > 3 && !self_intersections(polygon).empty()) { //Reversing the whole polygon can't make each of its lobes wind counter-clockwise.
+		return offset(clip(polygon, apex::Polygon(), BooleanOperation::UNION), distance, join);
+	}
+	const detail::OffsetContours contours = detail::offset_prepare(polygon);
+	const detail::Dispatch dispatch(detail::Operation::offset, polygon.size());
+	switch(dispatch.version) {
+		case 0: return detail::offset_st(contours, distance, join);
+		case 1: return detail::offset_mt(contours, distance, join);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::offset_gpu(contours, distance, join);
+		}
+#endif //GPU
+	}
+	return detail::offset_mt(contours, distance, join);
+}
+
+/*!
+ * Grows or shrinks a shape consisting of a batch of contours by a certain
+ * distance.
+ *
+ * The batch is treated as a single shape, where counter-clockwise contours are
+ * filled and clockwise contours are holes, as produced by ``clip``. Outer
+ * contours grow when the distance is positive, while holes shrink. Where
+ * offset contours overlap, they are merged. To offset contours that don't
+ * follow these conventions, they can be normalised first with a union with an
+ * empty shape.
+ *
+ * All vertices of all contours are offset in parallel, so this is much faster
+ * than offsetting the contours one by one.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The contours of the shape to offset.
+ * \param distance How far to move the edges outwards. If negative, the edges
+ * are moved inwards.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of the offset shape.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Polygon> offset(const PolygonBatch& batch, const coord_t distance, const JoinType join = JoinType::MITER) {
+	const detail::OffsetContours contours = detail::offset_prepare(batch);
+	const detail::Dispatch dispatch(detail::Operation::offset_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return detail::offset_st(contours, distance, join);
+		case 1: return detail::offset_mt(contours, distance, join);
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			return detail::offset_gpu(contours, distance, join);
+		}
+#endif //GPU
+	}
+	return detail::offset_mt(contours, distance, join);
+}
+
+/*!
+ * Shrinks a shape repeatedly by the same distance, such as to generate the
+ * walls of a print.
+ *
+ * Each inset is computed from the previous inset, rather than from the original
+ * shape. The previous inset is already free of self-intersections and has had
+ * its thin parts removed, so this is cheaper than offsetting the original shape
+ * by ever greater distances. The result may differ from offsetting by the total
+ * distance though. Corners that are cut off by the miter limit or rounded by
+ * round joins are offset along with the rest of the contours.
+ *
+ * The insets stop when the shape has shrunk away completely, so fewer insets
+ * may be returned than requested.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The contours of the shape to shrink, following the conventions
+ * of the ``offset`` of a batch.
+ * \param distance How far inwards to move the edges for each inset. The first
+ * inset is this far from the original shape.
+ * \param count How many insets to generate.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of each inset, in order from the outside inwards.
+ */
+template<multi_polygonal PolygonBatch>
+std::vector<Batch<Polygon>> insets(const PolygonBatch& batch, const coord_t distance, const size_t count, const JoinType join = JoinType::MITER) {
+	std::vector<Batch<Polygon>> result;
+	if(count == 0) {
+		return result;
+	}
+	result.reserve(count);
+	Batch<Polygon> inset = offset(batch, -distance, join);
+	while(!inset.empty()) {
+		result.push_back(std::move(inset));
+		if(result.size() == count) {
+			break;
+		}
+		inset = offset(result.back(), -distance, join);
+	}
+	return result;
+}
+
+/*!
+ * Shrinks a polygon repeatedly by the same distance, such as to generate the
+ * walls of a print.
+ *
+ * Each inset is computed from the previous inset, rather than from the original
+ * polygon. See the ``insets`` of a batch for details.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to shrink, filled according to the nonzero rule.
+ * \param distance How far inwards to move the edges for each inset.
+ * \param count How many insets to generate.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of each inset, in order from the outside inwards.
+ */
+template<polygonal Polygon>
+std::vector<Batch<apex::Polygon>> insets(const Polygon& polygon, const coord_t distance, const size_t count, const JoinType join = JoinType::MITER) {
+	if(count == 0) {
+		return {};
+	}
+	const Batch<apex::Polygon> first = offset(polygon, -distance, join);
+	if(first.empty()) {
+		return {};
+	}
+	std::vector<Batch<apex::Polygon>> result = insets(first, distance, count - 1, join);
+	result.insert(result.begin(), first);
+	return result;
+}
+
+namespace detail {
+
+/*!
+ * Adds a contour to the contours that are about to be offset.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The contour to add.
+ * \param reverse Whether to add the vertices in reverse order, to make the
+ * contour wind the other way around.
+ * \param contours The contours to add the contour to.
+ */
+template<polygonal Polygon>
+void offset_add_contour(const Polygon& polygon, const bool reverse, OffsetContours& contours) {
+	const size_t size = polygon.size();
+	const size_t front = contours.vertices.size();
+	contours.vertices.emplace_back(); //Placeholder for the repeated last vertex.
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 current = polygon[reverse ? size - 1 - vertex : vertex];
+		if(contours.vertices.size() > front + 1 && contours.vertices.back() == current) {
+			continue; //Coincides with the previous vertex.
+		}
+		contours.vertices.push_back(current);
+	}
+	while(contours.vertices.size() > front + 2 && contours.vertices.back() == contours.vertices[front + 1]) {
+		contours.vertices.pop_back(); //Coincides with the first vertex.
+	}
+	const size_t contour_size = contours.vertices.size() - front - 1;
+	if(contour_size < 2) { //A single point has no edges, so no direction to offset towards.
+		contours.vertices.resize(front);
+		return;
+	}
+	contours.vertices[front] = contours.vertices.back();
+	contours.vertices.push_back(contours.vertices[front + 1]);
+	for(size_t vertex = 0; vertex < contour_size; ++vertex) {
+		contours.centres.push_back(front + 1 + vertex);
+	}
+	contours.starts.push_back(contours.centres.size());
+}
+
+/*!
+ * Prepares a polygon to be offset.
+ *
+ * If the polygon winds clockwise, it is reversed, so that it grows outwards
+ * with positive distances regardless of its orientation.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to prepare.
+ * \return The contour of the polygon, prepared to be offset.
+ */
+template<polygonal Polygon>
+OffsetContours offset_prepare(const Polygon& polygon) {
+	area_t double_area = 0;
+	const size_t size = polygon.size();
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 current = polygon[vertex];
+		const Point2 next = polygon[(vertex + 1) % size];
+		double_area += area_t(current.x) * next.y - area_t(current.y) * next.x;
+	}
+	OffsetContours contours;
+	contours.vertices.reserve(size + 2);
+	contours.centres.reserve(size);
+	offset_add_contour(polygon, double_area < 0, contours);
+	return contours;
+}
+
+/*!
+ * Prepares the contours of a shape to be offset.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The contours of the shape to prepare.
+ * \return The contours of the shape, prepared to be offset.
+ */
+template<multi_polygonal PolygonBatch>
+OffsetContours offset_prepare(const PolygonBatch& batch) {
+	OffsetContours contours;
+	contours.vertices.reserve(batch.size_subelements() + batch.size() * 2);
+	contours.centres.reserve(batch.size_subelements());
+	contours.starts.reserve(batch.size() + 1);
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		offset_add_contour(batch[polygon], false, contours);
+	}
+	return contours;
+}
+
+/*!
+ * Computes the offset vertices for one vertex of a contour.
+ *
+ * Both edges adjacent to the vertex are moved by the distance, to their right
+ * side. If the moved edges move away from each other, the gap between them is
+ * filled with a join. Otherwise, they are connected through the original
+ * vertex, which creates a small loop that winds the wrong way around. That loop
+ * gets removed when the self-intersections are removed afterwards.
+ *
+ * This is used both to count how many vertices are produced, and to then
+ * produce them. That way, all vertices can be offset in parallel, writing to
+ * their own part of the result.
+ * \param previous The vertex before the vertex to offset.
+ * \param vertex The vertex to offset.
+ * \param next The vertex after the vertex to offset.
+ * \param distance How far to move the edges to their right side. If negative,
+ * they are moved to the left side.
+ * \param join How to fill the gap if the offset edges move away from each
+ * other.
+ * \param output Where to write the offset vertices to. If this is
+ * ``nullptr``, the offset vertices are only counted.
+ * \return How many offset vertices this vertex produces.
+ */
+inline size_t offset_vertex(const Point2& previous, const Point2& vertex, const Point2& next, const coord_t distance, const JoinType join, Point2* output) {
+	const double incoming_x = double(vertex.x) - previous.x;
+	const double incoming_y = double(vertex.y) - previous.y;
+	const double outgoing_x = double(next.x) - vertex.x;
+	const double outgoing_y = double(next.y) - vertex.y;
+	const double incoming_length = std::sqrt(incoming_x * incoming_x + incoming_y * incoming_y);
+	const double outgoing_length = std::sqrt(outgoing_x * outgoing_x + outgoing_y * outgoing_y);
+	//The displacements of the edges, in the direction of their right-hand normals.
+	const double start_x = incoming_y / incoming_length * distance;
+	const double start_y = -incoming_x / incoming_length * distance;
+	const double end_x = outgoing_y / outgoing_length * distance;
+	const double end_y = -outgoing_x / outgoing_length * distance;
+	const area_t turn = (area_t(vertex.x) - previous.x) * (area_t(next.y) - vertex.y) - (area_t(vertex.y) - previous.y) * (area_t(next.x) - vertex.x); //Positive for left turns.
+	const area_t forwards = (area_t(vertex.x) - previous.x) * (area_t(next.x) - vertex.x) + (area_t(vertex.y) - previous.y) * (area_t(next.y) - vertex.y);
+
+	size_t count = 0;
+	const auto emit = [&](const double x, const double y) {
+		if(output) {
+			output[count] = Point2(coord_t(std::llround(vertex.x + x)), coord_t(std::llround(vertex.y + y)));
+		}
+		++count;
+	};
+	if(distance == 0 || (turn == 0 && forwards > 0)) { //Not offset, or a straight line. Both edges move to the same spot.
+		emit(start_x, start_y);
+		return count;
+	}
+	const bool gap = (turn == 0) || ((turn > 0) == (distance > 0)); //Spikes always leave a gap at their tip.
+	if(!gap) {
+		emit(start_x, start_y);
+		emit(0, 0);
+		emit(end_x, end_y);
+		return count;
+	}
+	const double cosine = std::max(-1.0, std::min(1.0, (start_x * end_x + start_y * end_y) / (double(distance) * distance)));
+	if(join == JoinType::MITER) {
+		if(1 + cosine > 2 / (miter_limit * miter_limit)) { //The miter stays within the limit.
+			emit((start_x + end_x) / (1 + cosine), (start_y + end_y) / (1 + cosine));
+		} else {
+			emit(start_x, start_y);
+			emit(end_x, end_y);
+		}
+		return count;
+	}
+	//Round join. Rotate from the start displacement to the end displacement in small steps.
+	const double radius = std::abs(double(distance));
+	const double step_limit = radius > arc_tolerance ? 2 * std::acos(1 - arc_tolerance / radius) : 2.0;
+	const double angle = std::acos(cosine);
+	const size_t steps = std::max(size_t(1), size_t(std::ceil(angle / step_limit)));
+	const double step = (distance > 0 ? angle : -angle) / steps; //Growing turns counter-clockwise around the vertex, shrinking clockwise.
+	for(size_t i = 0; i < steps; ++i) {
+		const double rotation_cos = std::cos(step * i);
+		const double rotation_sin = std::sin(step * i);
+		emit(start_x * rotation_cos - start_y * rotation_sin, start_x * rotation_sin + start_y * rotation_cos);
+	}
+	emit(end_x, end_y);
+	return count;
+}
+
+/*!
+ * Connects the offset vertices into contours.
+ * \param contours The contours that were offset.
+ * \param output_starts For each vertex that was offset, where its offset
+ * vertices start in the buffer, followed by the size of the buffer.
+ * \param buffer The offset vertices of all contours.
+ * \return The offset contours, which may still intersect themselves.
+ */
+inline Batch<Polygon> offset_raw_contours(const OffsetContours& contours, const std::vector<size_t>& output_starts, std::pmr::vector<Point2>&& buffer) {
+	std::vector<size_t> offsets(contours.starts.size());
+	for(size_t contour = 0; contour < contours.starts.size(); ++contour) {
+		offsets[contour] = output_starts[contours.starts[contour]];
+	}
+	return Batch<Polygon>(std::move(buffer), offsets);
+}
+
+/*!
+ * Single-threaded implementation of offsetting contours.
+ * \param contours The contours to offset.
+ * \param distance How far to move the edges outwards.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of the offset shape.
+ */
+inline Batch<Polygon> offset_st(const OffsetContours& contours, const coord_t distance, const JoinType join) {
+	const size_t num_vertices = contours.centres.size();
+	std::vector<size_t> output_starts(num_vertices + 1);
+	output_starts[0] = 0;
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const size_t centre = contours.centres[vertex];
+		output_starts[vertex + 1] = output_starts[vertex] + offset_vertex(contours.vertices[centre - 1], contours.vertices[centre], contours.vertices[centre + 1], distance, join, nullptr);
+	}
+	std::pmr::vector<Point2> buffer(output_starts.back());
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const size_t centre = contours.centres[vertex];
+		offset_vertex(contours.vertices[centre - 1], contours.vertices[centre], contours.vertices[centre + 1], distance, join, buffer.data() + output_starts[vertex]);
+	}
+	std::vector<ClipEdge> edges;
+	clip_add_edges(offset_raw_contours(contours, output_starts, std::move(buffer)), 0, edges);
+	return clip_st(std::move(edges), BooleanOperation::UNION, FillRule::POSITIVE);
+}
+
+/*!
+ * Multi-threaded implementation of offsetting contours.
+ *
+ * The vertices are first counted in parallel, then a prefix sum determines
+ * where each vertex writes its offset vertices, and then the offset vertices
+ * are computed in parallel. The self-intersections are removed with the
+ * multi-threaded boolean operation engine.
+ * \param contours The contours to offset.
+ * \param distance How far to move the edges outwards.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of the offset shape.
+ */
+inline Batch<Polygon> offset_mt(const OffsetContours& contours, const coord_t distance, const JoinType join) {
+	const size_t num_vertices = contours.centres.size();
+	std::vector<size_t> output_starts(num_vertices + 1);
+	output_starts[0] = 0;
+	#pragma omp parallel for
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const size_t centre = contours.centres[vertex];
+		output_starts[vertex + 1] = offset_vertex(contours.vertices[centre - 1], contours.vertices[centre], contours.vertices[centre + 1], distance, join, nullptr);
+	}
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		output_starts[vertex + 1] += output_starts[vertex];
+	}
+	std::pmr::vector<Point2> buffer(output_starts.back());
+	#pragma omp parallel for
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const size_t centre = contours.centres[vertex];
+		offset_vertex(contours.vertices[centre - 1], contours.vertices[centre], contours.vertices[centre + 1], distance, join, buffer.data() + output_starts[vertex]);
+	}
+	std::vector<ClipEdge> edges;
+	clip_add_edges(offset_raw_contours(contours, output_starts, std::move(buffer)), 0, edges);
+	return clip_mt(std::move(edges), BooleanOperation::UNION, FillRule::POSITIVE);
+}
+
+#ifdef GPU
+/*!
+ * GPU implementation of offsetting contours.
+ *
+ * The vertices are counted and offset on the GPU, with a prefix sum on the host
+ * in between. The self-intersections are removed on the host afterwards, with
+ * the multi-threaded boolean operation engine.
+ * \param contours The contours to offset.
+ * \param distance How far to move the edges outwards.
+ * \param join How to fill the gaps where the offset edges move away from each
+ * other.
+ * \return The contours of the offset shape.
+ */
+inline Batch<Polygon> offset_gpu(const OffsetContours& contours, const coord_t distance, const JoinType join) {
+	const size_t num_vertices = contours.centres.size();
+	std::vector<size_t> output_starts(num_vertices + 1);
+	output_starts[0] = 0;
+	std::pmr::vector<Point2> buffer;
+	const Point2* vertices = contours.vertices.data();
+	const size_t vertices_size = contours.vertices.size();
+	const size_t* centres = contours.centres.data();
+	size_t* counts = output_starts.data() + 1;
+	#pragma omp target data map(to:vertices[0:vertices_size], centres[0:num_vertices])
+	{
+		#pragma omp target teams distribute parallel for map(from:counts[0:num_vertices])
+		for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+			const size_t centre = centres[vertex];
+			counts[vertex] = offset_vertex(vertices[centre - 1], vertices[centre], vertices[centre + 1], distance, join, nullptr);
+		}
+		for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+			output_starts[vertex + 1] += output_starts[vertex];
+		}
+		const size_t* starts = output_starts.data();
+		const size_t buffer_size = output_starts.back();
+		buffer.resize(buffer_size);
+		Point2* buffer_data = buffer.data();
+		#pragma omp target teams distribute parallel for map(to:starts[0:num_vertices]) map(from:buffer_data[0:buffer_size])
+		for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+			const size_t centre = centres[vertex];
+			offset_vertex(vertices[centre - 1], vertices[centre], vertices[centre + 1], distance, join, buffer_data + starts[vertex]);
+		}
+	}
+	std::vector<ClipEdge> edges;
+	clip_add_edges(offset_raw_contours(contours, output_starts, std::move(buffer)), 0, edges);
+	return clip_mt(std::move(edges), BooleanOperation::UNION, FillRule::POSITIVE);
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_OFFSET
\ No newline at end of file
@@ -0,0 +1,97 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_ORIENTATION
+#define APEX_ORIENTATION
+
+#include "../batch.hpp" //To return the orientation of each polygon in a batch.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/polygon_properties.hpp" //To cache the orientation of polygons.
+#include "convexity.hpp" //The orientation is found in the same pass over the vertices as the convexity.
+
+namespace apex {
+
+/*!
+ * Finds the winding orientation of a polygon.
+ *
+ * Polygons that wind counter-clockwise are positive, and polygons that wind
+ * clockwise are negative. Polygons that have parts winding in both directions,
+ * such as figure eights, are mixed. Polygons that have all of their vertices on
+ * one line have no orientation, so the orientation is unknown.
+ *
+ * This is determined from the sign of the area, together with how many times
+ * the direction of the contour turns around. If the polygon is convex or known
+ * not to intersect itself, this is exact. Otherwise, loops that wind the other
+ * way are only detected if they cancel out the turns of the rest of the
+ * polygon, as with figure eights.
+ *
+ * The orientation is computed in the same pass over the vertices as the area
+ * and the convexity. If the polygon caches its properties, all of these are
+ * stored in the cache, so that they don't need to be computed again.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find the orientation of.
+ * \return The winding orientation of the polygon.
+ */
+template<polygonal Polygon>
+PolygonProperties::Orientation orientation(const Polygon& polygon) {
+	if constexpr(caches_properties<Polygon>) {
+		PolygonProperties properties = polygon.get_properties();
+		if(properties.orientation() == PolygonProperties::Orientation::UNKNOWN) {
+			detail::store_turns(detail::turns_uncached(polygon), properties);
+			polygon.set_properties(properties);
+		}
+		return properties.orientation();
+	}
+	return detail::classify_orientation(detail::turns_uncached(polygon), PolygonProperties::SelfIntersecting::UNKNOWN);
+}
+
+/*!
+ * Finds the winding orientation of each polygon in a batch.
+ *
+ * See the ``orientation`` of a single polygon for how the polygons are
+ * classified. If the batch caches the properties of its polygons, the
+ * orientation, convexity and area of all polygons are stored in the cache.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to find the orientation of.
+ * \return For each polygon, its winding orientation, in the same order as the
+ * order of those polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<PolygonProperties::Orientation> orientation(const PolygonBatch& batch) {
+	Batch<PolygonProperties::Orientation> result;
+	result.reserve(batch.size());
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const PolygonProperties::Orientation cached = batch.get_properties(polygon).orientation();
+			if(cached == PolygonProperties::Orientation::UNKNOWN) {
+				break; //Classifying the whole batch at once is more efficient than classifying the missing ones separately.
+			}
+			result.push_back(cached);
+		}
+		if(result.size() == batch.size()) {
+			return result;
+		}
+		result.clear();
+		const Batch<detail::TurnSummary> turns = detail::turns_uncached(batch);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			PolygonProperties properties = batch.get_properties(polygon);
+			detail::store_turns(turns[polygon], properties);
+			batch.set_properties(polygon, properties);
+			result.push_back(properties.orientation());
+		}
+		return result;
+	}
+	for(const detail::TurnSummary& turns : detail::turns_uncached(batch)) {
+		result.push_back(detail::classify_orientation(turns, PolygonProperties::SelfIntersecting::UNKNOWN));
+	}
+	return result;
+}
+
+}
+
+#endif //APEX_ORIENTATION
\ No newline at end of file
@@ -9,23 +9,57 @@
 #ifndef APEX_SELF_INTERSECTIONS
 #define APEX_SELF_INTERSECTIONS
 
+#include <algorithm> //To sort edges along the sweep line.
+#include <omp.h> //To divide the sweep line over multiple threads.
+#include <utility> //To sort the intersections found on the GPU together with their work items.
+#include <vector> //To store intermediary data while finding intersections.
+
 #include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
 #include "../detail/pairing_function.hpp" //To enumerate pairs of edges that may intersect.
+#include "../detail/polygon_properties.hpp" //To skip polygons that are known not to intersect themselves.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../detail/uniform_grid.hpp" //To find pairs of edges that may intersect.
 #include "../batch.hpp" //To perform batch operations and to return batches of self-intersections.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
 #include "../line_segment.hpp" //To intersect edges of the polygon.
 #include "../self_intersection.hpp" //The return type of this operation.
+#include "intersects.hpp" //To quickly find which edges may intersect.
 
 namespace apex {
 
 namespace detail {
 
 //Forward declare the functions we'd like to use.
+inline bool known_not_self_intersecting(const PolygonProperties& properties);
+inline void set_not_self_intersecting(PolygonProperties& properties);
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_uncached(const Polygon& polygon);
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_uncached(const PolygonBatch& batch);
 template<polygonal Polygon>
 Batch<PolygonSelfIntersection> self_intersections_st_naive(const Polygon& polygon);
 template<polygonal Polygon>
 Batch<PolygonSelfIntersection> self_intersections_mt_naive(const Polygon& polygon);
+#ifdef GPU
 template<polygonal Polygon>
 Batch<PolygonSelfIntersection> self_intersections_gpu_naive(const Polygon& polygon);
+#endif //GPU
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_st_sweep(const Polygon& polygon);
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_mt_sweep(const Polygon& polygon);
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_mt_grid(const Polygon& polygon);
+
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_st(const PolygonBatch& batch);
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_mt(const PolygonBatch& batch);
+#ifdef GPU
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_gpu(const PolygonBatch& batch);
+#endif //GPU
 
 }
 
@@ -95,19 +129,305 @@ Batch<PolygonSelfIntersection> self_intersections_gpu_naive(const Polygon& polyg
  */
 template<polygonal Polygon>
 Batch<PolygonSelfIntersection> self_intersections(const Polygon& polygon) {
-	return detail::self_intersections_gpu_naive(polygon);
+	if constexpr(caches_properties<Polygon>) {
+		PolygonProperties properties = polygon.get_properties();
+		if(detail::known_not_self_intersecting(properties)) {
+			return Batch<PolygonSelfIntersection>();
+		}
+		Batch<PolygonSelfIntersection> result = detail::self_intersections_uncached(polygon);
+		if(result.empty()) {
+			detail::set_not_self_intersecting(properties);
+			polygon.set_properties(properties);
+		}
+		return result;
+	}
+	return detail::self_intersections_uncached(polygon);
+}
+
+/*!
+ * Finds all self-intersections in each polygon of a batch.
+ *
+ * Only intersections between edges of the same polygon are reported. Different
+ * polygons in the batch may intersect each other, but those intersections are
+ * not self-intersections.
+ *
+ * The self-intersections in each polygon are found according to the same rules
+ * as the \ref self_intersections function for single polygons.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to test for self-intersections.
+ * \return For each polygon in the batch, a batch of self-intersection results,
+ * in the same order as the polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections(const PolygonBatch& batch) {
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		bool all_known = true;
+		for(size_t polygon = 0; polygon < batch.size() && all_known; ++polygon) {
+			all_known = detail::known_not_self_intersecting(batch.get_properties(polygon));
+		}
+		if(all_known) {
+			return Batch<Batch<PolygonSelfIntersection>>(batch.size());
+		}
+		Batch<Batch<PolygonSelfIntersection>> result = detail::self_intersections_uncached(batch);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			if(result[polygon].empty()) {
+				PolygonProperties properties = batch.get_properties(polygon);
+				detail::set_not_self_intersecting(properties);
+				batch.set_properties(polygon, properties);
+			}
+		}
+		return result;
+	}
+	return detail::self_intersections_uncached(batch);
 }
 
 namespace detail {
 
+/*!
+ * Whether the cached properties of a polygon are enough to know that it
+ * doesn't intersect itself.
+ *
+ * Convex polygons can't intersect themselves either, so those don't need to be
+ * checked.
+ * \param properties The cached properties of a polygon.
+ * \return ``true`` if the polygon is known not to intersect itself, or
+ * ``false`` if it may intersect itself.
+ */
+inline bool known_not_self_intersecting(const PolygonProperties& properties) {
+	return properties.self_intersecting() == PolygonProperties::SelfIntersecting::NO || properties.convexity() == PolygonProperties::Convexity::CONVEX;
+}
+
+/*!
+ * Records in the cached properties of a polygon that it doesn't intersect
+ * itself.
+ *
+ * If no self-intersections were found, they may still be found by counting
+ * edge cases, so the other outcomes can't be recorded this easily. If the area
+ * of the polygon is known, this also reveals its orientation.
+ * \param properties The cached properties of a polygon without
+ * self-intersections.
+ */
+inline void set_not_self_intersecting(PolygonProperties& properties) {
+	properties.set_self_intersecting(PolygonProperties::SelfIntersecting::NO);
+	if(properties.has_area()) {
+		properties.set_area(properties.area()); //Now that the polygon is known not to intersect itself, this fills in the orientation.
+	}
+}
+
+/*!
+ * Finds all self-intersections in a polygon with the fastest version of
+ * ``self_intersections``, regardless of what is cached about the polygon.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon A polygon to test for self-intersections.
+ * \return A batch of self-intersection results.
+ */
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_uncached(const Polygon& polygon) {
+	const Dispatch dispatch(Operation::self_intersections, polygon.size());
+	switch(dispatch.version) {
+		case 0: return self_intersections_st_naive(polygon);
+		case 1: return self_intersections_st_sweep(polygon);
+	}
+	return self_intersections_mt_grid(polygon);
+}
+
+/*!
+ * Finds all self-intersections in each polygon of a batch with the fastest
+ * version of ``self_intersections``, regardless of what is cached about the
+ * polygons.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch A batch of polygons to test for self-intersections.
+ * \return For each polygon in the batch, a batch of self-intersection results,
+ * in the same order as the polygons in the batch.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_uncached(const PolygonBatch& batch) {
+	const Dispatch dispatch(Operation::self_intersections_batch, batch.size() + batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: return self_intersections_st(batch);
+	}
+	//The GPU version is not chosen automatically. It needs to transfer the whole batch and the results, which the single polygon version doesn't either.
+	return self_intersections_mt(batch);
+}
+
+/*!
+ * Computes, for each vertex of a polygon, the index of the unique position it
+ * is at along the contour.
+ *
+ * Subsequent vertices that are on the same position get the same index. This
+ * way, zero-length edges can be recognised by comparing the indices of their
+ * endpoints. The vertices at the start of the polygon get the same index as the
+ * vertices at the end if they are on the same position, so the seam of the
+ * polygon is handled as well.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find the unique positions of. It must have at
+ * least one vertex.
+ * \return For each vertex, the index of its unique position along the contour.
+ */
+template<polygonal Polygon>
+std::vector<size_t> self_intersections_position_index(const Polygon& polygon) {
+	std::vector<size_t> position_index;
+	position_index.reserve(polygon.size());
+	Point2 last_position = polygon[0];
+	position_index.push_back(0); //The first vertex is always a unique position.
+	size_t unique_position = 0;
+	for(size_t vertex = 1; vertex < polygon.size(); ++vertex) {
+		if(polygon[vertex] != last_position) {
+			unique_position++;
+			last_position = polygon[vertex];
+		}
+		position_index.push_back(unique_position);
+	}
+	for(size_t vertex = 0; vertex < polygon.size() && polygon[vertex] == last_position; ++vertex) { //Also loop around to eliminate the seam.
+		position_index[vertex] = position_index.back();
+	}
+	return position_index;
+}
+
+/*!
+ * Sorts the edges of a polygon by the lowest X coordinate of each edge.
+ *
+ * This is the order in which a sweep line moving in the +X direction would
+ * encounter the edges. Zero-length edges are left out, since those can never
+ * be reported as intersecting anything.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to sort the edges of.
+ * \param position_index The unique position of every vertex, as computed by
+ * \ref self_intersections_position_index.
+ * \return The indices of all edges with nonzero length, ordered by their lowest
+ * X coordinate. Edges with the same X coordinate are ordered by their index.
+ */
+template<polygonal Polygon>
+std::vector<size_t> self_intersections_sweep_order(const Polygon& polygon, const std::vector<size_t>& position_index) {
+	const size_t size = polygon.size();
+	std::vector<size_t> order;
+	order.reserve(size);
+	for(size_t edge = 0; edge < size; ++edge) {
+		if(position_index[edge] != position_index[(edge + 1) % size]) {
+			order.push_back(edge);
+		}
+	}
+	std::sort(order.begin(), order.end(), [&polygon, size](const size_t edge_a, const size_t edge_b) {
+		const coord_t min_a = std::min(polygon[edge_a].x, polygon[(edge_a + 1) % size].x);
+		const coord_t min_b = std::min(polygon[edge_b].x, polygon[(edge_b + 1) % size].x);
+		return min_a < min_b || (min_a == min_b && edge_a < edge_b);
+	});
+	return order;
+}
+
+/*!
+ * Tests two edges of a polygon for intersection, and adds the intersection to
+ * the result if they do.
+ *
+ * This applies the same rules as the naive implementations. Adjacent edges are
+ * skipped, since they are checked separately. Edges that only touch because
+ * there are zero-length edges in between are not reported either.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon that the edges are part of.
+ * \param position_index The unique position of every vertex, as computed by
+ * \ref self_intersections_position_index.
+ * \param segment_a The index of one of the edges to test.
+ * \param segment_b The index of the other edge to test. This must be greater
+ * than the index of the first edge.
+ * \param result The batch of self-intersections to add the intersection to, if
+ * any.
+ */
+template<polygonal Polygon>
+void self_intersections_test_pair(const Polygon& polygon, const std::vector<size_t>& position_index, const size_t segment_a, const size_t segment_b, Batch<PolygonSelfIntersection>& result) {
+	const size_t size = polygon.size();
+	if(segment_b == segment_a + 1 || (segment_a == 0 && segment_b == size - 1)) {
+		return; //Adjacent segments can only overlap, which is checked separately.
+	}
+	if(position_index[segment_a] == position_index[segment_b]) { //Only zero-length segments in between, so they are effectively adjacent.
+		return;
+	}
+	const Point2 a_start = polygon[segment_a];
+	const Point2 a_end = polygon[segment_a + 1]; //Since B > A, we don't need to check if this exceeds the polygon size.
+	const Point2 b_start = polygon[segment_b];
+	const Point2 b_end = polygon[(segment_b + 1) % size];
+	const std::optional<Point2> intersection = LineSegment::intersect(a_start, a_end, b_start, b_end);
+	if(intersection) { //They did intersect.
+		if((position_index[segment_b] == position_index[segment_a + 1] && *intersection == b_start) || (position_index[(segment_b + 1) % size] == position_index[segment_a] && *intersection == b_end)) { //But it's intersecting at the endpoints with only 0-length segments in between.
+			return; //Don't count those. They are essentially just along the same contour.
+		}
+		result.emplace_back(*intersection, segment_a, segment_b);
+	}
+}
+
+/*!
+ * Finds the self-intersections between adjacent edges of a polygon.
+ *
+ * Adjacent edges always share a vertex, which doesn't count as intersection. So
+ * they can only intersect if they overlap lengthwise.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find overlapping adjacent edges in.
+ * \param result The batch of self-intersections to add the overlaps to.
+ */
+template<polygonal Polygon>
+void self_intersections_adjacent(const Polygon& polygon, Batch<PolygonSelfIntersection>& result) {
+	const size_t size = polygon.size();
+	for(size_t vertex = 0; vertex < size; ++vertex) { //Check the two adjacent edges around this vertex.
+		const Point2 this_a = polygon[vertex];
+		const Point2 this_b = polygon[(vertex + 1) % size];
+		const size_t previous_index = (vertex + size - 1) % size;
+		const Point2 previous = polygon[previous_index];
+		if(previous.orientation_with_line(this_a, this_b) == 0) { //Can only intersect if collinear.
+			if((this_b > this_a && previous > this_a) || (this_b < this_a && previous < this_a)) { //Both line segments go in the same direction, so they partially overlap.
+				result.emplace_back(this_a, previous_index, vertex);
+			}
+		}
+	}
+}
+
+/*!
+ * Sorts self-intersections by the indices of the edges involved.
+ *
+ * Implementations that find self-intersections in parallel find them in an
+ * order that depends on the scheduling of the threads. Sorting them afterwards
+ * makes the result the same for every run.
+ * \param intersections The self-intersections to sort.
+ */
+inline void self_intersections_sort(Batch<PolygonSelfIntersection>& intersections) {
+	std::sort(intersections.begin(), intersections.end(), [](const PolygonSelfIntersection& a, const PolygonSelfIntersection& b) {
+		return a.segment_a < b.segment_a || (a.segment_a == b.segment_a && a.segment_b < b.segment_b);
+	});
+}
+
+/*!
+ * Concatenates the self-intersections found by multiple threads and sorts them.
+ * \param thread_results The self-intersections found by each thread.
+ * \return All self-intersections in one batch, sorted by the indices of the
+ * edges involved.
+ */
+inline Batch<PolygonSelfIntersection> self_intersections_merge(const std::vector<Batch<PolygonSelfIntersection>>& thread_results) {
+	size_t total = 0;
+	for(const Batch<PolygonSelfIntersection>& thread_result : thread_results) {
+		total += thread_result.size();
+	}
+	Batch<PolygonSelfIntersection> result;
+	result.reserve(total);
+	for(const Batch<PolygonSelfIntersection>& thread_result : thread_results) {
+		result.insert(result.end(), thread_result.begin(), thread_result.end());
+	}
+	self_intersections_sort(result);
+	return result;
+}
+
 /*!
  * Naive implementation to find self-intersections in a polygon.
  *
  * This implementation simply compares all pairs of line segments to see if they
- * intersect. All found intersections are returned in a batch.
+ * intersect. All found intersections are returned in a batch. Each edge is first
+ * tested against all previous edges at once with SIMD instructions, so that
+ * the exact intersection only needs to be computed for the pairs that
+ * intersect.
  *
  * The implementation is so simple that it may be very effective for low-
  * resolution polygons, but it scales badly for high-resolution polygons.
+ *
+ * Like the other versions, the intersections are sorted by the indices of the
+ * edges involved, so that the result doesn't depend on the version that found
+ * them.
  * \param polygon The polygons to find self-intersections in.
  * \return A batch of self-intersections.
  */
@@ -139,14 +459,22 @@ Batch<PolygonSelfIntersection> self_intersections_st_naive(const Polygon& polygo
 			position_index[segment_index] = position_index.back();
 		}
 
+		std::vector<char> candidates(polygon.size());
+		size_t pairs_tested = 0; //Only used for instrumentation. Without it, the compiler eliminates this counter.
 		for(size_t segment_index = 0; segment_index < polygon.size(); ++segment_index) {
 			const Point2 this_a = polygon[segment_index];
 			const Point2 this_b = polygon[(segment_index + 1) % polygon.size()];
+			if(segment_index > 1) {
+				intersects_edges(this_a, this_b, &polygon[0], segment_index - 1, candidates.data()); //Filter out the edges that certainly don't intersect with SIMD instructions first.
+			}
 			for(size_t other_index = 0; other_index + 1 < segment_index; ++other_index) { //Stop 1 short of the neighbouring segment, because neighbours can be checked more easily.
+				if(!candidates[other_index]) {
+					continue;
+				}
 				if(other_index == 0 && segment_index == polygon.size() - 1) {
 					continue; //Don't check the last vs. the first segment, as they are also neighbours.
 				}
-				if(position_index[segment_index] == position_index[(segment_index + 1) % polygon.size()] && position_index[other_index] == position_index[(other_index + 1) % polygon.size()]) {
+				if(position_index[segment_index] == position_index[(segment_index + 1) % polygon.size()] || position_index[other_index] == position_index[other_index + 1]) {
 					continue; //Segments of zero length don't intersect with anything.
 				}
 				if(position_index[segment_index] == position_index[other_index]) { //Same position, so this is a zero-length segment.
@@ -154,12 +482,13 @@ Batch<PolygonSelfIntersection> self_intersections_st_naive(const Polygon& polygo
 				}
 				const Point2 other_a = polygon[other_index];
 				const Point2 other_b = polygon[other_index + 1]; //No need to limit to polygon size, since this can never equal segment_index.
-				const std::optional<Point2> intersection = LineSegment::intersect(this_a, this_b, other_a, other_b);
+				pairs_tested++;
+				const std::optional<Point2> intersection = LineSegment::intersect(other_a, other_b, this_a, this_b); //Lowest index first, like the other versions, so that ties are rounded the same way.
 				if(intersection) { //They did intersect.
 					if((position_index[segment_index] == position_index[other_index + 1] && *intersection == this_a) || (position_index[(segment_index + 1) % polygon.size()] == position_index[other_index] && *intersection == this_b)) { //But it's intersecting at the endpoints with only 0-length segments in between.
 						continue; //Don't count those. They are essentially just along the same contour.
 					}
-					result.emplace_back(*intersection, segment_index, other_index);
+					result.emplace_back(*intersection, other_index, segment_index);
 				}
 			}
 			//We skipped the neighbour. Check now for self-intersection with the neighbour. This can only partially overlap, never properly intersect.
@@ -171,6 +500,8 @@ Batch<PolygonSelfIntersection> self_intersections_st_naive(const Polygon& polygo
 				}
 			}
 		}
+		Instrumentation::count(Counter::pairs_tested, pairs_tested);
+		self_intersections_sort(result);
 	}
 	return result;
 }
@@ -181,7 +512,10 @@ Batch<PolygonSelfIntersection> self_intersections_st_naive(const Polygon& polygo
  * This implementation simply compares all pairs of line segments to see if they
  * intersect. All found intersections are returned in a batch.
  * This version parallelises the work by dividing the pairs of edges over a
- * number of different threads.
+ * number of different threads. Each thread collects its own results, which are
+ * merged and sorted by the indices of the edges afterwards. This way, the
+ * threads don't need to wait for each other, and the result is the same in
+ * every run.
  *
  * The implementation is so simple that it may be very effective for low-
  * resolution polygons, but it scales badly for high-resolution polygons.
@@ -199,39 +533,8 @@ Batch<PolygonSelfIntersection> self_intersections_mt_naive(const Polygon& polygo
 		only one. So we can special-case that. */
 		result.emplace_back(polygon[0], 0, 1); //The 0th segment always intersects with the 1st segment. Choose any point on the line as intersection point.
 	} else if(polygon.size() > 2) [[likely]] {
-		//Pre-compute the unique positions along the contour, to find and ignore zero-length edges.
-		//We divide the polygon into segments, one for each thread. These segments are then sewn together afterwards.
-		std::vector<size_t> position_index;
-		position_index.resize(polygon.size());
-		const size_t thread_count = omp_get_num_threads();
-		const size_t vertices_per_thread = polygon.size() / thread_count;
-		const size_t leftover = polygon.size() % thread_count; //The first few threads get 1 extra, if it's not divisible by the thread count.
-		#pragma omp parallel for
-		for(size_t thread = 0; thread < thread_count; ++thread) {
-			const size_t start_vertex = vertices_per_thread * thread + std::min(thread, leftover);
-			const size_t end_vertex = start_vertex + vertices_per_thread + (thread < leftover);
-			Point2 last_position = polygon[start_vertex];
-			size_t unique_position = start_vertex; //Likely too high if there are any duplicates in previous segments, but for the algorithm this doesn't matter.
-			for(size_t vertex = start_vertex + 1; vertex < end_vertex; ++vertex) {
-				if(polygon[vertex] != last_position) {
-					unique_position++;
-					last_position = polygon[vertex];
-				}
-				position_index[vertex] = unique_position;
-			}
-		}
-		//If the vertices around the segment seams are equal, sow the seams to indicate that the positions are equal.
-		for(size_t thread = 0; thread < thread_count; ++thread) {
-			const size_t start_vertex = vertices_per_thread * thread + std::min(thread, leftover);
-			const size_t end_vertex = start_vertex + vertices_per_thread + (thread < leftover);
-			const size_t previous_vertex = (start_vertex + polygon.size() - 1) % polygon.size();
-			if(polygon[previous_vertex] == polygon[start_vertex]) {
-				const size_t old_position_index = position_index[start_vertex];
-				for(size_t vertex = start_vertex; vertex < end_vertex && position_index[vertex] == old_position_index; ++vertex) {
-					position_index[vertex] = position_index[previous_vertex];
-				}
-			}
-		}
+		const std::vector<size_t> position_index = self_intersections_position_index(polygon); //To find and ignore zero-length edges. This takes linear time, which is insignificant compared to checking all pairs.
+		std::vector<Batch<PolygonSelfIntersection>> thread_results(omp_get_max_threads()); //Each thread collects its own results, so they don't need to wait on each other.
 
 		constexpr bool disallow_adjacent = false;
 		const size_t num_pairs = num_pairings(polygon.size(), disallow_adjacent);
@@ -254,11 +557,10 @@ Batch<PolygonSelfIntersection> self_intersections_mt_naive(const Polygon& polygo
 			const Point2 b_end = polygon[(segment_b + 1) % polygon.size()];
 			const std::optional<Point2> intersection = LineSegment::intersect(a_start, a_end, b_start, b_end);
 			if(intersection) { //They did intersect.
-				if((position_index[segment_a] == position_index[segment_b + 1] && *intersection == a_start) || (position_index[(segment_a + 1) % polygon.size()] == position_index[segment_b] && *intersection == a_end)) { //But it's intersecting at the endpoints with only 0-length segments in between.
+				if((position_index[segment_a] == position_index[(segment_b + 1) % polygon.size()] && *intersection == a_start) || (position_index[(segment_a + 1) % polygon.size()] == position_index[segment_b] && *intersection == a_end)) { //But it's intersecting at the endpoints with only 0-length segments in between.
 					continue; //Don't count those. They are essentially just along the same contour.
 				}
-				#pragma omp critical
-				result.emplace_back(*intersection, segment_a, segment_b);
+				thread_results[omp_get_thread_num()].emplace_back(*intersection, segment_a, segment_b);
 			}
 		}
 
@@ -271,22 +573,25 @@ Batch<PolygonSelfIntersection> self_intersections_mt_naive(const Polygon& polygo
 			const Point2 previous = polygon[previous_index];
 			if(previous.orientation_with_line(this_a, this_b) == 0) { //Can only intersect if collinear.
 				if((this_b > this_a && previous > this_a) || (this_b < this_a && previous < this_a)) { //Both line segments go in the same direction, so they partially overlap.
-					#pragma omp critical
-					result.emplace_back(this_a, previous_index, vertex);
+					thread_results[omp_get_thread_num()].emplace_back(this_a, previous_index, vertex);
 				}
 			}
 		}
+		result = self_intersections_merge(thread_results);
 	}
 	return result;
 }
 
+#ifdef GPU
 /*!
  * Naive implementation to find self-intersections in a polygon.
  *
  * This implementation simply compares all pairs of line segments to see if they
  * intersect. All found intersections are returned in a batch.
  * This version parallelises the work on the GPU by dividing the pairs of edges
- * over a number of different teams.
+ * over a number of different teams. Like the batch version, the intersections
+ * are collected in a buffer with an atomic counter, and sorted by the indices
+ * of the edges afterwards.
  *
  * The implementation is so simple that it may be very effective for low-
  * resolution polygons, but it scales badly for high-resolution polygons.
@@ -304,98 +609,575 @@ Batch<PolygonSelfIntersection> self_intersections_gpu_naive(const Polygon& polyg
 		only one. So we can special-case that. */
 		result.emplace_back(polygon[0], 0, 1); //The 0th segment always intersects with the 1st segment. Choose any point on the line as intersection point.
 	} else if(polygon.size() > 2) [[likely]] {
-		//Pre-compute an array that indicates how many identical vertices in a row we've encountered.
-		//This allows to find and ignore zero-length edges, while still identifying loops in the polygon correctly if the crossing is on a vertex.
-		//We will first write a 1 for each vertex that is identical to the previous vertex.
-		bool found_any_sequence_start = false;
-		bool has_any_sequence = false;
+		//Pre-compute the unique positions along the contour on the host, to find and ignore zero-length edges, like the other implementations.
+		//This takes linear time, which is insignificant compared to checking all pairs.
+		const std::vector<size_t> position_index = self_intersections_position_index(polygon);
 		const Point2* vertex_data = polygon.data();
 		const size_t size = polygon.size();
-		std::vector<size_t> position_index;
-		position_index.resize(size);
-		size_t* position_data = position_index.data();
-
-		if(vertex_data[0] == vertex_data[size - 1]) { //Special case for the closing edge.
-			position_index[0] = 1;
-			has_any_sequence = true;
+		const size_t* position_data = position_index.data();
+		if constexpr(gpu_tracked<Polygon>) {
+			GPUDataTracker::sync_to_gpu(vertex_data, size, &polygon); //Leave the vertices on the GPU for subsequent operations.
 		}
-		#pragma omp target teams distribute parallel for map(to:vertex_data[1:size]) map(from:position_data[1:size])
-		for(size_t vertex = 1; vertex < size; ++vertex) {
-			if(vertex_data[vertex] == vertex_data[vertex - 1]) {
-				position_data[vertex] = 1;
-				#pragma omp atomic
-				has_any_sequence |= true;
+		constexpr bool disallow_adjacent = false;
+		const size_t num_pairs = num_pairings(size, disallow_adjacent);
+		const size_t total_work = num_pairs + size; //First all pairs of edges, then each vertex to check its two adjacent edges.
+		size_t capacity = size + 1; //Most polygons intersect themselves only a few times, if at all, so start with room for one intersection per vertex.
+		std::vector<size_t> found_work;
+		std::vector<Point2> found_locations;
+		size_t num_found = 0;
+		while(true) {
+			found_work.resize(capacity);
+			found_locations.resize(capacity);
+			size_t* found_work_data = found_work.data();
+			Point2* found_location_data = found_locations.data();
+			num_found = 0;
+			#pragma omp target teams distribute parallel for map(to:vertex_data[0:size], position_data[0:size]) map(from:found_work_data[0:capacity], found_location_data[0:capacity]) map(tofrom:num_found)
+			for(size_t work = 0; work < total_work; ++work) {
+				Point2 location;
+				if(work < num_pairs) { //Check a pair of non-adjacent edges.
+					auto[segment_a, segment_b] = enumerate_pairs(size, work, disallow_adjacent);
+					if(segment_a == 0 && segment_b == size - 1) {
+						continue; //Don't check the last vs. the first segment, as they are also neighbours.
+					}
+					if(position_data[segment_a] == position_data[segment_a + 1] || position_data[segment_b] == position_data[(segment_b + 1) % size]) {
+						continue; //Segments of zero length don't intersect with anything.
+					}
+					if(position_data[segment_a] == position_data[segment_b]) { //Only zero-length segments in between, so they are effectively adjacent.
+						continue;
+					}
+					const Point2 a_start = vertex_data[segment_a];
+					const Point2 a_end = vertex_data[segment_a + 1]; //Since B > A, we don't need to check if this exceeds the polygon size.
+					const Point2 b_start = vertex_data[segment_b];
+					const Point2 b_end = vertex_data[(segment_b + 1) % size];
+					const std::optional<Point2> intersection = LineSegment::intersect(a_start, a_end, b_start, b_end);
+					if(!intersection) {
+						continue;
+					}
+					if((position_data[segment_b] == position_data[segment_a + 1] && *intersection == b_start) || (position_data[(segment_b + 1) % size] == position_data[segment_a] && *intersection == b_end)) { //Intersecting at the endpoints with only 0-length segments in between.
+						continue; //Don't count those. They are essentially just along the same contour.
+					}
+					location = *intersection;
+				} else { //We skipped each vertex' neighbour. Check now for overlap with the neighbour. This can only partially overlap, never properly intersect.
+					const size_t vertex = work - num_pairs;
+					const Point2 this_a = vertex_data[vertex];
+					const Point2 this_b = vertex_data[(vertex + 1) % size];
+					const Point2 previous = vertex_data[(vertex + size - 1) % size];
+					if(previous.orientation_with_line(this_a, this_b) != 0) {
+						continue; //Can only intersect if collinear.
+					}
+					//Compare lexicographically, like the ordering of Point2, but without relying on a three-way comparison in device code.
+					const bool b_after_a = this_b.x > this_a.x || (this_b.x == this_a.x && this_b.y > this_a.y);
+					const bool b_before_a = this_b.x < this_a.x || (this_b.x == this_a.x && this_b.y < this_a.y);
+					const bool previous_after_a = previous.x > this_a.x || (previous.x == this_a.x && previous.y > this_a.y);
+					const bool previous_before_a = previous.x < this_a.x || (previous.x == this_a.x && previous.y < this_a.y);
+					if(!(b_after_a && previous_after_a) && !(b_before_a && previous_before_a)) {
+						continue; //The line segments go in opposite directions, so they only touch at this vertex.
+					}
+					location = this_a; //Both line segments go in the same direction, so they partially overlap.
+				}
+
+				size_t slot;
+				#pragma omp atomic capture
+				slot = num_found++;
+				if(slot < capacity) { //If the buffer is full, only count the intersection, so that the buffer can be made big enough.
+					found_work_data[slot] = work;
+					found_location_data[slot] = location;
+				}
 			}
+			if(num_found <= capacity) {
+				break;
+			}
+			capacity = num_found; //Run again with room for all of them.
 		}
-		//Next, each vertex that is at the start of a sequence of 1's will count on to the end of its segment.
-		//After this, the position_index should contain a list of how many repeated vertices there are, allowing instantly finding the start of a sequence.
-		#pragma omp target teams distribute parallel for map(to:vertex_data[1:size]) map(tofrom:position_data[1:size])
-		for(size_t vertex = 1; vertex < size; ++vertex) {
-			if(position_data[vertex] == 1 && position_data[vertex - 1] == 0) { //This is a start of a sequence.
-				#pragma omp atomic
-				found_any_sequence_start |= true;
-				for(size_t crawl = 1; position_data[vertex + crawl] == 1; ++crawl) {
-					position_data[vertex + crawl] = 1 + crawl;
-				}
+
+		//The GPU can't append to the result, so collect the intersections on the host, in the order of the work items to make the result deterministic.
+		std::vector<std::pair<size_t, Point2>> found;
+		found.reserve(num_found);
+		for(size_t slot = 0; slot < num_found; ++slot) {
+			found.emplace_back(found_work[slot], found_locations[slot]);
+		}
+		std::sort(found.begin(), found.end(), [](const std::pair<size_t, Point2>& a, const std::pair<size_t, Point2>& b) {
+			return a.first < b.first;
+		});
+		result.reserve(found.size());
+		for(const auto& [work, location] : found) {
+			if(work < num_pairs) {
+				auto[segment_a, segment_b] = enumerate_pairs(size, work, disallow_adjacent);
+				result.emplace_back(location, segment_a, segment_b);
+			} else {
+				const size_t vertex = work - num_pairs;
+				result.emplace_back(location, (vertex + size - 1) % size, vertex);
 			}
 		}
-		//The 0th vertex is a special case, so do that one on the main thread.
-		if(position_data[0] == 1 && position_data[size - 1] == 0) {
-			found_any_sequence_start = true;
-			for(size_t crawl = 1; position_data[crawl] == 1; ++crawl) {
-				position_data[crawl] = 1 + crawl;
+		self_intersections_sort(result);
+	}
+	return result;
+}
+#endif //GPU
+
+/*!
+ * Runs part of a sweep line over the edges of a polygon, to find intersections
+ * between non-adjacent edges.
+ *
+ * The sweep line moves in the +X direction. It keeps track of all edges that it
+ * is currently crossing. Each edge it encounters is only tested for
+ * intersection against the edges that it is crossing at that moment, and only
+ * if their Y ranges overlap as well.
+ *
+ * The sweep can be started and ended anywhere along the sweep order. The edges
+ * encountered before the start that are still crossed by the sweep line at the
+ * start are included in the tests. This allows splitting the sweep into slabs
+ * that are processed independently. Every pair of edges is tested exactly once
+ * over all slabs, by the slab containing the edge that is encountered last.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find self-intersections in.
+ * \param position_index The unique position of every vertex, as computed by
+ * \ref self_intersections_position_index.
+ * \param order The order in which the sweep line encounters the edges, as
+ * computed by \ref self_intersections_sweep_order.
+ * \param start The position in the sweep order to start sweeping.
+ * \param end The position in the sweep order to stop sweeping (exclusive).
+ * \param result The batch of self-intersections to add the found intersections
+ * to.
+ */
+template<polygonal Polygon>
+void self_intersections_sweep(const Polygon& polygon, const std::vector<size_t>& position_index, const std::vector<size_t>& order, const size_t start, const size_t end, Batch<PolygonSelfIntersection>& result) {
+	if(start >= end) {
+		return;
+	}
+	const size_t size = polygon.size();
+	std::vector<size_t> active; //The edges that the sweep line is currently crossing.
+	const coord_t start_x = std::min(polygon[order[start]].x, polygon[(order[start] + 1) % size].x);
+	for(size_t sweep_index = 0; sweep_index < start; ++sweep_index) { //Find the edges from previous slabs that reach into this slab.
+		const size_t edge = order[sweep_index];
+		if(std::max(polygon[edge].x, polygon[(edge + 1) % size].x) >= start_x) {
+			active.push_back(edge);
+		}
+	}
+
+	size_t pairs_tested = 0; //Only used for instrumentation. Without it, the compiler eliminates this counter.
+	for(size_t sweep_index = start; sweep_index < end; ++sweep_index) {
+		const size_t edge = order[sweep_index];
+		const Point2 edge_start = polygon[edge];
+		const Point2 edge_end = polygon[(edge + 1) % size];
+		const coord_t sweep_x = std::min(edge_start.x, edge_end.x);
+		const coord_t min_y = std::min(edge_start.y, edge_end.y);
+		const coord_t max_y = std::max(edge_start.y, edge_end.y);
+		for(size_t active_index = 0; active_index < active.size();) {
+			const size_t other = active[active_index];
+			const Point2 other_start = polygon[other];
+			const Point2 other_end = polygon[(other + 1) % size];
+			if(std::max(other_start.x, other_end.x) < sweep_x) { //The sweep line has passed this edge. Remove it by replacing it with the last one.
+				active[active_index] = active.back();
+				active.pop_back();
+				continue;
 			}
+			if(std::max(other_start.y, other_end.y) >= min_y && std::min(other_start.y, other_end.y) <= max_y) { //Bounding boxes overlap, so they may intersect.
+				self_intersections_test_pair(polygon, position_index, std::min(edge, other), std::max(edge, other), result);
+				pairs_tested++;
+			}
+			active_index++;
+		}
+		active.push_back(edge);
+	}
+	Instrumentation::count(Counter::pairs_tested, pairs_tested);
+}
+
+/*!
+ * Sweep line implementation to find self-intersections in a polygon.
+ *
+ * This implementation moves a line along the X direction, and only tests edges
+ * for intersection if the line crosses both of them at the same time and their
+ * Y ranges overlap. The edges need to be sorted for this, which makes this
+ * implementation scale with \f$O(n \log n + k)\f$, where \f$k\f$ is the number
+ * of pairs of edges with overlapping bounding boxes. For most polygons that is
+ * far fewer than the number of all pairs of edges.
+ *
+ * This is not the full Bentley-Ottmann algorithm, which would also maintain the
+ * vertical order of the edges crossing the sweep line. That order is hard to
+ * maintain with the overlapping and touching edges that this operation needs to
+ * report, so the Y ranges are compared for each pair instead. The intersections
+ * are found in the order of the sweep, so they are sorted by the indices of the
+ * edges afterwards, like in the other versions.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find self-intersections in.
+ * \return A batch of self-intersections.
+ */
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_st_sweep(const Polygon& polygon) {
+	Batch<PolygonSelfIntersection> result;
+	if(polygon.size() == 2) [[unlikely]] {
+		//With 2 vertices, the two line segments loop back on each other, completely overlapping. That is only one intersection.
+		result.emplace_back(polygon[0], 0, 1); //The 0th segment always intersects with the 1st segment. Choose any point on the line as intersection point.
+	} else if(polygon.size() > 2) [[likely]] {
+		const std::vector<size_t> position_index = self_intersections_position_index(polygon);
+		const std::vector<size_t> order = self_intersections_sweep_order(polygon, position_index);
+		self_intersections_sweep(polygon, position_index, order, 0, order.size(), result);
+		self_intersections_adjacent(polygon, result);
+		self_intersections_sort(result);
+	}
+	return result;
+}
+
+/*!
+ * Sweep line implementation to find self-intersections in a polygon, dividing
+ * the sweep over multiple threads.
+ *
+ * The sweep order is divided into slabs with an equal number of edges. Each
+ * slab is swept separately, starting with the edges of previous slabs that
+ * reach into the slab. There are a few more slabs than threads, so that the
+ * work remains balanced if some slabs are more crowded than others. The results
+ * of the slabs are sorted by the indices of the edges afterwards, so the result
+ * doesn't depend on the number of threads that processed them.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find self-intersections in.
+ * \return A batch of self-intersections.
+ */
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_mt_sweep(const Polygon& polygon) {
+	Batch<PolygonSelfIntersection> result;
+	if(polygon.size() == 2) [[unlikely]] {
+		//With 2 vertices, the two line segments loop back on each other, completely overlapping. That is only one intersection.
+		result.emplace_back(polygon[0], 0, 1); //The 0th segment always intersects with the 1st segment. Choose any point on the line as intersection point.
+	} else if(polygon.size() > 2) [[likely]] {
+		const std::vector<size_t> position_index = self_intersections_position_index(polygon);
+		const std::vector<size_t> order = self_intersections_sweep_order(polygon, position_index);
+		const size_t num_slabs = std::max(size_t(1), std::min(order.size(), size_t(omp_get_max_threads()) * 4));
+		std::vector<Batch<PolygonSelfIntersection>> slab_results(num_slabs);
+		#pragma omp parallel for schedule(dynamic)
+		for(size_t slab = 0; slab < num_slabs; ++slab) {
+			const size_t start = order.size() * slab / num_slabs;
+			const size_t end = order.size() * (slab + 1) / num_slabs;
+			self_intersections_sweep(polygon, position_index, order, start, end, slab_results[slab]);
+		}
+		for(const Batch<PolygonSelfIntersection>& slab_result : slab_results) {
+			result.insert(result.end(), slab_result.begin(), slab_result.end());
+		}
+		self_intersections_adjacent(polygon, result);
+		self_intersections_sort(result);
+	}
+	return result;
+}
+
+
+/*!
+ * Implementation to find self-intersections in a polygon that uses a uniform
+ * grid to find the pairs of edges that may intersect.
+ *
+ * The bounding boxes of all edges are binned into the cells of a grid. Only
+ * pairs of edges whose bounding boxes overlap are tested for intersection. The
+ * cells of the grid are processed in parallel. For dense polygons where most of
+ * the edges are short compared to the size of the polygon, this takes roughly
+ * linear time. If there are many long edges, they will end up in many cells,
+ * and the grid becomes less effective.
+ *
+ * The results of the threads are merged and sorted by the indices of the
+ * edges afterwards, so the result is the same in every run.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find self-intersections in.
+ * \return A batch of self-intersections.
+ */
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_mt_grid(const Polygon& polygon) {
+	Batch<PolygonSelfIntersection> result;
+	if(polygon.size() == 2) [[unlikely]] {
+		//With 2 vertices, the two line segments loop back on each other, completely overlapping. That is only one intersection.
+		result.emplace_back(polygon[0], 0, 1); //The 0th segment always intersects with the 1st segment. Choose any point on the line as intersection point.
+	} else if(polygon.size() > 2) [[likely]] {
+		const size_t size = polygon.size();
+		const std::vector<size_t> position_index = self_intersections_position_index(polygon);
+		std::vector<std::pair<Point2, Point2>> boxes(size);
+		#pragma omp parallel for
+		for(size_t edge = 0; edge < size; ++edge) {
+			const Point2 start = polygon[edge];
+			const Point2 end = polygon[(edge + 1) % size];
+			boxes[edge] = {Point2(std::min(start.x, end.x), std::min(start.y, end.y)), Point2(std::max(start.x, end.x), std::max(start.y, end.y))};
 		}
-		if(has_any_sequence && !found_any_sequence_start) [[unlikely]] { //There is a sequence, but no vertex is the start of it. So all vertices are identical.
-			//Return empty result.
-		} else {
-			constexpr bool disallow_adjacent = false;
+		const UniformGrid grid(boxes);
+
+		std::vector<Batch<PolygonSelfIntersection>> thread_results(omp_get_max_threads());
+		#pragma omp parallel for schedule(dynamic, 64)
+		for(size_t cell = 0; cell < grid.num_cells(); ++cell) {
+			Batch<PolygonSelfIntersection>& thread_result = thread_results[omp_get_thread_num()];
+			size_t pairs_tested = 0; //Only used for instrumentation. Without it, the compiler eliminates this counter.
+			grid.candidates(cell, [&](const size_t segment_a, const size_t segment_b) {
+				if(position_index[segment_a] == position_index[(segment_a + 1) % size] || position_index[segment_b] == position_index[(segment_b + 1) % size]) {
+					return; //Segments of zero length don't intersect with anything.
+				}
+				self_intersections_test_pair(polygon, position_index, segment_a, segment_b, thread_result);
+				pairs_tested++;
+			});
+			Instrumentation::count(Counter::pairs_tested, pairs_tested);
+		}
+		self_intersections_adjacent(polygon, thread_results[0]);
+		result = self_intersections_merge(thread_results);
+	}
+	return result;
+}
+
+
+/*!
+ * Finds the self-intersections in one polygon of a batch, with the fastest
+ * single-threaded version.
+ *
+ * The versions are chosen with the crossovers of ``self_intersections`` for
+ * single polygons. The batch implementations already divide the polygons over
+ * the threads, so the multi-threaded versions are not considered. The choice is
+ * made without a \ref Dispatch, so that the instrumentation only reports the
+ * version chosen for the batch, not one for every polygon in it.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to find self-intersections in.
+ * \return A batch of self-intersections.
+ */
+template<polygonal Polygon>
+Batch<PolygonSelfIntersection> self_intersections_st_fastest(const Polygon& polygon) {
+	if(Strategies::choose(Operation::self_intersections, polygon.size()) == 0) {
+		return self_intersections_st_naive(polygon);
+	}
+	return self_intersections_st_sweep(polygon);
+}
+
+/*!
+ * Single-threaded implementation to find the self-intersections in each
+ * polygon of a batch.
+ *
+ * This simply finds the self-intersections of each polygon in turn. Small
+ * polygons are handled with the naive implementation, since that has the least
+ * overhead. Bigger polygons use the sweep line. Both give the same result, so
+ * the result doesn't depend on which polygons were handled by which version.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to find self-intersections in.
+ * \return For each polygon, a batch of self-intersections.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_st(const PolygonBatch& batch) {
+	Batch<Batch<PolygonSelfIntersection>> result;
+	result.reserve(batch.size());
+	for(size_t polygon_index = 0; polygon_index < batch.size(); ++polygon_index) {
+		const auto& polygon = batch[polygon_index]; //Instantiates auto with whatever type the batch indexes.
+		result.push_back(self_intersections_st_fastest(polygon));
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation to find the self-intersections in each polygon
+ * of a batch.
+ *
+ * The polygons are divided over the threads. Each polygon is processed by a
+ * single thread, like in the single-threaded implementation. Since polygons may
+ * differ a lot in size, they are scheduled dynamically.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to find self-intersections in.
+ * \return For each polygon, a batch of self-intersections.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_mt(const PolygonBatch& batch) {
+	std::vector<Batch<PolygonSelfIntersection>> polygon_results(batch.size());
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t polygon_index = 0; polygon_index < batch.size(); ++polygon_index) {
+		const auto& polygon = batch[polygon_index]; //Instantiates auto with whatever type the batch indexes.
+		polygon_results[polygon_index] = self_intersections_st_fastest(polygon);
+	}
+
+	Batch<Batch<PolygonSelfIntersection>> result;
+	result.reserve(batch.size());
+	size_t total = 0;
+	for(const Batch<PolygonSelfIntersection>& polygon_result : polygon_results) {
+		total += polygon_result.size();
+	}
+	result.reserve_subelements(total);
+	for(const Batch<PolygonSelfIntersection>& polygon_result : polygon_results) {
+		result.push_back(polygon_result);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Implementation to find the self-intersections in each polygon of a batch that
+ * runs on the graphics card, if available.
+ *
+ * All pairs of edges of all polygons are tested in a single kernel on the GPU,
+ * working on the vertex buffer of the whole batch at once. Each work item in
+ * this kernel is either a pair of non-adjacent edges in one of the polygons, or
+ * a vertex, for which the two adjacent edges are checked for overlap. Each work
+ * item finds the polygon it belongs to with a binary search through the
+ * cumulative number of work items per polygon.
+ *
+ * The GPU can't append to the result, so instead each work item that finds an
+ * intersection claims a slot in an output buffer with an atomic counter, and
+ * writes its work item and the location of the intersection there. This way
+ * the memory needed only grows with the number of vertices and intersections,
+ * not with the number of pairs of edges. If the buffer turns out to be too
+ * small, the kernel is executed again with a buffer that has room for all
+ * intersections. The slots are claimed in an order that depends on the
+ * scheduling of the GPU, so the intersections are sorted by work item
+ * afterwards, to make the result deterministic. The intersections of each
+ * polygon are then sorted by the indices of the edges involved, like in the
+ * other implementations.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to find self-intersections in.
+ * \return For each polygon, a batch of self-intersections.
+ */
+template<multi_polygonal PolygonBatch>
+Batch<Batch<PolygonSelfIntersection>> self_intersections_gpu(const PolygonBatch& batch) {
+	const size_t batch_size = batch.size();
+	const Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Leave the vertices on the GPU for subsequent operations.
+	}
+
+	//Prepare the layout of the work on the host. This takes linear time, which is insignificant compared to checking all pairs.
+	std::vector<size_t> offsets(batch_size, 0); //Where each polygon starts in the vertex buffer.
+	std::vector<size_t> sizes(batch_size);
+	std::vector<size_t> work_starts(batch_size + 1, 0); //Cumulative number of work items per polygon.
+	std::vector<size_t> position_index(vertices_size, 0); //To find and ignore zero-length edges, like the other implementations.
+	constexpr bool disallow_adjacent = false;
+	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
+		const auto& polygon = batch[polygon_index]; //Instantiates auto with whatever type the batch indexes.
+		sizes[polygon_index] = polygon.size();
+		size_t work = 0;
+		if(polygon.size() > 2) {
+			offsets[polygon_index] = polygon.data() - vertices;
+			const std::vector<size_t> polygon_position_index = self_intersections_position_index(polygon);
+			std::copy(polygon_position_index.begin(), polygon_position_index.end(), position_index.begin() + offsets[polygon_index]);
+			work = num_pairings(polygon.size(), disallow_adjacent) + polygon.size();
+		}
+		work_starts[polygon_index + 1] = work_starts[polygon_index] + work;
+	}
+	const size_t total_work = work_starts.back();
+
+	const size_t* offsets_data = offsets.data();
+	const size_t* sizes_data = sizes.data();
+	const size_t* work_starts_data = work_starts.data();
+	const size_t* position_data = position_index.data();
+	size_t capacity = vertices_size + 1; //Most polygons intersect themselves only a few times, if at all, so start with room for one intersection per vertex.
+	std::vector<size_t> found_work;
+	std::vector<Point2> found_locations;
+	size_t num_found = 0;
+	while(true) {
+		found_work.resize(capacity);
+		found_locations.resize(capacity);
+		size_t* found_work_data = found_work.data();
+		Point2* found_location_data = found_locations.data();
+		num_found = 0;
+		#pragma omp target teams distribute parallel for map(to:vertices[0:vertices_size], position_data[0:vertices_size], offsets_data[0:batch_size], sizes_data[0:batch_size], work_starts_data[0:batch_size + 1]) map(from:found_work_data[0:capacity], found_location_data[0:capacity]) map(tofrom:num_found)
+		for(size_t work = 0; work < total_work; ++work) {
+			//Find the last polygon that starts at or before this work item. Polygons without work items start at the same place as the next one, so they won't be selected.
+			size_t polygon_index = 0;
+			size_t upper = batch_size;
+			while(upper - polygon_index > 1) {
+				const size_t middle = (polygon_index + upper) / 2;
+				if(work_starts_data[middle] <= work) {
+					polygon_index = middle;
+				} else {
+					upper = middle;
+				}
+			}
+			const Point2* polygon = vertices + offsets_data[polygon_index];
+			const size_t* positions = position_data + offsets_data[polygon_index];
+			const size_t size = sizes_data[polygon_index];
+			const size_t local_work = work - work_starts_data[polygon_index];
 			const size_t num_pairs = num_pairings(size, disallow_adjacent);
-			#pragma omp target teams distribute parallel for
-			for(size_t pair_index = 0; pair_index < num_pairs; ++pair_index) {
-				auto[segment_a, segment_b] = enumerate_pairs(size, pair_index, disallow_adjacent);
 
+			Point2 location;
+			if(local_work < num_pairs) { //Check a pair of non-adjacent edges.
+				auto[segment_a, segment_b] = enumerate_pairs(size, local_work, disallow_adjacent);
 				if(segment_a == 0 && segment_b == size - 1) {
 					continue; //Don't check the last vs. the first segment, as they are also neighbours.
 				}
-				if(position_data[segment_a + 1] > 0 || position_data[(segment_b + 1) % size] > 0) {
+				if(positions[segment_a] == positions[segment_a + 1] || positions[segment_b] == positions[(segment_b + 1) % size]) {
 					continue; //Segments of zero length don't intersect with anything.
 				}
-				if(position_data[segment_a] == position_data[segment_b]) { //Same position, so this is a zero-length segment.
-					continue; //Skip. They may not intersect anything (and the segment intersection check doesn't deal with this well).
+				if(positions[segment_a] == positions[segment_b]) { //Only zero-length segments in between, so they are effectively adjacent.
+					continue;
 				}
-				const Point2 a_start = vertex_data[segment_a];
-				const Point2 a_end = vertex_data[segment_a + 1]; //Since B > A, we don't need to check if this exceeds the polygon size.
-				const Point2 b_start = vertex_data[segment_b];
-				const Point2 b_end = vertex_data[(segment_b + 1) % size];
+				const Point2 a_start = polygon[segment_a];
+				const Point2 a_end = polygon[segment_a + 1]; //Since B > A, we don't need to check if this exceeds the polygon size.
+				const Point2 b_start = polygon[segment_b];
+				const Point2 b_end = polygon[(segment_b + 1) % size];
 				const std::optional<Point2> intersection = LineSegment::intersect(a_start, a_end, b_start, b_end);
-				if(intersection) { //They did intersect.
-					if((position_data[segment_a] == position_data[segment_b + 1] && *intersection == a_start) || (position_data[(segment_a + 1) % size] == position_data[segment_b] && *intersection == a_end)) { //But it's intersecting at the endpoints with only 0-length segments in between.
-						continue; //Don't count those. They are essentially just along the same contour.
-					}
-					#pragma omp critical
-					result.emplace_back(*intersection, segment_a, segment_b);
+				if(!intersection) {
+					continue;
+				}
+				if((positions[segment_b] == positions[segment_a + 1] && *intersection == b_start) || (positions[(segment_b + 1) % size] == positions[segment_a] && *intersection == b_end)) { //Intersecting at the endpoints with only 0-length segments in between.
+					continue; //Don't count those. They are essentially just along the same contour.
+				}
+				location = *intersection;
+			} else { //Check the two adjacent edges around a vertex for overlap.
+				const size_t vertex = local_work - num_pairs;
+				const Point2 this_a = polygon[vertex];
+				const Point2 this_b = polygon[(vertex + 1) % size];
+				const Point2 previous = polygon[(vertex + size - 1) % size];
+				if(previous.orientation_with_line(this_a, this_b) != 0) {
+					continue; //Can only intersect if collinear.
 				}
+				//Compare lexicographically, like the ordering of Point2, but without relying on a three-way comparison in device code.
+				const bool b_after_a = this_b.x > this_a.x || (this_b.x == this_a.x && this_b.y > this_a.y);
+				const bool b_before_a = this_b.x < this_a.x || (this_b.x == this_a.x && this_b.y < this_a.y);
+				const bool previous_after_a = previous.x > this_a.x || (previous.x == this_a.x && previous.y > this_a.y);
+				const bool previous_before_a = previous.x < this_a.x || (previous.x == this_a.x && previous.y < this_a.y);
+				if(!(b_after_a && previous_after_a) && !(b_before_a && previous_before_a)) {
+					continue; //The line segments go in opposite directions, so they only touch at this vertex.
+				}
+				location = this_a; //Both line segments go in the same direction, so they partially overlap.
 			}
 
-			//We skipped each vertex' neighbour. Check now for self-intersection with the neighbour. This can only partially overlap, never properly intersect.
-			#pragma omp target teams distribute parallel for
-			for(size_t vertex = 0; vertex < size; ++vertex) { //Check the two adjacent edges around this vertex.
-				const Point2 this_a = vertex_data[vertex];
-				const Point2 this_b = vertex_data[(vertex + 1) % size];
-				const size_t previous_index = (vertex + size - 1) % size;
-				const Point2 previous = vertex_data[previous_index];
-				if(previous.orientation_with_line(this_a, this_b) == 0) { //Can only intersect if collinear.
-					if((this_b > this_a && previous > this_a) || (this_b < this_a && previous < this_a)) { //Both line segments go in the same direction, so they partially overlap.
-						#pragma omp critical
-						result.emplace_back(this_a, previous_index, vertex);
-					}
-				}
+			size_t slot;
+			#pragma omp atomic capture
+			slot = num_found++;
+			if(slot < capacity) { //If the buffer is full, only count the intersection, so that the buffer can be made big enough.
+				found_work_data[slot] = work;
+				found_location_data[slot] = location;
+			}
+		}
+		if(num_found <= capacity) {
+			break;
+		}
+		capacity = num_found; //Run again with room for all of them.
+	}
+
+	//Sort the intersections by work item, so that they are in the same order as the pairs of edges of each polygon.
+	std::vector<std::pair<size_t, Point2>> found;
+	found.reserve(num_found);
+	for(size_t slot = 0; slot < num_found; ++slot) {
+		found.emplace_back(found_work[slot], found_locations[slot]);
+	}
+	std::sort(found.begin(), found.end(), [](const std::pair<size_t, Point2>& a, const std::pair<size_t, Point2>& b) {
+		return a.first < b.first;
+	});
+
+	//Collect the results on the host, in order.
+	Batch<Batch<PolygonSelfIntersection>> result;
+	result.reserve(batch_size);
+	size_t next_found = 0;
+	for(size_t polygon_index = 0; polygon_index < batch_size; ++polygon_index) {
+		const size_t size = sizes[polygon_index];
+		Batch<PolygonSelfIntersection> polygon_result;
+		if(size == 2) [[unlikely]] {
+			//With 2 vertices, the two line segments loop back on each other, completely overlapping. That is only one intersection.
+			polygon_result.emplace_back(batch[polygon_index][0], 0, 1);
+		}
+		const size_t num_pairs = num_pairings(size, disallow_adjacent);
+		for(; next_found < found.size() && found[next_found].first < work_starts[polygon_index + 1]; ++next_found) {
+			const auto& [work, location] = found[next_found];
+			const size_t local_work = work - work_starts[polygon_index];
+			if(local_work < num_pairs) {
+				auto[segment_a, segment_b] = enumerate_pairs(size, local_work, disallow_adjacent);
+				polygon_result.emplace_back(location, segment_a, segment_b);
+			} else {
+				const size_t vertex = local_work - num_pairs;
+				polygon_result.emplace_back(location, (vertex + size - 1) % size, vertex);
 			}
 		}
+		self_intersections_sort(polygon_result);
+		result.push_back(polygon_result);
 	}
 	return result;
 }
+#endif //GPU
 
 }
 
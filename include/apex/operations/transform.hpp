@@ -0,0 +1,501 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_TRANSFORM
+#define APEX_TRANSFORM
+
+#include "../affine_transform.hpp" //The transformations to perform.
+#include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
+#include "../detail/polygon_properties.hpp" //To forget the cached properties of the transformed polygons.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
+
+namespace apex {
+
+namespace detail {
+
+//Declare the detail functions so that we can reference them from the public ones.
+template<polygonal Polygon>
+void transform_st(Polygon& polygon, const AffineTransform& transformation);
+
+template<multi_polygonal PolygonBatch>
+void transform_st(PolygonBatch& batch, const AffineTransform& transformation);
+
+template<polygonal Polygon>
+void transform_mt(Polygon& polygon, const AffineTransform& transformation);
+
+template<multi_polygonal PolygonBatch>
+void transform_mt(PolygonBatch& batch, const AffineTransform& transformation);
+
+#ifdef GPU
+template<polygonal Polygon>
+void transform_gpu(Polygon& polygon, const AffineTransform& transformation);
+
+template<multi_polygonal PolygonBatch>
+void transform_gpu(PolygonBatch& batch, const AffineTransform& transformation);
+#endif
+
+template<soa_polygonal Polygon>
+void transform_st(Polygon& polygon, const AffineTransform& transformation);
+
+template<soa_multi_polygonal PolygonBatch>
+void transform_st(PolygonBatch& batch, const AffineTransform& transformation);
+
+template<soa_polygonal Polygon>
+void transform_mt(Polygon& polygon, const AffineTransform& transformation);
+
+template<soa_multi_polygonal PolygonBatch>
+void transform_mt(PolygonBatch& batch, const AffineTransform& transformation);
+
+#ifdef GPU
+template<soa_polygonal Polygon>
+void transform_gpu(Polygon& polygon, const AffineTransform& transformation);
+
+template<soa_multi_polygonal PolygonBatch>
+void transform_gpu(PolygonBatch& batch, const AffineTransform& transformation);
+#endif
+
+}
+
+/*!
+ * Transforms a polygon with an affine transformation.
+ *
+ * The polygon is transformed in-place. To perform multiple transformations in
+ * a row, compose them with ``AffineTransform::then`` first. Then the vertices
+ * only need to be read and written once.
+ *
+ * Transformations that mirror the polygon reverse its orientation, and others
+ * may change its area or make it degenerate. If the polygon caches its
+ * properties, they are forgotten.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<polygonal Polygon>
+void transform(Polygon& polygon, const AffineTransform& transformation) {
+	if constexpr(caches_properties<Polygon>) {
+		polygon.set_properties(PolygonProperties()); //The transformation may mirror the polygon or make it degenerate, so nothing is known about it any more.
+	}
+	const detail::Dispatch dispatch(detail::Operation::transform, polygon.size());
+	switch(dispatch.version) {
+		case 0: detail::transform_st(polygon, transformation); return;
+		case 1: detail::transform_mt(polygon, transformation); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::transform_gpu(polygon, transformation);
+			return;
+		}
+#endif //GPU
+	}
+	detail::transform_mt(polygon, transformation);
+}
+
+/*!
+ * Transforms all polygons in a batch of polygons with an affine
+ * transformation.
+ *
+ * The polygons are transformed in-place. All polygons are transformed the same
+ * way.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<multi_polygonal PolygonBatch>
+void transform(PolygonBatch& batch, const AffineTransform& transformation) {
+	if constexpr(caches_batch_properties<PolygonBatch>) {
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			if(batch.get_properties(polygon).bitfield != 0) { //The transformation may mirror the polygons or make them degenerate, so nothing is known about them any more.
+				batch.set_properties(polygon, PolygonProperties());
+			}
+		}
+	}
+	const detail::Dispatch dispatch(detail::Operation::transform_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: detail::transform_st(batch, transformation); return;
+		case 1: detail::transform_mt(batch, transformation); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::transform_gpu(batch, transformation);
+			return;
+		}
+#endif //GPU
+	}
+	detail::transform_mt(batch, transformation);
+}
+
+/*!
+ * Transforms a polygon that stores its vertices as a structure of arrays with
+ * an affine transformation.
+ *
+ * The polygon is transformed in-place.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_polygonal Polygon>
+void transform(Polygon& polygon, const AffineTransform& transformation) {
+	const detail::Dispatch dispatch(detail::Operation::transform_soa, polygon.size());
+	switch(dispatch.version) {
+		case 0: detail::transform_st(polygon, transformation); return;
+		case 1: detail::transform_mt(polygon, transformation); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::transform_gpu(polygon, transformation);
+			return;
+		}
+#endif //GPU
+	}
+	detail::transform_mt(polygon, transformation);
+}
+
+/*!
+ * Transforms all polygons in a batch that stores its vertices as a structure
+ * of arrays with an affine transformation.
+ *
+ * The polygons are transformed in-place. All polygons are transformed the same
+ * way.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void transform(PolygonBatch& batch, const AffineTransform& transformation) {
+	const detail::Dispatch dispatch(detail::Operation::transform_soa_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: detail::transform_st(batch, transformation); return;
+		case 1: detail::transform_mt(batch, transformation); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::transform_gpu(batch, transformation);
+			return;
+		}
+#endif //GPU
+	}
+	detail::transform_mt(batch, transformation);
+}
+
+namespace detail {
+
+/*!
+ * Transforms a range of vertices with SIMD instructions.
+ *
+ * This is the kernel of the single-threaded versions of \ref transform. The
+ * vertices of a polygon and of a whole batch are transformed the same way.
+ * \param vertices The vertices to transform.
+ * \param size The number of vertices to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+inline void transform_vertices(Point2* vertices, const size_t size, const AffineTransform& transformation) {
+	#pragma omp simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] = transformation.apply(vertices[vertex]);
+	}
+}
+
+/*!
+ * Single-threaded implementation of \ref transform.
+ *
+ * This implementation simply transforms each vertex in turn.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<polygonal Polygon>
+void transform_st(Polygon& polygon, const AffineTransform& transformation) {
+	Point2* vertices = polygon.data();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertices are modified directly, so synchronise them once beforehand.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	transform_vertices(vertices, polygon.size(), transformation);
+}
+
+/*!
+ * Single-threaded implementation of \ref transform for batches of polygons.
+ *
+ * This implementation ignores the boundaries of polygons and simply transforms
+ * all vertices in the batch in one loop, even those in unused regions of the
+ * vertex buffer.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<multi_polygonal PolygonBatch>
+void transform_st(PolygonBatch& batch, const AffineTransform& transformation) {
+	Point2* vertices = batch.data_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertex buffer is modified directly, so synchronise it the same way as accessing the polygons does.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	transform_vertices(vertices, batch.size_subelements(), transformation);
+}
+
+/*!
+ * Multi-threaded implementation of \ref transform.
+ *
+ * This implementation simply transforms all vertices in parallel.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<polygonal Polygon>
+void transform_mt(Polygon& polygon, const AffineTransform& transformation) {
+	Point2* vertices = polygon.data();
+	const size_t size = polygon.size();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertices are modified directly, so synchronise them once beforehand.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] = transformation.apply(vertices[vertex]);
+	}
+}
+
+/*!
+ * Multi-threaded implementation of \ref transform for batches of polygons.
+ *
+ * Like the single-threaded implementation, this ignores the boundaries of
+ * polygons and transforms all vertices in the vertex buffer. The vertex buffer
+ * is divided evenly over the threads.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<multi_polygonal PolygonBatch>
+void transform_mt(PolygonBatch& batch, const AffineTransform& transformation) {
+	Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertex buffer is modified directly, so synchronise it the same way as accessing the polygons does.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
+		vertices[vertex] = transformation.apply(vertices[vertex]);
+	}
+}
+
+#ifdef GPU
+/*!
+ * GPU-accelerated implementation of \ref transform.
+ *
+ * This implementation simply transforms all vertices in parallel. If the
+ * polygon is tracked by the ``GPUDataTracker``, the vertices stay on the GPU
+ * afterwards, so that further operations on the GPU don't need to transfer
+ * them again.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<polygonal Polygon>
+void transform_gpu(Polygon& polygon, const AffineTransform& transformation) {
+	Point2* vertices = polygon.data();
+	const size_t size = polygon.size();
+	const AffineTransform transformation_copy = transformation; //Copy the transformation to the GPU, rather than the reference to it.
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Then the mapping below finds the vertices already present, and doesn't transfer them back.
+	}
+	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:size]) map(to:transformation_copy)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] = transformation_copy.apply(vertices[vertex]);
+	}
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Only transfer the result to the host once it is needed there.
+	}
+}
+
+/*!
+ * GPU-accelerated implementation of \ref transform for batches of polygons.
+ *
+ * This implementation ignores the boundaries of polygons and simply transforms
+ * all vertices in the batch, even those in unused regions of the vertex
+ * buffer.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<multi_polygonal PolygonBatch>
+void transform_gpu(PolygonBatch& batch, const AffineTransform& transformation) {
+	Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	const AffineTransform transformation_copy = transformation; //Copy the transformation to the GPU, rather than the reference to it.
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Then the mapping below finds the vertices already present, and doesn't transfer them back.
+	}
+	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:vertices_size]) map(to:transformation_copy)
+	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
+		vertices[vertex] = transformation_copy.apply(vertices[vertex]);
+	}
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Only transfer the result to the host once it is needed there.
+	}
+}
+#endif
+
+/*!
+ * Transforms a range of coordinates stored as a structure of arrays, with SIMD
+ * instructions.
+ * \param x The X coordinates of the vertices to transform.
+ * \param y The Y coordinates of the vertices to transform.
+ * \param size The number of vertices to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+inline void transform_soa_coordinates(coord_t* x, coord_t* y, const size_t size, const AffineTransform& transformation) {
+	#pragma omp simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 transformed = transformation.apply(Point2(x[vertex], y[vertex]));
+		x[vertex] = transformed.x;
+		y[vertex] = transformed.y;
+	}
+}
+
+/*!
+ * Single-threaded implementation of \ref transform for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * Both coordinates of a vertex are needed to compute either coordinate of the
+ * result, so this processes the X and Y arrays side by side. Both are accessed
+ * consecutively, so the loop is vectorised.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_polygonal Polygon>
+void transform_st(Polygon& polygon, const AffineTransform& transformation) {
+	transform_soa_coordinates(polygon.data_x(), polygon.data_y(), polygon.size(), transformation);
+}
+
+/*!
+ * Single-threaded implementation of \ref transform for batches of polygons
+ * that store their vertices as a structure of arrays.
+ *
+ * Since all polygons are transformed the same way and the coordinates of all
+ * polygons are stored consecutively, the boundaries between polygons can be
+ * ignored. All coordinates of the batch are transformed in one go.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void transform_st(PolygonBatch& batch, const AffineTransform& transformation) {
+	transform_soa_coordinates(batch.data_x(), batch.data_y(), batch.size_subelements(), transformation);
+}
+
+/*!
+ * Multi-threaded implementation of \ref transform for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This implementation transforms all vertices in parallel.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_polygonal Polygon>
+void transform_mt(Polygon& polygon, const AffineTransform& transformation) {
+	coord_t* x = polygon.data_x();
+	coord_t* y = polygon.data_y();
+	const size_t size = polygon.size();
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 transformed = transformation.apply(Point2(x[vertex], y[vertex]));
+		x[vertex] = transformed.x;
+		y[vertex] = transformed.y;
+	}
+}
+
+/*!
+ * Multi-threaded implementation of \ref transform for batches of polygons that
+ * store their vertices as a structure of arrays.
+ *
+ * This implementation ignores the boundaries between polygons and transforms
+ * all vertices of the batch in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void transform_mt(PolygonBatch& batch, const AffineTransform& transformation) {
+	coord_t* x = batch.data_x();
+	coord_t* y = batch.data_y();
+	const size_t size = batch.size_subelements();
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 transformed = transformation.apply(Point2(x[vertex], y[vertex]));
+		x[vertex] = transformed.x;
+		y[vertex] = transformed.y;
+	}
+}
+
+#ifdef GPU
+/*!
+ * GPU-accelerated implementation of \ref transform for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This implementation simply transforms all vertices in parallel.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_polygonal Polygon>
+void transform_gpu(Polygon& polygon, const AffineTransform& transformation) {
+	coord_t* x = polygon.data_x();
+	coord_t* y = polygon.data_y();
+	const size_t size = polygon.size();
+	const AffineTransform transformation_copy = transformation; //Copy the transformation to the GPU, rather than the reference to it.
+	#pragma omp target teams distribute parallel for simd map(tofrom:x[0:size], y[0:size]) map(to:transformation_copy)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 transformed = transformation_copy.apply(Point2(x[vertex], y[vertex]));
+		x[vertex] = transformed.x;
+		y[vertex] = transformed.y;
+	}
+}
+
+/*!
+ * GPU-accelerated implementation of \ref transform for batches of polygons
+ * that store their vertices as a structure of arrays.
+ *
+ * This implementation ignores the boundaries between polygons and transforms
+ * all vertices of the batch in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to transform.
+ * \param transformation The transformation to perform on each vertex.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void transform_gpu(PolygonBatch& batch, const AffineTransform& transformation) {
+	coord_t* x = batch.data_x();
+	coord_t* y = batch.data_y();
+	const size_t size = batch.size_subelements();
+	const AffineTransform transformation_copy = transformation; //Copy the transformation to the GPU, rather than the reference to it.
+	#pragma omp target teams distribute parallel for simd map(tofrom:x[0:size], y[0:size]) map(to:transformation_copy)
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		const Point2 transformed = transformation_copy.apply(Point2(x[vertex], y[vertex]));
+		x[vertex] = transformed.x;
+		y[vertex] = transformed.y;
+	}
+}
+#endif
+
+}
+
+}
+
+#endif //APEX_TRANSFORM
\ No newline at end of file
@@ -9,7 +9,13 @@
 #ifndef APEX_TRANSLATE
 #define APEX_TRANSLATE
 
+#include "../detail/fixed_size.hpp" //To unroll the loops over the vertices of fixed-size polygons.
 #include "../detail/geometry_concepts.hpp" //To disambiguate overloads.
+#include "../detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
+#include "../detail/polygon_properties.hpp" //To move the cached bounding boxes along.
+#include "../detail/strategies.hpp" //To choose the fastest version of the operation.
+#include "../gpu_future.hpp" //To return handles to asynchronous operations.
+#include "../instrumentation.hpp" //To report on the chosen version of the operation.
 
 namespace apex {
 
@@ -25,9 +31,55 @@ void translate_st(PolygonBatch& batch, const Point2& delta);
 template<polygonal Polygon>
 void translate_mt(Polygon& polygon, const Point2& delta);
 
+template<multi_polygonal PolygonBatch>
+void translate_mt(PolygonBatch& batch, const Point2& delta);
+
 #ifdef GPU
 template<polygonal Polygon>
 void translate_gpu(Polygon& polygon, const Point2& delta);
+
+template<multi_polygonal PolygonBatch>
+void translate_gpu(PolygonBatch& batch, const Point2& delta);
+
+template<polygonal Polygon>
+GPUFuture<void> translate_gpu_async(Polygon& polygon, const Point2& delta);
+
+template<multi_polygonal PolygonBatch>
+GPUFuture<void> translate_gpu_async(PolygonBatch& batch, const Point2& delta);
+#endif
+
+template<soa_polygonal Polygon>
+void translate_st(Polygon& polygon, const Point2& delta);
+
+template<soa_multi_polygonal PolygonBatch>
+void translate_st(PolygonBatch& batch, const Point2& delta);
+
+template<soa_polygonal Polygon>
+void translate_mt(Polygon& polygon, const Point2& delta);
+
+template<soa_multi_polygonal PolygonBatch>
+void translate_mt(PolygonBatch& batch, const Point2& delta);
+
+#ifdef GPU
+template<soa_polygonal Polygon>
+void translate_gpu(Polygon& polygon, const Point2& delta);
+
+template<soa_multi_polygonal PolygonBatch>
+void translate_gpu(PolygonBatch& batch, const Point2& delta);
+#endif
+
+template<fixed_polygonal Polygon>
+void translate_st(Polygon& polygon, const Point2& delta);
+
+template<fixed_multi_polygonal PolygonBatch>
+void translate_st(PolygonBatch& batch, const Point2& delta);
+
+template<fixed_multi_polygonal PolygonBatch>
+void translate_mt(PolygonBatch& batch, const Point2& delta);
+
+#ifdef GPU
+template<fixed_multi_polygonal PolygonBatch>
+void translate_gpu(PolygonBatch& batch, const Point2& delta);
 #endif
 
 }
@@ -43,7 +95,24 @@ void translate_gpu(Polygon& polygon, const Point2& delta);
  */
 template<polygonal Polygon>
 void translate(Polygon& polygon, const Point2& delta) {
-	detail::translate_st(polygon, delta);
+	if constexpr(caches_properties<Polygon>) { //Moving doesn't change the shape, so only the bounding box of the cached properties needs to move along.
+		PolygonProperties properties = polygon.get_properties();
+		properties.translate(delta);
+		polygon.set_properties(properties);
+	}
+	const detail::Dispatch dispatch(detail::Operation::translate, polygon.size());
+	switch(dispatch.version) {
+		case 0: detail::translate_st(polygon, delta); return;
+		case 1: detail::translate_mt(polygon, delta); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::translate_gpu(polygon, delta);
+			return;
+		}
+#endif //GPU
+	}
+	detail::translate_mt(polygon, delta);
 }
 
 /*!
@@ -57,9 +126,179 @@ void translate(Polygon& polygon, const Point2& delta) {
  */
 template<multi_polygonal PolygonBatch>
 void translate(PolygonBatch& batch, const Point2& delta) {
-	detail::translate_st(batch, delta);
+	if constexpr(caches_batch_properties<PolygonBatch>) { //Moving doesn't change the shapes, so only the bounding boxes of the cached properties need to move along.
+		batch.translate_properties(delta);
+	}
+	const detail::Dispatch dispatch(detail::Operation::translate_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: detail::translate_st(batch, delta); return;
+		case 1: detail::translate_mt(batch, delta); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::translate_gpu(batch, delta);
+			return;
+		}
+#endif //GPU
+	}
+	detail::translate_mt(batch, delta);
+}
+
+/*!
+ * Moves a polygon that stores its vertices as a structure of arrays with a
+ * certain offset.
+ *
+ * The polygon is moved in-place.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_polygonal Polygon>
+void translate(Polygon& polygon, const Point2& delta) {
+	const detail::Dispatch dispatch(detail::Operation::translate_soa, polygon.size());
+	switch(dispatch.version) {
+		case 0: detail::translate_st(polygon, delta); return;
+		case 1: detail::translate_mt(polygon, delta); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::translate_gpu(polygon, delta);
+			return;
+		}
+#endif //GPU
+	}
+	detail::translate_mt(polygon, delta);
+}
+
+/*!
+ * Moves all polygons in a batch that stores its vertices as a structure of
+ * arrays with a certain offset.
+ *
+ * The polygons are moved in-place. All polygons are moved with the same offset.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void translate(PolygonBatch& batch, const Point2& delta) {
+	const detail::Dispatch dispatch(detail::Operation::translate_soa_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: detail::translate_st(batch, delta); return;
+		case 1: detail::translate_mt(batch, delta); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::translate_gpu(batch, delta);
+			return;
+		}
+#endif //GPU
+	}
+	detail::translate_mt(batch, delta);
 }
 
+/*!
+ * Moves a polygon with a fixed number of vertices with a certain offset.
+ *
+ * The polygon is moved in-place. Since the number of vertices is known at
+ * compile time and small, this always uses the single-threaded implementation,
+ * which is completely unrolled.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_polygonal Polygon>
+void translate(Polygon& polygon, const Point2& delta) {
+	detail::translate_st(polygon, delta);
+}
+
+/*!
+ * Moves all polygons in a batch of polygons with a fixed number of vertices
+ * with a certain offset.
+ *
+ * The polygons are moved in-place. All polygons are moved with the same offset.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+void translate(PolygonBatch& batch, const Point2& delta) {
+	const detail::Dispatch dispatch(detail::Operation::translate_fixed_batch, batch.size_subelements());
+	switch(dispatch.version) {
+		case 0: detail::translate_st(batch, delta); return;
+		case 1: detail::translate_mt(batch, delta); return;
+#ifdef GPU
+		default: {
+			const detail::Strategies::GPUReservation reservation;
+			detail::translate_gpu(batch, delta);
+			return;
+		}
+#endif //GPU
+	}
+	detail::translate_mt(batch, delta);
+}
+
+#ifdef GPU
+/*!
+ * Moves a polygon with a certain offset on the GPU, without waiting for it to
+ * complete.
+ *
+ * The translation is queued on the GPU, and this returns immediately.
+ * Operations on the GPU that are queued later on the same polygon are executed
+ * after this one, so they can be chained without waiting in between.
+ *
+ * If the polygon is tracked by the ``GPUDataTracker``, accessing it on the host
+ * waits for the translation to complete. Otherwise, the returned handle must be
+ * waited on before the polygon is accessed or destroyed.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ * \return A handle to wait for the translation to complete.
+ */
+template<polygonal Polygon>
+GPUFuture<void> translate_async(Polygon& polygon, const Point2& delta) {
+	if constexpr(caches_properties<Polygon>) { //Moving doesn't change the shape, so only the bounding box of the cached properties needs to move along.
+		PolygonProperties properties = polygon.get_properties();
+		properties.translate(delta);
+		polygon.set_properties(properties);
+	}
+	return detail::translate_gpu_async(polygon, delta);
+}
+
+/*!
+ * Moves all polygons in a batch of polygons with a certain offset on the GPU,
+ * without waiting for it to complete.
+ *
+ * The translation is queued on the GPU, and this returns immediately.
+ * Operations on the GPU that are queued later on the same batch are executed
+ * after this one, so they can be chained without waiting in between.
+ *
+ * If the batch is tracked by the ``GPUDataTracker``, accessing it on the host
+ * waits for the translation to complete. Otherwise, the returned handle must be
+ * waited on before the batch is accessed or destroyed.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ * \return A handle to wait for the translation to complete.
+ */
+template<multi_polygonal PolygonBatch>
+GPUFuture<void> translate_async(PolygonBatch& batch, const Point2& delta) {
+	if constexpr(caches_batch_properties<PolygonBatch>) { //Moving doesn't change the shapes, so only the bounding boxes of the cached properties need to move along.
+		batch.translate_properties(delta);
+	}
+	return detail::translate_gpu_async(batch, delta);
+}
+#endif
+
 namespace detail {
 
 /*!
@@ -73,15 +312,24 @@ namespace detail {
  */
 template<polygonal Polygon>
 void translate_st(Polygon& polygon, const Point2& delta) {
-	for(Point2& vertex : polygon) {
-		vertex += delta;
+	Point2* vertices = polygon.data();
+	const size_t size = polygon.size();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertices are modified directly, so that the cached properties of the polygon are kept.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
 	}
 }
 
 /*!
  * Single-threaded implementation of \ref translate for batches of polygons.
  *
- * This implementation simply translates each polygon in turn.
+ * This implementation ignores the boundaries of polygons and simply shifts all
+ * vertices in the batch by the given delta in one loop, even those in unused
+ * regions of the vertex buffer. The loop accesses consecutive vertices, so it is
+ * vectorised.
  * \tparam PolygonBatch A class that behaves like a batch of polygons.
  * \param batch The batch of polygons to translate.
  * \param delta The distance by which to move, representing both dimensions to
@@ -89,8 +337,15 @@ void translate_st(Polygon& polygon, const Point2& delta) {
  */
 template<multi_polygonal PolygonBatch>
 void translate_st(PolygonBatch& batch, const Point2& delta) {
-	for(typename PolygonBatch::iterator polygon = batch.begin(); polygon != batch.end(); ++polygon) {
-		translate_st(*polygon, delta);
+	Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertex buffer is modified directly, so synchronise it the same way as accessing the polygons does.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	#pragma omp simd
+	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
+		vertices[vertex] += delta;
 	}
 }
 
@@ -105,18 +360,25 @@ void translate_st(PolygonBatch& batch, const Point2& delta) {
  */
 template<polygonal Polygon>
 void translate_mt(Polygon& polygon, const Point2& delta) {
+	Point2* vertices = polygon.data();
+	const size_t size = polygon.size();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_host(vertices); //Synchronise once, rather than for each vertex accessed.
+		GPUDataTracker::changed_on_host(vertices);
+	}
 	#pragma omp parallel for simd
-	for(size_t vertex = 0; vertex < polygon.size(); ++vertex) {
-		polygon[vertex] += delta;
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
 	}
 }
 
 /*!
  * Multi-threaded implementation of \ref translate for batches of polygons.
  *
- * This implementation will translate all polygons in parallel. The vertices of
- * each polygon may be translated in parallel as well, if there are enough of
- * them. Small polygons will simply be processed thread-locally.
+ * Like the single-threaded implementation, this ignores the boundaries of
+ * polygons and shifts all vertices in the vertex buffer. The vertex buffer is
+ * divided evenly over the threads, so that a few large polygons in the batch
+ * don't leave the other threads waiting.
  * \tparam PolygonBatch A class that behaves like a batch of polygons.
  * \param batch The batch of polygons to translate.
  * \param delta The distance by which to move, representing both dimensions to
@@ -124,17 +386,15 @@ void translate_mt(Polygon& polygon, const Point2& delta) {
  */
 template<multi_polygonal PolygonBatch>
 void translate_mt(PolygonBatch& batch, const Point2& delta) {
-	const int parallel_threshold = omp_get_num_procs() * 2; //A polygon is considered "big" if it's larger than twice the number of available polygons. We'll parallelise that then.
-	#pragma omp parallel for
-	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
-		if(batch[polygon].size() < parallel_threshold) {
-			translate_st(batch[polygon], delta);
-		} else {
-			#pragma omp parallel for simd
-			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
-				batch[polygon][vertex] += delta;
-			}
-		}
+	Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_host(vertices); //The vertex buffer is modified directly, so synchronise it the same way as accessing the polygons does.
+		GPUDataTracker::changed_on_host(vertices);
+	}
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
+		vertices[vertex] += delta;
 	}
 }
 
@@ -157,10 +417,16 @@ template<polygonal Polygon>
 void translate_gpu(Polygon& polygon, const Point2& delta) {
 	Point2* vertices = polygon.data();
 	const size_t size = polygon.size();
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon); //Then the mapping below finds the vertices already present, and doesn't transfer them back.
+	}
 	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:size])
 	for(size_t vertex = 0; vertex < size; ++vertex) {
 		vertices[vertex] += delta;
 	}
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Only transfer the result to the host once it is needed there.
+	}
 }
 
 /*!
@@ -178,10 +444,324 @@ template<multi_polygonal PolygonBatch>
 void translate_gpu(PolygonBatch& batch, const Point2& delta) {
 	Point2* vertices = batch.data_subelements();
 	const size_t vertices_size = batch.size_subelements();
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch); //Then the mapping below finds the vertices already present, and doesn't transfer them back.
+	}
 	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:vertices_size])
 	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
 		vertices[vertex] += delta;
 	}
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Only transfer the result to the host once it is needed there.
+	}
+}
+
+/*!
+ * Asynchronous GPU-accelerated implementation of \ref translate.
+ *
+ * This modifies all vertices in parallel, like ``translate_gpu``, but the target
+ * region is queued as a deferred task instead of waiting for it to complete.
+ * The task depends on the vertices, so it runs after earlier operations on the
+ * same polygon, and later operations run after it.
+ * \tparam Polygon A class that behaves like a polygon.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ * \return A handle to wait for the translation to complete.
+ */
+template<polygonal Polygon>
+GPUFuture<void> translate_gpu_async(Polygon& polygon, const Point2& delta) {
+	Point2* vertices = polygon.data();
+	const size_t size = polygon.size();
+	if(size == 0) {
+		return GPUFuture<void>();
+	}
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::sync_to_gpu(vertices, size, &polygon, true); //Queue the transfer, so that it happens in the background as well.
+	}
+	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:size]) nowait depend(inout:vertices[0])
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
+	}
+	if constexpr(gpu_tracked<Polygon>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Accessing the vertices on the host then waits for the task and transfers the result.
+	}
+	return GPUFuture<void>(vertices);
+}
+
+/*!
+ * Asynchronous GPU-accelerated implementation of \ref translate for batches of
+ * polygons.
+ *
+ * This shifts all vertices in the vertex buffer, like ``translate_gpu``, but
+ * the target region is queued as a deferred task instead of waiting for it to
+ * complete. The task depends on the vertices, so it runs after earlier
+ * operations on the same batch, and later operations run after it.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ * \return A handle to wait for the translation to complete.
+ */
+template<multi_polygonal PolygonBatch>
+GPUFuture<void> translate_gpu_async(PolygonBatch& batch, const Point2& delta) {
+	Point2* vertices = batch.data_subelements();
+	const size_t vertices_size = batch.size_subelements();
+	if(vertices_size == 0) {
+		return GPUFuture<void>();
+	}
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::sync_to_gpu(vertices, vertices_size, &batch, true); //Queue the transfer, so that it overlaps with other work on the GPU.
+	}
+	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:vertices_size]) nowait depend(inout:vertices[0])
+	for(size_t vertex = 0; vertex < vertices_size; ++vertex) {
+		vertices[vertex] += delta;
+	}
+	if constexpr(gpu_tracked<PolygonBatch>) {
+		GPUDataTracker::changed_on_gpu(vertices); //Accessing the vertices on the host then waits for the task and transfers the result.
+	}
+	return GPUFuture<void>(vertices);
+}
+#endif
+
+/*!
+ * Moves a range of coordinates by a certain offset in one dimension, with SIMD
+ * instructions.
+ * \param coordinates The coordinates to move.
+ * \param size The number of coordinates to move.
+ * \param delta The distance by which to move.
+ */
+inline void translate_soa_coordinates(coord_t* coordinates, const size_t size, const coord_t delta) {
+	#pragma omp simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		coordinates[vertex] += delta;
+	}
+}
+
+/*!
+ * Single-threaded implementation of \ref translate for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This implementation adds the delta to all X coordinates, and then to all Y
+ * coordinates. Both loops access consecutive coordinates, so they are
+ * vectorised.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_polygonal Polygon>
+void translate_st(Polygon& polygon, const Point2& delta) {
+	translate_soa_coordinates(polygon.data_x(), polygon.size(), delta.x);
+	translate_soa_coordinates(polygon.data_y(), polygon.size(), delta.y);
+}
+
+/*!
+ * Single-threaded implementation of \ref translate for batches of polygons that
+ * store their vertices as a structure of arrays.
+ *
+ * Since all polygons are moved by the same offset and the coordinates of all
+ * polygons are stored consecutively, the boundaries between polygons can be
+ * ignored. All coordinates of the batch are moved in one go.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void translate_st(PolygonBatch& batch, const Point2& delta) {
+	translate_soa_coordinates(batch.data_x(), batch.size_subelements(), delta.x);
+	translate_soa_coordinates(batch.data_y(), batch.size_subelements(), delta.y);
+}
+
+/*!
+ * Multi-threaded implementation of \ref translate for polygons that store their
+ * vertices as a structure of arrays.
+ *
+ * This implementation modifies all coordinates in parallel.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_polygonal Polygon>
+void translate_mt(Polygon& polygon, const Point2& delta) {
+	coord_t* x = polygon.data_x();
+	coord_t* y = polygon.data_y();
+	const size_t size = polygon.size();
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		x[vertex] += delta.x;
+		y[vertex] += delta.y;
+	}
+}
+
+/*!
+ * Multi-threaded implementation of \ref translate for batches of polygons that
+ * store their vertices as a structure of arrays.
+ *
+ * This implementation ignores the boundaries between polygons and modifies all
+ * coordinates of the batch in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void translate_mt(PolygonBatch& batch, const Point2& delta) {
+	coord_t* x = batch.data_x();
+	coord_t* y = batch.data_y();
+	const size_t size = batch.size_subelements();
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		x[vertex] += delta.x;
+		y[vertex] += delta.y;
+	}
+}
+
+#ifdef GPU
+/*!
+ * GPU-accelerated implementation of \ref translate for polygons that store
+ * their vertices as a structure of arrays.
+ *
+ * This implementation simply modifies all coordinates in parallel.
+ * \tparam Polygon A class that behaves like a polygon, storing its coordinates
+ * in separate arrays.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_polygonal Polygon>
+void translate_gpu(Polygon& polygon, const Point2& delta) {
+	coord_t* x = polygon.data_x();
+	coord_t* y = polygon.data_y();
+	const size_t size = polygon.size();
+	const coord_t delta_x = delta.x;
+	const coord_t delta_y = delta.y;
+	#pragma omp target teams distribute parallel for simd map(tofrom:x[0:size], y[0:size])
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		x[vertex] += delta_x;
+		y[vertex] += delta_y;
+	}
+}
+
+/*!
+ * GPU-accelerated implementation of \ref translate for batches of polygons that
+ * store their vertices as a structure of arrays.
+ *
+ * This implementation ignores the boundaries between polygons and modifies all
+ * coordinates of the batch in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, storing
+ * its coordinates in separate arrays.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<soa_multi_polygonal PolygonBatch>
+void translate_gpu(PolygonBatch& batch, const Point2& delta) {
+	coord_t* x = batch.data_x();
+	coord_t* y = batch.data_y();
+	const size_t size = batch.size_subelements();
+	const coord_t delta_x = delta.x;
+	const coord_t delta_y = delta.y;
+	#pragma omp target teams distribute parallel for simd map(tofrom:x[0:size], y[0:size])
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		x[vertex] += delta_x;
+		y[vertex] += delta_y;
+	}
+}
+#endif
+
+
+/*!
+ * Single-threaded implementation of \ref translate for polygons with a fixed
+ * number of vertices.
+ *
+ * The loop over the vertices is unrolled at compile time.
+ * \tparam Polygon A class that behaves like a polygon, with a number of
+ * vertices that is fixed at compile time.
+ * \param polygon The polygon to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_polygonal Polygon>
+void translate_st(Polygon& polygon, const Point2& delta) {
+	Point2* vertices = polygon.data();
+	unroll<Polygon::fixed_size>([&]<size_t vertex>() {
+		vertices[vertex] += delta;
+	});
+}
+
+/*!
+ * Single-threaded implementation of \ref translate for batches of polygons
+ * with a fixed number of vertices.
+ *
+ * Since the polygons are stored without any gaps in between, this ignores the
+ * boundaries between polygons and moves all vertices of the batch in one
+ * vectorised loop.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+void translate_st(PolygonBatch& batch, const Point2& delta) {
+	Point2* vertices = batch.data();
+	const size_t size = batch.size_subelements();
+	#pragma omp simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
+	}
+}
+
+/*!
+ * Multi-threaded implementation of \ref translate for batches of polygons with
+ * a fixed number of vertices.
+ *
+ * The vertices of all polygons are divided over the threads, regardless of
+ * which polygon they belong to.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+void translate_mt(PolygonBatch& batch, const Point2& delta) {
+	Point2* vertices = batch.data();
+	const size_t size = batch.size_subelements();
+	#pragma omp parallel for simd
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
+	}
+}
+
+#ifdef GPU
+/*!
+ * GPU-accelerated implementation of \ref translate for batches of polygons
+ * with a fixed number of vertices.
+ *
+ * This implementation ignores the boundaries between polygons and modifies all
+ * vertices of the batch in parallel.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons, which
+ * all have the same number of vertices, fixed at compile time.
+ * \param batch The batch of polygons to translate.
+ * \param delta The distance by which to move, representing both dimensions to
+ * move through as a single 2D vector.
+ */
+template<fixed_multi_polygonal PolygonBatch>
+void translate_gpu(PolygonBatch& batch, const Point2& delta) {
+	Point2* vertices = batch.data();
+	const size_t size = batch.size_subelements();
+	#pragma omp target teams distribute parallel for simd map(tofrom:vertices[0:size])
+	for(size_t vertex = 0; vertex < size; ++vertex) {
+		vertices[vertex] += delta;
+	}
 }
 #endif
 
@@ -124,6 +124,53 @@ public:
 	 */
 	constexpr std::strong_ordering operator <=>(const Point2& other) const = default;
 
+	/*!
+	 * Whether this point comes before another point in the lexicographic order.
+	 *
+	 * This gives the same result as the three-way comparison, but without
+	 * using ``std::strong_ordering``, which can't be used in code that runs on
+	 * the GPU. Since it is a better match than the three-way comparison, it
+	 * also gets used by algorithms like ``std::min``.
+	 * \param other The point to compare with.
+	 * \return ``true`` if this point comes before the other point, or
+	 * ``false`` if it is equal or comes after it.
+	 */
+	constexpr bool operator <(const Point2& other) const {
+		return x < other.x || (x == other.x && y < other.y);
+	}
+
+	/*!
+	 * Whether this point comes after another point in the lexicographic order.
+	 * \param other The point to compare with.
+	 * \return ``true`` if this point comes after the other point, or ``false``
+	 * if it is equal or comes before it.
+	 */
+	constexpr bool operator >(const Point2& other) const {
+		return other < *this;
+	}
+
+	/*!
+	 * Whether this point comes before or is equal to another point in the
+	 * lexicographic order.
+	 * \param other The point to compare with.
+	 * \return ``true`` if this point is equal or comes before the other point,
+	 * or ``false`` if it comes after it.
+	 */
+	constexpr bool operator <=(const Point2& other) const {
+		return !(other < *this);
+	}
+
+	/*!
+	 * Whether this point comes after or is equal to another point in the
+	 * lexicographic order.
+	 * \param other The point to compare with.
+	 * \return ``true`` if this point is equal or comes after the other point,
+	 * or ``false`` if it comes before it.
+	 */
+	constexpr bool operator >=(const Point2& other) const {
+		return !(*this < other);
+	}
+
 	/*!
 	 * Overloads streaming this point.
 	 *
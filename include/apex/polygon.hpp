@@ -9,11 +9,18 @@
 #ifndef APEX_POLYGON
 #define APEX_POLYGON
 
-#include <utility> //For std::forward.
+#include <memory_resource> //To allow allocating polygons from a custom memory resource.
+#include <mutex> //To allow caching properties from multiple threads.
+#include <span> //To take the sizes of polygons from any contiguous container.
+#include <utility> //For std::forward and std::move.
 
 #include "batch.hpp" //The vertex storage is by batch.
+#include "detail/gpu_data_tracker.hpp" //To keep the vertices on the GPU in between operations.
 #include "detail/polygon_properties.hpp" //Properties about polygons to cache.
 #include "operations/area.hpp" //To allow calculating the area of this shape.
+#include "operations/bounding_box.hpp" //To allow calculating the bounding box of this shape.
+#include "operations/contains.hpp" //To allow testing whether points are inside of this shape.
+#include "operations/transform.hpp" //To allow transforming this shape.
 #include "operations/translate.hpp" //To allow moving this shape.
 #include "point2.hpp" //The vertices of the polygon are 2D points.
 
@@ -40,9 +47,29 @@ namespace apex {
  *
  * If the vertices of the polygon are winding counter-clockwise, the polygon is
  * positive. Otherwise it is negative.
+ *
+ * When compiled with GPU support, the vertices of the polygon are registered
+ * with the \ref GPUDataTracker. Operations on the GPU then leave the vertices
+ * on the GPU, and accessing the vertices on the host transfers them back only
+ * if they were changed on the GPU. Note that \ref data gives direct access to
+ * the vertex buffer on the host, without synchronising it.
+ *
+ * The polygon caches some properties that are expensive to compute, like its
+ * area and bounding box, once they are computed. Modifying the vertices
+ * through any of the methods of the polygon makes it forget those properties.
+ * Modifying the vertices through \ref data doesn't, so the cache needs to be
+ * reset with \ref set_properties afterwards. Multiple threads may read and fill
+ * in the cache of the same constant polygon at the same time.
  */
 class Polygon : public Batch<Point2> {
 public:
+#ifdef GPU
+	/*!
+	 * Polygons keep their vertices on the GPU in between operations.
+	 */
+	static constexpr bool gpu_tracked = true;
+#endif //GPU
+
 	/*!
 	 * Constructs an empty polygon, without any vertices.
 	 *
@@ -55,6 +82,20 @@ public:
 			| static_cast<unsigned int>(PolygonProperties::Orientation::POSITIVE)
 		) {}
 
+	/*!
+	 * Constructs an empty polygon that allocates its vertices from a specific
+	 * memory resource.
+	 *
+	 * The memory resource must outlive the polygon.
+	 * \param resource The memory resource to allocate the vertices from.
+	 */
+	explicit Polygon(std::pmr::memory_resource* resource) noexcept : Batch<Point2>(resource),
+		properties(
+			static_cast<unsigned int>(PolygonProperties::Convexity::DEGENERATE)
+			| static_cast<unsigned int>(PolygonProperties::SelfIntersecting::NO)
+			| static_cast<unsigned int>(PolygonProperties::Orientation::POSITIVE)
+		) {}
+
 	/*!
 	 * Constructs a polygon containing a single point repeated numerous times.
 	 *
@@ -107,8 +148,8 @@ public:
 	 * Copies a polygon.
 	 * \param original The polygon to copy.
 	 */
-	Polygon(const Polygon& original) : Batch<Point2>(original),
-		properties(original.properties) {} //The same properties as the original.
+	Polygon(const Polygon& original) : Batch<Point2>(original.synced_to_host()),
+		properties(original.get_properties()) {} //The same properties as the original.
 
 	/*!
 	 * Move constructor to move a polygon into a different polygon.
@@ -117,9 +158,18 @@ public:
 	 * can execute in constant time.
 	 * \param original The polygon to move.
 	 */
-	Polygon(Polygon&& original) : Batch<Point2>(original),
+	Polygon(Polygon&& original) noexcept : Batch<Point2>(std::move(original)),
 		properties(original.properties) {} //The same properties as the original.
 
+#ifdef GPU
+	/*!
+	 * Removes the vertices of this polygon from the GPU, if they were there.
+	 */
+	~Polygon() {
+		discard_gpu_copy();
+	}
+#endif //GPU
+
 	/*!
 	 * Assigns a different polygon to this polygon.
 	 *
@@ -128,8 +178,9 @@ public:
 	 * \return A reference to this polygon.
 	 */
 	Polygon& operator =(const Polygon& other) {
-		Batch<Point2>::operator =(other);
-		properties = other.properties; //Also copy its properties
+		discard_gpu_copy(); //The vertices are replaced anyway.
+		Batch<Point2>::operator =(other.synced_to_host());
+		properties = other.get_properties(); //Also copy its properties
 		return *this;
 	}
 
@@ -137,12 +188,15 @@ public:
 	 * Assigns a different polygon to this polygon.
 	 *
 	 * This moves the contents of the other polygon into this one. The vertex
-	 * data can have just its reference moved, saving work.
+	 * data can have just its reference moved, saving work. If the polygons use
+	 * different memory resources, the vertices need to be moved into memory
+	 * from the resource of this polygon instead, which may throw.
 	 * \param other The polygon to assign to this one.
 	 * \return A reference to this polygon.
 	 */
-	Polygon& operator =(Polygon&& other) noexcept {
-		Batch<Point2>::operator =(other);
+	Polygon& operator =(Polygon&& other) {
+		discard_gpu_copy(); //The vertices are replaced anyway.
+		Batch<Point2>::operator =(std::move(other));
 		properties = other.properties;
 		return *this;
 	}
@@ -201,6 +255,269 @@ public:
 		return !((*this) == other); //Implemented in terms of ==.
 	}
 
+	//Accessing the vertices on the host needs to synchronise them with the GPU first, and may make the cached properties outdated.
+	/*!
+	 * Get the vertex at a certain index.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at the given index.
+	 */
+	const Point2& operator [](const size_t index) const {
+		sync_to_host();
+		return Batch<Point2>::operator [](index);
+	}
+
+	/*!
+	 * Get the vertex at a certain index.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at the given index.
+	 */
+	Point2& operator [](const size_t index) {
+		changing_on_host();
+		return Batch<Point2>::operator [](index);
+	}
+
+	/*!
+	 * Get the vertex at a certain index, checking whether the index is in
+	 * range.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at the given index.
+	 */
+	const Point2& at(const size_t index) const {
+		sync_to_host();
+		return Batch<Point2>::at(index);
+	}
+
+	/*!
+	 * Get the vertex at a certain index, checking whether the index is in
+	 * range.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at the given index.
+	 */
+	Point2& at(const size_t index) {
+		changing_on_host();
+		return Batch<Point2>::at(index);
+	}
+
+	/*!
+	 * Get the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return The last vertex of the polygon.
+	 */
+	const Point2& back() const {
+		sync_to_host();
+		return Batch<Point2>::back();
+	}
+
+	/*!
+	 * Get the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return The last vertex of the polygon.
+	 */
+	Point2& back() {
+		changing_on_host();
+		return Batch<Point2>::back();
+	}
+
+	/*!
+	 * Get an iterator to the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing at the first vertex.
+	 */
+	const_iterator begin() const {
+		sync_to_host();
+		return Batch<Point2>::begin();
+	}
+
+	/*!
+	 * Get an iterator to the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return An iterator pointing at the first vertex.
+	 */
+	iterator begin() {
+		changing_on_host();
+		return Batch<Point2>::begin();
+	}
+
+	/*!
+	 * Get an iterator to the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing at the first vertex.
+	 */
+	const_iterator cbegin() const {
+		sync_to_host();
+		return Batch<Point2>::cbegin();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing beyond the last vertex.
+	 */
+	const_iterator cend() const {
+		sync_to_host();
+		return Batch<Point2>::cend();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing at the last vertex.
+	 */
+	const_reverse_iterator crbegin() const {
+		sync_to_host();
+		return Batch<Point2>::crbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing before the first vertex.
+	 */
+	const_reverse_iterator crend() const {
+		sync_to_host();
+		return Batch<Point2>::crend();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing beyond the last vertex.
+	 */
+	const_iterator end() const {
+		sync_to_host();
+		return Batch<Point2>::end();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return An iterator pointing beyond the last vertex.
+	 */
+	iterator end() {
+		changing_on_host();
+		return Batch<Point2>::end();
+	}
+
+	/*!
+	 * Get the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return The first vertex of the polygon.
+	 */
+	const Point2& front() const {
+		sync_to_host();
+		return Batch<Point2>::front();
+	}
+
+	/*!
+	 * Get the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return The first vertex of the polygon.
+	 */
+	Point2& front() {
+		changing_on_host();
+		return Batch<Point2>::front();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing at the last vertex.
+	 */
+	const_reverse_iterator rbegin() const {
+		sync_to_host();
+		return Batch<Point2>::rbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return A reverse iterator pointing at the last vertex.
+	 */
+	reverse_iterator rbegin() {
+		changing_on_host();
+		return Batch<Point2>::rbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing before the first vertex.
+	 */
+	const_reverse_iterator rend() const {
+		sync_to_host();
+		return Batch<Point2>::rend();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first vertex of the polygon.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the vertices may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return A reverse iterator pointing before the first vertex.
+	 */
+	reverse_iterator rend() {
+		changing_on_host();
+		return Batch<Point2>::rend();
+	}
+
 	/*!
 	 * Computes the surface area of the polygon.
 	 *
@@ -218,6 +535,57 @@ public:
 		return apex::area(*this);
 	}
 
+	/*!
+	 * Computes the axis-aligned bounding box of the polygon.
+	 *
+	 * The bounding box is cached, so it is only computed the first time this
+	 * is called after the polygon was modified. For an empty polygon, the
+	 * bounding box is empty, with both corners at the origin.
+	 * \return The minimum and maximum corner of the bounding box, in that
+	 * order.
+	 */
+	std::pair<Point2, Point2> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Tests whether a point is inside of the polygon.
+	 *
+	 * This uses the nonzero fill rule. Points on the border of the polygon are
+	 * considered to be inside.
+	 * \param point The point to test.
+	 * \return ``true`` if the point is inside of the polygon or on its border,
+	 * or ``false`` if it is outside.
+	 */
+	bool contains(const Point2& point) const {
+		return apex::contains(*this, point);
+	}
+
+	/*!
+	 * Get the properties that are currently known about this polygon.
+	 *
+	 * Operations use this to skip computations of which the result is already
+	 * known.
+	 * \return The cached properties of this polygon.
+	 */
+	PolygonProperties get_properties() const {
+		const std::lock_guard<std::mutex> lock(properties_mutex);
+		return properties;
+	}
+
+	/*!
+	 * Store properties that were computed about this polygon.
+	 *
+	 * Since the properties are only a cache, this may also be called on a
+	 * constant polygon, also by multiple threads at the same time.
+	 * \param new_properties The properties that are now known about this
+	 * polygon.
+	 */
+	void set_properties(const PolygonProperties& new_properties) const {
+		const std::lock_guard<std::mutex> lock(properties_mutex);
+		properties = new_properties;
+	}
+
 	/*!
 	 * Replaces the content of the polygon with a vertex, repeated a number of
 	 * times.
@@ -229,6 +597,7 @@ public:
 	 * \param vertex The vertex to add multiple times.
 	 */
 	void assign(const size_t count, const Point2& vertex) {
+		discard_gpu_copy(); //The vertices are replaced anyway.
 		properties = static_cast<unsigned int>(PolygonProperties::Convexity::DEGENERATE)
 			| static_cast<unsigned int>(PolygonProperties::SelfIntersecting::UNKNOWN) //Would be an edge case if count >= 2.
 			| static_cast<unsigned int>(PolygonProperties::Orientation::POSITIVE);
@@ -243,6 +612,7 @@ public:
 	template<class InputIterator>
 	void assign(InputIterator first, InputIterator last) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::assign(first, last);
 	}
 
@@ -253,6 +623,7 @@ public:
 	 */
 	void assign(const std::initializer_list<Point2>& vertices) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::assign(vertices);
 	}
 
@@ -260,6 +631,7 @@ public:
 	 * Empties out the polygon, resulting in an empty polygon.
 	 */
 	void clear() noexcept {
+		discard_gpu_copy();
 		properties = static_cast<unsigned int>(PolygonProperties::Convexity::DEGENERATE)
 			| static_cast<unsigned int>(PolygonProperties::SelfIntersecting::NO)
 			| static_cast<unsigned int>(PolygonProperties::Orientation::POSITIVE);
@@ -278,6 +650,7 @@ public:
 	template<typename... Arguments>
 	iterator emplace(const_iterator position, Arguments... arguments) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::emplace(position, arguments...);
 	}
 
@@ -291,6 +664,7 @@ public:
 	template<typename... Arguments>
 	void emplace_back(Arguments... arguments) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::emplace_back(arguments...);
 	}
 
@@ -303,6 +677,7 @@ public:
 	 */
 	iterator erase(const_iterator position) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::erase(position);
 	}
 
@@ -319,6 +694,7 @@ public:
 	 */
 	iterator erase(const_iterator first, const_iterator last) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::erase(first, last);
 	}
 
@@ -330,6 +706,7 @@ public:
 	 */
 	iterator insert(const_iterator position, const Point2& vertex) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::insert(position, vertex);
 	}
 
@@ -344,6 +721,7 @@ public:
 	 */
 	iterator insert(const_iterator position, const Point2&& vertex) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::insert(position, vertex);
 	}
 
@@ -360,6 +738,7 @@ public:
 	 */
 	iterator insert(const_iterator position, const size_t count, const Point2& vertex) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::insert(position, count, vertex);
 	}
 
@@ -378,6 +757,7 @@ public:
 	template<class InputIterator>
 	iterator insert(const_iterator position, InputIterator first, InputIterator last) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::insert(position, first, last);
 	}
 
@@ -390,6 +770,7 @@ public:
 	 */
 	iterator insert(const_iterator position, const std::initializer_list<Point2>& vertices) {
 		properties.reset();
+		detach_from_gpu();
 		return Batch<Point2>::insert(position, vertices);
 	}
 
@@ -398,6 +779,7 @@ public:
 	 */
 	void pop_back() {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::pop_back();
 	}
 
@@ -407,6 +789,7 @@ public:
 	 */
 	void push_back(const Point2& vertex) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::push_back(vertex);
 	}
 
@@ -418,9 +801,24 @@ public:
 	 */
 	void push_back(Point2&& vertex) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::push_back(vertex);
 	}
 
+#ifdef GPU
+	/*!
+	 * Reserve memory for a number of vertices.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed.
+	 * \param new_capacity The number of vertices to reserve memory for.
+	 */
+	void reserve(const size_t new_capacity) {
+		detach_from_gpu();
+		Batch<Point2>::reserve(new_capacity);
+	}
+#endif //GPU
+
 	/*!
 	 * Resize the list of vertices of the polygon such that it reaches the given
 	 * size.
@@ -438,9 +836,23 @@ public:
 	 */
 	void resize(const size_t new_size, const Point2& fill_vertex = Point2(0, 0)) {
 		properties.reset();
+		detach_from_gpu();
 		Batch<Point2>::resize(new_size, fill_vertex);
 	}
 
+#ifdef GPU
+	/*!
+	 * Reduce the memory used by the polygon to fit its vertices.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed.
+	 */
+	void shrink_to_fit() {
+		detach_from_gpu();
+		Batch<Point2>::shrink_to_fit();
+	}
+#endif //GPU
+
 	/*!
 	 * Swap the contents of this polygon with that of another.
 	 * \param other The polygon to swap with.
@@ -450,10 +862,23 @@ public:
 		Batch<Point2>::swap(other);
 	}
 
+	/*!
+	 * Transforms this polygon with an affine transformation.
+	 *
+	 * The polygon is transformed in-place. Since the transformation may mirror
+	 * the polygon or make it degenerate, the properties that are known about
+	 * the polygon are forgotten.
+	 * \param transformation The transformation to perform on each vertex.
+	 */
+	void transform(const AffineTransform& transformation) {
+		apex::transform(*this, transformation);
+	}
+
 	/*!
 	 * Moves this polygon with a certain offset.
 	 *
-	 * The polygon is moved in-place.
+	 * The polygon is moved in-place. The properties that are known about the
+	 * polygon stay valid, with the bounding box moving along.
 	 * \param delta The distance by which to move, representing both dimensions
 	 * to move through as a single 2D vector.
 	 */
@@ -467,20 +892,721 @@ protected:
 	 *
 	 * This is used to cache important information and use that speed up future
 	 * calculations with the polygon if we already know some properties about
-	 * the polygon.
+	 * the polygon. Since it is only a cache, it may be filled in when the
+	 * polygon is constant.
+	 */
+	mutable PolygonProperties properties;
+
+	/*!
+	 * Guards the cached properties while they are read or filled in through a
+	 * constant polygon.
+	 *
+	 * Methods that modify the polygon need exclusive access to it anyway, so
+	 * they don't lock this.
+	 */
+	mutable std::mutex properties_mutex;
+
+	/*!
+	 * Get this polygon, making sure that its vertices on the host are up to
+	 * date first.
+	 * \return This polygon.
+	 */
+	const Polygon& synced_to_host() const {
+		sync_to_host();
+		return *this;
+	}
+
+	/*!
+	 * Transfer the vertices back from the GPU, if they were changed there.
+	 */
+	void sync_to_host() const {
+#ifdef GPU
+		GPUDataTracker::sync_to_host(Batch<Point2>::data());
+#endif //GPU
+	}
+
+	/*!
+	 * Prepare for the vertices to be modified on the host, without changing
+	 * how many there are.
+	 *
+	 * The vertices are transferred back from the GPU if they were changed
+	 * there. Their copy on the GPU and the cached properties are then
+	 * considered outdated.
+	 */
+	void changing_on_host() {
+		properties.reset();
+#ifdef GPU
+		GPUDataTracker::sync_to_host(Batch<Point2>::data());
+		GPUDataTracker::changed_on_host(Batch<Point2>::data());
+#endif //GPU
+	}
+
+	/*!
+	 * Prepare for the vertex buffer to be modified or reallocated on the host.
+	 *
+	 * The vertices are transferred back from the GPU if they were changed
+	 * there, and their copy on the GPU is removed.
+	 */
+	void detach_from_gpu() {
+#ifdef GPU
+		GPUDataTracker::sync_to_host(Batch<Point2>::data());
+		GPUDataTracker::release(Batch<Point2>::data());
+#endif //GPU
+	}
+
+	/*!
+	 * Remove the copy of the vertices on the GPU, without transferring any
+	 * changes back to the host.
+	 *
+	 * This is used when the vertices on the host are about to be replaced or
+	 * freed anyway.
 	 */
-	PolygonProperties properties;
+	void discard_gpu_copy() noexcept {
+#ifdef GPU
+		GPUDataTracker::release(Batch<Point2>::data());
+#endif //GPU
+	}
 };
 
 /*!
  * This specialisation of batches of polygons allows polygon operations on
  * batches, possibly increasing parallelism.
+ *
+ * When compiled with GPU support, the vertices of all polygons in the batch are
+ * registered with the \ref GPUDataTracker, the same as for single polygons.
+ * Accessing the polygons on the host transfers the vertices back only if they
+ * were changed on the GPU. Note that \ref data_subelements gives direct access
+ * to the vertex buffer on the host, without synchronising it. References to
+ * polygons in the batch should also not be kept while running operations on
+ * the GPU, since they don't synchronise the vertices by themselves. *
+ * The properties of each polygon are cached in the same way as for single
+ * polygons, once they are computed. Modifying the batch through any of its
+ * methods makes it forget those properties. Modifying the vertices through
+ * \ref data_subelements doesn't, so the cache needs to be reset with
+ * \ref set_properties afterwards. Multiple threads may read and fill in the
+ * cache of the same constant batch at the same time.
  */
 template<>
 class Batch<Polygon> : public Batch<Batch<Point2>> {
 public:
 	using Batch<Batch<Point2>>::Batch; //The constructors are the same.
 
+#ifdef GPU
+	/*!
+	 * Batches of polygons keep their vertices on the GPU in between operations.
+	 */
+	static constexpr bool gpu_tracked = true;
+#endif //GPU
+
+	/*!
+	 * Creates an empty batch of polygons.
+	 */
+	Batch() : Batch<Batch<Point2>>() {}
+
+	/*!
+	 * Copies a batch of polygons.
+	 * \param original The batch to copy.
+	 */
+	Batch(const Batch<Polygon>& original) : Batch<Batch<Point2>>(original.synced_to_host()) {
+		const std::lock_guard<std::mutex> lock(original.properties_mutex); //Other threads may be filling in the cache of the original.
+		properties = original.properties;
+	}
+
+	/*!
+	 * Moves a batch of polygons.
+	 *
+	 * The vertices stay in the same place in memory, so if they are on the GPU,
+	 * they stay there.
+	 * \param original The batch to move.
+	 */
+	Batch(Batch<Polygon>&& original) noexcept : Batch<Batch<Point2>>(std::move(original)),
+		properties(std::move(original.properties)) {}
+
+#ifdef GPU
+	/*!
+	 * Removes the vertices of this batch from the GPU, if they were there.
+	 */
+	~Batch() {
+		discard_gpu_copy();
+	}
+#endif //GPU
+
+	/*!
+	 * Copies the contents of a different batch of polygons into this one.
+	 * \param other The batch to copy.
+	 * \return A reference to this batch.
+	 */
+	Batch<Polygon>& operator =(const Batch<Polygon>& other) {
+		discard_gpu_copy(); //The vertices are replaced anyway.
+		Batch<Batch<Point2>>::operator =(other.synced_to_host());
+		const std::lock_guard<std::mutex> lock(other.properties_mutex); //Other threads may be filling in the cache of the other batch.
+		properties = other.properties;
+		return *this;
+	}
+
+	/*!
+	 * Moves the contents of a different batch of polygons into this one.
+	 *
+	 * If the batches use different memory resources, the polygons need to be
+	 * moved into memory from the resource of this batch, which may throw.
+	 * \param other The batch to move.
+	 * \return A reference to this batch.
+	 */
+	Batch<Polygon>& operator =(Batch<Polygon>&& other) {
+		discard_gpu_copy(); //The vertices are replaced anyway.
+		Batch<Batch<Point2>>::operator =(std::move(other));
+		properties = std::move(other.properties);
+		return *this;
+	}
+
+	//Accessing the polygons on the host needs to synchronise them with the GPU first, and may make the cached properties outdated.
+	/*!
+	 * Get the polygon at a certain index.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \param index The index of the polygon to get.
+	 * \return The polygon at the given index.
+	 */
+	const Subbatch<Point2>& operator [](const size_t index) const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::operator [](index);
+	}
+
+	/*!
+	 * Get the polygon at a certain index.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \param index The index of the polygon to get.
+	 * \return The polygon at the given index.
+	 */
+	Subbatch<Point2>& operator [](const size_t index) {
+		changing_on_host();
+		return Batch<Batch<Point2>>::operator [](index);
+	}
+
+	/*!
+	 * Get the polygon at a certain index, checking whether the index is in
+	 * range.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \param index The index of the polygon to get.
+	 * \return The polygon at the given index.
+	 */
+	const Subbatch<Point2>& at(const size_t index) const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::at(index);
+	}
+
+	/*!
+	 * Get the polygon at a certain index, checking whether the index is in
+	 * range.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \param index The index of the polygon to get.
+	 * \return The polygon at the given index.
+	 */
+	Subbatch<Point2>& at(const size_t index) {
+		changing_on_host();
+		return Batch<Batch<Point2>>::at(index);
+	}
+
+	/*!
+	 * Get the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return The last polygon in the batch.
+	 */
+	const Subbatch<Point2>& back() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::back();
+	}
+
+	/*!
+	 * Get the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return The last polygon in the batch.
+	 */
+	Subbatch<Point2>& back() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::back();
+	}
+
+	/*!
+	 * Get an iterator to the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing at the first polygon.
+	 */
+	const_iterator begin() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::begin();
+	}
+
+	/*!
+	 * Get an iterator to the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return An iterator pointing at the first polygon.
+	 */
+	iterator begin() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::begin();
+	}
+
+	/*!
+	 * Get an iterator to the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing at the first polygon.
+	 */
+	const_iterator cbegin() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::cbegin();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing beyond the last polygon.
+	 */
+	const_iterator cend() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::cend();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing at the last polygon.
+	 */
+	const_reverse_iterator crbegin() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::crbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing before the first polygon.
+	 */
+	const_reverse_iterator crend() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::crend();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return An iterator pointing beyond the last polygon.
+	 */
+	const_iterator end() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::end();
+	}
+
+	/*!
+	 * Get an iterator to beyond the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return An iterator pointing beyond the last polygon.
+	 */
+	iterator end() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::end();
+	}
+
+	/*!
+	 * Get the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return The first polygon in the batch.
+	 */
+	const Subbatch<Point2>& front() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::front();
+	}
+
+	/*!
+	 * Get the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return The first polygon in the batch.
+	 */
+	Subbatch<Point2>& front() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::front();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing at the last polygon.
+	 */
+	const_reverse_iterator rbegin() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::rbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to the last polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return A reverse iterator pointing at the last polygon.
+	 */
+	reverse_iterator rbegin() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::rbegin();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first.
+	 * \return A reverse iterator pointing before the first polygon.
+	 */
+	const_reverse_iterator rend() const {
+		sync_to_host();
+		return Batch<Batch<Point2>>::rend();
+	}
+
+	/*!
+	 * Get a reverse iterator to before the first polygon in the batch.
+	 *
+	 * If the vertices were changed on the GPU, they are transferred back to the
+	 * host first. Since the polygons may be modified through the result, the
+	 * copy on the GPU and the cached properties are considered outdated
+	 * afterwards.
+	 * \return A reverse iterator pointing before the first polygon.
+	 */
+	reverse_iterator rend() {
+		changing_on_host();
+		return Batch<Batch<Point2>>::rend();
+	}
+
+	//Modifying the batch may reallocate the vertices, so they need to be removed from the GPU first. The cached properties are forgotten too.
+	/*!
+	 * Replace the contents of the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void assign(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::assign(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Replace the contents of the batch with a list of polygons.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \param initialiser_list The polygons to use.
+	 */
+	void assign(const std::initializer_list<Batch<Point2>>& initialiser_list) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::assign(initialiser_list);
+	}
+
+	/*!
+	 * Replace the contents of the batch with polygons of predetermined sizes,
+	 * which can then be filled in parallel.
+	 *
+	 * This allocates a new vertex buffer, so the copy on the GPU is removed
+	 * first. While filling the polygons from multiple threads, access them
+	 * through an iterator obtained beforehand, rather than through the batch
+	 * itself, since accessing the batch also updates its cached properties.
+	 * \param sizes For each polygon, the number of vertices it must get.
+	 */
+	void assign_sizes(const std::span<const size_t> sizes) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::assign_sizes(sizes);
+	}
+
+	/*!
+	 * Remove all polygons from the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void clear(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::clear(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Close the gaps between the polygons in the vertex buffer.
+	 *
+	 * This moves the vertices within the buffer, so their copy on the GPU is
+	 * removed first.
+	 */
+	void compact() {
+		detach_from_gpu();
+		Batch<Batch<Point2>>::compact();
+	}
+
+	/*!
+	 * Construct a polygon in-place at a certain position in the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 * \return An iterator pointing at the new polygon.
+	 */
+	template<typename... Arguments>
+	iterator emplace(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		return Batch<Batch<Point2>>::emplace(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Construct a polygon in-place at a certain position in the batch, from
+	 * a list of vertices.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \param position The position to insert at.
+	 * \param initialiser_list The vertices to use.
+	 * \return An iterator pointing at the new polygon.
+	 */
+	iterator emplace(const_iterator position, const std::initializer_list<Point2>& initialiser_list) {
+		properties.clear();
+		detach_from_gpu();
+		return Batch<Batch<Point2>>::emplace(position, initialiser_list);
+	}
+
+	/*!
+	 * Construct a polygon in-place at the end of the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void emplace_back(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::emplace_back(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Construct a polygon in-place at the end of the batch, from a list of
+	 * vertices.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \param initialiser_list The vertices to use.
+	 */
+	void emplace_back(const std::initializer_list<Point2>& initialiser_list) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::emplace_back(initialiser_list);
+	}
+
+	/*!
+	 * Remove polygons from the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 * \return An iterator pointing at the polygon after the removed polygons.
+	 */
+	template<typename... Arguments>
+	iterator erase(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		return Batch<Batch<Point2>>::erase(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Insert polygons at a certain position in the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 * \return An iterator pointing at the first inserted polygon.
+	 */
+	template<typename... Arguments>
+	iterator insert(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		return Batch<Batch<Point2>>::insert(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Insert a list of polygons at a certain position in the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \param position The position to insert at.
+	 * \param initialiser_list The polygons to use.
+	 * \return An iterator pointing at the first inserted polygon.
+	 */
+	iterator insert(const_iterator position, const std::initializer_list<Batch<Point2>>& initialiser_list) {
+		properties.clear();
+		detach_from_gpu();
+		return Batch<Batch<Point2>>::insert(position, initialiser_list);
+	}
+
+	/*!
+	 * Remove the last polygon from the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void pop_back(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::pop_back(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Add a polygon to the end of the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void push_back(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::push_back(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Reserve memory for a number of vertices in total.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void reserve_subelements(Arguments&&... arguments) {
+		detach_from_gpu();
+		Batch<Batch<Point2>>::reserve_subelements(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Change the number of polygons in the batch.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void resize(Arguments&&... arguments) {
+		properties.clear();
+		detach_from_gpu();
+		Batch<Batch<Point2>>::resize(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Reduce the memory used by the batch to fit its polygons.
+	 *
+	 * This may move the vertices to a different place in memory, so their copy
+	 * on the GPU is removed first.
+	 * \tparam Arguments The types of the arguments of the modification.
+	 * \param arguments The arguments of the modification, the same as those of
+	 * the batch it is based on.
+	 */
+	template<typename... Arguments>
+	void shrink_to_fit(Arguments&&... arguments) {
+		detach_from_gpu();
+		Batch<Batch<Point2>>::shrink_to_fit(std::forward<Arguments>(arguments)...);
+	}
+
+	/*!
+	 * Swap the contents of this batch with that of another.
+	 *
+	 * The properties that are known about the polygons are swapped along.
+	 * \param other The batch to swap with.
+	 */
+	void swap(Batch<Polygon>& other) noexcept {
+		properties.swap(other.properties);
+		Batch<Batch<Point2>>::swap(other);
+	}
+
+	/*!
+	 * Creates an empty batch of polygons that allocates its memory from a
+	 * specific memory resource.
+	 *
+	 * The vertices, the polygons and their properties are all allocated from
+	 * this resource. The memory resource must outlive the batch.
+	 * \param resource The memory resource to allocate the batch from.
+	 */
+	explicit Batch(std::pmr::memory_resource* resource) : Batch<Batch<Point2>>(resource),
+		properties(resource) {}
+
 	/*!
 	 * Computes the surface area of the polygons in this batch.
 	 *
@@ -499,6 +1625,82 @@ public:
 		return apex::area(*this);
 	}
 
+	/*!
+	 * Computes the axis-aligned bounding boxes of the polygons in this batch.
+	 *
+	 * The bounding boxes are cached, so they are only computed if they are not
+	 * all known since the batch was last modified.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the minimum and maximum corner of the bounding box of each
+	 * polygon in the same order.
+	 */
+	Batch<std::pair<Point2, Point2>> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Get the properties that are currently known about one of the polygons in
+	 * this batch.
+	 *
+	 * Operations use this to skip computations of which the result is already
+	 * known.
+	 * \param index The index of the polygon to get the properties of.
+	 * \return The cached properties of that polygon.
+	 */
+	PolygonProperties get_properties(const size_t index) const {
+		const std::lock_guard<std::mutex> lock(properties_mutex);
+		if(index >= properties.size()) { //Nothing is known about the polygons yet.
+			return PolygonProperties();
+		}
+		return properties[index];
+	}
+
+	/*!
+	 * Store properties that were computed about one of the polygons in this
+	 * batch.
+	 *
+	 * Since the properties are only a cache, this may also be called on a
+	 * constant batch, also by multiple threads at the same time.
+	 * \param index The index of the polygon to store the properties of.
+	 * \param new_properties The properties that are now known about that
+	 * polygon.
+	 */
+	void set_properties(const size_t index, const PolygonProperties& new_properties) const {
+		const std::lock_guard<std::mutex> lock(properties_mutex); //Filling in the cache reallocates it, which must not happen while other threads read it.
+		if(properties.size() != size()) { //Nothing is known about the polygons yet.
+			properties.assign(size(), PolygonProperties());
+		}
+		properties[index] = new_properties;
+	}
+
+	/*!
+	 * Update the cached properties of all polygons in this batch after they
+	 * were all moved by the same distance.
+	 *
+	 * This updates all of them at once, rather than getting and setting the
+	 * properties of each polygon in turn. If nothing is cached about the
+	 * polygons, nothing needs to be updated.
+	 * \param delta The distance by which the polygons were moved.
+	 */
+	void translate_properties(const Point2& delta) {
+		for(PolygonProperties& polygon_properties : properties) {
+			if(polygon_properties.has_bounding_box()) {
+				polygon_properties.translate(delta);
+			}
+		}
+	}
+
+	/*!
+	 * Transforms all polygons in this batch with the same affine
+	 * transformation.
+	 *
+	 * The polygons are transformed in-place.
+	 * \param transformation The transformation to perform on each vertex.
+	 */
+	void transform(const AffineTransform& transformation) {
+		apex::transform(*this, transformation);
+	}
+
 	/*!
 	 * Moves all polygons in this batch with the same offset.
 	 *
@@ -517,9 +1719,81 @@ protected:
 	 *
 	 * This is used to cache important information and use that speed up future
 	 * calculations with the polygons if we already know some properties
-	 * about the polygons.
+	 * about the polygons. It is filled in lazily, so it is either empty or has
+	 * one element for each polygon in the batch. Since it is only a cache, it
+	 * may be filled in when the batch is constant.
+	 */
+	mutable std::pmr::vector<PolygonProperties> properties;
+
+	/*!
+	 * Guards the cached properties while they are read or filled in through a
+	 * constant batch.
+	 *
+	 * Methods that modify the batch need exclusive access to it anyway, so they
+	 * don't lock this.
+	 */
+	mutable std::mutex properties_mutex;
+
+	/*!
+	 * Get this batch, making sure that its vertices on the host are up to date
+	 * first.
+	 * \return This batch.
+	 */
+	const Batch<Polygon>& synced_to_host() const {
+		sync_to_host();
+		return *this;
+	}
+
+	/*!
+	 * Transfer the vertices back from the GPU, if they were changed there.
+	 */
+	void sync_to_host() const {
+#ifdef GPU
+		GPUDataTracker::sync_to_host(data_subelements());
+#endif //GPU
+	}
+
+	/*!
+	 * Prepare for the vertices to be modified on the host, without changing
+	 * how many there are.
+	 *
+	 * The vertices are transferred back from the GPU if they were changed
+	 * there. Their copy on the GPU and the cached properties are then
+	 * considered outdated.
 	 */
-	std::vector<PolygonProperties> properties;
+	void changing_on_host() {
+		properties.clear();
+#ifdef GPU
+		GPUDataTracker::sync_to_host(data_subelements());
+		GPUDataTracker::changed_on_host(data_subelements());
+#endif //GPU
+	}
+
+	/*!
+	 * Prepare for the vertex buffer to be modified or reallocated on the host.
+	 *
+	 * The vertices are transferred back from the GPU if they were changed
+	 * there, and their copy on the GPU is removed.
+	 */
+	void detach_from_gpu() {
+#ifdef GPU
+		GPUDataTracker::sync_to_host(data_subelements());
+		GPUDataTracker::release(data_subelements());
+#endif //GPU
+	}
+
+	/*!
+	 * Remove the copy of the vertices on the GPU, without transferring any
+	 * changes back to the host.
+	 *
+	 * This is used when the vertices on the host are about to be replaced or
+	 * freed anyway.
+	 */
+	void discard_gpu_copy() noexcept {
+#ifdef GPU
+		GPUDataTracker::release(data_subelements());
+#endif //GPU
+	}
 };
 
 }
@@ -0,0 +1,714 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_R_TREE
+#define APEX_R_TREE
+
+#include <algorithm> //For std::min, std::max and std::sort.
+#include <cmath> //To choose the number of slices to sort the items in.
+#include <numeric> //To initialise the order of the items.
+#include <utility> //To store bounding boxes as pairs of corners.
+#include <vector> //To store the nodes of the tree.
+
+#include "batch.hpp" //To store the results of queries.
+#include "coordinate.hpp" //To compute the centres of bounding boxes without overflowing.
+#include "detail/geometry_concepts.hpp" //To build trees from any type of polygon batch.
+#include "detail/strategies.hpp" //To choose the fastest version of batched queries.
+#include "instrumentation.hpp" //To report on the chosen version of batched queries.
+#include "operations/bounding_box.hpp" //To find the bounding boxes of the polygons to index.
+#include "point2.hpp" //To store the corners of the bounding boxes.
+
+namespace apex {
+
+class RTree;
+
+namespace detail {
+
+//Declare the detail functions so that we can reference them from the R-tree.
+template<typename Callback>
+void r_tree_traverse(const Point2* minima, const Point2* maxima, const size_t* items, const size_t* level_starts, const size_t num_levels, const Point2 minimum, const Point2 maximum, Callback& callback);
+inline Batch<Batch<size_t>> r_tree_query_st(const RTree& tree, const Point2* minima, const Point2* maxima, const size_t num_windows);
+inline Batch<Batch<size_t>> r_tree_query_mt(const RTree& tree, const Point2* minima, const Point2* maxima, const size_t num_windows);
+#ifdef GPU
+inline Batch<Batch<size_t>> r_tree_query_gpu(const RTree& tree, const Point2* minima, const Point2* maxima, const size_t num_windows);
+#endif //GPU
+
+}
+
+/*!
+ * A spatial index to quickly find which items overlap with a region.
+ *
+ * The items are indexed by their axis-aligned bounding boxes. Typically the
+ * items are the polygons of a batch, but any list of bounding boxes can be
+ * indexed. Finding the items that overlap with a region then takes roughly
+ * logarithmic time, rather than the linear time needed to compare the region
+ * with every item.
+ *
+ * This is a packed R-tree, bulk loaded with the Sort-Tile-Recursive algorithm.
+ * The items are sorted by the X coordinate of their centres and divided into
+ * vertical slices. Within each slice, they are sorted by the Y coordinate of
+ * their centres. Groups of consecutive items then form the leaf nodes of the
+ * tree, which tend to be compact and overlap little. Every node of the tree is
+ * completely filled, except the last node of each level. The tree can't be
+ * modified after it's constructed, except by changing the bounding boxes of
+ * the items it contains.
+ *
+ * Since the nodes are completely filled, the children of each node can be
+ * found by their position, without needing to store pointers. The bounding
+ * boxes of all nodes are stored in flat arrays, level by level, starting with
+ * the leaves and ending with the root. This makes traversing the tree cache-
+ * friendly, and allows the tree to be copied to the GPU with a few transfers.
+ *
+ * The index doesn't keep a reference to the items it indexes. If the items
+ * move, the tree should be informed with \ref refit, \ref update or
+ * \ref translate. That is much cheaper than constructing a new tree, but the
+ * tree may become less efficient if the items move a lot relative to each
+ * other.
+ */
+class RTree {
+public:
+	/*!
+	 * The number of children of each node in the tree.
+	 *
+	 * With 16 children, the bounding boxes of the children of one node fill a
+	 * few cache lines, and the tree remains shallow.
+	 */
+	static constexpr size_t node_size = 16;
+
+	/*!
+	 * The maximum number of levels in a tree.
+	 *
+	 * With 16 children per node, this is enough to index as many items as fit
+	 * in memory. Traversals use a stack of a fixed size, based on this depth.
+	 */
+	static constexpr size_t max_levels = 16;
+
+	/*!
+	 * Constructs an empty tree, without any items.
+	 */
+	RTree() : level_starts({0}) {}
+
+	/*!
+	 * Constructs a tree indexing the polygons in a batch.
+	 *
+	 * The items of the tree are the polygons, identified by their index in the
+	 * batch. If the batch caches the bounding boxes of its polygons, they are
+	 * taken from the cache.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The polygons to index.
+	 */
+	template<multi_polygonal PolygonBatch>
+	explicit RTree(const PolygonBatch& batch) : RTree(apex::bounding_box(batch)) {}
+
+	/*!
+	 * Constructs a tree indexing items with the given bounding boxes.
+	 *
+	 * The items of the tree are identified by their index in the list of
+	 * bounding boxes. The slices of the items are sorted in parallel, and each
+	 * level of the tree is computed in parallel too.
+	 * \param boxes For each item, the minimum and maximum corner of its
+	 * bounding box, in that order.
+	 */
+	explicit RTree(const Batch<std::pair<Point2, Point2>>& boxes) {
+		const size_t num_items = boxes.size();
+		items.resize(num_items);
+		std::iota(items.begin(), items.end(), 0);
+
+		//Sort-Tile-Recursive: Sort by X, then divide into vertical slices and sort each slice by Y.
+		const auto centre_x = [&boxes](const size_t item) {
+			return area_t(boxes[item].first.x) + boxes[item].second.x; //Twice the centre, which sorts the same way without rounding.
+		};
+		const auto centre_y = [&boxes](const size_t item) {
+			return area_t(boxes[item].first.y) + boxes[item].second.y;
+		};
+		std::sort(items.begin(), items.end(), [&centre_x](const size_t a, const size_t b) {
+			return centre_x(a) < centre_x(b);
+		});
+		const size_t num_leaves = (num_items + node_size - 1) / node_size;
+		const size_t num_slices = std::max(size_t(1), size_t(std::ceil(std::sqrt(num_leaves))));
+		const size_t slice_size = (num_leaves + num_slices - 1) / num_slices * node_size;
+		#pragma omp parallel for schedule(dynamic)
+		for(size_t slice = 0; slice < num_slices; ++slice) {
+			const size_t start = std::min(slice * slice_size, num_items);
+			const size_t end = std::min(start + slice_size, num_items);
+			std::sort(items.begin() + start, items.begin() + end, [&centre_y](const size_t a, const size_t b) {
+				return centre_y(a) < centre_y(b);
+			});
+		}
+
+		positions.resize(num_items);
+		#pragma omp parallel for
+		for(size_t leaf = 0; leaf < num_items; ++leaf) {
+			positions[items[leaf]] = leaf;
+		}
+
+		//Allocate all levels at once. Each level has a node for every group of children in the level below.
+		level_starts.push_back(0);
+		size_t level_size = num_items;
+		while(level_size > 0) {
+			level_starts.push_back(level_starts.back() + level_size);
+			if(level_size == 1) {
+				break; //Reached the root.
+			}
+			level_size = (level_size + node_size - 1) / node_size;
+		}
+		minima.resize(level_starts.back());
+		maxima.resize(level_starts.back());
+		refit(boxes);
+	}
+
+	/*!
+	 * Get the number of items in the tree.
+	 * \return The number of items that the tree indexes.
+	 */
+	size_t size() const {
+		return items.size();
+	}
+
+	/*!
+	 * Get whether the tree is empty.
+	 * \return ``true`` if the tree doesn't index any items, or ``false`` if it
+	 * does.
+	 */
+	bool empty() const {
+		return items.empty();
+	}
+
+	/*!
+	 * Get the number of levels in the tree, including the level of the leaves
+	 * and the root.
+	 * \return The number of levels in the tree.
+	 */
+	size_t num_levels() const {
+		return level_starts.size() - 1;
+	}
+
+	/*!
+	 * Get the bounding box of all items in the tree.
+	 * \return The minimum and maximum corner of the bounding box around all
+	 * items, in that order. If the tree is empty, the bounding box is empty at
+	 * the origin.
+	 */
+	std::pair<Point2, Point2> bounding_box() const {
+		if(empty()) {
+			return std::make_pair(Point2(0, 0), Point2(0, 0));
+		}
+		return std::make_pair(minima.back(), maxima.back());
+	}
+
+	/*!
+	 * Find the items whose bounding boxes overlap with a rectangular window.
+	 *
+	 * Bounding boxes that only touch the window are considered overlapping.
+	 * Note that the polygons themselves may not overlap with the window, even
+	 * if their bounding boxes do.
+	 * \param minimum The minimum corner of the window.
+	 * \param maximum The maximum corner of the window.
+	 * \return The indices of the items that overlap with the window, in no
+	 * particular order.
+	 */
+	Batch<size_t> query(const Point2& minimum, const Point2& maximum) const {
+		Batch<size_t> result;
+		traverse(minimum, maximum, [&result](const size_t item) {
+			result.push_back(item);
+		});
+		return result;
+	}
+
+	/*!
+	 * Find the items whose bounding boxes contain a point.
+	 *
+	 * Points on the border of a bounding box are considered to be inside.
+	 * \param point The point to find the items at.
+	 * \return The indices of the items whose bounding boxes contain the point,
+	 * in no particular order.
+	 */
+	Batch<size_t> query(const Point2& point) const {
+		return query(point, point);
+	}
+
+	/*!
+	 * Find the items whose bounding boxes overlap with each of several windows.
+	 *
+	 * This gives the same results as querying each window separately, but the
+	 * windows may be queried in parallel, or on the GPU.
+	 * \param windows For each window, the minimum and maximum corner.
+	 * \return For each window, the indices of the items that overlap with the
+	 * window, in no particular order.
+	 */
+	Batch<Batch<size_t>> query(const Batch<std::pair<Point2, Point2>>& windows) const {
+		std::vector<Point2> window_minima(windows.size());
+		std::vector<Point2> window_maxima(windows.size());
+		for(size_t window = 0; window < windows.size(); ++window) {
+			window_minima[window] = windows[window].first;
+			window_maxima[window] = windows[window].second;
+		}
+		return query(window_minima.data(), window_maxima.data(), windows.size());
+	}
+
+	/*!
+	 * Find the items whose bounding boxes contain each of several points.
+	 *
+	 * This gives the same results as querying each point separately, but the
+	 * points may be queried in parallel, or on the GPU.
+	 * \param points The points to find the items at.
+	 * \return For each point, the indices of the items whose bounding boxes
+	 * contain the point, in no particular order.
+	 */
+	Batch<Batch<size_t>> query(const Batch<Point2>& points) const {
+		return query(points.data(), points.data(), points.size());
+	}
+
+	/*!
+	 * Update the bounding boxes of all items in the tree, keeping the structure
+	 * of the tree intact.
+	 *
+	 * The bounding boxes of all nodes are recomputed from the leaves up, which
+	 * takes linear time, but the items are not sorted again.
+	 * \param boxes For each item, the new minimum and maximum corner of its
+	 * bounding box. This must have the same number of items as the tree.
+	 */
+	void refit(const Batch<std::pair<Point2, Point2>>& boxes) {
+		const size_t num_items = items.size();
+		#pragma omp parallel for
+		for(size_t leaf = 0; leaf < num_items; ++leaf) {
+			minima[leaf] = boxes[items[leaf]].first;
+			maxima[leaf] = boxes[items[leaf]].second;
+		}
+		for(size_t level = 1; level < num_levels(); ++level) {
+			const size_t level_size = level_starts[level + 1] - level_starts[level];
+			#pragma omp parallel for if(level_size >= 1024)
+			for(size_t node = 0; node < level_size; ++node) {
+				fit_node(level, node);
+			}
+		}
+	}
+
+	/*!
+	 * Update the bounding boxes of the polygons in the tree, keeping the
+	 * structure of the tree intact.
+	 *
+	 * If the batch caches the bounding boxes of its polygons, they are taken
+	 * from the cache. Translating polygons keeps those caches up to date, so
+	 * refitting the tree after translating is cheap.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The polygons in the tree, after they were moved. This must
+	 * have the same number of polygons as the tree has items.
+	 */
+	template<multi_polygonal PolygonBatch>
+	void refit(const PolygonBatch& batch) {
+		refit(apex::bounding_box(batch));
+	}
+
+	/*!
+	 * Update the bounding box of a single item in the tree.
+	 *
+	 * Only the nodes that contain the item are recomputed, which takes
+	 * logarithmic time.
+	 * \param item The index of the item that changed.
+	 * \param minimum The new minimum corner of the bounding box of the item.
+	 * \param maximum The new maximum corner of the bounding box of the item.
+	 */
+	void update(const size_t item, const Point2& minimum, const Point2& maximum) {
+		size_t node = positions[item];
+		minima[node] = minimum;
+		maxima[node] = maximum;
+		for(size_t level = 1; level < num_levels(); ++level) {
+			node /= node_size;
+			fit_node(level, node);
+		}
+	}
+
+	/*!
+	 * Move all items in the tree by the same offset.
+	 *
+	 * This is the counterpart of translating all polygons in the batch that the
+	 * tree indexes. Since all bounding boxes move by the same offset, the
+	 * structure of the tree remains just as efficient.
+	 * \param delta The distance to move the items by.
+	 */
+	void translate(const Point2& delta) {
+		#pragma omp parallel for simd
+		for(size_t node = 0; node < minima.size(); ++node) {
+			minima[node] += delta;
+			maxima[node] += delta;
+		}
+	}
+
+	/*!
+	 * Get the minimum corners of the bounding boxes of all nodes.
+	 *
+	 * The nodes are stored level by level, starting with the leaves, in the
+	 * order of \ref data_items, and ending with the root.
+	 * \return A pointer to the minimum corners of all nodes.
+	 */
+	const Point2* data_minima() const {
+		return minima.data();
+	}
+
+	/*!
+	 * Get the maximum corners of the bounding boxes of all nodes.
+	 *
+	 * The nodes are stored in the same order as in \ref data_minima.
+	 * \return A pointer to the maximum corners of all nodes.
+	 */
+	const Point2* data_maxima() const {
+		return maxima.data();
+	}
+
+	/*!
+	 * Get the item in each leaf of the tree.
+	 * \return A pointer to the index of the item in each leaf, in the order
+	 * that the leaves are stored in.
+	 */
+	const size_t* data_items() const {
+		return items.data();
+	}
+
+	/*!
+	 * Get where each level of the tree starts in the arrays of nodes.
+	 *
+	 * This contains one extra element at the end, indicating the end of the
+	 * root level, which is the total number of nodes.
+	 * \return A pointer to the position of the first node of each level.
+	 */
+	const size_t* data_level_starts() const {
+		return level_starts.data();
+	}
+
+	/*!
+	 * Get the total number of nodes in the tree, including the leaves.
+	 * \return The number of nodes in the tree.
+	 */
+	size_t num_nodes() const {
+		return minima.size();
+	}
+
+protected:
+	/*!
+	 * The minimum corners of the bounding boxes of all nodes, level by level.
+	 *
+	 * The first level contains the leaves, which are the bounding boxes of the
+	 * items themselves. The last level contains only the root.
+	 */
+	std::vector<Point2> minima;
+
+	/*!
+	 * The maximum corners of the bounding boxes of all nodes, in the same order
+	 * as \ref minima.
+	 */
+	std::vector<Point2> maxima;
+
+	/*!
+	 * For each leaf, the index of the item it contains.
+	 */
+	std::vector<size_t> items;
+
+	/*!
+	 * For each item, the index of the leaf that contains it.
+	 *
+	 * This is the inverse of \ref items, to find the nodes to update when an
+	 * item moves.
+	 */
+	std::vector<size_t> positions;
+
+	/*!
+	 * For each level, where its nodes start in \ref minima and \ref maxima.
+	 *
+	 * This contains one extra element at the end, indicating the end of the
+	 * last level.
+	 */
+	std::vector<size_t> level_starts;
+
+	/*!
+	 * Recompute the bounding box of a node from the bounding boxes of its
+	 * children.
+	 * \param level The level of the node. This must not be the level of the
+	 * leaves.
+	 * \param node The index of the node within that level.
+	 */
+	void fit_node(const size_t level, const size_t node) {
+		const size_t children_start = level_starts[level - 1];
+		const size_t first = children_start + node * node_size;
+		const size_t end = std::min(first + node_size, level_starts[level]);
+		Point2 minimum = minima[first];
+		Point2 maximum = maxima[first];
+		for(size_t child = first + 1; child < end; ++child) {
+			minimum = Point2(std::min(minimum.x, minima[child].x), std::min(minimum.y, minima[child].y));
+			maximum = Point2(std::max(maximum.x, maxima[child].x), std::max(maximum.y, maxima[child].y));
+		}
+		minima[level_starts[level] + node] = minimum;
+		maxima[level_starts[level] + node] = maximum;
+	}
+
+	/*!
+	 * Find the items whose bounding boxes overlap with a window, and report
+	 * them to a callback.
+	 * \tparam Callback A function taking the index of an item.
+	 * \param minimum The minimum corner of the window.
+	 * \param maximum The maximum corner of the window.
+	 * \param callback The function to call for each item that overlaps.
+	 */
+	template<typename Callback>
+	void traverse(const Point2& minimum, const Point2& maximum, Callback callback) const {
+		detail::r_tree_traverse(minima.data(), maxima.data(), items.data(), level_starts.data(), num_levels(), minimum, maximum, callback);
+	}
+
+	/*!
+	 * Find the items that overlap with each of several windows, with the
+	 * fastest version of the batched query.
+	 * \param window_minima The minimum corner of each window.
+	 * \param window_maxima The maximum corner of each window.
+	 * \param num_windows The number of windows to query.
+	 * \return For each window, the indices of the items that overlap with it.
+	 */
+	Batch<Batch<size_t>> query(const Point2* window_minima, const Point2* window_maxima, const size_t num_windows) const {
+		const detail::Dispatch dispatch(detail::Operation::r_tree_query_batch, num_windows);
+		switch(dispatch.version) {
+			case 0: return detail::r_tree_query_st(*this, window_minima, window_maxima, num_windows);
+			case 1: return detail::r_tree_query_mt(*this, window_minima, window_maxima, num_windows);
+#ifdef GPU
+			default: {
+				const detail::Strategies::GPUReservation reservation;
+				return detail::r_tree_query_gpu(*this, window_minima, window_maxima, num_windows);
+			}
+#endif //GPU
+		}
+		return detail::r_tree_query_mt(*this, window_minima, window_maxima, num_windows);
+	}
+};
+
+namespace detail {
+
+/*!
+ * Traverses an R-tree to find the items whose bounding boxes overlap with a
+ * window.
+ *
+ * This works on the flat arrays of the tree, so that it can run on the GPU as
+ * well. The tree is traversed depth-first with a stack of a fixed size, which
+ * is enough for any tree of at most \ref RTree::max_levels levels.
+ * \tparam Callback A function or function object taking the index of an item.
+ * \param minima The minimum corners of the bounding boxes of all nodes.
+ * \param maxima The maximum corners of the bounding boxes of all nodes.
+ * \param items The index of the item in each leaf.
+ * \param level_starts Where each level starts in the arrays of nodes.
+ * \param num_levels The number of levels in the tree.
+ * \param minimum The minimum corner of the window.
+ * \param maximum The maximum corner of the window.
+ * \param callback The function to call for each item that overlaps.
+ */
+template<typename Callback>
+void r_tree_traverse(const Point2* minima, const Point2* maxima, const size_t* items, const size_t* level_starts, const size_t num_levels, const Point2 minimum, const Point2 maximum, Callback& callback) {
+	if(num_levels == 0) {
+		return; //Empty tree.
+	}
+	const size_t root = level_starts[num_levels - 1];
+	if(minima[root].x > maximum.x || maxima[root].x < minimum.x || minima[root].y > maximum.y || maxima[root].y < minimum.y) {
+		return; //Window is completely outside of the tree.
+	}
+	if(num_levels == 1) {
+		callback(items[0]);
+		return;
+	}
+	constexpr size_t stack_capacity = RTree::node_size * RTree::max_levels; //Each level can add at most one node's children to the stack.
+	size_t stack_levels[stack_capacity];
+	size_t stack_nodes[stack_capacity];
+	size_t stack_size = 1;
+	stack_levels[0] = num_levels - 1;
+	stack_nodes[0] = 0;
+	while(stack_size > 0) {
+		--stack_size;
+		const size_t level = stack_levels[stack_size];
+		const size_t node = stack_nodes[stack_size];
+		const size_t children_start = level_starts[level - 1];
+		const size_t first = node * RTree::node_size;
+		const size_t end = std::min(first + RTree::node_size, level_starts[level] - children_start);
+		for(size_t child = first; child < end; ++child) {
+			const size_t position = children_start + child;
+			if(minima[position].x > maximum.x || maxima[position].x < minimum.x || minima[position].y > maximum.y || maxima[position].y < minimum.y) {
+				continue; //No overlap, so none of its descendants overlap either.
+			}
+			if(level == 1) { //Child is a leaf.
+				callback(items[child]);
+			} else {
+				stack_levels[stack_size] = level - 1;
+				stack_nodes[stack_size] = child;
+				++stack_size;
+			}
+		}
+	}
+}
+
+/*!
+ * Single-threaded implementation of querying an R-tree with many windows.
+ *
+ * The windows are queried one by one.
+ * \param tree The tree to query.
+ * \param window_minima The minimum corner of each window.
+ * \param window_maxima The maximum corner of each window.
+ * \param num_windows The number of windows to query.
+ * \return For each window, the indices of the items that overlap with it.
+ */
+inline Batch<Batch<size_t>> r_tree_query_st(const RTree& tree, const Point2* window_minima, const Point2* window_maxima, const size_t num_windows) {
+	Batch<Batch<size_t>> result;
+	result.reserve(num_windows);
+	Batch<size_t> window_result;
+	const auto collect = [&window_result](const size_t item) {
+		window_result.push_back(item);
+	};
+	for(size_t window = 0; window < num_windows; ++window) {
+		window_result.clear();
+		r_tree_traverse(tree.data_minima(), tree.data_maxima(), tree.data_items(), tree.data_level_starts(), tree.num_levels(), window_minima[window], window_maxima[window], collect);
+		result.push_back(window_result);
+	}
+	return result;
+}
+
+/*!
+ * Multi-threaded implementation of querying an R-tree with many windows.
+ *
+ * The windows are divided over the threads. Since some windows may find many
+ * more items than others, they are scheduled dynamically.
+ * \param tree The tree to query.
+ * \param window_minima The minimum corner of each window.
+ * \param window_maxima The maximum corner of each window.
+ * \param num_windows The number of windows to query.
+ * \return For each window, the indices of the items that overlap with it.
+ */
+inline Batch<Batch<size_t>> r_tree_query_mt(const RTree& tree, const Point2* window_minima, const Point2* window_maxima, const size_t num_windows) {
+	std::vector<Batch<size_t>> window_results(num_windows);
+	#pragma omp parallel for schedule(dynamic, 64)
+	for(size_t window = 0; window < num_windows; ++window) {
+		Batch<size_t>& window_result = window_results[window];
+		const auto collect = [&window_result](const size_t item) {
+			window_result.push_back(item);
+		};
+		r_tree_traverse(tree.data_minima(), tree.data_maxima(), tree.data_items(), tree.data_level_starts(), tree.num_levels(), window_minima[window], window_maxima[window], collect);
+	}
+
+	Batch<Batch<size_t>> result;
+	result.reserve(num_windows);
+	size_t total = 0;
+	for(const Batch<size_t>& window_result : window_results) {
+		total += window_result.size();
+	}
+	result.reserve_subelements(total);
+	for(const Batch<size_t>& window_result : window_results) {
+		result.push_back(window_result);
+	}
+	return result;
+}
+
+#ifdef GPU
+/*!
+ * Counts the items found by a traversal of an R-tree on the GPU.
+ */
+struct RTreeCountItems {
+	/*!
+	 * The number of items found so far.
+	 */
+	size_t count = 0;
+
+	/*!
+	 * Count another item.
+	 */
+	void operator ()(const size_t) {
+		++count;
+	}
+};
+
+/*!
+ * Writes the items found by a traversal of an R-tree on the GPU to an array.
+ */
+struct RTreeWriteItems {
+	/*!
+	 * Where to write the next item.
+	 */
+	size_t* output;
+
+	/*!
+	 * Write another item.
+	 * \param item The index of the item that was found.
+	 */
+	void operator ()(const size_t item) {
+		*(output++) = item;
+	}
+};
+
+/*!
+ * Implementation of querying an R-tree with many windows that runs on the
+ * graphics card, if available.
+ *
+ * The nodes of the tree are copied to the GPU, and each window is queried by a
+ * separate thread. Since the number of results is not known beforehand, the
+ * tree is traversed twice. The first traversal counts the results of each
+ * window, and the second writes them into one flat array.
+ * \param tree The tree to query.
+ * \param window_minima The minimum corner of each window.
+ * \param window_maxima The maximum corner of each window.
+ * \param num_windows The number of windows to query.
+ * \return For each window, the indices of the items that overlap with it.
+ */
+inline Batch<Batch<size_t>> r_tree_query_gpu(const RTree& tree, const Point2* window_minima, const Point2* window_maxima, const size_t num_windows) {
+	const Point2* minima = tree.data_minima();
+	const Point2* maxima = tree.data_maxima();
+	const size_t* items = tree.data_items();
+	const size_t* level_starts = tree.data_level_starts();
+	const size_t num_nodes = tree.num_nodes();
+	const size_t num_items = tree.size();
+	const size_t num_levels = tree.num_levels();
+
+	std::vector<size_t> starts(num_windows + 1, 0);
+	size_t* starts_data = starts.data();
+	std::vector<size_t> found; //Resized once the number of results is known.
+	#pragma omp target data map(to:minima[0:num_nodes], maxima[0:num_nodes], items[0:num_items], level_starts[0:num_levels + 1], window_minima[0:num_windows], window_maxima[0:num_windows])
+	{
+		#pragma omp target teams distribute parallel for map(from:starts_data[0:num_windows])
+		for(size_t window = 0; window < num_windows; ++window) {
+			RTreeCountItems counter;
+			r_tree_traverse(minima, maxima, items, level_starts, num_levels, window_minima[window], window_maxima[window], counter);
+			starts_data[window] = counter.count;
+		}
+
+		//Turn the counts into the positions where the results of each window start.
+		size_t total = 0;
+		for(size_t window = 0; window <= num_windows; ++window) {
+			const size_t count = starts[window];
+			starts[window] = total;
+			total += count;
+		}
+		found.resize(total);
+		size_t* found_data = found.data();
+
+		#pragma omp target teams distribute parallel for map(to:starts_data[0:num_windows + 1]) map(from:found_data[0:total])
+		for(size_t window = 0; window < num_windows; ++window) {
+			RTreeWriteItems writer{found_data + starts_data[window]};
+			r_tree_traverse(minima, maxima, items, level_starts, num_levels, window_minima[window], window_maxima[window], writer);
+		}
+	}
+
+	Batch<Batch<size_t>> result;
+	result.reserve(num_windows);
+	result.reserve_subelements(found.size());
+	for(size_t window = 0; window < num_windows; ++window) {
+		Batch<size_t> window_result;
+		window_result.reserve(starts[window + 1] - starts[window]);
+		for(size_t position = starts[window]; position < starts[window + 1]; ++position) {
+			window_result.push_back(found[position]);
+		}
+		result.push_back(window_result);
+	}
+	return result;
+}
+#endif //GPU
+
+}
+
+}
+
+#endif //APEX_R_TREE
\ No newline at end of file
@@ -46,6 +46,15 @@ struct PolygonSelfIntersection {
 	 */
 	size_t segment_b;
 
+	/*!
+	 * Construct a placeholder self-intersection, between the first segment and
+	 * itself at the origin.
+	 *
+	 * This is necessary to be able to store self-intersections in batches of
+	 * batches, which preallocate their subelements.
+	 */
+	PolygonSelfIntersection() : location(0, 0), segment_a(0), segment_b(0) {};
+
 	/*!
 	 * Construct a new self-intersection.
 	 * \param location The position of the self-intersection.
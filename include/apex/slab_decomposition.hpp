@@ -0,0 +1,224 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_SLAB_DECOMPOSITION
+#define APEX_SLAB_DECOMPOSITION
+
+#include <algorithm> //For std::min, std::max and std::clamp.
+#include <utility> //To store the bounding box of the polygon.
+#include <vector> //To store the edges in each slab.
+
+#include "batch.hpp" //To query batches of points.
+#include "coordinate.hpp" //To compute slab indices without overflowing.
+#include "detail/geometry_concepts.hpp" //To decompose any type of polygon.
+#include "operations/bounding_box.hpp" //To find the range of the slabs.
+#include "operations/contains.hpp" //To test the edges in a slab.
+#include "point2.hpp" //The vertices of the edges and the points to test.
+
+namespace apex {
+
+/*!
+ * A preprocessed polygon to quickly test whether points are inside of it.
+ *
+ * Testing whether a point is inside of a polygon requires looking at every
+ * edge of the polygon. If the same polygon is tested with very many points,
+ * it pays off to sort the edges first. This divides the height of the polygon
+ * into horizontal slabs of equal height. Each slab stores copies of the edges
+ * that overlap with its vertical range. A point can only be inside of the
+ * polygon or on its border because of edges that span the Y coordinate of
+ * the point, which are all in the slab containing the point. Testing a point
+ * then only needs to look at the edges in one slab, which are stored
+ * contiguously for SIMD processing.
+ *
+ * The results are exactly the same as those of ``contains``, using the nonzero
+ * fill rule and considering points on the border to be inside.
+ *
+ * The number of slabs is proportional to the number of edges. Edges that span
+ * many slabs get copied into each of them. If that would take too much memory,
+ * fewer slabs are used. The slabs are stored in a compressed format, with the
+ * edges of all slabs in one flat array and an array indicating where each slab
+ * starts.
+ *
+ * The decomposition is a copy. It doesn't change if the original polygon is
+ * modified afterwards.
+ */
+class SlabDecomposition {
+public:
+	/*!
+	 * Decomposes a polygon into slabs.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to decompose.
+	 */
+	template<polygonal Polygon>
+	explicit SlabDecomposition(const Polygon& polygon) {
+		const size_t size = polygon.size();
+		slab_starts.assign(2, 0);
+		if(size == 0) {
+			return;
+		}
+		const std::pair<Point2, Point2> box = apex::bounding_box(polygon);
+		minimum = box.first;
+		maximum = box.second;
+		height = area_t(maximum.y) - minimum.y + 1;
+
+		//Choose the number of slabs such that edges don't get copied too often.
+		slabs = std::max(size_t(1), std::min(size / 2, size_t(height)));
+		while(slabs > 1) {
+			size_t total = 0;
+			for(size_t vertex = 0; vertex < size; ++vertex) {
+				const Point2 start = polygon[(vertex + size - 1) % size];
+				const Point2 end = polygon[vertex];
+				total += slab(std::max(start.y, end.y)) - slab(std::min(start.y, end.y)) + 1;
+			}
+			if(total <= max_copies * size) {
+				break;
+			}
+			slabs /= 2;
+		}
+
+		//First count how many edges go into each slab, then store the edges in a flat array with that layout.
+		slab_starts.assign(slabs + 1, 0);
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const Point2 start = polygon[(vertex + size - 1) % size];
+			const Point2 end = polygon[vertex];
+			const size_t last = slab(std::max(start.y, end.y));
+			for(size_t edge_slab = slab(std::min(start.y, end.y)); edge_slab <= last; ++edge_slab) {
+				slab_starts[edge_slab + 1]++;
+			}
+		}
+		for(size_t slab_index = 1; slab_index < slab_starts.size(); ++slab_index) {
+			slab_starts[slab_index] += slab_starts[slab_index - 1];
+		}
+		edge_starts.resize(slab_starts.back());
+		edge_ends.resize(slab_starts.back());
+		std::vector<size_t> slab_fill(slab_starts.begin(), slab_starts.end() - 1); //Where to put the next edge in each slab.
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const Point2 start = polygon[(vertex + size - 1) % size];
+			const Point2 end = polygon[vertex];
+			const size_t last = slab(std::max(start.y, end.y));
+			for(size_t edge_slab = slab(std::min(start.y, end.y)); edge_slab <= last; ++edge_slab) {
+				edge_starts[slab_fill[edge_slab]] = start;
+				edge_ends[slab_fill[edge_slab]] = end;
+				slab_fill[edge_slab]++;
+			}
+		}
+	}
+
+	/*!
+	 * Get the number of slabs that the polygon is divided into.
+	 * \return The number of slabs.
+	 */
+	size_t num_slabs() const {
+		return slabs;
+	}
+
+	/*!
+	 * Get the number of edges stored in a slab.
+	 * \param index The index of the slab, counting from the bottom.
+	 * \return The number of edges that overlap with the slab.
+	 */
+	size_t slab_size(const size_t index) const {
+		return slab_starts[index + 1] - slab_starts[index];
+	}
+
+	/*!
+	 * Tests whether a point is inside of the polygon.
+	 * \param point The point to test.
+	 * \return ``true`` if the point is inside of the polygon or on its border,
+	 * or ``false`` if it is outside.
+	 */
+	bool contains(const Point2& point) const {
+		if(point.x < minimum.x || point.x > maximum.x || point.y < minimum.y || point.y > maximum.y || edge_starts.empty()) {
+			return false; //Outside of the bounding box.
+		}
+		const size_t index = slab(point.y);
+		return detail::contains_edges(edge_starts.data() + slab_starts[index], edge_ends.data() + slab_starts[index], slab_size(index), point);
+	}
+
+	/*!
+	 * Tests for each of a batch of points whether it is inside of the polygon.
+	 *
+	 * The points are divided over multiple threads.
+	 * \param points The points to test.
+	 * \return For each point, in the same order, whether it is inside of the
+	 * polygon or on its border.
+	 */
+	Batch<bool> contains(const Batch<Point2>& points) const {
+		std::vector<char> inside(points.size()); //Not booleans, since those are packed into bits that can't be written to in parallel.
+		#pragma omp parallel for
+		for(size_t point = 0; point < points.size(); ++point) {
+			inside[point] = contains(points[point]);
+		}
+		return Batch<bool>(inside.begin(), inside.end());
+	}
+
+protected:
+	/*!
+	 * Edges are copied into at most this many slabs on average.
+	 *
+	 * If the edges would need to be copied more often, fewer slabs are used.
+	 */
+	static constexpr size_t max_copies = 8;
+
+	/*!
+	 * The minimum corner of the bounding box of the polygon.
+	 */
+	Point2 minimum;
+
+	/*!
+	 * The maximum corner of the bounding box of the polygon.
+	 */
+	Point2 maximum;
+
+	/*!
+	 * The height of the bounding box of the polygon, including both the bottom
+	 * and the top row of coordinates.
+	 */
+	area_t height = 1;
+
+	/*!
+	 * The number of slabs.
+	 */
+	size_t slabs = 1;
+
+	/*!
+	 * For each slab, where its edges start in \ref edge_starts and
+	 * \ref edge_ends.
+	 *
+	 * This contains one extra element at the end, indicating the end of the
+	 * last slab.
+	 */
+	std::vector<size_t> slab_starts;
+
+	/*!
+	 * The start points of the edges of all slabs, stored slab after slab.
+	 */
+	std::vector<Point2> edge_starts;
+
+	/*!
+	 * The end points of the edges of all slabs, in the same order as
+	 * \ref edge_starts.
+	 */
+	std::vector<Point2> edge_ends;
+
+	/*!
+	 * Get the slab that contains a certain Y coordinate.
+	 *
+	 * Coordinates outside of the polygon are clamped to the nearest slab.
+	 * \param y The Y coordinate to find the slab of.
+	 * \return The index of the slab containing that Y coordinate.
+	 */
+	size_t slab(const coord_t y) const {
+		const area_t offset = std::clamp(area_t(y) - minimum.y, area_t(0), height - 1);
+		return offset * slabs / height;
+	}
+};
+
+}
+
+#endif //APEX_SLAB_DECOMPOSITION
\ No newline at end of file
@@ -0,0 +1,592 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_SOA_POLYGON
+#define APEX_SOA_POLYGON
+
+#include <initializer_list> //To construct polygons from a list of vertices.
+
+#include "batch.hpp" //To store the coordinates.
+#include "coordinate.hpp" //To store coordinates.
+#include "detail/geometry_concepts.hpp" //To convert from any type of polygon.
+#include "operations/area.hpp" //To allow calculating the area of this shape.
+#include "operations/bounding_box.hpp" //To allow calculating the bounding box of this shape.
+#include "operations/transform.hpp" //To allow transforming this shape.
+#include "operations/translate.hpp" //To allow moving this shape.
+#include "point2.hpp" //To access the vertices as points.
+#include "polygon.hpp" //To convert to normal polygons.
+
+namespace apex {
+
+/*!
+ * A polygon that stores its vertices as a structure of arrays.
+ *
+ * The normal \ref Polygon stores its vertices as an array of points, where the
+ * X and Y coordinates of each vertex are interleaved. This polygon instead
+ * stores the X coordinates of all vertices in one array, and the Y coordinates
+ * in another. Algorithms that process many vertices at once can then load the
+ * coordinates of consecutive vertices into vector registers directly, rather
+ * than having to gather them from strided memory. This is faster for
+ * memory-bound algorithms, such as computing the area or translating.
+ *
+ * The polygon behaves like a normal polygon when reading its vertices. However
+ * accessing a vertex creates a new point, so vertices can't be modified via
+ * references. To modify a vertex, use \ref set.
+ *
+ * Operations that have a specialised implementation for this storage layout
+ * will use it automatically. Other operations will use their general
+ * implementation, reading the vertices one by one.
+ */
+class SoAPolygon {
+public:
+	/*!
+	 * Constructs an empty polygon, without any vertices.
+	 */
+	SoAPolygon() noexcept {}
+
+	/*!
+	 * Constructs a polygon, filled with the vertices from this initialiser
+	 * list.
+	 * \param vertices The vertices to add to the polygon.
+	 */
+	SoAPolygon(const std::initializer_list<Point2>& vertices) {
+		reserve(vertices.size());
+		for(const Point2& vertex : vertices) {
+			push_back(vertex);
+		}
+	}
+
+	/*!
+	 * Converts any other type of polygon into a polygon that stores its
+	 * vertices as a structure of arrays.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to convert.
+	 */
+	template<polygonal Polygon>
+	explicit SoAPolygon(const Polygon& polygon) {
+		const size_t size = polygon.size();
+		x.resize(size);
+		y.resize(size);
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const Point2 point = polygon[vertex];
+			x[vertex] = point.x;
+			y[vertex] = point.y;
+		}
+	}
+
+	/*!
+	 * Tests whether this polygon has the same vertices as another, in the same
+	 * order.
+	 *
+	 * Unlike normal polygons, this doesn't try to match polygons that start at
+	 * a different vertex.
+	 * \param other The polygon to compare to.
+	 * \return ``true`` if the polygons have the same vertices in the same
+	 * order, or ``false`` otherwise.
+	 */
+	bool operator ==(const SoAPolygon& other) const {
+		return x == other.x && y == other.y;
+	}
+
+	/*!
+	 * Gets a copy of a vertex of the polygon.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at that index.
+	 */
+	Point2 operator [](const size_t index) const {
+		return Point2(x[index], y[index]);
+	}
+
+	/*!
+	 * Computes the surface area of the polygon.
+	 *
+	 * The sign of the area is linked to the polygon winding order. If the
+	 * polygon is positive, the area will be positive too, and vice versa. If
+	 * the polygon intersects itself, parts of the polygon will be subtracting
+	 * from the area while other parts add up to the area.
+	 * \return The surface area of the polygon.
+	 */
+	area_t area() const {
+		return apex::area(*this);
+	}
+
+	/*!
+	 * Computes the axis-aligned bounding box of the polygon.
+	 *
+	 * For an empty polygon, the bounding box is empty, with both corners at the
+	 * origin.
+	 * \return The minimum and maximum corner of the bounding box, in that
+	 * order.
+	 */
+	std::pair<Point2, Point2> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Removes all vertices from the polygon.
+	 */
+	void clear() noexcept {
+		x.clear();
+		y.clear();
+	}
+
+	/*!
+	 * Gets a pointer to the X coordinates of all vertices.
+	 * \return A pointer to an array with the X coordinate of each vertex.
+	 */
+	coord_t* data_x() noexcept {
+		return x.data();
+	}
+
+	/*!
+	 * Gets a pointer to the X coordinates of all vertices.
+	 * \return A pointer to an array with the X coordinate of each vertex.
+	 */
+	const coord_t* data_x() const noexcept {
+		return x.data();
+	}
+
+	/*!
+	 * Gets a pointer to the Y coordinates of all vertices.
+	 * \return A pointer to an array with the Y coordinate of each vertex.
+	 */
+	coord_t* data_y() noexcept {
+		return y.data();
+	}
+
+	/*!
+	 * Gets a pointer to the Y coordinates of all vertices.
+	 * \return A pointer to an array with the Y coordinate of each vertex.
+	 */
+	const coord_t* data_y() const noexcept {
+		return y.data();
+	}
+
+	/*!
+	 * Adds a vertex at the end of the polygon.
+	 * \param x The X coordinate of the new vertex.
+	 * \param y The Y coordinate of the new vertex.
+	 */
+	void emplace_back(const coord_t x, const coord_t y) {
+		this->x.push_back(x);
+		this->y.push_back(y);
+	}
+
+	/*!
+	 * Checks whether the polygon has any vertices.
+	 * \return ``true`` if the polygon has no vertices, or ``false`` if it has.
+	 */
+	bool empty() const noexcept {
+		return x.empty();
+	}
+
+	/*!
+	 * Adds a vertex at the end of the polygon.
+	 * \param vertex The vertex to add.
+	 */
+	void push_back(const Point2& vertex) {
+		x.push_back(vertex.x);
+		y.push_back(vertex.y);
+	}
+
+	/*!
+	 * Reserves memory for a number of vertices.
+	 * \param new_capacity The number of vertices to reserve memory for.
+	 */
+	void reserve(const size_t new_capacity) {
+		x.reserve(new_capacity);
+		y.reserve(new_capacity);
+	}
+
+	/*!
+	 * Changes the position of a vertex.
+	 * \param index The index of the vertex to change.
+	 * \param vertex The new position of the vertex.
+	 */
+	void set(const size_t index, const Point2& vertex) {
+		x[index] = vertex.x;
+		y[index] = vertex.y;
+	}
+
+	/*!
+	 * Gets the number of vertices in the polygon.
+	 * \return The number of vertices in the polygon.
+	 */
+	size_t size() const noexcept {
+		return x.size();
+	}
+
+	/*!
+	 * Converts this polygon to a normal polygon, which stores its vertices as
+	 * an array of points.
+	 * \return A polygon with the same vertices.
+	 */
+	Polygon to_polygon() const {
+		Polygon result;
+		result.resize(size());
+		for(size_t vertex = 0; vertex < size(); ++vertex) {
+			result[vertex] = (*this)[vertex];
+		}
+		return result;
+	}
+
+	/*!
+	 * Transforms the polygon with an affine transformation.
+	 *
+	 * The polygon is transformed in-place.
+	 * \param transformation The transformation to perform on each vertex.
+	 */
+	void transform(const AffineTransform& transformation) {
+		apex::transform(*this, transformation);
+	}
+
+	/*!
+	 * Moves the polygon with a certain offset.
+	 *
+	 * The polygon is moved in-place.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 */
+	void translate(const Point2& delta) {
+		apex::translate(*this, delta);
+	}
+
+protected:
+	/*!
+	 * The X coordinates of all vertices.
+	 */
+	Batch<coord_t> x;
+
+	/*!
+	 * The Y coordinates of all vertices.
+	 */
+	Batch<coord_t> y;
+};
+
+/*!
+ * A read-only view on one polygon in a batch of polygons that store their
+ * vertices as a structure of arrays.
+ *
+ * The view refers to the coordinate arrays of the batch, so it becomes invalid
+ * when the batch is modified or destroyed.
+ */
+class SoAPolygonView {
+public:
+	/*!
+	 * Creates a view on a range of the coordinate arrays of a batch.
+	 * \param x The X coordinates of the vertices of the polygon.
+	 * \param y The Y coordinates of the vertices of the polygon.
+	 * \param size The number of vertices in the polygon.
+	 */
+	SoAPolygonView(const coord_t* x, const coord_t* y, const size_t size) : x(x), y(y), count(size) {}
+
+	/*!
+	 * Gets a copy of a vertex of the polygon.
+	 * \param index The index of the vertex to get.
+	 * \return The vertex at that index.
+	 */
+	Point2 operator [](const size_t index) const {
+		return Point2(x[index], y[index]);
+	}
+
+	/*!
+	 * Gets a pointer to the X coordinates of all vertices.
+	 * \return A pointer to an array with the X coordinate of each vertex.
+	 */
+	const coord_t* data_x() const noexcept {
+		return x;
+	}
+
+	/*!
+	 * Gets a pointer to the Y coordinates of all vertices.
+	 * \return A pointer to an array with the Y coordinate of each vertex.
+	 */
+	const coord_t* data_y() const noexcept {
+		return y;
+	}
+
+	/*!
+	 * Checks whether the polygon has any vertices.
+	 * \return ``true`` if the polygon has no vertices, or ``false`` if it has.
+	 */
+	bool empty() const noexcept {
+		return count == 0;
+	}
+
+	/*!
+	 * Gets the number of vertices in the polygon.
+	 * \return The number of vertices in the polygon.
+	 */
+	size_t size() const noexcept {
+		return count;
+	}
+
+protected:
+	/*!
+	 * The X coordinates of the vertices of the polygon.
+	 */
+	const coord_t* x;
+
+	/*!
+	 * The Y coordinates of the vertices of the polygon.
+	 */
+	const coord_t* y;
+
+	/*!
+	 * The number of vertices in the polygon.
+	 */
+	size_t count;
+};
+
+/*!
+ * A batch of polygons that stores the vertices of all polygons as a structure
+ * of arrays.
+ *
+ * The X coordinates of all vertices of all polygons are stored in one array,
+ * and the Y coordinates in another. The polygons are stored consecutively in
+ * those arrays, without any gaps. A third array indicates where each polygon
+ * starts, with one extra element at the end. Algorithms can then process all
+ * coordinates of the batch in one go, and load consecutive coordinates into
+ * vector registers directly.
+ *
+ * Since there are no gaps between the polygons, polygons can only be added at
+ * the end. The vertices of the polygons can be read through views, but to
+ * modify them, convert the batch back to normal polygons.
+ */
+template<>
+class Batch<SoAPolygon> {
+public:
+	/*!
+	 * Creates an empty batch.
+	 */
+	Batch() : starts({0}) {}
+
+	/*!
+	 * Converts any other batch of polygons into a batch that stores its
+	 * vertices as a structure of arrays.
+	 * \tparam PolygonBatch A class that behaves like a batch of polygons.
+	 * \param batch The batch of polygons to convert.
+	 */
+	template<multi_polygonal PolygonBatch>
+	explicit Batch(const PolygonBatch& batch) : starts({0}) {
+		starts.reserve(batch.size() + 1);
+		size_t total = 0;
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			total += batch[polygon].size();
+			starts.push_back(total);
+		}
+		x.resize(total);
+		y.resize(total);
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const auto& original = batch[polygon]; //Instantiates auto with whatever type the batch indexes.
+			for(size_t vertex = 0; vertex < original.size(); ++vertex) {
+				const Point2 point = original[vertex];
+				x[starts[polygon] + vertex] = point.x;
+				y[starts[polygon] + vertex] = point.y;
+			}
+		}
+	}
+
+	/*!
+	 * Gets a view on one of the polygons in the batch.
+	 * \param index The index of the polygon to get.
+	 * \return A view on the polygon at that index.
+	 */
+	SoAPolygonView operator [](const size_t index) const {
+		return SoAPolygonView(x.data() + starts[index], y.data() + starts[index], starts[index + 1] - starts[index]);
+	}
+
+	/*!
+	 * Computes the surface area of the polygons in this batch.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the areas of each polygon in the same order.
+	 */
+	Batch<area_t> area() const {
+		return apex::area(*this);
+	}
+
+	/*!
+	 * Computes the axis-aligned bounding boxes of the polygons in this batch.
+	 * \return A list, equally long to the number of polygons in this batch,
+	 * that lists the minimum and maximum corner of the bounding box of each
+	 * polygon in the same order.
+	 */
+	Batch<std::pair<Point2, Point2>> bounding_box() const {
+		return apex::bounding_box(*this);
+	}
+
+	/*!
+	 * Removes all polygons from the batch.
+	 */
+	void clear() noexcept {
+		x.clear();
+		y.clear();
+		starts.resize(1);
+	}
+
+	/*!
+	 * Gets a pointer to the index in the coordinate arrays where each polygon
+	 * starts.
+	 *
+	 * This array has one extra element at the end, which indicates where the
+	 * last polygon ends.
+	 * \return A pointer to an array with the start of each polygon.
+	 */
+	const size_t* data_starts() const noexcept {
+		return starts.data();
+	}
+
+	/*!
+	 * Gets a pointer to the X coordinates of all vertices of all polygons.
+	 * \return A pointer to an array with the X coordinate of each vertex.
+	 */
+	coord_t* data_x() noexcept {
+		return x.data();
+	}
+
+	/*!
+	 * Gets a pointer to the X coordinates of all vertices of all polygons.
+	 * \return A pointer to an array with the X coordinate of each vertex.
+	 */
+	const coord_t* data_x() const noexcept {
+		return x.data();
+	}
+
+	/*!
+	 * Gets a pointer to the Y coordinates of all vertices of all polygons.
+	 * \return A pointer to an array with the Y coordinate of each vertex.
+	 */
+	coord_t* data_y() noexcept {
+		return y.data();
+	}
+
+	/*!
+	 * Gets a pointer to the Y coordinates of all vertices of all polygons.
+	 * \return A pointer to an array with the Y coordinate of each vertex.
+	 */
+	const coord_t* data_y() const noexcept {
+		return y.data();
+	}
+
+	/*!
+	 * Checks whether the batch has any polygons.
+	 * \return ``true`` if the batch has no polygons, or ``false`` if it has.
+	 */
+	bool empty() const noexcept {
+		return size() == 0;
+	}
+
+	/*!
+	 * Adds a polygon at the end of the batch.
+	 * \tparam Polygon A class that behaves like a polygon.
+	 * \param polygon The polygon to add.
+	 */
+	template<polygonal Polygon>
+	void push_back(const Polygon& polygon) {
+		const size_t size = polygon.size();
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			const Point2 point = polygon[vertex];
+			x.push_back(point.x);
+			y.push_back(point.y);
+		}
+		starts.push_back(x.size());
+	}
+
+	/*!
+	 * Reserves memory for a number of polygons and vertices.
+	 * \param num_polygons The number of polygons to reserve memory for.
+	 * \param num_vertices The total number of vertices to reserve memory for.
+	 */
+	void reserve(const size_t num_polygons, const size_t num_vertices) {
+		starts.reserve(num_polygons + 1);
+		x.reserve(num_vertices);
+		y.reserve(num_vertices);
+	}
+
+	/*!
+	 * Gets the number of polygons in the batch.
+	 * \return The number of polygons in the batch.
+	 */
+	size_t size() const noexcept {
+		return starts.size() - 1;
+	}
+
+	/*!
+	 * Gets the total number of vertices of all polygons in the batch.
+	 *
+	 * This is the length of the coordinate arrays.
+	 * \return The total number of vertices in the batch.
+	 */
+	size_t size_subelements() const noexcept {
+		return x.size();
+	}
+
+	/*!
+	 * Converts this batch to a normal batch of polygons, which store their
+	 * vertices as arrays of points.
+	 * \return A batch of polygons with the same vertices.
+	 */
+	Batch<Polygon> to_polygons() const {
+		Batch<Polygon> result;
+		result.reserve(size());
+		result.reserve_subelements(size_subelements());
+		for(size_t polygon = 0; polygon < size(); ++polygon) {
+			result.emplace_back();
+			const SoAPolygonView view = (*this)[polygon];
+			for(size_t vertex = 0; vertex < view.size(); ++vertex) {
+				result.back().push_back(view[vertex]);
+			}
+		}
+		return result;
+	}
+
+	/*!
+	 * Transforms all polygons in this batch with the same affine
+	 * transformation.
+	 *
+	 * The polygons are transformed in-place.
+	 * \param transformation The transformation to perform on each vertex.
+	 */
+	void transform(const AffineTransform& transformation) {
+		apex::transform(*this, transformation);
+	}
+
+	/*!
+	 * Moves all polygons in this batch with the same offset.
+	 *
+	 * The polygons are moved in-place.
+	 * \param delta The distance by which to move, representing both dimensions
+	 * to move through as a single 2D vector.
+	 */
+	void translate(const Point2& delta) {
+		apex::translate(*this, delta);
+	}
+
+protected:
+	/*!
+	 * The X coordinates of all vertices of all polygons.
+	 */
+	Batch<coord_t> x;
+
+	/*!
+	 * The Y coordinates of all vertices of all polygons.
+	 */
+	Batch<coord_t> y;
+
+	/*!
+	 * For each polygon, the index in the coordinate arrays where it starts.
+	 *
+	 * This contains one extra element at the end, indicating where the last
+	 * polygon ends.
+	 */
+	Batch<size_t> starts;
+};
+
+}
+
+#endif //APEX_SOA_POLYGON
\ No newline at end of file
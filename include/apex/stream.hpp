@@ -0,0 +1,239 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_STREAM
+#define APEX_STREAM
+
+#include <algorithm> //For std::copy and std::max.
+#include <concepts> //To define what sources of polygons, processing steps and sinks are.
+#include <future> //To load the next chunk while processing the current one.
+#include <limits> //To detect whether the memory on the GPU is limited.
+#include <vector> //To store the sizes of the polygons in a chunk.
+
+#include "batch.hpp" //To return batches of results.
+#include "coordinate.hpp" //To stream areas.
+#include "detail/geometry_concepts.hpp" //To read chunks from any batch of polygons.
+#include "detail/gpu_data_tracker.hpp" //To choose the size of the chunks from the memory budget on the GPU.
+#include "detail/polygon_properties.hpp" //To copy the cached properties along with the polygons.
+#include "operations/self_intersections.hpp" //To stream self-intersections.
+#include "point2.hpp" //To compute the size of the vertices in a chunk.
+#include "polygon.hpp" //To hold the polygons of each chunk.
+#include "self_intersection.hpp" //To stream self-intersections.
+
+namespace apex {
+
+/*!
+ * A concept for sources that provide polygons in chunks, for processing sets
+ * of polygons that don't fit in memory at once.
+ *
+ * The source replaces the contents of the given batch with its next polygons,
+ * which together have at most the given number of vertices. Only if a single
+ * polygon has more vertices than that, this polygon is provided alone. Once the
+ * source has no more polygons, it returns ``false``.
+ *
+ * The next chunk is requested from a different thread than the one processing
+ * the previous chunk, but never from multiple threads at once.
+ */
+template<typename T>
+concept polygon_source = requires(T source, Batch<Polygon>& chunk, const size_t max_vertices) {
+	{ source.next_chunk(chunk, max_vertices) } -> std::convertible_to<bool>;
+};
+
+/*!
+ * A source of polygons that provides the polygons of a batch in chunks.
+ *
+ * The batch may be any batch of polygons, such as a ``MappedPolygonBatch``.
+ * With a mapped file, reading a chunk makes the operating system read that
+ * part of the file from disk, so that the file doesn't need to fit in memory.
+ * The properties that are cached for the polygons are copied along.
+ * \tparam PolygonBatch A class that behaves like a batch of polygons.
+ */
+template<multi_polygonal PolygonBatch>
+class BatchChunks {
+public:
+	/*!
+	 * Creates a source that provides the polygons of a batch.
+	 *
+	 * The batch is not copied. It must stay alive as long as this source is
+	 * used.
+	 * \param batch The batch to provide the polygons of.
+	 */
+	explicit BatchChunks(const PolygonBatch& batch) : batch(batch), position(0) {}
+
+	/*!
+	 * Replaces the contents of a batch with the next polygons of the source.
+	 * \param chunk The batch to put the next polygons in.
+	 * \param max_vertices The maximum number of vertices to put in the chunk,
+	 * unless a single polygon has more vertices.
+	 * \return ``true`` if there were any polygons left to put in the chunk, or
+	 * ``false`` if the source has provided all of its polygons.
+	 */
+	bool next_chunk(Batch<Polygon>& chunk, const size_t max_vertices) {
+		//Take as many polygons as fit, but at least one.
+		std::vector<size_t> sizes;
+		size_t num_vertices = 0;
+		while(position + sizes.size() < batch.size()) {
+			const size_t size = batch[position + sizes.size()].size();
+			if(!sizes.empty() && num_vertices + size > max_vertices) {
+				break;
+			}
+			num_vertices += size;
+			sizes.push_back(size);
+		}
+		if(sizes.empty()) {
+			return false;
+		}
+
+		chunk.assign_sizes(sizes); //Reuses the vertex buffer of the previous chunk, if it's big enough.
+		const Batch<Polygon>::iterator polygons = chunk.begin(); //Fill through an iterator, since accessing the batch forgets the cached properties.
+		for(size_t polygon = 0; polygon < sizes.size(); ++polygon) {
+			if(sizes[polygon] > 0) {
+				const Point2* vertices = &batch[position + polygon][0];
+				std::copy(vertices, vertices + sizes[polygon], polygons[polygon].begin());
+			}
+		}
+		if constexpr(caches_batch_properties<PolygonBatch>) {
+			for(size_t polygon = 0; polygon < sizes.size(); ++polygon) {
+				const PolygonProperties properties = batch.get_properties(position + polygon);
+				if(properties.bitfield != 0) { //Only allocate the cache if anything is known.
+					chunk.set_properties(polygon, properties);
+				}
+			}
+		}
+		position += sizes.size();
+		return true;
+	}
+
+protected:
+	/*!
+	 * The batch to provide the polygons of.
+	 */
+	const PolygonBatch& batch;
+
+	/*!
+	 * The index of the next polygon to provide.
+	 */
+	size_t position;
+};
+
+namespace detail {
+
+/*!
+ * The number of vertices in each chunk, if the memory on the GPU is not
+ * limited.
+ *
+ * This is 8MB of vertices, big enough that the overhead of each chunk is
+ * negligible and that each chunk can be processed on multiple threads.
+ */
+constexpr size_t default_chunk_vertices = 1 << 20;
+
+/*!
+ * Chooses how many vertices to put in each chunk when streaming polygons.
+ *
+ * The chunks are double-buffered, so two chunks need to fit in memory at the
+ * same time. If the ``GPUDataTracker`` is given a memory budget, the chunks
+ * are sized such that both fit in that budget. That way, the previous chunk
+ * doesn't need to be evicted from the GPU to make room for the next one.
+ * \return The maximum number of vertices to put in each chunk.
+ */
+inline size_t stream_chunk_size() {
+	const size_t budget = GPUDataTracker::get_memory_budget();
+	if(budget == std::numeric_limits<size_t>::max()) {
+		return default_chunk_vertices;
+	}
+	return std::max(size_t(1), budget / (2 * sizeof(Point2)));
+}
+
+}
+
+/*!
+ * Processes the polygons of a source in chunks, loading the next chunk while
+ * processing the current one.
+ *
+ * This allows processing sets of polygons that don't fit in memory, or in the
+ * memory of the GPU. Only two chunks are in memory at any time. While one chunk
+ * is processed, the next chunk is loaded by a separate thread. The processing
+ * itself can use all threads and the GPU, as the operations normally do.
+ *
+ * The processing step may run any chain of operations on each chunk. It is
+ * given the chunk, and the index of the first polygon of that chunk among all
+ * polygons of the source. The chunk may be modified, but the processing step
+ * must not keep any references to it, since the chunk is reused afterwards.
+ * \tparam Source A source that provides polygons in chunks.
+ * \tparam Process A function to call on each chunk.
+ * \param source The source of the polygons to process.
+ * \param process The function to call on each chunk, with the chunk and the
+ * index of its first polygon.
+ * \param chunk_vertices The maximum number of vertices in each chunk. If this is
+ * 0, it is chosen automatically from the memory budget of the GPU.
+ */
+template<polygon_source Source, std::invocable<Batch<Polygon>&, size_t> Process>
+void stream(Source& source, Process&& process, size_t chunk_vertices = 0) {
+	if(chunk_vertices == 0) {
+		chunk_vertices = detail::stream_chunk_size();
+	}
+	Batch<Polygon> current;
+	Batch<Polygon> next; //Declared before the loading task, so that it outlives the task if the processing throws.
+	bool has_current = source.next_chunk(current, chunk_vertices);
+	size_t first_polygon = 0;
+	while(has_current) {
+		std::future<bool> loading = std::async(std::launch::async, [&source, &next, chunk_vertices]() {
+			return static_cast<bool>(source.next_chunk(next, chunk_vertices));
+		});
+		process(current, first_polygon);
+		first_polygon += current.size();
+		has_current = loading.get();
+		current.swap(next);
+	}
+}
+
+/*!
+ * Computes the areas of the polygons of a source, chunk by chunk.
+ *
+ * See \ref stream for how the chunks are processed. The areas of each chunk are
+ * given to the sink as soon as they are computed.
+ * \tparam Source A source that provides polygons in chunks.
+ * \tparam Sink A function to call with the areas of each chunk.
+ * \param source The source of the polygons to compute the areas of.
+ * \param sink The function to call with the areas of each chunk, in the same
+ * order as the polygons in the chunk, and the index of the first polygon of
+ * the chunk.
+ * \param chunk_vertices The maximum number of vertices in each chunk. If this is
+ * 0, it is chosen automatically from the memory budget of the GPU.
+ */
+template<polygon_source Source, std::invocable<Batch<area_t>&&, size_t> Sink>
+void stream_area(Source& source, Sink&& sink, const size_t chunk_vertices = 0) {
+	stream(source, [&sink](Batch<Polygon>& chunk, const size_t first_polygon) {
+		sink(chunk.area(), first_polygon);
+	}, chunk_vertices);
+}
+
+/*!
+ * Finds the self-intersections in the polygons of a source, chunk by chunk.
+ *
+ * See \ref stream for how the chunks are processed. The self-intersections of
+ * each chunk are given to the sink as soon as they are found.
+ * \tparam Source A source that provides polygons in chunks.
+ * \tparam Sink A function to call with the self-intersections of each chunk.
+ * \param source The source of the polygons to find self-intersections in.
+ * \param sink The function to call with, for each polygon of a chunk, a batch
+ * of the self-intersections in that polygon, and the index of the first
+ * polygon of the chunk.
+ * \param chunk_vertices The maximum number of vertices in each chunk. If this is
+ * 0, it is chosen automatically from the memory budget of the GPU.
+ */
+template<polygon_source Source, std::invocable<Batch<Batch<PolygonSelfIntersection>>&&, size_t> Sink>
+void stream_self_intersections(Source& source, Sink&& sink, const size_t chunk_vertices = 0) {
+	stream(source, [&sink](Batch<Polygon>& chunk, const size_t first_polygon) {
+		sink(self_intersections(chunk), first_polygon);
+	}, chunk_vertices);
+}
+
+}
+
+#endif //APEX_STREAM
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <cmath> //To compute the expected results of rotations.
+#include <gtest/gtest.h> //To run the test.
+#include <limits> //To test saturating to the range of coordinates.
+#include <numbers> //To rotate by fractions of a turn.
+
+#include "apex/affine_transform.hpp" //The code under test.
+#include "apex/point2.hpp" //To transform points.
+
+namespace apex {
+
+/*!
+ * Test that the default transformation doesn't change any points.
+ */
+TEST(AffineTransform, Identity) {
+	const AffineTransform identity;
+	EXPECT_EQ(identity.apply(Point2(0, 0)), Point2(0, 0));
+	EXPECT_EQ(identity.apply(Point2(123, -456)), Point2(123, -456));
+	EXPECT_EQ(identity.apply(Point2(std::numeric_limits<coord_t>::min(), std::numeric_limits<coord_t>::max())), Point2(std::numeric_limits<coord_t>::min(), std::numeric_limits<coord_t>::max())) << "The extremes of the coordinate space must stay the same.";
+	EXPECT_EQ(AffineTransform::scaling(1), identity) << "Scaling by 1 is the same as the identity transformation.";
+	EXPECT_EQ(AffineTransform::rotation(0), identity) << "Rotating by 0 is the same as the identity transformation.";
+}
+
+/*!
+ * Test translating points.
+ */
+TEST(AffineTransform, Translation) {
+	const AffineTransform translation = AffineTransform::translation(Point2(10, -20));
+	EXPECT_EQ(translation.apply(Point2(0, 0)), Point2(10, -20));
+	EXPECT_EQ(translation.apply(Point2(-10, 20)), Point2(0, 0));
+}
+
+/*!
+ * Test scaling by integer factors, which must be exact.
+ */
+TEST(AffineTransform, ScalingInteger) {
+	const AffineTransform scaling = AffineTransform::scaling(3, -2);
+	EXPECT_EQ(scaling.fraction_bits, 0) << "Integer scales don't need any fraction bits.";
+	EXPECT_EQ(scaling.apply(Point2(100, 100)), Point2(300, -200));
+	EXPECT_EQ(scaling.apply(Point2(-7, 5)), Point2(-21, -10));
+}
+
+/*!
+ * Test scaling by fractional factors, which must round to the nearest
+ * coordinate.
+ */
+TEST(AffineTransform, ScalingFraction) {
+	const AffineTransform half = AffineTransform::scaling(0.5);
+	EXPECT_EQ(half.fraction_bits, 1) << "Halving only needs one fraction bit.";
+	EXPECT_EQ(half.apply(Point2(10, 11)), Point2(5, 6)) << "Halfway must be rounded away from zero.";
+	EXPECT_EQ(half.apply(Point2(-10, -11)), Point2(-5, -6)) << "Halfway must be rounded away from zero, also in the negatives.";
+
+	const AffineTransform third = AffineTransform::scaling(1.0 / 3.0);
+	EXPECT_EQ(third.apply(Point2(300000000, -300000000)), Point2(100000000, -100000000)) << "The precision must be enough to scale big coordinates accurately.";
+}
+
+/*!
+ * Test rotating by a quarter turn, which must be exact.
+ */
+TEST(AffineTransform, RotationQuarter) {
+	const AffineTransform rotation = AffineTransform::rotation(std::numbers::pi / 2);
+	EXPECT_EQ(rotation, AffineTransform(0, -1, 1, 0)) << "The rounding errors of the sine and cosine must disappear when they are quantised.";
+	EXPECT_EQ(rotation.apply(Point2(100, 0)), Point2(0, 100)) << "Positive angles rotate counter-clockwise.";
+	EXPECT_EQ(rotation.apply(Point2(0, 100)), Point2(-100, 0)) << "Positive angles rotate counter-clockwise.";
+}
+
+/*!
+ * Test rotating by an arbitrary angle, compared to computing it in floating
+ * point.
+ */
+TEST(AffineTransform, RotationArbitrary) {
+	const double angle = 0.4;
+	const AffineTransform rotation = AffineTransform::rotation(angle);
+	for(const Point2& point : {Point2(1000, 0), Point2(-31337, 1337), Point2(1000000000, 1000000000)}) {
+		const Point2 result = rotation.apply(point);
+		EXPECT_NEAR(result.x, std::cos(angle) * point.x - std::sin(angle) * point.y, 3) << "The result must be accurate up to rounding, even for big coordinates.";
+		EXPECT_NEAR(result.y, std::sin(angle) * point.x + std::cos(angle) * point.y, 3) << "The result must be accurate up to rounding, even for big coordinates.";
+	}
+}
+
+/*!
+ * Test transforming with a general matrix, including a translation after the
+ * linear part.
+ */
+TEST(AffineTransform, Matrix) {
+	const AffineTransform shear = AffineTransform::matrix(1, 2, 0, 1, Point2(5, 5));
+	EXPECT_EQ(shear.apply(Point2(10, 10)), Point2(35, 15));
+}
+
+/*!
+ * Test composing transformations.
+ *
+ * The composition must transform points the same way as performing the
+ * transformations one after another, up to rounding.
+ */
+TEST(AffineTransform, Compose) {
+	const AffineTransform first = AffineTransform::rotation(0.3);
+	const AffineTransform second = AffineTransform::translation(Point2(500, -200));
+	const AffineTransform third = AffineTransform::scaling(1.7, 0.9);
+	const AffineTransform composed = first.then(second).then(third);
+	for(const Point2& point : {Point2(0, 0), Point2(1000, 0), Point2(-31337, 1337), Point2(1000000, -2000000)}) {
+		const Point2 separately = third.apply(second.apply(first.apply(point)));
+		const Point2 together = composed.apply(point);
+		EXPECT_NEAR(together.x, separately.x, 2);
+		EXPECT_NEAR(together.y, separately.y, 2);
+	}
+}
+
+/*!
+ * Test that composing a transformation with its inverse gives the identity
+ * transformation.
+ */
+TEST(AffineTransform, ComposeInverse) {
+	EXPECT_EQ(AffineTransform::scaling(4).then(AffineTransform::scaling(0.25)), AffineTransform()) << "The redundant fraction bits must be removed, so that this compares equal to the identity.";
+	EXPECT_EQ(AffineTransform::translation(Point2(5, 6)).then(AffineTransform::translation(Point2(-5, -6))), AffineTransform());
+	EXPECT_EQ(AffineTransform::rotation(std::numbers::pi / 2).then(AffineTransform::rotation(-std::numbers::pi / 2)), AffineTransform());
+}
+
+/*!
+ * Test that results outside of the coordinate space are saturated, rather than
+ * overflowing.
+ */
+TEST(AffineTransform, Saturate) {
+	const coord_t maximum = std::numeric_limits<coord_t>::max();
+	const coord_t minimum = std::numeric_limits<coord_t>::min();
+	const AffineTransform scaling = AffineTransform::scaling(1000000);
+	EXPECT_EQ(scaling.apply(Point2(maximum, minimum)), Point2(maximum, minimum)) << "The result must be saturated to the extremes of the coordinate space.";
+	EXPECT_EQ(scaling.apply(Point2(-5, 3)), Point2(-5000000, 3000000)) << "Coordinates that fit must not be affected.";
+
+	const AffineTransform huge = AffineTransform::scaling(1e30); //Doesn't fit the coefficients either.
+	EXPECT_EQ(huge.xx, max_transform_coefficient) << "The coefficients must be saturated.";
+	EXPECT_EQ(huge.apply(Point2(10, -10)), Point2(maximum, minimum));
+
+	const AffineTransform far = AffineTransform::translation(Point2(maximum, maximum)).then(AffineTransform::translation(Point2(maximum, maximum))).then(AffineTransform::translation(Point2(maximum, maximum)));
+	EXPECT_EQ(far.translation_x, max_transform_translation) << "The translation must be saturated.";
+	EXPECT_EQ(far.apply(Point2(minimum, minimum)), Point2(maximum, maximum));
+}
+
+}
\ No newline at end of file
@@ -8,8 +8,10 @@
 
 #include <gtest/gtest.h> //To run the test.
 #include <list> //For linked lists, a data structure with inherently limited iterators, from which batches must be able to copy.
+#include <memory_resource> //To test allocating batches from custom memory resources.
 
 #include "apex/batch.hpp" //The code under test.
+#include "helpers/allocation_counter.hpp" //To test that moving batches doesn't copy their data.
 #include "helpers/fuzz_equal_behaviour.hpp" //To test whether batches behave equally to vectors.
 #include "helpers/input_iterator_limiter.hpp" //To test with very limited iterator types.
 
@@ -20,10 +22,85 @@ You might expect there to be some tests for batches of simple elements here.
 However the Batch<E> class simply inherits all of its functions from
 std::vector<E>. Writing tests for this then is effectively like writing tests
 for the vector implementation of your compiler. Since std::vector can be
-considered stable, writing tests for it is not effective. The tests below only
-apply to class template specialisations with more interesting behaviour.
+considered stable, writing tests for it is not effective. The tests below
+mostly apply to class template specialisations with more interesting behaviour.
+Only the move semantics and memory resources, which Batch<E> implements itself,
+are tested here.
 */
 
+/*!
+ * Test that the move constructor of batches takes over the data of the
+ * original batch, without copying it.
+ */
+TEST(Batch, ConstructMove) {
+	Batch<int> original({1, 2, 3, 4, 5});
+	const int* original_data = original.data();
+
+	AllocationCounter counter;
+	const Batch<int> moved(std::move(original));
+	EXPECT_EQ(counter.allocations(), 0) << "Moving the batch must not allocate any memory for a copy of the data.";
+	EXPECT_EQ(moved.data(), original_data) << "The moved batch must take over the data of the original batch.";
+	EXPECT_EQ(moved, Batch<int>({1, 2, 3, 4, 5})) << "The data itself is unchanged by the move.";
+}
+
+/*!
+ * Test that the move-assignment operator of batches takes over the data of the
+ * original batch, without copying it.
+ */
+TEST(Batch, AssignMove) {
+	Batch<int> original({1, 2, 3, 4, 5});
+	const int* original_data = original.data();
+	Batch<int> assigned({6, 7});
+
+	AllocationCounter counter;
+	assigned = std::move(original);
+	EXPECT_EQ(counter.allocations(), 0) << "Moving the batch must not allocate any memory for a copy of the data.";
+	EXPECT_EQ(assigned.data(), original_data) << "The assigned batch must take over the data of the original batch.";
+	EXPECT_EQ(assigned, Batch<int>({1, 2, 3, 4, 5})) << "The data itself is unchanged by the move.";
+}
+
+/*!
+ * Test move-assigning a batch to a batch that uses a different memory
+ * resource.
+ *
+ * The data can't be taken over then, so it is moved into memory from the
+ * resource of the assigned batch. If that resource can't provide the memory,
+ * the assignment must throw instead of terminating.
+ */
+TEST(Batch, AssignMoveDifferentResource) {
+	std::byte buffer[4096];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource()); //Fails if it would need to allocate outside of the buffer.
+
+	Batch<int> assigned(&arena);
+	assigned = Batch<int>({1, 2, 3, 4, 5});
+	EXPECT_EQ(assigned.get_memory_resource(), &arena) << "The assigned batch keeps its own memory resource.";
+	EXPECT_EQ(assigned, Batch<int>({1, 2, 3, 4, 5})) << "The data itself is unchanged by the move.";
+
+	Batch<int> too_big(sizeof(buffer), 0);
+	EXPECT_THROW(assigned = std::move(too_big), std::bad_alloc) << "The arena can't hold the moved data.";
+}
+
+/*!
+ * Test allocating a batch from a custom memory resource.
+ */
+TEST(Batch, ConstructMemoryResource) {
+	std::byte buffer[4096];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource()); //Fails if it would need to allocate outside of the buffer.
+
+	AllocationCounter counter;
+	Batch<int> batch(&arena);
+	for(int i = 0; i < 100; ++i) {
+		batch.push_back(i);
+	}
+	EXPECT_EQ(counter.allocations(), 0) << "All memory must come from the arena, not from the heap.";
+	EXPECT_EQ(batch.get_memory_resource(), &arena) << "The batch must report the memory resource it was constructed with.";
+	EXPECT_GE(static_cast<const void*>(batch.data()), static_cast<const void*>(buffer)) << "The elements must be stored in the buffer of the arena.";
+	EXPECT_LT(static_cast<const void*>(batch.data()), static_cast<const void*>(buffer + sizeof(buffer))) << "The elements must be stored in the buffer of the arena.";
+	for(int i = 0; i < 100; ++i) {
+		EXPECT_EQ(batch[i], i);
+	}
+}
+
 /*!
  * A fixture with a few pre-constructed batches for easy writing of tests.
  */
@@ -247,11 +324,14 @@ TEST_F(BatchOfBatchesFixture, ConstructMove) {
 	const Batch<Batch<int>> original_batch(power_increases); //Make a copy so that we can compare the data in the batch without using the decommissioned moved batch.
 
 	const int* original_position = &power_increases[5][5]; //Grab an arbitrary element in the array, noting its position in memory.
+	AllocationCounter counter;
 	const Batch<Batch<int>> moved_batch(std::move(power_increases));
+	const size_t allocations = counter.allocations();
 	const int* new_position = &moved_batch[5][5];
 
 	EXPECT_EQ(moved_batch, original_batch) << "After the move, all element data and subelement data is still unchanged.";
 	EXPECT_EQ(original_position, new_position) << "The actual subelement data has not moved in the memory, eliding a copy for better performance.";
+	EXPECT_EQ(allocations, 0) << "Moving the batch must not allocate any memory for a copy of the data.";
 }
 
 /*!
@@ -268,6 +348,72 @@ TEST(BatchOfBatches, ConstructInitialiserList) {
 	EXPECT_EQ(batch[2], Batch<int>({8, 9, 10, 11, 12})) << "The third subbatch.";
 }
 
+/*!
+ * Test allocating a batch of batches from a custom memory resource.
+ *
+ * Both the subelements and the subbatches must be allocated from that resource.
+ */
+TEST(BatchOfBatches, ConstructMemoryResource) {
+	std::byte buffer[16384];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource()); //Fails if it would need to allocate outside of the buffer.
+
+	AllocationCounter counter;
+	Batch<Batch<int>> batch(&arena);
+	for(int subbatch = 0; subbatch < 10; ++subbatch) {
+		batch.emplace_back();
+		for(int element = 0; element < subbatch; ++element) {
+			batch.back().push_back(element);
+		}
+	}
+	batch.shrink_to_fit(); //Must also allocate the optimised buffer from the arena.
+	EXPECT_EQ(counter.allocations(), 0) << "All memory must come from the arena, not from the heap.";
+	EXPECT_EQ(batch.get_memory_resource(), &arena) << "The batch must report the memory resource it was constructed with.";
+	ASSERT_EQ(batch.size(), 10);
+	for(int subbatch = 0; subbatch < 10; ++subbatch) {
+		ASSERT_EQ(batch[subbatch].size(), subbatch) << "Each subbatch got as many elements as its index.";
+		for(int element = 0; element < subbatch; ++element) {
+			EXPECT_EQ(batch[subbatch][element], element);
+		}
+	}
+}
+
+/*!
+ * Test constructing a batch of batches around an existing buffer of
+ * subelements.
+ */
+TEST(BatchOfBatches, ConstructAdoptBuffer) {
+	std::pmr::vector<int> buffer = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	buffer.reserve(16); //Leave room for the empty subbatch, which needs space of its own.
+	const int* data = buffer.data();
+	const std::vector<size_t> offsets = {0, 2, 2, 7, 9};
+
+	AllocationCounter counter;
+	Batch<Batch<int>> batch(std::move(buffer), offsets);
+	EXPECT_EQ(counter.allocations(), 1) << "Only the table of subbatches must be allocated. The subelements must not be copied.";
+	EXPECT_EQ(batch.data_subelements(), data) << "The buffer must be used directly.";
+
+	ASSERT_EQ(batch.size(), 4) << "There were 5 offsets, so 4 subbatches.";
+	EXPECT_EQ(batch[0], Batch<int>({1, 2}));
+	EXPECT_TRUE(batch[1].empty()) << "The second and third offsets were equal, so the second subbatch is empty.";
+	EXPECT_EQ(batch[2], Batch<int>({3, 4, 5, 6, 7}));
+	EXPECT_EQ(batch[3], Batch<int>({8, 9}));
+
+	batch[1].push_back(10); //The empty subbatch needs space of its own.
+	batch[0].push_back(11);
+	EXPECT_EQ(batch, Batch<Batch<int>>({{1, 2, 11}, {10}, {3, 4, 5, 6, 7}, {8, 9}})) << "The subbatches must be able to grow without overwriting each other.";
+}
+
+/*!
+ * Test constructing a batch of batches around an existing buffer with no
+ * subbatches at all.
+ */
+TEST(BatchOfBatches, ConstructAdoptBufferEmpty) {
+	Batch<Batch<int>> batch{std::pmr::vector<int>(), std::vector<size_t>()};
+	EXPECT_TRUE(batch.empty()) << "There were no offsets, so no subbatches.";
+	batch.push_back(Batch<int>({1, 2, 3}));
+	EXPECT_EQ(batch[0], Batch<int>({1, 2, 3})) << "The batch must be usable after adopting an empty buffer.";
+}
+
 /*!
  * Test assigning empty batches to other batches with copy-assignment.
  */
@@ -340,6 +486,14 @@ TEST_F(BatchOfBatchesFixture, AssignMoveFilled) {
 	Batch<Batch<int>> assign_filled(linear_increases);
 	assign_filled = std::move(powers_copy_3);
 	EXPECT_EQ(assign_filled, power_increases) << "After assigning this batch, it must be equal to this batch.";
+
+	Batch<Batch<int>> powers_copy_4(power_increases); //Don't re-use the moved batch ever again!
+	const int* original_position = &powers_copy_4[5][5];
+	Batch<Batch<int>> assign_counted(linear_increases);
+	AllocationCounter counter;
+	assign_counted = std::move(powers_copy_4);
+	EXPECT_EQ(counter.allocations(), 0) << "Moving the batch must not allocate any memory for a copy of the data.";
+	EXPECT_EQ(&assign_counted[5][5], original_position) << "The subelement data must not have moved in memory.";
 }
 
 /*!
@@ -725,6 +879,36 @@ TEST_F(BatchOfBatchesFixture, AssignInitialiserList) {
 	EXPECT_EQ(batch[2], Batch<int>({8, 9, 10, 11, 12})) << "The third subbatch.";
 }
 
+/*!
+ * Test assigning subbatches of predetermined sizes, and filling them in
+ * parallel.
+ */
+TEST_F(BatchOfBatchesFixture, AssignSizes) {
+	const std::vector<size_t> sizes = {3, 0, 1, 100, 5};
+	power_increases.assign_sizes(sizes);
+	ASSERT_EQ(power_increases.size(), sizes.size()) << "There must be a subbatch for each size.";
+	for(size_t subbatch = 0; subbatch < sizes.size(); ++subbatch) {
+		EXPECT_EQ(power_increases[subbatch].size(), sizes[subbatch]) << "Each subbatch must get the requested size.";
+	}
+	EXPECT_EQ(power_increases.size_subelements(), 110) << "The subbatches are placed without gaps, with only the empty one taking 1 more space.";
+	EXPECT_EQ(power_increases.fragmentation(), 0.0) << "There are no gaps in the buffer.";
+
+	AllocationCounter counter;
+	const Batch<Batch<int>>::iterator subbatches = power_increases.begin();
+	#pragma omp parallel for
+	for(size_t subbatch = 0; subbatch < sizes.size(); ++subbatch) {
+		for(size_t element = 0; element < sizes[subbatch]; ++element) {
+			subbatches[subbatch][element] = subbatch * 1000 + element;
+		}
+	}
+	EXPECT_EQ(counter.allocations(), 0) << "Filling the subbatches must not reallocate anything.";
+	for(size_t subbatch = 0; subbatch < sizes.size(); ++subbatch) {
+		for(size_t element = 0; element < sizes[subbatch]; ++element) {
+			EXPECT_EQ(power_increases[subbatch][element], subbatch * 1000 + element) << "Every element must have been filled in.";
+		}
+	}
+}
+
 /*!
  * Test clearing batches of batches.
  */
@@ -743,6 +927,97 @@ TEST_F(BatchOfBatchesFixture, Clear) {
 	EXPECT_EQ(batch.size(), 0) << "The one item in this batch must be erased by the clearing.";
 }
 
+/*!
+ * Test compacting a batch of batches after some subbatches were moved to the end
+ * of the subelement buffer.
+ */
+TEST_F(BatchOfBatchesFixture, Compact) {
+	power_increases[1].push_back(100); //These subbatches have to move to the end, leaving gaps behind.
+	power_increases[3].push_back(101);
+	ASSERT_GT(power_increases.fragmentation(), 0.0) << "Moving subbatches to the end leaves gaps in the buffer.";
+	const Batch<Batch<int>> before_compacting = power_increases; //Compacting shouldn't change the data, so we can compare to this.
+	std::vector<size_t> capacities;
+	for(const Subbatch<int>& subbatch : power_increases) {
+		capacities.push_back(subbatch.capacity());
+	}
+
+	power_increases.compact();
+
+	EXPECT_EQ(power_increases, before_compacting) << "The data in the batch should not be changed by compacting.";
+	EXPECT_EQ(power_increases.fragmentation(), 0.0) << "After compacting, there are no more gaps between the subbatches.";
+	for(size_t subbatch = 0; subbatch < power_increases.size(); ++subbatch) {
+		EXPECT_EQ(power_increases[subbatch].capacity(), capacities[subbatch]) << "Compacting keeps the capacity of the subbatches, so they can still grow.";
+		if(subbatch > 0) {
+			EXPECT_EQ(power_increases[subbatch].data(), power_increases[subbatch - 1].data() + capacities[subbatch - 1]) << "The subbatches must be placed right after each other, in order.";
+		}
+	}
+}
+
+/*!
+ * Test that the buffer gets compacted automatically when it needs to grow while
+ * it has too many gaps.
+ */
+TEST(BatchOfBatches, CompactAutomatically) {
+	for(const double threshold : {0.25, 1.0}) {
+		Batch<Batch<int>> batch;
+		batch.set_compaction_threshold(threshold);
+		EXPECT_EQ(batch.get_compaction_threshold(), threshold) << "The threshold must be stored.";
+		for(int subbatch = 0; subbatch < 100; ++subbatch) {
+			batch.push_back(Batch<int>(10, subbatch));
+		}
+		batch.erase(batch.begin(), batch.begin() + 50); //Leaves half of the buffer unused.
+		EXPECT_EQ(batch.fragmentation(), 0.5) << "The first half of the buffer is no longer used by any subbatch.";
+		for(int subbatch = 100; subbatch < 160; ++subbatch) { //Doesn't fit in the buffer any more, so it needs to grow.
+			batch.push_back(Batch<int>(10, subbatch));
+		}
+
+		ASSERT_EQ(batch.size(), 110);
+		for(int subbatch = 0; subbatch < 110; ++subbatch) {
+			EXPECT_EQ(batch[subbatch], Batch<int>(10, subbatch + 50)) << "The data must not be affected by compacting.";
+		}
+		if(threshold < 0.5) {
+			EXPECT_EQ(batch.fragmentation(), 0.0) << "The buffer had more dead space than the threshold, so it should have been compacted before growing.";
+			EXPECT_EQ(batch.size_subelements(), 1100) << "After compacting, only the live subbatches take space.";
+		} else {
+			EXPECT_GT(batch.fragmentation(), 0.0) << "Automatic compaction is disabled with a threshold of 1.";
+			EXPECT_EQ(batch.size_subelements(), 1600) << "Without compacting, the gaps remain.";
+		}
+	}
+}
+
+/*!
+ * Test that subbatches grow into the free space after them in the buffer, if
+ * there is any, rather than moving to the end.
+ */
+TEST_F(BatchOfBatchesFixture, GrowInPlace) {
+	const ptrdiff_t start = linear_increases[1].data() - linear_increases.data_subelements();
+	linear_increases.erase(linear_increases.begin() + 2); //Frees up the space right after the second subbatch.
+	const size_t size_before = linear_increases.size_subelements();
+
+	linear_increases[1].push_back(3);
+	linear_increases[1].push_back(4);
+
+	EXPECT_EQ(linear_increases[1], Batch<int>({1, 2, 3, 4})) << "The elements must have been added.";
+	EXPECT_EQ(linear_increases[1].data() - linear_increases.data_subelements(), start) << "The subbatch grew into the space of the erased subbatch, so it didn't need to move.";
+	EXPECT_EQ(linear_increases.size_subelements(), size_before) << "Nothing got added to the end of the buffer.";
+	EXPECT_EQ(linear_increases[2], Batch<int>({1, 2, 3, 4})) << "The subsequent subbatch must be unaffected.";
+}
+
+/*!
+ * Test measuring how fragmented the subelement buffer is.
+ */
+TEST_F(BatchOfBatchesFixture, Fragmentation) {
+	EXPECT_EQ(empty_batch.fragmentation(), 0.0) << "Without any subelements, there are no gaps either.";
+	EXPECT_EQ(linear_increases.fragmentation(), 0.0) << "The subbatches were filled in order, growing in place, so there are no gaps.";
+
+	linear_increases.erase(linear_increases.begin()); //Erasing the first subbatch leaves a gap at the start.
+	const size_t gap = linear_increases.size_subelements() - std::accumulate(linear_increases.cbegin(), linear_increases.cend(), size_t(0), [](const size_t current, const Subbatch<int>& subbatch) {
+		return current + subbatch.capacity();
+	});
+	EXPECT_GT(gap, 0) << "Erasing a subbatch leaves a gap in the buffer.";
+	EXPECT_DOUBLE_EQ(linear_increases.fragmentation(), double(gap) / linear_increases.size_subelements()) << "The fragmentation is the fraction of the buffer not used by any subbatch.";
+}
+
 /*!
  * Test getting an array of data for the subelements.
  *
@@ -2034,6 +2309,18 @@ TEST(BatchOfBatches, VectorEquivalenceFuzz) {
 		[](Batch<Batch<int>>& batch) { batch.clear(); },
 		[](std::vector<std::vector<int>>& vec) { vec.clear(); },
 		1.0);
+	fuzzer.add_transformation("compact",
+		[](Batch<Batch<int>>& batch) { batch.compact(); },
+		[](std::vector<std::vector<int>>&) {},
+		4.0);
+	fuzzer.add_transformation("compaction_threshold_low",
+		[](Batch<Batch<int>>& batch) { batch.set_compaction_threshold(0.1); },
+		[](std::vector<std::vector<int>>&) {},
+		1.0);
+	fuzzer.add_transformation("compaction_threshold_disabled",
+		[](Batch<Batch<int>>& batch) { batch.set_compaction_threshold(1.0); },
+		[](std::vector<std::vector<int>>&) {},
+		1.0);
 	fuzzer.add_transformation("emplace_empty_begin",
 		[](Batch<Batch<int>>& batch) { batch.emplace(batch.begin()); },
 		[](std::vector<std::vector<int>>& vec) { vec.emplace(vec.begin()); },
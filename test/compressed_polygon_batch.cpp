@@ -0,0 +1,126 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+#include <limits> //To test compressing extreme coordinates.
+
+#include "apex/compressed_polygon_batch.hpp" //The code under test.
+#include "helpers/polygon_batch_test_cases.hpp" //To load testing polygons to compress.
+#include "helpers/polygon_test_cases.hpp" //To compress a polygon with many vertices.
+
+namespace apex {
+
+/*!
+ * Tests compressing an empty batch.
+ */
+TEST(CompressedPolygonBatch, Empty) {
+	const CompressedPolygonBatch compressed(PolygonBatchTestCases::empty());
+	EXPECT_TRUE(compressed.empty()) << "There were no polygons in the batch that was compressed.";
+	EXPECT_EQ(compressed.size_subelements(), 0) << "There are no vertices without polygons.";
+	EXPECT_TRUE(compressed.decompress().empty()) << "There are no polygons to decompress.";
+	EXPECT_TRUE(compressed.area().empty()) << "There are no polygons to compute the area of.";
+	EXPECT_TRUE(compressed.bounding_box().empty()) << "There are no polygons to compute the bounding box of.";
+}
+
+/*!
+ * Tests that decompressing gives the same polygons as the batch that was
+ * compressed, including empty and degenerate polygons.
+ */
+TEST(CompressedPolygonBatch, RoundTrip) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases();
+	const CompressedPolygonBatch compressed(original);
+	ASSERT_EQ(compressed.size(), original.size()) << "Each polygon must have been compressed.";
+	size_t num_vertices = 0;
+	for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+		num_vertices += original[polygon].size();
+	}
+	EXPECT_EQ(compressed.size_subelements(), num_vertices) << "Each vertex must have been compressed.";
+	const Batch<Polygon> decompressed = compressed.decompress();
+	ASSERT_EQ(decompressed.size(), original.size()) << "Each polygon must be decompressed.";
+	for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+		EXPECT_EQ(decompressed[polygon], original[polygon]) << "The whole batch must be decompressed to the original polygons.";
+		EXPECT_EQ(compressed.decompress(polygon), Polygon(original[polygon])) << "Each polygon must be decompressed to the original polygon.";
+	}
+}
+
+/*!
+ * Tests that polygons with more vertices than fit in one block are
+ * decompressed correctly.
+ */
+TEST(CompressedPolygonBatch, ManyBlocks) {
+	Batch<Polygon> original;
+	Polygon spiral;
+	for(coord_t vertex = 0; vertex < 100; ++vertex) {
+		spiral.push_back(Point2(vertex * vertex * (vertex % 2 == 0 ? 1 : -1), -vertex * 7)); //Edges of very different lengths.
+	}
+	original.push_back(spiral);
+	const CompressedPolygonBatch compressed(original);
+	EXPECT_EQ(compressed.decompress(0), spiral) << "All blocks of the polygon must be decompressed.";
+}
+
+/*!
+ * Tests compressing coordinates at the limits of what can be represented, where
+ * the deltas between them don't fit in a coordinate.
+ */
+TEST(CompressedPolygonBatch, ExtremeCoordinates) {
+	constexpr coord_t min = std::numeric_limits<coord_t>::min();
+	constexpr coord_t max = std::numeric_limits<coord_t>::max();
+	const Polygon extreme({Point2(min, min), Point2(max, min), Point2(max, max), Point2(min, max), Point2(0, 0)});
+	CompressedPolygonBatch compressed;
+	compressed.push_back(extreme);
+	EXPECT_EQ(compressed.decompress(0), extreme) << "The deltas wrap around, but the original coordinates must be restored.";
+	EXPECT_EQ(compressed.bounding_box()[0], std::make_pair(Point2(min, min), Point2(max, max))) << "The bounding box covers the whole coordinate space.";
+}
+
+/*!
+ * Tests adding polygons one by one.
+ */
+TEST(CompressedPolygonBatch, PushBack) {
+	const Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	CompressedPolygonBatch compressed;
+	for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+		compressed.push_back(original[polygon]);
+	}
+	EXPECT_EQ(compressed.size(), original.size()) << "All polygons were added.";
+	EXPECT_EQ(compressed.decompress(), original) << "The polygons must be stored in the order they were added.";
+}
+
+/*!
+ * Tests that the areas computed on the compressed polygons are the same as
+ * those of the original polygons.
+ */
+TEST(CompressedPolygonBatch, Area) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const CompressedPolygonBatch compressed(original);
+		EXPECT_EQ(compressed.area(), original.area()) << "The areas must be the same as those of the original polygons.";
+	}
+}
+
+/*!
+ * Tests that the bounding boxes computed on the compressed polygons are the
+ * same as those of the original polygons.
+ */
+TEST(CompressedPolygonBatch, BoundingBox) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const CompressedPolygonBatch compressed(original);
+		EXPECT_EQ(compressed.bounding_box(), bounding_box(original)) << "The bounding boxes must be the same as those of the original polygons.";
+	}
+}
+
+/*!
+ * Tests that polygons with short edges take much less memory when compressed.
+ */
+TEST(CompressedPolygonBatch, CompressionRatio) {
+	Batch<Polygon> original;
+	original.push_back(PolygonTestCases::circle());
+	const CompressedPolygonBatch compressed(original);
+	const size_t uncompressed_size = original.size_subelements() * sizeof(Point2);
+	EXPECT_LT(compressed.memory_usage() * 3, uncompressed_size) << "The edges of the circle are short, so the vertices must compress to less than a third.";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+#include <limits> //To reset the memory budget.
+#include <vector> //To create some data to track.
+
+#include "apex/detail/gpu_data_tracker.hpp" //The code under test.
+
+namespace apex {
+
+/*!
+ * Gives the tests access to the synchronisation state of the tracker.
+ */
+class GPUDataTrackerInspector : public GPUDataTracker {
+public:
+	/*!
+	 * Get whether some data is tracked at all.
+	 * \param points The data to look up.
+	 * \return ``true`` if the data is on the GPU, or ``false`` if it is only on
+	 * the host.
+	 */
+	static bool is_tracked(const Point2* points) {
+		return sync_state.find(points) != sync_state.end();
+	}
+
+	/*!
+	 * Get whether the GPU has a more recent copy of some data than the host.
+	 * \param points The data to look up.
+	 * \return ``true`` if the GPU has the most recent copy, or ``false`` if the
+	 * host has it too.
+	 */
+	static bool is_newer_on_gpu(const Point2* points) {
+		return is_tracked(points) && sync_state[points].state == GPUSyncState::DEVICE;
+	}
+
+	/*!
+	 * Get whether the host has a more recent copy of some data than the GPU.
+	 * \param points The data to look up.
+	 * \return ``true`` if the copy on the GPU is outdated, or ``false`` if it
+	 * is not.
+	 */
+	static bool is_newer_on_host(const Point2* points) {
+		return is_tracked(points) && sync_state[points].state == GPUSyncState::HOST;
+	}
+
+	/*!
+	 * Get the number of points of some data that are on the GPU.
+	 * \param points The data to look up.
+	 * \return The number of points that were transferred to the GPU.
+	 */
+	static size_t tracked_count(const Point2* points) {
+		return is_tracked(points) ? sync_state[points].count : 0;
+	}
+
+	/*!
+	 * Get the number of memory objects on the GPU.
+	 * \return The number of memory objects on the GPU.
+	 */
+	static size_t num_tracked_objects() {
+		return sync_state.size();
+	}
+};
+
+/*!
+ * Tests that data is not tracked until it is synchronised to the GPU.
+ */
+TEST(GPUDataTracker, UntrackedUntilSynced) {
+	const std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(points.data())) << "The data was never transferred to the GPU.";
+	GPUDataTracker::changed_on_gpu(points.data());
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(points.data())) << "Data that isn't on the GPU can't have changed there.";
+
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(points.data())) << "After synchronising, the data is on the GPU.";
+	EXPECT_EQ(GPUDataTrackerInspector::tracked_count(points.data()), points.size()) << "All of the points were transferred.";
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Tests the synchronisation states when the data changes on the GPU and is
+ * then needed on the host.
+ */
+TEST(GPUDataTracker, ChangedOnGPU) {
+	const std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_FALSE(GPUDataTrackerInspector::is_newer_on_gpu(points.data())) << "Right after synchronising, both have the same data.";
+
+	GPUDataTracker::changed_on_gpu(points.data());
+	EXPECT_TRUE(GPUDataTrackerInspector::is_newer_on_gpu(points.data())) << "The data was changed on the GPU, so the host is outdated.";
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_TRUE(GPUDataTrackerInspector::is_newer_on_gpu(points.data())) << "Synchronising to the GPU must not overwrite the newer data there.";
+
+	GPUDataTracker::sync_to_host(points.data());
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(points.data())) << "The data stays on the GPU after synchronising it to the host.";
+	EXPECT_FALSE(GPUDataTrackerInspector::is_newer_on_gpu(points.data())) << "After synchronising, both have the same data.";
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Tests the synchronisation states when the data changes on the host and is
+ * then needed on the GPU.
+ */
+TEST(GPUDataTracker, ChangedOnHost) {
+	const std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	GPUDataTracker::changed_on_host(points.data());
+	EXPECT_TRUE(GPUDataTrackerInspector::is_newer_on_host(points.data())) << "The data was changed on the host, so the GPU is outdated.";
+
+	GPUDataTracker::sync_to_host(points.data());
+	EXPECT_TRUE(GPUDataTrackerInspector::is_newer_on_host(points.data())) << "Synchronising to the host must not overwrite the newer data there.";
+
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_FALSE(GPUDataTrackerInspector::is_newer_on_host(points.data())) << "After synchronising, both have the same data.";
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Tests that data is transferred again if it changed size.
+ */
+TEST(GPUDataTracker, ChangedSize) {
+	std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+	points.reserve(10); //Make sure that the data stays at the same address.
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	points.emplace_back(0, 10);
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_EQ(GPUDataTrackerInspector::tracked_count(points.data()), points.size()) << "The new point must be transferred too.";
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Tests releasing data from the GPU.
+ */
+TEST(GPUDataTracker, Release) {
+	const std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	GPUDataTracker::changed_on_gpu(points.data());
+	GPUDataTracker::release(points.data());
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(points.data())) << "After releasing, the data is no longer on the GPU.";
+
+	GPUDataTracker::release(points.data());
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(points.data())) << "Releasing data that isn't on the GPU does nothing.";
+}
+
+/*!
+ * Tests that the least recently used data is removed from the GPU when the
+ * memory budget is exceeded.
+ */
+TEST(GPUDataTracker, EvictLeastRecentlyUsed) {
+	const std::vector<Point2> first(10);
+	const std::vector<Point2> second(10);
+	const std::vector<Point2> third(10);
+	GPUDataTracker::set_memory_budget(sizeof(Point2) * 20); //Fits only two of them.
+	GPUDataTracker::sync_to_gpu(first.data(), first.size(), &first);
+	GPUDataTracker::sync_to_gpu(second.data(), second.size(), &second);
+	GPUDataTracker::sync_to_gpu(first.data(), first.size(), &first); //Use the first again, so that the second is the least recently used.
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), sizeof(Point2) * 20) << "Both fit within the budget.";
+
+	GPUDataTracker::sync_to_gpu(third.data(), third.size(), &third);
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(first.data())) << "The first data was used more recently, so it must stay on the GPU.";
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(second.data())) << "The second data was used least recently, so it must make room for the third.";
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(third.data())) << "The third data is now on the GPU.";
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), sizeof(Point2) * 20) << "The memory of the second data was freed.";
+
+	GPUDataTracker::release(first.data());
+	GPUDataTracker::release(third.data());
+	GPUDataTracker::set_memory_budget(std::numeric_limits<size_t>::max());
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), 0) << "All data was released.";
+}
+
+/*!
+ * Tests that data changed on the GPU is transferred back before removing it to
+ * make room for other data.
+ */
+TEST(GPUDataTracker, EvictChangedOnGPU) {
+	const std::vector<Point2> first(10);
+	const std::vector<Point2> second(10);
+	GPUDataTracker::set_memory_budget(sizeof(Point2) * 10);
+	GPUDataTracker::sync_to_gpu(first.data(), first.size(), &first);
+	GPUDataTracker::changed_on_gpu(first.data());
+	GPUDataTracker::sync_to_gpu(second.data(), second.size(), &second);
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(first.data())) << "The first data must make room for the second.";
+	EXPECT_FALSE(GPUDataTrackerInspector::is_newer_on_gpu(first.data())) << "The changes must have been transferred back to the host.";
+
+	GPUDataTracker::release(second.data());
+	GPUDataTracker::set_memory_budget(std::numeric_limits<size_t>::max());
+}
+
+/*!
+ * Tests that data larger than the entire memory budget is not put on the GPU.
+ */
+TEST(GPUDataTracker, LargerThanBudget) {
+	const std::vector<Point2> points(100);
+	GPUDataTracker::set_memory_budget(sizeof(Point2) * 10);
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(points.data())) << "The data doesn't fit on the GPU, so operations need to transfer it themselves.";
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), 0) << "Nothing was put on the GPU.";
+	GPUDataTracker::set_memory_budget(std::numeric_limits<size_t>::max());
+}
+
+/*!
+ * Tests that a buffer is removed from the GPU when its owner synchronises a
+ * different buffer, without having released the old one.
+ */
+TEST(GPUDataTracker, OwnerReallocated) {
+	const std::vector<Point2> old_buffer(10);
+	const std::vector<Point2> new_buffer(20);
+	const int owner = 0; //Any object to identify the owner.
+	GPUDataTracker::sync_to_gpu(old_buffer.data(), old_buffer.size(), &owner);
+	GPUDataTracker::sync_to_gpu(new_buffer.data(), new_buffer.size(), &owner);
+	EXPECT_FALSE(GPUDataTrackerInspector::is_tracked(old_buffer.data())) << "The owner moved on to a different buffer, so the old one must be removed from the GPU.";
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(new_buffer.data())) << "The new buffer is now on the GPU.";
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), sizeof(Point2) * 20) << "Only the new buffer occupies memory on the GPU.";
+	GPUDataTracker::release(new_buffer.data());
+}
+
+/*!
+ * Tests that a buffer is refreshed when a different owner synchronises it,
+ * since its address may have been reused.
+ */
+TEST(GPUDataTracker, AddressReused) {
+	const std::vector<Point2> points(10);
+	const int first_owner = 0;
+	const int second_owner = 0;
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &first_owner);
+	ASSERT_FALSE(GPUDataTrackerInspector::is_newer_on_host(points.data())) << "The data is in sync.";
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &second_owner);
+	EXPECT_TRUE(GPUDataTrackerInspector::is_tracked(points.data())) << "The data is still on the GPU.";
+	EXPECT_FALSE(GPUDataTrackerInspector::is_newer_on_host(points.data())) << "The data must have been refreshed for the new owner.";
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), sizeof(Point2) * 10) << "The data is only on the GPU once.";
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Tests using the tracker from many threads at the same time.
+ */
+TEST(GPUDataTracker, Concurrent) {
+	constexpr size_t num_buffers = 64;
+	std::vector<std::vector<Point2>> buffers(num_buffers, std::vector<Point2>(16));
+	GPUDataTracker::set_memory_budget(sizeof(Point2) * 16 * num_buffers / 2); //Only half fit, forcing evictions.
+	#pragma omp parallel for
+	for(size_t repeat = 0; repeat < num_buffers * 8; ++repeat) {
+		const std::vector<Point2>& buffer = buffers[repeat % num_buffers];
+		GPUDataTracker::sync_to_gpu(buffer.data(), buffer.size(), &buffer);
+		GPUDataTracker::changed_on_gpu(buffer.data());
+		GPUDataTracker::sync_to_host(buffer.data());
+		GPUDataTracker::changed_on_host(buffer.data());
+	}
+	EXPECT_LE(GPUDataTracker::get_memory_used(), GPUDataTracker::get_memory_budget()) << "The memory budget must be respected, even with many threads.";
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), GPUDataTrackerInspector::num_tracked_objects() * sizeof(Point2) * 16) << "The memory used must match the data that is tracked.";
+	for(const std::vector<Point2>& buffer : buffers) {
+		GPUDataTracker::release(buffer.data());
+	}
+	EXPECT_EQ(GPUDataTracker::get_memory_used(), 0) << "All data was released.";
+	GPUDataTracker::set_memory_budget(std::numeric_limits<size_t>::max());
+}
+
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <gtest/gtest.h> //To run the test.
 #include <tuple> //Combinatoric test data.
+#include <utility> //To compare bounding boxes.
 
 #include "apex/detail/polygon_properties.hpp" //The code under test.
 
@@ -68,4 +69,59 @@ TEST_P(PolygonPropertiesTest, Reset) {
 	EXPECT_EQ(properties.orientation(), PolygonProperties::Orientation::UNKNOWN);
 }
 
+/*!
+ * Tests storing the area of a polygon.
+ */
+TEST(PolyProperties, Area) {
+	PolygonProperties properties;
+	EXPECT_FALSE(properties.has_area()) << "Initially, the area is not known.";
+
+	properties.set_area(-1234);
+	EXPECT_TRUE(properties.has_area()) << "The area was stored, so it is now known.";
+	EXPECT_EQ(properties.area(), -1234) << "The area must remain what we have set it to.";
+	EXPECT_EQ(properties.orientation(), PolygonProperties::Orientation::UNKNOWN) << "The polygon may intersect itself, so the sign of the area doesn't reveal the orientation.";
+}
+
+/*!
+ * Tests that the orientation follows from the area if the polygon is known not
+ * to intersect itself.
+ */
+TEST(PolyProperties, AreaOrientation) {
+	PolygonProperties properties;
+	properties.set_self_intersecting(PolygonProperties::SelfIntersecting::NO);
+
+	properties.set_area(-1234);
+	EXPECT_EQ(properties.orientation(), PolygonProperties::Orientation::NEGATIVE) << "A simple polygon with negative area is negative.";
+	properties.set_area(1234);
+	EXPECT_EQ(properties.orientation(), PolygonProperties::Orientation::POSITIVE) << "A simple polygon with positive area is positive.";
+}
+
+/*!
+ * Tests storing and moving the bounding box of a polygon.
+ */
+TEST(PolyProperties, BoundingBox) {
+	PolygonProperties properties;
+	EXPECT_FALSE(properties.has_bounding_box()) << "Initially, the bounding box is not known.";
+
+	properties.set_bounding_box(Point2(10, 20), Point2(30, 40));
+	EXPECT_TRUE(properties.has_bounding_box()) << "The bounding box was stored, so it is now known.";
+	EXPECT_EQ(properties.bounding_box(), std::make_pair(Point2(10, 20), Point2(30, 40))) << "The bounding box must remain what we have set it to.";
+
+	properties.translate(Point2(-5, 5));
+	EXPECT_EQ(properties.bounding_box(), std::make_pair(Point2(5, 25), Point2(25, 45))) << "The bounding box moves along with the polygon.";
+}
+
+/*!
+ * Tests that the area and bounding box are forgotten after resetting.
+ */
+TEST(PolyProperties, ResetCache) {
+	PolygonProperties properties;
+	properties.set_area(1234);
+	properties.set_bounding_box(Point2(10, 20), Point2(30, 40));
+
+	properties.reset();
+	EXPECT_FALSE(properties.has_area()) << "After resetting, the area is no longer known.";
+	EXPECT_FALSE(properties.has_bounding_box()) << "After resetting, the bounding box is no longer known.";
+}
+
 }
\ No newline at end of file
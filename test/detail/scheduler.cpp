@@ -0,0 +1,215 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <atomic> //To count how often each vertex is visited, from multiple threads.
+#include <gtest/gtest.h> //To run the test.
+#include <omp.h> //To test scheduling from within a parallel region.
+#include <vector> //To store the offsets of the polygons.
+
+#include "apex/detail/scheduler.hpp" //The unit under test.
+#include "apex/polygon.hpp" //To build the vertex ranges of a batch.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * Fixture that restores the default configuration of the scheduler after each
+ * test, so that the tests don't influence each other.
+ */
+class SchedulerFixture : public ::testing::Test {
+public:
+	/*!
+	 * The offsets of a batch with polygons of very different sizes, including
+	 * empty polygons.
+	 *
+	 * The polygons have 3, 0, 1000, 4, 0 and 10 vertices.
+	 */
+	std::vector<size_t> offsets = {0, 3, 3, 1003, 1007, 1007, 1017};
+
+	/*!
+	 * Restores the default configuration.
+	 */
+	void TearDown() {
+		Scheduler::reset();
+	}
+
+	/*!
+	 * Visits all vertices of the polygons in \ref offsets, and counts how often
+	 * each vertex is visited.
+	 * \return For each vertex in the list of all vertices, how often it was
+	 * visited.
+	 */
+	std::vector<size_t> count_visits() const {
+		std::vector<std::atomic<size_t>> visits(offsets.back());
+		Scheduler::for_each_range(offsets, [&](const size_t polygon, const size_t begin, const size_t end) {
+			EXPECT_LT(begin, end) << "Empty ranges must not be visited.";
+			EXPECT_LE(end, offsets[polygon + 1] - offsets[polygon]) << "The range must be within the polygon.";
+			for(size_t vertex = begin; vertex < end; ++vertex) {
+				visits[offsets[polygon] + vertex]++;
+			}
+		});
+		return std::vector<size_t>(visits.begin(), visits.end());
+	}
+};
+
+/*!
+ * Test that every vertex is visited exactly once with the default
+ * configuration.
+ */
+TEST_F(SchedulerFixture, VisitsAllVertices) {
+	EXPECT_EQ(count_visits(), std::vector<size_t>(offsets.back(), 1)) << "Each vertex must be visited exactly once.";
+}
+
+/*!
+ * Test that polygons are split over multiple tasks if they are bigger than the
+ * grain size.
+ */
+TEST_F(SchedulerFixture, SplitsBigPolygons) {
+	Scheduler::set_grain_size(100);
+	std::atomic<size_t> parts_of_big_polygon = 0;
+	Scheduler::for_each_range(offsets, [&](const size_t polygon, const size_t, const size_t) {
+		if(polygon == 2) {
+			parts_of_big_polygon++;
+		}
+	});
+	EXPECT_GE(parts_of_big_polygon, 10) << "The polygon with 1000 vertices must be split over at least 10 tasks of 100 vertices.";
+	EXPECT_EQ(count_visits(), std::vector<size_t>(offsets.back(), 1)) << "Each vertex must still be visited exactly once.";
+}
+
+/*!
+ * Test that every vertex is visited exactly once, with tasks as small as
+ * possible.
+ */
+TEST_F(SchedulerFixture, SingleVertexTasks) {
+	Scheduler::set_grain_size(1);
+	EXPECT_EQ(count_visits(), std::vector<size_t>(offsets.back(), 1)) << "Each vertex must be visited exactly once.";
+}
+
+/*!
+ * Test that every vertex is visited exactly once, regardless of the number of
+ * threads and their affinity.
+ */
+TEST_F(SchedulerFixture, ThreadsAndAffinity) {
+	Scheduler::set_grain_size(7);
+	for(const size_t threads : {1, 2, 3, 16}) {
+		for(const Affinity affinity : {Affinity::unspecified, Affinity::close, Affinity::spread}) {
+			Scheduler::set_num_threads(threads);
+			Scheduler::set_affinity(affinity);
+			EXPECT_EQ(Scheduler::get_num_threads(), threads);
+			EXPECT_EQ(Scheduler::get_affinity(), affinity);
+			EXPECT_EQ(count_visits(), std::vector<size_t>(offsets.back(), 1)) << "Each vertex must be visited exactly once.";
+		}
+	}
+}
+
+/*!
+ * Test that the configured number of threads is not exceeded.
+ */
+TEST_F(SchedulerFixture, NumThreads) {
+	Scheduler::set_grain_size(1);
+	Scheduler::set_num_threads(2);
+	std::atomic<int> max_thread = 0;
+	Scheduler::for_each_range(offsets, [&](const size_t, const size_t, const size_t) {
+		int current = max_thread;
+		while(omp_get_thread_num() > current && !max_thread.compare_exchange_weak(current, omp_get_thread_num())) {}
+		EXPECT_LE(omp_get_num_threads(), 2) << "At most 2 threads may be used.";
+	});
+	EXPECT_LT(max_thread, 2) << "Only threads 0 and 1 may get tasks.";
+}
+
+/*!
+ * Test that scheduling from within a parallel region doesn't start more
+ * threads.
+ */
+TEST_F(SchedulerFixture, Nested) {
+	Scheduler::set_grain_size(10);
+	#pragma omp parallel num_threads(2)
+	{
+		const int outer_thread = omp_get_thread_num();
+		size_t visited = 0;
+		Scheduler::for_each_range(offsets, [&](const size_t, const size_t begin, const size_t end) {
+			EXPECT_EQ(omp_get_thread_num(), outer_thread) << "Within a parallel region, the calling thread must execute all tasks.";
+			visited += end - begin; //Not atomic, since only the calling thread may visit.
+		});
+		EXPECT_EQ(visited, offsets.back()) << "All vertices must still be visited.";
+	}
+}
+
+/*!
+ * Test scheduling a batch without any vertices.
+ */
+TEST_F(SchedulerFixture, Empty) {
+	for(const std::vector<size_t>& empty : {std::vector<size_t>{0}, std::vector<size_t>{0, 0, 0}}) {
+		size_t calls = 0;
+		Scheduler::for_each_range(empty, [&](const size_t, const size_t, const size_t) {
+			calls++;
+		});
+		EXPECT_EQ(calls, 0) << "There are no vertices to visit.";
+	}
+}
+
+/*!
+ * Test that a grain size of 0 is raised to 1, so that all vertices are still
+ * visited.
+ */
+TEST_F(SchedulerFixture, ZeroGrainSize) {
+	Scheduler::set_grain_size(0);
+	EXPECT_EQ(Scheduler::get_grain_size(), 1) << "Tasks must have at least 1 vertex.";
+	EXPECT_EQ(count_visits(), std::vector<size_t>(offsets.back(), 1)) << "Each vertex must be visited exactly once.";
+}
+
+/*!
+ * Test that visiting blocks of indices covers every index exactly once.
+ */
+TEST_F(SchedulerFixture, Blocks) {
+	Scheduler::set_grain_size(7);
+	for(const size_t count : {0, 1, 7, 100}) {
+		std::vector<std::atomic<size_t>> visits(count);
+		Scheduler::for_each_block(count, [&](const size_t begin, const size_t end) {
+			EXPECT_LT(begin, end) << "Empty blocks must not be visited.";
+			for(size_t index = begin; index < end; ++index) {
+				visits[index]++;
+			}
+		});
+		EXPECT_EQ(std::vector<size_t>(visits.begin(), visits.end()), std::vector<size_t>(count, 1)) << "Each index must be visited exactly once.";
+	}
+}
+
+/*!
+ * Test building the table of vertex ranges of a batch with a gap in its vertex
+ * buffer.
+ */
+TEST_F(SchedulerFixture, VertexRanges) {
+	Batch<Polygon> batch = {Polygon({Point2(0, 0), Point2(1, 0), Point2(1, 1)}), Polygon(), Polygon({Point2(5, 5), Point2(6, 6)})};
+	batch[0].emplace_back(0, 1); //Grow the first polygon, so that it has to move and leaves a gap in the vertex buffer.
+	const VertexRanges ranges(batch);
+	EXPECT_EQ(ranges.offsets, std::vector<size_t>({0, 4, 4, 6})) << "Without gaps, the polygons start after the vertices of the previous polygons.";
+	EXPECT_EQ(ranges.size(0), 4);
+	EXPECT_EQ(ranges.size(1), 0);
+	for(const size_t polygon : {0, 2}) {
+		EXPECT_EQ(batch.data_subelements()[ranges.starts[polygon]], batch[polygon][0]) << "The starts must point at the first vertex of each polygon in the vertex buffer.";
+	}
+}
+
+/*!
+ * Test restoring the default configuration.
+ */
+TEST_F(SchedulerFixture, Reset) {
+	Scheduler::set_num_threads(3);
+	Scheduler::set_affinity(Affinity::spread);
+	Scheduler::set_grain_size(5);
+	Scheduler::reset();
+	EXPECT_EQ(Scheduler::get_num_threads(), 0) << "By default, the OpenMP runtime chooses the number of threads.";
+	EXPECT_EQ(Scheduler::get_affinity(), Affinity::unspecified);
+	EXPECT_EQ(Scheduler::get_grain_size(), Scheduler::default_grain_size);
+}
+
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <filesystem> //To store profiles in a temporary directory.
+#include <fstream> //To write profiles with errors.
+#include <gtest/gtest.h> //To run the test.
+
+#include "apex/detail/strategies.hpp" //The unit under test.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * Fixture that restores the compiled crossovers after each test, so that the
+ * tests don't influence each other.
+ */
+class StrategiesFixture : public ::testing::Test {
+public:
+	/*!
+	 * A path to store a profile at.
+	 */
+	std::filesystem::path profile_path;
+
+	/*!
+	 * Chooses the path to store profiles at.
+	 */
+	void SetUp() {
+		profile_path = std::filesystem::temp_directory_path() / "apex_strategies_test_profile.txt";
+	}
+
+	/*!
+	 * Restores the crossovers and removes the profile.
+	 */
+	void TearDown() {
+		Strategies::reset();
+		std::filesystem::remove(profile_path);
+	}
+};
+
+/*!
+ * Test choosing a version based on the crossovers of an operation.
+ */
+TEST_F(StrategiesFixture, Choose) {
+	Strategies::set_crossovers(Operation::self_intersections, {10, 100, no_crossover});
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, 0), 0) << "Below the first crossover, the first version is chosen.";
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, 9), 0) << "Below the first crossover, the first version is chosen.";
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, 10), 1) << "From the first crossover, the second version is chosen.";
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, 99), 1) << "Below the second crossover, the second version is chosen.";
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, 100), 2) << "From the second crossover, the third version is chosen.";
+	EXPECT_EQ(Strategies::choose(Operation::self_intersections, no_crossover - 1), 2) << "The last version is never faster.";
+}
+
+/*!
+ * Test that the GPU version is only chosen if it's available and not busy.
+ */
+TEST_F(StrategiesFixture, GPUBusy) {
+	Strategies::set_crossovers(Operation::area, {10, 100, no_crossover});
+#ifdef GPU
+	EXPECT_EQ(Strategies::choose(Operation::area, 1000), 2) << "The GPU is faster for big inputs.";
+	{
+		const Strategies::GPUReservation reservation;
+		EXPECT_EQ(Strategies::choose(Operation::area, 1000), 1) << "The GPU is being used by a different operation, so fall back to the fastest version on the CPU.";
+	}
+	EXPECT_EQ(Strategies::choose(Operation::area, 1000), 2) << "The GPU is available again.";
+#else
+	EXPECT_EQ(Strategies::choose(Operation::area, 1000), 1) << "Without GPU support, fall back to the fastest version on the CPU.";
+#endif //GPU
+	EXPECT_EQ(Strategies::choose(Operation::area, 50), 1) << "Versions on the CPU are still chosen for smaller inputs.";
+}
+
+/*!
+ * Test saving a profile and loading it again.
+ */
+TEST_F(StrategiesFixture, SaveAndLoad) {
+	Strategies::set_crossovers(Operation::translate, {5, 50, 500});
+	Strategies::set_crossovers(Operation::area_batch, {7, no_crossover, no_crossover});
+	ASSERT_TRUE(Strategies::save_profile(profile_path.string())) << "The temporary directory must be writable.";
+	Strategies::reset();
+	ASSERT_TRUE(Strategies::load_profile(profile_path.string())) << "The profile was just saved, so it must be valid.";
+	EXPECT_EQ(Strategies::get_crossovers(Operation::translate), Crossovers({5, 50, 500})) << "The crossovers must be loaded from the profile.";
+	EXPECT_EQ(Strategies::get_crossovers(Operation::area_batch), Crossovers({7, no_crossover, no_crossover})) << "Missing crossovers must be restored too.";
+	EXPECT_EQ(Strategies::get_crossovers(Operation::area), calibrated_crossovers[static_cast<size_t>(Operation::area)]) << "The other operations are unchanged.";
+}
+
+/*!
+ * Test loading profiles that can't be used.
+ */
+TEST_F(StrategiesFixture, LoadInvalid) {
+	const Crossovers original = Strategies::get_crossovers(Operation::area);
+	EXPECT_FALSE(Strategies::load_profile((profile_path.parent_path() / "apex_nonexistent_profile.txt").string())) << "The profile doesn't exist.";
+
+	for(const std::string line : {"area 10 5 none", "area 10 20", "area 10 twenty 30", "area 10 20x 30"}) {
+		{
+			std::ofstream file(profile_path);
+			file << "#Test profile.\ntranslate 1 2 3\n" << line << "\n";
+		}
+		EXPECT_FALSE(Strategies::load_profile(profile_path.string())) << "The line \"" << line << "\" is invalid.";
+		EXPECT_EQ(Strategies::get_crossovers(Operation::area), original) << "An invalid profile is not loaded at all.";
+		EXPECT_EQ(Strategies::get_crossovers(Operation::translate), calibrated_crossovers[static_cast<size_t>(Operation::translate)]) << "An invalid profile is not loaded at all, not even the valid lines.";
+	}
+
+	{
+		std::ofstream file(profile_path);
+		file << "unknown_operation 1 2 3\narea 1 2 3\n";
+	}
+	EXPECT_TRUE(Strategies::load_profile(profile_path.string())) << "Unknown operations are skipped.";
+	EXPECT_EQ(Strategies::get_crossovers(Operation::area), Crossovers({1, 2, 3})) << "The known operations are loaded.";
+}
+
+/*!
+ * Test finding the crossovers from measured durations.
+ */
+TEST(Strategies, FitCrossovers) {
+	const std::vector<size_t> sizes = {0, 10, 20, 30, 40, 50};
+	const std::vector<std::vector<double>> durations = {
+		{1, 2, 3, 4, 5, 6}, //Low overhead, scales poorly.
+		{3, 3, 2.5, 4.5, 3.5, 4}, //Fastest at 20, but only consistently from 40 on.
+		{10, 10, 10, 10, 10, 1} //Only fastest at the end.
+	};
+	EXPECT_EQ(Strategies::fit_crossovers(sizes, durations), Crossovers({40, 50, no_crossover})) << "Each version must only be chosen from the size where it is consistently faster.";
+
+	const std::vector<std::vector<double>> without_gpu = {
+		{1, 2, 3, 4, 5, 6},
+		{3, 3, 3, 3, 3, 3},
+		{} //Not measured.
+	};
+	EXPECT_EQ(Strategies::fit_crossovers(sizes, without_gpu), Crossovers({30, no_crossover, no_crossover})) << "Versions that weren't measured are never chosen.";
+
+	const std::vector<std::vector<double>> skipping = {
+		{1, 2, 3, 4, 5, 6},
+		{9, 9, 9, 9, 9, 9},
+		{5, 5, 5, 1, 1, 1}
+	};
+	EXPECT_EQ(Strategies::fit_crossovers(sizes, skipping), Crossovers({30, 30, no_crossover})) << "A version that is never fastest is skipped.";
+}
+
+/*!
+ * Test arranging the crossovers of a compiled profile by their operations.
+ */
+TEST(Strategies, IndexCrossovers) {
+	std::array<CalibratedOperation, num_operations> reversed;
+	for(size_t operation = 0; operation < num_operations; ++operation) {
+		reversed[operation] = {static_cast<Operation>(num_operations - 1 - operation), {operation, no_crossover, no_crossover}};
+	}
+	const std::array<Crossovers, num_operations> indexed = index_crossovers(reversed);
+	for(size_t operation = 0; operation < num_operations; ++operation) {
+		EXPECT_EQ(indexed[operation], Crossovers({num_operations - 1 - operation, no_crossover, no_crossover})) << "The crossovers must end up at their operation, regardless of the order in which they are listed.";
+	}
+	EXPECT_THROW(index_crossovers(std::array<CalibratedOperation, num_operations>()), std::invalid_argument) << "Every operation must be listed exactly once, so each entry can't be the first operation.";
+}
+
+}
+
+}
\ No newline at end of file
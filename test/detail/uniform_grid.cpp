@@ -0,0 +1,130 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <algorithm> //To sort the found pairs.
+#include <gtest/gtest.h> //To run the test.
+#include <random> //To generate lots of bounding boxes.
+
+#include "apex/detail/uniform_grid.hpp" //The unit under test.
+
+namespace apex {
+
+namespace detail {
+
+/*!
+ * Collects all candidate pairs from all cells of a grid.
+ * \param grid The grid to find the candidate pairs in.
+ * \return All candidate pairs reported by the grid, sorted.
+ */
+std::vector<std::pair<size_t, size_t>> all_candidates(const UniformGrid& grid) {
+	std::vector<std::pair<size_t, size_t>> result;
+	for(size_t cell = 0; cell < grid.num_cells(); ++cell) {
+		grid.candidates(cell, [&result](const size_t first, const size_t second) {
+			result.emplace_back(first, second);
+		});
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+/*!
+ * Test constructing a grid without any items.
+ */
+TEST(UniformGrid, Empty) {
+	const UniformGrid grid({});
+	EXPECT_EQ(grid.num_cells(), 1) << "Even without items, the grid has a cell.";
+	EXPECT_TRUE(grid.cell(0).empty()) << "There are no items to put in the cell.";
+	EXPECT_TRUE(all_candidates(grid).empty()) << "Without items, there are no pairs of items either.";
+}
+
+/*!
+ * Test constructing a grid with a single item.
+ */
+TEST(UniformGrid, Single) {
+	const UniformGrid grid({{Point2(0, 0), Point2(100, 100)}});
+	EXPECT_EQ(grid.num_cells(), 1) << "With 1 item, there should be 1 cell.";
+	ASSERT_EQ(grid.cell(0).size(), 1) << "The only item must be in the only cell.";
+	EXPECT_EQ(grid.cell(0)[0], 0) << "The only item has index 0.";
+	EXPECT_TRUE(all_candidates(grid).empty()) << "With only 1 item, there are no pairs of items.";
+}
+
+/*!
+ * Test that items whose bounding boxes overlap are reported as a pair, and
+ * items that don't overlap aren't.
+ */
+TEST(UniformGrid, OverlappingPairs) {
+	const UniformGrid grid({
+		{Point2(0, 0), Point2(100, 100)},
+		{Point2(50, 50), Point2(150, 150)}, //Overlaps with the first.
+		{Point2(1000, 1000), Point2(1100, 1100)}, //Doesn't overlap with anything.
+		{Point2(100, 0), Point2(200, 10)} //Touches the first, but not the second.
+	});
+	const std::vector<std::pair<size_t, size_t>> ground_truth = {{0, 1}, {0, 3}};
+	EXPECT_EQ(all_candidates(grid), ground_truth) << "Only the pairs of items whose bounding boxes overlap or touch must be reported.";
+}
+
+/*!
+ * Test that a pair of large items that share many cells is only reported once.
+ */
+TEST(UniformGrid, LargeItemsReportedOnce) {
+	std::vector<std::pair<Point2, Point2>> boxes;
+	for(coord_t i = 0; i < 100; ++i) { //Lots of small items to make a fine grid.
+		boxes.emplace_back(Point2(i * 100, 0), Point2(i * 100 + 10, 10));
+	}
+	boxes.emplace_back(Point2(20, 20), Point2(10000, 10000)); //Two large items covering almost all cells.
+	boxes.emplace_back(Point2(20, 20), Point2(10000, 10000));
+	const UniformGrid grid(boxes);
+	ASSERT_GT(grid.num_cells(), 1) << "The grid needs to have many cells for this test to be meaningful.";
+	const std::vector<std::pair<size_t, size_t>> ground_truth = {{100, 101}};
+	EXPECT_EQ(all_candidates(grid), ground_truth) << "The two large items overlap in many cells, but must only be reported once.";
+}
+
+/*!
+ * Test that every item is placed in the cells that its bounding box covers.
+ */
+TEST(UniformGrid, CellContents) {
+	std::vector<std::pair<Point2, Point2>> boxes;
+	for(coord_t x = 0; x < 4; ++x) {
+		for(coord_t y = 0; y < 4; ++y) {
+			boxes.emplace_back(Point2(x * 100, y * 100), Point2(x * 100 + 10, y * 100 + 10));
+		}
+	}
+	const UniformGrid grid(boxes);
+	for(size_t item = 0; item < boxes.size(); ++item) {
+		const std::span<const size_t> cell = grid.cell(grid.cell_at(boxes[item].first));
+		EXPECT_NE(std::find(cell.begin(), cell.end(), item), cell.end()) << "The item must be in the cell containing its minimum corner.";
+	}
+}
+
+/*!
+ * Test whether the grid finds the same overlapping pairs as comparing all pairs
+ * of many randomly placed bounding boxes.
+ */
+TEST(UniformGrid, MatchesBruteForce) {
+	std::mt19937 randomiser(42); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> position(-10000, 10000);
+	std::uniform_int_distribution<coord_t> size(0, 1000);
+	std::vector<std::pair<Point2, Point2>> boxes;
+	for(size_t item = 0; item < 500; ++item) {
+		const Point2 minimum(position(randomiser), position(randomiser));
+		boxes.emplace_back(minimum, minimum + Point2(size(randomiser), size(randomiser)));
+	}
+	std::vector<std::pair<size_t, size_t>> ground_truth;
+	for(size_t first = 0; first < boxes.size(); ++first) {
+		for(size_t second = first + 1; second < boxes.size(); ++second) {
+			if(boxes[first].first.x <= boxes[second].second.x && boxes[second].first.x <= boxes[first].second.x && boxes[first].first.y <= boxes[second].second.y && boxes[second].first.y <= boxes[first].second.y) {
+				ground_truth.emplace_back(first, second);
+			}
+		}
+	}
+	EXPECT_EQ(all_candidates(UniformGrid(boxes)), ground_truth) << "The grid must report exactly the pairs whose bounding boxes overlap.";
+}
+
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+
+#include "apex/fixed_polygon.hpp" //The code under test.
+#include "helpers/polygon_batch_test_cases.hpp" //To convert batches of polygons.
+#include "helpers/polygon_test_cases.hpp" //To convert polygons.
+
+namespace apex {
+
+/*!
+ * Tests that the fixed-size polygons and batches are recognised as such, so
+ * that operations choose their unrolled overloads.
+ */
+TEST(FixedPolygon, Concepts) {
+	EXPECT_TRUE(fixed_polygonal<FixedPolygon<3>>) << "Fixed-size polygons have a constant number of vertices.";
+	EXPECT_TRUE(fixed_multi_polygonal<Batch<FixedPolygon<3>>>) << "Batches of fixed-size polygons have a constant number of vertices per polygon.";
+	EXPECT_FALSE(fixed_polygonal<Polygon>) << "Normal polygons can have any number of vertices.";
+	EXPECT_FALSE(fixed_multi_polygonal<Batch<Polygon>>) << "Normal batches can have polygons with any number of vertices.";
+}
+
+/*!
+ * Tests constructing a polygon without vertices.
+ */
+TEST(FixedPolygon, ConstructDefault) {
+	const FixedPolygon<3> triangle;
+	EXPECT_EQ(triangle.size(), 3) << "The number of vertices is fixed, even if no vertices were given.";
+	EXPECT_FALSE(triangle.empty());
+	for(const Point2& vertex : triangle) {
+		EXPECT_EQ(vertex, Point2(0, 0)) << "All vertices start at the origin.";
+	}
+}
+
+/*!
+ * Tests constructing a polygon from a list of vertices.
+ */
+TEST(FixedPolygon, ConstructInitialiserList) {
+	const FixedPolygon<3> triangle = {Point2(10, 20), Point2(30, 40), Point2(50, 60)};
+	EXPECT_EQ(triangle[0], Point2(10, 20));
+	EXPECT_EQ(triangle[1], Point2(30, 40));
+	EXPECT_EQ(triangle[2], Point2(50, 60));
+	EXPECT_EQ(triangle.data()[1], Point2(30, 40)) << "The vertices are stored consecutively.";
+}
+
+/*!
+ * Tests constructing a polygon from more vertices than it can hold.
+ */
+TEST(FixedPolygon, ConstructTruncate) {
+	const FixedPolygon<3> triangle = {Point2(10, 20), Point2(30, 40), Point2(50, 60), Point2(70, 80)};
+	EXPECT_EQ(triangle, FixedPolygon<3>({Point2(10, 20), Point2(30, 40), Point2(50, 60)})) << "The excess vertex is dropped.";
+}
+
+/*!
+ * Tests constructing a polygon from fewer vertices than it must hold.
+ */
+TEST(FixedPolygon, ConstructPad) {
+	const FixedPolygon<4> quad = {Point2(10, 20), Point2(30, 40)};
+	EXPECT_EQ(quad[1], Point2(30, 40));
+	EXPECT_EQ(quad[2], Point2(30, 40)) << "The last vertex is repeated to fill up the polygon.";
+	EXPECT_EQ(quad[3], Point2(30, 40)) << "The last vertex is repeated to fill up the polygon.";
+}
+
+/*!
+ * Tests converting polygons with the same number of vertices to fixed-size
+ * polygons and back.
+ */
+TEST(FixedPolygon, ConvertPolygon) {
+	for(const Polygon& original : {PolygonTestCases::square_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::hourglass()}) {
+		const FixedPolygon<4> converted(original);
+		for(size_t vertex = 0; vertex < original.size(); ++vertex) {
+			EXPECT_EQ(converted[vertex], original[vertex]) << "The vertices must be the same, in the same order.";
+		}
+		EXPECT_EQ(converted.to_polygon(), original) << "Converting back must produce the original polygon.";
+	}
+}
+
+/*!
+ * Tests converting an empty polygon, which has no vertex to repeat.
+ */
+TEST(FixedPolygon, ConvertEmpty) {
+	const FixedPolygon<3> converted(PolygonTestCases::empty());
+	for(const Point2& vertex : converted) {
+		EXPECT_EQ(vertex, Point2(0, 0)) << "Without any vertices to copy, the vertices are placed at the origin.";
+	}
+}
+
+/*!
+ * Tests constructing an empty batch.
+ */
+TEST(FixedPolygonBatch, ConstructEmpty) {
+	const Batch<FixedPolygon<3>> empty;
+	EXPECT_EQ(empty.size(), 0) << "The batch was constructed without polygons.";
+	EXPECT_TRUE(empty.empty()) << "The batch was constructed without polygons.";
+	EXPECT_EQ(empty.size_subelements(), 0) << "Without polygons, there are no vertices either.";
+}
+
+/*!
+ * Tests adding polygons to a batch.
+ */
+TEST(FixedPolygonBatch, PushBack) {
+	Batch<FixedPolygon<4>> batch;
+	batch.push_back(PolygonTestCases::square_1000());
+	batch.push_back(PolygonTestCases::triangle_1000());
+	batch.push_back(FixedPolygon<4>({Point2(1, 2), Point2(3, 4), Point2(5, 6), Point2(7, 8)}));
+
+	ASSERT_EQ(batch.size(), 3) << "Three polygons were added.";
+	EXPECT_EQ(batch.size_subelements(), 12) << "Each polygon has 4 vertices.";
+	EXPECT_EQ(batch[1][3], PolygonTestCases::triangle_1000()[2]) << "The triangle was padded with its last vertex.";
+	EXPECT_EQ(batch[2][1], Point2(3, 4));
+	EXPECT_EQ(batch.data()[9], Point2(3, 4)) << "The vertices of all polygons are stored consecutively, 4 per polygon.";
+
+	batch.clear();
+	EXPECT_TRUE(batch.empty()) << "All polygons were removed.";
+	EXPECT_EQ(batch.size_subelements(), 0) << "All vertices were removed.";
+}
+
+/*!
+ * Tests converting batches of polygons to batches of fixed-size polygons and
+ * back.
+ */
+TEST(FixedPolygonBatch, ConvertBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_square(), PolygonBatchTestCases::two_squares()}) {
+		const Batch<FixedPolygon<4>> converted(original);
+		ASSERT_EQ(converted.size(), original.size()) << "The converted batch must have the same number of polygons.";
+		for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+			for(size_t vertex = 0; vertex < original[polygon].size(); ++vertex) {
+				EXPECT_EQ(converted[polygon][vertex], original[polygon][vertex]) << "The vertices must be the same, in the same order.";
+			}
+		}
+		EXPECT_EQ(converted.to_polygons(), original) << "Converting back must produce the original batch.";
+	}
+}
+
+}
\ No newline at end of file
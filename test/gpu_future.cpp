@@ -0,0 +1,79 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+
+#include "apex/gpu_future.hpp" //The unit under test.
+
+namespace apex {
+
+/*!
+ * Test retrieving a result that is available right away.
+ */
+TEST(GPUFuture, Ready) {
+	GPUFuture<int> future(42);
+	EXPECT_TRUE(future.valid()) << "The result hasn't been retrieved yet.";
+	EXPECT_EQ(future.get(), 42) << "The result is the value that the handle was constructed with.";
+	EXPECT_FALSE(future.valid()) << "The result can only be retrieved once.";
+}
+
+/*!
+ * Test waiting for a result that is computed by a deferred task.
+ *
+ * The task runs on the host here, but the handle waits for it in the same way as
+ * for a target region on the GPU.
+ */
+TEST(GPUFuture, WaitForTask) {
+	std::unique_ptr<int> result = std::make_unique<int>(0);
+	int* value = result.get();
+	#pragma omp parallel
+	#pragma omp single
+	{
+		#pragma omp task depend(out:value[0])
+		{
+			value[0] = 21;
+		}
+		GPUFuture<int> future(std::move(result), value, [](int& value) {
+			value *= 2;
+		});
+		EXPECT_EQ(future.get(), 42) << "The handle must wait for the task, and then apply the finishing function.";
+	}
+}
+
+/*!
+ * Test moving a handle before retrieving the result.
+ */
+TEST(GPUFuture, Move) {
+	GPUFuture<int> original(42);
+	GPUFuture<int> moved(std::move(original));
+	EXPECT_FALSE(original.valid()) << "The result moved to the other handle.";
+	ASSERT_TRUE(moved.valid()) << "The result moved to this handle.";
+	EXPECT_EQ(moved.get(), 42) << "The result must be moved along with the handle.";
+}
+
+/*!
+ * Test waiting for a task through a handle without a result.
+ */
+TEST(GPUFuture, WaitWithoutResult) {
+	int value = 0;
+	int* data = &value;
+	#pragma omp parallel
+	#pragma omp single
+	{
+		#pragma omp task depend(inout:data[0])
+		{
+			data[0] = 42;
+		}
+		GPUFuture<void> future(data);
+		future.wait();
+		EXPECT_EQ(value, 42) << "The handle must wait for the task that depends on the same address.";
+		future.wait(); //Waiting again returns immediately.
+	}
+}
+
+}
\ No newline at end of file
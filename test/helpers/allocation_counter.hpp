@@ -0,0 +1,196 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#ifndef APEX_ALLOCATION_COUNTER
+#define APEX_ALLOCATION_COUNTER
+
+#include <atomic> //To count allocations from multiple threads.
+#include <cstdlib> //To allocate memory without going through the counted operators.
+#include <new> //To replace the global allocation functions.
+
+/*
+This helper replaces the global allocation functions with versions that count
+how often they are called. Tests can then verify that an operation didn't
+allocate any memory, for instance to prove that a move doesn't copy the data.
+
+Replacement allocation functions may only be defined once in a program. Since
+every test is compiled into its own executable, this header may be included by
+at most one source file of each test, and never by the test helpers library.
+*/
+
+namespace apex {
+
+/*!
+ * The number of times memory was allocated via the global allocation
+ * functions since the start of the program.
+ */
+inline std::atomic<size_t> allocation_count(0);
+
+/*!
+ * Counts the number of memory allocations made in its lifetime.
+ *
+ * Construct this right before performing the operation to measure, and request
+ * the number of allocations right after.
+ */
+class AllocationCounter {
+public:
+	/*!
+	 * Starts counting allocations.
+	 */
+	AllocationCounter() : start(allocation_count.load()) {}
+
+	/*!
+	 * Get the number of allocations made since this counter was constructed.
+	 * \return The number of allocations made since this counter was constructed.
+	 */
+	size_t allocations() const {
+		return allocation_count.load() - start;
+	}
+
+protected:
+	/*!
+	 * The number of allocations made in the program when this counter was
+	 * constructed.
+	 */
+	size_t start;
+};
+
+}
+
+/*!
+ * Allocates memory, counting the allocation.
+ * \param size The number of bytes to allocate.
+ * \return A pointer to the allocated memory.
+ */
+void* operator new(const size_t size) {
+	apex::allocation_count++;
+	void* result = std::malloc(size == 0 ? 1 : size); //Must return a unique pointer, even for 0 bytes.
+	if(!result) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+/*!
+ * Allocates memory with a specific alignment, counting the allocation.
+ *
+ * This variant is used for instance by the default memory resource of
+ * polymorphic allocators.
+ * \param size The number of bytes to allocate.
+ * \param alignment The alignment of the memory to allocate.
+ * \return A pointer to the allocated memory.
+ */
+void* operator new(const size_t size, const std::align_val_t alignment) {
+	apex::allocation_count++;
+	const size_t align = static_cast<size_t>(alignment);
+	void* result = std::aligned_alloc(align, (size + align) / align * align); //Size must be a multiple of the alignment, and non-zero.
+	if(!result) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+/*!
+ * Allocates memory for an array, counting the allocation.
+ * \param size The number of bytes to allocate.
+ * \return A pointer to the allocated memory.
+ */
+void* operator new[](const size_t size) {
+	return operator new(size);
+}
+
+/*!
+ * Allocates memory for an array with a specific alignment, counting the
+ * allocation.
+ * \param size The number of bytes to allocate.
+ * \param alignment The alignment of the memory to allocate.
+ * \return A pointer to the allocated memory.
+ */
+void* operator new[](const size_t size, const std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+//The compiler sees that these free memory from our own replacement operators, and would warn that they came from operator new rather than malloc.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+/*!
+ * Frees memory allocated by any of the counted allocation functions.
+ * \param pointer The memory to free.
+ */
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+#pragma GCC diagnostic pop
+
+/*!
+ * Frees memory allocated by the counted allocation function.
+ * \param pointer The memory to free.
+ * \param size The size of the memory to free, unused.
+ */
+void operator delete(void* pointer, const size_t) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted aligned allocation function.
+ * \param pointer The memory to free.
+ * \param alignment The alignment of the memory to free, unused.
+ */
+void operator delete(void* pointer, const std::align_val_t) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted aligned allocation function.
+ * \param pointer The memory to free.
+ * \param size The size of the memory to free, unused.
+ * \param alignment The alignment of the memory to free, unused.
+ */
+void operator delete(void* pointer, const size_t, const std::align_val_t) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted array allocation function.
+ * \param pointer The memory to free.
+ */
+void operator delete[](void* pointer) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted array allocation function.
+ * \param pointer The memory to free.
+ * \param size The size of the memory to free, unused.
+ */
+void operator delete[](void* pointer, const size_t) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted aligned array allocation function.
+ * \param pointer The memory to free.
+ * \param alignment The alignment of the memory to free, unused.
+ */
+void operator delete[](void* pointer, const std::align_val_t) noexcept {
+	operator delete(pointer);
+}
+
+/*!
+ * Frees memory allocated by the counted aligned array allocation function.
+ * \param pointer The memory to free.
+ * \param size The size of the memory to free, unused.
+ * \param alignment The alignment of the memory to free, unused.
+ */
+void operator delete[](void* pointer, const size_t, const std::align_val_t) noexcept {
+	operator delete(pointer);
+}
+
+#endif //APEX_ALLOCATION_COUNTER
\ No newline at end of file
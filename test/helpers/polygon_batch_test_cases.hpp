@@ -65,10 +65,8 @@ protected:
 	 * a polygon, which is added to the batch. This way, the easy-to-visualise
 	 * SVG files can be used to create test cases.
 	 *
-	 * No transformations or CSS is applied. Other SVG elements such as
-	 * ``<path>`` are not parsed. The parser in this loader is extremely simple
-	 * and naive. This prevents needing a whole new library just to read test
-	 * cases.
+	 * This uses ``load_svg``, so paths are loaded as polygons too. No
+	 * transformations or CSS is applied.
 	 * \param svg The contents of an SVG file containing the polygons to load.
 	 * \return A ``Batch`` of ``Polygon`` with the loaded test data.
 	 */
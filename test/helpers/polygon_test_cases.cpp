@@ -9,6 +9,7 @@
 #include <cmath> //For trigonometry functions to construct an approximation of a circle.
 #include <numbers> //For use of pi to construct an approximation of a circle by radians.
 
+#include "apex/load.hpp" //To parse the SVG files.
 #include "polygon_test_cases.hpp" //The definition we're implementing.
 
 namespace apex {
@@ -135,47 +136,11 @@ Polygon PolygonTestCases::circle() {
 }
 
 Polygon PolygonTestCases::load_polygon(const std::string& svg) {
-	Polygon result;
-
-	size_t position = 0;
-	position = svg.find("<polygon ", position) + 9;
-	if(position == std::string::npos) { //There is no polygon in this SVG file.
-		return result;
-	}
-	position = svg.find("points=\"", position) + 8;
-	if(position == std::string::npos) { //There is no points in this polygon (or maybe whitespace is not as we expect here).
-		return result;
-	}
-	const size_t points_end = svg.find("\"", position);
-	if(points_end == std::string::npos) { //The points never end. Malformed file or incomplete.
-		return result;
-	}
-
-	std::vector<coord_t> coordinates; //Until we paired them up, store all single coordinates.
-	while(position < points_end) {
-		while((svg[position] == ',' || svg[position] == ' ') && position < points_end) {
-			++position; //Skip over delimiter(s).
-		}
-		//We are now at the start of the coordinate. Find the end.
-		const size_t coordinate_end = std::min(svg.find(",", position), std::min(svg.find(" ", position), svg.find("\"", position)));
-
-		//Turn this substring into a coordinate and store it.
-		const std::string coordinate_str = svg.substr(position, coordinate_end - position);
-		try {
-			coordinates.push_back(std::stoll(coordinate_str));
-		} catch(const std::invalid_argument exception) { //Not a valid numerical coordinate here.
-			//Ignore. Just continue setting the position to the end of this coordinate and parse the next one.
-		}
-
-		//Continue from the end with finding the next coordinate.
-		position = coordinate_end;
-	}
-
-	for(size_t coordinate = 0; coordinate + 1 < coordinates.size(); coordinate += 2) {
-		result.emplace_back(coordinates[coordinate], coordinates[coordinate + 1]); //Combine each pair of coordinates into a point.
+	const Batch<Polygon> polygons = load_svg(svg);
+	if(polygons.empty()) { //There is no polygon in this SVG file.
+		return Polygon();
 	}
-
-	return result;
+	return Polygon(polygons[0]);
 }
 
 }
\ No newline at end of file
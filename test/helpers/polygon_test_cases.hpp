@@ -72,10 +72,8 @@ protected:
 	 * polygon. This way, the easy-to-visualise SVG files can be used to create
 	 * test cases.
 	 *
-	 * Only the first polygon in the file is used. No transformations or CSS is
-	 * applied. Other SVG elements such as ``<path>`` are not parsed. The parser
-	 * in this loader is extremely simple and naive. This prevents needing a
-	 * whole new library just to read test cases.
+	 * Only the first polygon in the file is used. This uses ``load_svg``, so
+	 * paths are loaded as polygons too. No transformations or CSS is applied.
 	 * \param svg The contents of an SVG file containing the polygon to load.
 	 * \return A Polygon with the loaded test data.
 	 */
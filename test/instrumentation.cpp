@@ -0,0 +1,181 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+#include <vector> //To collect the reported events.
+
+#ifndef INSTRUMENTATION //The build may already compile it in, with WITH_INSTRUMENTATION.
+#define INSTRUMENTATION //Compile the instrumentation in, to test it. This must be defined before including any of the library.
+#endif //INSTRUMENTATION
+#include "apex/detail/gpu_data_tracker.hpp" //To test reporting transfers.
+#include "apex/instrumentation.hpp" //The unit under test.
+#include "apex/operations/area.hpp" //To test reporting the versions of an operation.
+#include "apex/operations/self_intersections.hpp" //To test counting the tested pairs of edges.
+#include "apex/operations/translate.hpp" //An operation that doesn't cache its result, to call repeatedly.
+#include "apex/polygon.hpp" //To have something to perform operations on.
+
+namespace apex {
+
+/*!
+ * Fixture that removes all callbacks and resets the counters and crossovers
+ * after each test, so that the tests don't influence each other.
+ */
+class InstrumentationFixture : public ::testing::Test {
+public:
+	/*!
+	 * A simple polygon to perform operations on.
+	 */
+	Polygon square = {Point2(0, 0), Point2(10, 0), Point2(10, 10), Point2(0, 10)};
+
+	/*!
+	 * Starts with zeroed counters.
+	 */
+	void SetUp() {
+		Instrumentation::reset_counters();
+	}
+
+	/*!
+	 * Removes the callbacks and restores the crossovers.
+	 */
+	void TearDown() {
+		Instrumentation::clear_callbacks();
+		Instrumentation::reset_counters();
+		Instrumentation::enable_hardware_counters(false);
+		detail::Strategies::reset();
+	}
+};
+
+/*!
+ * Test that the instrumentation is compiled in when the macro is defined.
+ */
+TEST_F(InstrumentationFixture, Compiled) {
+	EXPECT_TRUE(Instrumentation::compiled) << "The INSTRUMENTATION macro was defined, so the instrumentation must be compiled in.";
+}
+
+/*!
+ * Test that the version chosen by an operation is reported.
+ */
+TEST_F(InstrumentationFixture, StrategyChosen) {
+	detail::Strategies::set_crossovers(detail::Operation::area, {2, detail::no_crossover, detail::no_crossover});
+	std::vector<StrategyEvent> events;
+	Instrumentation::add_strategy_callback([&events](const StrategyEvent& event) {
+		events.push_back(event);
+	});
+
+	EXPECT_EQ(area(square), 100);
+	ASSERT_EQ(events.size(), 1) << "The operation chose a version once.";
+	EXPECT_EQ(events[0].operation, detail::Operation::area);
+	EXPECT_STREQ(events[0].operation_name(), "area");
+	EXPECT_EQ(events[0].size, 4) << "The size of the area operation is the number of vertices.";
+	EXPECT_EQ(events[0].version, 1) << "With 4 vertices, the size is beyond the first crossover, so the second version was chosen.";
+}
+
+/*!
+ * Test that the chosen version of an operation is timed.
+ */
+TEST_F(InstrumentationFixture, KernelTimed) {
+	std::vector<KernelEvent> events;
+	Instrumentation::add_kernel_callback([&events](const KernelEvent& event) {
+		events.push_back(event);
+	});
+
+	area(square);
+	ASSERT_EQ(events.size(), 1) << "The operation executed one version.";
+	EXPECT_EQ(events[0].operation, detail::Operation::area);
+	EXPECT_EQ(events[0].version, detail::Strategies::choose(detail::Operation::area, square.size())) << "The version that was chosen was also executed.";
+	EXPECT_GE(events[0].duration.count(), 0);
+	EXPECT_FALSE(events[0].hardware.valid) << "The hardware counters are not enabled.";
+}
+
+/*!
+ * Test that callbacks are no longer called after they are removed.
+ */
+TEST_F(InstrumentationFixture, RemoveCallback) {
+	size_t strategy_calls = 0;
+	size_t kernel_calls = 0;
+	const size_t strategy_handle = Instrumentation::add_strategy_callback([&strategy_calls](const StrategyEvent&) {
+		strategy_calls++;
+	});
+	Instrumentation::add_kernel_callback([&kernel_calls](const KernelEvent&) {
+		kernel_calls++;
+	});
+
+	translate(square, Point2(1, 1));
+	Instrumentation::remove_callback(strategy_handle);
+	translate(square, Point2(1, 1));
+	EXPECT_EQ(strategy_calls, 1) << "The strategy callback was removed after the first operation.";
+	EXPECT_EQ(kernel_calls, 2) << "Only the strategy callback was removed.";
+
+	Instrumentation::clear_callbacks();
+	translate(square, Point2(1, 1));
+	EXPECT_EQ(kernel_calls, 2) << "All callbacks were removed.";
+}
+
+/*!
+ * Test counting the pairs of edges that are tested for self-intersections.
+ */
+TEST_F(InstrumentationFixture, PairsTested) {
+	const Polygon hourglass = {Point2(0, 0), Point2(10, 0), Point2(0, 10), Point2(10, 10)};
+	detail::self_intersections_st_naive(hourglass);
+	EXPECT_GT(Instrumentation::get_counter(Counter::pairs_tested), 0) << "The two crossing edges must have been tested.";
+
+	Instrumentation::reset_counters();
+	detail::self_intersections_st_sweep(hourglass);
+	EXPECT_GT(Instrumentation::get_counter(Counter::pairs_tested), 0) << "The two crossing edges overlap along the sweep line, so they must have been tested.";
+
+	Instrumentation::reset_counters();
+	EXPECT_EQ(Instrumentation::get_counter(Counter::pairs_tested), 0) << "The counters were reset.";
+}
+
+/*!
+ * Test that transfers by the GPU data tracker are reported and counted.
+ */
+TEST_F(InstrumentationFixture, Transfers) {
+	std::vector<TransferEvent> events;
+	Instrumentation::add_transfer_callback([&events](const TransferEvent& event) {
+		events.push_back(event);
+	});
+	const std::vector<Point2> points = {Point2(0, 0), Point2(10, 0), Point2(10, 10)};
+
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	ASSERT_EQ(events.size(), 1) << "The data was transferred to the GPU once.";
+	EXPECT_EQ(events[0].direction, TransferEvent::Direction::TO_DEVICE);
+	EXPECT_EQ(events[0].bytes, points.size() * sizeof(Point2));
+	EXPECT_FALSE(events[0].asynchronous);
+
+	GPUDataTracker::sync_to_gpu(points.data(), points.size(), &points);
+	EXPECT_EQ(events.size(), 1) << "The GPU already had the data, so nothing was transferred.";
+
+	GPUDataTracker::changed_on_gpu(points.data());
+	GPUDataTracker::sync_to_host(points.data());
+	ASSERT_EQ(events.size(), 2) << "The data changed on the GPU, so it was transferred back.";
+	EXPECT_EQ(events[1].direction, TransferEvent::Direction::TO_HOST);
+	EXPECT_EQ(Instrumentation::get_counter(Counter::bytes_to_device), points.size() * sizeof(Point2));
+	EXPECT_EQ(Instrumentation::get_counter(Counter::bytes_to_host), points.size() * sizeof(Point2));
+	GPUDataTracker::release(points.data());
+}
+
+/*!
+ * Test reading the hardware performance counters, if they are available.
+ */
+TEST_F(InstrumentationFixture, HardwareCounters) {
+	if(!Instrumentation::enable_hardware_counters(true)) {
+		GTEST_SKIP() << "The hardware performance counters can't be read on this computer.";
+	}
+	std::vector<KernelEvent> events;
+	Instrumentation::add_kernel_callback([&events](const KernelEvent& event) {
+		events.push_back(event);
+	});
+
+	area(square);
+	ASSERT_EQ(events.size(), 1);
+	EXPECT_TRUE(events[0].hardware.valid) << "The counters are available, so they must have been read.";
+	EXPECT_GT(events[0].hardware.instructions, 0) << "Computing the area takes some instructions.";
+}
+
+}
\ No newline at end of file
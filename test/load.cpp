@@ -0,0 +1,232 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <filesystem> //To load files.
+#include <fstream> //To write files to load.
+#include <gtest/gtest.h> //To run the test.
+#include <omp.h> //To force parsing on multiple threads.
+#include <stdexcept> //To test loading malformed input.
+#include <string> //To construct inputs to load.
+
+#include "apex/load.hpp" //The code under test.
+#include "helpers/allocation_counter.hpp" //To test that vertices are not allocated one by one.
+
+namespace apex {
+
+/*!
+ * Parses a single coordinate from the start of a string.
+ * \param text The text to parse.
+ * \return The coordinate at the start of the text.
+ */
+coord_t parse(const std::string& text) {
+	const char* position = text.data();
+	return detail::parse_coordinate(position, text.data() + text.size());
+}
+
+/*!
+ * Tests parsing integers of every length, both in blocks and one character at a
+ * time at the end of the text.
+ */
+TEST(Load, ParseIntegers) {
+	coord_t expected = 0;
+	std::string digits = "";
+	for(char digit = '1'; digit <= '9'; ++digit) {
+		digits += digit;
+		expected = expected * 10 + (digit - '0');
+		EXPECT_EQ(parse(digits), expected) << "Parsing at the end of the text, one character at a time.";
+		EXPECT_EQ(parse(digits + " 12345678"), expected) << "Parsing with enough room to process the digits in blocks.";
+		EXPECT_EQ(parse("-" + digits + ",00000000"), -expected) << "Parsing a negative number.";
+	}
+	EXPECT_EQ(parse("0"), 0) << "Zero is a single digit.";
+	EXPECT_EQ(parse("+42,        "), 42) << "A positive sign is allowed.";
+	EXPECT_EQ(parse("2147483647          "), 2147483647) << "The largest coordinate spans more than one block.";
+	EXPECT_EQ(parse("-2147483648         "), -2147483648) << "The smallest coordinate is one further from zero than the largest one.";
+}
+
+/*!
+ * Tests that the parser stops at the end of the number, and leaves the position
+ * there.
+ */
+TEST(Load, ParseEnd) {
+	const std::string text = "123-45 ";
+	const char* position = text.data();
+	EXPECT_EQ(detail::parse_coordinate(position, text.data() + text.size()), 123) << "The first number ends at the minus sign.";
+	EXPECT_EQ(position, text.data() + 3) << "The position must be left right after the first number.";
+	EXPECT_EQ(detail::parse_coordinate(position, text.data() + text.size()), -45) << "The second number starts with the minus sign.";
+}
+
+/*!
+ * Tests parsing numbers with decimals or exponents, which are rounded.
+ */
+TEST(Load, ParseDecimals) {
+	EXPECT_EQ(parse("12.4"), 12) << "Rounded down.";
+	EXPECT_EQ(parse("12.5 0000000"), 13) << "Rounded up.";
+	EXPECT_EQ(parse("-12.6"), -13) << "Negative numbers are rounded to the nearest coordinate too.";
+	EXPECT_EQ(parse(".5"), 1) << "Numbers may start at the decimal point.";
+	EXPECT_EQ(parse("1.5e2"), 150) << "Numbers may have an exponent.";
+}
+
+/*!
+ * Tests that malformed or too big numbers are refused.
+ */
+TEST(Load, ParseErrors) {
+	EXPECT_THROW(parse("abc"), std::invalid_argument) << "This is not a number.";
+	EXPECT_THROW(parse("-"), std::invalid_argument) << "There are no digits after the sign.";
+	EXPECT_THROW(parse("2147483648"), std::out_of_range) << "This doesn't fit in a coordinate.";
+	EXPECT_THROW(parse("-2147483649         "), std::out_of_range) << "This doesn't fit in a coordinate.";
+	EXPECT_THROW(parse("1234567890123456789012345"), std::out_of_range) << "This doesn't fit in a coordinate, nor in any integer.";
+	EXPECT_THROW(parse("1e20"), std::out_of_range) << "The exponent makes this too big for a coordinate.";
+}
+
+/*!
+ * Tests loading the polygons from an SVG document.
+ */
+TEST(Load, SVGPolygons) {
+	const Batch<Polygon> result = load_svg(R"(<?xml version="1.0" encoding="utf-8" ?>
+<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000">
+	<polygon points="0,0 1000,0 1000,1000 0,1000" />
+	<polygon fill="red" points='10 20, -30 40' />
+	<polygon points="" />
+	<polygon fill="green" />
+	<polygonal points="5,5" />
+	<rect data-points="1,2,3,4" />
+</svg>)");
+	ASSERT_EQ(result.size(), 4) << "There are 4 polygon elements. Other elements are ignored.";
+	EXPECT_EQ(result[0], Polygon({Point2(0, 0), Point2(1000, 0), Point2(1000, 1000), Point2(0, 1000)}));
+	EXPECT_EQ(result[1], Polygon({Point2(10, 20), Point2(-30, 40)})) << "Any whitespace or commas separate the coordinates.";
+	EXPECT_TRUE(result[2].empty()) << "This polygon has no points.";
+	EXPECT_TRUE(result[3].empty()) << "Polygons without points attribute are empty too.";
+}
+
+/*!
+ * Tests loading the polygons from the paths in an SVG document.
+ */
+TEST(Load, SVGPaths) {
+	const Batch<Polygon> result = load_svg(R"(<svg>
+	<path d="M0,0 L100,0 100,100 Z m 200,0 h 50 v 50 h -50 z" />
+	<path d="M0 0 C 10 10 20 10 30 0 Q 40 -10 50 0 A 5 5 0 0150,10 T 0 10" />
+	<path d="M 0 0 L 10 0 L 0 10 Z L -10 0" />
+	<pathology d="M 5 5 L 6 6" />
+</svg>)");
+	ASSERT_EQ(result.size(), 5) << "Each subpath becomes a polygon.";
+	EXPECT_EQ(result[0], Polygon({Point2(0, 0), Point2(100, 0), Point2(100, 100)})) << "Absolute lines, with implicit repetition.";
+	EXPECT_EQ(result[1], Polygon({Point2(200, 0), Point2(250, 0), Point2(250, 50), Point2(200, 50)})) << "Relative commands, starting from the start of the previous subpath, where it was closed.";
+	EXPECT_EQ(result[2], Polygon({Point2(0, 0), Point2(30, 0), Point2(50, 0), Point2(50, 10), Point2(0, 10)})) << "Curves and arcs are replaced by their end points.";
+	EXPECT_EQ(result[3], Polygon({Point2(0, 0), Point2(10, 0), Point2(0, 10)}));
+	EXPECT_EQ(result[4], Polygon({Point2(0, 0), Point2(-10, 0)})) << "Drawing after closing starts a new subpath from the start of the closed one.";
+}
+
+/*!
+ * Tests that malformed SVG documents are refused.
+ */
+TEST(Load, SVGErrors) {
+	EXPECT_THROW(load_svg(R"(<polygon points="0,0 10" />)"), std::invalid_argument) << "The last vertex is missing its Y coordinate.";
+	EXPECT_THROW(load_svg(R"(<polygon points="0,0 10,a" />)"), std::invalid_argument) << "That's not a number.";
+	EXPECT_THROW(load_svg(R"(<path d="10,10" />)"), std::invalid_argument) << "The path must start with a command.";
+	EXPECT_THROW(load_svg(R"(<path d="M 0 0 X 10 10" />)"), std::invalid_argument) << "That's not a command of SVG paths.";
+	EXPECT_THROW(load_svg(R"(<polygon points="0,0 10,10 />)"), std::invalid_argument) << "The attribute is never closed.";
+}
+
+/*!
+ * Tests loading polygons from a list of vertices.
+ */
+TEST(Load, Vertices) {
+	const Batch<Polygon> result = load_vertices("# A comment.\n"
+		"0 0\n"
+		"100\t0\n"
+		"100,100 25\n"
+		"\n"
+		"\r\n"
+		"  \n"
+		"-5 -5\r\n"
+		"-6 -6");
+	ASSERT_EQ(result.size(), 2) << "Blank lines separate the polygons. Multiple blank lines don't make empty polygons.";
+	EXPECT_EQ(result[0], Polygon({Point2(0, 0), Point2(100, 0), Point2(100, 100)})) << "Coordinates may be separated by whitespace or commas. Further columns are ignored.";
+	EXPECT_EQ(result[1], Polygon({Point2(-5, -5), Point2(-6, -6)})) << "The last line doesn't need to end with a newline.";
+
+	EXPECT_TRUE(load_vertices("").empty()) << "There are no polygons without text.";
+	EXPECT_THROW(load_vertices("0 0\n5\n"), std::invalid_argument) << "The second vertex is missing its Y coordinate.";
+}
+
+/*!
+ * Tests that large inputs are parsed in parallel with the same result as when
+ * parsing them on one thread.
+ */
+TEST(Load, Parallel) {
+	std::string vertices;
+	std::string svg = "<svg>\n";
+	for(coord_t polygon = 0; polygon < 30000; ++polygon) {
+		svg += "<polygon points=\"";
+		for(coord_t vertex = 0; vertex < 10; ++vertex) {
+			const std::string x = std::to_string(polygon * 100 + vertex);
+			const std::string y = std::to_string(-vertex);
+			vertices += x + " " + y + "\n";
+			svg += x + "," + y + " ";
+		}
+		vertices += "\n";
+		svg += "\" />\n";
+	}
+	svg += "</svg>";
+	ASSERT_GT(vertices.size(), 2 * detail::parse_chunk_size) << "The input must be big enough to be split among threads.";
+
+	const int num_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+	const Batch<Polygon> serial_vertices = load_vertices(vertices);
+	const Batch<Polygon> serial_svg = load_svg(svg);
+	omp_set_num_threads(4);
+	const Batch<Polygon> parallel_vertices = load_vertices(vertices);
+	const Batch<Polygon> parallel_svg = load_svg(svg);
+	omp_set_num_threads(num_threads);
+
+	ASSERT_EQ(serial_vertices.size(), 30000) << "Each polygon must be loaded.";
+	EXPECT_EQ(parallel_vertices, serial_vertices) << "Parsing in parallel must give the same polygons as parsing serially.";
+	EXPECT_EQ(serial_svg, serial_vertices) << "Both formats contain the same polygons.";
+	EXPECT_EQ(parallel_svg, serial_svg) << "Parsing in parallel must give the same polygons as parsing serially.";
+	EXPECT_EQ(parallel_svg[12345][3], Point2(1234503, -3)) << "The polygons must be in the original order.";
+}
+
+/*!
+ * Tests that the vertices are not allocated one by one.
+ */
+TEST(Load, FewAllocations) {
+	std::string vertices;
+	for(coord_t vertex = 0; vertex < 10000; ++vertex) {
+		vertices += std::to_string(vertex) + " " + std::to_string(vertex) + (vertex % 100 == 99 ? "\n\n" : "\n");
+	}
+	const AllocationCounter counter;
+	const Batch<Polygon> result = load_vertices(vertices);
+	EXPECT_EQ(result.size(), 100) << "Each group of 100 vertices is a polygon.";
+	EXPECT_LT(counter.allocations(), 50) << "The vertex buffer grows geometrically, and is adopted by the batch without copying.";
+}
+
+/*!
+ * Tests loading files, which are mapped into memory.
+ */
+TEST(Load, Files) {
+	const std::filesystem::path filename = std::filesystem::temp_directory_path() / "apex_load.txt";
+	{
+		std::ofstream file(filename);
+		file << "1 2\n3 4\n5 6\n";
+	}
+	const Batch<Polygon> vertices = load_vertices_file(filename);
+	ASSERT_EQ(vertices.size(), 1) << "There is one polygon in the file.";
+	EXPECT_EQ(vertices[0], Polygon({Point2(1, 2), Point2(3, 4), Point2(5, 6)}));
+	{
+		std::ofstream file(filename);
+		file << "<svg><polygon points=\"1,2 3,4 5,6\"/></svg>";
+	}
+	EXPECT_EQ(load_svg_file(filename), vertices) << "The SVG file contains the same polygon.";
+	{
+		std::ofstream file(filename);
+	}
+	EXPECT_TRUE(load_vertices_file(filename).empty()) << "An empty file contains no polygons.";
+	std::filesystem::remove(filename);
+	EXPECT_THROW(load_svg_file(filename), std::system_error) << "The file doesn't exist any more.";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <filesystem> //To create and clean up the files to map.
+#include <fstream> //To write malformed files.
+#include <gtest/gtest.h> //To run the test.
+#include <stdexcept> //To test reading malformed files.
+#include <string> //To give each test its own file.
+#include <system_error> //To test reading files that don't exist.
+
+#include "apex/mapped_polygon_batch.hpp" //The code under test.
+#include "apex/polygon.hpp" //To write batches of polygons to the files.
+#include "helpers/polygon_batch_test_cases.hpp" //To load testing polygons to write.
+
+namespace apex {
+
+/*!
+ * Fixture that provides a file for each test to write to, and removes it after
+ * the test.
+ */
+class MappedPolygonBatchFixture : public ::testing::Test {
+public:
+	/*!
+	 * The file that this test may write to.
+	 */
+	std::filesystem::path filename;
+
+	/*!
+	 * Chooses a file in the temporary directory, unique to this test.
+	 */
+	void SetUp() {
+		filename = std::filesystem::temp_directory_path() / (std::string("apex_") + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".polygons");
+	}
+
+	/*!
+	 * Removes the file again.
+	 */
+	void TearDown() {
+		std::filesystem::remove(filename);
+	}
+
+	/*!
+	 * Checks that a mapped batch contains the same polygons as a batch in
+	 * memory.
+	 * \param mapped The mapped batch to check.
+	 * \param original The batch that it should be equal to.
+	 */
+	void expect_equal(const MappedPolygonBatch& mapped, const Batch<Polygon>& original) {
+		ASSERT_EQ(mapped.size(), original.size()) << "Each polygon must have been stored.";
+		size_t total_vertices = 0;
+		for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+			ASSERT_EQ(mapped[polygon].size(), original[polygon].size()) << "Each polygon must have the same number of vertices.";
+			for(size_t vertex = 0; vertex < original[polygon].size(); ++vertex) {
+				EXPECT_EQ(mapped[polygon][vertex], original[polygon][vertex]) << "Each vertex must be stored in the same place.";
+			}
+			total_vertices += original[polygon].size();
+		}
+		EXPECT_EQ(mapped.size_subelements(), total_vertices) << "The mapped vertices must not have any space in between.";
+	}
+};
+
+/*!
+ * Tests writing and mapping an empty batch.
+ */
+TEST_F(MappedPolygonBatchFixture, Empty) {
+	MappedPolygonBatch::write(PolygonBatchTestCases::empty(), filename);
+	const MappedPolygonBatch mapped(filename);
+	EXPECT_TRUE(mapped.empty()) << "There were no polygons in the batch that was written.";
+	EXPECT_EQ(mapped.size_subelements(), 0) << "There are no vertices without polygons.";
+	EXPECT_TRUE(mapped.area().empty()) << "There are no polygons to compute the area of.";
+}
+
+/*!
+ * Tests that mapping a file gives the same polygons as the batch that was
+ * written.
+ */
+TEST_F(MappedPolygonBatchFixture, RoundTrip) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases();
+	MappedPolygonBatch::write(original, filename);
+	const MappedPolygonBatch mapped(filename);
+	expect_equal(mapped, original);
+
+	size_t polygon = 0;
+	for(MappedPolygonBatch::const_iterator it = mapped.begin(); it != mapped.end(); ++it) {
+		EXPECT_EQ((*it).size(), original[polygon].size()) << "Iterating must visit the polygons in order.";
+		++polygon;
+	}
+	EXPECT_EQ(polygon, original.size()) << "Iterating must visit all polygons.";
+}
+
+/*!
+ * Tests that the vertices are mapped directly from the file, aligned to be
+ * loaded with SIMD instructions.
+ */
+TEST_F(MappedPolygonBatchFixture, Aligned) {
+	MappedPolygonBatch::write(PolygonBatchTestCases::square_triangle_square(), filename);
+	const MappedPolygonBatch mapped(filename);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.data_subelements()) % 64, 0) << "The vertices must be aligned to 64 bytes.";
+	EXPECT_EQ(&mapped[1][0], mapped.data_subelements() + mapped[0].size()) << "The polygons must be stored consecutively.";
+}
+
+/*!
+ * Tests that free space in between the polygons of the batch doesn't end up in
+ * the file.
+ */
+TEST_F(MappedPolygonBatchFixture, Compacts) {
+	Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	original[0].emplace_back(50, 50); //Makes the first polygon grow, which may move it or leave space behind.
+	original.erase(original.begin() + 1); //Leaves a hole where the triangle was.
+	MappedPolygonBatch::write(original, filename);
+	const MappedPolygonBatch mapped(filename);
+	expect_equal(mapped, original);
+}
+
+/*!
+ * Tests computing the area of the polygons in the mapped file.
+ */
+TEST_F(MappedPolygonBatchFixture, Area) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases();
+	MappedPolygonBatch::write(original, filename, false);
+	const MappedPolygonBatch mapped(filename);
+	const Batch<area_t> ground_truth = detail::area_st(original);
+	EXPECT_EQ(mapped.area(), ground_truth) << "The areas must be the same as those of the original batch.";
+	EXPECT_EQ(detail::area_st(mapped), ground_truth) << "The single-threaded version must work on the mapped memory.";
+	EXPECT_EQ(detail::area_mt(mapped), ground_truth) << "The multi-threaded version must work on the mapped memory.";
+	EXPECT_EQ(detail::area_simd(mapped), ground_truth) << "The SIMD version must work on the mapped memory.";
+#ifdef GPU
+	EXPECT_EQ(detail::area_gpu(mapped), ground_truth) << "The GPU version must work on the mapped memory.";
+#endif //GPU
+	for(size_t polygon = 0; polygon < mapped.size(); ++polygon) {
+		EXPECT_TRUE(mapped.get_properties(polygon).has_area()) << "The area must be cached after computing it.";
+	}
+}
+
+/*!
+ * Tests moving the polygons in the mapped file, which must not modify the file
+ * itself.
+ */
+TEST_F(MappedPolygonBatchFixture, Translate) {
+	Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	MappedPolygonBatch::write(original, filename);
+	{
+		MappedPolygonBatch mapped(filename);
+		mapped.translate(Point2(100, -50));
+		Batch<Polygon> translated = original;
+		translated.translate(Point2(100, -50));
+		expect_equal(mapped, translated);
+	}
+	const MappedPolygonBatch unchanged(filename);
+	expect_equal(unchanged, original);
+}
+
+/*!
+ * Tests finding self-intersections in the polygons of the mapped file.
+ */
+TEST_F(MappedPolygonBatchFixture, SelfIntersections) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases();
+	MappedPolygonBatch::write(original, filename, false);
+	const MappedPolygonBatch mapped(filename);
+	EXPECT_EQ(mapped.self_intersections(), detail::self_intersections_st(original)) << "The self-intersections must be the same as those of the original batch.";
+	EXPECT_EQ(detail::self_intersections_mt(mapped), detail::self_intersections_st(original)) << "The multi-threaded version must work on the mapped memory.";
+}
+
+/*!
+ * Tests that the cached properties of the polygons are stored in the file.
+ */
+TEST_F(MappedPolygonBatchFixture, Properties) {
+	const Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	const Batch<area_t> areas = original.area(); //Caches the areas in the batch.
+	MappedPolygonBatch::write(original, filename);
+	{
+		const MappedPolygonBatch mapped(filename);
+		ASSERT_TRUE(mapped.has_mapped_properties()) << "The properties were written.";
+		for(size_t polygon = 0; polygon < mapped.size(); ++polygon) {
+			ASSERT_TRUE(mapped.get_properties(polygon).has_area()) << "The area was known when writing the file.";
+			EXPECT_EQ(mapped.get_properties(polygon).area(), areas[polygon]) << "The cached area must be stored in the file.";
+		}
+	}
+
+	MappedPolygonBatch::write(original, filename, false);
+	const MappedPolygonBatch mapped(filename);
+	EXPECT_FALSE(mapped.has_mapped_properties()) << "The properties were not written this time.";
+	for(size_t polygon = 0; polygon < mapped.size(); ++polygon) {
+		EXPECT_FALSE(mapped.get_properties(polygon).has_area()) << "Nothing is known about the polygons without stored properties.";
+	}
+}
+
+/*!
+ * Tests that modifying the vertices of a polygon in the mapped file makes its
+ * cached properties unknown again.
+ */
+TEST_F(MappedPolygonBatchFixture, ModifyInvalidatesProperties) {
+	Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	original.area(); //Caches the areas in the batch, so that they are stored in the file.
+	MappedPolygonBatch::write(original, filename);
+	MappedPolygonBatch mapped(filename);
+	ASSERT_TRUE(mapped.get_properties(0).has_area()) << "The area was known when writing the file.";
+	const area_t old_area = mapped.area()[0];
+
+	mapped[0][2] += Point2(1000, 1000); //Moves one corner of the square away from the origin.
+	EXPECT_FALSE(mapped.get_properties(0).has_area()) << "The cached area is no longer valid after modifying the polygon.";
+	original[0][2] += Point2(1000, 1000);
+	EXPECT_NE(mapped.area()[0], old_area) << "The area must have changed by moving a vertex.";
+	EXPECT_EQ(mapped.area()[0], original.area()[0]) << "The area must be computed from the modified vertices.";
+}
+
+/*!
+ * Tests moving a mapping to a different batch.
+ */
+TEST_F(MappedPolygonBatchFixture, Move) {
+	const Batch<Polygon> original = PolygonBatchTestCases::square_triangle();
+	MappedPolygonBatch::write(original, filename);
+	MappedPolygonBatch mapped(filename);
+	const Point2* vertices = mapped.data_subelements();
+	MappedPolygonBatch moved(std::move(mapped));
+	EXPECT_EQ(moved.data_subelements(), vertices) << "The vertices must stay in the same place in memory.";
+	EXPECT_TRUE(mapped.empty()) << "The mapping was moved away from the original batch.";
+	expect_equal(moved, original);
+}
+
+/*!
+ * Tests that files that are not batches of polygons are refused.
+ */
+TEST_F(MappedPolygonBatchFixture, Malformed) {
+	EXPECT_THROW(MappedPolygonBatch(std::filesystem::temp_directory_path() / "apex_does_not_exist.polygons"), std::system_error) << "The file doesn't exist.";
+
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file << "This is just some text, long enough to fill the header of the file format.";
+	}
+	EXPECT_THROW(MappedPolygonBatch mapped(filename), std::runtime_error) << "The file doesn't start with the right magic number.";
+
+	MappedPolygonBatch::write(PolygonBatchTestCases::square_triangle(), filename);
+	std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 8);
+	EXPECT_THROW(MappedPolygonBatch mapped(filename), std::runtime_error) << "The properties are cut off at the end of the file.";
+}
+
+}
\ No newline at end of file
@@ -11,7 +11,10 @@
 
 #include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches of polygons to compute the area of.
 #include "../helpers/polygon_test_cases.hpp" //To load testing polygons to compute the area of.
+#include "apex/detail/scheduler.hpp" //To split the polygons over many small tasks.
+#include "apex/fixed_polygon.hpp" //To test the area of polygons with a fixed number of vertices.
 #include "apex/operations/area.hpp" //The unit we're testing here.
+#include "apex/soa_polygon.hpp" //To test the area of polygons stored as structures of arrays.
 
 #define PI 3.14159265358979 //To calculate the area of a regular N-gon.
 
@@ -25,6 +28,7 @@ TEST(PolygonArea, InitialAreaIsZero) {
 	EXPECT_EQ(area(PolygonTestCases::empty()), true_area) << "The polygon is empty, so it has no surface area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::empty()), true_area) << "The polygon is empty, so it has no surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::empty()), true_area) << "The polygon is empty, so it has no surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::empty()), true_area) << "The polygon is empty, so it has no surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::empty()), true_area) << "The polygon is empty, so it has no surface area.";
 #endif
@@ -38,6 +42,7 @@ TEST(PolygonArea, Square1000) {
 	EXPECT_EQ(area(PolygonTestCases::square_1000()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::square_1000()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::square_1000()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::square_1000()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::square_1000()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied.";
 #endif
@@ -51,6 +56,7 @@ TEST(PolygonArea, Square1000NegativeX) {
 	EXPECT_EQ(area(PolygonTestCases::square_1000_negative_x()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::square_1000_negative_x()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::square_1000_negative_x()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::square_1000_negative_x()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::square_1000_negative_x()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #endif
@@ -64,6 +70,7 @@ TEST(PolygonArea, Square1000NegativeY) {
 	EXPECT_EQ(area(PolygonTestCases::square_1000_negative_y()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::square_1000_negative_y()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::square_1000_negative_y()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::square_1000_negative_y()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::square_1000_negative_y()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #endif
@@ -78,6 +85,7 @@ TEST(PolygonArea, Square1000NegativeXY) {
 	EXPECT_EQ(area(PolygonTestCases::square_1000_negative_xy()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::square_1000_negative_xy()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::square_1000_negative_xy()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::square_1000_negative_xy()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::square_1000_negative_xy()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #endif
@@ -91,6 +99,7 @@ TEST(PolygonArea, Square1000Centred) {
 	EXPECT_EQ(area(PolygonTestCases::square_1000_centred()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::square_1000_centred()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::square_1000_centred()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::square_1000_centred()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::square_1000_centred()), true_area) << "It's a 1000 by 1000 square, so the area should be those multiplied, regardless of its position around the origin.";
 #endif
@@ -104,6 +113,7 @@ TEST(PolygonArea, Triangle1000) {
 	EXPECT_EQ(area(PolygonTestCases::triangle_1000()), true_area) << "This triangle has base 1000 and height 1000, so it should have half the surface area of those multiplied.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::triangle_1000()), true_area) << "This triangle has base 1000 and height 1000, so it should have half the surface area of those multiplied.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::triangle_1000()), true_area) << "This triangle has base 1000 and height 1000, so it should have half the surface area of those multiplied.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::triangle_1000()), true_area) << "This triangle has base 1000 and height 1000, so it should have half the surface area of those multiplied.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::triangle_1000()), true_area) << "This triangle has base 1000 and height 1000, so it should have half the surface area of those multiplied.";
 #endif
@@ -119,6 +129,7 @@ TEST(PolygonArea, ThinRectangle) {
 	EXPECT_EQ(area(PolygonTestCases::thin_rectangle()), true_area) << "This is a 1000-long and 1-wide polygon.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::thin_rectangle()), true_area) << "This is a 1000-long and 1-wide polygon.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::thin_rectangle()), true_area) << "This is a 1000-long and 1-wide polygon.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::thin_rectangle()), true_area) << "This is a 1000-long and 1-wide polygon.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::thin_rectangle()), true_area) << "This is a 1000-long and 1-wide polygon.";
 #endif
@@ -132,6 +143,7 @@ TEST(PolygonArea, Concave) {
 	EXPECT_EQ(area(PolygonTestCases::arrowhead()), true_area) << "The arrowhead has a 1000-wide base and 1000 height, subtracting 1000-wide base with 500 height from the shape.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::arrowhead()), true_area) << "The arrowhead has a 1000-wide base and 1000 height, subtracting 1000-wide base with 500 height from the shape.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::arrowhead()), true_area) << "The arrowhead has a 1000-wide base and 1000 height, subtracting 1000-wide base with 500 height from the shape.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::arrowhead()), true_area) << "The arrowhead has a 1000-wide base and 1000 height, subtracting 1000-wide base with 500 height from the shape.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::arrowhead()), true_area) << "The arrowhead has a 1000-wide base and 1000 height, subtracting 1000-wide base with 500 height from the shape.";
 #endif
@@ -146,6 +158,7 @@ TEST(PolygonArea, Negative) {
 	EXPECT_EQ(area(PolygonTestCases::negative_square()), true_area) << "Since the winding order is the other way around, this shape is negative and should have a negative area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::negative_square()), true_area) << "Since the winding order is the other way around, this shape is negative and should have a negative area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::negative_square()), true_area) << "Since the winding order is the other way around, this shape is negative and should have a negative area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::negative_square()), true_area) << "Since the winding order is the other way around, this shape is negative and should have a negative area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::negative_square()), true_area) << "Since the winding order is the other way around, this shape is negative and should have a negative area.";
 #endif
@@ -159,6 +172,7 @@ TEST(PolygonArea, SelfIntersecting) {
 	EXPECT_EQ(area(PolygonTestCases::hourglass()), true_area) << "The negative area of this polygon exactly cancels out the positive area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::hourglass()), true_area) << "The negative area of this polygon exactly cancels out the positive area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::hourglass()), true_area) << "The negative area of this polygon exactly cancels out the positive area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::hourglass()), true_area) << "The negative area of this polygon exactly cancels out the positive area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::hourglass()), true_area) << "The negative area of this polygon exactly cancels out the positive area.";
 #endif
@@ -171,6 +185,7 @@ TEST(PolygonArea, Point) {
 	EXPECT_EQ(area(PolygonTestCases::point()), 0) << "Points don't have any surface area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::point()), 0) << "Points don't have any surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::point()), 0) << "Points don't have any surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::point()), 0) << "Points don't have any surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::point()), 0) << "Points don't have any surface area.";
 #endif
@@ -183,6 +198,7 @@ TEST(PolygonArea, Line) {
 	EXPECT_EQ(area(PolygonTestCases::line()), 0) << "Lines don't have any surface area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::line()), 0) << "Lines don't have any surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::line()), 0) << "Lines don't have any surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::line()), 0) << "Lines don't have any surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::line()), 0) << "Lines don't have any surface area.";
 #endif
@@ -195,11 +211,37 @@ TEST(PolygonArea, ZeroWidth) {
 	EXPECT_EQ(area(PolygonTestCases::zero_width()), 0) << "The shape has no width, so no surface area.";
 	EXPECT_EQ(detail::area_st(PolygonTestCases::zero_width()), 0) << "The shape has no width, so no surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonTestCases::zero_width()), 0) << "The shape has no width, so no surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonTestCases::zero_width()), 0) << "The shape has no width, so no surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonTestCases::zero_width()), 0) << "The shape has no width, so no surface area.";
 #endif
 }
 
+/*!
+ * Tests the area of a polygon with coordinates close to the limits of the
+ * coordinate range.
+ *
+ * The products of these coordinates don't fit in the coordinate type. This
+ * tests that the coordinates are widened before multiplying them, even in the
+ * vectorised implementations.
+ */
+TEST(PolygonArea, LargeCoordinates) {
+	const coord_t limit = 1 << 29; //Twice the area must still fit in area_t.
+	Polygon square = {Point2(-limit, -limit), Point2(limit, -limit)};
+	for(coord_t x = limit; x > -limit; x -= limit / 8) { //Add some vertices to the top edge, so that the vectorised loop has more than one iteration.
+		square.emplace_back(x, limit);
+	}
+	square.emplace_back(-limit, limit);
+	const area_t true_area = area_t(limit) * limit * 4;
+	EXPECT_EQ(area(square), true_area) << "The square is 2^30 wide and 2^30 high.";
+	EXPECT_EQ(detail::area_st(square), true_area) << "The square is 2^30 wide and 2^30 high.";
+	EXPECT_EQ(detail::area_mt(square), true_area) << "The square is 2^30 wide and 2^30 high.";
+	EXPECT_EQ(detail::area_simd(square), true_area) << "The square is 2^30 wide and 2^30 high.";
+#ifdef GPU
+	EXPECT_EQ(detail::area_gpu(square), true_area) << "The square is 2^30 wide and 2^30 high.";
+#endif
+}
+
 /*!
  * Tests computing the area of a regular polygon that consists of many vertices.
  *
@@ -218,6 +260,7 @@ TEST(PolygonArea, Circle) {
 	EXPECT_NEAR(area(circle), ground_truth, error_margin) << "The area of the polygon must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
 	EXPECT_NEAR(detail::area_st(circle), ground_truth, error_margin) << "The area of the polygon must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
 	EXPECT_NEAR(detail::area_mt(circle), ground_truth, error_margin) << "The area of the polygon must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
+	EXPECT_NEAR(detail::area_simd(circle), ground_truth, error_margin) << "The area of the polygon must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
 #ifdef GPU
 	EXPECT_NEAR(detail::area_gpu(circle), ground_truth, error_margin) << "The area of the polygon must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
 #endif
@@ -231,6 +274,7 @@ TEST(PolygonBatchArea, EmptyBatch) {
 	EXPECT_EQ(area(PolygonBatchTestCases::empty()), ground_truth) << "The area of an empty batch is an empty list.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::empty()), ground_truth) << "The area of an empty batch is an empty list.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::empty()), ground_truth) << "The area of an empty batch is an empty list.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::empty()), ground_truth) << "The area of an empty batch is an empty list.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::empty()), ground_truth) << "The area of an empty batch is an empty list.";
 #endif
@@ -247,6 +291,7 @@ TEST(PolygonBatchArea, SingleEmpty) {
 	EXPECT_EQ(area(PolygonBatchTestCases::single_empty()), ground_truth) << "There is a single polygon in this batch, and it is empty.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::single_empty()), ground_truth) << "There is a single polygon in this batch, and it is empty.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::single_empty()), ground_truth) << "There is a single polygon in this batch, and it is empty.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::single_empty()), ground_truth) << "There is a single polygon in this batch, and it is empty.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::single_empty()), ground_truth) << "There is a single polygon in this batch, and it is empty.";
 #endif
@@ -261,6 +306,7 @@ TEST(PolygonBatchArea, SinglePoint) {
 	EXPECT_EQ(area(PolygonBatchTestCases::single_point()), ground_truth) << "There is a single polygon in this batch, but it's just a point with no surface area.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::single_point()), ground_truth) << "There is a single polygon in this batch, but it's just a point with no surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::single_point()), ground_truth) << "There is a single polygon in this batch, but it's just a point with no surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::single_point()), ground_truth) << "There is a single polygon in this batch, but it's just a point with no surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::single_point()), ground_truth) << "There is a single polygon in this batch, but it's just a point with no surface area.";
 #endif
@@ -275,6 +321,7 @@ TEST(PolygonBatchArea, SingleLine) {
 	EXPECT_EQ(area(PolygonBatchTestCases::single_line()), ground_truth) << "There is a single polygon in this batch, but it's just a line with no surface area.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::single_line()), ground_truth) << "There is a single polygon in this batch, but it's just a line with no surface area.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::single_line()), ground_truth) << "There is a single polygon in this batch, but it's just a line with no surface area.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::single_line()), ground_truth) << "There is a single polygon in this batch, but it's just a line with no surface area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::single_line()), ground_truth) << "There is a single polygon in this batch, but it's just a line with no surface area.";
 #endif
@@ -288,6 +335,7 @@ TEST(PolygonBatchArea, SingleSquare) {
 	EXPECT_EQ(area(PolygonBatchTestCases::single_square()), ground_truth) << "There is a single polygon in this batch, and it's a 1000x1000 square.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::single_square()), ground_truth) << "There is a single polygon in this batch, and it's a 1000x1000 square.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::single_square()), ground_truth) << "There is a single polygon in this batch, and it's a 1000x1000 square.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::single_square()), ground_truth) << "There is a single polygon in this batch, and it's a 1000x1000 square.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::single_square()), ground_truth) << "There is a single polygon in this batch, and it's a 1000x1000 square.";
 #endif
@@ -305,6 +353,7 @@ TEST(PolygonBatchArea, SquareTriangle) {
 	EXPECT_EQ(area(PolygonBatchTestCases::square_triangle()), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::square_triangle()), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::square_triangle()), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::square_triangle()), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::square_triangle()), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
 #endif
@@ -321,6 +370,7 @@ TEST(PolygonBatchArea, SquareTriangleSquare) {
 	EXPECT_EQ(area(PolygonBatchTestCases::square_triangle_square()), ground_truth) << "The first and third polygons are squares of 1000x1000. The middle one is a triangle, with half of that area.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::square_triangle_square()), ground_truth) << "The first and third polygons are squares of 1000x1000. The middle one is a triangle, with half of that area.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::square_triangle_square()), ground_truth) << "The first and third polygons are squares of 1000x1000. The middle one is a triangle, with half of that area.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::square_triangle_square()), ground_truth) << "The first and third polygons are squares of 1000x1000. The middle one is a triangle, with half of that area.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::square_triangle_square()), ground_truth) << "The first and third polygons are squares of 1000x1000. The middle one is a triangle, with half of that area.";
 #endif
@@ -337,11 +387,55 @@ TEST(PolygonBatchArea, TwoSquares) {
 	EXPECT_EQ(area(PolygonBatchTestCases::two_squares()), ground_truth) << "The batch has two 1000x1000 squares.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::two_squares()), ground_truth) << "The batch has two 1000x1000 squares.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::two_squares()), ground_truth) << "The batch has two 1000x1000 squares.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::two_squares()), ground_truth) << "The batch has two 1000x1000 squares.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::two_squares()), ground_truth) << "The batch has two 1000x1000 squares.";
 #endif
 }
 
+/*!
+ * Tests that the areas of a batch are stored in the properties of its
+ * polygons, and forgotten again once the batch is modified.
+ */
+TEST(PolygonBatchArea, Cached) {
+	Batch<Polygon> batch = PolygonBatchTestCases::square_triangle();
+	const Batch<area_t> ground_truth = {1000 * 1000, 1000 * 1000 / 2};
+	EXPECT_EQ(area(batch), ground_truth) << "The square is 1000x1000. The triangle has a base and height of 1000, so an area of half of that.";
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		ASSERT_TRUE(batch.get_properties(polygon).has_area()) << "The area has been computed, so it must be cached.";
+		EXPECT_EQ(batch.get_properties(polygon).area(), ground_truth[polygon]) << "The cached area must be the computed area.";
+	}
+	EXPECT_EQ(area(batch), ground_truth) << "Getting the areas from the cache must give the same result.";
+
+	batch.push_back(PolygonTestCases::square_1000());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		EXPECT_FALSE(batch.get_properties(polygon).has_area()) << "The batch was modified, so the areas are no longer known.";
+	}
+	const Batch<area_t> modified_ground_truth = {1000 * 1000, 1000 * 1000 / 2, 1000 * 1000};
+	EXPECT_EQ(area(batch), modified_ground_truth) << "The areas must be computed again, including that of the new square.";
+}
+
+/*!
+ * Tests computing and caching the areas of a constant batch from multiple
+ * threads at the same time.
+ *
+ * The first thread to cache an area allocates the cache of the whole batch,
+ * which must not disturb the threads reading it.
+ */
+TEST(PolygonBatchArea, CachedFromMultipleThreads) {
+	const Batch<area_t> ground_truth = {1000 * 1000, 1000 * 1000 / 2};
+	for(size_t repeat = 0; repeat < 100; ++repeat) {
+		const Batch<Polygon> batch = PolygonBatchTestCases::square_triangle();
+		size_t wrong = 0;
+		#pragma omp parallel num_threads(4) reduction(+:wrong)
+		{
+			wrong += area(batch) != ground_truth;
+			wrong += !batch.get_properties(1).has_area() || batch.get_properties(1).area() != ground_truth[1];
+		}
+		EXPECT_EQ(wrong, 0) << "Each thread must find the correct areas, computed or cached.";
+	}
+}
+
 /*!
  * Tests all sorts of edge cases, to see if the batch version handles those the
  * same way as the normal algorithms.
@@ -351,6 +445,7 @@ TEST(PolygonBatchArea, EdgeCases) {
 	EXPECT_EQ(area(PolygonBatchTestCases::edge_cases()), ground_truth) << "The first element is a negative square. The second is self-intersecting which causes the negative area to compensate for the positive. The rest all has no surface.";
 	EXPECT_EQ(detail::area_st(PolygonBatchTestCases::edge_cases()), ground_truth) << "The first element is a negative square. The second is self-intersecting which causes the negative area to compensate for the positive. The rest all has no surface.";
 	EXPECT_EQ(detail::area_mt(PolygonBatchTestCases::edge_cases()), ground_truth) << "The first element is a negative square. The second is self-intersecting which causes the negative area to compensate for the positive. The rest all has no surface.";
+	EXPECT_EQ(detail::area_simd(PolygonBatchTestCases::edge_cases()), ground_truth) << "The first element is a negative square. The second is self-intersecting which causes the negative area to compensate for the positive. The rest all has no surface.";
 #ifdef GPU
 	EXPECT_EQ(detail::area_gpu(PolygonBatchTestCases::edge_cases()), ground_truth) << "The first element is a negative square. The second is self-intersecting which causes the negative area to compensate for the positive. The rest all has no surface.";
 #endif
@@ -379,6 +474,10 @@ TEST(PolygonBatchArea, TwoCircles) {
 	for(area_t calculated_area : calculated_areas) {
 		EXPECT_NEAR(calculated_area, true_area, error_margin) << "The area of the polygons must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
 	}
+	calculated_areas = detail::area_simd(two_circles);
+	for(area_t calculated_area : calculated_areas) {
+		EXPECT_NEAR(calculated_area, true_area, error_margin) << "The area of the polygons must be close to the ideal area of the regular polygon, but can be different due to integer rounding of its vertices.";
+	}
 #ifdef GPU
 	calculated_areas = detail::area_gpu(two_circles);
 	for(area_t calculated_area : calculated_areas) {
@@ -387,4 +486,188 @@ TEST(PolygonBatchArea, TwoCircles) {
 #endif
 }
 
+/*!
+ * Tests computing the areas of a batch with polygons of very different sizes.
+ *
+ * Some implementations divide the vertices of all polygons into chunks, so
+ * large polygons get split over multiple chunks, and chunks contain multiple
+ * small polygons. The batch also contains gaps in its vertex buffer, left over
+ * from growing one of the polygons. The areas must be the same as computing
+ * them one by one.
+ */
+TEST(PolygonBatchArea, MixedSizes) {
+	Batch<Polygon> batch;
+	for(size_t repeat = 0; repeat < 3; ++repeat) {
+		batch.push_back(PolygonTestCases::circle());
+		batch.push_back(PolygonTestCases::empty());
+		for(size_t small = 0; small < 500; ++small) {
+			batch.push_back(PolygonTestCases::square_1000());
+			batch.push_back(PolygonTestCases::triangle_1000());
+		}
+		batch.push_back(PolygonTestCases::arrowhead());
+	}
+	for(size_t vertex = 0; vertex < 100; ++vertex) { //Grow one of the polygons, so that it has to move and leaves a gap in the vertex buffer.
+		batch[3].emplace_back(0, 1000 - vertex);
+	}
+
+	Batch<area_t> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::area_st(polygon));
+	}
+	EXPECT_EQ(area(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+	EXPECT_EQ(detail::area_st(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+	EXPECT_EQ(detail::area_mt(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+	EXPECT_EQ(detail::area_simd(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+#ifdef GPU
+	EXPECT_EQ(detail::area_gpu(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+#endif
+}
+
+/*!
+ * Tests computing the areas of a batch with tasks that are much smaller than
+ * the polygons.
+ *
+ * The big polygons are then split over many tasks, which may run on different
+ * threads. The areas of the parts must be added up to the same areas as
+ * computing them one by one.
+ */
+TEST(PolygonBatchArea, SmallTasks) {
+	Batch<Polygon> batch;
+	for(size_t repeat = 0; repeat < 3; ++repeat) {
+		batch.push_back(PolygonTestCases::circle());
+		batch.push_back(PolygonTestCases::empty());
+		for(size_t small = 0; small < 20; ++small) {
+			batch.push_back(PolygonTestCases::square_1000());
+			batch.push_back(PolygonTestCases::triangle_1000());
+		}
+		batch.push_back(PolygonTestCases::arrowhead());
+	}
+	Batch<area_t> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::area_st(polygon));
+	}
+	detail::Scheduler::set_grain_size(7);
+	for(const size_t threads : {1, 2, 4}) {
+		detail::Scheduler::set_num_threads(threads);
+		EXPECT_EQ(detail::area_mt(batch), ground_truth) << "The areas must be the same as computing them for each polygon separately.";
+	}
+	detail::Scheduler::reset();
+}
+
+/*!
+ * Tests computing the area of polygons with a fixed number of vertices.
+ *
+ * The polygons are truncated or padded to 4 vertices. Their areas must be
+ * exactly the same as for normal polygons with the same vertices.
+ */
+TEST(FixedPolygonArea, SameAsPolygon) {
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::line(), PolygonTestCases::square_1000(), PolygonTestCases::triangle_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass(), PolygonTestCases::zero_width(), PolygonTestCases::circle()}) {
+		const FixedPolygon<4> polygon(original);
+		const area_t ground_truth = detail::area_st(polygon.to_polygon());
+		EXPECT_EQ(area(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_st(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(polygon.area(), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the areas of batches of polygons with a fixed number of
+ * vertices.
+ *
+ * The polygons are truncated or padded to 4 vertices. Their areas must be
+ * exactly the same as for normal batches with the same vertices.
+ */
+TEST(FixedPolygonBatchArea, SameAsPolygonBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::single_line(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const Batch<FixedPolygon<4>> batch(original);
+		const Batch<area_t> ground_truth = detail::area_st(batch.to_polygons());
+		EXPECT_EQ(area(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_st(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_mt(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::area_gpu(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(batch.area(), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the area of polygons that store their vertices as a
+ * structure of arrays.
+ *
+ * The areas must be exactly the same as for the same polygons stored as arrays
+ * of points.
+ */
+TEST(SoAPolygonArea, SameAsPolygon) {
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::line(), PolygonTestCases::square_1000(), PolygonTestCases::square_1000_centred(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass(), PolygonTestCases::zero_width(), PolygonTestCases::circle()}) {
+		const area_t ground_truth = detail::area_st(original);
+		const SoAPolygon polygon(original);
+		EXPECT_EQ(area(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_st(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_mt(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_simd(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::area_gpu(polygon), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(polygon.area(), ground_truth) << "The area must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the areas of batches of polygons that store their vertices as
+ * a structure of arrays.
+ *
+ * The areas must be exactly the same as for the same batches stored as arrays
+ * of points.
+ */
+TEST(SoAPolygonBatchArea, SameAsPolygonBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::single_line(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const Batch<area_t> ground_truth = detail::area_st(original);
+		const Batch<SoAPolygon> batch(original);
+		EXPECT_EQ(area(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_st(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_mt(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::area_simd(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::area_gpu(batch), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(batch.area(), ground_truth) << "The areas must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+
+#ifdef GPU
+/*!
+ * Tests computing the areas of several polygons asynchronously, queueing all of
+ * them before retrieving any of the results.
+ */
+TEST(PolygonArea, Async) {
+	const std::vector<Polygon> polygons = {PolygonTestCases::empty(), PolygonTestCases::square_1000(), PolygonTestCases::triangle_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::circle()};
+	std::vector<GPUFuture<area_t>> futures;
+	for(const Polygon& polygon : polygons) {
+		futures.push_back(area_async(polygon));
+	}
+	for(size_t i = 0; i < polygons.size(); ++i) {
+		ASSERT_TRUE(futures[i].valid()) << "The result hasn't been retrieved yet.";
+		EXPECT_EQ(futures[i].get(), detail::area_st(polygons[i])) << "The area must be the same as when computed synchronously.";
+		EXPECT_FALSE(futures[i].valid()) << "The result can only be retrieved once.";
+	}
+}
+
+/*!
+ * Tests computing the areas of several batches asynchronously, queueing all of
+ * them before retrieving any of the results.
+ */
+TEST(PolygonBatchArea, Async) {
+	const std::vector<Batch<Polygon>> batches = {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()};
+	std::vector<GPUFuture<Batch<area_t>>> futures;
+	for(const Batch<Polygon>& batch : batches) {
+		futures.push_back(area_async(batch));
+	}
+	for(size_t i = 0; i < batches.size(); ++i) {
+		EXPECT_EQ(futures[i].get(), detail::area_st(batches[i])) << "The areas must be the same as when computed synchronously.";
+	}
+}
+#endif
+
 }
\ No newline at end of file
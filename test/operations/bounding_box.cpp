@@ -0,0 +1,335 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <algorithm> //To compute the ground truth of bounding boxes.
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <utility> //To construct bounding boxes.
+
+#include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches of polygons to compute the bounding boxes of.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to compute the bounding boxes of.
+#include "apex/detail/scheduler.hpp" //To split the polygons over many small tasks.
+#include "apex/fixed_polygon.hpp" //To test the bounding boxes of polygons with a fixed number of vertices.
+#include "apex/operations/bounding_box.hpp" //The unit we're testing here.
+#include "apex/soa_polygon.hpp" //To test the bounding boxes of polygons stored as structures of arrays.
+
+namespace apex {
+
+/*!
+ * All implementations of the bounding box of a single polygon, to test all of
+ * them in the same way.
+ */
+const std::vector<std::function<std::pair<Point2, Point2>(const Polygon&)>> polygon_implementations = {
+	[](const Polygon& polygon) { return bounding_box(polygon); },
+	[](const Polygon& polygon) { return detail::bounding_box_st(polygon); },
+	[](const Polygon& polygon) { return detail::bounding_box_mt(polygon); },
+#ifdef GPU
+	[](const Polygon& polygon) { return detail::bounding_box_gpu(polygon); },
+#endif
+	[](const Polygon& polygon) { return polygon.bounding_box(); }
+};
+
+/*!
+ * All implementations of the bounding boxes of a batch of polygons, to test all
+ * of them in the same way.
+ */
+const std::vector<std::function<Batch<std::pair<Point2, Point2>>(const Batch<Polygon>&)>> batch_implementations = {
+	[](const Batch<Polygon>& batch) { return bounding_box(batch); },
+	[](const Batch<Polygon>& batch) { return detail::bounding_box_st(batch); },
+	[](const Batch<Polygon>& batch) { return detail::bounding_box_mt(batch); },
+#ifdef GPU
+	[](const Batch<Polygon>& batch) { return detail::bounding_box_gpu(batch); },
+#endif
+	[](const Batch<Polygon>& batch) { return batch.bounding_box(); }
+};
+
+/*!
+ * Tests the bounding box of an empty polygon.
+ */
+TEST(PolygonBoundingBox, Empty) {
+	const std::pair<Point2, Point2> ground_truth(Point2(0, 0), Point2(0, 0));
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(PolygonTestCases::empty()), ground_truth) << "An empty polygon has an empty bounding box at the origin.";
+	}
+}
+
+/*!
+ * Tests the bounding box of a polygon with a single vertex.
+ */
+TEST(PolygonBoundingBox, Point) {
+	const Polygon point = PolygonTestCases::point();
+	const std::pair<Point2, Point2> ground_truth(point[0], point[0]);
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(point), ground_truth) << "The bounding box of a single vertex is that vertex.";
+	}
+}
+
+/*!
+ * Tests the bounding box of a basic 1000 by 1000 square.
+ */
+TEST(PolygonBoundingBox, Square1000) {
+	const std::pair<Point2, Point2> ground_truth(Point2(0, 0), Point2(1000, 1000));
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(PolygonTestCases::square_1000()), ground_truth) << "The square spans from 0 to 1000 in both dimensions.";
+	}
+}
+
+/*!
+ * Tests the bounding box of a 1000 by 1000 square around the origin, to test
+ * negative coordinates.
+ */
+TEST(PolygonBoundingBox, Square1000Centred) {
+	const std::pair<Point2, Point2> ground_truth(Point2(-500, -500), Point2(500, 500));
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(PolygonTestCases::square_1000_centred()), ground_truth) << "The square spans from -500 to 500 in both dimensions.";
+	}
+}
+
+/*!
+ * Tests the bounding box of a concave polygon, where the extremes are not all
+ * at the same vertices.
+ */
+TEST(PolygonBoundingBox, Arrowhead) {
+	const Polygon arrowhead = PolygonTestCases::arrowhead();
+	Point2 minimum = arrowhead[0];
+	Point2 maximum = arrowhead[0];
+	for(const Point2& vertex : arrowhead) {
+		minimum = Point2(std::min(minimum.x, vertex.x), std::min(minimum.y, vertex.y));
+		maximum = Point2(std::max(maximum.x, vertex.x), std::max(maximum.y, vertex.y));
+	}
+	const std::pair<Point2, Point2> ground_truth(minimum, maximum);
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(arrowhead), ground_truth) << "The bounding box must contain exactly the extremes of the vertices.";
+	}
+}
+
+/*!
+ * Tests the bounding box of a polygon with many vertices, which gets divided
+ * over many threads in the multi-threaded versions.
+ */
+TEST(PolygonBoundingBox, Circle) {
+	const Polygon circle = PolygonTestCases::circle();
+	const std::pair<Point2, Point2> ground_truth(Point2(-1000000, -1000000), Point2(1000000, 1000000));
+	for(const auto& implementation : polygon_implementations) {
+		EXPECT_EQ(implementation(circle), ground_truth) << "The circle has a radius of 1 million around the origin.";
+	}
+}
+
+/*!
+ * Tests that the bounding box of a polygon is stored in its cached properties.
+ */
+TEST(PolygonBoundingBox, Cached) {
+	Polygon polygon = PolygonTestCases::square_1000();
+	const std::pair<Point2, Point2> ground_truth(Point2(0, 0), Point2(1000, 1000));
+	EXPECT_EQ(bounding_box(polygon), ground_truth) << "The square spans from 0 to 1000 in both dimensions.";
+	ASSERT_TRUE(polygon.get_properties().has_bounding_box()) << "The bounding box has been computed, so it must be cached.";
+	EXPECT_EQ(polygon.get_properties().bounding_box(), ground_truth) << "The cached bounding box must be the computed bounding box.";
+
+	polygon.emplace_back(2000, 500);
+	EXPECT_FALSE(polygon.get_properties().has_bounding_box()) << "The polygon was modified, so the bounding box is no longer known.";
+	EXPECT_EQ(bounding_box(polygon), std::make_pair(Point2(0, 0), Point2(2000, 1000))) << "The bounding box must be computed again, including the new vertex.";
+}
+
+/*!
+ * Tests the bounding boxes of an empty batch.
+ */
+TEST(PolygonBatchBoundingBox, EmptyBatch) {
+	for(const auto& implementation : batch_implementations) {
+		EXPECT_EQ(implementation(PolygonBatchTestCases::empty()).size(), 0) << "There are no polygons, so there are no bounding boxes either.";
+	}
+}
+
+/*!
+ * Tests the bounding boxes of a batch with several simple polygons.
+ */
+TEST(PolygonBatchBoundingBox, SquareTriangleSquare) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::square_triangle_square();
+	Batch<std::pair<Point2, Point2>> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::bounding_box_st(polygon));
+	}
+	for(const auto& implementation : batch_implementations) {
+		EXPECT_EQ(implementation(batch), ground_truth) << "The bounding boxes must be the same as computing them for each polygon separately.";
+	}
+}
+
+/*!
+ * Tests all sorts of edge cases, to see if the batch versions handle those the
+ * same way as the versions for single polygons.
+ */
+TEST(PolygonBatchBoundingBox, EdgeCases) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::edge_cases();
+	Batch<std::pair<Point2, Point2>> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::bounding_box_st(polygon));
+	}
+	for(const auto& implementation : batch_implementations) {
+		EXPECT_EQ(implementation(batch), ground_truth) << "The bounding boxes must be the same as computing them for each polygon separately.";
+	}
+}
+
+/*!
+ * Tests computing the bounding boxes of a batch with polygons of very
+ * different sizes, with a gap in its vertex buffer.
+ */
+TEST(PolygonBatchBoundingBox, MixedSizes) {
+	Batch<Polygon> batch;
+	for(size_t repeat = 0; repeat < 3; ++repeat) {
+		batch.push_back(PolygonTestCases::circle());
+		batch.push_back(PolygonTestCases::empty());
+		for(size_t small = 0; small < 100; ++small) {
+			batch.push_back(PolygonTestCases::square_1000());
+			batch.push_back(PolygonTestCases::triangle_1000());
+		}
+		batch.push_back(PolygonTestCases::arrowhead());
+	}
+	for(size_t vertex = 0; vertex < 100; ++vertex) { //Grow one of the polygons, so that it has to move and leaves a gap in the vertex buffer.
+		batch[3].emplace_back(-static_cast<coord_t>(vertex), 1000 + vertex);
+	}
+
+	Batch<std::pair<Point2, Point2>> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::bounding_box_st(polygon));
+	}
+	for(const auto& implementation : batch_implementations) {
+		EXPECT_EQ(implementation(batch), ground_truth) << "The bounding boxes must be the same as computing them for each polygon separately.";
+	}
+}
+
+/*!
+ * Tests computing the bounding boxes of a batch with tasks that are much
+ * smaller than the polygons.
+ *
+ * The big polygons are then split over many tasks, which may run on different
+ * threads. The bounding boxes of the parts must be merged into the same
+ * bounding boxes as computing them one by one.
+ */
+TEST(PolygonBatchBoundingBox, SmallTasks) {
+	Batch<Polygon> batch;
+	for(size_t repeat = 0; repeat < 3; ++repeat) {
+		batch.push_back(PolygonTestCases::circle());
+		batch.push_back(PolygonTestCases::empty());
+		for(size_t small = 0; small < 20; ++small) {
+			batch.push_back(PolygonTestCases::square_1000());
+			batch.push_back(PolygonTestCases::triangle_1000());
+		}
+		batch.push_back(PolygonTestCases::arrowhead());
+	}
+	Batch<std::pair<Point2, Point2>> ground_truth;
+	for(const Subbatch<Point2>& polygon : batch) {
+		ground_truth.push_back(detail::bounding_box_st(polygon));
+	}
+	detail::Scheduler::set_grain_size(7);
+	for(const size_t threads : {1, 2, 4}) {
+		detail::Scheduler::set_num_threads(threads);
+		EXPECT_EQ(detail::bounding_box_mt(batch), ground_truth) << "The bounding boxes must be the same as computing them for each polygon separately.";
+	}
+	detail::Scheduler::reset();
+}
+
+/*!
+ * Tests that the bounding boxes of a batch are stored in the properties of its
+ * polygons, and forgotten again once the batch is modified.
+ */
+TEST(PolygonBatchBoundingBox, Cached) {
+	Batch<Polygon> batch = PolygonBatchTestCases::square_triangle();
+	const Batch<std::pair<Point2, Point2>> ground_truth = detail::bounding_box_st(batch);
+	EXPECT_EQ(bounding_box(batch), ground_truth) << "The bounding boxes must be the same as computing them without the cache.";
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		ASSERT_TRUE(batch.get_properties(polygon).has_bounding_box()) << "The bounding box has been computed, so it must be cached.";
+		EXPECT_EQ(batch.get_properties(polygon).bounding_box(), ground_truth[polygon]) << "The cached bounding box must be the computed bounding box.";
+	}
+	EXPECT_EQ(bounding_box(batch), ground_truth) << "Getting the bounding boxes from the cache must give the same result.";
+
+	batch.push_back(PolygonTestCases::square_1000_centred());
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		EXPECT_FALSE(batch.get_properties(polygon).has_bounding_box()) << "The batch was modified, so the bounding boxes are no longer known.";
+	}
+	EXPECT_EQ(bounding_box(batch).back(), std::make_pair(Point2(-500, -500), Point2(500, 500))) << "The bounding boxes must be computed again, including that of the new square.";
+}
+
+/*!
+ * Tests computing the bounding box of polygons with a fixed number of vertices.
+ *
+ * The polygons are truncated or padded to 4 vertices. Their bounding boxes must
+ * be exactly the same as for normal polygons with the same vertices.
+ */
+TEST(FixedPolygonBoundingBox, SameAsPolygon) {
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::line(), PolygonTestCases::square_1000(), PolygonTestCases::triangle_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass(), PolygonTestCases::zero_width(), PolygonTestCases::circle()}) {
+		const FixedPolygon<4> polygon(original);
+		const std::pair<Point2, Point2> ground_truth = detail::bounding_box_st(polygon.to_polygon());
+		EXPECT_EQ(bounding_box(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_st(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(polygon.bounding_box(), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the bounding boxes of batches of polygons with a fixed
+ * number of vertices.
+ *
+ * The polygons are truncated or padded to 4 vertices. Their bounding boxes must
+ * be exactly the same as for normal batches with the same vertices.
+ */
+TEST(FixedPolygonBatchBoundingBox, SameAsPolygonBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::single_line(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const Batch<FixedPolygon<4>> batch(original);
+		const Batch<std::pair<Point2, Point2>> ground_truth = detail::bounding_box_st(batch.to_polygons());
+		EXPECT_EQ(bounding_box(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_st(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_mt(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::bounding_box_gpu(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(batch.bounding_box(), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the bounding box of polygons that store their vertices as a
+ * structure of arrays.
+ *
+ * The bounding boxes must be exactly the same as for the same polygons stored
+ * as arrays of points.
+ */
+TEST(SoAPolygonBoundingBox, SameAsPolygon) {
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::line(), PolygonTestCases::square_1000(), PolygonTestCases::square_1000_centred(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass(), PolygonTestCases::zero_width(), PolygonTestCases::circle()}) {
+		const std::pair<Point2, Point2> ground_truth = detail::bounding_box_st(original);
+		const SoAPolygon polygon(original);
+		EXPECT_EQ(bounding_box(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_st(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_mt(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::bounding_box_gpu(polygon), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(polygon.bounding_box(), ground_truth) << "The bounding box must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+/*!
+ * Tests computing the bounding boxes of batches of polygons that store their
+ * vertices as a structure of arrays.
+ *
+ * The bounding boxes must be exactly the same as for the same batches stored as
+ * arrays of points.
+ */
+TEST(SoAPolygonBatchBoundingBox, SameAsPolygonBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::single_line(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases(), PolygonBatchTestCases::two_circles()}) {
+		const Batch<std::pair<Point2, Point2>> ground_truth = detail::bounding_box_st(original);
+		const Batch<SoAPolygon> batch(original);
+		EXPECT_EQ(bounding_box(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_st(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::bounding_box_mt(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::bounding_box_gpu(batch), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(batch.bounding_box(), ground_truth) << "The bounding boxes must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+}
\ No newline at end of file
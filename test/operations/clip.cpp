@@ -0,0 +1,240 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <cmath> //To generate regular polygons.
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <numbers> //To generate regular polygons.
+#include <random> //To generate lots of polygons to clip.
+
+#include "apex/operations/clip.hpp" //The unit we're testing here.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to clip.
+
+namespace apex {
+
+/*!
+ * All implementations of the boolean operation engine, to test all of them in
+ * the same way.
+ */
+const std::vector<std::function<Batch<Polygon>(const Batch<Polygon>&, const Batch<Polygon>&, const BooleanOperation, const FillRule)>> clip_implementations = {
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b, const BooleanOperation operation, const FillRule fill_rule) { return clip(a, b, operation, fill_rule); },
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b, const BooleanOperation operation, const FillRule fill_rule) {
+		std::vector<detail::ClipEdge> edges;
+		detail::clip_add_edges(a, 0, edges);
+		detail::clip_add_edges(b, 1, edges);
+		return detail::clip_st(edges, operation, fill_rule);
+	},
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b, const BooleanOperation operation, const FillRule fill_rule) {
+		std::vector<detail::ClipEdge> edges;
+		detail::clip_add_edges(a, 0, edges);
+		detail::clip_add_edges(b, 1, edges);
+		return detail::clip_mt(edges, operation, fill_rule);
+	}
+};
+
+/*!
+ * Computes the total area of the contours of a shape.
+ * \param shape The contours of the shape.
+ * \return The sum of the areas of the contours. Holes count negatively.
+ */
+area_t total_area(const Batch<Polygon>& shape) {
+	area_t total = 0;
+	for(const area_t area : shape.area()) {
+		total += area;
+	}
+	return total;
+}
+
+/*!
+ * Constructs a copy of a polygon that is moved by a certain offset.
+ * \param polygon The polygon to move.
+ * \param delta The offset to move the polygon by.
+ * \return A moved copy of the polygon.
+ */
+Polygon moved(Polygon polygon, const Point2& delta) {
+	polygon.translate(delta);
+	return polygon;
+}
+
+/*!
+ * Generates random regular polygons, spread out such that many of them
+ * overlap.
+ * \param count How many polygons to generate.
+ * \param seed The seed for the random number generator.
+ * \return A batch of random polygons.
+ */
+Batch<Polygon> random_shape(const size_t count, const unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<coord_t> position(0, 1000);
+	std::uniform_int_distribution<coord_t> radius(50, 200);
+	std::uniform_int_distribution<size_t> num_vertices(3, 12);
+	Batch<Polygon> result;
+	for(size_t polygon = 0; polygon < count; ++polygon) {
+		const Point2 centre(position(generator), position(generator));
+		const coord_t size = radius(generator);
+		const size_t vertices = num_vertices(generator);
+		Polygon regular;
+		for(size_t vertex = 0; vertex < vertices; ++vertex) {
+			const double angle = std::numbers::pi * 2 * vertex / vertices;
+			regular.emplace_back(centre.x + std::lround(std::cos(angle) * size), centre.y + std::lround(std::sin(angle) * size));
+		}
+		result.push_back(regular);
+	}
+	return result;
+}
+
+/*!
+ * Tests clipping shapes without any contours.
+ */
+TEST(Clip, Empty) {
+	const Batch<Polygon> empty;
+	const Batch<Polygon> square = {PolygonTestCases::square_1000()};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		EXPECT_TRUE(clip_implementations[implementation](empty, empty, BooleanOperation::UNION, FillRule::NONZERO).empty()) << "Two empty shapes have an empty union (implementation " << implementation << ").";
+		EXPECT_EQ(clip_implementations[implementation](square, empty, BooleanOperation::UNION, FillRule::NONZERO), square) << "The union with an empty shape is the original shape (implementation " << implementation << ").";
+		EXPECT_TRUE(clip_implementations[implementation](square, empty, BooleanOperation::INTERSECTION, FillRule::NONZERO).empty()) << "Nothing intersects with an empty shape (implementation " << implementation << ").";
+		EXPECT_EQ(clip_implementations[implementation](square, empty, BooleanOperation::DIFFERENCE, FillRule::NONZERO), square) << "Subtracting an empty shape changes nothing (implementation " << implementation << ").";
+		EXPECT_TRUE(clip_implementations[implementation](empty, square, BooleanOperation::DIFFERENCE, FillRule::NONZERO).empty()) << "Subtracting from an empty shape leaves nothing (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the boolean operations on two squares that partially overlap.
+ */
+TEST(Clip, OverlappingSquares) {
+	const Polygon square = PolygonTestCases::square_1000();
+	const Polygon other = moved(square, Point2(500, 500));
+
+	const Batch<Polygon> united = clip(square, other, BooleanOperation::UNION);
+	ASSERT_EQ(united.size(), 1) << "The squares merge into one contour.";
+	EXPECT_EQ(united[0].size(), 8) << "The union has the 6 corners of the squares outside of the other square, and the 2 intersections.";
+	EXPECT_EQ(area(united[0]), 1750000) << "The union covers both squares, but the overlap only once.";
+
+	const Batch<Polygon> intersection = clip(square, other, BooleanOperation::INTERSECTION);
+	ASSERT_EQ(intersection.size(), 1) << "The overlap is one square.";
+	EXPECT_EQ(intersection[0], Polygon({Point2(500, 500), Point2(1000, 500), Point2(1000, 1000), Point2(500, 1000)})) << "The overlap is the square between the corners of the squares, winding counter-clockwise.";
+
+	const Batch<Polygon> difference = clip(square, other, BooleanOperation::DIFFERENCE);
+	ASSERT_EQ(difference.size(), 1) << "What remains of the first square is one contour.";
+	EXPECT_EQ(difference[0].size(), 6) << "An L-shape remains.";
+	EXPECT_EQ(area(difference[0]), 750000) << "The overlap was removed from the first square.";
+}
+
+/*!
+ * Tests the boolean operations on shapes that don't overlap.
+ */
+TEST(Clip, Disjoint) {
+	const Batch<Polygon> square = {PolygonTestCases::square_1000()};
+	const Batch<Polygon> far = {moved(PolygonTestCases::square_1000(), Point2(2000, 0))};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		EXPECT_EQ(clip_implementations[implementation](square, far, BooleanOperation::UNION, FillRule::NONZERO).size(), 2) << "Both squares remain separate contours (implementation " << implementation << ").";
+		EXPECT_TRUE(clip_implementations[implementation](square, far, BooleanOperation::INTERSECTION, FillRule::NONZERO).empty()) << "The squares don't overlap (implementation " << implementation << ").";
+		EXPECT_EQ(clip_implementations[implementation](square, far, BooleanOperation::DIFFERENCE, FillRule::NONZERO), square) << "Nothing of the first square is removed (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests subtracting a shape from the middle of another, which creates a hole.
+ */
+TEST(Clip, Hole) {
+	const Batch<Polygon> square = {PolygonTestCases::square_1000()};
+	const Batch<Polygon> inside = {Polygon({Point2(400, 400), Point2(600, 400), Point2(600, 600), Point2(400, 600)})};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = clip_implementations[implementation](square, inside, BooleanOperation::DIFFERENCE, FillRule::NONZERO);
+		ASSERT_EQ(result.size(), 2) << "The outer contour and the hole (implementation " << implementation << ").";
+		EXPECT_EQ(area(result[0]), 1000000) << "The outer contour winds counter-clockwise (implementation " << implementation << ").";
+		EXPECT_EQ(area(result[1]), -40000) << "The hole winds clockwise (implementation " << implementation << ").";
+
+		EXPECT_EQ(clip_implementations[implementation](inside, square, BooleanOperation::INTERSECTION, FillRule::NONZERO), inside) << "The inner square is completely inside of the outer square (implementation " << implementation << ").";
+		EXPECT_EQ(clip_implementations[implementation](inside, square, BooleanOperation::UNION, FillRule::NONZERO), square) << "The inner square adds nothing to the outer square (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the boolean operations on squares that touch each other.
+ */
+TEST(Clip, Touching) {
+	const Batch<Polygon> square = {PolygonTestCases::square_1000()};
+	const Batch<Polygon> adjacent = {moved(PolygonTestCases::square_1000(), Point2(1000, 0))};
+	const Batch<Polygon> diagonal = {moved(PolygonTestCases::square_1000(), Point2(1000, 1000))};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		const Batch<Polygon> rectangle = clip_implementations[implementation](square, adjacent, BooleanOperation::UNION, FillRule::NONZERO);
+		ASSERT_EQ(rectangle.size(), 1) << "Squares that share an edge merge (implementation " << implementation << ").";
+		EXPECT_EQ(rectangle[0], Polygon({Point2(0, 0), Point2(2000, 0), Point2(2000, 1000), Point2(0, 1000)})) << "The shared edge and the vertices in the middle of straight edges are removed (implementation " << implementation << ").";
+		EXPECT_TRUE(clip_implementations[implementation](square, adjacent, BooleanOperation::INTERSECTION, FillRule::NONZERO).empty()) << "Squares that share an edge have no area in common (implementation " << implementation << ").";
+
+		const Batch<Polygon> corners = clip_implementations[implementation](square, diagonal, BooleanOperation::UNION, FillRule::NONZERO);
+		EXPECT_EQ(corners.size(), 2) << "Squares that only share a corner remain separate contours (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(corners), 2000000) << "Both squares are in the union (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the difference between the fill rules, with a shape that consists of
+ * overlapping contours.
+ */
+TEST(Clip, FillRules) {
+	const Batch<Polygon> overlapping = {PolygonTestCases::square_1000(), moved(PolygonTestCases::square_1000(), Point2(500, 500))};
+	const Batch<Polygon> empty;
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		const Batch<Polygon> nonzero = clip_implementations[implementation](overlapping, empty, BooleanOperation::UNION, FillRule::NONZERO);
+		ASSERT_EQ(nonzero.size(), 1) << "With the nonzero rule, the overlap is inside, so the contours merge (implementation " << implementation << ").";
+		EXPECT_EQ(area(nonzero[0]), 1750000) << "The overlap is counted once (implementation " << implementation << ").";
+
+		const Batch<Polygon> even_odd = clip_implementations[implementation](overlapping, empty, BooleanOperation::UNION, FillRule::EVEN_ODD);
+		EXPECT_EQ(even_odd.size(), 2) << "With the even-odd rule, the overlap is outside, leaving two L-shapes that touch at their corners (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(even_odd), 1500000) << "The overlap is left out (implementation " << implementation << ").";
+	}
+	const Batch<Polygon> with_hole = {PolygonTestCases::square_1000(), Polygon({Point2(400, 400), Point2(400, 600), Point2(600, 600), Point2(600, 400)})};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		EXPECT_EQ(total_area(clip_implementations[implementation](with_hole, empty, BooleanOperation::UNION, FillRule::NONZERO)), 960000) << "A contour with opposite orientation cancels out the square (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(clip_implementations[implementation](with_hole, empty, BooleanOperation::UNION, FillRule::EVEN_ODD)), 960000) << "Any contour inside of the square toggles the inside (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(clip_implementations[implementation](with_hole, empty, BooleanOperation::UNION, FillRule::POSITIVE)), 960000) << "A clockwise contour inside of a counter-clockwise contour is a hole (implementation " << implementation << ").";
+	}
+	const Batch<Polygon> clockwise = {PolygonTestCases::negative_square()};
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		EXPECT_EQ(total_area(clip_implementations[implementation](clockwise, empty, BooleanOperation::UNION, FillRule::NONZERO)), 1000000) << "With the nonzero rule, the orientation doesn't matter (implementation " << implementation << ").";
+		EXPECT_TRUE(clip_implementations[implementation](clockwise, empty, BooleanOperation::UNION, FillRule::POSITIVE).empty()) << "With the positive rule, a clockwise contour is not filled by itself (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests removing the self-intersections of a polygon, by taking the union with
+ * an empty polygon.
+ */
+TEST(Clip, SelfIntersecting) {
+	const Batch<Polygon> result = clip(PolygonTestCases::hourglass(), PolygonTestCases::empty(), BooleanOperation::UNION);
+	ASSERT_EQ(result.size(), 2) << "The hourglass gets split into two triangles at its self-intersection.";
+	EXPECT_EQ(area(result[0]), 250000) << "The triangles both wind counter-clockwise, even though the original polygon winds in both directions.";
+	EXPECT_EQ(area(result[1]), 250000) << "The triangles both wind counter-clockwise, even though the original polygon winds in both directions.";
+}
+
+/*!
+ * Tests the boolean operations on shapes consisting of many overlapping
+ * polygons, by checking that the areas of the results are consistent with each
+ * other.
+ */
+TEST(Clip, Random) {
+	const Batch<Polygon> a = random_shape(30, 1);
+	const Batch<Polygon> b = random_shape(30, 2);
+	const Batch<Polygon> empty;
+	for(size_t implementation = 0; implementation < clip_implementations.size(); ++implementation) {
+		const area_t area_a = total_area(clip_implementations[implementation](a, empty, BooleanOperation::UNION, FillRule::NONZERO));
+		const area_t area_b = total_area(clip_implementations[implementation](b, empty, BooleanOperation::UNION, FillRule::NONZERO));
+		const area_t united = total_area(clip_implementations[implementation](a, b, BooleanOperation::UNION, FillRule::NONZERO));
+		const area_t intersection = total_area(clip_implementations[implementation](a, b, BooleanOperation::INTERSECTION, FillRule::NONZERO));
+		const area_t difference = total_area(clip_implementations[implementation](a, b, BooleanOperation::DIFFERENCE, FillRule::NONZERO));
+		ASSERT_GT(intersection, 0) << "The test is only meaningful if the shapes overlap (implementation " << implementation << ").";
+		//Rounding the intersections to whole coordinates changes the areas a bit.
+		EXPECT_NEAR(united + intersection, area_a + area_b, (area_a + area_b) / 1000) << "The union and intersection together cover both shapes (implementation " << implementation << ").";
+		EXPECT_NEAR(difference + intersection, area_a, area_a / 1000) << "The difference and intersection together make up the first shape (implementation " << implementation << ").";
+	}
+	EXPECT_EQ(clip_implementations[1](a, b, BooleanOperation::UNION, FillRule::EVEN_ODD), clip_implementations[2](a, b, BooleanOperation::UNION, FillRule::EVEN_ODD)) << "The single-threaded and multi-threaded implementations must give exactly the same result.";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,314 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <random> //To generate lots of points to test.
+
+#include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches of polygons.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons.
+#include "apex/detail/scheduler.hpp" //To split the polygons over many small tasks.
+#include "apex/fixed_polygon.hpp" //To test polygons with a fixed number of vertices.
+#include "apex/operations/contains.hpp" //The unit we're testing here.
+#include "apex/polygon.hpp" //To test polygons and their cached bounding boxes.
+
+namespace apex {
+
+/*!
+ * All implementations of testing a single point, to test all of them in the
+ * same way.
+ */
+const std::vector<std::function<bool(const Polygon&, const Point2&)>> point_implementations = {
+	[](const Polygon& polygon, const Point2& point) { return contains(polygon, point); },
+	[](const Polygon& polygon, const Point2& point) { return detail::contains_st(polygon, point); },
+	[](const Polygon& polygon, const Point2& point) { return detail::contains_mt(polygon, point); },
+#ifdef GPU
+	[](const Polygon& polygon, const Point2& point) { return detail::contains_gpu(polygon, point); },
+#endif
+	[](const Polygon& polygon, const Point2& point) { return polygon.contains(point); },
+	[](const Polygon& polygon, const Point2& point) -> bool { return contains(polygon, Batch<Point2>({point}))[0]; },
+	[](const Polygon& polygon, const Point2& point) -> bool { return detail::contains_st(polygon, Batch<Point2>({point}))[0]; },
+	[](const Polygon& polygon, const Point2& point) -> bool { return detail::contains_mt(polygon, Batch<Point2>({point}))[0]; },
+#ifdef GPU
+	[](const Polygon& polygon, const Point2& point) -> bool { return detail::contains_gpu(polygon, Batch<Point2>({point}))[0]; },
+#endif
+};
+
+/*!
+ * Test that nothing is inside of an empty polygon.
+ */
+TEST(PolygonContains, Empty) {
+	for(const auto& implementation : point_implementations) {
+		EXPECT_FALSE(implementation(PolygonTestCases::empty(), Point2(0, 0))) << "An empty polygon doesn't contain anything, not even the origin.";
+	}
+}
+
+/*!
+ * Test points inside, outside and on the border of a simple square.
+ */
+TEST(PolygonContains, Square) {
+	const Polygon square = PolygonTestCases::square_1000();
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(square, Point2(500, 500))) << "This point is in the middle of the square.";
+		EXPECT_TRUE(implementation(square, Point2(1, 999))) << "This point is just inside of the corner of the square.";
+		EXPECT_FALSE(implementation(square, Point2(1500, 500))) << "This point is to the right of the square.";
+		EXPECT_FALSE(implementation(square, Point2(-1, 500))) << "This point is just left of the square.";
+		EXPECT_FALSE(implementation(square, Point2(500, 1001))) << "This point is just above the square.";
+		EXPECT_TRUE(implementation(square, Point2(1000, 500))) << "Points on the edges of the square are inside.";
+		EXPECT_TRUE(implementation(square, Point2(500, 0))) << "Points on the edges of the square are inside.";
+		EXPECT_TRUE(implementation(square, Point2(0, 0))) << "The vertices of the square are on its border, so they are inside.";
+		EXPECT_TRUE(implementation(square, Point2(1000, 1000))) << "The vertices of the square are on its border, so they are inside.";
+		EXPECT_FALSE(implementation(square, Point2(2000, 0))) << "This point is in line with the bottom edge, but not on it.";
+	}
+}
+
+/*!
+ * Test that the winding direction of the polygon doesn't matter for points
+ * inside of it.
+ */
+TEST(PolygonContains, NegativeSquare) {
+	const Polygon square = PolygonTestCases::negative_square();
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(square, Point2(500, 500))) << "Clockwise polygons wind around the point too, just in the other direction.";
+		EXPECT_FALSE(implementation(square, Point2(1500, 500))) << "This point is to the right of the square.";
+		EXPECT_TRUE(implementation(square, Point2(0, 500))) << "Points on the edges of the square are inside.";
+	}
+}
+
+/*!
+ * Test points in and around a concave polygon.
+ */
+TEST(PolygonContains, Concave) {
+	const Polygon arrowhead = PolygonTestCases::arrowhead();
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(arrowhead, Point2(510, 700))) << "This point is inside of the tip of the arrowhead.";
+		EXPECT_FALSE(implementation(arrowhead, Point2(510, 200))) << "This point is in the notch at the back of the arrowhead, which is outside.";
+		EXPECT_TRUE(implementation(arrowhead, Point2(200, 300))) << "This point is inside of one of the barbs of the arrowhead.";
+		EXPECT_TRUE(implementation(arrowhead, Point2(510, 510))) << "This is the concave vertex, which is on the border.";
+	}
+}
+
+/*!
+ * Test points in a self-intersecting polygon, where one loop is clockwise and
+ * the other counter-clockwise.
+ */
+TEST(PolygonContains, SelfIntersecting) {
+	const Polygon hourglass = PolygonTestCases::hourglass();
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(hourglass, Point2(500, 100))) << "This point is inside of the bottom loop of the hourglass.";
+		EXPECT_TRUE(implementation(hourglass, Point2(500, 900))) << "This point is inside of the top loop of the hourglass.";
+		EXPECT_FALSE(implementation(hourglass, Point2(100, 500))) << "This point is beside the waist of the hourglass.";
+		EXPECT_TRUE(implementation(hourglass, Point2(500, 500))) << "This point is where the edges cross, which is on the border.";
+	}
+}
+
+/*!
+ * Test a polygon that loops around the same region twice, which has a winding
+ * number of 2 there.
+ */
+TEST(PolygonContains, LoopedTwice) {
+	const Polygon twice({Point2(0, 0), Point2(1000, 0), Point2(1000, 1000), Point2(0, 1000), Point2(0, 0), Point2(1000, 0), Point2(1000, 1000), Point2(0, 1000)});
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(twice, Point2(500, 500))) << "With the nonzero fill rule, regions that are looped twice are inside.";
+		EXPECT_FALSE(implementation(twice, Point2(1500, 500))) << "This point is outside of both loops.";
+	}
+}
+
+/*!
+ * Test polygons with degenerate shapes, that have no surface area.
+ */
+TEST(PolygonContains, Degenerate) {
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(PolygonTestCases::point(), PolygonTestCases::point()[0])) << "The only vertex is on the border of the polygon.";
+		EXPECT_FALSE(implementation(PolygonTestCases::point(), PolygonTestCases::point()[0] + Point2(1, 0))) << "The polygon has no surface area, so anything else is outside.";
+		const Polygon line = PolygonTestCases::line();
+		EXPECT_TRUE(implementation(line, line[0])) << "The vertices of the line are on its border.";
+		EXPECT_FALSE(implementation(line, line[0] + Point2(1, 0))) << "The line has no surface area, so points next to it are outside.";
+	}
+}
+
+/*!
+ * Test that the computation is exact for very large coordinates.
+ */
+TEST(PolygonContains, LargeCoordinates) {
+	constexpr coord_t big = 1000000000;
+	const Polygon square({Point2(-big, -big), Point2(big, -big), Point2(big, big), Point2(-big, big)});
+	const Polygon sliver({Point2(-big, -big), Point2(big, big - 1), Point2(big, big)}); //Very thin triangle along the diagonal.
+	for(const auto& implementation : point_implementations) {
+		EXPECT_TRUE(implementation(square, Point2(big - 1, 0))) << "This point is just inside of the right edge.";
+		EXPECT_FALSE(implementation(square, Point2(big + 1, 0))) << "This point is just outside of the right edge.";
+		EXPECT_TRUE(implementation(square, Point2(0, big))) << "This point is on the top edge.";
+		EXPECT_TRUE(implementation(sliver, Point2(big / 2, big / 2))) << "This point is on the long edge of the sliver.";
+		EXPECT_FALSE(implementation(sliver, Point2(big / 2 + 1, big / 2))) << "This point is just beside the sliver.";
+	}
+}
+
+/*!
+ * Test that points outside of a cached bounding box are rejected, and that the
+ * results remain correct.
+ */
+TEST(PolygonContains, CachedBoundingBox) {
+	const Polygon square = PolygonTestCases::square_1000();
+	square.bounding_box(); //Caches the bounding box.
+	ASSERT_TRUE(square.get_properties().has_bounding_box()) << "The bounding box must be cached for this test to be meaningful.";
+	EXPECT_FALSE(contains(square, Point2(2000, 500))) << "This point is outside of the bounding box.";
+	EXPECT_TRUE(contains(square, Point2(1000, 1000))) << "The corner of the bounding box is a vertex of the square.";
+	EXPECT_TRUE(contains(square, Point2(500, 500))) << "This point is in the middle of the square.";
+}
+
+/*!
+ * Test many random points against a polygon with many vertices, comparing the
+ * batched versions to testing each point separately.
+ */
+TEST(PolygonContains, ManyPoints) {
+	const Polygon circle = PolygonTestCases::circle();
+	std::mt19937 randomiser(42); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> position(-1100000, 1100000);
+	Batch<Point2> points;
+	for(size_t point = 0; point < 200; ++point) {
+		points.emplace_back(position(randomiser), position(randomiser));
+	}
+	points.push_back(circle[0]); //On the border.
+	points.push_back(circle[1000] + Point2(1, 1)); //Just outside.
+
+	Batch<bool> ground_truth;
+	for(const Point2& point : points) {
+		ground_truth.push_back(detail::contains_st(circle, point));
+	}
+	EXPECT_TRUE(ground_truth[200]) << "The vertex is on the border.";
+	EXPECT_EQ(contains(circle, points), ground_truth) << "The batched version must give the same results as testing each point separately.";
+	EXPECT_EQ(detail::contains_st(circle, points), ground_truth) << "The batched version must give the same results as testing each point separately.";
+	EXPECT_EQ(detail::contains_mt(circle, points), ground_truth) << "The batched version must give the same results as testing each point separately.";
+#ifdef GPU
+	EXPECT_EQ(detail::contains_gpu(circle, points), ground_truth) << "The batched version must give the same results as testing each point separately.";
+#endif
+	for(size_t point = 0; point < points.size(); ++point) {
+		const area_t distance_squared = area_t(points[point].x) * points[point].x + area_t(points[point].y) * points[point].y;
+		if(distance_squared < area_t(999000) * 999000) {
+			EXPECT_TRUE(ground_truth[point]) << "Points well inside of the radius of the circle must be inside.";
+		} else if(distance_squared > area_t(1000001) * 1000001) {
+			EXPECT_FALSE(ground_truth[point]) << "Points outside of the radius of the circle must be outside.";
+		}
+	}
+}
+
+/*!
+ * Test each polygon of a batch with a point of its own.
+ */
+TEST(PolygonBatchContains, EdgeCases) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::edge_cases();
+	const Batch<Point2> points = {Point2(500, 500), Point2(500, 100), Point2(500, 0), Point2(75, 150), Point2(25, 25), Point2(0, 0)};
+	ASSERT_EQ(batch.size(), points.size()) << "There must be a point for each polygon.";
+	const Batch<bool> ground_truth = {true, true, true, true, true, false};
+	EXPECT_EQ(contains(batch, points), ground_truth) << "The points are in the polygons or on their borders, except for the empty polygon.";
+	EXPECT_EQ(detail::contains_st(batch, points), ground_truth) << "The points are in the polygons or on their borders, except for the empty polygon.";
+	EXPECT_EQ(detail::contains_mt(batch, points), ground_truth) << "The points are in the polygons or on their borders, except for the empty polygon.";
+#ifdef GPU
+	EXPECT_EQ(detail::contains_gpu(batch, points), ground_truth) << "The points are in the polygons or on their borders, except for the empty polygon.";
+#endif
+}
+
+/*!
+ * Test pairing up the polygons of a batch with points some of which are
+ * outside.
+ */
+TEST(PolygonBatchContains, SquareTriangleSquare) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::square_triangle_square();
+	Batch<Point2> points;
+	for(const Subbatch<Point2>& polygon : batch) {
+		points.push_back(polygon[0] + Point2(10, 10));
+	}
+	Batch<bool> ground_truth;
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		ground_truth.push_back(detail::contains_st(batch[polygon], points[polygon]));
+	}
+	EXPECT_EQ(contains(batch, points), ground_truth) << "The batched version must give the same results as testing each polygon separately.";
+	EXPECT_EQ(detail::contains_st(batch, points), ground_truth) << "The batched version must give the same results as testing each polygon separately.";
+	EXPECT_EQ(detail::contains_mt(batch, points), ground_truth) << "The batched version must give the same results as testing each polygon separately.";
+#ifdef GPU
+	EXPECT_EQ(detail::contains_gpu(batch, points), ground_truth) << "The batched version must give the same results as testing each polygon separately.";
+#endif
+}
+
+/*!
+ * Test a batch with tasks that are much smaller than the polygons.
+ *
+ * The big polygons are then split over many tasks, which may run on different
+ * threads. The winding numbers of the parts must be added up to the same
+ * results as testing each polygon separately.
+ */
+TEST(PolygonBatchContains, SmallTasks) {
+	Batch<Polygon> batch;
+	for(size_t repeat = 0; repeat < 3; ++repeat) {
+		batch.push_back(PolygonTestCases::circle());
+		batch.push_back(PolygonTestCases::empty());
+		for(size_t small = 0; small < 20; ++small) {
+			batch.push_back(PolygonTestCases::square_1000());
+			batch.push_back(PolygonTestCases::triangle_1000());
+		}
+		batch.push_back(PolygonTestCases::arrowhead());
+	}
+	Batch<Point2> points;
+	Batch<bool> ground_truth;
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		points.emplace_back(coord_t(polygon * 37 % 1000), coord_t(polygon * 53 % 1000)); //Some inside, some outside, and some on the border.
+		ground_truth.push_back(detail::contains_st(batch[polygon], points[polygon]));
+	}
+	detail::Scheduler::set_grain_size(7);
+	for(const size_t threads : {1, 2, 4}) {
+		detail::Scheduler::set_num_threads(threads);
+		EXPECT_EQ(detail::contains_mt(batch, points), ground_truth) << "The batched version must give the same results as testing each polygon separately.";
+	}
+	detail::Scheduler::reset();
+}
+
+/*!
+ * Test whether points are inside of polygons with a fixed number of vertices.
+ *
+ * The polygons are truncated or padded to 4 vertices. The results must be the
+ * same as for normal polygons with the same vertices.
+ */
+TEST(FixedPolygonContains, SameAsPolygon) {
+	const std::vector<Point2> points = {Point2(0, 0), Point2(500, 500), Point2(500, 0), Point2(75, 150), Point2(-100, 50), Point2(1000, 1000)};
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::line(), PolygonTestCases::square_1000(), PolygonTestCases::triangle_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass(), PolygonTestCases::zero_width()}) {
+		const FixedPolygon<4> polygon(original);
+		for(const Point2& point : points) {
+			const bool ground_truth = detail::contains_st(polygon.to_polygon(), point);
+			EXPECT_EQ(contains(polygon, point), ground_truth) << "The result must be the same, regardless of how the vertices are stored.";
+			EXPECT_EQ(detail::contains_st(polygon, point), ground_truth) << "The result must be the same, regardless of how the vertices are stored.";
+			EXPECT_EQ(polygon.contains(point), ground_truth) << "The result must be the same, regardless of how the vertices are stored.";
+		}
+	}
+}
+
+/*!
+ * Test each polygon of a batch of polygons with a fixed number of vertices with
+ * a point of its own.
+ *
+ * The polygons are truncated or padded to 4 vertices. The results must be the
+ * same as for normal batches with the same vertices.
+ */
+TEST(FixedPolygonBatchContains, SameAsPolygonBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_line(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases()}) {
+		const Batch<FixedPolygon<4>> batch(original);
+		Batch<Point2> points;
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			points.push_back(batch[polygon][0] + Point2(10, 10));
+		}
+		const Batch<bool> ground_truth = detail::contains_st(batch.to_polygons(), points);
+		EXPECT_EQ(contains(batch, points), ground_truth) << "The results must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::contains_st(batch, points), ground_truth) << "The results must be the same, regardless of how the vertices are stored.";
+		EXPECT_EQ(detail::contains_mt(batch, points), ground_truth) << "The results must be the same, regardless of how the vertices are stored.";
+#ifdef GPU
+		EXPECT_EQ(detail::contains_gpu(batch, points), ground_truth) << "The results must be the same, regardless of how the vertices are stored.";
+#endif
+		EXPECT_EQ(batch.contains(points), ground_truth) << "The results must be the same, regardless of how the vertices are stored.";
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <cmath> //To generate regular polygons.
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <numbers> //To generate regular polygons.
+
+#include "apex/detail/scheduler.hpp" //To split the polygons over many small tasks.
+#include "apex/operations/convexity.hpp" //The unit we're testing here.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to classify.
+
+namespace apex {
+
+/*!
+ * All implementations of classifying the turns of a polygon, to test all of
+ * them in the same way.
+ */
+const std::vector<std::function<detail::TurnSummary(const Polygon&)>> turns_implementations = {
+	[](const Polygon& polygon) { return detail::turns_st(polygon); },
+	[](const Polygon& polygon) { return detail::turns_mt(polygon); },
+#ifdef GPU
+	[](const Polygon& polygon) { return detail::turns_gpu(polygon); },
+#endif
+	[](const Polygon& polygon) { return detail::turns_st(Batch<Polygon>({polygon}))[0]; },
+	[](const Polygon& polygon) { return detail::turns_mt(Batch<Polygon>({polygon}))[0]; },
+#ifdef GPU
+	[](const Polygon& polygon) { return detail::turns_gpu(Batch<Polygon>({polygon}))[0]; },
+#endif
+};
+
+/*!
+ * Finds the convexity of a polygon with the given implementation.
+ * \param implementation The index of the implementation to use.
+ * \param polygon The polygon to find the convexity of.
+ * \return The convexity of the polygon.
+ */
+PolygonProperties::Convexity convexity_with(const size_t implementation, const Polygon& polygon) {
+	return detail::classify_convexity(turns_implementations[implementation](polygon), PolygonProperties::SelfIntersecting::UNKNOWN);
+}
+
+/*!
+ * Constructs a regular polygon, winding counter-clockwise.
+ * \param num_vertices The number of vertices of the polygon.
+ * \param step How many vertices to skip, to construct star polygons.
+ * \return A regular polygon.
+ */
+Polygon regular_polygon(const size_t num_vertices, const size_t step = 1) {
+	Polygon result;
+	for(size_t vertex = 0; vertex < num_vertices; ++vertex) {
+		const double angle = std::numbers::pi * 2 / num_vertices * ((vertex * step) % num_vertices);
+		result.emplace_back(std::lround(std::cos(angle) * 1000000), std::lround(std::sin(angle) * 1000000));
+	}
+	return result;
+}
+
+/*!
+ * Tests that polygons without area are degenerate.
+ */
+TEST(Convexity, Degenerate) {
+	for(size_t implementation = 0; implementation < turns_implementations.size(); ++implementation) {
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::empty()), PolygonProperties::Convexity::DEGENERATE) << "An empty polygon has no area (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::point()), PolygonProperties::Convexity::DEGENERATE) << "A point has no area (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::line()), PolygonProperties::Convexity::DEGENERATE) << "A line has no area (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::zero_width()), PolygonProperties::Convexity::DEGENERATE) << "This polygon goes back along the same line (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests classifying convex polygons.
+ */
+TEST(Convexity, Convex) {
+	for(size_t implementation = 0; implementation < turns_implementations.size(); ++implementation) {
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::square_1000()), PolygonProperties::Convexity::CONVEX) << "A square is convex (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::negative_square()), PolygonProperties::Convexity::CONVEX) << "Convexity doesn't depend on the orientation (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::triangle_1000()), PolygonProperties::Convexity::CONVEX) << "A triangle is always convex (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, regular_polygon(1000)), PolygonProperties::Convexity::CONVEX) << "A regular polygon is convex (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::zero_length_segments()), PolygonProperties::Convexity::CONVEX) << "Coinciding vertices don't make a polygon concave (implementation " << implementation << ").";
+		const Polygon collinear({Point2(0, 0), Point2(500, 0), Point2(1000, 0), Point2(1000, 1000), Point2(0, 1000)});
+		EXPECT_EQ(convexity_with(implementation, collinear), PolygonProperties::Convexity::CONVEX) << "Vertices in the middle of a straight edge are not turns (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests classifying concave polygons.
+ */
+TEST(Convexity, Concave) {
+	for(size_t implementation = 0; implementation < turns_implementations.size(); ++implementation) {
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::arrowhead()), PolygonProperties::Convexity::CONCAVE) << "The arrowhead has a concave vertex (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::touching_vertex()), PolygonProperties::Convexity::CONCAVE) << "Touching itself is not detected by its turns (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests classifying polygons that intersect themselves in a way that can be
+ * seen from their turns.
+ */
+TEST(Convexity, SelfIntersecting) {
+	for(size_t implementation = 0; implementation < turns_implementations.size(); ++implementation) {
+		EXPECT_EQ(convexity_with(implementation, PolygonTestCases::hourglass()), PolygonProperties::Convexity::DEGENERATE) << "The turns of the two halves of the hourglass cancel out (implementation " << implementation << ").";
+		EXPECT_EQ(convexity_with(implementation, regular_polygon(5, 2)), PolygonProperties::Convexity::DEGENERATE) << "The pentagram turns the same way everywhere, but goes around twice (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests that the convexity is stored in the properties of the polygon, along
+ * with the other properties that were found in the same pass.
+ */
+TEST(Convexity, Caching) {
+	const Polygon square = PolygonTestCases::square_1000();
+	EXPECT_EQ(convexity(square), PolygonProperties::Convexity::CONVEX) << "A square is convex.";
+	const PolygonProperties properties = square.get_properties();
+	EXPECT_EQ(properties.convexity(), PolygonProperties::Convexity::CONVEX) << "The convexity must be stored.";
+	EXPECT_EQ(properties.orientation(), PolygonProperties::Orientation::POSITIVE) << "The orientation was found in the same pass.";
+	EXPECT_EQ(properties.self_intersecting(), PolygonProperties::SelfIntersecting::NO) << "Convex polygons can't intersect themselves.";
+	ASSERT_TRUE(properties.has_area()) << "The area was computed in the same pass.";
+	EXPECT_EQ(properties.area(), 1000000) << "The area must be stored correctly.";
+
+	PolygonProperties known;
+	known.set_convexity(PolygonProperties::Convexity::CONCAVE);
+	square.set_properties(known);
+	EXPECT_EQ(convexity(square), PolygonProperties::Convexity::CONCAVE) << "If the convexity is already known, it is not computed again.";
+
+	PolygonProperties intersecting;
+	intersecting.set_self_intersecting(PolygonProperties::SelfIntersecting::YES);
+	const Polygon arrowhead = PolygonTestCases::arrowhead();
+	arrowhead.set_properties(intersecting);
+	EXPECT_EQ(convexity(arrowhead), PolygonProperties::Convexity::DEGENERATE) << "Concave polygons that are known to intersect themselves are degenerate.";
+}
+
+/*!
+ * Tests finding the convexity of each polygon in a batch.
+ */
+TEST(Convexity, Batch) {
+	const Batch<Polygon> batch = {PolygonTestCases::square_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::empty(), PolygonTestCases::hourglass()};
+	const Batch<PolygonProperties::Convexity> expected = {PolygonProperties::Convexity::CONVEX, PolygonProperties::Convexity::CONCAVE, PolygonProperties::Convexity::DEGENERATE, PolygonProperties::Convexity::DEGENERATE};
+	EXPECT_EQ(convexity(batch), expected) << "Each polygon must be classified.";
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		EXPECT_EQ(batch.get_properties(polygon).convexity(), expected[polygon]) << "The convexity must be stored for each polygon of the batch.";
+		EXPECT_TRUE(batch.get_properties(polygon).has_area()) << "The area was computed in the same pass.";
+	}
+	EXPECT_EQ(convexity(batch), expected) << "The stored convexity must be returned the second time.";
+}
+
+/*!
+ * Tests classifying the turns of a batch with tasks that are much smaller than
+ * the polygons.
+ *
+ * The big polygons are then split over many tasks, which may run on different
+ * threads. The summaries of the parts must be added up to the same summaries
+ * as classifying each polygon separately.
+ */
+TEST(Convexity, BatchSmallTasks) {
+	const Batch<Polygon> batch = {regular_polygon(100), PolygonTestCases::empty(), PolygonTestCases::arrowhead(), regular_polygon(50, 7), PolygonTestCases::zero_length_segments(), PolygonTestCases::hourglass()};
+	detail::Scheduler::set_grain_size(7);
+	for(const size_t threads : {1, 2, 4}) {
+		detail::Scheduler::set_num_threads(threads);
+		const Batch<detail::TurnSummary> result = detail::turns_mt(batch);
+		ASSERT_EQ(result.size(), batch.size());
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const detail::TurnSummary ground_truth = detail::turns_st(batch[polygon]);
+			EXPECT_EQ(result[polygon].double_area, ground_truth.double_area);
+			EXPECT_EQ(result[polygon].left_turns, ground_truth.left_turns);
+			EXPECT_EQ(result[polygon].right_turns, ground_truth.right_turns);
+			EXPECT_EQ(result[polygon].reversals, ground_truth.reversals);
+			EXPECT_EQ(result[polygon].turning_number, ground_truth.turning_number);
+		}
+	}
+	detail::Scheduler::reset();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <cmath> //To generate regular polygons.
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <numbers> //To generate regular polygons.
+#include <random> //To generate lots of line segments and polygons to test.
+#include <string> //To describe the test cases.
+#include <tuple> //To list the test cases.
+
+#include "apex/operations/intersects.hpp" //The unit we're testing here.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to intersect.
+
+namespace apex {
+
+/*!
+ * All implementations of testing pairs of line segments, to test all of them
+ * in the same way.
+ */
+const std::vector<std::function<Batch<bool>(const Batch<LineSegment>&, const Batch<LineSegment>&)>> pairwise_implementations = {
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return intersects(a, b); },
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersects_st(a, b); },
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersects_mt(a, b); },
+#ifdef GPU
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersects_gpu(a, b); },
+#endif
+};
+
+/*!
+ * All implementations of finding all intersecting pairs between two batches of
+ * line segments, to test all of them in the same way.
+ */
+const std::vector<std::function<Batch<std::pair<size_t, size_t>>(const Batch<LineSegment>&, const Batch<LineSegment>&)>> all_pairs_implementations = {
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return intersecting_pairs(a, b); },
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersecting_pairs_st(a, b); },
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersecting_pairs_mt(a, b); },
+#ifdef GPU
+	[](const Batch<LineSegment>& a, const Batch<LineSegment>& b) { return detail::intersecting_pairs_gpu(a, b); },
+#endif
+};
+
+/*!
+ * All implementations of finding all intersecting pairs between two batches of
+ * polygons, to test all of them in the same way.
+ */
+const std::vector<std::function<Batch<std::pair<size_t, size_t>>(const Batch<Polygon>&, const Batch<Polygon>&)>> polygon_pairs_implementations = {
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b) { return intersecting_pairs(a, b); },
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b) { return intersecting_pairs(a, b, RTree(b)); },
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b) { return detail::intersecting_pairs_st(a, b, detail::intersecting_candidates(a, RTree(b))); },
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b) { return detail::intersecting_pairs_mt(a, b, detail::intersecting_candidates(a, RTree(b))); },
+#ifdef GPU
+	[](const Batch<Polygon>& a, const Batch<Polygon>& b) { return detail::intersecting_pairs_gpu(a, b, detail::intersecting_candidates(a, RTree(b))); },
+#endif
+};
+
+/*!
+ * Generates random line segments, many of which intersect.
+ * \param count How many line segments to generate.
+ * \param seed The seed for the random number generator.
+ * \return A batch of random line segments.
+ */
+Batch<LineSegment> random_segments(const size_t count, const unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<coord_t> distribution(0, 20); //A small range, so that there are also many parallel and collinear segments.
+	Batch<LineSegment> result;
+	for(size_t segment = 0; segment < count; ++segment) {
+		result.emplace_back(Point2(distribution(generator), distribution(generator)), Point2(distribution(generator), distribution(generator)));
+	}
+	return result;
+}
+
+/*!
+ * Generates random small polygons, spread out such that some of them intersect.
+ *
+ * The polygons are regular polygons, so they are convex.
+ * \param count How many polygons to generate.
+ * \param seed The seed for the random number generator.
+ * \return A batch of random polygons.
+ */
+Batch<Polygon> random_polygons(const size_t count, const unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<coord_t> position(0, 1000);
+	std::uniform_int_distribution<coord_t> radius(10, 50);
+	std::uniform_int_distribution<size_t> num_vertices(3, 8);
+	Batch<Polygon> result;
+	for(size_t polygon = 0; polygon < count; ++polygon) {
+		const Point2 centre(position(generator), position(generator));
+		const coord_t size = radius(generator);
+		const size_t vertices = num_vertices(generator);
+		Polygon regular;
+		for(size_t vertex = 0; vertex < vertices; ++vertex) {
+			const double angle = std::numbers::pi * 2 * vertex / vertices;
+			regular.emplace_back(centre.x + std::lround(std::cos(angle) * size), centre.y + std::lround(std::sin(angle) * size));
+		}
+		result.push_back(regular);
+	}
+	return result;
+}
+
+/*!
+ * Marks a copy of a polygon as being convex, so that the separating axis test
+ * is used for it.
+ * \param polygon The polygon to mark.
+ * \return A copy of the polygon, marked as convex.
+ */
+Polygon mark_convex(Polygon polygon) {
+	PolygonProperties properties;
+	properties.set_convexity(PolygonProperties::Convexity::CONVEX);
+	polygon.set_properties(properties);
+	return polygon;
+}
+
+/*!
+ * Tests testing empty batches of line segments.
+ */
+TEST(Intersects, Empty) {
+	for(size_t implementation = 0; implementation < pairwise_implementations.size(); ++implementation) {
+		EXPECT_TRUE(pairwise_implementations[implementation](Batch<LineSegment>(), Batch<LineSegment>()).empty()) << "There are no pairs to test (implementation " << implementation << ").";
+	}
+	const Batch<LineSegment> segments = random_segments(10, 0);
+	for(size_t implementation = 0; implementation < all_pairs_implementations.size(); ++implementation) {
+		EXPECT_TRUE(all_pairs_implementations[implementation](Batch<LineSegment>(), segments).empty()) << "Without segments on one side, there are no pairs (implementation " << implementation << ").";
+		EXPECT_TRUE(all_pairs_implementations[implementation](segments, Batch<LineSegment>()).empty()) << "Without segments on one side, there are no pairs (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the edge cases of intersecting line segments, such as parallel and
+ * touching segments.
+ */
+TEST(Intersects, EdgeCases) {
+	const Batch<LineSegment> a = {
+		LineSegment(Point2(0, 0), Point2(100, 100)), //Crossing.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Sharing an endpoint.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //T-junction.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Parallel, but not collinear.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Collinear and overlapping.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Collinear, but apart.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Collinear, touching at the endpoints.
+		LineSegment(Point2(0, 0), Point2(100, 0)), //Missing.
+		LineSegment(Point2(50, 0), Point2(50, 0)) //Zero length, on the other segment.
+	};
+	const Batch<LineSegment> b = {
+		LineSegment(Point2(100, 0), Point2(0, 100)),
+		LineSegment(Point2(100, 0), Point2(100, 100)),
+		LineSegment(Point2(50, 0), Point2(50, 100)),
+		LineSegment(Point2(0, 10), Point2(100, 10)),
+		LineSegment(Point2(50, 0), Point2(150, 0)),
+		LineSegment(Point2(150, 0), Point2(200, 0)),
+		LineSegment(Point2(200, 0), Point2(100, 0)),
+		LineSegment(Point2(200, -100), Point2(200, 100)),
+		LineSegment(Point2(0, 0), Point2(100, 0))
+	};
+	const Batch<bool> ground_truth = {true, true, true, false, true, false, true, false, true};
+	for(size_t implementation = 0; implementation < pairwise_implementations.size(); ++implementation) {
+		EXPECT_EQ(pairwise_implementations[implementation](a, b), ground_truth) << "The implementation must give the same results as the scalar test (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests that the batched tests give the same results as the scalar test for
+ * many random pairs of line segments.
+ */
+TEST(Intersects, Random) {
+	const Batch<LineSegment> a = random_segments(10000, 1);
+	const Batch<LineSegment> b = random_segments(10000, 2);
+	Batch<bool> ground_truth;
+	for(size_t pair = 0; pair < a.size(); ++pair) {
+		ground_truth.push_back(a[pair].intersects(b[pair]));
+	}
+	for(size_t implementation = 0; implementation < pairwise_implementations.size(); ++implementation) {
+		EXPECT_EQ(pairwise_implementations[implementation](a, b), ground_truth) << "The implementation must give the same results as the scalar test (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests finding all intersecting pairs between two batches of line segments.
+ */
+TEST(Intersects, AllPairs) {
+	const Batch<LineSegment> a = random_segments(100, 3);
+	const Batch<LineSegment> b = random_segments(150, 4);
+	Batch<std::pair<size_t, size_t>> ground_truth;
+	for(size_t segment = 0; segment < a.size(); ++segment) {
+		for(size_t other = 0; other < b.size(); ++other) {
+			if(a[segment].intersects(b[other])) {
+				ground_truth.emplace_back(segment, other);
+			}
+		}
+	}
+	ASSERT_FALSE(ground_truth.empty()) << "The test is only meaningful if some segments intersect.";
+	for(size_t implementation = 0; implementation < all_pairs_implementations.size(); ++implementation) {
+		EXPECT_EQ(all_pairs_implementations[implementation](a, b), ground_truth) << "All intersecting pairs must be found, in order (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests whether two polygons intersect in various situations, including
+ * touching polygons and polygons inside of each other.
+ */
+TEST(Intersects, TwoPolygons) {
+	const Polygon square = PolygonTestCases::square_1000();
+	Polygon overlapping = square;
+	overlapping.translate(Point2(500, 500));
+	Polygon disjoint = square;
+	disjoint.translate(Point2(2000, 0));
+	Polygon touching_edge = square;
+	touching_edge.translate(Point2(1000, 0));
+	Polygon touching_corner = square;
+	touching_corner.translate(Point2(1000, 1000));
+	const Polygon inside({Point2(400, 400), Point2(600, 400), Point2(600, 600), Point2(400, 600)});
+	const Polygon triangle({Point2(0, 0), Point2(1000, 0), Point2(0, 1000)});
+	const Polygon opposite_triangle({Point2(1000, 1000), Point2(100, 1000), Point2(1000, 100)}); //Overlapping bounding boxes, but separated by the diagonal.
+
+	const std::vector<std::tuple<Polygon, Polygon, bool, std::string>> cases = {
+		{square, overlapping, true, "The squares overlap partially."},
+		{square, disjoint, false, "The squares are far apart."},
+		{square, touching_edge, true, "The squares share an edge."},
+		{square, touching_corner, true, "The squares share a corner."},
+		{square, inside, true, "The small square is completely inside of the big square."},
+		{inside, square, true, "The small square is completely inside of the big square."},
+		{triangle, opposite_triangle, false, "The bounding boxes overlap, but the triangles are on opposite sides of the diagonal."},
+		{square, PolygonTestCases::empty(), false, "Empty polygons don't intersect anything."},
+		{PolygonTestCases::empty(), square, false, "Empty polygons don't intersect anything."}
+	};
+	for(const std::tuple<Polygon, Polygon, bool, std::string>& test_case : cases) {
+		EXPECT_EQ(intersects(std::get<0>(test_case), std::get<1>(test_case)), std::get<2>(test_case)) << std::get<3>(test_case);
+		EXPECT_EQ(intersects(std::get<1>(test_case), std::get<0>(test_case)), std::get<2>(test_case)) << std::get<3>(test_case) << " The order of the polygons must not matter.";
+		if(!std::get<0>(test_case).empty() && !std::get<1>(test_case).empty()) {
+			EXPECT_EQ(intersects(mark_convex(std::get<0>(test_case)), mark_convex(std::get<1>(test_case))), std::get<2>(test_case)) << std::get<3>(test_case) << " The separating axis test must give the same result.";
+		}
+	}
+}
+
+/*!
+ * Tests finding all intersecting pairs between two batches of polygons, by
+ * comparing with testing all pairs one by one.
+ */
+TEST(Intersects, PolygonPairs) {
+	Batch<Polygon> a = random_polygons(200, 5);
+	Batch<Polygon> b = random_polygons(300, 6);
+	a.push_back(PolygonTestCases::empty()); //Empty polygons must be skipped, on either side.
+	b.push_back(PolygonTestCases::empty());
+	Batch<std::pair<size_t, size_t>> ground_truth;
+	for(size_t polygon = 0; polygon < a.size(); ++polygon) {
+		for(size_t other = 0; other < b.size(); ++other) {
+			if(intersects(a[polygon], b[other])) {
+				ground_truth.emplace_back(polygon, other);
+			}
+		}
+	}
+	ASSERT_FALSE(ground_truth.empty()) << "The test is only meaningful if some polygons intersect.";
+	for(size_t implementation = 0; implementation < polygon_pairs_implementations.size(); ++implementation) {
+		EXPECT_EQ(polygon_pairs_implementations[implementation](a, b), ground_truth) << "All intersecting pairs must be found, in order (implementation " << implementation << ").";
+	}
+
+	//The random polygons are all convex, so marking them as such must give the same results.
+	PolygonProperties convex;
+	convex.set_convexity(PolygonProperties::Convexity::CONVEX);
+	for(size_t polygon = 0; polygon + 1 < a.size(); ++polygon) {
+		a.set_properties(polygon, convex);
+	}
+	for(size_t polygon = 0; polygon + 1 < b.size(); ++polygon) {
+		b.set_properties(polygon, convex);
+	}
+	for(size_t implementation = 0; implementation < polygon_pairs_implementations.size(); ++implementation) {
+		EXPECT_EQ(polygon_pairs_implementations[implementation](a, b), ground_truth) << "The separating axis test must find the same pairs (implementation " << implementation << ").";
+	}
+}
+
+}
\ No newline at end of file
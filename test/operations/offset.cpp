@@ -0,0 +1,240 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <algorithm> //For std::min and std::max, to compute bounding boxes.
+#include <cmath> //To compute the expected areas of round joins.
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <numbers> //To compute the expected areas of round joins.
+
+#include "apex/operations/offset.hpp" //The unit we're testing here.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to offset.
+
+namespace apex {
+
+/*!
+ * All implementations of offsetting, to test all of them in the same way.
+ */
+const std::vector<std::function<Batch<Polygon>(const Batch<Polygon>&, const coord_t, const JoinType)>> offset_implementations = {
+	[](const Batch<Polygon>& shape, const coord_t distance, const JoinType join) { return offset(shape, distance, join); },
+	[](const Batch<Polygon>& shape, const coord_t distance, const JoinType join) { return detail::offset_st(detail::offset_prepare(shape), distance, join); },
+	[](const Batch<Polygon>& shape, const coord_t distance, const JoinType join) { return detail::offset_mt(detail::offset_prepare(shape), distance, join); },
+#ifdef GPU
+	[](const Batch<Polygon>& shape, const coord_t distance, const JoinType join) { return detail::offset_gpu(detail::offset_prepare(shape), distance, join); },
+#endif
+	[](const Batch<Polygon>& shape, const coord_t distance, const JoinType join) { return offset(shape[0], distance, join); } //Only for shapes with one contour.
+};
+
+/*!
+ * Computes the total area of the contours of a shape.
+ * \param shape The contours of the shape.
+ * \return The sum of the areas of the contours. Holes count negatively.
+ */
+area_t total_area(const Batch<Polygon>& shape) {
+	area_t total = 0;
+	for(const area_t area : shape.area()) {
+		total += area;
+	}
+	return total;
+}
+
+/*!
+ * Computes the bounding box around all contours of a shape.
+ * \param shape The contours of the shape.
+ * \return The minimum and maximum coordinates of the shape.
+ */
+std::pair<Point2, Point2> total_bounding_box(const Batch<Polygon>& shape) {
+	std::pair<Point2, Point2> result = std::make_pair(shape[0][0], shape[0][0]);
+	for(size_t contour = 0; contour < shape.size(); ++contour) {
+		for(const Point2& vertex : shape[contour]) {
+			result.first = Point2(std::min(result.first.x, vertex.x), std::min(result.first.y, vertex.y));
+			result.second = Point2(std::max(result.second.x, vertex.x), std::max(result.second.y, vertex.y));
+		}
+	}
+	return result;
+}
+
+/*!
+ * Tests offsetting polygons that have no area or no edges to offset.
+ */
+TEST(Offset, Empty) {
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		EXPECT_TRUE(offset_implementations[implementation]({PolygonTestCases::empty()}, 100, JoinType::MITER).empty()) << "There are no edges to offset (implementation " << implementation << ").";
+		EXPECT_TRUE(offset_implementations[implementation]({PolygonTestCases::point()}, 100, JoinType::ROUND).empty()) << "A single point has no direction to offset towards (implementation " << implementation << ").";
+	}
+	EXPECT_TRUE(offset(Batch<Polygon>(), 100).empty()) << "A batch without contours has no edges to offset.";
+}
+
+/*!
+ * Tests offsetting by a distance of 0, which leaves the polygon unchanged.
+ */
+TEST(Offset, ZeroDistance) {
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({PolygonTestCases::square_1000()}, 0, JoinType::MITER);
+		ASSERT_EQ(result.size(), 1) << "The square stays one contour (implementation " << implementation << ").";
+		EXPECT_EQ(result[0].size(), 4) << "The square keeps its 4 vertices (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(result), 1000000) << "The square keeps its area (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests growing a square with miter joins, which keeps its corners sharp.
+ */
+TEST(Offset, OutsetMiter) {
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({PolygonTestCases::square_1000()}, 100, JoinType::MITER);
+		ASSERT_EQ(result.size(), 1) << "The grown square is one contour (implementation " << implementation << ").";
+		EXPECT_EQ(result[0].size(), 4) << "Miter joins keep the corners sharp (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(result), 1200 * 1200) << "Each side grows by 100 on both ends (implementation " << implementation << ").";
+		EXPECT_EQ(total_bounding_box(result), std::make_pair(Point2(-100, -100), Point2(1100, 1100))) << "All edges moved outwards by 100 (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests shrinking a square.
+ */
+TEST(Offset, InsetMiter) {
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({PolygonTestCases::square_1000()}, -100, JoinType::MITER);
+		ASSERT_EQ(result.size(), 1) << "The shrunk square is one contour (implementation " << implementation << ").";
+		EXPECT_EQ(result[0].size(), 4) << "The corners are cut off by the inner loops, leaving sharp corners (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(result), 800 * 800) << "Each side shrinks by 100 on both ends (implementation " << implementation << ").";
+		EXPECT_EQ(total_bounding_box(result), std::make_pair(Point2(100, 100), Point2(900, 900))) << "All edges moved inwards by 100 (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests shrinking polygons by more than half of their width, which makes them
+ * disappear.
+ */
+TEST(Offset, InsetVanishes) {
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		EXPECT_TRUE(offset_implementations[implementation]({PolygonTestCases::square_1000()}, -600, JoinType::MITER).empty()) << "The square is only 1000 wide, so it can't shrink by 600 on both sides (implementation " << implementation << ").";
+		EXPECT_TRUE(offset_implementations[implementation]({PolygonTestCases::thin_rectangle()}, -1, JoinType::ROUND).empty()) << "The rectangle is only 1 wide (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests growing a square with round joins.
+ */
+TEST(Offset, OutsetRound) {
+	const double expected = 1000.0 * 1000 + 4 * 1000 * 100 + std::numbers::pi * 100 * 100;
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({PolygonTestCases::square_1000()}, 100, JoinType::ROUND);
+		ASSERT_EQ(result.size(), 1) << "The grown square is one contour (implementation " << implementation << ").";
+		EXPECT_GT(result[0].size(), 4 * 10) << "Each corner is rounded with many line segments (implementation " << implementation << ").";
+		EXPECT_NEAR(total_area(result), expected, expected * 0.001) << "The corners are quarter circles with a radius of 100 (implementation " << implementation << ").";
+		EXPECT_EQ(total_bounding_box(result), std::make_pair(Point2(-100, -100), Point2(1100, 1100))) << "The arcs don't extend beyond the offset edges (implementation " << implementation << ").";
+		for(const Point2& vertex : result[0]) {
+			const double clamped_x = std::max<coord_t>(0, std::min<coord_t>(1000, vertex.x));
+			const double clamped_y = std::max<coord_t>(0, std::min<coord_t>(1000, vertex.y));
+			EXPECT_NEAR(std::hypot(vertex.x - clamped_x, vertex.y - clamped_y), 100, 1) << "All vertices are 100 away from the original square (implementation " << implementation << ").";
+		}
+	}
+}
+
+/*!
+ * Tests that polygons that wind clockwise grow outwards too.
+ */
+TEST(Offset, Clockwise) {
+	const Batch<Polygon> result = offset(PolygonTestCases::negative_square(), 100);
+	ASSERT_EQ(result.size(), 1) << "The grown square is one contour.";
+	EXPECT_EQ(total_area(result), 1200 * 1200) << "The square grows outwards, and the result winds counter-clockwise.";
+}
+
+/*!
+ * Tests that the lobes of a self-intersecting polygon all grow outwards, even if
+ * they wind in opposite directions.
+ */
+TEST(Offset, SelfIntersecting) {
+	const Batch<Polygon> hourglass = offset(PolygonTestCases::hourglass(), 100);
+	const std::pair<Point2, Point2> bounding_box = total_bounding_box(hourglass);
+	EXPECT_EQ(bounding_box.first.y, -100) << "The bottom lobe of the hourglass grows outwards.";
+	EXPECT_EQ(bounding_box.second.y, 1100) << "The top lobe of the hourglass grows outwards.";
+	EXPECT_GT(total_area(hourglass), 1000 * 1000 / 2) << "Both lobes of the hourglass grow, so the area increases.";
+
+	const Polygon twisted({Point2(627, 493), Point2(727, 361), Point2(549, 589), Point2(606, 504)});
+	const Batch<Polygon> normalised = clip(twisted, Polygon(), BooleanOperation::UNION);
+	const Batch<Polygon> grown = offset(twisted, 60, JoinType::ROUND);
+	EXPECT_EQ(grown, offset(normalised, 60, JoinType::ROUND)) << "The polygon is grown as if it were normalised first.";
+	EXPECT_GT(total_area(grown), total_area(normalised)) << "All lobes grow outwards.";
+}
+
+/*!
+ * Tests that very sharp corners are cut off instead of extending far away.
+ */
+TEST(Offset, MiterLimit) {
+	const Polygon spike({Point2(0, 0), Point2(1000, 50), Point2(0, 100)});
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({spike}, 10, JoinType::MITER);
+		ASSERT_EQ(result.size(), 1) << "The grown spike is one contour (implementation " << implementation << ").";
+		EXPECT_LE(total_bounding_box(result).second.x, 1000 + 10 * detail::miter_limit) << "The tip of the spike must be cut off (implementation " << implementation << ").";
+		EXPECT_GE(total_bounding_box(result).second.x, 1000) << "The cut-off corner may not go inside the original spike (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests offsetting a line segment, which grows on both sides.
+ */
+TEST(Offset, LineSegment) {
+	const double length = std::hypot(50.0, 100.0);
+	const double expected = 2 * 10 * length + std::numbers::pi * 10 * 10;
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({PolygonTestCases::line()}, 10, JoinType::ROUND);
+		ASSERT_EQ(result.size(), 1) << "The line segment grows into a single contour (implementation " << implementation << ").";
+		EXPECT_NEAR(total_area(result), expected, expected * 0.02) << "The segment grows into a rectangle with half circles at the ends (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests growing a shape with a hole, which makes the hole shrink.
+ */
+TEST(Offset, Hole) {
+	const Batch<Polygon> shape = {PolygonTestCases::square_1000(), Polygon({Point2(400, 400), Point2(400, 600), Point2(600, 600), Point2(600, 400)})};
+	for(size_t implementation = 0; implementation + 1 < offset_implementations.size(); ++implementation) { //The last implementation only offsets the first contour.
+		const Batch<Polygon> grown = offset_implementations[implementation](shape, 50, JoinType::MITER);
+		ASSERT_EQ(grown.size(), 2) << "The hole shrinks, but doesn't disappear yet (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(grown), 1100 * 1100 - 100 * 100) << "The outside grows by 50, so the hole shrinks by 50 (implementation " << implementation << ").";
+		const Batch<Polygon> closed = offset_implementations[implementation](shape, 150, JoinType::MITER);
+		ASSERT_EQ(closed.size(), 1) << "The hole closes up completely (implementation " << implementation << ").";
+		EXPECT_EQ(total_area(closed), 1300 * 1300) << "Only the grown outside remains (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests shrinking a polygon with a thin part, which splits it up into multiple
+ * parts.
+ */
+TEST(Offset, Split) {
+	const Polygon dumbbell({Point2(0, 0), Point2(400, 0), Point2(400, 150), Point2(600, 150), Point2(600, 0), Point2(1000, 0), Point2(1000, 400), Point2(600, 400), Point2(600, 250), Point2(400, 250), Point2(400, 400), Point2(0, 400)});
+	for(size_t implementation = 0; implementation < offset_implementations.size(); ++implementation) {
+		const Batch<Polygon> result = offset_implementations[implementation]({dumbbell}, -60, JoinType::MITER);
+		ASSERT_EQ(result.size(), 2) << "The bar in the middle is only 100 wide, so it vanishes (implementation " << implementation << ").";
+		EXPECT_EQ(result.area(), Batch<area_t>({280 * 280, 280 * 280})) << "Both ends shrink to squares of 280 wide (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests generating repeated insets.
+ */
+TEST(Offset, Insets) {
+	const std::vector<Batch<Polygon>> walls = insets(PolygonTestCases::square_1000(), 100, 10);
+	ASSERT_EQ(walls.size(), 4) << "The fifth inset would be 500 inwards from each side, which leaves nothing of the square.";
+	for(size_t wall = 0; wall < walls.size(); ++wall) {
+		const coord_t inwards = coord_t(wall + 1) * 100;
+		ASSERT_EQ(walls[wall].size(), 1) << "Each inset of the square is one contour.";
+		EXPECT_EQ(total_bounding_box(walls[wall]), std::make_pair(Point2(inwards, inwards), Point2(1000 - inwards, 1000 - inwards))) << "Each inset is 100 further inwards than the previous one.";
+		EXPECT_EQ(total_area(walls[wall]), total_area(offset(PolygonTestCases::square_1000(), -inwards))) << "The corners of the square are not cut off, so the insets are the same as offsetting the original by the total distance.";
+	}
+	EXPECT_EQ(insets(PolygonTestCases::square_1000(), 100, 2).size(), 2) << "Only 2 insets were requested.";
+	EXPECT_TRUE(insets(PolygonTestCases::square_1000(), 100, 0).empty()) << "No insets were requested.";
+	const Batch<Polygon> shape = {PolygonTestCases::square_1000()};
+	EXPECT_EQ(insets(shape, 100, 10).size(), 4) << "The insets of a batch are the same as those of its only contour.";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <functional> //To test all implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+
+#include "apex/operations/orientation.hpp" //The unit we're testing here.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to classify.
+
+namespace apex {
+
+/*!
+ * All implementations of finding the orientation of a polygon, to test all of
+ * them in the same way.
+ */
+const std::vector<std::function<PolygonProperties::Orientation(const Polygon&)>> orientation_implementations = {
+	[](const Polygon& polygon) { return orientation(polygon); },
+	[](const Polygon& polygon) { return detail::classify_orientation(detail::turns_st(polygon), PolygonProperties::SelfIntersecting::UNKNOWN); },
+	[](const Polygon& polygon) { return detail::classify_orientation(detail::turns_mt(polygon), PolygonProperties::SelfIntersecting::UNKNOWN); },
+#ifdef GPU
+	[](const Polygon& polygon) { return detail::classify_orientation(detail::turns_gpu(polygon), PolygonProperties::SelfIntersecting::UNKNOWN); },
+#endif
+	[](const Polygon& polygon) { return orientation(Batch<Polygon>({polygon}))[0]; }
+};
+
+/*!
+ * Tests that polygons that have all of their vertices on one line have no
+ * orientation.
+ */
+TEST(Orientation, Degenerate) {
+	for(size_t implementation = 0; implementation < orientation_implementations.size(); ++implementation) {
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::empty()), PolygonProperties::Orientation::UNKNOWN) << "An empty polygon has no orientation (implementation " << implementation << ").";
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::point()), PolygonProperties::Orientation::UNKNOWN) << "A point has no orientation (implementation " << implementation << ").";
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::zero_width()), PolygonProperties::Orientation::UNKNOWN) << "A polygon that goes back and forth along a line has no orientation (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the orientation of polygons that wind in one direction.
+ */
+TEST(Orientation, SingleDirection) {
+	for(size_t implementation = 0; implementation < orientation_implementations.size(); ++implementation) {
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::square_1000()), PolygonProperties::Orientation::POSITIVE) << "The square winds counter-clockwise (implementation " << implementation << ").";
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::negative_square()), PolygonProperties::Orientation::NEGATIVE) << "The negative square winds clockwise (implementation " << implementation << ").";
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::arrowhead()), PolygonProperties::Orientation::POSITIVE) << "A concave polygon that winds counter-clockwise is positive (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests the orientation of polygons with parts that wind in opposite
+ * directions.
+ */
+TEST(Orientation, Mixed) {
+	for(size_t implementation = 0; implementation < orientation_implementations.size(); ++implementation) {
+		EXPECT_EQ(orientation_implementations[implementation](PolygonTestCases::hourglass()), PolygonProperties::Orientation::MIXED) << "The halves of the hourglass wind in opposite directions (implementation " << implementation << ").";
+		const Polygon uneven_hourglass({Point2(0, 0), Point2(3000, 3000), Point2(3000, 0), Point2(0, 1000)});
+		EXPECT_EQ(orientation_implementations[implementation](uneven_hourglass), PolygonProperties::Orientation::MIXED) << "The big half winds the other way than the small half, even though the area is not zero (implementation " << implementation << ").";
+	}
+}
+
+/*!
+ * Tests that the orientation is stored in the properties of the polygon.
+ */
+TEST(Orientation, Caching) {
+	const Polygon square = PolygonTestCases::negative_square();
+	EXPECT_EQ(orientation(square), PolygonProperties::Orientation::NEGATIVE) << "The negative square winds clockwise.";
+	EXPECT_EQ(square.get_properties().orientation(), PolygonProperties::Orientation::NEGATIVE) << "The orientation must be stored.";
+	EXPECT_EQ(square.get_properties().convexity(), PolygonProperties::Convexity::CONVEX) << "The convexity was found in the same pass.";
+	EXPECT_EQ(square.get_properties().area(), -1000000) << "The area was found in the same pass.";
+
+	const Batch<Polygon> batch = {PolygonTestCases::square_1000(), PolygonTestCases::negative_square(), PolygonTestCases::hourglass()};
+	const Batch<PolygonProperties::Orientation> expected = {PolygonProperties::Orientation::POSITIVE, PolygonProperties::Orientation::NEGATIVE, PolygonProperties::Orientation::MIXED};
+	EXPECT_EQ(orientation(batch), expected) << "Each polygon in the batch must be classified.";
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		EXPECT_EQ(batch.get_properties(polygon).orientation(), expected[polygon]) << "The orientation must be stored for each polygon of the batch.";
+	}
+}
+
+}
\ No newline at end of file
@@ -6,19 +6,51 @@
  * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
  */
 
+#include <algorithm> //To sort intersection results.
+#include <functional> //To run the same test on multiple implementations.
 #include <gtest/gtest.h> //To run the test.
+#include <random> //To generate polygons with lots of intersections.
+#include <vector> //To test multiple implementations in the same test.
 
+#include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches to find self-intersections in.
 #include "../helpers/polygon_test_cases.hpp" //To load testing polygons to compute the area of.
+#include "apex/detail/polygon_properties.hpp" //To test skipping polygons with known properties.
 #include "apex/operations/self_intersections.hpp" //The unit we're testing here.
 
 namespace apex {
 
+/*!
+ * Gets the pairs of edges that were found to intersect, in a canonical order.
+ *
+ * This allows comparing the results of implementations that find the same
+ * intersections in a different order.
+ * \param intersections The self-intersections found by an implementation.
+ * \return For each self-intersection, the indices of the two edges, with the
+ * lowest index first. These pairs are sorted.
+ */
+std::vector<std::pair<size_t, size_t>> sorted_pairs(const Batch<PolygonSelfIntersection>& intersections) {
+	std::vector<std::pair<size_t, size_t>> result;
+	for(const PolygonSelfIntersection& intersection : intersections) {
+		result.emplace_back(std::min(intersection.segment_a, intersection.segment_b), std::max(intersection.segment_a, intersection.segment_b));
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
 /*!
  * Test finding self-intersections on an empty polygon.
  */
 TEST(PolygonSelfIntersections, Empty) {
 	const Batch<PolygonSelfIntersection> ground_truth; //No self-intersections, empty batch.
 	EXPECT_EQ(self_intersections(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::empty()), ground_truth) << "There should be no self-intersections in the empty polygon.";
+#endif
 }
 
 /*!
@@ -27,6 +59,14 @@ TEST(PolygonSelfIntersections, Empty) {
 TEST(PolygonSelfIntersections, Point) {
 	const Batch<PolygonSelfIntersection> ground_truth; //No self-intersections, empty batch.
 	EXPECT_EQ(self_intersections(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::point()), ground_truth) << "With only 1 vertex, there are no edges that can intersect.";
+#endif
 }
 
 /*!
@@ -37,9 +77,21 @@ TEST(PolygonSelfIntersections, Point) {
  */
 TEST(PolygonSelfIntersections, Line) {
 	const Polygon polygon = PolygonTestCases::line();
-	const Batch<PolygonSelfIntersection> result = self_intersections(polygon);
-	ASSERT_EQ(result.size(), 1) << "The polygon is closed, so it has two line segments. They exactly overlap, so that's an intersection.";
-	EXPECT_TRUE(LineSegment(polygon[0], polygon[1]).intersects(result[0].location)) << "The intersecting point must be somewhere on the line segment.";
+	std::vector<Batch<PolygonSelfIntersection>> results = {
+		self_intersections(polygon),
+		detail::self_intersections_st_naive(polygon),
+		detail::self_intersections_mt_naive(polygon),
+		detail::self_intersections_st_sweep(polygon),
+		detail::self_intersections_mt_sweep(polygon),
+		detail::self_intersections_mt_grid(polygon)
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu_naive(polygon));
+#endif
+	for(const Batch<PolygonSelfIntersection>& result : results) {
+		ASSERT_EQ(result.size(), 1) << "The polygon is closed, so it has two line segments. They exactly overlap, so that's an intersection.";
+		EXPECT_TRUE(LineSegment(polygon[0], polygon[1]).intersects(result[0].location)) << "The intersecting point must be somewhere on the line segment.";
+	}
 }
 
 /*!
@@ -49,6 +101,14 @@ TEST(PolygonSelfIntersections, Line) {
 TEST(PolygonSelfIntersections, Square) {
 	const Batch<PolygonSelfIntersection> ground_truth; //No self-intersections, empty batch.
 	EXPECT_EQ(self_intersections(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::square_1000()), ground_truth) << "This square has no self-intersections.";
+#endif
 }
 
 /*!
@@ -58,6 +118,14 @@ TEST(PolygonSelfIntersections, Square) {
 TEST(PolygonSelfIntersections, Concave) {
 	const Batch<PolygonSelfIntersection> ground_truth; //No self-intersections, empty batch.
 	EXPECT_EQ(self_intersections(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::arrowhead()), ground_truth) << "This shape has no self-intersections.";
+#endif
 }
 
 /*!
@@ -67,6 +135,47 @@ TEST(PolygonSelfIntersections, Concave) {
 TEST(PolygonSelfIntersections, SimpleSelfIntersection) {
 	const Batch<PolygonSelfIntersection> ground_truth = {PolygonSelfIntersection(Point2(500, 500), 0, 2)};
 	EXPECT_EQ(self_intersections(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::hourglass()), ground_truth) << "The 0th segment intersects with the 2nd segment, in the middle at position 500,500.";
+#endif
+}
+
+/*!
+ * Test that polygons that are known not to intersect themselves are not
+ * checked again.
+ *
+ * To be able to observe this, the test lies about the properties of a polygon
+ * that does intersect itself.
+ */
+TEST(PolygonSelfIntersections, KnownProperties) {
+	const Polygon hourglass = PolygonTestCases::hourglass();
+	hourglass.set_properties(PolygonProperties(static_cast<unsigned int>(PolygonProperties::SelfIntersecting::NO)));
+	EXPECT_TRUE(self_intersections(hourglass).empty()) << "The polygon is known not to intersect itself, so it must not be checked.";
+	hourglass.set_properties(PolygonProperties(static_cast<unsigned int>(PolygonProperties::Convexity::CONVEX)));
+	EXPECT_TRUE(self_intersections(hourglass).empty()) << "Convex polygons can't intersect themselves, so it must not be checked.";
+	hourglass.set_properties(PolygonProperties());
+	EXPECT_EQ(self_intersections(hourglass).size(), 1) << "Nothing is known about the polygon any more, so it must be checked again.";
+}
+
+/*!
+ * Test that not finding any self-intersections is recorded in the properties of
+ * the polygon.
+ */
+TEST(PolygonSelfIntersections, RecordProperties) {
+	const Polygon square = PolygonTestCases::square_1000();
+	square.area(); //Once it is known not to intersect itself, the area reveals the orientation.
+	ASSERT_TRUE(self_intersections(square).empty()) << "The square doesn't intersect itself.";
+	EXPECT_EQ(square.get_properties().self_intersecting(), PolygonProperties::SelfIntersecting::NO) << "No self-intersections were found, so that is now known about the square.";
+	EXPECT_EQ(square.get_properties().orientation(), PolygonProperties::Orientation::POSITIVE) << "The square doesn't intersect itself and has a positive area, so it must be positive.";
+
+	const Polygon hourglass = PolygonTestCases::hourglass();
+	ASSERT_FALSE(self_intersections(hourglass).empty()) << "The hourglass intersects itself.";
+	EXPECT_EQ(hourglass.get_properties().self_intersecting(), PolygonProperties::SelfIntersecting::UNKNOWN) << "Self-intersections were found, but they may be edge cases, so that is not recorded.";
 }
 
 /*!
@@ -80,6 +189,43 @@ TEST(PolygonSelfIntersections, SimpleSelfIntersection) {
 TEST(PolygonSelfIntersections, ZeroLengthSegments) {
 	const Batch<PolygonSelfIntersection> ground_truth;
 	EXPECT_EQ(self_intersections(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+	EXPECT_EQ(detail::self_intersections_st_naive(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+	EXPECT_EQ(detail::self_intersections_mt_naive(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+#ifdef GPU
+	EXPECT_EQ(detail::self_intersections_gpu_naive(PolygonTestCases::zero_length_segments()), ground_truth) << "Zero-length line segments are not counted in the self-intersection.";
+#endif
+}
+
+/*!
+ * Test finding a self-intersection in a polygon that repeats one of its
+ * vertices halfway along the contour.
+ *
+ * The repeated vertex makes a zero-length segment, which must be ignored, but
+ * it may not cause the other segments to be ignored too.
+ */
+TEST(PolygonSelfIntersections, RepeatedVertex) {
+	const Polygon polygon = {Point2(0, 0), Point2(1000, 1000), Point2(1000, 1000), Point2(0, 1000), Point2(1000, 0)}; //The hourglass, with its second vertex repeated.
+	const std::vector<std::pair<size_t, size_t>> ground_truth = {{0, 3}};
+	std::vector<Batch<PolygonSelfIntersection>> results = {
+		self_intersections(polygon),
+		detail::self_intersections_st_naive(polygon),
+		detail::self_intersections_mt_naive(polygon),
+		detail::self_intersections_st_sweep(polygon),
+		detail::self_intersections_mt_sweep(polygon),
+		detail::self_intersections_mt_grid(polygon)
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu_naive(polygon));
+#endif
+	for(const Batch<PolygonSelfIntersection>& result : results) {
+		EXPECT_EQ(sorted_pairs(result), ground_truth) << "The diagonals still cross each other, even though one of the vertices is repeated.";
+		for(const PolygonSelfIntersection& intersection : result) {
+			EXPECT_EQ(intersection.location, Point2(500, 500)) << "The diagonals cross in the middle.";
+		}
+	}
 }
 
 /*!
@@ -91,10 +237,22 @@ TEST(PolygonSelfIntersections, GrazingVertex) {
 		PolygonSelfIntersection(Point2(500, 0), 0, 2),
 		PolygonSelfIntersection(Point2(500, 0), 0, 3)
 	};
-	const Batch<PolygonSelfIntersection> result = self_intersections(PolygonTestCases::touching_edge());
-	ASSERT_EQ(ground_truth.size(), result.size()) << "A vertex touches an edge, so both edges incident to that vertex will be reported as intersecting.";
-	for(const PolygonSelfIntersection& intersection : result) {
-		EXPECT_EQ(std::count(ground_truth.begin(), ground_truth.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+	std::vector<Batch<PolygonSelfIntersection>> results = {
+		self_intersections(PolygonTestCases::touching_edge()),
+		detail::self_intersections_st_naive(PolygonTestCases::touching_edge()),
+		detail::self_intersections_mt_naive(PolygonTestCases::touching_edge()),
+		detail::self_intersections_st_sweep(PolygonTestCases::touching_edge()),
+		detail::self_intersections_mt_sweep(PolygonTestCases::touching_edge()),
+		detail::self_intersections_mt_grid(PolygonTestCases::touching_edge())
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu_naive(PolygonTestCases::touching_edge()));
+#endif
+	for(const Batch<PolygonSelfIntersection>& result : results) {
+		ASSERT_EQ(ground_truth.size(), result.size()) << "A vertex touches an edge, so both edges incident to that vertex will be reported as intersecting.";
+		for(const PolygonSelfIntersection& intersection : result) {
+			EXPECT_EQ(std::count(ground_truth.begin(), ground_truth.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+		}
 	}
 }
 
@@ -112,10 +270,22 @@ TEST(PolygonSelfIntersections, TouchingVertex) {
 		PolygonSelfIntersection(Point2(1000, 500), 1, 3),
 		PolygonSelfIntersection(Point2(1000, 500), 1, 4)
 	};
-	const Batch<PolygonSelfIntersection> result = self_intersections(PolygonTestCases::touching_vertex());
-	ASSERT_EQ(ground_truth.size(), result.size()) << "Two vertices touch each other, and it's not just zero-length segments. Every non-adjacent pair of edges must be reported as intersecting.";
-	for(const PolygonSelfIntersection& intersection : result) {
-		EXPECT_EQ(std::count(ground_truth.begin(), ground_truth.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+	std::vector<Batch<PolygonSelfIntersection>> results = {
+		self_intersections(PolygonTestCases::touching_vertex()),
+		detail::self_intersections_st_naive(PolygonTestCases::touching_vertex()),
+		detail::self_intersections_mt_naive(PolygonTestCases::touching_vertex()),
+		detail::self_intersections_st_sweep(PolygonTestCases::touching_vertex()),
+		detail::self_intersections_mt_sweep(PolygonTestCases::touching_vertex()),
+		detail::self_intersections_mt_grid(PolygonTestCases::touching_vertex())
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu_naive(PolygonTestCases::touching_vertex()));
+#endif
+	for(const Batch<PolygonSelfIntersection>& result : results) {
+		ASSERT_EQ(ground_truth.size(), result.size()) << "Two vertices touch each other, and it's not just zero-length segments. Every non-adjacent pair of edges must be reported as intersecting.";
+		for(const PolygonSelfIntersection& intersection : result) {
+			EXPECT_EQ(std::count(ground_truth.begin(), ground_truth.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+		}
 	}
 }
 
@@ -149,30 +319,256 @@ TEST(PolygonSelfIntersections, OverlappingSegments) {
 	 - 5 with 9
 	*/
 	const Polygon polygon = PolygonTestCases::zero_width_connection();
-	const Batch<PolygonSelfIntersection> result = self_intersections(polygon);
-	ASSERT_EQ(ground_truth_points.size() + 6, result.size()) << "The result must include all of the intersecting points, plus 6 overlapping segments.";
-	for(const PolygonSelfIntersection& intersection : ground_truth_points) {
-		EXPECT_EQ(std::count(ground_truth_points.begin(), ground_truth_points.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+	std::vector<Batch<PolygonSelfIntersection>> results = {
+		self_intersections(polygon),
+		detail::self_intersections_st_naive(polygon),
+		detail::self_intersections_mt_naive(polygon),
+		detail::self_intersections_st_sweep(polygon),
+		detail::self_intersections_mt_sweep(polygon),
+		detail::self_intersections_mt_grid(polygon)
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu_naive(polygon));
+#endif
+	for(const Batch<PolygonSelfIntersection>& result : results) {
+		ASSERT_EQ(ground_truth_points.size() + 6, result.size()) << "The result must include all of the intersecting points, plus 6 overlapping segments.";
+		for(const PolygonSelfIntersection& intersection : ground_truth_points) {
+			EXPECT_EQ(std::count(ground_truth_points.begin(), ground_truth_points.end(), intersection), std::count(result.begin(), result.end(), intersection)) << "The intersection must be reported the correct number of times.";
+		}
+		//Check for the overlapping segments being reported.
+		for(const PolygonSelfIntersection& intersection : result) {
+			if((intersection.segment_a == 1 && intersection.segment_b == 13) || (intersection.segment_a == 13 && intersection.segment_b == 1)) {
+				EXPECT_TRUE(LineSegment(polygon[1], polygon[2]).intersects(intersection.location)) << "Segment 1 overlaps with segment 13.";
+			}
+			if((intersection.segment_a == 2 && intersection.segment_b == 12) || (intersection.segment_a == 12 && intersection.segment_b == 2)) {
+				EXPECT_TRUE(LineSegment(polygon[2], polygon[3]).intersects(intersection.location)) << "Segment 2 overlaps with segment 12.";
+			}
+			if((intersection.segment_a == 3 && intersection.segment_b == 11) || (intersection.segment_a == 11 && intersection.segment_b == 3)) {
+				EXPECT_TRUE(LineSegment(polygon[3], polygon[4]).intersects(intersection.location)) << "Segment 3 overlaps with part of segment 11.";
+			}
+			if((intersection.segment_a == 4 && intersection.segment_b == 11) || (intersection.segment_a == 11 && intersection.segment_b == 4)) {
+				EXPECT_TRUE(LineSegment(polygon[4], polygon[11]).intersects(intersection.location)) << "Part of segment 4 overlaps with part of segment 11.";
+			}
+			if((intersection.segment_a == 4 && intersection.segment_b == 10) || (intersection.segment_a == 10 && intersection.segment_b == 4)) {
+				EXPECT_TRUE(LineSegment(polygon[11], polygon[10]).intersects(intersection.location)) << "Part of segment 4 intersects with segment 10.";
+			}
+			if((intersection.segment_a == 5 && intersection.segment_b == 9) || (intersection.segment_a == 9 && intersection.segment_b == 5)) {
+				EXPECT_TRUE(LineSegment(polygon[5], polygon[9]).intersects(intersection.location)) << "Segment 5 overlaps with segment 9.";
+			}
+		}
 	}
-	//Check for the overlapping segments being reported.
-	for(const PolygonSelfIntersection& intersection : result) {
-		if((intersection.segment_a == 1 && intersection.segment_b == 13) || (intersection.segment_a == 13 && intersection.segment_b == 1)) {
-			EXPECT_TRUE(LineSegment(polygon[1], polygon[2]).intersects(intersection.location)) << "Segment 1 overlaps with segment 13.";
+}
+
+
+/*!
+ * Test whether the implementations that skip pairs of edges find the same
+ * self-intersections as the naive implementation, on a polygon with lots of
+ * self-intersections.
+ *
+ * The vertices of this polygon are placed randomly in a small area. This causes
+ * many proper intersections, but also many edge cases where vertices touch
+ * edges or edges overlap.
+ */
+TEST(PolygonSelfIntersections, BroadPhaseMatchesNaive) {
+	for(const coord_t range : {10, 1000}) {
+		std::mt19937 randomiser(42); //Fixed seed to make the test deterministic.
+		std::uniform_int_distribution<coord_t> coordinate(0, range);
+		Polygon polygon;
+		while(polygon.size() < 300) {
+			const Point2 vertex(coordinate(randomiser), coordinate(randomiser));
+			if(polygon.empty() || (vertex != polygon.back() && vertex != polygon.front())) { //Zero-length edges are tested separately.
+				polygon.push_back(vertex);
+			}
 		}
-		if((intersection.segment_a == 2 && intersection.segment_b == 12) || (intersection.segment_a == 12 && intersection.segment_b == 2)) {
-			EXPECT_TRUE(LineSegment(polygon[2], polygon[3]).intersects(intersection.location)) << "Segment 2 overlaps with segment 12.";
+
+		const std::vector<std::pair<size_t, size_t>> ground_truth = sorted_pairs(detail::self_intersections_st_naive(polygon));
+		EXPECT_EQ(sorted_pairs(detail::self_intersections_st_sweep(polygon)), ground_truth) << "The sweep line must find the same intersecting pairs of edges as comparing all pairs.";
+		EXPECT_EQ(sorted_pairs(detail::self_intersections_mt_sweep(polygon)), ground_truth) << "The sweep line must find the same intersecting pairs of edges as comparing all pairs.";
+		EXPECT_EQ(sorted_pairs(detail::self_intersections_mt_grid(polygon)), ground_truth) << "The grid must find the same intersecting pairs of edges as comparing all pairs.";
+	}
+}
+
+/*!
+ * Test finding self-intersections in a polygon with a lot of vertices, but no
+ * self-intersections.
+ *
+ * This is the use case where the sweep line and grid implementations should be
+ * much faster than the naive implementations, so only those implementations are
+ * tested.
+ */
+TEST(PolygonSelfIntersections, Circle) {
+	const Polygon circle = PolygonTestCases::circle();
+	const Batch<PolygonSelfIntersection> ground_truth; //No self-intersections, empty batch.
+	EXPECT_EQ(self_intersections(circle), ground_truth) << "The circle has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_st_sweep(circle), ground_truth) << "The circle has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_sweep(circle), ground_truth) << "The circle has no self-intersections.";
+	EXPECT_EQ(detail::self_intersections_mt_grid(circle), ground_truth) << "The circle has no self-intersections.";
+}
+
+/*!
+ * Test that the multi-threaded implementations produce their results in a
+ * deterministic order, sorted by the indices of the edges involved.
+ */
+TEST(PolygonSelfIntersections, MultiThreadedDeterministic) {
+	std::mt19937 randomiser(1337); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> coordinate(0, 1000);
+	Polygon polygon;
+	for(size_t vertex = 0; vertex < 500; ++vertex) {
+		polygon.emplace_back(coordinate(randomiser), coordinate(randomiser));
+	}
+
+	for(const std::function<Batch<PolygonSelfIntersection>(const Polygon&)>& implementation : std::vector<std::function<Batch<PolygonSelfIntersection>(const Polygon&)>>{detail::self_intersections_mt_naive<Polygon>, detail::self_intersections_mt_grid<Polygon>}) {
+		const Batch<PolygonSelfIntersection> result = implementation(polygon);
+		ASSERT_FALSE(result.empty()) << "This random polygon should have lots of self-intersections.";
+		for(size_t i = 1; i < result.size(); ++i) {
+			EXPECT_TRUE(result[i - 1].segment_a < result[i].segment_a || (result[i - 1].segment_a == result[i].segment_a && result[i - 1].segment_b < result[i].segment_b)) << "The self-intersections must be sorted by the indices of their edges.";
+		}
+		const Batch<PolygonSelfIntersection> second_result = implementation(polygon);
+		ASSERT_EQ(result.size(), second_result.size()) << "Running it again must find the same number of self-intersections.";
+		for(size_t i = 0; i < result.size(); ++i) {
+			EXPECT_EQ(result[i].segment_a, second_result[i].segment_a) << "Running it again must give the results in the same order.";
+			EXPECT_EQ(result[i].segment_b, second_result[i].segment_b) << "Running it again must give the results in the same order.";
+			EXPECT_EQ(result[i].location, second_result[i].location) << "Running it again must give the same intersection points.";
 		}
-		if((intersection.segment_a == 3 && intersection.segment_b == 11) || (intersection.segment_a == 11 && intersection.segment_b == 3)) {
-			EXPECT_TRUE(LineSegment(polygon[3], polygon[4]).intersects(intersection.location)) << "Segment 3 overlaps with part of segment 11.";
+	}
+}
+
+/*!
+ * Checks that each implementation of the batch version finds the same
+ * self-intersections in each polygon as the single polygon version.
+ * \param batch The batch of polygons to find self-intersections in.
+ */
+void check_batch_matches_single(const Batch<Polygon>& batch) {
+	std::vector<Batch<Batch<PolygonSelfIntersection>>> results = {
+		self_intersections(batch),
+		detail::self_intersections_st(batch),
+		detail::self_intersections_mt(batch)
+	};
+#ifdef GPU
+	results.push_back(detail::self_intersections_gpu(batch));
+#endif //GPU
+	for(const Batch<Batch<PolygonSelfIntersection>>& result : results) {
+		ASSERT_EQ(result.size(), batch.size()) << "There must be a result for every polygon in the batch.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			const Batch<PolygonSelfIntersection> ground_truth = detail::self_intersections_st_naive(batch[polygon]);
+			EXPECT_EQ(sorted_pairs(result[polygon]), sorted_pairs(ground_truth)) << "The self-intersections of each polygon must be the same as when finding them for that polygon alone.";
 		}
-		if((intersection.segment_a == 4 && intersection.segment_b == 11) || (intersection.segment_a == 11 && intersection.segment_b == 4)) {
-			EXPECT_TRUE(LineSegment(polygon[4], polygon[11]).intersects(intersection.location)) << "Part of segment 4 overlaps with part of segment 11.";
+	}
+}
+
+/*!
+ * Test finding self-intersections in an empty batch.
+ */
+TEST(PolygonBatchSelfIntersections, Empty) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::empty();
+	EXPECT_TRUE(self_intersections(batch).empty()) << "An empty batch has no polygons to produce results for.";
+	check_batch_matches_single(batch);
+}
+
+/*!
+ * Test finding self-intersections in batches with a single degenerate polygon.
+ */
+TEST(PolygonBatchSelfIntersections, SingleDegenerate) {
+	check_batch_matches_single(PolygonBatchTestCases::single_empty());
+	check_batch_matches_single(PolygonBatchTestCases::single_point());
+
+	const Batch<Polygon> line = PolygonBatchTestCases::single_line();
+	const Batch<Batch<PolygonSelfIntersection>> result = self_intersections(line);
+	ASSERT_EQ(result.size(), 1) << "There is one polygon in the batch.";
+	EXPECT_EQ(result[0].size(), 1) << "The two segments of the line overlap each other completely.";
+	check_batch_matches_single(line);
+}
+
+/*!
+ * Test finding self-intersections in batches of simple polygons.
+ */
+TEST(PolygonBatchSelfIntersections, Simple) {
+	check_batch_matches_single(PolygonBatchTestCases::single_square());
+	check_batch_matches_single(PolygonBatchTestCases::square_triangle());
+	check_batch_matches_single(PolygonBatchTestCases::square_triangle_square());
+
+	const Batch<Batch<PolygonSelfIntersection>> result = self_intersections(PolygonBatchTestCases::two_squares());
+	ASSERT_EQ(result.size(), 2) << "There are two polygons in the batch.";
+	EXPECT_TRUE(result[0].empty()) << "The squares overlap each other, but that doesn't count as a self-intersection.";
+	EXPECT_TRUE(result[1].empty()) << "The squares overlap each other, but that doesn't count as a self-intersection.";
+}
+
+/*!
+ * Test that the results of finding self-intersections in a batch are recorded
+ * in the properties of each polygon.
+ */
+TEST(PolygonBatchSelfIntersections, RecordProperties) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::edge_cases();
+	const Batch<Batch<PolygonSelfIntersection>> result = self_intersections(batch);
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		const PolygonProperties::SelfIntersecting ground_truth = result[polygon].empty() ? PolygonProperties::SelfIntersecting::NO : PolygonProperties::SelfIntersecting::UNKNOWN;
+		EXPECT_EQ(batch.get_properties(polygon).self_intersecting(), ground_truth) << "Only polygons without self-intersections are recorded to be so.";
+	}
+	EXPECT_EQ(self_intersections(batch), result) << "Finding the self-intersections again, with the recorded properties, must give the same results.";
+}
+
+/*!
+ * Test finding self-intersections in a batch with various edge cases.
+ */
+TEST(PolygonBatchSelfIntersections, EdgeCases) {
+	check_batch_matches_single(PolygonBatchTestCases::edge_cases());
+}
+
+/*!
+ * Test finding self-intersections in a batch of random polygons of various
+ * sizes, so that different strategies are used for different polygons.
+ */
+TEST(PolygonBatchSelfIntersections, RandomPolygons) {
+	std::mt19937 randomiser(31415); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> coordinate(0, 1000);
+	Batch<Polygon> batch;
+	for(const size_t size : {3, 10, 0, 100, 5, 250, 1}) {
+		Polygon polygon;
+		while(polygon.size() < size) {
+			const Point2 vertex(coordinate(randomiser), coordinate(randomiser));
+			if(polygon.empty() || (vertex != polygon.back() && vertex != polygon.front())) { //Zero-length edges are tested separately.
+				polygon.push_back(vertex);
+			}
 		}
-		if((intersection.segment_a == 4 && intersection.segment_b == 10) || (intersection.segment_a == 10 && intersection.segment_b == 4)) {
-			EXPECT_TRUE(LineSegment(polygon[11], polygon[10]).intersects(intersection.location)) << "Part of segment 4 intersects with segment 10.";
+		batch.push_back(polygon);
+	}
+	check_batch_matches_single(batch);
+}
+
+/*!
+ * Test that the result of the batch version doesn't depend on which version
+ * handled each polygon.
+ *
+ * The random vertices are chosen on a coarse grid, so that many intersections
+ * lie exactly halfway between two coordinates, and need to be rounded the same
+ * way by each version.
+ */
+TEST(PolygonBatchSelfIntersections, IndependentOfVersion) {
+	std::mt19937 randomiser(2718); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> coordinate(0, 10);
+	Batch<Polygon> batch;
+	for(const size_t size : {10, 100, 250}) {
+		Polygon polygon;
+		for(size_t vertex = 0; vertex < size; ++vertex) {
+			polygon.emplace_back(coordinate(randomiser) * 3, coordinate(randomiser) * 3);
 		}
-		if((intersection.segment_a == 5 && intersection.segment_b == 9) || (intersection.segment_a == 9 && intersection.segment_b == 5)) {
-			EXPECT_TRUE(LineSegment(polygon[5], polygon[9]).intersects(intersection.location)) << "Segment 5 overlaps with segment 9.";
+		batch.push_back(polygon);
+	}
+
+	const detail::Crossovers original = detail::Strategies::get_crossovers(detail::Operation::self_intersections);
+	detail::Strategies::set_crossovers(detail::Operation::self_intersections, {detail::no_crossover, detail::no_crossover, detail::no_crossover}); //Only the naive version.
+	const Batch<Batch<PolygonSelfIntersection>> naive = detail::self_intersections_st(batch);
+	detail::Strategies::set_crossovers(detail::Operation::self_intersections, {0, detail::no_crossover, detail::no_crossover}); //Only the sweep line.
+	const Batch<Batch<PolygonSelfIntersection>> sweep = detail::self_intersections_mt(batch);
+	detail::Strategies::set_crossovers(detail::Operation::self_intersections, original);
+
+	ASSERT_EQ(naive.size(), sweep.size()) << "There must be a result for every polygon in the batch.";
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		ASSERT_EQ(naive[polygon].size(), sweep[polygon].size()) << "Both versions must find the same number of self-intersections.";
+		for(size_t i = 0; i < naive[polygon].size(); ++i) {
+			EXPECT_EQ(naive[polygon][i].segment_a, sweep[polygon][i].segment_a) << "Both versions must report the edges in the same order.";
+			EXPECT_EQ(naive[polygon][i].segment_b, sweep[polygon][i].segment_b) << "Both versions must report the edges in the same order.";
+			EXPECT_EQ(naive[polygon][i].location, sweep[polygon][i].location) << "Both versions must round the intersections the same way.";
 		}
 	}
 }
@@ -0,0 +1,201 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <functional> //To run the same test on multiple implementations.
+#include <gtest/gtest.h> //To run the test.
+#include <vector> //To run the same test on multiple implementations.
+
+#include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches of polygons to transform.
+#include "../helpers/polygon_test_cases.hpp" //To load testing polygons to transform.
+#include "apex/affine_transform.hpp" //To provide the transformations to perform.
+#include "apex/operations/area.hpp" //To test chaining operations on the GPU.
+#include "apex/operations/transform.hpp" //The function under test.
+#include "apex/soa_polygon.hpp" //To test transforming polygons stored as structures of arrays.
+
+namespace apex {
+
+class TransformByMatrix : public testing::TestWithParam<AffineTransform> {};
+
+INSTANTIATE_TEST_SUITE_P(TransformInputs, TransformByMatrix, testing::Values(
+	AffineTransform(),
+	AffineTransform::scaling(3, -2),
+	AffineTransform::rotation(0.4),
+	AffineTransform::rotation(1.2).then(AffineTransform::translation(Point2(-40, 70))).then(AffineTransform::scaling(0.75))
+));
+
+/*!
+ * Test transforming a polygon.
+ *
+ * Each vertex must be transformed the same way as transforming the vertex by
+ * itself.
+ */
+TEST_P(TransformByMatrix, PolygonTransform) {
+	const Polygon original = PolygonTestCases::circle(); //Many vertices, to exercise the vectorised loops.
+	const AffineTransform transformation = GetParam();
+
+	std::vector<std::function<void(Polygon&, const AffineTransform&)>> implementations = {
+		[](Polygon& polygon, const AffineTransform& transformation) { transform(polygon, transformation); },
+		[](Polygon& polygon, const AffineTransform& transformation) { detail::transform_st(polygon, transformation); },
+		[](Polygon& polygon, const AffineTransform& transformation) { detail::transform_mt(polygon, transformation); },
+		[](Polygon& polygon, const AffineTransform& transformation) { polygon.transform(transformation); }
+	};
+#ifdef GPU
+	implementations.push_back([](Polygon& polygon, const AffineTransform& transformation) { detail::transform_gpu(polygon, transformation); });
+#endif
+	for(const std::function<void(Polygon&, const AffineTransform&)>& implementation : implementations) {
+		Polygon polygon(original);
+		implementation(polygon, transformation);
+		ASSERT_EQ(polygon.size(), original.size()) << "The polygon may not gain or lose any vertices by transforming it.";
+		for(size_t i = 0; i < polygon.size(); ++i) {
+			EXPECT_EQ(polygon[i], transformation.apply(original[i]));
+		}
+	}
+}
+
+/*!
+ * Test transforming a batch of polygons with gaps in its vertex buffer.
+ *
+ * The implementations that transform the whole vertex buffer at once also
+ * transform the vertices in the gaps. That must not affect the polygons in the
+ * batch.
+ */
+TEST_P(TransformByMatrix, PolygonBatchTransform) {
+	Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	original[0].emplace_back(50, 50); //Growing the first polygon moves it to the end of the buffer, leaving a gap.
+	const AffineTransform transformation = GetParam();
+
+	std::vector<std::function<void(Batch<Polygon>&, const AffineTransform&)>> implementations = {
+		[](Batch<Polygon>& batch, const AffineTransform& transformation) { transform(batch, transformation); },
+		[](Batch<Polygon>& batch, const AffineTransform& transformation) { detail::transform_st(batch, transformation); },
+		[](Batch<Polygon>& batch, const AffineTransform& transformation) { detail::transform_mt(batch, transformation); },
+		[](Batch<Polygon>& batch, const AffineTransform& transformation) { batch.transform(transformation); }
+	};
+#ifdef GPU
+	implementations.push_back([](Batch<Polygon>& batch, const AffineTransform& transformation) { detail::transform_gpu(batch, transformation); });
+#endif
+	for(const std::function<void(Batch<Polygon>&, const AffineTransform&)>& implementation : implementations) {
+		Batch<Polygon> batch(original);
+		implementation(batch, transformation);
+		ASSERT_EQ(batch.size(), original.size()) << "The number of polygons must remain the same.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			ASSERT_EQ(batch[polygon].size(), original[polygon].size()) << "The number of vertices in each polygon must remain the same.";
+			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+				EXPECT_EQ(batch[polygon][vertex], transformation.apply(original[polygon][vertex]));
+			}
+		}
+	}
+}
+
+/*!
+ * Test transforming a polygon that stores its vertices as a structure of
+ * arrays.
+ */
+TEST_P(TransformByMatrix, SoAPolygonTransform) {
+	const Polygon original = PolygonTestCases::circle();
+	const AffineTransform transformation = GetParam();
+
+	std::vector<std::function<void(SoAPolygon&, const AffineTransform&)>> implementations = {
+		[](SoAPolygon& polygon, const AffineTransform& transformation) { transform(polygon, transformation); },
+		[](SoAPolygon& polygon, const AffineTransform& transformation) { detail::transform_st(polygon, transformation); },
+		[](SoAPolygon& polygon, const AffineTransform& transformation) { detail::transform_mt(polygon, transformation); }
+	};
+#ifdef GPU
+	implementations.push_back([](SoAPolygon& polygon, const AffineTransform& transformation) { detail::transform_gpu(polygon, transformation); });
+#endif
+	for(const std::function<void(SoAPolygon&, const AffineTransform&)>& implementation : implementations) {
+		SoAPolygon polygon(original);
+		implementation(polygon, transformation);
+		ASSERT_EQ(polygon.size(), original.size()) << "The polygon may not gain or lose any vertices by transforming it.";
+		for(size_t i = 0; i < polygon.size(); ++i) {
+			EXPECT_EQ(polygon[i], transformation.apply(original[i]));
+		}
+	}
+}
+
+/*!
+ * Test transforming a batch of polygons that stores its vertices as a structure
+ * of arrays.
+ */
+TEST_P(TransformByMatrix, SoAPolygonBatchTransform) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases(); //Includes empty polygons, which must not disturb the other polygons.
+	const AffineTransform transformation = GetParam();
+
+	std::vector<std::function<void(Batch<SoAPolygon>&, const AffineTransform&)>> implementations = {
+		[](Batch<SoAPolygon>& batch, const AffineTransform& transformation) { transform(batch, transformation); },
+		[](Batch<SoAPolygon>& batch, const AffineTransform& transformation) { detail::transform_st(batch, transformation); },
+		[](Batch<SoAPolygon>& batch, const AffineTransform& transformation) { detail::transform_mt(batch, transformation); }
+	};
+#ifdef GPU
+	implementations.push_back([](Batch<SoAPolygon>& batch, const AffineTransform& transformation) { detail::transform_gpu(batch, transformation); });
+#endif
+	for(const std::function<void(Batch<SoAPolygon>&, const AffineTransform&)>& implementation : implementations) {
+		Batch<SoAPolygon> batch(original);
+		implementation(batch, transformation);
+		ASSERT_EQ(batch.size(), original.size()) << "The number of polygons must remain the same.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			ASSERT_EQ(batch[polygon].size(), original[polygon].size()) << "The number of vertices in each polygon must remain the same.";
+			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+				EXPECT_EQ(batch[polygon][vertex], transformation.apply(original[polygon][vertex]));
+			}
+		}
+	}
+}
+
+/*!
+ * Test transforming an empty polygon and an empty batch.
+ *
+ * Since they stay empty, nothing should happen. But it shouldn't crash.
+ */
+TEST(PolygonTransform, TransformEmpty) {
+	const AffineTransform transformation = AffineTransform::rotation(1);
+	Polygon empty = PolygonTestCases::empty();
+	Batch<Polygon> empty_batch = PolygonBatchTestCases::empty();
+
+	transform(empty, transformation);
+	detail::transform_st(empty, transformation);
+	detail::transform_mt(empty, transformation);
+	transform(empty_batch, transformation);
+	detail::transform_st(empty_batch, transformation);
+	detail::transform_mt(empty_batch, transformation);
+#ifdef GPU
+	detail::transform_gpu(empty, transformation);
+	detail::transform_gpu(empty_batch, transformation);
+#endif
+	EXPECT_TRUE(empty.empty()) << "After transforming it, the polygon is still empty.";
+	EXPECT_TRUE(empty_batch.empty()) << "After transforming it, the batch is still empty.";
+}
+
+/*!
+ * Test that mirroring a polygon reverses its orientation, which shows in the
+ * sign of its area.
+ */
+TEST(PolygonTransform, MirrorArea) {
+	Polygon square = PolygonTestCases::square_1000();
+	const area_t original_area = square.area();
+	square.transform(AffineTransform::scaling(-1, 1));
+	EXPECT_EQ(square.area(), -original_area) << "Mirroring the polygon reverses its orientation, so the area becomes negative.";
+	square.transform(AffineTransform::scaling(2, 3));
+	EXPECT_EQ(square.area(), -original_area * 6) << "Scaling multiplies the area with the determinant.";
+}
+
+#ifdef GPU
+/*!
+ * Test chaining a transformation and another operation on the GPU.
+ *
+ * The vertices may stay on the GPU in between the operations, but the results
+ * must be the same as if they were transferred every time.
+ */
+TEST(PolygonTransform, ChainOnGPU) {
+	Polygon square = PolygonTestCases::square_1000();
+	detail::transform_gpu(square, AffineTransform::scaling(2));
+	EXPECT_EQ(detail::area_gpu(square), 4 * 1000 * 1000) << "The area must be computed on the transformed vertices.";
+	EXPECT_EQ(square[2], Point2(2000, 2000)) << "Accessing the vertices on the host must transfer the result back.";
+}
+#endif
+
+}
\ No newline at end of file
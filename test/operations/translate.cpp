@@ -6,12 +6,17 @@
  * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
  */
 
+#include <functional> //To run the same test on multiple implementations.
 #include <gtest/gtest.h> //To run the test.
+#include <vector> //To run the same test on multiple implementations.
 
 #include "../helpers/polygon_batch_test_cases.hpp" //To load testing batches of polygons to translate.
 #include "../helpers/polygon_test_cases.hpp" //To load testing polygons to translate.
+#include "apex/fixed_polygon.hpp" //To test translating polygons with a fixed number of vertices.
+#include "apex/operations/area.hpp" //To test chaining operations on the GPU.
 #include "apex/operations/translate.hpp" //The function under test.
 #include "apex/point2.hpp" //To provide the delta vector to translate by.
+#include "apex/soa_polygon.hpp" //To test translating polygons stored as structures of arrays.
 
 namespace apex {
 
@@ -201,4 +206,261 @@ TEST(PolygonBatchTranslate, MoveEmpty) {
 #endif
 }
 
+/*!
+ * Test moving a batch of polygons with gaps in its vertex buffer.
+ *
+ * The implementations that move the whole vertex buffer at once also move the
+ * vertices in the gaps. That must not affect the polygons in the batch.
+ */
+TEST(PolygonBatchTranslate, MoveWithGaps) {
+	Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	original[0].emplace_back(50, 50); //Growing the first polygon moves it to the end of the buffer, leaving a gap.
+	ASSERT_GT(original.size_subelements(), original[0].size() + original[1].size() + original[2].size()) << "The vertex buffer must have a gap for this test to be meaningful.";
+	const Point2 move_vector(-40, 70);
+
+	std::vector<std::function<void(Batch<Polygon>&, const Point2&)>> implementations = {
+		[](Batch<Polygon>& batch, const Point2& delta) { translate(batch, delta); },
+		[](Batch<Polygon>& batch, const Point2& delta) { detail::translate_st(batch, delta); },
+		[](Batch<Polygon>& batch, const Point2& delta) { detail::translate_mt(batch, delta); }
+	};
+#ifdef GPU
+	implementations.push_back([](Batch<Polygon>& batch, const Point2& delta) { detail::translate_gpu(batch, delta); });
+#endif
+	for(const std::function<void(Batch<Polygon>&, const Point2&)>& implementation : implementations) {
+		Batch<Polygon> batch(original);
+		implementation(batch, move_vector);
+		ASSERT_EQ(batch.size(), original.size()) << "The number of polygons must remain the same.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			ASSERT_EQ(batch[polygon].size(), original[polygon].size()) << "The number of vertices in each polygon must remain the same.";
+			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+				EXPECT_EQ(batch[polygon][vertex], original[polygon][vertex] + move_vector);
+			}
+		}
+	}
+}
+
+/*!
+ * Test that moving a batch of polygons moves their cached bounding boxes along,
+ * and keeps the rest of the cached properties.
+ */
+TEST(PolygonBatchTranslate, CachedProperties) {
+	Batch<Polygon> batch = PolygonBatchTestCases::square_triangle();
+	const Batch<area_t> areas = batch.area();
+	batch.bounding_box(); //Caches the bounding boxes.
+	const Point2 move_vector(-40, 70);
+	translate(batch, move_vector);
+	const Batch<Polygon>& moved = batch; //Accessing the polygons through a non-constant batch would clear their cached properties.
+	for(size_t polygon = 0; polygon < moved.size(); ++polygon) {
+		const PolygonProperties properties = moved.get_properties(polygon);
+		ASSERT_TRUE(properties.has_bounding_box()) << "The bounding box is still known after moving the polygon.";
+		EXPECT_EQ(properties.bounding_box(), detail::bounding_box_st(moved[polygon])) << "The bounding box must have moved along with the polygon.";
+		ASSERT_TRUE(properties.has_area()) << "Moving the polygon doesn't change its area.";
+		EXPECT_EQ(properties.area(), areas[polygon]) << "Moving the polygon doesn't change its area.";
+	}
+
+	Batch<Polygon> uncached = PolygonBatchTestCases::square_triangle();
+	translate(uncached, move_vector);
+	for(size_t polygon = 0; polygon < uncached.size(); ++polygon) {
+		EXPECT_FALSE(uncached.get_properties(polygon).has_bounding_box()) << "Nothing was known about the polygons before moving them.";
+	}
+}
+
+/*!
+ * Test moving a polygon with a fixed number of vertices.
+ */
+TEST_P(TranslateByVector, FixedPolygonTranslateByVector) {
+	const FixedPolygon<4> original(PolygonTestCases::arrowhead());
+	const Point2 move_vector = GetParam();
+
+	std::vector<std::function<void(FixedPolygon<4>&, const Point2&)>> implementations = {
+		[](FixedPolygon<4>& polygon, const Point2& delta) { translate(polygon, delta); },
+		[](FixedPolygon<4>& polygon, const Point2& delta) { detail::translate_st(polygon, delta); },
+		[](FixedPolygon<4>& polygon, const Point2& delta) { polygon.translate(delta); }
+	};
+	for(const std::function<void(FixedPolygon<4>&, const Point2&)>& implementation : implementations) {
+		FixedPolygon<4> polygon(original);
+		implementation(polygon, move_vector);
+		for(size_t i = 0; i < polygon.size(); ++i) {
+			EXPECT_EQ(polygon[i], original[i] + move_vector);
+		}
+	}
+}
+
+/*!
+ * Test moving a batch of polygons with a fixed number of vertices.
+ */
+TEST_P(TranslateByVector, FixedPolygonBatchTranslateByVector) {
+	const Batch<FixedPolygon<4>> original(PolygonBatchTestCases::edge_cases()); //Includes empty polygons, which are padded with the origin.
+	const Point2 move_vector = GetParam();
+
+	std::vector<std::function<void(Batch<FixedPolygon<4>>&, const Point2&)>> implementations = {
+		[](Batch<FixedPolygon<4>>& batch, const Point2& delta) { translate(batch, delta); },
+		[](Batch<FixedPolygon<4>>& batch, const Point2& delta) { detail::translate_st(batch, delta); },
+		[](Batch<FixedPolygon<4>>& batch, const Point2& delta) { detail::translate_mt(batch, delta); }
+	};
+#ifdef GPU
+	implementations.push_back([](Batch<FixedPolygon<4>>& batch, const Point2& delta) { detail::translate_gpu(batch, delta); });
+#endif
+	for(const std::function<void(Batch<FixedPolygon<4>>&, const Point2&)>& implementation : implementations) {
+		Batch<FixedPolygon<4>> batch(original);
+		implementation(batch, move_vector);
+		ASSERT_EQ(batch.size(), original.size()) << "The number of polygons must remain the same.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+				EXPECT_EQ(batch[polygon][vertex], original[polygon][vertex] + move_vector);
+			}
+		}
+	}
+}
+
+/*!
+ * Test moving a polygon that stores its vertices as a structure of arrays.
+ */
+TEST_P(TranslateByVector, SoAPolygonTranslateByVector) {
+	const Polygon original = PolygonTestCases::circle(); //Many vertices, to exercise the vectorised loops.
+	const Point2 move_vector = GetParam();
+
+	std::vector<std::function<void(SoAPolygon&, const Point2&)>> implementations = {
+		[](SoAPolygon& polygon, const Point2& delta) { translate(polygon, delta); },
+		[](SoAPolygon& polygon, const Point2& delta) { detail::translate_st(polygon, delta); },
+		[](SoAPolygon& polygon, const Point2& delta) { detail::translate_mt(polygon, delta); }
+	};
+#ifdef GPU
+	implementations.push_back([](SoAPolygon& polygon, const Point2& delta) { detail::translate_gpu(polygon, delta); });
+#endif
+	for(const std::function<void(SoAPolygon&, const Point2&)>& implementation : implementations) {
+		SoAPolygon polygon(original);
+		implementation(polygon, move_vector);
+		ASSERT_EQ(polygon.size(), original.size()) << "The polygon may not gain or lose any vertices by translating it.";
+		for(size_t i = 0; i < polygon.size(); ++i) {
+			EXPECT_EQ(polygon[i], original[i] + move_vector);
+		}
+	}
+}
+
+/*!
+ * Test moving a batch of polygons that stores its vertices as a structure of
+ * arrays.
+ */
+TEST_P(TranslateByVector, SoAPolygonBatchTranslateByVector) {
+	const Batch<Polygon> original = PolygonBatchTestCases::edge_cases(); //Includes empty polygons, which must not disturb the other polygons.
+	const Point2 move_vector = GetParam();
+
+	std::vector<std::function<void(Batch<SoAPolygon>&, const Point2&)>> implementations = {
+		[](Batch<SoAPolygon>& batch, const Point2& delta) { translate(batch, delta); },
+		[](Batch<SoAPolygon>& batch, const Point2& delta) { detail::translate_st(batch, delta); },
+		[](Batch<SoAPolygon>& batch, const Point2& delta) { detail::translate_mt(batch, delta); }
+	};
+#ifdef GPU
+	implementations.push_back([](Batch<SoAPolygon>& batch, const Point2& delta) { detail::translate_gpu(batch, delta); });
+#endif
+	for(const std::function<void(Batch<SoAPolygon>&, const Point2&)>& implementation : implementations) {
+		Batch<SoAPolygon> batch(original);
+		implementation(batch, move_vector);
+		ASSERT_EQ(batch.size(), original.size()) << "The number of polygons must remain the same.";
+		for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+			ASSERT_EQ(batch[polygon].size(), original[polygon].size()) << "The number of vertices in each polygon must remain the same.";
+			for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+				EXPECT_EQ(batch[polygon][vertex], original[polygon][vertex] + move_vector);
+			}
+		}
+	}
+}
+
+#ifdef GPU
+/*!
+ * Test chaining multiple operations on a polygon on the GPU, while modifying it
+ * on the host in between.
+ *
+ * The vertices may stay on the GPU in between the operations, but the results
+ * must be the same as if they were transferred every time.
+ */
+TEST(PolygonTranslate, ChainOnGPU) {
+	const Polygon original = PolygonTestCases::square_1000();
+	Polygon polygon = original;
+	detail::translate_gpu(polygon, Point2(10, 20));
+	detail::translate_gpu(polygon, Point2(30, 40));
+	EXPECT_EQ(detail::area_gpu(polygon), detail::area_st(original)) << "Translating doesn't change the area.";
+	for(size_t i = 0; i < polygon.size(); ++i) {
+		EXPECT_EQ(polygon[i], original[i] + Point2(40, 60)) << "Both translations must be visible on the host.";
+	}
+
+	polygon[0] = Point2(-1000, 0); //Modify on the host, then use it on the GPU again.
+	polygon.push_back(Point2(2000, 2000)); //Also reallocate the vertices.
+	detail::translate_gpu(polygon, Point2(1, 1));
+	EXPECT_EQ(polygon[0], Point2(-999, 1)) << "The modification on the host must have been transferred to the GPU.";
+	EXPECT_EQ(polygon.back(), Point2(2001, 2001)) << "The added vertex must have been transferred to the GPU.";
+	const Polygon copy = polygon;
+	EXPECT_EQ(copy, polygon) << "Copying must include the changes made on the GPU.";
+}
+
+/*!
+ * Test chaining multiple operations on a batch of polygons on the GPU.
+ */
+TEST(PolygonBatchTranslate, ChainOnGPU) {
+	const Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	Batch<Polygon> batch = original;
+	detail::translate_gpu(batch, Point2(10, 20));
+	detail::translate_gpu(batch, Point2(30, 40));
+	EXPECT_EQ(detail::area_gpu(batch), detail::area_st(original)) << "Translating doesn't change the area.";
+	const Batch<Polygon> copy = batch;
+	for(size_t polygon = 0; polygon < batch.size(); ++polygon) {
+		for(size_t vertex = 0; vertex < batch[polygon].size(); ++vertex) {
+			EXPECT_EQ(batch[polygon][vertex], original[polygon][vertex] + Point2(40, 60)) << "Both translations must be visible on the host.";
+			EXPECT_EQ(copy[polygon][vertex], original[polygon][vertex] + Point2(40, 60)) << "Copying must include the changes made on the GPU.";
+		}
+	}
+
+	batch.push_back(PolygonTestCases::triangle_1000()); //Reallocate the vertices, then use them on the GPU again.
+	detail::translate_gpu(batch, Point2(1, 1));
+	EXPECT_EQ(batch.back()[0], PolygonTestCases::triangle_1000()[0] + Point2(1, 1)) << "The added polygon must have been transferred to the GPU.";
+}
+
+/*!
+ * Test chaining asynchronous operations on a polygon on the GPU, without
+ * waiting in between.
+ *
+ * The operations must be executed in the order they were queued.
+ */
+TEST(PolygonTranslate, ChainAsync) {
+	const Polygon original = PolygonTestCases::square_1000();
+	Polygon polygon = original;
+	translate_async(polygon, Point2(10, 20));
+	GPUFuture<area_t> area = area_async(polygon);
+	translate_async(polygon, Point2(30, 40));
+	EXPECT_EQ(area.get(), detail::area_st(original)) << "Translating doesn't change the area.";
+	for(size_t i = 0; i < polygon.size(); ++i) {
+		EXPECT_EQ(polygon[i], original[i] + Point2(40, 60)) << "Accessing the polygon on the host must wait for both translations.";
+	}
+
+	polygon[0] = Point2(-1000, 0); //Modify on the host, then use it on the GPU again.
+	translate_async(polygon, Point2(1, 1)).wait();
+	EXPECT_EQ(polygon[0], Point2(-999, 1)) << "The modification on the host must have been transferred to the GPU.";
+}
+
+/*!
+ * Test chaining asynchronous operations on multiple batches of polygons on the
+ * GPU, alternating between the batches.
+ */
+TEST(PolygonBatchTranslate, ChainAsync) {
+	const Batch<Polygon> original = PolygonBatchTestCases::square_triangle_square();
+	Batch<Polygon> first = original;
+	Batch<Polygon> second = original;
+	translate_async(first, Point2(10, 20));
+	translate_async(second, Point2(-10, -20));
+	GPUFuture<Batch<area_t>> first_area = area_async(first);
+	GPUFuture<Batch<area_t>> second_area = area_async(second);
+	translate_async(first, Point2(30, 40));
+	translate_async(second, Point2(-30, -40));
+	EXPECT_EQ(first_area.get(), detail::area_st(original)) << "Translating doesn't change the area.";
+	EXPECT_EQ(second_area.get(), detail::area_st(original)) << "Translating doesn't change the area.";
+	for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+		for(size_t vertex = 0; vertex < original[polygon].size(); ++vertex) {
+			EXPECT_EQ(first[polygon][vertex], original[polygon][vertex] + Point2(40, 60)) << "Accessing the batch on the host must wait for both translations.";
+			EXPECT_EQ(second[polygon][vertex], original[polygon][vertex] - Point2(40, 60)) << "Accessing the batch on the host must wait for both translations.";
+		}
+	}
+}
+#endif
+
 }
\ No newline at end of file
@@ -9,9 +9,12 @@
 #include <algorithm> //To test the specialisation of std::swap.
 #include <cmath> //To construct an octagon.
 #include <gtest/gtest.h> //To run the test.
+#include <memory_resource> //To test allocating polygons from custom memory resources.
+#include <utility> //To compare bounding boxes.
 
 #include "apex/coordinate.hpp" //To construct an octagon.
 #include "apex/polygon.hpp" //The code under test.
+#include "helpers/allocation_counter.hpp" //To test that moving polygons doesn't copy their vertices.
 
 namespace apex {
 
@@ -71,6 +74,83 @@ TEST(Polygon, ConstructRepeated) {
 	}
 }
 
+/*!
+ * Tests constructing a polygon that allocates from a custom memory resource.
+ */
+TEST(Polygon, ConstructMemoryResource) {
+	std::byte buffer[1024];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource()); //Fails if it would need to allocate outside of the buffer.
+
+	AllocationCounter counter;
+	Polygon polygon(&arena);
+	polygon.emplace_back(0, 0);
+	polygon.emplace_back(100, 0);
+	polygon.emplace_back(0, 100);
+	EXPECT_EQ(counter.allocations(), 0) << "All memory must come from the arena, not from the heap.";
+	EXPECT_EQ(polygon.get_memory_resource(), &arena) << "The polygon must report the memory resource it was constructed with.";
+	EXPECT_EQ(polygon, Polygon({Point2(0, 0), Point2(100, 0), Point2(0, 100)}));
+}
+
+/*!
+ * Tests constructing a batch of polygons that allocates from a custom memory
+ * resource.
+ */
+TEST(Polygon, ConstructBatchMemoryResource) {
+	std::byte buffer[4096];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource()); //Fails if it would need to allocate outside of the buffer.
+
+	AllocationCounter counter;
+	Batch<Polygon> batch(&arena);
+	for(coord_t polygon = 0; polygon < 5; ++polygon) {
+		batch.emplace_back();
+		batch.back().emplace_back(polygon, 0);
+		batch.back().emplace_back(polygon + 10, 0);
+		batch.back().emplace_back(polygon, 10);
+	}
+	EXPECT_EQ(counter.allocations(), 0) << "All memory must come from the arena, not from the heap.";
+	EXPECT_EQ(batch.get_memory_resource(), &arena) << "The batch must report the memory resource it was constructed with.";
+	ASSERT_EQ(batch.size(), 5);
+	EXPECT_EQ(batch[4][1], Point2(14, 0));
+}
+
+/*!
+ * Tests constructing a batch of polygons around an existing vertex buffer,
+ * without copying the vertices.
+ */
+TEST(Polygon, ConstructBatchAdoptBuffer) {
+	std::pmr::vector<Point2> vertices = {Point2(0, 0), Point2(10, 0), Point2(0, 10), Point2(20, 20), Point2(30, 20), Point2(30, 30), Point2(20, 30)};
+	const Point2* data = vertices.data();
+	const Batch<Polygon> batch(std::move(vertices), std::vector<size_t>({0, 3, 7}));
+	EXPECT_EQ(batch.data_subelements(), data) << "The vertices must not have been copied.";
+	ASSERT_EQ(batch.size(), 2);
+	EXPECT_EQ(batch[0], Polygon({Point2(0, 0), Point2(10, 0), Point2(0, 10)})) << "The first 3 vertices form a triangle.";
+	EXPECT_EQ(batch[1], Polygon({Point2(20, 20), Point2(30, 20), Point2(30, 30), Point2(20, 30)})) << "The last 4 vertices form a square.";
+	EXPECT_EQ(batch.area(), Batch<area_t>({50, 100})) << "Operations work on the adopted vertices directly.";
+}
+
+/*!
+ * Tests filling a batch of polygons of predetermined sizes from multiple
+ * threads.
+ */
+TEST(Polygon, AssignSizesBatch) {
+	Batch<Polygon> batch;
+	const std::vector<size_t> sizes(1000, 4);
+	batch.assign_sizes(sizes);
+	const Batch<Polygon>::iterator polygons = batch.begin();
+	#pragma omp parallel for
+	for(size_t polygon = 0; polygon < sizes.size(); ++polygon) {
+		const coord_t offset = polygon * 10;
+		polygons[polygon][0] = Point2(offset, 0);
+		polygons[polygon][1] = Point2(offset + 10, 0);
+		polygons[polygon][2] = Point2(offset + 10, 10);
+		polygons[polygon][3] = Point2(offset, 10);
+	}
+	ASSERT_EQ(batch.size(), 1000);
+	EXPECT_EQ(batch.size_subelements(), 4000) << "All polygons are placed in one buffer without gaps.";
+	EXPECT_EQ(batch[999], Polygon({Point2(9990, 0), Point2(10000, 0), Point2(10000, 10), Point2(9990, 10)})) << "Every polygon must have been filled in.";
+	EXPECT_EQ(batch.area(), Batch<area_t>(1000, 100)) << "All of the polygons are squares of 10 by 10.";
+}
+
 /*!
  * Tests copy-constructing a polygon.
  */
@@ -88,11 +168,30 @@ TEST_F(PolygonFixture, ConstructCopy) {
  */
 TEST_F(PolygonFixture, ConstructMove) {
 	Polygon copy = triangle; //Make a copy to move so we keep the original fixture to compare against.
+	const Point2* original_data = copy.data();
+	AllocationCounter counter;
 	Polygon target = std::move(copy);
 
+	EXPECT_EQ(counter.allocations(), 0) << "Moving the polygon must not allocate any memory for a copy of the vertices.";
+	EXPECT_EQ(target.data(), original_data) << "The moved polygon must take over the vertices of the original polygon.";
 	EXPECT_EQ(triangle, target);
 }
 
+/*!
+ * Tests move-assigning a polygon.
+ */
+TEST_F(PolygonFixture, AssignMove) {
+	Polygon copy = octagon; //Make a copy to move so we keep the original fixture to compare against.
+	const Point2* original_data = copy.data();
+	Polygon target = triangle;
+	AllocationCounter counter;
+	target = std::move(copy);
+
+	EXPECT_EQ(counter.allocations(), 0) << "Moving the polygon must not allocate any memory for a copy of the vertices.";
+	EXPECT_EQ(target.data(), original_data) << "The assigned polygon must take over the vertices of the original polygon.";
+	EXPECT_EQ(octagon, target);
+}
+
 /*!
  * Tests making a copy via assignment.
  */
@@ -126,6 +225,48 @@ TEST_F(PolygonFixture, AccessCopy) {
 	EXPECT_EQ(vertex.y, 20);
 }
 
+/*!
+ * Tests that the area of the polygon is cached once it is computed.
+ */
+TEST_F(PolygonFixture, AreaCached) {
+	EXPECT_FALSE(triangle.get_properties().has_area()) << "The area hasn't been computed yet.";
+	EXPECT_EQ(triangle.area(), 80 * 40 / 2) << "The triangle has a base of 80 and a height of 40.";
+	ASSERT_TRUE(triangle.get_properties().has_area()) << "The area has been computed, so it must be cached.";
+	EXPECT_EQ(triangle.get_properties().area(), 80 * 40 / 2) << "The cached area must be the computed area.";
+}
+
+/*!
+ * Tests computing and caching the area of a constant polygon from multiple
+ * threads at the same time.
+ */
+TEST_F(PolygonFixture, AreaCachedFromMultipleThreads) {
+	const Polygon& shared = triangle;
+	size_t wrong = 0;
+	#pragma omp parallel for num_threads(4) reduction(+:wrong)
+	for(size_t repeat = 0; repeat < 1000; ++repeat) {
+		if(repeat % 10 == 0) {
+			shared.set_properties(PolygonProperties()); //Make some threads compute the area again, overwriting the cache.
+		}
+		const PolygonProperties properties = shared.get_properties();
+		wrong += shared.area() != 80 * 40 / 2 || (properties.has_area() && properties.area() != 80 * 40 / 2);
+	}
+	EXPECT_EQ(wrong, 0) << "Each thread must find the correct area, computed or cached.";
+}
+
+/*!
+ * Tests that the cached area is forgotten when the polygon is modified.
+ */
+TEST_F(PolygonFixture, AreaCacheInvalidated) {
+	triangle.area();
+	triangle.push_back(Point2(20, 60)); //Adds another triangle on the left side.
+	EXPECT_FALSE(triangle.get_properties().has_area()) << "The polygon was modified, so the area is no longer known.";
+	EXPECT_EQ(triangle.area(), 80 * 40 / 2 + 40 * 40 / 2) << "The new vertex adds a triangle with a base and height of 40.";
+
+	triangle[2] = Point2(100, 60); //Modify through a reference, making it a rectangle.
+	EXPECT_FALSE(triangle.get_properties().has_area()) << "The polygon may have been modified through the reference, so the area is no longer known.";
+	EXPECT_EQ(triangle.area(), 80 * 40) << "The rectangle is 80x40.";
+}
+
 /*!
  * Tests assigning a repeated vertex to the polygon.
  */
@@ -231,6 +372,26 @@ TEST_F(PolygonFixture, Back) {
 	EXPECT_EQ(copy.back(), Point2(60, 60));
 }
 
+/*!
+ * Tests computing the bounding box of a polygon.
+ */
+TEST_F(PolygonFixture, BoundingBox) {
+	EXPECT_EQ(triangle.bounding_box(), std::make_pair(Point2(20, 20), Point2(100, 60))) << "The bounding box must span from the minimum to the maximum coordinates of the triangle.";
+	EXPECT_TRUE(triangle.get_properties().has_bounding_box()) << "The bounding box has been computed, so it must be cached.";
+
+	triangle.push_back(Point2(0, 100));
+	EXPECT_FALSE(triangle.get_properties().has_bounding_box()) << "The polygon was modified, so the bounding box is no longer known.";
+	EXPECT_EQ(triangle.bounding_box(), std::make_pair(Point2(0, 20), Point2(100, 100))) << "The bounding box must include the new vertex.";
+}
+
+/*!
+ * Tests computing the bounding box of an empty polygon.
+ */
+TEST(Polygon, BoundingBoxEmpty) {
+	const Polygon empty;
+	EXPECT_EQ(empty.bounding_box(), std::make_pair(Point2(0, 0), Point2(0, 0))) << "Without vertices, the bounding box is empty, at the origin.";
+}
+
 /*!
  * Tests clearing a polygon.
  */
@@ -927,4 +1088,31 @@ TEST_F(PolygonFixture, SwapStd) {
 	EXPECT_EQ(copy_octagon, triangle) << "Since the octagon was swapped with the triangle, it must now contain the triangle.";
 }
 
+/*!
+ * Tests that transforming a polygon forgets its cached properties.
+ */
+TEST_F(PolygonFixture, TransformInvalidatesCache) {
+	triangle.area();
+	triangle.bounding_box();
+	triangle.transform(AffineTransform::scaling(2));
+	EXPECT_FALSE(triangle.get_properties().has_area()) << "The transformation may change the area, so it is no longer known.";
+	EXPECT_FALSE(triangle.get_properties().has_bounding_box()) << "The transformation may change the bounding box, so it is no longer known.";
+	EXPECT_EQ(triangle.area(), 160 * 80 / 2) << "The triangle was scaled by 2 in both dimensions.";
+}
+
+/*!
+ * Tests that translating a polygon keeps its cached properties, moving the
+ * bounding box along.
+ */
+TEST_F(PolygonFixture, TranslateKeepsCache) {
+	triangle.area();
+	triangle.bounding_box();
+	triangle.translate(Point2(10, -10));
+	ASSERT_TRUE(triangle.get_properties().has_area()) << "Moving the polygon doesn't change its area, so it must still be known.";
+	EXPECT_EQ(triangle.get_properties().area(), 80 * 40 / 2) << "Moving the polygon doesn't change its area.";
+	ASSERT_TRUE(triangle.get_properties().has_bounding_box()) << "The bounding box moves along with the polygon, so it must still be known.";
+	EXPECT_EQ(triangle.get_properties().bounding_box(), std::make_pair(Point2(30, 10), Point2(110, 50))) << "The bounding box must have moved along with the polygon.";
+	EXPECT_EQ(triangle[0], Point2(30, 10)) << "The vertices must have moved too.";
+}
+
 }
\ No newline at end of file
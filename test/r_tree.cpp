@@ -0,0 +1,250 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <algorithm> //To sort the found items.
+#include <functional> //To test all batched query implementations in the same way.
+#include <gtest/gtest.h> //To run the test.
+#include <random> //To generate lots of bounding boxes.
+
+#include "apex/polygon.hpp" //To index batches of polygons.
+#include "apex/r_tree.hpp" //The unit under test.
+
+namespace apex {
+
+/*!
+ * Fixture with a tree indexing many randomly placed bounding boxes.
+ */
+class RTreeFixture : public testing::Test {
+public:
+	/*!
+	 * The bounding boxes of the items in the tree.
+	 */
+	Batch<std::pair<Point2, Point2>> boxes;
+
+	/*!
+	 * Windows to query the tree with, some of which overlap with many items
+	 * and some with none.
+	 */
+	Batch<std::pair<Point2, Point2>> windows;
+
+	/*!
+	 * Generates the bounding boxes and windows.
+	 */
+	void SetUp() {
+		std::mt19937 randomiser(42); //Fixed seed to make the test deterministic.
+		std::uniform_int_distribution<coord_t> position(-10000, 10000);
+		std::uniform_int_distribution<coord_t> size(0, 1000);
+		for(size_t item = 0; item < 2000; ++item) {
+			const Point2 minimum(position(randomiser), position(randomiser));
+			boxes.emplace_back(minimum, minimum + Point2(size(randomiser), size(randomiser)));
+		}
+		std::uniform_int_distribution<coord_t> window_size(0, 5000);
+		for(size_t window = 0; window < 100; ++window) {
+			const Point2 minimum(position(randomiser), position(randomiser));
+			windows.emplace_back(minimum, minimum + Point2(window_size(randomiser), window_size(randomiser)));
+		}
+		windows.emplace_back(Point2(20000, 20000), Point2(30000, 30000)); //Outside of all items.
+		windows.emplace_back(Point2(-20000, -20000), Point2(20000, 20000)); //Around all items.
+	}
+
+	/*!
+	 * Find the items that overlap with a window by comparing it to every item.
+	 * \param minimum The minimum corner of the window.
+	 * \param maximum The maximum corner of the window.
+	 * \return The indices of the items that overlap with the window, sorted.
+	 */
+	Batch<size_t> brute_force(const Point2& minimum, const Point2& maximum) const {
+		Batch<size_t> result;
+		for(size_t item = 0; item < boxes.size(); ++item) {
+			if(boxes[item].first.x <= maximum.x && minimum.x <= boxes[item].second.x && boxes[item].first.y <= maximum.y && minimum.y <= boxes[item].second.y) {
+				result.push_back(item);
+			}
+		}
+		return result;
+	}
+};
+
+/*!
+ * Sorts the items found by a query, since queries find them in no particular
+ * order.
+ * \param items The items to sort.
+ * \return The same items, sorted by index.
+ */
+Batch<size_t> sorted(Batch<size_t> items) {
+	std::sort(items.begin(), items.end());
+	return items;
+}
+
+/*!
+ * Test querying a tree without any items.
+ */
+TEST(RTree, Empty) {
+	const RTree tree;
+	EXPECT_TRUE(tree.empty()) << "The tree was constructed without items.";
+	EXPECT_EQ(tree.num_levels(), 0) << "Without items, there are no nodes either.";
+	EXPECT_TRUE(tree.query(Point2(-100, -100), Point2(100, 100)).empty()) << "There are no items to find.";
+
+	const RTree from_boxes(Batch<std::pair<Point2, Point2>>{});
+	EXPECT_TRUE(from_boxes.empty()) << "The tree was constructed without items.";
+	const Batch<Batch<size_t>> found = from_boxes.query(Batch<Point2>({Point2(0, 0), Point2(10, 10)}));
+	ASSERT_EQ(found.size(), 2) << "There must be a result for each queried point.";
+	EXPECT_TRUE(found[0].empty()) << "There are no items to find.";
+	EXPECT_TRUE(found[1].empty()) << "There are no items to find.";
+}
+
+/*!
+ * Test querying a tree with a single item.
+ */
+TEST(RTree, Single) {
+	const RTree tree(Batch<std::pair<Point2, Point2>>({{Point2(0, 0), Point2(100, 100)}}));
+	EXPECT_EQ(tree.size(), 1) << "There is one item in the tree.";
+	EXPECT_EQ(tree.num_levels(), 1) << "The only item is both the leaf and the root.";
+	EXPECT_EQ(tree.query(Point2(50, 50)), Batch<size_t>({0})) << "The point is inside of the only item.";
+	EXPECT_EQ(tree.query(Point2(100, 0)), Batch<size_t>({0})) << "Points on the border of the bounding box are considered inside.";
+	EXPECT_TRUE(tree.query(Point2(101, 50)).empty()) << "The point is outside of the only item.";
+	EXPECT_EQ(tree.bounding_box(), std::make_pair(Point2(0, 0), Point2(100, 100))) << "The bounding box of the tree is that of the only item.";
+}
+
+/*!
+ * Test the number of levels in the tree, which depends on how many nodes fit
+ * in each node.
+ */
+TEST(RTree, NumLevels) {
+	Batch<std::pair<Point2, Point2>> boxes;
+	for(coord_t item = 0; item < coord_t(RTree::node_size * RTree::node_size + 1); ++item) {
+		boxes.emplace_back(Point2(item * 10, 0), Point2(item * 10 + 5, 5));
+	}
+	const RTree tree(boxes);
+	EXPECT_EQ(tree.num_levels(), 4) << "The leaves fill 17 nodes, which don't fit in one node, so those need another level, and then the root.";
+	EXPECT_EQ(tree.num_nodes(), boxes.size() + RTree::node_size + 1 + 2 + 1) << "The leaves, 17 nodes on the second level, 2 on the third and the root.";
+}
+
+/*!
+ * Test that window queries find exactly the items whose bounding boxes overlap
+ * with the window.
+ */
+TEST_F(RTreeFixture, QueryWindow) {
+	const RTree tree(boxes);
+	for(const std::pair<Point2, Point2>& window : windows) {
+		EXPECT_EQ(sorted(tree.query(window.first, window.second)), brute_force(window.first, window.second)) << "The tree must find exactly the items that overlap with the window.";
+	}
+}
+
+/*!
+ * Test that point queries find exactly the items whose bounding boxes contain
+ * the point.
+ */
+TEST_F(RTreeFixture, QueryPoint) {
+	const RTree tree(boxes);
+	for(const std::pair<Point2, Point2>& window : windows) {
+		EXPECT_EQ(sorted(tree.query(window.first)), brute_force(window.first, window.first)) << "The tree must find exactly the items that contain the point.";
+	}
+	EXPECT_EQ(sorted(tree.query(boxes[0].second)), brute_force(boxes[0].second, boxes[0].second)) << "The corner of an item is inside of that item.";
+}
+
+/*!
+ * Test that all versions of batched window queries find the same items as
+ * querying each window separately.
+ */
+TEST_F(RTreeFixture, QueryBatch) {
+	const RTree tree(boxes);
+	std::vector<Point2> minima;
+	std::vector<Point2> maxima;
+	for(const std::pair<Point2, Point2>& window : windows) {
+		minima.push_back(window.first);
+		maxima.push_back(window.second);
+	}
+	std::vector<std::function<Batch<Batch<size_t>>()>> implementations = {
+		[&]() { return tree.query(windows); },
+		[&]() { return detail::r_tree_query_st(tree, minima.data(), maxima.data(), windows.size()); },
+		[&]() { return detail::r_tree_query_mt(tree, minima.data(), maxima.data(), windows.size()); }
+	};
+#ifdef GPU
+	implementations.push_back([&]() { return detail::r_tree_query_gpu(tree, minima.data(), maxima.data(), windows.size()); });
+#endif
+	for(const std::function<Batch<Batch<size_t>>()>& implementation : implementations) {
+		const Batch<Batch<size_t>> found = implementation();
+		ASSERT_EQ(found.size(), windows.size()) << "There must be a result for each window.";
+		for(size_t window = 0; window < windows.size(); ++window) {
+			Batch<size_t> window_found;
+			for(const size_t item : found[window]) {
+				window_found.push_back(item);
+			}
+			EXPECT_EQ(sorted(window_found), brute_force(windows[window].first, windows[window].second)) << "Each window must find exactly the items that overlap with it.";
+		}
+	}
+}
+
+/*!
+ * Test refitting the tree after all bounding boxes changed.
+ */
+TEST_F(RTreeFixture, Refit) {
+	RTree tree(boxes);
+	for(size_t item = 0; item < boxes.size(); ++item) { //Move the items around in different directions.
+		const coord_t offset = coord_t(item % 7) * 1000 - 3000;
+		boxes[item].first += Point2(offset, -offset);
+		boxes[item].second += Point2(offset, -offset);
+	}
+	tree.refit(boxes);
+	for(const std::pair<Point2, Point2>& window : windows) {
+		EXPECT_EQ(sorted(tree.query(window.first, window.second)), brute_force(window.first, window.second)) << "After refitting, the tree must find the items at their new positions.";
+	}
+}
+
+/*!
+ * Test updating the bounding box of individual items.
+ */
+TEST_F(RTreeFixture, Update) {
+	RTree tree(boxes);
+	for(size_t item = 0; item < boxes.size(); item += 13) {
+		boxes[item].first += Point2(5000, 5000);
+		boxes[item].second += Point2(5000, 6000);
+		tree.update(item, boxes[item].first, boxes[item].second);
+	}
+	for(const std::pair<Point2, Point2>& window : windows) {
+		EXPECT_EQ(sorted(tree.query(window.first, window.second)), brute_force(window.first, window.second)) << "After updating, the tree must find the items at their new positions.";
+	}
+}
+
+/*!
+ * Test moving all items in the tree at once.
+ */
+TEST_F(RTreeFixture, Translate) {
+	RTree tree(boxes);
+	const Point2 delta(-1234, 5678);
+	tree.translate(delta);
+	for(std::pair<Point2, Point2>& box : boxes) {
+		box.first += delta;
+		box.second += delta;
+	}
+	for(const std::pair<Point2, Point2>& window : windows) {
+		EXPECT_EQ(sorted(tree.query(window.first, window.second)), brute_force(window.first, window.second)) << "After translating, the tree must find the items at their new positions.";
+	}
+}
+
+/*!
+ * Test indexing the polygons of a batch, and refitting the tree after some of
+ * them are translated.
+ */
+TEST(RTree, PolygonBatch) {
+	Batch<Polygon> batch;
+	for(coord_t polygon = 0; polygon < 100; ++polygon) {
+		batch.push_back(Polygon({Point2(polygon * 100, 0), Point2(polygon * 100 + 50, 0), Point2(polygon * 100 + 50, 50)}));
+	}
+	RTree tree(batch);
+	EXPECT_EQ(tree.size(), batch.size()) << "Each polygon is an item in the tree.";
+	EXPECT_EQ(tree.query(Point2(1025, 1)), Batch<size_t>({10})) << "The point is inside of the bounding box of polygon 10.";
+	EXPECT_TRUE(tree.query(Point2(1075, 1)).empty()) << "The point is between polygons 10 and 11.";
+
+	translate(batch, Point2(0, 1000));
+	tree.refit(batch);
+	EXPECT_TRUE(tree.query(Point2(1025, 1)).empty()) << "All polygons moved away from this point.";
+	EXPECT_EQ(tree.query(Point2(1025, 1001)), Batch<size_t>({10})) << "Polygon 10 has moved to this point.";
+}
+
+}
\ No newline at end of file
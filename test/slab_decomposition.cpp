@@ -0,0 +1,109 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+#include <random> //To generate lots of points to test.
+
+#include "apex/polygon.hpp" //To decompose polygons.
+#include "apex/slab_decomposition.hpp" //The unit under test.
+#include "helpers/polygon_test_cases.hpp" //To load testing polygons to decompose.
+
+namespace apex {
+
+/*!
+ * Tests many points against the decomposition of a polygon, comparing them to
+ * testing the points against the polygon itself.
+ * \param polygon The polygon to test.
+ * \param minimum The minimum corner of the region to generate points in.
+ * \param maximum The maximum corner of the region to generate points in.
+ */
+void expect_same_as_polygon(const Polygon& polygon, const Point2& minimum, const Point2& maximum) {
+	std::mt19937 randomiser(42); //Fixed seed to make the test deterministic.
+	std::uniform_int_distribution<coord_t> x(minimum.x, maximum.x);
+	std::uniform_int_distribution<coord_t> y(minimum.y, maximum.y);
+	Batch<Point2> points;
+	for(size_t point = 0; point < 1000; ++point) {
+		points.emplace_back(x(randomiser), y(randomiser));
+	}
+	const size_t stride = polygon.size() / 1000 + 1; //Also test some of the vertices, which are on the border.
+	for(size_t vertex = 0; vertex < polygon.size(); vertex += stride) {
+		points.push_back(polygon[vertex]);
+	}
+
+	const SlabDecomposition slabs(polygon);
+	const Batch<bool> ground_truth = detail::contains_st(polygon, points);
+	for(size_t point = 0; point < points.size(); ++point) {
+		EXPECT_EQ(slabs.contains(points[point]), ground_truth[point]) << "The decomposition must give the same result as testing all edges of the polygon.";
+	}
+	EXPECT_EQ(slabs.contains(points), ground_truth) << "The batched version must give the same results as testing all edges of the polygon.";
+}
+
+/*!
+ * Test that nothing is inside of the decomposition of an empty polygon.
+ */
+TEST(SlabDecomposition, Empty) {
+	const SlabDecomposition slabs(PolygonTestCases::empty());
+	EXPECT_EQ(slabs.num_slabs(), 1) << "Even without edges, there is a slab.";
+	EXPECT_FALSE(slabs.contains(Point2(0, 0))) << "An empty polygon doesn't contain anything, not even the origin.";
+}
+
+/*!
+ * Test a simple square, where every slab contains the two vertical edges.
+ */
+TEST(SlabDecomposition, Square) {
+	const SlabDecomposition slabs(PolygonTestCases::square_1000());
+	EXPECT_TRUE(slabs.contains(Point2(500, 500))) << "This point is in the middle of the square.";
+	EXPECT_TRUE(slabs.contains(Point2(1000, 1000))) << "The vertices of the square are on its border, so they are inside.";
+	EXPECT_FALSE(slabs.contains(Point2(1001, 500))) << "This point is just outside of the square.";
+	EXPECT_FALSE(slabs.contains(Point2(500, -1))) << "This point is just below the square.";
+	expect_same_as_polygon(PolygonTestCases::square_1000(), Point2(-100, -100), Point2(1100, 1100));
+}
+
+/*!
+ * Test concave and self-intersecting polygons.
+ */
+TEST(SlabDecomposition, EdgeCases) {
+	expect_same_as_polygon(PolygonTestCases::arrowhead(), Point2(0, 0), Point2(1100, 1100));
+	expect_same_as_polygon(PolygonTestCases::hourglass(), Point2(-100, -100), Point2(1100, 1100));
+	expect_same_as_polygon(PolygonTestCases::negative_square(), Point2(-100, -100), Point2(1100, 1100));
+	expect_same_as_polygon(PolygonTestCases::thin_rectangle(), Point2(-100, -100), Point2(1100, 1100));
+	expect_same_as_polygon(PolygonTestCases::zero_width(), Point2(-100, -100), Point2(1100, 1100));
+}
+
+/*!
+ * Test a polygon with many vertices, which gets divided into many slabs.
+ */
+TEST(SlabDecomposition, Circle) {
+	const Polygon circle = PolygonTestCases::circle();
+	const SlabDecomposition slabs(circle);
+	EXPECT_GT(slabs.num_slabs(), 1000) << "With many short edges, there should be many slabs.";
+	expect_same_as_polygon(circle, Point2(-1100000, -1100000), Point2(1100000, 1100000));
+}
+
+/*!
+ * Test that long edges spanning the whole polygon don't cause the edges to be
+ * copied too often.
+ */
+TEST(SlabDecomposition, LongEdges) {
+	Polygon zigzag;
+	for(coord_t tooth = 0; tooth < 1000; ++tooth) { //Each tooth spans the whole height.
+		zigzag.emplace_back(tooth * 10, 0);
+		zigzag.emplace_back(tooth * 10 + 5, 100000);
+	}
+	zigzag.emplace_back(10000, -10);
+	zigzag.emplace_back(0, -10);
+	const SlabDecomposition slabs(zigzag);
+	size_t total = 0;
+	for(size_t slab = 0; slab < slabs.num_slabs(); ++slab) {
+		total += slabs.slab_size(slab);
+	}
+	EXPECT_LE(total, zigzag.size() * 8) << "The edges must not be copied into too many slabs.";
+	expect_same_as_polygon(zigzag, Point2(-100, -100), Point2(10100, 100100));
+}
+
+}
\ No newline at end of file
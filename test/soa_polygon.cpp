@@ -0,0 +1,121 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h> //To run the test.
+
+#include "apex/soa_polygon.hpp" //The code under test.
+#include "helpers/polygon_batch_test_cases.hpp" //To convert batches of polygons.
+#include "helpers/polygon_test_cases.hpp" //To convert polygons.
+
+namespace apex {
+
+/*!
+ * Tests constructing an empty polygon.
+ */
+TEST(SoAPolygon, ConstructEmpty) {
+	const SoAPolygon empty;
+	EXPECT_EQ(empty.size(), 0) << "The polygon was constructed without vertices.";
+	EXPECT_TRUE(empty.empty()) << "The polygon was constructed without vertices.";
+}
+
+/*!
+ * Tests constructing a polygon from a list of vertices, and that the
+ * coordinates are stored in separate arrays.
+ */
+TEST(SoAPolygon, ConstructInitialiserList) {
+	const SoAPolygon triangle = {Point2(10, 20), Point2(30, 40), Point2(50, 60)};
+	ASSERT_EQ(triangle.size(), 3) << "There were 3 vertices in the initialiser list.";
+	EXPECT_EQ(triangle[0], Point2(10, 20));
+	EXPECT_EQ(triangle[1], Point2(30, 40));
+	EXPECT_EQ(triangle[2], Point2(50, 60));
+	EXPECT_EQ(triangle.data_x()[1], 30) << "The X coordinates are stored consecutively.";
+	EXPECT_EQ(triangle.data_y()[2], 60) << "The Y coordinates are stored consecutively.";
+}
+
+/*!
+ * Tests modifying the vertices of a polygon.
+ */
+TEST(SoAPolygon, Modify) {
+	SoAPolygon polygon;
+	polygon.push_back(Point2(1, 2));
+	polygon.emplace_back(3, 4);
+	polygon.set(0, Point2(5, 6));
+	ASSERT_EQ(polygon.size(), 2);
+	EXPECT_EQ(polygon[0], Point2(5, 6)) << "The first vertex was changed.";
+	EXPECT_EQ(polygon[1], Point2(3, 4));
+
+	polygon.clear();
+	EXPECT_TRUE(polygon.empty()) << "All vertices were removed.";
+}
+
+/*!
+ * Tests converting polygons to the structure of arrays layout and back.
+ */
+TEST(SoAPolygon, ConvertPolygon) {
+	for(const Polygon& original : {PolygonTestCases::empty(), PolygonTestCases::point(), PolygonTestCases::square_1000(), PolygonTestCases::arrowhead(), PolygonTestCases::hourglass()}) {
+		const SoAPolygon converted(original);
+		ASSERT_EQ(converted.size(), original.size()) << "The converted polygon must have the same number of vertices.";
+		for(size_t vertex = 0; vertex < original.size(); ++vertex) {
+			EXPECT_EQ(converted[vertex], original[vertex]) << "The vertices must be the same, in the same order.";
+		}
+		EXPECT_EQ(converted.to_polygon(), original) << "Converting back must produce the original polygon.";
+	}
+}
+
+/*!
+ * Tests constructing an empty batch.
+ */
+TEST(SoAPolygonBatch, ConstructEmpty) {
+	const Batch<SoAPolygon> empty;
+	EXPECT_EQ(empty.size(), 0) << "The batch was constructed without polygons.";
+	EXPECT_TRUE(empty.empty()) << "The batch was constructed without polygons.";
+	EXPECT_EQ(empty.size_subelements(), 0) << "Without polygons, there are no vertices either.";
+}
+
+/*!
+ * Tests adding polygons to a batch.
+ */
+TEST(SoAPolygonBatch, PushBack) {
+	Batch<SoAPolygon> batch;
+	batch.push_back(PolygonTestCases::square_1000());
+	batch.push_back(PolygonTestCases::empty());
+	batch.push_back(SoAPolygon({Point2(1, 2), Point2(3, 4), Point2(5, 6)}));
+
+	ASSERT_EQ(batch.size(), 3) << "Three polygons were added.";
+	EXPECT_EQ(batch.size_subelements(), 7) << "The polygons have 4, 0 and 3 vertices.";
+	EXPECT_EQ(batch[0].size(), 4);
+	EXPECT_TRUE(batch[1].empty()) << "The second polygon was empty.";
+	ASSERT_EQ(batch[2].size(), 3);
+	EXPECT_EQ(batch[2][1], Point2(3, 4));
+	EXPECT_EQ(batch.data_starts()[2], 4) << "The third polygon starts after the 4 vertices of the first and none of the second.";
+	EXPECT_EQ(batch.data_x()[5], 3) << "The coordinates of all polygons are stored consecutively.";
+
+	batch.clear();
+	EXPECT_TRUE(batch.empty()) << "All polygons were removed.";
+	EXPECT_EQ(batch.size_subelements(), 0) << "All vertices were removed.";
+}
+
+/*!
+ * Tests converting batches of polygons to the structure of arrays layout and
+ * back.
+ */
+TEST(SoAPolygonBatch, ConvertBatch) {
+	for(const Batch<Polygon>& original : {PolygonBatchTestCases::empty(), PolygonBatchTestCases::single_empty(), PolygonBatchTestCases::square_triangle_square(), PolygonBatchTestCases::edge_cases()}) {
+		const Batch<SoAPolygon> converted(original);
+		ASSERT_EQ(converted.size(), original.size()) << "The converted batch must have the same number of polygons.";
+		for(size_t polygon = 0; polygon < original.size(); ++polygon) {
+			ASSERT_EQ(converted[polygon].size(), original[polygon].size()) << "Each polygon must have the same number of vertices.";
+			for(size_t vertex = 0; vertex < original[polygon].size(); ++vertex) {
+				EXPECT_EQ(converted[polygon][vertex], original[polygon][vertex]) << "The vertices must be the same, in the same order.";
+			}
+		}
+		EXPECT_EQ(converted.to_polygons(), original) << "Converting back must produce the original batch.";
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*
+ * Library for performing massively parallel computations on polygons.
+ * Copyright (C) 2022 Ghostkeeper
+ * This library is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for details.
+ * You should have received a copy of the GNU Affero General Public License along with this library. If not, see <https://gnu.org/licenses/>.
+ */
+
+#include <filesystem> //To stream polygons from a file.
+#include <gtest/gtest.h> //To run the test.
+#include <limits> //To restore the memory budget of the GPU.
+#include <stdexcept> //To test that exceptions during processing are propagated.
+
+#include "apex/mapped_polygon_batch.hpp" //To stream polygons from a file.
+#include "apex/stream.hpp" //The code under test.
+#include "helpers/polygon_batch_test_cases.hpp" //To load testing polygons to stream.
+
+namespace apex {
+
+/*!
+ * Creates a batch with many squares of different sizes, to spread over many
+ * chunks.
+ * \return A batch of 100 squares.
+ */
+Batch<Polygon> many_squares() {
+	Batch<Polygon> batch;
+	for(coord_t square = 0; square < 100; ++square) {
+		const coord_t size = (square + 1) * 10;
+		batch.push_back(Polygon({Point2(0, 0), Point2(size, 0), Point2(size, size), Point2(0, size)}));
+	}
+	return batch;
+}
+
+/*!
+ * Tests that streaming an empty source never calls the processing step.
+ */
+TEST(Stream, Empty) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::empty();
+	BatchChunks source(batch);
+	size_t num_chunks = 0;
+	stream(source, [&num_chunks](Batch<Polygon>&, const size_t) {
+		++num_chunks;
+	}, 16);
+	EXPECT_EQ(num_chunks, 0) << "There are no polygons to process.";
+}
+
+/*!
+ * Tests that the chunks together contain all polygons, in order, and that each
+ * chunk is limited in size.
+ */
+TEST(Stream, Chunks) {
+	const Batch<Polygon> batch = many_squares();
+	BatchChunks source(batch);
+	size_t num_chunks = 0;
+	size_t next_polygon = 0;
+	stream(source, [&](Batch<Polygon>& chunk, const size_t first_polygon) {
+		++num_chunks;
+		EXPECT_EQ(first_polygon, next_polygon) << "The chunks must be processed in order.";
+		EXPECT_LE(chunk.size_subelements(), 30) << "The chunk must not have more vertices than allowed.";
+		for(size_t polygon = 0; polygon < chunk.size(); ++polygon) {
+			EXPECT_EQ(chunk[polygon], batch[first_polygon + polygon]) << "The chunk must contain copies of the polygons of the source.";
+		}
+		next_polygon += chunk.size();
+	}, 30);
+	EXPECT_EQ(next_polygon, batch.size()) << "All polygons must have been processed.";
+	EXPECT_EQ(num_chunks, 15) << "With 4 vertices per polygon, 7 polygons fit in each chunk, so 100 polygons need 15 chunks.";
+}
+
+/*!
+ * Tests that polygons bigger than a chunk are processed alone.
+ */
+TEST(Stream, BigPolygons) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::square_triangle_square();
+	BatchChunks source(batch);
+	size_t num_chunks = 0;
+	stream(source, [&num_chunks](Batch<Polygon>& chunk, const size_t) {
+		++num_chunks;
+		EXPECT_EQ(chunk.size(), 1) << "Each polygon is bigger than the chunk size, so it must be alone in its chunk.";
+	}, 2);
+	EXPECT_EQ(num_chunks, batch.size()) << "Each polygon must be processed.";
+}
+
+/*!
+ * Tests streaming the areas out of a source.
+ */
+TEST(Stream, Area) {
+	const Batch<Polygon> batch = many_squares();
+	const Batch<area_t> ground_truth = batch.area();
+	BatchChunks source(batch);
+	Batch<area_t> result(batch.size(), 0);
+	stream_area(source, [&result](Batch<area_t>&& areas, const size_t first_polygon) {
+		for(size_t polygon = 0; polygon < areas.size(); ++polygon) {
+			result[first_polygon + polygon] = areas[polygon];
+		}
+	}, 50);
+	EXPECT_EQ(result, ground_truth) << "The streamed areas must be the same as those of the whole batch.";
+}
+
+/*!
+ * Tests streaming the self-intersections out of a source.
+ */
+TEST(Stream, SelfIntersections) {
+	const Batch<Polygon> batch = PolygonBatchTestCases::edge_cases();
+	const Batch<Batch<PolygonSelfIntersection>> ground_truth = detail::self_intersections_st(batch);
+	BatchChunks source(batch);
+	size_t num_polygons = 0;
+	stream_self_intersections(source, [&](Batch<Batch<PolygonSelfIntersection>>&& intersections, const size_t first_polygon) {
+		for(size_t polygon = 0; polygon < intersections.size(); ++polygon) {
+			EXPECT_EQ(intersections[polygon], ground_truth[first_polygon + polygon]) << "The streamed self-intersections must be the same as those of the whole batch.";
+		}
+		num_polygons += intersections.size();
+	}, 8);
+	EXPECT_EQ(num_polygons, batch.size()) << "There must be results for all polygons.";
+}
+
+/*!
+ * Tests streaming the polygons of a mapped file, with a chain of operations on
+ * each chunk.
+ */
+TEST(Stream, MappedFile) {
+	const std::filesystem::path filename = std::filesystem::temp_directory_path() / "apex_stream.polygons";
+	const Batch<Polygon> batch = many_squares();
+	MappedPolygonBatch::write(batch, filename);
+	{
+		const MappedPolygonBatch mapped(filename);
+		BatchChunks source(mapped);
+		size_t num_polygons = 0;
+		stream(source, [&](Batch<Polygon>& chunk, const size_t first_polygon) {
+			chunk.translate(Point2(-5, -5));
+			const Batch<area_t> areas = chunk.area();
+			for(size_t polygon = 0; polygon < chunk.size(); ++polygon) {
+				EXPECT_EQ(chunk[polygon][0], Point2(-5, -5)) << "The chunk must have been moved.";
+				EXPECT_EQ(areas[polygon], (first_polygon + polygon + 1) * (first_polygon + polygon + 1) * 100) << "Moving doesn't change the area.";
+			}
+			num_polygons += chunk.size();
+		}, 40);
+		EXPECT_EQ(num_polygons, batch.size()) << "All polygons in the file must have been processed.";
+	}
+	std::filesystem::remove(filename);
+}
+
+/*!
+ * Tests that the cached properties of the polygons are copied into the chunks.
+ */
+TEST(Stream, Properties) {
+	const Batch<Polygon> batch = many_squares();
+	batch.area(); //Caches the areas.
+	BatchChunks source(batch);
+	stream(source, [&batch](Batch<Polygon>& chunk, const size_t first_polygon) {
+		for(size_t polygon = 0; polygon < chunk.size(); ++polygon) {
+			ASSERT_TRUE(chunk.get_properties(polygon).has_area()) << "The area was known in the source.";
+			EXPECT_EQ(chunk.get_properties(polygon).area(), batch.get_properties(first_polygon + polygon).area()) << "The known area must be copied along.";
+		}
+	}, 20);
+}
+
+/*!
+ * Tests that exceptions during the processing are propagated, after the next
+ * chunk has finished loading.
+ */
+TEST(Stream, Exception) {
+	const Batch<Polygon> batch = many_squares();
+	BatchChunks source(batch);
+	EXPECT_THROW(stream(source, [](Batch<Polygon>&, const size_t) {
+		throw std::runtime_error("Processing failed.");
+	}, 20), std::runtime_error) << "The exception of the processing step must reach the caller.";
+}
+
+/*!
+ * Tests choosing the chunk size from the memory budget on the GPU.
+ */
+TEST(Stream, ChunkSize) {
+	EXPECT_EQ(detail::stream_chunk_size(), detail::default_chunk_vertices) << "Without a budget, the default chunk size is used.";
+	GPUDataTracker::set_memory_budget(1600);
+	EXPECT_EQ(detail::stream_chunk_size(), 100) << "Two chunks of 100 vertices of 8 bytes fit in the budget.";
+	GPUDataTracker::set_memory_budget(4);
+	EXPECT_EQ(detail::stream_chunk_size(), 1) << "Chunks always have room for some vertices.";
+	GPUDataTracker::set_memory_budget(std::numeric_limits<size_t>::max());
+}
+
+}
\ No newline at end of file